@@ -0,0 +1,56 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Dedicated per-port sample-rate converter replacing SDL_AudioStream's
+// generic per-buffer conversion. The ratio and channel layout are configured
+// once from the port's settings; filter state - the fractional phase and the
+// source frames straddling a put boundary - persists across buffers, so
+// conversion is seamless and the common 48kHz stereo case degenerates to an
+// append. S16 in, S16 out. The conversion kernels are plain indexed loops
+// over whole buffers, which the compiler vectorizes.
+class AudioResampler {
+public:
+    AudioResampler(int src_channels, int src_rate, int dst_channels, int dst_rate);
+
+    void put(const uint8_t *buf, int len_bytes);
+
+    // Emits the tail frames still held as interpolation state.
+    void flush();
+
+    // Bytes ready to get at the output format.
+    int available() const;
+
+    // Copies up to len_bytes of converted audio, returning the bytes copied.
+    int get(uint8_t *buf, int len_bytes);
+
+private:
+    void append_output(const int16_t *frames, size_t frame_count);
+
+    const int src_channels;
+    const int dst_channels;
+    const uint64_t step; // source frames per output frame, 32.32 fixed point
+
+    uint64_t phase = 0; // position in history, 32.32 fixed point
+    std::vector<int16_t> history; // channel-converted source-rate frames not yet consumed
+    std::vector<int16_t> pending; // converted output, interleaved dst_channels
+    size_t read_offset = 0; // samples of pending already handed out
+};
@@ -17,24 +17,29 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <functional>
-#include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <shared_mutex>
+#include <utility>
 #include <vector>
 
+#include <audio/resampler.h>
+
 #include <psp2/types.h>
 
 #include <SDL_audio.h>
 
-typedef std::shared_ptr<SDL_AudioStream> AudioStreamPtr;
+typedef std::shared_ptr<AudioResampler> AudioResamplerPtr;
 typedef std::function<void(SceUID)> ResumeAudioThread;
 
 struct AudioOutput {
     const uint8_t *buf = nullptr;
     int len_bytes = 0;
-    SceUID thread = -1;
+    SceUID thread = -1; // thread to wake on consumption, or -1 for a credit (non-blocking) output
+    std::vector<uint8_t> data; // owns the samples for credit outputs, whose guest buffer is reusable immediately
 };
 
 struct ReadOnlyAudioOutPortState {
@@ -42,22 +47,90 @@ struct ReadOnlyAudioOutPortState {
 };
 
 struct AudioCallbackOutPortState {
-    AudioStreamPtr stream;
+    AudioResamplerPtr resampler;
+};
+
+// Bounded single-producer single-consumer ring carrying queued outputs from
+// the guest thread to the SDL audio callback. The producer fills a slot and
+// publishes head with a release store; the callback reads with acquire loads
+// and retires tail the same way, so neither side takes a lock. The old mutex
+// was contended at audio-period rate and showed up as underruns under load.
+// Single producer holds: a port's outputs come from one guest audio thread,
+// which blocks after each queued buffer until the callback drains it.
+struct AudioOutputRing {
+    static constexpr uint32_t capacity = 16; // must stay a power of two
+
+    // Producer-side push is two-step: claim the next slot, fill it in
+    // place - reusing the slot's pooled sample storage, so steady-state
+    // submission allocates nothing - then publish it.
+    AudioOutput *begin_push() {
+        const uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == capacity) {
+            return nullptr; // full
+        }
+        return &slots[h % capacity];
+    }
+
+    void commit_push() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    uint32_t size() const {
+        return head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed);
+    }
+
+    // The consumer may adjust the returned slot in place (partial puts)
+    // until it calls pop - the producer never touches a published slot.
+    AudioOutput *front() {
+        const uint32_t t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t) {
+            return nullptr; // empty
+        }
+        return &slots[t % capacity];
+    }
+
+    void pop() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    std::array<AudioOutput, capacity> slots;
+    std::atomic<uint32_t> head{ 0 }; // next slot to fill (producer)
+    std::atomic<uint32_t> tail{ 0 }; // next slot to drain (consumer)
 };
 
 struct SharedAudioOutPortState {
-    std::mutex mutex;
-    std::queue<AudioOutput> outputs;
+    AudioOutputRing outputs;
+};
+
+// Per-port telemetry, written by the audio callback and read by the GUI
+// audio panel and the periodic stats line. Counters are cumulative.
+struct AudioOutPortStats {
+    std::atomic<uint64_t> periods{ 0 }; // callback mixes of this port
+    std::atomic<uint64_t> underruns{ 0 }; // periods that came up short of a full mix
+    std::atomic<uint64_t> depth_sum{ 0 }; // ring depth sampled per period, for the average
+    std::atomic<uint64_t> mix_ns_sum{ 0 };
+    std::atomic<uint64_t> mix_ns_peak{ 0 };
+    std::atomic<uint64_t> queued_bytes{ 0 }; // ring + resampler bytes after the last mix, for the latency estimate
+
+    // Display-only depth trace for the GUI plot - the callback races the
+    // reader by design.
+    std::array<float, 128> depth_history{};
+    uint32_t depth_history_pos = 0;
 };
 
 struct AudioOutPort {
     ReadOnlyAudioOutPortState ro;
     AudioCallbackOutPortState callback;
     SharedAudioOutPortState shared;
+    AudioOutPortStats stats;
 };
 
 typedef std::shared_ptr<AudioOutPort> AudioOutPortPtr;
-typedef std::map<int, AudioOutPortPtr> AudioOutPortPtrs;
+
+// Flat slot array indexed by port id - every audio HLE call looks its port
+// up, so this stays an indexed load instead of a tree walk.
+typedef std::vector<AudioOutPortPtr> AudioOutPortPtrs;
 typedef std::shared_ptr<void> AudioDevicePtr;
 
 struct ReadOnlyAudioState {
@@ -67,11 +140,14 @@ struct ReadOnlyAudioState {
 
 struct AudioCallbackState {
     std::vector<uint8_t> temp_buffer;
+    uint64_t periods = 0; // for the periodic stats line
 };
 
 struct SharedAudioState {
-    std::mutex mutex;
-    int next_port_id = 0;
+    // Guards the port table only - port state is lock-free per port. Opens
+    // are rare and lookups happen on every audio call, so lookups take this
+    // shared and never contend with each other.
+    std::shared_mutex mutex;
     AudioOutPortPtrs out_ports;
 };
 
@@ -19,54 +19,86 @@
 
 #include <audio/state.h>
 #include <util/log.h>
+#include <util/trace.h>
 
 #include <microprofile.h>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstring>
 
 #define AUDIO_PROFILE(name) MICROPROFILE_SCOPEI("Audio", name, MP_THISTLE)
 
 static const int stream_put_granularity = 512;
 
+// ~10.9ms per period at 512 samples / 48kHz, so roughly every 11 seconds.
+static const uint64_t AUDIO_STATS_REPORT_INTERVAL = 1024;
+
 static void mix_out_port(uint8_t *stream, uint8_t *temp_buffer, int len, AudioOutPort &port, const ResumeAudioThread &resume_thread) {
     AUDIO_PROFILE(__func__);
 
-    int available_to_get = SDL_AudioStreamAvailable(port.callback.stream.get());
+    const auto mix_start = std::chrono::steady_clock::now();
+
+    const uint32_t depth = port.shared.outputs.size();
+    port.stats.depth_sum += depth;
+    port.stats.periods++;
+    port.stats.depth_history[port.stats.depth_history_pos] = static_cast<float>(depth);
+    port.stats.depth_history_pos = (port.stats.depth_history_pos + 1) % port.stats.depth_history.size();
+
+    int available_to_get = port.callback.resampler->available();
     assert(available_to_get >= 0);
 
     while (available_to_get < len) {
-        std::unique_lock<std::mutex> lock(port.shared.mutex);
-        if (port.shared.outputs.empty()) {
-            lock.unlock();
-            SDL_AudioStreamFlush(port.callback.stream.get());
+        AudioOutput *const output = port.shared.outputs.front();
+        if (!output) {
+            port.callback.resampler->flush();
             break;
         } else {
-            AudioOutput &output = port.shared.outputs.front();
-            const int bytes_to_put = std::min(stream_put_granularity, output.len_bytes);
-            const int ret = SDL_AudioStreamPut(port.callback.stream.get(), output.buf, bytes_to_put);
-            assert(ret == 0);
-            output.buf += bytes_to_put;
-            output.len_bytes -= bytes_to_put;
-            if (output.len_bytes <= 0) {
+            const int bytes_to_put = std::min(stream_put_granularity, output->len_bytes);
+            port.callback.resampler->put(output->buf, bytes_to_put);
+            output->buf += bytes_to_put;
+            output->len_bytes -= bytes_to_put;
+            if (output->len_bytes <= 0) {
+                // Retire the slot first - the wakeup takes the queued
+                // thread's own mutex, which is outside the ring's
+                // lock-free path. Credit outputs carry no thread; their
+                // producer never blocked.
+                const SceUID thread = output->thread;
                 port.shared.outputs.pop();
-                resume_thread(output.thread);
+                if (thread >= 0) {
+                    resume_thread(thread);
+                }
             }
         }
 
-        available_to_get = SDL_AudioStreamAvailable(port.callback.stream.get());
+        available_to_get = port.callback.resampler->available();
         assert(available_to_get >= 0);
     }
 
     const int bytes_to_get = std::min(len, available_to_get);
-    const int get_result = SDL_AudioStreamGet(port.callback.stream.get(), temp_buffer, bytes_to_get);
+    // A short mix on a port that had something to play is an underrun; a
+    // silent port coming up empty is just idle.
+    if ((bytes_to_get < len) && ((depth > 0) || (bytes_to_get > 0))) {
+        port.stats.underruns++;
+    }
+    const int get_result = port.callback.resampler->get(temp_buffer, bytes_to_get);
     if (get_result > 0) {
         SDL_MixAudio(stream, temp_buffer, bytes_to_get, SDL_MIX_MAXVOLUME);
     }
+
+    port.stats.queued_bytes = uint64_t(port.shared.outputs.size()) * port.ro.len_bytes + port.callback.resampler->available();
+
+    const uint64_t mix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mix_start).count();
+    port.stats.mix_ns_sum += mix_ns;
+    if (mix_ns > port.stats.mix_ns_peak) {
+        port.stats.mix_ns_peak = mix_ns;
+    }
 }
 
 static void SDLCALL audio_callback(void *userdata, Uint8 *stream, int len) {
     AUDIO_PROFILE(__func__);
+    const TraceScope trace("audio callback");
 
     assert(userdata != nullptr);
     assert(stream != nullptr);
@@ -77,10 +109,12 @@ static void SDLCALL audio_callback(void *userdata, Uint8 *stream, int len) {
     std::vector<AudioOutPortPtr> ports;
     {
         // Read from shared state.
-        const std::lock_guard<std::mutex> lock(state.shared.mutex);
+        const std::shared_lock<std::shared_mutex> lock(state.shared.mutex);
         ports.reserve(state.shared.out_ports.size());
-        for (const AudioOutPortPtrs::value_type &port : state.shared.out_ports) {
-            ports.push_back(port.second);
+        for (const AudioOutPortPtr &port : state.shared.out_ports) {
+            if (port) {
+                ports.push_back(port);
+            }
         }
     }
 
@@ -89,6 +123,25 @@ static void SDLCALL audio_callback(void *userdata, Uint8 *stream, int len) {
     for (const AudioOutPortPtr &port : ports) {
         mix_out_port(stream, state.callback.temp_buffer.data(), len, *port, state.ro.resume_thread);
     }
+
+    // Periodic stats line, one per port - cumulative counters, so glitch
+    // reports can be correlated with the gpu_timer lines around them.
+    ++state.callback.periods;
+    if ((state.callback.periods % AUDIO_STATS_REPORT_INTERVAL) == 0) {
+        const uint64_t byte_rate = uint64_t(state.ro.spec.freq) * state.ro.spec.channels * sizeof(int16_t);
+        for (size_t i = 0; i < ports.size(); ++i) {
+            const AudioOutPortStats &stats = ports[i]->stats;
+            const uint64_t periods = std::max<uint64_t>(stats.periods, 1);
+            LOG_INFO("audio port={} periods={} underruns={} avg_depth={} avg_mix_us={} peak_mix_us={} latency_ms={}",
+                i,
+                stats.periods.load(),
+                stats.underruns.load(),
+                stats.depth_sum / periods,
+                stats.mix_ns_sum / periods / 1000,
+                stats.mix_ns_peak / 1000,
+                (stats.queued_bytes + state.ro.spec.size) * 1000 / byte_rate);
+        }
+    }
 }
 
 static void close_audio(void *) {
@@ -106,9 +159,12 @@ bool init(AudioState &state, ResumeAudioThread resume_thread) {
     desired.callback = &audio_callback;
     desired.userdata = &state;
 
-    if (SDL_OpenAudio(&desired, &state.ro.spec) != 0) {
+    // Have SDL convert to whatever the device really is - the per-port
+    // resamplers are configured against this exact S16 stereo 48kHz spec.
+    if (SDL_OpenAudio(&desired, nullptr) != 0) {
         return false;
     }
+    state.ro.spec = desired;
 
     state.device = AudioDevicePtr(nullptr, close_audio);
     state.callback.temp_buffer.resize(state.ro.spec.size);
@@ -0,0 +1,121 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <audio/resampler.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+static constexpr uint64_t PHASE_ONE = uint64_t(1) << 32;
+
+AudioResampler::AudioResampler(int src_channels, int src_rate, int dst_channels, int dst_rate)
+    : src_channels(src_channels)
+    , dst_channels(dst_channels)
+    , step((uint64_t(src_rate) << 32) / dst_rate) {
+    assert((src_channels == 1) || (src_channels == 2));
+    assert((dst_channels == 1) || (dst_channels == 2));
+}
+
+void AudioResampler::append_output(const int16_t *frames, size_t frame_count) {
+    pending.insert(pending.end(), frames, frames + frame_count * dst_channels);
+}
+
+void AudioResampler::put(const uint8_t *buf, int len_bytes) {
+    const int16_t *const samples = reinterpret_cast<const int16_t *>(buf);
+    const size_t frame_count = len_bytes / (src_channels * sizeof(int16_t));
+
+    // Fast path: same rate and layout with no interpolation state in
+    // flight - the buffer is already in the output format.
+    if ((step == PHASE_ONE) && (src_channels == dst_channels) && history.empty()) {
+        append_output(samples, frame_count);
+        return;
+    }
+
+    // Channel-convert into the source-rate history the interpolator reads.
+    const size_t base = history.size();
+    history.resize(base + frame_count * dst_channels);
+    if (src_channels == dst_channels) {
+        std::memcpy(history.data() + base, samples, frame_count * dst_channels * sizeof(int16_t));
+    } else if ((src_channels == 1) && (dst_channels == 2)) {
+        for (size_t i = 0; i < frame_count; ++i) {
+            history[base + i * 2] = samples[i];
+            history[base + i * 2 + 1] = samples[i];
+        }
+    } else {
+        for (size_t i = 0; i < frame_count; ++i) {
+            history[base + i] = static_cast<int16_t>((samples[i * 2] + samples[i * 2 + 1]) / 2);
+        }
+    }
+
+    // Linear-phase kernel: each output frame blends the pair of source
+    // frames its 32.32 phase lands between. One plain loop per channel
+    // layout over the whole buffer, so the compiler vectorizes it.
+    const size_t history_frames = history.size() / dst_channels;
+    if (history_frames < 2) {
+        return; // need a successor frame to interpolate towards
+    }
+
+    const size_t out_frames = ((uint64_t(history_frames - 1) << 32) - phase + step - 1) / step;
+    const size_t out_base = pending.size();
+    pending.resize(out_base + out_frames * dst_channels);
+    uint64_t p = phase;
+    for (size_t i = 0; i < out_frames; ++i, p += step) {
+        const size_t index = p >> 32;
+        const int32_t frac = static_cast<int32_t>((p & 0xffffffff) >> 17); // 15-bit blend weight
+        for (int c = 0; c < dst_channels; ++c) {
+            const int32_t a = history[index * dst_channels + c];
+            const int32_t b = history[(index + 1) * dst_channels + c];
+            pending[out_base + i * dst_channels + c] = static_cast<int16_t>(a + (((b - a) * frac) >> 15));
+        }
+    }
+    phase = p;
+
+    // Drop fully consumed history frames, keeping the interpolation pair.
+    const size_t consumed = phase >> 32;
+    history.erase(history.begin(), history.begin() + consumed * dst_channels);
+    phase &= 0xffffffff;
+}
+
+void AudioResampler::flush() {
+    // The final source frame has no successor to blend towards - emit it
+    // as-is and start the next buffer clean.
+    if (!history.empty()) {
+        append_output(history.data() + history.size() - dst_channels, 1);
+        history.clear();
+    }
+    phase = 0;
+}
+
+int AudioResampler::available() const {
+    return static_cast<int>((pending.size() - read_offset) * sizeof(int16_t));
+}
+
+int AudioResampler::get(uint8_t *buf, int len_bytes) {
+    const int bytes = std::min(len_bytes, available());
+    std::memcpy(buf, pending.data() + read_offset, bytes);
+    read_offset += bytes / sizeof(int16_t);
+
+    // Compact once everything handed out - keeps the buffer from growing
+    // without shuffling on every period.
+    if (read_offset == pending.size()) {
+        pending.clear();
+        read_offset = 0;
+    }
+
+    return bytes;
+}
@@ -0,0 +1,159 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+// Microbenchmarks for the primitives every frame touches. Run before and
+// after an optimization and paste both tables into the PR. The harness is a
+// plain timed loop - wall-clock medians over enough iterations are stable
+// to a few percent, which is all these numbers are for.
+
+#include <crypto/hash.h>
+#include <disasm/functions.h>
+#include <disasm/state.h>
+#include <io/functions.h>
+#include <io/state.h>
+#include <kernel/state.h>
+#include <kernel/thread/sync_primitives.h>
+#include <kernel/thread/thread_state.h>
+#include <mem/mem.h>
+#include <module/lay_out_args.h>
+#include <util/log.h>
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// Results funnel through here so the optimizer cannot delete a loop body.
+static volatile uint64_t g_sink;
+
+template <typename Body>
+static void run_bench(const char *name, uint64_t iterations, Body body) {
+    using Clock = std::chrono::steady_clock;
+
+    // One untimed pass to warm caches and lazy initialization.
+    body();
+
+    const auto start = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        body();
+    }
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    std::printf("%-32s %10" PRIu64 " iters %12.1f ns/op\n", name, iterations, static_cast<double>(ns) / iterations);
+}
+
+static void bench_mem(MemState &mem) {
+    run_bench("mem alloc/free 4K", 1 << 18, [&mem]() {
+        const Address block = alloc(mem, 4096, "bench");
+        g_sink = block;
+        free(mem, block);
+    });
+}
+
+static void bench_hash() {
+    // hash64 is the kernel of hash_texture_data - the rest of that function
+    // is size computation. 256K is a typical mid-size texture level.
+    std::vector<uint8_t> data(256 * 1024);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i);
+    }
+
+    run_bench("hash64 256K (texture hash)", 1 << 12, [&data]() {
+        g_sink = hash64(data.data(), data.size());
+    });
+}
+
+static void bench_translate_path() {
+    IOState io;
+    io.device_paths.app0 = "ux0:app/BENCH00000/";
+    io.device_paths.savedata0 = "ux0:user/00/savedata/BENCH00000/";
+    io.device_paths.addcont0 = "ux0:addcont/BENCH00000/";
+
+    const std::string path = "app0:data/file.bin";
+    run_bench("translate_path_cached hit", 1 << 18, [&io, &path]() {
+        const TranslatedPath &translated = translate_path_cached(io, path);
+        g_sink = translated.path.size();
+    });
+}
+
+static void bench_lay_out_args() {
+    // Layouts are constexpr, so the right answer here is "free" - this
+    // exists to catch that property regressing to a runtime computation.
+    run_bench("lay_out_args 4-arg bridge", 1 << 20, []() {
+        const auto layout = lay_out<int32_t, int64_t, float, int32_t>();
+        g_sink = layout[3].offset;
+    });
+}
+
+static void bench_disassemble() {
+    DisasmState disasm;
+    if (!init(disasm)) {
+        std::printf("%-32s skipped (capstone init failed)\n", "disassemble");
+        return;
+    }
+
+    const uint8_t nop[] = { 0x00, 0x00, 0xa0, 0xe1 }; // mov r0, r0
+    run_bench("disassemble 1 ARM insn", 1 << 16, [&disasm, &nop]() {
+        const std::string text = disassemble(disasm, nop, sizeof(nop), 0x81000000, false);
+        g_sink = text.size();
+    });
+}
+
+static void bench_mutex(KernelState &kernel, SceUID thread_id) {
+    SceUID mutexid = 0;
+    if (mutex_create(&mutexid, kernel, "bench", thread_id, "bench_mutex", 0, 0, nullptr, SyncWeight::Heavy) < 0) {
+        std::printf("%-32s skipped (create failed)\n", "mutex lock/unlock");
+        return;
+    }
+
+    run_bench("mutex lock/unlock uncontended", 1 << 18, [&kernel, thread_id, mutexid]() {
+        mutex_lock(kernel, "bench", thread_id, mutexid, 1, nullptr, SyncWeight::Heavy);
+        mutex_unlock(kernel, "bench", thread_id, mutexid, 1, SyncWeight::Heavy);
+    });
+
+    mutex_delete(kernel, "bench", thread_id, mutexid, SyncWeight::Heavy);
+}
+
+int main() {
+    init_logging();
+
+    MemState mem;
+    if (!init(mem)) {
+        std::printf("mem init failed\n");
+        return 1;
+    }
+
+    // The sync benches need a registered thread for lock_and_find; it never
+    // runs guest code, so scheduling fields at rest are enough.
+    KernelState kernel;
+    const SceUID thread_id = kernel.threads.alloc();
+    const ThreadStatePtr thread = std::make_shared<ThreadState>();
+    thread->id = thread_id;
+    thread->priority = 0x10000100;
+    kernel.threads.set(thread_id, thread);
+
+    bench_mem(mem);
+    bench_hash();
+    bench_translate_path();
+    bench_lay_out_args();
+    bench_disassemble();
+    bench_mutex(kernel, thread_id);
+
+    return 0;
+}
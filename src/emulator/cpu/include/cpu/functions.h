@@ -21,6 +21,9 @@
 
 #include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 struct CPUState;
 struct MemState;
@@ -28,7 +31,66 @@ struct MemState;
 typedef std::function<void(CPUState &cpu, uint32_t, Address)> CallSVC;
 typedef std::unique_ptr<CPUState, std::function<void(CPUState *)>> CPUStatePtr;
 
-CPUStatePtr init_cpu(Address pc, Address sp, bool log_code, CallSVC call_svc, MemState &mem);
+enum class CPUBackend {
+    Unicorn,
+    Dynarmic,
+};
+
+// Instrumentation tiers, from cheapest to most detailed. Off installs no
+// hooks at all, so untraced execution pays nothing. The higher tiers can be
+// engaged on a live session, optionally restricted to a PC range.
+enum class TraceTier {
+    Off,
+    Code, // disassemble every executed instruction
+    Memory, // Code plus guest load/store logging
+};
+
+// Full register file of one guest thread, exchanged with the backend in
+// bulk. fpu_used is false when the VFP file was still in its power-on
+// all-zero state at save time, letting load_context skip the 32 double
+// registers for threads that never touched the FPU.
+struct CPUContext {
+    uint32_t cpu_registers[16] = {}; // r0-r12, sp, lr, pc
+    uint64_t fpu_registers[32] = {}; // d0-d31
+    uint32_t cpsr = 0;
+    uint32_t fpscr = 0;
+    bool fpu_used = false;
+};
+
+// Recycles initialized CPU instances across guest thread lifetimes. Engine
+// construction - Unicorn open, mapping the 4GB arena, hook installation -
+// costs milliseconds, which titles spawning a worker per job pay on every
+// spawn. A recycled instance keeps its translation and SVC caches warm and
+// only needs a register reset. Guarded by its own mutex; thread create and
+// delete are rare enough that contention is a non-issue.
+struct CPUPool {
+    std::mutex mutex;
+    std::vector<CPUStatePtr> free_list;
+};
+
+CPUStatePtr init_cpu(CPUBackend backend, Address pc, Address sp, bool log_code, CallSVC call_svc, MemState &mem);
+// Hands out a pooled instance with a matching configuration when one is
+// free, falling back to init_cpu. The recycled engine gets its pristine
+// register file back before being pointed at the new entry point.
+CPUStatePtr acquire_cpu(CPUPool &pool, CPUBackend backend, Address pc, Address sp, bool log_code, CallSVC call_svc, MemState &mem);
+// Returns an instance to the pool, or lets it die if the pool is full.
+void release_cpu(CPUPool &pool, CPUStatePtr state);
+// Retired guest instructions, summed over every CPU instance in the process
+// since startup. Monotonic; sample it twice and divide by the interval for
+// MIPS. Unicorn counts per translated block, Dynarmic per retired block, so
+// the counter costs nothing measurable on either backend.
+uint64_t cpu_instructions_executed();
+// Backend-internal: credit retired instructions to the process counter.
+void cpu_count_instructions(uint64_t count);
+// Runs the built-in ARM integer benchmark (a dhrystone-style dependent
+// add/eor/orr loop) on a fresh CPU instance for roughly a second and returns
+// the score in MIPS, or a negative value on failure. Guest memory for the
+// payload is borrowed from mem and released afterwards.
+double run_cpu_benchmark(CPUBackend backend, MemState &mem);
+// Instruction budget per run() slice; 0 runs unsliced to the next stop.
+void set_execution_quantum(CPUState &state, uint64_t instructions);
+// A trace_begin/trace_end of 0/0 traces the whole address space.
+void set_trace_tier(CPUState &state, TraceTier tier, Address trace_begin = 0, Address trace_end = 0);
 int run(CPUState &state, bool callback);
 void stop(CPUState &state);
 uint32_t read_reg(CPUState &state, size_t index);
@@ -36,7 +98,10 @@ float read_float_reg(CPUState &state, size_t index);
 uint32_t read_sp(CPUState &state);
 uint32_t read_pc(CPUState &state);
 uint32_t read_lr(CPUState &state);
+bool is_thumb_mode(CPUState &state);
 void write_reg(CPUState &state, size_t index, uint32_t value);
 void write_sp(CPUState &state, uint32_t value);
 void write_pc(CPUState &state, uint32_t value);
 void write_lr(CPUState &state, uint32_t value);
+void save_context(CPUState &state, CPUContext &ctx);
+void load_context(CPUState &state, const CPUContext &ctx);
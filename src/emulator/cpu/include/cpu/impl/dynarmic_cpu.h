@@ -0,0 +1,68 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <cpu/impl/interface.h>
+
+#include <mem/mem.h> // Address.
+
+#include <dynarmic/A32/a32.h>
+
+#include <atomic>
+#include <memory>
+
+struct CPUState;
+class ArmDynarmicCallbacks;
+
+// Recompiling backend built on Dynarmic. Guest code is translated to host
+// machine code block by block, and loads/stores hit the 4GB arena directly.
+// HLE calls halt the jit at the SVC so the service runs outside translated
+// code, mirroring the Unicorn interrupt hook.
+class DynarmicCPU : public CPUInterface {
+    friend class ArmDynarmicCallbacks;
+
+    CPUState *state = nullptr;
+    std::unique_ptr<ArmDynarmicCallbacks> callbacks;
+    std::unique_ptr<Dynarmic::A32::Jit> jit;
+    std::atomic<bool> interrupted{ false };
+    bool sliced = false; // this run() honours the execution quantum
+    TraceTier trace_tier = TraceTier::Off;
+    Address trace_begin = 0;
+    Address trace_end = 0;
+
+public:
+    DynarmicCPU(CPUState *state, Address pc, Address sp, bool log_code);
+    ~DynarmicCPU();
+
+    int run(bool callback) override;
+    void stop() override;
+
+    uint32_t get_reg(size_t index) override;
+    void set_reg(size_t index, uint32_t value) override;
+    float get_float_reg(size_t index) override;
+    uint32_t get_sp() override;
+    void set_sp(uint32_t value) override;
+    uint32_t get_pc() override;
+    void set_pc(uint32_t value) override;
+    uint32_t get_lr() override;
+    void set_lr(uint32_t value) override;
+    bool is_thumb_mode() override;
+    void save_context(CPUContext &ctx) override;
+    void load_context(const CPUContext &ctx) override;
+    void set_tracing(TraceTier tier, Address trace_begin, Address trace_end) override;
+};
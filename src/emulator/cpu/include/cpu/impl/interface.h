@@ -0,0 +1,48 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <cpu/functions.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// Interface implemented by every CPU execution engine. The free functions in
+// cpu/functions.h forward to the backend held by CPUState, so the rest of the
+// emulator never depends on a specific engine.
+class CPUInterface {
+public:
+    virtual ~CPUInterface() = default;
+
+    virtual int run(bool callback) = 0;
+    virtual void stop() = 0;
+
+    virtual uint32_t get_reg(size_t index) = 0;
+    virtual void set_reg(size_t index, uint32_t value) = 0;
+    virtual float get_float_reg(size_t index) = 0;
+    virtual uint32_t get_sp() = 0;
+    virtual void set_sp(uint32_t value) = 0;
+    virtual uint32_t get_pc() = 0;
+    virtual void set_pc(uint32_t value) = 0;
+    virtual uint32_t get_lr() = 0;
+    virtual void set_lr(uint32_t value) = 0;
+    virtual bool is_thumb_mode() = 0;
+    virtual void save_context(CPUContext &ctx) = 0;
+    virtual void load_context(const CPUContext &ctx) = 0;
+    virtual void set_tracing(TraceTier tier, Address trace_begin, Address trace_end) = 0;
+};
@@ -0,0 +1,82 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <cpu/impl/interface.h>
+
+#include <mem/mem.h> // Address.
+
+#include <unicorn/unicorn.h>
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+struct CPUState;
+
+typedef std::unique_ptr<uc_struct, std::function<void(uc_struct *)>> UnicornPtr;
+
+// Interpreting backend built on Unicorn. This is the reference engine - it is
+// slow, but well tested, and stays available as a fallback/verification mode
+// next to any recompiler.
+class UnicornCPU : public CPUInterface {
+    CPUState *state = nullptr;
+    UnicornPtr uc;
+    uc_hook code_hook_handle = 0;
+    uc_hook read_hook_handle = 0;
+    uc_hook write_hook_handle = 0;
+
+    // Thumb/ARM mode, refreshed at the points it can change (block entry,
+    // context load) so the hot paths read a bool instead of issuing a
+    // uc_query round-trip per event. A fresh engine starts in ARM mode.
+    bool thumb_mode_cached = false;
+
+    // SVC immediates keyed by trap PC. Import thunks are immutable, so a
+    // site decodes once and hits the cache on every later call.
+    std::unordered_map<Address, uint32_t> svc_immediates;
+
+    // The FPU starts switched off and is enabled on the first VFP/NEON
+    // instruction, which traps as undefined. Integer-only threads - most of
+    // a title's helpers - never flip this and skip the VFP file on every
+    // context save.
+    bool fpu_enabled = false;
+
+    static void code_hook(uc_engine *uc, uint64_t address, uint32_t size, void *user_data);
+    static void block_hook(uc_engine *uc, uint64_t address, uint32_t size, void *user_data);
+    static void intr_hook(uc_engine *uc, uint32_t intno, void *user_data);
+
+public:
+    UnicornCPU(CPUState *state, Address pc, Address sp, bool log_code);
+
+    int run(bool callback) override;
+    void stop() override;
+
+    uint32_t get_reg(size_t index) override;
+    void set_reg(size_t index, uint32_t value) override;
+    float get_float_reg(size_t index) override;
+    uint32_t get_sp() override;
+    void set_sp(uint32_t value) override;
+    uint32_t get_pc() override;
+    void set_pc(uint32_t value) override;
+    uint32_t get_lr() override;
+    void set_lr(uint32_t value) override;
+    bool is_thumb_mode() override;
+    void save_context(CPUContext &ctx) override;
+    void load_context(const CPUContext &ctx) override;
+    void set_tracing(TraceTier tier, Address trace_begin, Address trace_end) override;
+};
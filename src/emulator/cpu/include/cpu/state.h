@@ -0,0 +1,46 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <cpu/functions.h>
+
+#include <disasm/state.h>
+
+#include <memory>
+
+class CPUInterface;
+
+struct CPUState {
+    MemState *mem = nullptr;
+    CallSVC call_svc;
+    DisasmState disasm;
+    Address entry_point;
+    std::unique_ptr<CPUInterface> cpu;
+
+    // Instruction budget per run() slice, 0 for unsliced. With a quantum the
+    // backend hands control back to the kernel loop every N instructions so
+    // compute-heavy threads cannot starve their siblings between syscalls.
+    uint64_t execution_quantum = 0;
+
+    // Pool bookkeeping: the configuration this instance was built with and
+    // the register file captured right after construction, reloaded when the
+    // instance is recycled for a new guest thread.
+    CPUBackend backend = CPUBackend::Unicorn;
+    bool log_code = false;
+    CPUContext pristine_context;
+};
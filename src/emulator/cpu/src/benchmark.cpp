@@ -0,0 +1,99 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+// Built-in CPU throughput benchmark. A hand-assembled ARM integer loop is
+// written into guest memory and run on a fresh CPU instance, so the score
+// measures the backend alone - no kernel, no HLE, no other threads. The
+// loop is dependent arithmetic in the dhrystone spirit: short, branchy,
+// and impossible for a recompiler to fold away without doing real work.
+
+#include <cpu/functions.h>
+
+#include <cpu/state.h>
+#include <mem/ptr.h>
+#include <util/log.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+// r0 counts down; r1-r3 form a dependency chain off it. Only subs sets
+// flags, so they survive to the bne at the bottom. The final svc is the
+// exit - the benchmark's SVC handler stops the CPU.
+static constexpr uint32_t payload[] = {
+    0xe2500001, // loop: subs r0, r0, #1
+    0xe0811000, //       add  r1, r1, r0
+    0xe0222001, //       eor  r2, r2, r1
+    0xe1833002, //       orr  r3, r3, r2
+    0x1afffffa, //       bne  loop
+    0xef000000, //       svc  #0
+};
+
+static constexpr uint64_t instructions_per_iteration = 5;
+
+// Returns wall time for one run of the loop, or a negative value if the
+// backend failed to come up.
+static double run_pass(CPUBackend backend, MemState &mem, Address code, Address sp, uint32_t iterations) {
+    const CallSVC stop_on_svc = [](CPUState &state, uint32_t, Address) {
+        stop(state);
+    };
+    const CPUStatePtr cpu = init_cpu(backend, code, sp, false, stop_on_svc, mem);
+    if (!cpu) {
+        return -1.0;
+    }
+    write_reg(*cpu, 0, iterations);
+
+    const auto start = std::chrono::steady_clock::now();
+    run(*cpu, false);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double run_cpu_benchmark(CPUBackend backend, MemState &mem) {
+    const Address code = alloc(mem, sizeof(payload), "cpu benchmark code");
+    const Address stack = alloc(mem, KB(4), "cpu benchmark stack");
+    double mips = -1.0;
+
+    if (code && stack) {
+        memcpy(Ptr<void>(code).get(mem), payload, sizeof(payload));
+        const Address sp = stack + static_cast<Address>(KB(4));
+
+        // A short calibration pass sizes the timed pass to about a second
+        // of execution, which keeps the score stable across backends that
+        // differ by two orders of magnitude in throughput.
+        const uint32_t calibration_iterations = 1 << 18;
+        const double calibration_seconds = run_pass(backend, mem, code, sp, calibration_iterations);
+        if (calibration_seconds > 0.0) {
+            uint64_t iterations = static_cast<uint64_t>(calibration_iterations / calibration_seconds);
+            iterations = std::max<uint64_t>(calibration_iterations, std::min<uint64_t>(iterations, 1ull << 28));
+
+            const double seconds = run_pass(backend, mem, code, sp, static_cast<uint32_t>(iterations));
+            if (seconds > 0.0) {
+                mips = (iterations * instructions_per_iteration) / seconds / 1e6;
+            }
+        }
+    } else {
+        LOG_ERROR("Could not allocate guest memory for the CPU benchmark.");
+    }
+
+    if (code) {
+        free(mem, code);
+    }
+    if (stack) {
+        free(mem, stack);
+    }
+    return mips;
+}
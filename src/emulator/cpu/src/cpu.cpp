@@ -17,276 +17,180 @@
 
 #include <cpu/functions.h>
 
+#include <cpu/impl/unicorn_cpu.h>
+#include <cpu/state.h>
 #include <disasm/functions.h>
-#include <disasm/state.h>
-#include <mem/ptr.h>
 #include <util/log.h>
 
-#include <unicorn/unicorn.h>
+#ifdef USE_DYNARMIC
+#include <cpu/impl/dynarmic_cpu.h>
+#endif
 
+#include <atomic>
 #include <cassert>
-#include <cstring>
-#include <iomanip>
-#include <iostream>
 
-typedef std::unique_ptr<uc_struct, std::function<void(uc_struct *)>> UnicornPtr;
-
-union DoubleReg {
-    double d;
-    float f[2];
-};
-
-struct CPUState {
-    MemState *mem = nullptr;
-    CallSVC call_svc;
-    DisasmState disasm;
-    UnicornPtr uc;
-    Address entry_point;
-};
-
-static const bool LOG_CODE = true;
-static const bool LOG_MEM_ACCESS = false;
+// One process-wide counter rather than a per-CPUState field: guest threads
+// come and go, and the HUD wants a total that survives them. Relaxed is
+// enough - nothing is ordered against it, it is only ever read for display.
+static std::atomic<uint64_t> g_instructions_executed(0);
 
 static void delete_cpu_state(CPUState *state) {
     delete state;
 }
 
-static bool is_thumb_mode(uc_engine *uc) {
-    size_t mode = 0;
-    const uc_err err = uc_query(uc, UC_QUERY_MODE, &mode);
-    assert(err == UC_ERR_OK);
-
-    return mode & UC_MODE_THUMB;
+uint64_t cpu_instructions_executed() {
+    return g_instructions_executed.load(std::memory_order_relaxed);
 }
 
-static void code_hook(uc_engine *uc, uint64_t address, uint32_t size, void *user_data) {
-    CPUState &state = *static_cast<CPUState *>(user_data);
-    const MemState &mem = *state.mem;
-    const uint8_t *const code = Ptr<const uint8_t>(static_cast<Address>(address)).get(mem);
-    const size_t buffer_size = GB(4) - address;
-    const bool thumb = is_thumb_mode(uc);
-    const std::string disassembly = disassemble(state.disasm, code, buffer_size, address, thumb);
-    LOG_TRACE("{} {}", log_hex(address), disassembly);
+void cpu_count_instructions(uint64_t count) {
+    g_instructions_executed.fetch_add(count, std::memory_order_relaxed);
 }
 
-static void log_memory_access(const char *type, Address address, int size, int64_t value, const MemState &mem) {
-    const char *const name = mem_name(address, mem);
-    LOG_TRACE("{} {} bytes, address {} ( {} ), value {}", type, size, address, name, log_hex(value));
-}
-
-static void read_hook(uc_engine *uc, uc_mem_type type, uint64_t address, int size, int64_t value, void *user_data) {
-    assert(value == 0);
-
-    const CPUState &state = *static_cast<const CPUState *>(user_data);
-    const MemState &mem = *state.mem;
-    memcpy(&value, Ptr<const void>(static_cast<Address>(address)).get(mem), size);
-    log_memory_access("Read", static_cast<Address>(address), size, value, mem);
-}
-
-static void write_hook(uc_engine *uc, uc_mem_type type, uint64_t address, int size, int64_t value, void *user_data) {
-    const CPUState &state = *static_cast<const CPUState *>(user_data);
-    const MemState &mem = *state.mem;
-    log_memory_access("Write", static_cast<Address>(address), size, value, mem);
-}
-
-static void intr_hook(uc_engine *uc, uint32_t intno, void *user_data) {
-    assert(intno == 2);
-
-    CPUState &state = *static_cast<CPUState *>(user_data);
-
-    uint32_t pc = 0;
-    uc_err err = uc_reg_read(uc, UC_ARM_REG_PC, &pc);
-    assert(err == UC_ERR_OK);
-
-    if (is_thumb_mode(uc)) {
-        const Address svc_address = pc - 2;
-        uint16_t svc_instruction = 0;
-        err = uc_mem_read(uc, svc_address, &svc_instruction, sizeof(svc_instruction));
-        assert(err == UC_ERR_OK);
-        const uint8_t imm = svc_instruction & 0xff;
-        state.call_svc(state, imm, pc);
-    } else {
-        const Address svc_address = pc - 4;
-        uint32_t svc_instruction = 0;
-        err = uc_mem_read(uc, svc_address, &svc_instruction, sizeof(svc_instruction));
-        assert(err == UC_ERR_OK);
-        const uint32_t imm = svc_instruction & 0xffffff;
-        state.call_svc(state, imm, pc);
-    }
-}
+// Pooled instances beyond this just die with their engine - enough headroom
+// for spawn-per-job churn without keeping dozens of idle engines resident.
+static constexpr size_t CPU_POOL_MAX_FREE = 16;
 
-static void enable_vfp_fpu(uc_engine *uc) {
-    uint64_t c1_c0_2 = 0;
-    uc_err err = uc_reg_read(uc, UC_ARM_REG_C1_C0_2, &c1_c0_2);
-    assert(err == UC_ERR_OK);
-
-    c1_c0_2 |= (0xf << 20);
-
-    err = uc_reg_write(uc, UC_ARM_REG_C1_C0_2, &c1_c0_2);
-    assert(err == UC_ERR_OK);
-
-    const uint64_t fpexc = 0xf0000000;
-
-    err = uc_reg_write(uc, UC_ARM_REG_FPEXC, &fpexc);
-    assert(err == UC_ERR_OK);
-}
-
-CPUStatePtr init_cpu(Address pc, Address sp, bool log_code, CallSVC call_svc, MemState &mem) {
+CPUStatePtr init_cpu(CPUBackend backend, Address pc, Address sp, bool log_code, CallSVC call_svc, MemState &mem) {
     CPUStatePtr state(new CPUState(), delete_cpu_state);
     state->mem = &mem;
     state->call_svc = call_svc;
     state->entry_point = pc;
+    state->backend = backend;
+    state->log_code = log_code;
 
     if (!init(state->disasm)) {
         return CPUStatePtr();
     }
 
-    uc_engine *temp_uc = nullptr;
-    uc_err err = uc_open(UC_ARCH_ARM, UC_MODE_ARM, &temp_uc);
-    assert(err == UC_ERR_OK);
-
-    state->uc = UnicornPtr(temp_uc, uc_close);
-    temp_uc = nullptr;
-
-    uc_hook hh = 0;
-    if (log_code && LOG_CODE) {
-        const uc_err err = uc_hook_add(state->uc.get(), &hh, UC_HOOK_CODE, reinterpret_cast<void *>(&code_hook), state.get(), 1, 0);
-        assert(err == UC_ERR_OK);
+    switch (backend) {
+    case CPUBackend::Dynarmic:
+#ifdef USE_DYNARMIC
+        state->cpu = std::make_unique<DynarmicCPU>(state.get(), pc, sp, log_code);
+        break;
+#else
+        LOG_WARN("Dynarmic backend not compiled in, falling back to Unicorn.");
+        // Fallthrough.
+#endif
+    case CPUBackend::Unicorn:
+        state->cpu = std::make_unique<UnicornCPU>(state.get(), pc, sp, log_code);
+        break;
     }
 
-    if (LOG_MEM_ACCESS) {
-        uc_err err = uc_hook_add(state->uc.get(), &hh, UC_HOOK_MEM_READ, reinterpret_cast<void *>(&read_hook), state.get(), 1, 0);
-        assert(err == UC_ERR_OK);
-
-        err = uc_hook_add(state->uc.get(), &hh, UC_HOOK_MEM_WRITE, reinterpret_cast<void *>(&write_hook), state.get(), 1, 0);
-        assert(err == UC_ERR_OK);
+    if (!state->cpu) {
+        return CPUStatePtr();
     }
 
-    err = uc_hook_add(state->uc.get(), &hh, UC_HOOK_INTR, reinterpret_cast<void *>(&intr_hook), state.get(), 1, 0);
-    assert(err == UC_ERR_OK);
-
-    err = uc_reg_write(state->uc.get(), UC_ARM_REG_SP, &sp);
-    assert(err == UC_ERR_OK);
-
-    err = uc_mem_map_ptr(state->uc.get(), 0, GB(4), UC_PROT_ALL, &mem.memory[0]);
-    assert(err == UC_ERR_OK);
-
-    err = uc_reg_write(state->uc.get(), UC_ARM_REG_PC, &pc);
-
-    assert(err == UC_ERR_OK);
-
-    err = uc_reg_write(state->uc.get(), UC_ARM_REG_LR, &pc);
-
-    assert(err == UC_ERR_OK);
-
-    enable_vfp_fpu(state->uc.get());
+    // Capture the power-on register file for recycling. The VFP file is
+    // left alone: register state at thread entry is undefined anyway, so a
+    // previous tenant's FP leftovers are harmless and skipping them keeps
+    // recycled integer-only threads on the cheap path.
+    state->cpu->save_context(state->pristine_context);
 
     return state;
 }
 
-int run(CPUState &state, bool callback) {
-    std::uint32_t pc = read_pc(state);
-    bool thumb_mode = is_thumb_mode(state.uc.get());
-    if (thumb_mode) {
-        pc |= 1;
-    }
-    if (callback) {
-        uc_reg_write(state.uc.get(), UC_ARM_REG_LR, &state.entry_point);
+CPUStatePtr acquire_cpu(CPUPool &pool, CPUBackend backend, Address pc, Address sp, bool log_code, CallSVC call_svc, MemState &mem) {
+    {
+        const std::lock_guard<std::mutex> lock(pool.mutex);
+        for (auto entry = pool.free_list.begin(); entry != pool.free_list.end(); ++entry) {
+            CPUStatePtr &candidate = *entry;
+            if ((candidate->backend != backend) || (candidate->log_code != log_code) || (candidate->mem != &mem)) {
+                continue;
+            }
+            CPUStatePtr state = std::move(candidate);
+            pool.free_list.erase(entry);
+
+            state->cpu->load_context(state->pristine_context);
+            state->cpu->set_pc(pc);
+            state->cpu->set_sp(sp);
+            state->cpu->set_lr(pc); // the constructor seeds LR = PC too
+            state->entry_point = pc;
+            state->call_svc = call_svc;
+            return state;
+        }
     }
-    uc_err err = uc_emu_start(state.uc.get(), pc, 0, 0, 1);
-    pc = read_pc(state);
-    thumb_mode = is_thumb_mode(state.uc.get());
-    if (thumb_mode) {
-        pc |= 1;
-    }
-    err = uc_emu_start(state.uc.get(), pc, state.entry_point & 0xfffffffe, 0, 0);
+    return init_cpu(backend, pc, sp, log_code, call_svc, mem);
+}
 
-    if (err != UC_ERR_OK) {
-        std::uint32_t error_pc = read_pc(state);
-        uint32_t lr = read_lr(state);
-        LOG_CRITICAL("Unicorn error {} at: start PC: {} error PC {} LR: {}", log_hex(err), log_hex(pc), log_hex(error_pc), log_hex(lr));
-        return -1;
+void release_cpu(CPUPool &pool, CPUStatePtr state) {
+    if (!state) {
+        return;
     }
-    pc = read_pc(state);
-    thumb_mode = is_thumb_mode(state.uc.get());
-    if (thumb_mode) {
-        pc |= 1;
+    const std::lock_guard<std::mutex> lock(pool.mutex);
+    if (pool.free_list.size() >= CPU_POOL_MAX_FREE) {
+        return; // drops the last reference; the engine is torn down here
     }
-    if (pc == state.entry_point)
-        return 1;
-    return 0;
+    pool.free_list.push_back(std::move(state));
+}
+
+void set_execution_quantum(CPUState &state, uint64_t instructions) {
+    state.execution_quantum = instructions;
+}
+
+void set_trace_tier(CPUState &state, TraceTier tier, Address trace_begin, Address trace_end) {
+    state.cpu->set_tracing(tier, trace_begin, trace_end);
+}
+
+int run(CPUState &state, bool callback) {
+    return state.cpu->run(callback);
 }
 
 void stop(CPUState &state) {
-    const uc_err err = uc_emu_stop(state.uc.get());
-    assert(err == UC_ERR_OK);
+    state.cpu->stop();
 }
 
 uint32_t read_reg(CPUState &state, size_t index) {
     assert(index >= 0);
     assert(index <= 3);
 
-    uint32_t value = 0;
-    const uc_err err = uc_reg_read(state.uc.get(), UC_ARM_REG_R0 + index, &value);
-    assert(err == UC_ERR_OK);
-
-    return value;
+    return state.cpu->get_reg(index);
 }
 
 float read_float_reg(CPUState &state, size_t index) {
     assert(index >= 0);
 
-    DoubleReg value;
-
-    int single_index = index / 2;
-    const uc_err err = uc_reg_read(state.uc.get(), UC_ARM_REG_D0 + single_index, &value);
-    assert(err == UC_ERR_OK);
-    return value.f[index % 2];
+    return state.cpu->get_float_reg(index);
 }
 
 uint32_t read_sp(CPUState &state) {
-    uint32_t value = 0;
-    const uc_err err = uc_reg_read(state.uc.get(), UC_ARM_REG_SP, &value);
-    assert(err == UC_ERR_OK);
-
-    return value;
+    return state.cpu->get_sp();
 }
 
 uint32_t read_pc(CPUState &state) {
-    uint32_t value = 0;
-    const uc_err err = uc_reg_read(state.uc.get(), UC_ARM_REG_PC, &value);
-    assert(err == UC_ERR_OK);
-
-    return value;
+    return state.cpu->get_pc();
 }
 
 uint32_t read_lr(CPUState &state) {
-    uint32_t value = 0;
-    const uc_err err = uc_reg_read(state.uc.get(), UC_ARM_REG_LR, &value);
-    assert(err == UC_ERR_OK);
+    return state.cpu->get_lr();
+}
 
-    return value;
+bool is_thumb_mode(CPUState &state) {
+    return state.cpu->is_thumb_mode();
 }
 
 void write_reg(CPUState &state, size_t index, uint32_t value) {
     assert(index >= 0);
     assert(index <= 1);
 
-    const uc_err err = uc_reg_write(state.uc.get(), UC_ARM_REG_R0 + index, &value);
-    assert(err == UC_ERR_OK);
+    state.cpu->set_reg(index, value);
 }
 
 void write_sp(CPUState &state, uint32_t value) {
-    const uc_err err = uc_reg_write(state.uc.get(), UC_ARM_REG_SP, &value);
-    assert(err == UC_ERR_OK);
+    state.cpu->set_sp(value);
 }
 
 void write_pc(CPUState &state, uint32_t value) {
-    const uc_err err = uc_reg_write(state.uc.get(), UC_ARM_REG_PC, &value);
-    assert(err == UC_ERR_OK);
+    state.cpu->set_pc(value);
 }
 
 void write_lr(CPUState &state, uint32_t value) {
-    const uc_err err = uc_reg_write(state.uc.get(), UC_ARM_REG_LR, &value);
-    assert(err == UC_ERR_OK);
+    state.cpu->set_lr(value);
+}
+
+void save_context(CPUState &state, CPUContext &ctx) {
+    state.cpu->save_context(ctx);
+}
+
+void load_context(CPUState &state, const CPUContext &ctx) {
+    state.cpu->load_context(ctx);
 }
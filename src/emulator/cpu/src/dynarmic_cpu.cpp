@@ -0,0 +1,260 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <cpu/impl/dynarmic_cpu.h>
+
+#include <cpu/state.h>
+#include <disasm/functions.h>
+#include <mem/ptr.h>
+#include <util/log.h>
+
+#include <dynarmic/A32/config.h>
+
+#include <cassert>
+#include <cstring>
+
+class ArmDynarmicCallbacks : public Dynarmic::A32::UserCallbacks {
+    DynarmicCPU &cpu;
+
+    bool should_trace(uint32_t address) const {
+        if (cpu.trace_tier == TraceTier::Off) {
+            return false;
+        }
+        if (cpu.trace_begin == 0 && cpu.trace_end == 0) {
+            return true;
+        }
+        return (address >= cpu.trace_begin) && (address <= cpu.trace_end);
+    }
+
+    template <typename T>
+    T read(uint32_t address) {
+        T value;
+        std::memcpy(&value, &cpu.state->mem->memory[address], sizeof(value));
+        return value;
+    }
+
+    template <typename T>
+    void write(uint32_t address, T value) {
+        std::memcpy(&cpu.state->mem->memory[address], &value, sizeof(value));
+    }
+
+public:
+    explicit ArmDynarmicCallbacks(DynarmicCPU &cpu)
+        : cpu(cpu) {}
+
+    uint8_t MemoryRead8(uint32_t address) override {
+        return read<uint8_t>(address);
+    }
+
+    uint16_t MemoryRead16(uint32_t address) override {
+        return read<uint16_t>(address);
+    }
+
+    uint32_t MemoryRead32(uint32_t address) override {
+        return read<uint32_t>(address);
+    }
+
+    uint64_t MemoryRead64(uint32_t address) override {
+        return read<uint64_t>(address);
+    }
+
+    void MemoryWrite8(uint32_t address, uint8_t value) override {
+        write(address, value);
+    }
+
+    void MemoryWrite16(uint32_t address, uint16_t value) override {
+        write(address, value);
+    }
+
+    void MemoryWrite32(uint32_t address, uint32_t value) override {
+        write(address, value);
+    }
+
+    void MemoryWrite64(uint32_t address, uint64_t value) override {
+        write(address, value);
+    }
+
+    uint32_t MemoryReadCode(uint32_t address) override {
+        if (should_trace(address)) {
+            CPUState &state = *cpu.state;
+            const uint8_t *const code = Ptr<const uint8_t>(address).get(*state.mem);
+            const std::string disassembly = disassemble(state.disasm, code, GB(4) - address, address, cpu.is_thumb_mode(), state.mem->generation);
+            LOG_TRACE("{} {}", log_hex(address), disassembly);
+        }
+        return read<uint32_t>(address);
+    }
+
+    void InterpreterFallback(uint32_t pc, size_t num_instructions) override {
+        LOG_CRITICAL("Unimplemented instruction at {} - no interpreter fallback.", log_hex(pc));
+        cpu.stop();
+    }
+
+    void CallSVC(uint32_t imm) override {
+        CPUState &state = *cpu.state;
+        state.call_svc(state, imm, cpu.get_pc());
+    }
+
+    void ExceptionRaised(uint32_t pc, Dynarmic::A32::Exception exception) override {
+        LOG_CRITICAL("Exception {} raised at {}.", static_cast<int>(exception), log_hex(pc));
+        cpu.stop();
+    }
+
+    void AddTicks(uint64_t ticks) override {
+        // Dynarmic's tick is one retired instruction under the default config,
+        // so this is the retired-instruction counter for free.
+        cpu_count_instructions(ticks);
+    }
+
+    uint64_t GetTicksRemaining() override {
+        // A configured quantum bounds each jit->Run() so the kernel loop can
+        // reschedule between slices; otherwise run until halted.
+        if (cpu.sliced && (cpu.state->execution_quantum != 0)) {
+            return cpu.state->execution_quantum;
+        }
+        return 1ull << 60;
+    }
+};
+
+DynarmicCPU::DynarmicCPU(CPUState *state, Address pc, Address sp, bool log_code)
+    : state(state)
+    , callbacks(new ArmDynarmicCallbacks(*this)) {
+    Dynarmic::A32::UserConfig config;
+    config.callbacks = callbacks.get();
+    jit = std::make_unique<Dynarmic::A32::Jit>(config);
+
+    if (log_code) {
+        trace_tier = TraceTier::Code;
+    }
+
+    set_pc(pc);
+    set_lr(pc);
+    set_sp(sp);
+}
+
+DynarmicCPU::~DynarmicCPU() = default;
+
+int DynarmicCPU::run(bool callback) {
+    interrupted = false;
+    // Callback runs stay unsliced - their caller treats a 0 result as
+    // completion.
+    sliced = !callback;
+    if (callback) {
+        set_lr(state->entry_point);
+    }
+
+    const Address stop_address = state->entry_point & 0xfffffffe;
+    while (!interrupted) {
+        jit->Run();
+        if ((get_pc() & 0xfffffffe) == stop_address) {
+            return 1;
+        }
+        if (sliced && (state->execution_quantum != 0)) {
+            // The slice expired rather than the jit halting - hand control
+            // back so the kernel loop can reschedule before the next one.
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+void DynarmicCPU::stop() {
+    interrupted = true;
+    jit->HaltExecution();
+}
+
+uint32_t DynarmicCPU::get_reg(size_t index) {
+    return jit->Regs()[index];
+}
+
+void DynarmicCPU::set_reg(size_t index, uint32_t value) {
+    jit->Regs()[index] = value;
+}
+
+float DynarmicCPU::get_float_reg(size_t index) {
+    float value;
+    const uint32_t raw = jit->ExtRegs()[index];
+    std::memcpy(&value, &raw, sizeof(value));
+    return value;
+}
+
+uint32_t DynarmicCPU::get_sp() {
+    return jit->Regs()[13];
+}
+
+void DynarmicCPU::set_sp(uint32_t value) {
+    jit->Regs()[13] = value;
+}
+
+uint32_t DynarmicCPU::get_pc() {
+    return jit->Regs()[15];
+}
+
+void DynarmicCPU::set_pc(uint32_t value) {
+    if (value & 1) {
+        jit->SetCpsr(jit->Cpsr() | 0x20); // Thumb.
+        value &= 0xfffffffe;
+    }
+    jit->Regs()[15] = value;
+}
+
+uint32_t DynarmicCPU::get_lr() {
+    return jit->Regs()[14];
+}
+
+void DynarmicCPU::set_lr(uint32_t value) {
+    jit->Regs()[14] = value;
+}
+
+void DynarmicCPU::save_context(CPUContext &ctx) {
+    // The jit keeps the register files in plain host arrays.
+    std::memcpy(ctx.cpu_registers, jit->Regs().data(), sizeof(ctx.cpu_registers));
+    std::memcpy(ctx.fpu_registers, jit->ExtRegs().data(), sizeof(ctx.fpu_registers));
+    ctx.cpsr = jit->Cpsr();
+    ctx.fpscr = jit->Fpscr();
+
+    ctx.fpu_used = ctx.fpscr != 0;
+    for (int i = 0; !ctx.fpu_used && (i < 32); ++i) {
+        ctx.fpu_used = ctx.fpu_registers[i] != 0;
+    }
+}
+
+void DynarmicCPU::load_context(const CPUContext &ctx) {
+    std::memcpy(jit->Regs().data(), ctx.cpu_registers, sizeof(ctx.cpu_registers));
+    jit->SetCpsr(ctx.cpsr);
+
+    if (!ctx.fpu_used) {
+        return;
+    }
+
+    std::memcpy(jit->ExtRegs().data(), ctx.fpu_registers, sizeof(ctx.fpu_registers));
+    jit->SetFpscr(ctx.fpscr);
+}
+
+bool DynarmicCPU::is_thumb_mode() {
+    return jit->Cpsr() & 0x20;
+}
+
+void DynarmicCPU::set_tracing(TraceTier tier, Address begin, Address end) {
+    trace_tier = tier;
+    trace_begin = begin;
+    trace_end = end;
+    // Translated blocks bypass MemoryReadCode, so flush them to pick up the
+    // new tier. Memory-tier load/store logging needs hookable accesses; the
+    // jit only reports code, so Memory degrades to Code here.
+    jit->ClearCache();
+}
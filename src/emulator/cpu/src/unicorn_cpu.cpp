@@ -0,0 +1,401 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <cpu/impl/unicorn_cpu.h>
+
+#include <cpu/state.h>
+#include <disasm/functions.h>
+#include <mem/ptr.h>
+#include <util/log.h>
+
+#include <cassert>
+#include <cstring>
+
+union DoubleReg {
+    double d;
+    float f[2];
+};
+
+static void log_memory_access(const char *type, Address address, int size, int64_t value, const MemState &mem) {
+    const char *const name = mem_name(address, mem);
+    LOG_TRACE("{} {} bytes, address {} ( {} ), value {}", type, size, address, name, log_hex(value));
+}
+
+static void read_hook(uc_engine *uc, uc_mem_type type, uint64_t address, int size, int64_t value, void *user_data) {
+    assert(value == 0);
+
+    const CPUState &state = *static_cast<const CPUState *>(user_data);
+    const MemState &mem = *state.mem;
+    memcpy(&value, Ptr<const void>(static_cast<Address>(address)).get(mem), size);
+    log_memory_access("Read", static_cast<Address>(address), size, value, mem);
+}
+
+static void write_hook(uc_engine *uc, uc_mem_type type, uint64_t address, int size, int64_t value, void *user_data) {
+    const CPUState &state = *static_cast<const CPUState *>(user_data);
+    const MemState &mem = *state.mem;
+    log_memory_access("Write", static_cast<Address>(address), size, value, mem);
+}
+
+static void enable_vfp_fpu(uc_engine *uc) {
+    uint64_t c1_c0_2 = 0;
+    uc_err err = uc_reg_read(uc, UC_ARM_REG_C1_C0_2, &c1_c0_2);
+    assert(err == UC_ERR_OK);
+
+    c1_c0_2 |= (0xf << 20);
+
+    err = uc_reg_write(uc, UC_ARM_REG_C1_C0_2, &c1_c0_2);
+    assert(err == UC_ERR_OK);
+
+    const uint64_t fpexc = 0xf0000000;
+
+    err = uc_reg_write(uc, UC_ARM_REG_FPEXC, &fpexc);
+    assert(err == UC_ERR_OK);
+}
+
+void UnicornCPU::code_hook(uc_engine *uc, uint64_t address, uint32_t size, void *user_data) {
+    UnicornCPU &self = *static_cast<UnicornCPU *>(user_data);
+    CPUState &state = *self.state;
+    const MemState &mem = *state.mem;
+    const uint8_t *const code = Ptr<const uint8_t>(static_cast<Address>(address)).get(mem);
+    const size_t buffer_size = GB(4) - address;
+    const bool thumb = self.thumb_mode_cached;
+    const std::string disassembly = disassemble(state.disasm, code, buffer_size, address, thumb, mem.generation);
+    LOG_TRACE("{} {}", log_hex(address), disassembly);
+}
+
+void UnicornCPU::block_hook(uc_engine *uc, uint64_t address, uint32_t size, void *user_data) {
+    UnicornCPU &self = *static_cast<UnicornCPU *>(user_data);
+
+    // A block runs entirely in one mode, so this is the one place the query
+    // has to happen - everything until the next block reads the cached bool.
+    size_t mode = 0;
+    uc_query(uc, UC_QUERY_MODE, &mode);
+    self.thumb_mode_cached = mode & UC_MODE_THUMB;
+
+    // Unicorn reports the block size in bytes. Dividing by the encoding width
+    // is exact for ARM and an estimate for Thumb, where a 32-bit Thumb-2
+    // instruction counts as two - good enough for a MIPS readout, and a
+    // per-block hook is the only counting granularity that stays cheap.
+    cpu_count_instructions(size / (self.thumb_mode_cached ? 2 : 4));
+}
+
+void UnicornCPU::intr_hook(uc_engine *uc, uint32_t intno, void *user_data) {
+    UnicornCPU &self = *static_cast<UnicornCPU *>(user_data);
+    CPUState &state = *self.state;
+
+    if (intno == 1) { // EXCP_UDEF
+        // With the FPU off this is expected exactly once per FP-using
+        // thread: switch it on and re-execute the faulting instruction.
+        // VFP/NEON encodings are four bytes in both ARM and Thumb.
+        if (!self.fpu_enabled) {
+            enable_vfp_fpu(uc);
+            self.fpu_enabled = true;
+            const uint32_t resume_pc = self.get_pc() - 4;
+            self.set_pc(resume_pc);
+            return;
+        }
+        LOG_CRITICAL("Undefined instruction at {}.", log_hex(self.get_pc()));
+        self.stop();
+        return;
+    }
+
+    assert(intno == 2);
+
+    const uint32_t pc = self.get_pc();
+
+    const auto cached = self.svc_immediates.find(pc);
+    if (cached != self.svc_immediates.end()) {
+        state.call_svc(state, cached->second, pc);
+        return;
+    }
+
+    // The whole 4GB arena is mapped into Unicorn with uc_mem_map_ptr, so the
+    // SVC instruction can be decoded straight out of host memory instead of
+    // round-tripping through uc_mem_read.
+    uint32_t imm = 0;
+    if (self.thumb_mode_cached) {
+        const Address svc_address = pc - 2;
+        const uint16_t svc_instruction = *Ptr<const uint16_t>(svc_address).get(*state.mem);
+        imm = svc_instruction & 0xff;
+    } else {
+        const Address svc_address = pc - 4;
+        const uint32_t svc_instruction = *Ptr<const uint32_t>(svc_address).get(*state.mem);
+        imm = svc_instruction & 0xffffff;
+    }
+    self.svc_immediates.emplace(pc, imm);
+    state.call_svc(state, imm, pc);
+}
+
+UnicornCPU::UnicornCPU(CPUState *state, Address pc, Address sp, bool log_code)
+    : state(state) {
+    uc_engine *temp_uc = nullptr;
+    uc_err err = uc_open(UC_ARCH_ARM, UC_MODE_ARM, &temp_uc);
+    assert(err == UC_ERR_OK);
+
+    uc = UnicornPtr(temp_uc, uc_close);
+    temp_uc = nullptr;
+
+    if (log_code) {
+        set_tracing(TraceTier::Code, 0, 0);
+    }
+
+    uc_hook hh = 0;
+    err = uc_hook_add(uc.get(), &hh, UC_HOOK_INTR, reinterpret_cast<void *>(&intr_hook), this, 1, 0);
+    assert(err == UC_ERR_OK);
+
+    err = uc_hook_add(uc.get(), &hh, UC_HOOK_BLOCK, reinterpret_cast<void *>(&block_hook), this, 1, 0);
+    assert(err == UC_ERR_OK);
+
+    err = uc_reg_write(uc.get(), UC_ARM_REG_SP, &sp);
+    assert(err == UC_ERR_OK);
+
+    err = uc_mem_map_ptr(uc.get(), 0, GB(4), UC_PROT_ALL, &state->mem->memory[0]);
+    assert(err == UC_ERR_OK);
+
+    err = uc_reg_write(uc.get(), UC_ARM_REG_PC, &pc);
+    assert(err == UC_ERR_OK);
+
+    err = uc_reg_write(uc.get(), UC_ARM_REG_LR, &pc);
+    assert(err == UC_ERR_OK);
+
+    // The FPU stays off until the first VFP/NEON instruction traps - see
+    // intr_hook. Threads that never touch it keep their context cheap.
+}
+
+int UnicornCPU::run(bool callback) {
+    uint32_t pc = get_pc();
+    bool thumb_mode = is_thumb_mode();
+    if (thumb_mode) {
+        pc |= 1;
+    }
+    if (callback) {
+        uc_reg_write(uc.get(), UC_ARM_REG_LR, &state->entry_point);
+    }
+    uc_err err = uc_emu_start(uc.get(), pc, 0, 0, 1);
+    pc = get_pc();
+    thumb_mode = is_thumb_mode();
+    if (thumb_mode) {
+        pc |= 1;
+    }
+    // A configured quantum bounds this leg by instruction count; exhausting
+    // it returns 0 below and the kernel loop reschedules before the next
+    // slice. Callback runs stay unsliced - their caller treats a 0 result
+    // as completion.
+    const uint64_t quantum = callback ? 0 : state->execution_quantum;
+    err = uc_emu_start(uc.get(), pc, state->entry_point & 0xfffffffe, 0, quantum);
+
+    if (err != UC_ERR_OK) {
+        const uint32_t error_pc = get_pc();
+        const uint32_t lr = get_lr();
+        LOG_CRITICAL("Unicorn error {} at: start PC: {} error PC {} LR: {}", log_hex(err), log_hex(pc), log_hex(error_pc), log_hex(lr));
+        return -1;
+    }
+    pc = get_pc();
+    thumb_mode = is_thumb_mode();
+    if (thumb_mode) {
+        pc |= 1;
+    }
+    if (pc == state->entry_point)
+        return 1;
+    return 0;
+}
+
+void UnicornCPU::stop() {
+    const uc_err err = uc_emu_stop(uc.get());
+    assert(err == UC_ERR_OK);
+}
+
+uint32_t UnicornCPU::get_reg(size_t index) {
+    uint32_t value = 0;
+    const uc_err err = uc_reg_read(uc.get(), UC_ARM_REG_R0 + static_cast<int>(index), &value);
+    assert(err == UC_ERR_OK);
+
+    return value;
+}
+
+void UnicornCPU::set_reg(size_t index, uint32_t value) {
+    const uc_err err = uc_reg_write(uc.get(), UC_ARM_REG_R0 + static_cast<int>(index), &value);
+    assert(err == UC_ERR_OK);
+}
+
+float UnicornCPU::get_float_reg(size_t index) {
+    DoubleReg value;
+
+    const int double_index = static_cast<int>(index / 2);
+    const uc_err err = uc_reg_read(uc.get(), UC_ARM_REG_D0 + double_index, &value);
+    assert(err == UC_ERR_OK);
+
+    return value.f[index % 2];
+}
+
+uint32_t UnicornCPU::get_sp() {
+    uint32_t value = 0;
+    const uc_err err = uc_reg_read(uc.get(), UC_ARM_REG_SP, &value);
+    assert(err == UC_ERR_OK);
+
+    return value;
+}
+
+void UnicornCPU::set_sp(uint32_t value) {
+    const uc_err err = uc_reg_write(uc.get(), UC_ARM_REG_SP, &value);
+    assert(err == UC_ERR_OK);
+}
+
+uint32_t UnicornCPU::get_pc() {
+    uint32_t value = 0;
+    const uc_err err = uc_reg_read(uc.get(), UC_ARM_REG_PC, &value);
+    assert(err == UC_ERR_OK);
+
+    return value;
+}
+
+void UnicornCPU::set_pc(uint32_t value) {
+    const uc_err err = uc_reg_write(uc.get(), UC_ARM_REG_PC, &value);
+    assert(err == UC_ERR_OK);
+}
+
+uint32_t UnicornCPU::get_lr() {
+    uint32_t value = 0;
+    const uc_err err = uc_reg_read(uc.get(), UC_ARM_REG_LR, &value);
+    assert(err == UC_ERR_OK);
+
+    return value;
+}
+
+void UnicornCPU::set_lr(uint32_t value) {
+    const uc_err err = uc_reg_write(uc.get(), UC_ARM_REG_LR, &value);
+    assert(err == UC_ERR_OK);
+}
+
+// r0-r12, sp, lr, pc plus the status registers, transferred as one batch.
+static constexpr int CORE_CONTEXT_REGS[] = {
+    UC_ARM_REG_R0, UC_ARM_REG_R1, UC_ARM_REG_R2, UC_ARM_REG_R3,
+    UC_ARM_REG_R4, UC_ARM_REG_R5, UC_ARM_REG_R6, UC_ARM_REG_R7,
+    UC_ARM_REG_R8, UC_ARM_REG_R9, UC_ARM_REG_R10, UC_ARM_REG_R11,
+    UC_ARM_REG_R12, UC_ARM_REG_SP, UC_ARM_REG_LR, UC_ARM_REG_PC,
+    UC_ARM_REG_CPSR, UC_ARM_REG_FPSCR
+};
+
+static constexpr int CORE_CONTEXT_REG_COUNT = sizeof(CORE_CONTEXT_REGS) / sizeof(CORE_CONTEXT_REGS[0]);
+
+static void lay_out_context(CPUContext &ctx, void **core_values, int *fpu_regs, void **fpu_values) {
+    for (int i = 0; i < 16; ++i) {
+        core_values[i] = &ctx.cpu_registers[i];
+    }
+    core_values[16] = &ctx.cpsr;
+    core_values[17] = &ctx.fpscr;
+
+    for (int i = 0; i < 32; ++i) {
+        fpu_regs[i] = UC_ARM_REG_D0 + i;
+        fpu_values[i] = &ctx.fpu_registers[i];
+    }
+}
+
+void UnicornCPU::save_context(CPUContext &ctx) {
+    void *core_values[CORE_CONTEXT_REG_COUNT];
+    int fpu_regs[32];
+    void *fpu_values[32];
+    lay_out_context(ctx, core_values, fpu_regs, fpu_values);
+
+    uc_err err = uc_reg_read_batch(uc.get(), const_cast<int *>(CORE_CONTEXT_REGS), core_values, CORE_CONTEXT_REG_COUNT);
+    assert(err == UC_ERR_OK);
+
+    // An FPU that was never switched on still holds its power-on zeros, so
+    // the 32-register transfer can be skipped outright.
+    if (!fpu_enabled) {
+        memset(ctx.fpu_registers, 0, sizeof(ctx.fpu_registers));
+        ctx.fpu_used = false;
+        return;
+    }
+
+    err = uc_reg_read_batch(uc.get(), fpu_regs, fpu_values, 32);
+    assert(err == UC_ERR_OK);
+
+    ctx.fpu_used = true;
+}
+
+void UnicornCPU::load_context(const CPUContext &ctx) {
+    CPUContext &mutable_ctx = const_cast<CPUContext &>(ctx); // batch API is not const-correct
+    void *core_values[CORE_CONTEXT_REG_COUNT];
+    int fpu_regs[32];
+    void *fpu_values[32];
+    lay_out_context(mutable_ctx, core_values, fpu_regs, fpu_values);
+
+    uc_err err = uc_reg_write_batch(uc.get(), const_cast<int *>(CORE_CONTEXT_REGS), core_values, CORE_CONTEXT_REG_COUNT);
+    assert(err == UC_ERR_OK);
+
+    // The T bit came in with the CPSR; refresh the cached mode so run() sets
+    // the right thumb bit before the first block of the new context executes.
+    thumb_mode_cached = (ctx.cpsr & 0x20) != 0;
+
+    // The VFP file was all-zero at save time, so there is nothing to put
+    // back - callees leave d8-d15 as they found them per the AAPCS.
+    if (!ctx.fpu_used) {
+        return;
+    }
+
+    // The incoming context has live FP state; make sure the engine will
+    // execute VFP instructions without tripping the first-use trap again.
+    if (!fpu_enabled) {
+        enable_vfp_fpu(uc.get());
+        fpu_enabled = true;
+    }
+
+    err = uc_reg_write_batch(uc.get(), fpu_regs, fpu_values, 32);
+    assert(err == UC_ERR_OK);
+}
+
+bool UnicornCPU::is_thumb_mode() {
+    // Kept current by block_hook and load_context - the only places the
+    // mode can change underneath us.
+    return thumb_mode_cached;
+}
+
+void UnicornCPU::set_tracing(TraceTier tier, Address trace_begin, Address trace_end) {
+    // Tear down whatever is installed - tier Off leaves the engine hook-free.
+    if (code_hook_handle != 0) {
+        uc_hook_del(uc.get(), code_hook_handle);
+        code_hook_handle = 0;
+    }
+    if (read_hook_handle != 0) {
+        uc_hook_del(uc.get(), read_hook_handle);
+        read_hook_handle = 0;
+    }
+    if (write_hook_handle != 0) {
+        uc_hook_del(uc.get(), write_hook_handle);
+        write_hook_handle = 0;
+    }
+
+    if (tier == TraceTier::Off) {
+        return;
+    }
+
+    // Unicorn treats begin > end as "hook everywhere".
+    const uint64_t begin = (trace_begin == 0 && trace_end == 0) ? 1 : trace_begin;
+    const uint64_t end = (trace_begin == 0 && trace_end == 0) ? 0 : trace_end;
+
+    uc_err err = uc_hook_add(uc.get(), &code_hook_handle, UC_HOOK_CODE, reinterpret_cast<void *>(&code_hook), this, begin, end);
+    assert(err == UC_ERR_OK);
+
+    if (tier == TraceTier::Memory) {
+        err = uc_hook_add(uc.get(), &read_hook_handle, UC_HOOK_MEM_READ, reinterpret_cast<void *>(&read_hook), state, begin, end);
+        assert(err == UC_ERR_OK);
+
+        err = uc_hook_add(uc.get(), &write_hook_handle, UC_HOOK_MEM_WRITE, reinterpret_cast<void *>(&write_hook), state, begin, end);
+        assert(err == UC_ERR_OK);
+    }
+}
@@ -18,10 +18,18 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 
 using Sha256Hash = std::array<uint8_t, 32>;
 
+// One-shot SHA-256. Dispatches once per process to the SHA extension
+// implementation when the host CPU has it, otherwise to the portable one.
 Sha256Hash sha256(const void *data, size_t size);
+
+// Fast non-cryptographic 64-bit hash (xxHash64 algorithm) for change
+// detection on hot paths. Word-at-a-time with multiply-rotate mixing, so
+// permuted input does not alias the way a byte sum does.
+uint64_t hash64(const void *data, size_t size);
 typedef std::array<char, 65> Sha256HashText;
 
 template <size_t N>
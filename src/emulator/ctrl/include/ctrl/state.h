@@ -2,14 +2,81 @@
 
 #include <SDL_joystick.h>
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 struct _SDL_GameController;
 
 typedef std::shared_ptr<_SDL_GameController> GameControllerPtr;
 typedef std::map<SDL_JoystickGUID, GameControllerPtr> GameControllerList;
 
+enum class CtrlRecordMode {
+    off,
+    record,
+    replay,
+};
+
+// One input state transition, keyed to the frame it first applied on. A
+// recording is the sequence of transitions; the state holds between them.
+struct CtrlRecordEntry {
+    uint64_t frame = 0;
+    uint32_t buttons = 0;
+    uint8_t lx = 0x80;
+    uint8_t ly = 0x80;
+    uint8_t rx = 0x80;
+    uint8_t ry = 0x80;
+};
+
+// One pad sample as the sampler thread captured it.
+struct CtrlSample {
+    uint64_t timestamp_us = 0;
+    uint32_t buttons = 0;
+    uint8_t lx = 0x80;
+    uint8_t ly = 0x80;
+    uint8_t rx = 0x80;
+    uint8_t ry = 0x80;
+};
+
 struct CtrlState {
     GameControllerList controllers;
+
+    // Sampler thread output: a timestamped ring the peek NIDs read
+    // lock-free (publish slot, then bump count with release) and the read
+    // NIDs block on via the tick condvar. Titles polling many times per
+    // frame all see the same sample instead of each re-scanning SDL.
+    std::array<CtrlSample, 64> samples;
+    std::atomic<uint64_t> sample_count{ 0 };
+    uint64_t sampling_interval_us = 16667;
+    std::mutex sample_mutex;
+    std::condition_variable sample_tick;
+    std::atomic<bool> sampler_stop{ false };
+    std::thread sampler;
+
+    // Input record/replay, frame-locked to total_frame_count so two runs of
+    // the same build see identical pad state on identical frames.
+    CtrlRecordMode record_mode = CtrlRecordMode::off;
+    std::string record_path;
+    bool record_ready = false; // file opened (record) or parsed (replay)
+    std::ofstream record_file;
+    CtrlRecordEntry last_recorded;
+    bool have_last_recorded = false;
+    std::vector<CtrlRecordEntry> replay_entries;
+    size_t replay_pos = 0;
+
+    ~CtrlState() {
+        sampler_stop = true;
+        sample_tick.notify_all();
+        if (sampler.joinable()) {
+            sampler.join();
+        }
+    }
 };
@@ -23,3 +23,7 @@ struct DisasmState;
 
 bool init(DisasmState &state);
 std::string disassemble(DisasmState &state, const uint8_t *code, size_t size, uint64_t address, bool thumb);
+// Cached variant for hot paths like the trace hook. mem_generation is the
+// MemState allocation generation - the cache is flushed when it moves, so
+// freshly loaded or reallocated code is never served stale.
+std::string disassemble(DisasmState &state, const uint8_t *code, size_t size, uint64_t address, bool thumb, size_t mem_generation);
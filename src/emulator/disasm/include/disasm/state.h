@@ -19,12 +19,18 @@
 
 #include <functional>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 struct cs_insn;
 
 typedef std::unique_ptr<cs_insn, std::function<void(cs_insn *)>> InsnPtr;
+// Keyed by address << 1 | thumb - the same bytes decode differently per mode.
+typedef std::unordered_map<uint64_t, std::string> DisasmCache;
 
 struct DisasmState {
     size_t csh;
     InsnPtr insn;
+    DisasmCache cache;
+    size_t cache_generation = 0; // MemState allocation generation the cache was filled under
 };
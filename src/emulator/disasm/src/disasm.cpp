@@ -46,6 +46,24 @@ bool init(DisasmState &state) {
     return true;
 }
 
+std::string disassemble(DisasmState &state, const uint8_t *code, size_t size, uint64_t address, bool thumb, size_t mem_generation) {
+    if (state.cache_generation != mem_generation) {
+        state.cache.clear();
+        state.cache_generation = mem_generation;
+    }
+
+    const uint64_t key = (address << 1) | (thumb ? 1 : 0);
+    const DisasmCache::const_iterator cached = state.cache.find(key);
+    if (cached != state.cache.end()) {
+        return cached->second;
+    }
+
+    std::string disassembly = disassemble(state, code, size, address, thumb);
+    state.cache.emplace(key, disassembly);
+
+    return disassembly;
+}
+
 std::string disassemble(DisasmState &state, const uint8_t *code, size_t size, uint64_t address, bool thumb) {
     const cs_err err = cs_option(state.csh, CS_OPT_MODE, thumb ? CS_MODE_THUMB : CS_MODE_ARM);
     assert(err == CS_ERR_OK);
@@ -0,0 +1,44 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <cstdint>
+
+// GL validation and slow-call detection.
+//
+// Validation is a build split: debug builds install a KHR_debug message
+// callback on the current context where the driver offers one, so errors
+// are reported without a glGetError round trip per call; release builds do
+// no checking at all. The timing shim is runtime-opt-in and logs any GL
+// call that exceeds the threshold, catching driver stalls (shader
+// recompiles, buffer ghosting) that are otherwise invisible.
+
+// Installs the KHR_debug callback on the context current on this thread.
+// Returns false in release builds or when the extension is missing (4.1
+// core on macOS has no KHR_debug), in which case a caller may fall back to
+// per-call glGetError checking - debug builds only.
+bool install_khr_debug_callback();
+
+// Slow-call threshold in microseconds; 0 disables the shim entirely.
+void set_gl_slow_call_threshold_us(uint64_t us);
+uint64_t gl_slow_call_threshold_us();
+
+// Hooks for the glbinding before/after callbacks. Cheap no-ops while the
+// threshold is 0.
+void gl_call_begin();
+void gl_call_end(const char *name);
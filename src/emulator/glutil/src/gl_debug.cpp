@@ -0,0 +1,101 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <glutil/gl_debug.h>
+
+#include <util/log.h>
+
+#include <glbinding/gl/gl.h>
+
+#include <chrono>
+#include <cstring>
+
+#ifndef NDEBUG
+static void GL_APIENTRY gl_debug_message(gl::GLenum source, gl::GLenum type, gl::GLuint id, gl::GLenum severity, gl::GLsizei length, const gl::GLchar *message, const void *user) {
+    if (severity == gl::GL_DEBUG_SEVERITY_NOTIFICATION) {
+        return;
+    }
+    if (severity == gl::GL_DEBUG_SEVERITY_HIGH) {
+        LOG_ERROR("OpenGL: {} (id {})", message, id);
+    } else {
+        LOG_WARN("OpenGL: {} (id {})", message, id);
+    }
+}
+
+static bool has_khr_debug() {
+    gl::GLint count = 0;
+    gl::glGetIntegerv(gl::GL_NUM_EXTENSIONS, &count);
+    for (gl::GLint i = 0; i < count; ++i) {
+        const char *const name = reinterpret_cast<const char *>(gl::glGetStringi(gl::GL_EXTENSIONS, i));
+        if (name && (strcmp(name, "GL_KHR_debug") == 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif // NDEBUG
+
+bool install_khr_debug_callback() {
+#ifdef NDEBUG
+    return false;
+#else
+    if (!has_khr_debug()) {
+        return false;
+    }
+
+    gl::glEnable(gl::GL_DEBUG_OUTPUT);
+    // Synchronous output keeps the message on the offending call's stack at
+    // the cost of serialising the driver - acceptable in a debug build.
+    gl::glEnable(gl::GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    gl::glDebugMessageCallback(gl_debug_message, nullptr);
+    LOG_INFO("OpenGL: KHR_debug validation enabled on this context.");
+    return true;
+#endif
+}
+
+static uint64_t slow_call_threshold_us = 0;
+
+// Per thread because the render, shader-compiler and UI threads each issue
+// GL calls; the before/after pair always lands on the same thread.
+static thread_local std::chrono::steady_clock::time_point call_start;
+
+void set_gl_slow_call_threshold_us(uint64_t us) {
+    slow_call_threshold_us = us;
+    if (us != 0) {
+        LOG_INFO("OpenGL: logging calls slower than {} us.", us);
+    }
+}
+
+uint64_t gl_slow_call_threshold_us() {
+    return slow_call_threshold_us;
+}
+
+void gl_call_begin() {
+    if (slow_call_threshold_us != 0) {
+        call_start = std::chrono::steady_clock::now();
+    }
+}
+
+void gl_call_end(const char *name) {
+    if (slow_call_threshold_us == 0) {
+        return;
+    }
+    const auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - call_start).count();
+    if (static_cast<uint64_t>(elapsed_us) >= slow_call_threshold_us) {
+        LOG_WARN("OpenGL: {} took {} us.", name, elapsed_us);
+    }
+}
@@ -39,7 +39,16 @@ void DrawLwMutexesDialog(HostState &host);
 void DrawLwCondvarsDialog(HostState &host);
 void DrawCondvarsDialog(HostState &host);
 void DrawEventFlagsDialog(HostState &host);
+void DrawSyncStatsDialog(HostState &host);
+void DrawIoStatsDialog(HostState &host);
+void DrawAudioStatsDialog(HostState &host);
+void DrawPerfHud(HostState &host);
+void DrawImportStatsDialog(HostState &host);
+void DrawProfilerDialog(HostState &host);
+void DrawTextureCacheDialog(HostState &host);
+void DrawGpuProfilerDialog(HostState &host);
 void DrawUI(HostState &host);
 void DrawCommonDialog(HostState &host);
 void DrawGameSelector(HostState &host, AppRunType *run_type);
 void DrawReinstallDialog(HostState &host, GenericDialogState *status);
+void DrawBootProgress(HostState &host);
@@ -32,5 +32,6 @@ namespace imgui {
     void draw_begin(WindowPtr window);
     void draw_main(HostState &host, GLuint TextureID);
     void draw_end(WindowPtr window);
+    bool draw_cached(HostState &host, GLuint TextureID, WindowPtr window);
 
 } // namespace imgui
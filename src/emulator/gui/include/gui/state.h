@@ -18,18 +18,48 @@
 #pragma once
 
 #include <dialog/state.h>
+#include <kernel/debug_snapshot.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
 
 enum SelectorState {
     SELECT_APP
 };
 
+// One title's icon0.png, decoded to RGBA by the host when the list is built.
+// The GL texture is created lazily the first frame the selector draws it;
+// zero width means the title has no usable icon.
+struct GameIcon {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> rgba;
+    uint32_t texture = 0;
+};
+
 struct GamesSelector {
     std::vector<std::string> titles;
     std::vector<std::string> title_ids;
+    std::vector<GameIcon> icons;
     std::string title_id;
     SelectorState state = SELECT_APP;
 };
 
+// Rolling state behind the performance HUD overlay.
+struct PerfHudState {
+    std::array<float, 128> frame_ms{}; // UI frame times, newest at pos
+    uint32_t pos = 0;
+    std::chrono::steady_clock::time_point last_frame{};
+    std::chrono::steady_clock::time_point last_rate_sample{};
+    uint64_t last_guest_frames = 0;
+    uint64_t last_draws = 0;
+    uint64_t last_instructions = 0;
+    float guest_fps = 0.0f;
+    float draws_per_frame = 0.0f;
+    float guest_mips = 0.0f;
+};
+
 struct GuiState {
     // Debug menu
     bool renderer_focused = true;
@@ -40,10 +70,31 @@ struct GuiState {
     bool mutexes_dialog = false;
     bool lwmutexes_dialog = false;
     bool eventflags_dialog = false;
+    bool sync_stats_dialog = false;
+    bool io_stats_dialog = false;
+    bool audio_stats_dialog = false;
+    bool import_stats_dialog = false;
+    bool profiler_dialog = false;
+    bool texture_cache_dialog = false;
+    bool gpu_profiler_dialog = false;
+    bool perf_hud = false;
 
     // Optimisation menu
     bool texture_cache = true;
 
     DialogState common_dialog;
     GamesSelector game_selector;
+
+    // Double-buffered kernel snapshot for the debug dialogs: the UI
+    // captures into the back buffer under the kernel lock (microseconds,
+    // no allocation once warm) and renders the front buffer lock-free.
+    KernelDebugSnapshot kernel_snapshots[2];
+    int kernel_snapshot_front = 0;
+
+    PerfHudState perf_hud_state;
+
+    // Widget rebuild request for the on-demand GUI pass. Input events and
+    // state changes set it; between rebuilds the main loop replays the
+    // previous frame's draw data instead of traversing every widget.
+    std::atomic<bool> rebuild_requested{ true };
 };
@@ -18,6 +18,7 @@
 #include <gui/imgui_impl.h>
 
 #include <gui/functions.h>
+#include <host/display_format.h>
 
 #include <SDL.h>
 
@@ -33,23 +34,36 @@ void imgui::draw_begin(WindowPtr window) {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
-void imgui::draw_main(HostState &host, GLuint texture_id) {
-    const auto window_size = host.display.window_size;
+// Streams the guest frame into the screen texture. Runs every present, so
+// the game keeps animating even while cached widget draw data is replayed.
+static void upload_screen_texture(HostState &host, GLuint texture_id) {
     const auto image_size = host.display.image_size;
 
-    // workaround for imgui-related crash
-    if (host.display.image_size.width == 0)
-        return;
-
     glBindTexture(GL_TEXTURE_2D, texture_id);
     void *const pixels = host.display.base.cast<void>().get(host.mem);
 
+    DisplayFormatGL gl_format = {};
+    if (!display_format_to_gl(host.display.pixelformat, gl_format)) {
+        display_format_to_gl(SCE_DISPLAY_PIXELFORMAT_A8B8G8R8, gl_format);
+    }
+
     glPixelStorei(GL_UNPACK_ROW_LENGTH, host.display.pitch);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image_size.width, image_size.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glTexImage2D(GL_TEXTURE_2D, 0, gl_format.internal_format, image_size.width, image_size.height, 0, gl_format.format, gl_format.type, pixels);
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+void imgui::draw_main(HostState &host, GLuint texture_id) {
+    const auto window_size = host.display.window_size;
+    const auto image_size = host.display.image_size;
+
+    // workaround for imgui-related crash
+    if (host.display.image_size.width == 0)
+        return;
+
+    upload_screen_texture(host, texture_id);
 
     ImGui::SetNextWindowPos(ImVec2(0, MENUBAR_HEIGHT), ImGuiSetCond_Always);
     ImGui::SetNextWindowSize(ImVec2(window_size.width, window_size.height), ImGuiSetCond_Always);
@@ -65,3 +79,23 @@ void imgui::draw_end(WindowPtr window) {
     ImGui_ImplSdlGL3_RenderDrawData(ImGui::GetDrawData());
     SDL_GL_SwapWindow(window.get());
 }
+
+// Replays the previous frame's draw data without a NewFrame or any widget
+// traversal. The draw lists still reference the screen texture by id, so
+// refreshing the texture is all it takes to keep the game animating under
+// static widgets.
+bool imgui::draw_cached(HostState &host, GLuint texture_id, WindowPtr window) {
+    ImDrawData *const draw_data = ImGui::GetDrawData();
+    if ((draw_data == nullptr) || !draw_data->Valid) {
+        return false; // nothing rendered yet - the caller must rebuild
+    }
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    if (host.display.image_size.width != 0) {
+        upload_screen_texture(host, texture_id);
+    }
+    glViewport(0, 0, static_cast<int>(ImGui::GetIO().DisplaySize.x), static_cast<int>(ImGui::GetIO().DisplaySize.y));
+    ImGui_ImplSdlGL3_RenderDrawData(draw_data);
+    SDL_GL_SwapWindow(window.get());
+    return true;
+}
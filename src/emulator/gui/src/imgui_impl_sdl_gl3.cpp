@@ -45,6 +45,7 @@
 // SDL,GL3W
 #include <SDL.h>
 #include <SDL_syswm.h>
+#include <glbinding/gl/gl.h>
 #include <glutil/gl.h>
 
 // SDL data
@@ -60,6 +61,99 @@ static int g_AttribLocationTex = 0, g_AttribLocationProjMtx = 0;
 static int g_AttribLocationPosition = 0, g_AttribLocationUV = 0, g_AttribLocationColor = 0;
 static unsigned int g_VboHandle = 0, g_ElementsHandle = 0;
 
+// Draw-list streaming. With ARB_buffer_storage the vertex and index streams
+// live in persistent coherent mappings split into g_RingFrames fenced
+// regions, so a frame costs two memcpys and no buffer respecification. The
+// pinned 4.1-core context (macOS) lacks the extension and falls back to
+// orphaning - but once per frame for the whole draw data, not per list.
+static const int g_RingFrames = 3;
+static bool g_BufferStorageChecked = false;
+static bool g_PersistentBuffers = false;
+static uint8_t *g_VtxMapped = NULL;
+static uint8_t *g_IdxMapped = NULL;
+static GLsizeiptr g_VtxCapacity = 0; // bytes per ring region
+static GLsizeiptr g_IdxCapacity = 0;
+static int g_RingIndex = 0;
+static GLsync g_RingFences[g_RingFrames] = {};
+
+static bool ImGui_ImplSdlGL3_HasBufferStorage() {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++) {
+        const char *name = (const char *)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (name && strcmp(name, "GL_ARB_buffer_storage") == 0)
+            return true;
+    }
+    return false;
+}
+
+static void ImGui_ImplSdlGL3_DeleteRingFences() {
+    for (int i = 0; i < g_RingFrames; i++) {
+        if (g_RingFences[i]) {
+            glDeleteSync(g_RingFences[i]);
+            g_RingFences[i] = NULL;
+        }
+    }
+}
+
+// (Re)creates the stream buffers with at least the requested per-frame
+// capacity. Growing recreates the immutable stores; the old buffers are
+// orphaned by the driver once in-flight draws finish.
+static void ImGui_ImplSdlGL3_EnsureStreamCapacity(GLsizeiptr vtx_bytes, GLsizeiptr idx_bytes) {
+    if (!g_BufferStorageChecked) {
+        g_PersistentBuffers = ImGui_ImplSdlGL3_HasBufferStorage();
+        g_BufferStorageChecked = true;
+    }
+    if (!g_PersistentBuffers)
+        return;
+    if ((vtx_bytes <= g_VtxCapacity) && (idx_bytes <= g_IdxCapacity) && g_VtxMapped)
+        return;
+
+    GLsizeiptr vtx_capacity = g_VtxCapacity ? g_VtxCapacity : (GLsizeiptr)(256 * 1024);
+    GLsizeiptr idx_capacity = g_IdxCapacity ? g_IdxCapacity : (GLsizeiptr)(64 * 1024);
+    while (vtx_capacity < vtx_bytes)
+        vtx_capacity *= 2;
+    while (idx_capacity < idx_bytes)
+        idx_capacity *= 2;
+
+    ImGui_ImplSdlGL3_DeleteRingFences();
+    glDeleteBuffers(1, &g_VboHandle);
+    glDeleteBuffers(1, &g_ElementsHandle);
+    glGenBuffers(1, &g_VboHandle);
+    glGenBuffers(1, &g_ElementsHandle);
+
+    const gl::BufferStorageMask storage_flags = gl::GL_MAP_WRITE_BIT | gl::GL_MAP_PERSISTENT_BIT | gl::GL_MAP_COHERENT_BIT;
+    const gl::BufferAccessMask map_flags = gl::GL_MAP_WRITE_BIT | gl::GL_MAP_PERSISTENT_BIT | gl::GL_MAP_COHERENT_BIT;
+
+    glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
+    gl::glBufferStorage(gl::GL_ARRAY_BUFFER, vtx_capacity * g_RingFrames, NULL, storage_flags);
+    g_VtxMapped = (uint8_t *)gl::glMapBufferRange(gl::GL_ARRAY_BUFFER, 0, vtx_capacity * g_RingFrames, map_flags);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
+    gl::glBufferStorage(gl::GL_ELEMENT_ARRAY_BUFFER, idx_capacity * g_RingFrames, NULL, storage_flags);
+    g_IdxMapped = (uint8_t *)gl::glMapBufferRange(gl::GL_ELEMENT_ARRAY_BUFFER, 0, idx_capacity * g_RingFrames, map_flags);
+
+    if (!g_VtxMapped || !g_IdxMapped) {
+        // Driver refused the mapping - run on the orphaning path instead.
+        g_VtxMapped = g_IdxMapped = NULL;
+        g_PersistentBuffers = false;
+        return;
+    }
+
+    g_VtxCapacity = vtx_capacity;
+    g_IdxCapacity = idx_capacity;
+    g_RingIndex = 0;
+}
+
+static void ImGui_ImplSdlGL3_WaitRingFence(int index) {
+    if (!g_RingFences[index])
+        return;
+    // Usually signalled long ago - the ring is g_RingFrames deep.
+    glClientWaitSync(g_RingFences[index], GL_SYNC_FLUSH_COMMANDS_BIT, (GLuint64)1000 * 1000 * 1000);
+    glDeleteSync(g_RingFences[index]);
+    g_RingFences[index] = NULL;
+}
+
 // This is the main rendering function that you have to implement and provide to ImGui (via setting up 'RenderDrawListsFn' in the ImGuiIO structure)
 // Note that this implementation is little overcomplicated because we are saving/setting up/restoring every OpenGL state explicitly, in order to be able to run within any OpenGL engine that doesn't do so.
 // If text or lines are blurry when integrating ImGui in your engine: in your Render function, try translating your projection matrix by (0.5f,0.5f) or (0.375f,0.375f)
@@ -138,39 +232,91 @@ void ImGui_ImplSdlGL3_RenderDrawData(ImDrawData *draw_data) {
     GLuint vao_handle = 0;
     glGenVertexArrays(1, &vao_handle);
     glBindVertexArray(vao_handle);
-    glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
     glEnableVertexAttribArray(g_AttribLocationPosition);
     glEnableVertexAttribArray(g_AttribLocationUV);
     glEnableVertexAttribArray(g_AttribLocationColor);
-    glVertexAttribPointer(g_AttribLocationPosition, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid *)IM_OFFSETOF(ImDrawVert, pos));
-    glVertexAttribPointer(g_AttribLocationUV, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid *)IM_OFFSETOF(ImDrawVert, uv));
-    glVertexAttribPointer(g_AttribLocationColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid *)IM_OFFSETOF(ImDrawVert, col));
 
-    // Draw
+    // Stage every draw list's vertices and indices for the frame in one go:
+    // into this frame's region of the persistent ring, or after a single
+    // whole-frame orphaning on drivers without buffer_storage.
+    GLsizeiptr total_vtx_bytes = 0;
+    GLsizeiptr total_idx_bytes = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        total_vtx_bytes += (GLsizeiptr)draw_data->CmdLists[n]->VtxBuffer.Size * sizeof(ImDrawVert);
+        total_idx_bytes += (GLsizeiptr)draw_data->CmdLists[n]->IdxBuffer.Size * sizeof(ImDrawIdx);
+    }
+    ImGui_ImplSdlGL3_EnsureStreamCapacity(total_vtx_bytes, total_idx_bytes);
+
+    GLsizeiptr vtx_offset = 0;
+    GLsizeiptr idx_offset = 0;
+    glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
+    if (g_PersistentBuffers) {
+        ImGui_ImplSdlGL3_WaitRingFence(g_RingIndex);
+        vtx_offset = g_RingIndex * g_VtxCapacity;
+        idx_offset = g_RingIndex * g_IdxCapacity;
+    } else if ((total_vtx_bytes > 0) && (total_idx_bytes > 0)) {
+        glBufferData(GL_ARRAY_BUFFER, total_vtx_bytes, NULL, GL_STREAM_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, total_idx_bytes, NULL, GL_STREAM_DRAW);
+    }
+
+    // Draw, skipping redundant texture binds and scissor changes - draw
+    // lists produce runs of commands that share both.
+    GLuint last_bound_texture = 0;
+    bool texture_bound = false;
+    int last_scissor[4] = { -1, -1, -1, -1 };
     for (int n = 0; n < draw_data->CmdListsCount; n++) {
         const ImDrawList *cmd_list = draw_data->CmdLists[n];
-        const ImDrawIdx *idx_buffer_offset = 0;
+        const GLsizeiptr vtx_bytes = (GLsizeiptr)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
+        const GLsizeiptr idx_bytes = (GLsizeiptr)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
 
-        glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
-        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert), (const GLvoid *)cmd_list->VtxBuffer.Data, GL_STREAM_DRAW);
+        if (g_PersistentBuffers) {
+            memcpy(g_VtxMapped + vtx_offset, cmd_list->VtxBuffer.Data, vtx_bytes);
+            memcpy(g_IdxMapped + idx_offset, cmd_list->IdxBuffer.Data, idx_bytes);
+        } else {
+            glBufferSubData(GL_ARRAY_BUFFER, vtx_offset, vtx_bytes, cmd_list->VtxBuffer.Data);
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, idx_offset, idx_bytes, cmd_list->IdxBuffer.Data);
+        }
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), (const GLvoid *)cmd_list->IdxBuffer.Data, GL_STREAM_DRAW);
+        glVertexAttribPointer(g_AttribLocationPosition, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid *)(vtx_offset + IM_OFFSETOF(ImDrawVert, pos)));
+        glVertexAttribPointer(g_AttribLocationUV, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid *)(vtx_offset + IM_OFFSETOF(ImDrawVert, uv)));
+        glVertexAttribPointer(g_AttribLocationColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid *)(vtx_offset + IM_OFFSETOF(ImDrawVert, col)));
 
+        GLsizeiptr idx_buffer_offset = idx_offset;
         for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++) {
             const ImDrawCmd *pcmd = &cmd_list->CmdBuffer[cmd_i];
             if (pcmd->UserCallback) {
                 pcmd->UserCallback(cmd_list, pcmd);
+                // The callback may have rebound anything.
+                texture_bound = false;
+                last_scissor[0] = last_scissor[1] = last_scissor[2] = last_scissor[3] = -1;
             } else {
-                glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->TextureId);
-                glScissor((int)pcmd->ClipRect.x, (int)(fb_height - pcmd->ClipRect.w), (int)(pcmd->ClipRect.z - pcmd->ClipRect.x), (int)(pcmd->ClipRect.w - pcmd->ClipRect.y));
-                glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer_offset);
+                const GLuint texture = (GLuint)(intptr_t)pcmd->TextureId;
+                if (!texture_bound || (texture != last_bound_texture)) {
+                    glBindTexture(GL_TEXTURE_2D, texture);
+                    last_bound_texture = texture;
+                    texture_bound = true;
+                }
+                const int scissor[4] = { (int)pcmd->ClipRect.x, (int)(fb_height - pcmd->ClipRect.w), (int)(pcmd->ClipRect.z - pcmd->ClipRect.x), (int)(pcmd->ClipRect.w - pcmd->ClipRect.y) };
+                if (memcmp(scissor, last_scissor, sizeof(scissor)) != 0) {
+                    glScissor(scissor[0], scissor[1], scissor[2], scissor[3]);
+                    memcpy(last_scissor, scissor, sizeof(scissor));
+                }
+                glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (GLvoid *)idx_buffer_offset);
             }
-            idx_buffer_offset += pcmd->ElemCount;
+            idx_buffer_offset += (GLsizeiptr)pcmd->ElemCount * sizeof(ImDrawIdx);
         }
+
+        vtx_offset += vtx_bytes;
+        idx_offset += idx_bytes;
     }
     glDeleteVertexArrays(1, &vao_handle);
 
+    if (g_PersistentBuffers) {
+        g_RingFences[g_RingIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        g_RingIndex = (g_RingIndex + 1) % g_RingFrames;
+    }
+
     // Restore modified GL state
     glUseProgram(last_program);
     glBindTexture(GL_TEXTURE_2D, last_texture);
@@ -343,6 +489,13 @@ bool ImGui_ImplSdlGL3_CreateDeviceObjects() {
 }
 
 void ImGui_ImplSdlGL3_InvalidateDeviceObjects() {
+    ImGui_ImplSdlGL3_DeleteRingFences();
+    // Deleting the buffers implicitly unmaps them.
+    g_VtxMapped = g_IdxMapped = NULL;
+    g_VtxCapacity = g_IdxCapacity = 0;
+    g_RingIndex = 0;
+    g_BufferStorageChecked = g_PersistentBuffers = false;
+
     if (g_VboHandle)
         glDeleteBuffers(1, &g_VboHandle);
     if (g_ElementsHandle)
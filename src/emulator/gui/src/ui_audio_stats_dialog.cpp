@@ -0,0 +1,73 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <gui/functions.h>
+#include <imgui.h>
+
+#include <host/state.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+void DrawAudioStatsDialog(HostState &host) {
+    ImGui::Begin("Audio Telemetry", &host.gui.audio_stats_dialog);
+
+    std::vector<AudioOutPortPtr> ports;
+    {
+        const std::shared_lock<std::shared_mutex> lock(host.audio.shared.mutex);
+        ports = host.audio.shared.out_ports;
+    }
+
+    const uint64_t byte_rate = uint64_t(host.audio.ro.spec.freq) * host.audio.ro.spec.channels * sizeof(int16_t);
+
+    ImGui::TextColored(ImVec4(255, 255, 0, 255), "%-5s %-10s %-10s %-10s %-11s %-12s %-11s",
+        "Port", "Periods", "Underruns", "Avg Depth", "Avg Mix us", "Peak Mix us", "Latency ms");
+
+    for (size_t i = 0; i < ports.size(); ++i) {
+        if (!ports[i]) {
+            continue;
+        }
+        const AudioOutPortStats &stats = ports[i]->stats;
+        const uint64_t periods = std::max<uint64_t>(stats.periods, 1);
+        ImGui::Text("%-5zu %-10llu %-10llu %-10llu %-11llu %-12llu %llu",
+            i,
+            static_cast<unsigned long long>(stats.periods.load()),
+            static_cast<unsigned long long>(stats.underruns.load()),
+            static_cast<unsigned long long>(stats.depth_sum / periods),
+            static_cast<unsigned long long>(stats.mix_ns_sum / periods / 1000),
+            static_cast<unsigned long long>(stats.mix_ns_peak / 1000),
+            static_cast<unsigned long long>((stats.queued_bytes + host.audio.ro.spec.size) * 1000 / byte_rate));
+    }
+
+    ImGui::Separator();
+    ImGui::Text("Buffer depth over time (one sample per audio period):");
+    for (size_t i = 0; i < ports.size(); ++i) {
+        if (!ports[i]) {
+            continue;
+        }
+        AudioOutPortStats &stats = ports[i]->stats;
+        char label[32];
+        snprintf(label, sizeof(label), "port %zu", i);
+        ImGui::PlotLines(label, stats.depth_history.data(), static_cast<int>(stats.depth_history.size()),
+            static_cast<int>(stats.depth_history_pos), nullptr, 0.0f, 8.0f, ImVec2(0, 48));
+    }
+
+    ImGui::End();
+}
@@ -19,23 +19,20 @@
 #include <imgui.h>
 
 #include <host/state.h>
-#include <kernel/thread/thread_functions.h>
-#include <kernel/thread/thread_state.h>
-#include <util/resource.h>
 
 void DrawCondvarsDialog(HostState &host) {
     ImGui::Begin("Condition Variables", &host.gui.condvars_dialog);
     ImGui::TextColored(ImVec4(255, 255, 0, 255), "%-16s %-32s   %-16s %-16s", "ID", "Name", "Attributes", "Waiting Threads");
 
-    const std::lock_guard<std::mutex> lock(host.kernel.mutex);
+    // Rendered from the published snapshot - no kernel lock held here.
+    const KernelDebugSnapshot &snapshot = host.gui.kernel_snapshots[host.gui.kernel_snapshot_front];
 
-    for (auto condvar : host.kernel.condvars) {
-        std::shared_ptr<Condvar> sema_state = condvar.second;
+    for (const CondvarSnapshotRow &condvar : snapshot.condvars) {
         ImGui::Text("0x%08X       %-32s   %02d             %02zu",
-            condvar.first,
-            sema_state->name,
-            sema_state->attr,
-            sema_state->waiting_threads.size());
+            condvar.id,
+            condvar.name.c_str(),
+            condvar.attr,
+            condvar.waiters);
     }
     ImGui::End();
 }
@@ -44,15 +41,14 @@ void DrawLwCondvarsDialog(HostState &host) {
     ImGui::Begin("Lightweight Condition Variables", &host.gui.lwcondvars_dialog);
     ImGui::TextColored(ImVec4(255, 255, 0, 255), "%-16s %-32s   %-16s %-16s", "ID", "Name", "Attributes", "Waiting Threads");
 
-    const std::lock_guard<std::mutex> lock(host.kernel.mutex);
+    const KernelDebugSnapshot &snapshot = host.gui.kernel_snapshots[host.gui.kernel_snapshot_front];
 
-    for (auto condvar : host.kernel.lwcondvars) {
-        std::shared_ptr<Condvar> sema_state = condvar.second;
+    for (const CondvarSnapshotRow &condvar : snapshot.lwcondvars) {
         ImGui::Text("0x%08X       %-32s   %02d             %02zu",
-            condvar.first,
-            sema_state->name,
-            sema_state->attr,
-            sema_state->waiting_threads.size());
+            condvar.id,
+            condvar.name.c_str(),
+            condvar.attr,
+            condvar.waiters);
     }
     ImGui::End();
 }
@@ -19,23 +19,21 @@
 #include <imgui.h>
 
 #include <host/state.h>
-#include <kernel/thread/thread_functions.h>
-#include <kernel/thread/thread_state.h>
-#include <util/resource.h>
 
 void DrawEventFlagsDialog(HostState &host) {
     ImGui::Begin("Event Flags", &host.gui.eventflags_dialog);
     ImGui::TextColored(ImVec4(255, 255, 0, 255), "%-16s %-32s  %-7s   %-8s   %-16s", "ID", "EventFlag Name", "Flags", "Attributes", "Waiting Threads");
 
-    const std::lock_guard<std::mutex> lock(host.kernel.mutex);
-    for (auto event : host.kernel.eventflags) {
-        std::shared_ptr<EventFlag> event_state = event.second;
+    // Rendered from the published snapshot - no kernel lock held here.
+    const KernelDebugSnapshot &snapshot = host.gui.kernel_snapshots[host.gui.kernel_snapshot_front];
+
+    for (const EventFlagSnapshotRow &event : snapshot.eventflags) {
         ImGui::Text("0x%08X       %-32s  %02d        %01d         %02zu                 ",
-            event.first,
-            event_state->name,
-            event_state->flags,
-            event_state->attr,
-            event_state->waiting_threads.size());
+            event.id,
+            event.name.c_str(),
+            event.flags,
+            event.attr,
+            event.waiters);
     }
     ImGui::End();
 }
@@ -0,0 +1,55 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <gui/functions.h>
+#include <imgui.h>
+
+#include <gxm/gpu_timer_functions.h>
+#include <gxm/types.h>
+#include <host/state.h>
+
+void DrawGpuProfilerDialog(HostState &host) {
+    ImGui::Begin("GPU Profiler", &host.gui.gpu_profiler_dialog);
+
+    const Ptr<SceGxmContext> context = host.gxm.context;
+    if (!context) {
+        ImGui::Text("No GXM context.");
+        ImGui::End();
+        return;
+    }
+
+    // Timings are written on the render thread; reads here are racy but
+    // only feed this display.
+    const GpuTimerState &timer = context.get(host.mem)->renderer.gpu_timer;
+
+    ImGui::Text("%-16s %10s %10s %8s", "stage", "avg/frame", "last", "dropped");
+    ImGui::Separator();
+    for (size_t stage = 0; stage < GpuTimerStageCount; ++stage) {
+        if (stage == GPU_TIMER_STAGE_PRESENT) {
+            continue; // measured on the present context below
+        }
+
+        const GpuTimerStageTimings &timings = timer.stages[stage].timings;
+        ImGui::Text("%-16s %7.3f ms %7.3f ms %8llu", gpu_timer_stage_names[stage],
+            timings.average_frame_ns / 1e6, timings.last_frame_ns / 1e6,
+            static_cast<unsigned long long>(timings.dropped));
+    }
+    ImGui::Text("%-16s %7.3f ms %7.3f ms", gpu_timer_stage_names[GPU_TIMER_STAGE_PRESENT],
+        host.display.present_time_avg_ns / 1e6, host.display.present_time_last_ns / 1e6);
+
+    ImGui::End();
+}
@@ -0,0 +1,80 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <gui/functions.h>
+#include <imgui.h>
+
+#include <host/functions.h>
+#include <host/state.h>
+
+#include <algorithm>
+#include <vector>
+
+static constexpr size_t MAX_ROWS = 32;
+
+struct ImportStatsRow {
+    const char *name = nullptr;
+    ImportCallStats stats;
+};
+
+void DrawImportStatsDialog(HostState &host) {
+    ImGui::Begin("HLE Imports", &host.gui.import_stats_dialog);
+
+    ImGui::Checkbox("Record", &host.hle_telemetry.enabled);
+    ImGui::SameLine();
+    if (ImGui::Button("Dump JSON")) {
+        dump_hle_telemetry(host, host.pref_path + "hle_telemetry.json");
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Reset")) {
+        const std::lock_guard<std::mutex> lock(host.hle_telemetry.mutex);
+        host.hle_telemetry.imports.clear();
+    }
+    ImGui::Separator();
+
+    std::vector<ImportStatsRow> rows;
+    {
+        const std::lock_guard<std::mutex> lock(host.hle_telemetry.mutex);
+        for (const auto &entry : host.hle_telemetry.imports) {
+            ImportStatsRow row;
+            row.name = entry.first;
+            row.stats = entry.second;
+            rows.push_back(row);
+        }
+    }
+
+    std::sort(rows.begin(), rows.end(), [](const ImportStatsRow &a, const ImportStatsRow &b) {
+        return a.stats.total_ns > b.stats.total_ns;
+    });
+
+    ImGui::TextColored(ImVec4(255, 255, 0, 255), "%-40s %-12s %-12s %-10s %-10s",
+        "Import", "Calls", "Total us", "Avg us", "Worst us");
+
+    const size_t count = std::min(rows.size(), MAX_ROWS);
+    for (size_t i = 0; i < count; ++i) {
+        const ImportStatsRow &row = rows[i];
+        const uint64_t avg_ns = (row.stats.calls > 0) ? (row.stats.total_ns / row.stats.calls) : 0;
+        ImGui::Text("%-40s %-12llu %-12llu %-10llu %llu",
+            row.name,
+            static_cast<unsigned long long>(row.stats.calls),
+            static_cast<unsigned long long>(row.stats.total_ns / 1000),
+            static_cast<unsigned long long>(avg_ns / 1000),
+            static_cast<unsigned long long>(row.stats.worst_ns / 1000));
+    }
+
+    ImGui::End();
+}
@@ -0,0 +1,96 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <gui/functions.h>
+#include <imgui.h>
+
+#include <host/state.h>
+#include <io/functions.h>
+
+#include <algorithm>
+#include <vector>
+
+static constexpr size_t MAX_ROWS = 32;
+
+struct IoStatsRow {
+    std::string path;
+    IoFdStats stats;
+};
+
+// Upper bound of the highest occupied latency bucket, i.e. the worst
+// observed read latency rounded up to a power of two microseconds.
+static uint64_t worst_latency_us(const IoOpStats &op) {
+    for (size_t i = IO_LATENCY_BUCKETS; i > 0; i--) {
+        if (op.latency_us_hist[i - 1] > 0) {
+            return 1ull << (i - 1);
+        }
+    }
+    return 0;
+}
+
+void DrawIoStatsDialog(HostState &host) {
+    ImGui::Begin("I/O Telemetry", &host.gui.io_stats_dialog);
+
+    ImGui::Checkbox("Record", &host.io.telemetry.enabled);
+    ImGui::SameLine();
+    if (ImGui::Button("Dump JSON")) {
+        dump_io_telemetry(host.io, host.pref_path + "io_telemetry.json");
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Reset")) {
+        const std::lock_guard<std::mutex> lock(host.io.telemetry.mutex);
+        host.io.telemetry.files.clear();
+    }
+    ImGui::Separator();
+
+    std::vector<IoStatsRow> rows;
+    {
+        const std::lock_guard<std::mutex> lock(host.io.telemetry.mutex);
+        for (const auto &entry : host.io.telemetry.files) {
+            IoStatsRow row;
+            row.path = entry.first;
+            row.stats = entry.second;
+            rows.push_back(row);
+        }
+    }
+
+    std::sort(rows.begin(), rows.end(), [](const IoStatsRow &a, const IoStatsRow &b) {
+        return a.stats.reads.bytes + a.stats.writes.bytes > b.stats.reads.bytes + b.stats.writes.bytes;
+    });
+
+    ImGui::TextColored(ImVec4(255, 255, 0, 255), "%-40s %-7s %-9s %-12s %-6s %-9s %-12s %-7s %-12s",
+        "Path", "Opens", "Reads", "Read B", "Seq%", "Writes", "Written B", "Seeks", "Worst Rd us");
+
+    const size_t count = std::min(rows.size(), MAX_ROWS);
+    for (size_t i = 0; i < count; ++i) {
+        const IoStatsRow &row = rows[i];
+        const uint64_t total_reads = row.stats.sequential_reads + row.stats.random_reads;
+        const uint64_t seq_percent = (total_reads > 0) ? ((row.stats.sequential_reads * 100) / total_reads) : 0;
+        ImGui::Text("%-40s %-7llu %-9llu %-12llu %-6llu %-9llu %-12llu %-7llu %llu",
+            row.path.c_str(),
+            static_cast<unsigned long long>(row.stats.opens),
+            static_cast<unsigned long long>(row.stats.reads.count),
+            static_cast<unsigned long long>(row.stats.reads.bytes),
+            static_cast<unsigned long long>(seq_percent),
+            static_cast<unsigned long long>(row.stats.writes.count),
+            static_cast<unsigned long long>(row.stats.writes.bytes),
+            static_cast<unsigned long long>(row.stats.seeks),
+            static_cast<unsigned long long>(worst_latency_us(row.stats.reads)));
+    }
+
+    ImGui::End();
+}
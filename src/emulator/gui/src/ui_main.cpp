@@ -19,8 +19,30 @@
 #include <host/app.h>
 #include <host/state.h>
 
+#include <glutil/gl.h>
 #include <imgui.h>
 
+#include <mutex>
+#include <string>
+
+// Uploads a decoded icon the first frame it is needed; afterwards the
+// texture id rides in the selector state and this is a no-op.
+static void upload_game_icon(GameIcon &icon) {
+    if ((icon.texture != 0) || (icon.width == 0)) {
+        return;
+    }
+    GLint last_texture;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, icon.width, icon.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, icon.rgba.data());
+    glBindTexture(GL_TEXTURE_2D, last_texture);
+    icon.texture = texture;
+}
+
 void DrawGameSelector(HostState &host, AppRunType *run_type) {
     ImGui::SetNextWindowPos(ImVec2(0, 19), ImGuiSetCond_Always);
     ImGui::SetNextWindowSize(ImVec2(host.display.window_size.width, host.display.window_size.height - MENUBAR_HEIGHT), ImGuiSetCond_Always);
@@ -29,9 +51,15 @@ void DrawGameSelector(HostState &host, AppRunType *run_type) {
     case SELECT_APP:
         ImGui::TextColored(ImVec4(255, 255, 0, 255), "Select the game/application to start");
         ImGui::Separator();
-        int i = 0;
-        for (auto titleid : host.gui.game_selector.title_ids) {
-            std::string button_text = host.gui.game_selector.titles.at(i++);
+        for (size_t i = 0; i < host.gui.game_selector.title_ids.size(); ++i) {
+            const std::string &titleid = host.gui.game_selector.title_ids.at(i);
+            GameIcon &icon = host.gui.game_selector.icons.at(i);
+            upload_game_icon(icon);
+            if (icon.texture != 0) {
+                ImGui::Image(reinterpret_cast<ImTextureID>(static_cast<intptr_t>(icon.texture)), ImVec2(48, 48));
+                ImGui::SameLine();
+            }
+            std::string button_text = host.gui.game_selector.titles.at(i);
             button_text += " (" + titleid + ")";
             if (ImGui::Button(button_text.c_str())) {
                 host.gui.game_selector.title_id = titleid;
@@ -59,9 +87,60 @@ void DrawReinstallDialog(HostState &host, GenericDialogState *status) {
     ImGui::End();
 }
 
+void DrawBootProgress(HostState &host) {
+    std::string stage;
+    float progress = -1.0f;
+    bool reinstall_pending = false;
+    {
+        const std::lock_guard<std::mutex> lock(host.boot_status.mutex);
+        stage = host.boot_status.stage;
+        progress = host.boot_status.progress;
+        reinstall_pending = host.boot_status.reinstall_pending && (host.boot_status.reinstall_choice == 0);
+    }
+
+    // The loader thread is blocked on this question - post the choice back
+    // and wake it.
+    if (reinstall_pending) {
+        GenericDialogState choice = UNK_STATE;
+        DrawReinstallDialog(host, &choice);
+        if (choice != UNK_STATE) {
+            const std::lock_guard<std::mutex> lock(host.boot_status.mutex);
+            host.boot_status.reinstall_choice = choice;
+            host.boot_status.decision.notify_all();
+        }
+        return;
+    }
+
+    if (stage.empty()) {
+        return;
+    }
+
+    ImGui::SetNextWindowPosCenter();
+    ImGui::SetNextWindowSize(ImVec2(0, 0));
+    ImGui::Begin("Booting", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
+    ImGui::Text("%s...", stage.c_str());
+    if (progress >= 0.0f) {
+        ImGui::ProgressBar(progress, ImVec2(200, 0));
+    }
+    ImGui::End();
+}
+
 void DrawUI(HostState &host) {
     DrawMainMenuBar(host);
 
+    if (host.gui.perf_hud) {
+        DrawPerfHud(host);
+    }
+
+    // Refresh the back snapshot buffer while any kernel dialog is open -
+    // the copy holds the kernel lock for microseconds and the dialogs
+    // then render the front buffer without touching KernelState at all.
+    if (host.gui.threads_dialog || host.gui.semaphores_dialog || host.gui.mutexes_dialog || host.gui.lwmutexes_dialog || host.gui.condvars_dialog || host.gui.lwcondvars_dialog || host.gui.eventflags_dialog) {
+        const int back = 1 - host.gui.kernel_snapshot_front;
+        capture_debug_snapshot(host.kernel, host.gui.kernel_snapshots[back]);
+        host.gui.kernel_snapshot_front = back;
+    }
+
     if (host.gui.threads_dialog) {
         DrawThreadsDialog(host);
     }
@@ -83,4 +162,26 @@ void DrawUI(HostState &host) {
     if (host.gui.eventflags_dialog) {
         DrawEventFlagsDialog(host);
     }
+    if (host.gui.sync_stats_dialog) {
+        DrawSyncStatsDialog(host);
+    }
+    if (host.gui.io_stats_dialog) {
+        DrawIoStatsDialog(host);
+    }
+
+    if (host.gui.audio_stats_dialog) {
+        DrawAudioStatsDialog(host);
+    }
+    if (host.gui.import_stats_dialog) {
+        DrawImportStatsDialog(host);
+    }
+    if (host.gui.profiler_dialog) {
+        DrawProfilerDialog(host);
+    }
+    if (host.gui.texture_cache_dialog) {
+        DrawTextureCacheDialog(host);
+    }
+    if (host.gui.gpu_profiler_dialog) {
+        DrawGpuProfilerDialog(host);
+    }
 }
@@ -15,9 +15,15 @@
 // with this program; if not, write to the Free Software Foundation, Inc.,
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
+#include <cpu/functions.h>
 #include <gui/functions.h>
+#include <gxm/functions.h>
+#include <host/save_state.h>
 #include <host/state.h>
 #include <imgui.h>
+#include <util/log.h>
+
+#include <cstdio>
 
 void DrawMainMenuBar(HostState &host) {
     if (ImGui::BeginMainMenuBar()) {
@@ -29,11 +35,92 @@ void DrawMainMenuBar(HostState &host) {
             ImGui::MenuItem("Condition Variables", nullptr, &host.gui.condvars_dialog);
             ImGui::MenuItem("Lightweight Condition Variables", nullptr, &host.gui.lwcondvars_dialog);
             ImGui::MenuItem("Event Flags", nullptr, &host.gui.eventflags_dialog);
+            ImGui::MenuItem("Sync Contention", nullptr, &host.gui.sync_stats_dialog);
+            ImGui::MenuItem("I/O Telemetry", nullptr, &host.gui.io_stats_dialog);
+            ImGui::MenuItem("Audio Telemetry", nullptr, &host.gui.audio_stats_dialog);
+            ImGui::MenuItem("HLE Imports", nullptr, &host.gui.import_stats_dialog);
+            ImGui::MenuItem("Profiler", nullptr, &host.gui.profiler_dialog);
+            ImGui::MenuItem("Texture Cache", nullptr, &host.gui.texture_cache_dialog);
+            ImGui::MenuItem("GPU Profiler", nullptr, &host.gui.gpu_profiler_dialog);
+            ImGui::MenuItem("Performance HUD", nullptr, &host.gui.perf_hud);
+            ImGui::Separator();
+            // Runs synchronously on the UI thread for about two seconds; a
+            // debug tool, so the stall is acceptable and keeps the machine
+            // quiet while the score is taken.
+            if (ImGui::MenuItem("CPU Benchmark")) {
+                const double mips = run_cpu_benchmark(host.kernel.cpu_backend, host.mem);
+                if (mips >= 0.0) {
+                    LOG_INFO("CPU benchmark: {:.1f} MIPS ({}).", mips,
+                        (host.kernel.cpu_backend == CPUBackend::Dynarmic) ? "dynarmic" : "unicorn");
+                } else {
+                    LOG_ERROR("CPU benchmark failed to run.");
+                }
+            }
+            ImGui::EndMenu();
+        }
+
+        if (ImGui::BeginMenu("Emulation")) {
+            // Runs on the UI thread; both calls park the guest threads
+            // themselves for the duration.
+            if (ImGui::MenuItem("Save State")) {
+                save_state(host, save_state_path(host));
+            }
+            if (ImGui::MenuItem("Load State")) {
+                load_state(host, save_state_path(host));
+            }
             ImGui::EndMenu();
         }
 
         if (ImGui::BeginMenu("Optimisation")) {
             ImGui::MenuItem("Texture Cache", nullptr, &host.gui.texture_cache);
+            if (ImGui::BeginMenu("Internal Resolution")) {
+                for (uint32_t multiplier = 1; multiplier <= 4; ++multiplier) {
+                    char label[8];
+                    snprintf(label, sizeof(label), "%ux", multiplier);
+                    if (ImGui::MenuItem(label, nullptr, host.gxm.resolution_multiplier == multiplier)) {
+                        host.gxm.resolution_multiplier = multiplier;
+                    }
+                }
+                ImGui::EndMenu();
+            }
+            if (ImGui::BeginMenu("Speed Governor")) {
+                const bool unlocked = host.display.unlocked_speed.load();
+                if (ImGui::MenuItem("Unlocked", nullptr, unlocked)) {
+                    host.display.unlocked_speed.store(!unlocked);
+                    // No vblank pacing means no point blocking producers on
+                    // the display queue cap either - and back again.
+                    host.gxm.pacing = unlocked ? DISPLAY_PACING_STRICT : DISPLAY_PACING_UNLOCKED;
+                    apply_display_pacing(host.gxm);
+                }
+                const uint32_t turbo = host.display.turbo_multiplier.load();
+                for (uint32_t multiplier = 1; multiplier <= 4; multiplier *= 2) {
+                    char label[16];
+                    snprintf(label, sizeof(label), "Turbo %ux", multiplier);
+                    if (ImGui::MenuItem(label, nullptr, turbo == multiplier)) {
+                        host.display.turbo_multiplier.store(multiplier);
+                    }
+                }
+                const bool skip = host.display.auto_frame_skip.load();
+                if (ImGui::MenuItem("Auto Frame Skip", nullptr, skip)) {
+                    host.display.auto_frame_skip.store(!skip);
+                }
+                ImGui::EndMenu();
+            }
+            if (ImGui::BeginMenu("Display Pacing")) {
+                if (ImGui::MenuItem("Strict", nullptr, host.gxm.pacing == DISPLAY_PACING_STRICT)) {
+                    host.gxm.pacing = DISPLAY_PACING_STRICT;
+                    apply_display_pacing(host.gxm);
+                }
+                if (ImGui::MenuItem("Triple Buffered", nullptr, host.gxm.pacing == DISPLAY_PACING_TRIPLE)) {
+                    host.gxm.pacing = DISPLAY_PACING_TRIPLE;
+                    apply_display_pacing(host.gxm);
+                }
+                if (ImGui::MenuItem("Unlocked", nullptr, host.gxm.pacing == DISPLAY_PACING_UNLOCKED)) {
+                    host.gxm.pacing = DISPLAY_PACING_UNLOCKED;
+                    apply_display_pacing(host.gxm);
+                }
+                ImGui::EndMenu();
+            }
             ImGui::EndMenu();
         }
         ImGui::EndMainMenuBar();
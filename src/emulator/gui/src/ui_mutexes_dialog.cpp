@@ -19,25 +19,22 @@
 #include <imgui.h>
 
 #include <host/state.h>
-#include <kernel/thread/thread_functions.h>
-#include <kernel/thread/thread_state.h>
-#include <util/resource.h>
 
 void DrawMutexesDialog(HostState &host) {
     ImGui::Begin("Mutexes", &host.gui.mutexes_dialog);
     ImGui::TextColored(ImVec4(255, 255, 0, 255), "%-16s %-32s   %-7s   %-8s   %-16s   %-16s", "ID", "Mutex Name", "Status", "Attributes", "Waiting Threads", "Owner");
 
-    const std::lock_guard<std::mutex> lock(host.kernel.mutex);
+    // Rendered from the published snapshot - no kernel lock held here.
+    const KernelDebugSnapshot &snapshot = host.gui.kernel_snapshots[host.gui.kernel_snapshot_front];
 
-    for (auto mutex : host.kernel.mutexes) {
-        std::shared_ptr<Mutex> mutex_state = mutex.second;
+    for (const MutexSnapshotRow &mutex : snapshot.mutexes) {
         ImGui::Text("0x%08X       %-32s   %02d        %01d            %02zu                 %s",
-            mutex.first,
-            mutex_state->name,
-            mutex_state->lock_count,
-            mutex_state->attr,
-            mutex_state->waiting_threads.size(),
-            mutex_state->owner == nullptr ? "not owned" : mutex_state->owner->name.c_str());
+            mutex.id,
+            mutex.name.c_str(),
+            mutex.lock_count,
+            mutex.attr,
+            mutex.waiters,
+            mutex.owner.empty() ? "not owned" : mutex.owner.c_str());
     }
     ImGui::End();
 }
@@ -46,16 +43,15 @@ void DrawLwMutexesDialog(HostState &host) {
     ImGui::Begin("Lightweight Mutexes", &host.gui.lwmutexes_dialog);
     ImGui::TextColored(ImVec4(255, 255, 0, 255), "%-16s %-32s   %-7s   %-8s  %-16s   %-16s", "ID", "LwMutex Name", "Status", "Attributes", "Waiting Threads", "Owner");
 
-    const std::lock_guard<std::mutex> lock(host.kernel.mutex);
-    for (auto mutex : host.kernel.lwmutexes) {
-        std::shared_ptr<Mutex> mutex_state = mutex.second;
+    const KernelDebugSnapshot &snapshot = host.gui.kernel_snapshots[host.gui.kernel_snapshot_front];
+    for (const MutexSnapshotRow &mutex : snapshot.lwmutexes) {
         ImGui::Text("0x%08X       %-32s   %02d        %01d           %02zu                 %s",
-            mutex.first,
-            mutex_state->name,
-            mutex_state->lock_count,
-            mutex_state->attr,
-            mutex_state->waiting_threads.size(),
-            mutex_state->owner == nullptr ? "not owned" : mutex_state->owner->name.c_str());
+            mutex.id,
+            mutex.name.c_str(),
+            mutex.lock_count,
+            mutex.attr,
+            mutex.waiters,
+            mutex.owner.empty() ? "not owned" : mutex.owner.c_str());
     }
     ImGui::End();
 }
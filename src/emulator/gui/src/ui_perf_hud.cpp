@@ -0,0 +1,121 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <gui/functions.h>
+#include <imgui.h>
+
+#include <cpu/functions.h>
+#include <gxm/types.h>
+#include <host/state.h>
+#include <util/hitch.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+
+// Percentile over a copy of the frame-time ring. 128 floats, so the
+// nth_element costs nothing against a UI frame.
+static float percentile(const std::array<float, 128> &samples, float fraction) {
+    std::array<float, 128> sorted = samples;
+    const size_t nth = static_cast<size_t>((sorted.size() - 1) * fraction);
+    std::nth_element(sorted.begin(), sorted.begin() + nth, sorted.end());
+    return sorted[nth];
+}
+
+void DrawPerfHud(HostState &host) {
+    PerfHudState &hud = host.gui.perf_hud_state;
+    const auto now = std::chrono::steady_clock::now();
+
+    // UI frame time into the ring.
+    if (hud.last_frame.time_since_epoch().count() != 0) {
+        const float ms = std::chrono::duration<float, std::milli>(now - hud.last_frame).count();
+        hud.frame_ms[hud.pos] = ms;
+        hud.pos = (hud.pos + 1) % hud.frame_ms.size();
+    }
+    hud.last_frame = now;
+
+    // Rates are sampled every half second; frame_count is reset by the
+    // periodic FPS log, so a smaller reading means start over.
+    const float since_sample = std::chrono::duration<float>(now - hud.last_rate_sample).count();
+    if (since_sample >= 0.5f) {
+        const uint64_t guest_frames = host.frame_count;
+        const uint64_t draws = host.gxm.draw_count;
+        if (guest_frames >= hud.last_guest_frames) {
+            const uint64_t frame_delta = guest_frames - hud.last_guest_frames;
+            hud.guest_fps = frame_delta / since_sample;
+            if (frame_delta > 0) {
+                hud.draws_per_frame = static_cast<float>(draws - hud.last_draws) / frame_delta;
+            }
+        }
+        hud.last_guest_frames = guest_frames;
+        hud.last_draws = draws;
+        hud.last_rate_sample = now;
+
+        // The instruction counter is process-wide and monotonic, so the
+        // delta over the sample window is guest MIPS across all threads.
+        const uint64_t instructions = cpu_instructions_executed();
+        hud.guest_mips = static_cast<float>((instructions - hud.last_instructions) / since_sample / 1e6);
+        hud.last_instructions = instructions;
+    }
+
+    ImGui::SetNextWindowPos(ImVec2(10.0f, 30.0f), ImGuiSetCond_Always);
+    ImGui::Begin("##perf_hud", nullptr, ImVec2(0, 0), 0.4f,
+        ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_AlwaysAutoResize);
+
+    ImGui::Text("%.0f FPS  p50 %.1f ms  p99 %.1f ms", hud.guest_fps,
+        percentile(hud.frame_ms, 0.5f), percentile(hud.frame_ms, 0.99f));
+    ImGui::PlotLines("##frame_times", hud.frame_ms.data(), static_cast<int>(hud.frame_ms.size()),
+        static_cast<int>(hud.pos), nullptr, 0.0f, 50.0f, ImVec2(180, 32));
+
+    ImGui::Text("%.0f draws/frame", hud.draws_per_frame);
+    ImGui::Text("%.1f guest MIPS", hud.guest_mips);
+
+    // Session hitch histogram - what kind of slow frame this title produces.
+    const HitchHistogram hitches = hitch_histogram_snapshot();
+    if (hitches.slow_frames > 0) {
+        ImGui::Text("%llu hitches / %llu frames",
+            static_cast<unsigned long long>(hitches.slow_frames),
+            static_cast<unsigned long long>(hitches.frames));
+        for (int stage = 0; stage < HitchStageCount; ++stage) {
+            if (hitches.counts[stage] > 0) {
+                ImGui::Text("  %s %llu", hitch_stage_names[stage],
+                    static_cast<unsigned long long>(hitches.counts[stage]));
+            }
+        }
+    }
+
+    const Ptr<SceGxmContext> context = host.gxm.context;
+    if (context) {
+        const TextureCacheStatistics &stats = context.get(host.mem)->renderer.texture_cache.statistics;
+        ImGui::Text("tex cache %.1f%% hit",
+            (stats.lookups > 0) ? (100.0 * stats.hits / stats.lookups) : 0.0);
+    }
+
+    uint64_t underruns = 0;
+    {
+        const std::shared_lock<std::shared_mutex> lock(host.audio.shared.mutex);
+        for (const AudioOutPortPtr &port : host.audio.shared.out_ports) {
+            if (port) {
+                underruns += port->stats.underruns;
+            }
+        }
+    }
+    ImGui::Text("%llu audio underruns", static_cast<unsigned long long>(underruns));
+
+    ImGui::End();
+}
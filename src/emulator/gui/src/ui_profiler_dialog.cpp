@@ -0,0 +1,58 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <gui/functions.h>
+#include <imgui.h>
+
+#include <host/state.h>
+#include <kernel/profiler.h>
+
+static constexpr size_t MAX_HOT_FUNCTIONS = 32;
+
+void DrawProfilerDialog(HostState &host) {
+    SamplingProfiler &profiler = host.kernel.profiler;
+
+    ImGui::Begin("Profiler", &host.gui.profiler_dialog);
+
+    if (profiler.running) {
+        if (ImGui::Button("Stop")) {
+            stop_sampling_profiler(host.kernel);
+        }
+    } else {
+        if (ImGui::Button("Start")) {
+            start_sampling_profiler(host.kernel);
+        }
+    }
+    ImGui::SameLine();
+    ImGui::Text("%llu samples", static_cast<unsigned long long>(profiler.total_samples));
+    ImGui::Separator();
+
+    ImGui::TextColored(ImVec4(255, 255, 0, 255), "%-16s %-48s %-12s %-8s", "Address", "Function", "Samples", "%%");
+
+    const std::vector<ProfilerHotFunction> report = profiler_hot_functions(host.kernel, MAX_HOT_FUNCTIONS);
+    const uint64_t total = profiler.total_samples;
+    for (const ProfilerHotFunction &function : report) {
+        const double percent = (total != 0) ? (100.0 * function.samples / total) : 0.0;
+        ImGui::Text("0x%08X       %-48s %-12llu %6.2f",
+            function.address,
+            function.name.c_str(),
+            static_cast<unsigned long long>(function.samples),
+            percent);
+    }
+
+    ImGui::End();
+}
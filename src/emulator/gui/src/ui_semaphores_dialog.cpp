@@ -19,24 +19,21 @@
 #include <imgui.h>
 
 #include <host/state.h>
-#include <kernel/thread/thread_functions.h>
-#include <kernel/thread/thread_state.h>
-#include <util/resource.h>
 
 void DrawSemaphoresDialog(HostState &host) {
     ImGui::Begin("Semaphores", &host.gui.semaphores_dialog);
     ImGui::TextColored(ImVec4(255, 255, 0, 255), "%-16s %-32s   %-16s   %-16s", "ID", "Semaphore Name", "Status", "Locked Threads");
 
-    const std::lock_guard<std::mutex> lock(host.kernel.mutex);
+    // Rendered from the published snapshot - no kernel lock held here.
+    const KernelDebugSnapshot &snapshot = host.gui.kernel_snapshots[host.gui.kernel_snapshot_front];
 
-    for (auto semaphore : host.kernel.semaphores) {
-        std::shared_ptr<Semaphore> sema_state = semaphore.second;
+    for (const SemaphoreSnapshotRow &semaphore : snapshot.semaphores) {
         ImGui::Text("0x%08X       %-32s   %02d/%02d              %02zu",
-            semaphore.first,
-            sema_state->name,
-            sema_state->val,
-            sema_state->max,
-            sema_state->waiting_threads.size());
+            semaphore.id,
+            semaphore.name.c_str(),
+            semaphore.val,
+            semaphore.max,
+            semaphore.waiters);
     }
     ImGui::End();
 }
@@ -0,0 +1,96 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <gui/functions.h>
+#include <imgui.h>
+
+#include <host/state.h>
+
+#include <algorithm>
+#include <vector>
+
+static constexpr size_t MAX_ROWS = 32;
+
+struct SyncStatsRow {
+    SceUID uid;
+    const char *kind;
+    std::string name;
+    SyncStats stats;
+    size_t waiting_now;
+};
+
+template <typename Table>
+static void gather_rows(std::vector<SyncStatsRow> &rows, const Table &table, const char *kind) {
+    for (const auto &entry : table) {
+        SyncStatsRow row;
+        row.uid = entry.first;
+        row.kind = kind;
+        row.name = entry.second->name;
+        row.stats = entry.second->stats;
+        row.waiting_now = entry.second->waiting_threads.size();
+        rows.push_back(row);
+    }
+}
+
+void DrawSyncStatsDialog(HostState &host) {
+    ImGui::Begin("Sync Contention", &host.gui.sync_stats_dialog);
+
+    static int sort_key = 0;
+    ImGui::Combo("Sort by", &sort_key, "Contentions\0Total Hold\0Max Hold\0Acquisitions\0Max Waiters\0");
+    ImGui::Separator();
+
+    std::vector<SyncStatsRow> rows;
+    {
+        const std::shared_lock<std::shared_mutex> lock(host.kernel.mutex);
+        gather_rows(rows, host.kernel.mutexes, "Mutex");
+        gather_rows(rows, host.kernel.lwmutexes, "LwMutex");
+        gather_rows(rows, host.kernel.semaphores, "Semaphore");
+        gather_rows(rows, host.kernel.condvars, "Condvar");
+        gather_rows(rows, host.kernel.lwcondvars, "LwCondvar");
+        gather_rows(rows, host.kernel.eventflags, "EventFlag");
+    }
+
+    std::sort(rows.begin(), rows.end(), [](const SyncStatsRow &a, const SyncStatsRow &b) {
+        switch (sort_key) {
+        case 1: return a.stats.total_hold_us > b.stats.total_hold_us;
+        case 2: return a.stats.max_hold_us > b.stats.max_hold_us;
+        case 3: return a.stats.acquisitions > b.stats.acquisitions;
+        case 4: return a.stats.max_waiters > b.stats.max_waiters;
+        default: return a.stats.contentions > b.stats.contentions;
+        }
+    });
+
+    ImGui::TextColored(ImVec4(255, 255, 0, 255), "%-16s %-10s %-24s %-11s %-11s %-14s %-12s %-12s %-8s",
+        "ID", "Kind", "Name", "Acquired", "Contended", "Hold Total us", "Hold Max us", "Max Waiters", "Waiting");
+
+    const size_t count = std::min(rows.size(), MAX_ROWS);
+    for (size_t i = 0; i < count; ++i) {
+        const SyncStatsRow &row = rows[i];
+        ImGui::Text("0x%08X       %-10s %-24s %-11llu %-11llu %-14llu %-12llu %-12zu %zu",
+            row.uid,
+            row.kind,
+            row.name.c_str(),
+            static_cast<unsigned long long>(row.stats.acquisitions),
+            static_cast<unsigned long long>(row.stats.contentions),
+            static_cast<unsigned long long>(row.stats.total_hold_us),
+            static_cast<unsigned long long>(row.stats.max_hold_us),
+            row.stats.max_waiters,
+            row.waiting_now);
+    }
+
+    ImGui::End();
+}
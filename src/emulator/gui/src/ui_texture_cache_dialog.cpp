@@ -0,0 +1,54 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <gui/functions.h>
+#include <imgui.h>
+
+#include <gxm/types.h>
+#include <host/state.h>
+
+void DrawTextureCacheDialog(HostState &host) {
+    ImGui::Begin("Texture Cache", &host.gui.texture_cache_dialog);
+
+    const Ptr<SceGxmContext> context = host.gxm.context;
+    if (!context) {
+        ImGui::Text("No GXM context.");
+        ImGui::End();
+        return;
+    }
+
+    // Counters are written on the render thread; reads here are racy but
+    // only feed this display.
+    const TextureCacheState &cache = context.get(host.mem)->renderer.texture_cache;
+    const TextureCacheStatistics &stats = cache.statistics;
+    const uint64_t misses = stats.lookups - stats.hits;
+
+    ImGui::Text("Entries         %zu/%zu", cache.used, TextureCacheSize);
+    ImGui::Text("Lookups         %llu", static_cast<unsigned long long>(stats.lookups));
+    ImGui::Text("Hits            %llu (%.1f%%)", static_cast<unsigned long long>(stats.hits),
+        (stats.lookups > 0) ? (100.0 * stats.hits / stats.lookups) : 0.0);
+    ImGui::Text("Misses          %llu", static_cast<unsigned long long>(misses));
+    ImGui::Text("Re-hashes       %llu", static_cast<unsigned long long>(stats.rehashes));
+    ImGui::Text("Uploads         %llu", static_cast<unsigned long long>(stats.uploads));
+    ImGui::Text("Evictions       %llu", static_cast<unsigned long long>(stats.evictions));
+    ImGui::Text("Bytes hashed    %.1f MB", stats.bytes_hashed / (1024.0 * 1024.0));
+    ImGui::Text("Bytes uploaded  %.1f MB", stats.bytes_uploaded / (1024.0 * 1024.0));
+    ImGui::Text("Scene budget    %.1f/%.1f MB", cache.upload_bytes_this_scene / (1024.0 * 1024.0),
+        cache.upload_budget_per_scene / (1024.0 * 1024.0));
+
+    ImGui::End();
+}
@@ -19,35 +19,20 @@
 #include <imgui.h>
 
 #include <host/state.h>
-#include <kernel/thread/thread_functions.h>
-#include <kernel/thread/thread_state.h>
-#include <util/resource.h>
 
 void DrawThreadsDialog(HostState &host) {
     ImGui::Begin("Threads", &host.gui.threads_dialog);
     ImGui::TextColored(ImVec4(255, 255, 0, 255), "%-16s %-32s   %-16s   %-16s", "ID", "Thread Name", "Status", "Stack Pointer");
 
-    const std::lock_guard<std::mutex> lock(host.kernel.mutex);
+    // Rendered from the published snapshot - no kernel lock held here.
+    const KernelDebugSnapshot &snapshot = host.gui.kernel_snapshots[host.gui.kernel_snapshot_front];
 
-    for (auto thread : host.kernel.threads) {
-        std::shared_ptr<ThreadState> th_state = thread.second;
-        std::string run_state;
-        switch (th_state->to_do) {
-        case ThreadToDo::run:
-            run_state = "Running";
-            break;
-        case ThreadToDo::wait:
-            run_state = "Waiting";
-            break;
-        case ThreadToDo::exit:
-            run_state = "Exiting";
-            break;
-        }
+    for (const ThreadSnapshotRow &thread : snapshot.threads) {
         ImGui::Text("0x%08X       %-32s   %-16s   0x%08X       ",
-            thread.first,
-            th_state->name.c_str(),
-            run_state.c_str(),
-            th_state->stack.get()->get());
+            thread.id,
+            thread.name.c_str(),
+            thread.state,
+            thread.stack);
     }
     ImGui::End();
 }
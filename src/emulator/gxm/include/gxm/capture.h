@@ -0,0 +1,74 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+// GXM command-stream capture. Records the sequence of SceGxm entry points a
+// title issues, together with the guest memory each one references, as a
+// self-contained binary stream - a bisectable repro artifact for rendering
+// bugs and the input format for the standalone replay tool.
+//
+// File layout: a GxmCaptureHeader, then records back to back. Each record is
+// a GxmCaptureRecordHeader, args_size bytes of the call's scalar arguments,
+// then range_count times { u32 guest address, u32 size, size bytes }.
+
+enum class GxmCaptureOp : uint16_t {
+    begin_scene = 1, // args: u32 flags, SceGxmColorSurface, SceGxmDepthStencilSurface
+    end_scene = 2, // args: none
+    draw = 3, // args: u32 primType, u32 indexType, u32 indexData, u32 indexCount; range 0: index data
+    set_vertex_program = 4, // args: u32 guest address of the program
+    set_fragment_program = 5, // args: u32 guest address of the program
+    set_fragment_texture = 6, // args: u32 textureIndex, SceGxmTexture
+    reserve_vertex_uniform = 7, // args: u32 guest address, u32 size
+    reserve_fragment_uniform = 8, // args: u32 guest address, u32 size
+};
+
+struct GxmCaptureHeader {
+    uint32_t magic = 0x43473356; // 'V3GC'
+    uint32_t version = 1;
+};
+
+struct GxmCaptureRecordHeader {
+    uint16_t op;
+    uint16_t range_count;
+    uint32_t args_size;
+};
+
+// A guest memory range referenced by a captured call. host_data points at
+// the mapped bytes to copy into the stream.
+struct GxmCaptureRange {
+    uint32_t address;
+    uint32_t size;
+    const void *host_data;
+};
+
+struct GxmCaptureState {
+    std::mutex mutex;
+    std::ofstream file;
+    bool enabled = false; // checked unlocked on the hot path; written under mutex
+    uint64_t commands = 0;
+    uint64_t bytes = 0;
+};
+
+bool gxm_capture_begin(GxmCaptureState &capture, const std::string &path);
+void gxm_capture_end(GxmCaptureState &capture);
+void gxm_capture_command(GxmCaptureState &capture, GxmCaptureOp op, const void *args, uint32_t args_size, const GxmCaptureRange *ranges, uint32_t range_count);
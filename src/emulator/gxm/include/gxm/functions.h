@@ -4,6 +4,7 @@
 
 #include <psp2/gxm.h>
 
+#include <functional>
 #include <map>
 #include <memory>
 
@@ -15,20 +16,44 @@ namespace emu {
 }
 
 struct FragmentProgramCacheKey;
+struct GxmState;
 struct GxmViewport;
+struct RenderThread;
+struct ShaderCompiler;
+struct ShadersDB;
 typedef std::shared_ptr<GLObject> SharedGLObject;
 typedef std::map<GLuint, std::string> AttributeLocations;
+typedef std::function<void()> RenderCommand;
 
-void set_viewport(const GxmViewport &viewport, GLsizei display_w, GLsizei display_h);
-std::string get_fragment_glsl(SceGxmShaderPatcher &shader_patcher, const SceGxmProgram &fragment_program, const char *base_path);
-std::string get_vertex_glsl(SceGxmShaderPatcher &shader_patcher, const SceGxmProgram &vertex_program, const char *base_path);
+void set_viewport(const GxmViewport &viewport, GLsizei display_w, GLsizei display_h, uint32_t multiplier);
+std::string get_fragment_glsl(SceGxmShaderPatcher &shader_patcher, const ShadersDB &shaders_db, const SceGxmProgram &fragment_program, const char *base_path);
+std::string get_vertex_glsl(SceGxmShaderPatcher &shader_patcher, const ShadersDB &shaders_db, const SceGxmProgram &vertex_program, const char *base_path);
 AttributeLocations attribute_locations(const SceGxmProgram &vertex_program);
-SharedGLObject get_program(SceGxmContext &context, const MemState &mem);
+struct GxmDrawStateSnapshot;
+SharedGLObject get_program(SceGxmContext &context, const GxmDrawStateSnapshot &state, const MemState &mem, GxmState &gxm, const char *pref_path);
+void shader_compiler_run(ShaderCompiler &compiler);
+// Queues binary-only restore jobs for every program pair in the title's
+// prewarm manifest, so the compiler thread warms the cache during boot.
+void prewarm_shader_programs(SceGxmContext &context, GxmState &gxm, const char *base_path, const char *pref_path);
+void render_thread_run(RenderThread &renderer);
+void render_queue(RenderThread &renderer, RenderCommand command);
+void render_sync(RenderThread &renderer);
+void render_stop(RenderThread &renderer);
+void apply_display_pacing(GxmState &gxm);
+struct MappedRegion;
+enum MappedRegionKind : int;
+// Records a sceGxmMapMemory-style region; remapping the same base replaces
+// the old entry.
+void register_mapped_region(GxmState &gxm, Address base, uint32_t size, MappedRegionKind kind, bool writable);
+// Returns false when the base was never mapped.
+bool unregister_mapped_region(GxmState &gxm, Address base);
+// Copies out the region containing address, if any. O(log n) in the number
+// of live mappings.
+bool resolve_mapped_region(const GxmState &gxm, Address address, MappedRegion *region);
 GLenum attribute_format_to_gl_type(SceGxmAttributeFormat format);
 size_t attribute_format_size(SceGxmAttributeFormat format);
 bool attribute_format_normalised(SceGxmAttributeFormat format);
-void set_uniforms(GLuint program, const SceGxmContext &context, const MemState &mem);
-void flip_vertically(uint32_t *pixels, size_t width, size_t height, size_t stride_in_pixels);
+void set_uniforms(GLuint program, SceGxmContext &context, const GxmDrawStateSnapshot &state, const MemState &mem, uint64_t uniform_write_generation);
 GLenum translate_blend_func(SceGxmBlendFunc src);
 GLenum translate_blend_factor(SceGxmBlendFactor src);
 namespace texture {
@@ -38,6 +63,10 @@ namespace texture {
     unsigned int get_height(const SceGxmTexture *texture);
     void palette_texture_to_rgba_4(uint32_t *dst, const uint8_t *src, size_t width, size_t height, const uint32_t *palette);
     void palette_texture_to_rgba_8(uint32_t *dst, const uint8_t *src, size_t width, size_t height, const uint32_t *palette);
+    void yuv420_texture_to_rgba(uint32_t *dst, const uint8_t *y_plane, const uint8_t *u_plane, const uint8_t *v_plane, size_t width, size_t height, size_t uv_step);
+    void yuv422_texture_to_rgba(uint32_t *dst, const uint8_t *src, size_t width, size_t height);
+    void untwiddle(uint8_t *dst, const uint8_t *src, size_t width, size_t height, size_t bytes_per_pixel);
+    void detile(uint8_t *dst, const uint8_t *src, size_t width, size_t height, size_t bytes_per_pixel);
 
     // Texture formats.
     SceGxmTextureFormat get_format(const SceGxmTexture *texture);
@@ -45,11 +74,15 @@ namespace texture {
     const GLenum *translate_swizzle(SceGxmTextureFormat fmt);
     SceGxmTextureBaseFormat get_base_format(SceGxmTextureFormat src);
     bool is_paletted_format(SceGxmTextureFormat src);
+    bool is_yuv_format(SceGxmTextureFormat src);
+    bool is_compressed_format(SceGxmTextureFormat src);
     GLenum translate_internal_format(SceGxmTextureFormat src);
     GLenum translate_format(SceGxmTextureFormat src);
+    GLenum translate_compressed_internal_format(SceGxmTextureFormat src);
+    size_t compressed_data_size(SceGxmTextureFormat src, size_t width, size_t height);
 }
 GLenum translate_primitive(SceGxmPrimitiveType primType);
 GLenum translate_stencil_func(SceGxmStencilFunc stencil_func);
 GLenum translate_depth_func(SceGxmDepthFunc depth_func);
 GLenum translate_stencil_op(SceGxmStencilOp stencil_op);
-bool operator<(const FragmentProgramCacheKey &a, const FragmentProgramCacheKey &b);
+bool operator==(const FragmentProgramCacheKey &a, const FragmentProgramCacheKey &b);
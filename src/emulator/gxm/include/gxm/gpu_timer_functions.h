@@ -0,0 +1,14 @@
+#pragma once
+
+#include <gxm/gpu_timer_state.h>
+
+extern const char *const gpu_timer_stage_names[GpuTimerStageCount];
+
+bool init(GpuTimerState &timer);
+void gpu_timer_begin(GpuTimerState &timer, GpuTimerStage stage);
+void gpu_timer_end(GpuTimerState &timer, GpuTimerStage stage);
+
+// Harvests finished queries, rolls the per-stage frame totals into the
+// rolling averages and emits the periodic telemetry line. Call once per
+// frame on the thread owning the queries.
+void gpu_timer_end_frame(GpuTimerState &timer);
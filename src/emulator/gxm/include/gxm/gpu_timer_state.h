@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glutil/object_array.h>
+
+#include <array>
+
+// GL_TIME_ELAPSED instrumentation around the major renderer stages, so a
+// slow frame can be attributed to uniform/texture upload, vertex upload,
+// draw execution or the present instead of guessed at.
+enum GpuTimerStage {
+    GPU_TIMER_STAGE_TEXTURE_UPLOAD,
+    GPU_TIMER_STAGE_VERTEX_UPLOAD,
+    GPU_TIMER_STAGE_DRAW,
+    GPU_TIMER_STAGE_PRESENT,
+};
+
+constexpr size_t GpuTimerStageCount = 4;
+constexpr size_t GpuTimerQueriesPerStage = 64;
+constexpr uint64_t GpuTimerReportInterval = 600; // frames between log lines
+
+// Written on the thread issuing the GL work and read racily by the GUI;
+// approximate values are fine there.
+struct GpuTimerStageTimings {
+    uint64_t frame_ns = 0; // harvested since the last frame boundary
+    uint64_t last_frame_ns = 0;
+    uint64_t average_frame_ns = 0; // rolling average across recent frames
+    uint64_t report_ns = 0; // accumulated towards the next log line
+    uint64_t dropped = 0; // regions skipped because the query ring was full
+};
+
+// Each stage owns a ring of query objects: a region begins on the next free
+// query and results are collected at frame boundaries, a frame or two after
+// issue, without ever waiting on the driver. GL_TIME_ELAPSED queries cannot
+// nest, so the instrumented regions must not overlap.
+struct GpuTimerStageState {
+    GLObjectArray<GpuTimerQueriesPerStage> queries;
+    std::array<bool, GpuTimerQueriesPerStage> pending = {};
+    size_t next = 0;
+    bool active = false;
+    GpuTimerStageTimings timings;
+};
+
+struct GpuTimerState {
+    std::array<GpuTimerStageState, GpuTimerStageCount> stages;
+    uint64_t frames = 0;
+    uint64_t last_report_frame = 0;
+};
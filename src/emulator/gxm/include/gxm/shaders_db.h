@@ -0,0 +1,48 @@
+#pragma once
+
+#include <util/mapped_file.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// Packed shaders-db container. The per-hash GLSL files under shaders/ are
+// packed into a single shaders.db file with a fixed-size name -> offset
+// table, so booting does one read instead of an open/read/close per shader.
+// The directory stays the source of truth: a name that is missing from the
+// pack falls back to the loose file, and deleting shaders.db rebuilds it on
+// the next boot.
+//
+// The pack is served from a read-only shared mapping rather than a private
+// copy, so emulator instances running the same build share one physical
+// copy of the GLSL blob.
+
+struct ShadersDBHeader {
+    uint32_t magic; // "VSDB"
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(ShadersDBHeader) == 16, "Incorrect size.");
+
+struct ShadersDBEntry {
+    char name[72]; // "<sha256 hex>.<ext>", NUL padded
+    uint32_t offset; // from the start of the blob, after the entry table
+    uint32_t size;
+};
+
+static_assert(sizeof(ShadersDBEntry) == 80, "Incorrect size.");
+
+typedef std::unordered_map<std::string, std::pair<uint32_t, uint32_t>> ShadersDBIndex;
+
+struct ShadersDB {
+    MappedFile file;
+    uint64_t blob_offset = 0; // header and entry table precede the blob
+    ShadersDBIndex index;
+};
+
+bool load_shaders_db(ShadersDB &db, const char *base_path);
+bool build_shaders_db(const char *base_path);
+std::string find_shader(const ShadersDB &db, const char *name);
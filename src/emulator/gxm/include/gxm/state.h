@@ -1,7 +1,15 @@
 #pragma once
 
+#include <gxm/capture.h>
+#include <gxm/shaders_db.h>
 #include <mem/ptr.h>
 #include <threads/queue.h>
+#include <util/prewarm.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
 
 namespace emu {
     typedef void SceGxmDisplayQueueCallback(Ptr<const void> callbackData);
@@ -15,6 +23,8 @@ namespace emu {
     };
 }
 
+struct SceGxmContext;
+
 struct DisplayCallback {
     Address pc;
     Address data;
@@ -22,9 +32,93 @@ struct DisplayCallback {
     Address new_buffer;
 };
 
+enum DisplayQueuePacing {
+    DISPLAY_PACING_STRICT, // block once the title's requested pending count is reached
+    DISPLAY_PACING_TRIPLE, // allow one extra pending frame for more overlap
+    DISPLAY_PACING_UNLOCKED, // never block the guest on presentation
+};
+
+static constexpr size_t DisplayQueuePacingCount = 3;
+
+struct DisplayQueueStatistics {
+    uint64_t frames = 0;
+    uint64_t frame_time_total_us = 0;
+    uint64_t frame_time_min_us = 0;
+    uint64_t frame_time_max_us = 0;
+};
+
+// Guest memory the title handed to the GPU. The USSE variants are recorded
+// with their own kinds so address classification can tell shader code
+// mappings from ordinary data.
+enum MappedRegionKind : int {
+    MAPPED_REGION_GENERIC,
+    MAPPED_REGION_VERTEX_USSE,
+    MAPPED_REGION_FRAGMENT_USSE,
+};
+
+struct MappedRegion {
+    Address base = 0;
+    uint32_t size = 0;
+    MappedRegionKind kind = MAPPED_REGION_GENERIC;
+    bool writable = false;
+};
+
+// Regions keyed by base address. Resolution finds the predecessor of the
+// query and range-checks it, so the per-draw paths (texture cache, vertex
+// upload, surface tracking) get O(log n) address-to-region answers.
+struct MappedRegionRegistry {
+    mutable std::mutex mutex;
+    std::map<Address, MappedRegion> regions;
+};
+
 struct GxmState {
     emu::SceGxmInitializeParams params;
     bool isInScene = false;
-    Queue<DisplayCallback> display_queue;
+    SpscQueue<DisplayCallback> display_queue;
+    DisplayQueuePacing pacing = DISPLAY_PACING_STRICT;
+
+    // Scenes render at guest dimensions times this into the FBO, and are
+    // downsampled to guest size by the end-of-scene blit. Picked up at the
+    // next scene begin, which respecifies the render target storage.
+    uint32_t resolution_multiplier = 1;
+
+    // Per-scene texture upload budget from the title profile, in bytes;
+    // applied to the texture cache when the render context is created.
+    // Zero keeps the built-in default.
+    uint64_t texture_upload_budget = 0;
+
+    // Interval between display queue entries - the guest's present cadence -
+    // collected separately for each pacing mode so they can be compared.
+    DisplayQueueStatistics display_statistics[DisplayQueuePacingCount];
+    std::chrono::steady_clock::time_point last_display_entry;
     Ptr<uint32_t> notification_region;
+    // Completion paths write the guest notification word under the mutex and
+    // notify, so sceGxmNotificationWait sleeps on the condvar instead of
+    // burning a core polling guest memory. One condvar serves the whole
+    // region - notifications are rare enough that spurious wakes of waiters
+    // on other words cost nothing.
+    std::mutex notification_mutex;
+    std::condition_variable notification_cv;
+    ShadersDB shaders_db;
+
+    // Program pairs this title has asked for, as "<vs hash> <fs hash>"
+    // lines. sceGxmCreateContext replays the previous session's entries
+    // through the compiler thread, restoring the driver binaries before the
+    // first draw needs them.
+    PrewarmLog prewarm;
+
+    // Bumped by sceGxmSetUniformDataF, which only sees the buffer pointer
+    // and so cannot reach a per-context counter.
+    uint64_t uniform_write_generation = 1;
+
+    // Cumulative sceGxmDraw calls; the performance HUD diffs it per frame.
+    uint64_t draw_count = 0;
+
+    // The render context the title created, so host-side debug views (e.g.
+    // the texture cache dialog) can reach per-context renderer state.
+    Ptr<SceGxmContext> context;
+
+    MappedRegionRegistry mappings;
+
+    GxmCaptureState capture;
 };
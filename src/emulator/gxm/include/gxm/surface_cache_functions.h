@@ -0,0 +1,12 @@
+#pragma once
+
+#include <glutil/object.h>
+
+#include <mem/mem.h>
+
+#include <cstdint>
+
+struct SurfaceCacheState;
+
+SharedGLObject get_surface_texture(SurfaceCacheState &cache, Address address, uint32_t width, uint32_t height, uint32_t multiplier);
+SharedGLObject find_surface_texture(const SurfaceCacheState &cache, Address address, uint32_t width, uint32_t height);
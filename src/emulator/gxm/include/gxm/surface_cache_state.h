@@ -0,0 +1,26 @@
+#pragma once
+
+#include <glutil/object.h>
+
+#include <mem/mem.h>
+
+#include <cstdint>
+#include <map>
+
+// A colour surface that has been rendered to, living on the GPU as the
+// texture backing its framebuffer attachment.
+struct SurfaceCacheEntry {
+    SharedGLObject texture;
+    uint32_t width = 0; // guest dimensions; storage is scaled by multiplier
+    uint32_t height = 0;
+    uint32_t multiplier = 1;
+};
+
+typedef std::map<Address, SurfaceCacheEntry> SurfaceCache;
+
+// Rendered colour surfaces, keyed by their guest data address. A later
+// scene that samples one of these addresses binds the texture directly
+// instead of hashing and re-uploading the read-back pixels.
+struct SurfaceCacheState {
+    SurfaceCache surfaces;
+};
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <glutil/gl.h>
+
 struct MemState;
 struct SceGxmTexture;
 struct TextureCacheState;
 
 bool init(TextureCacheState &cache);
-void cache_and_bind_texture(TextureCacheState &cache, const SceGxmTexture &gxm_texture, const MemState &mem, bool enabled);
+
+// bound_texture is the GL texture the caller believes is bound to the active
+// unit (0 for unknown); the bind is skipped when it already matches and
+// nothing needs configuring or uploading. Returns the texture now bound.
+GLuint cache_and_bind_texture(TextureCacheState &cache, const SceGxmTexture &gxm_texture, MemState &mem, bool enabled, GLuint bound_texture);
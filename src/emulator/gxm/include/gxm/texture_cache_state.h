@@ -3,22 +3,68 @@
 #include <glutil/object_array.h>
 
 #include <array>
+#include <list>
+#include <unordered_map>
 
 struct SceGxmTexture;
 
 constexpr size_t TextureCacheSize = 1024;
+constexpr size_t TextureUploadRingSize = 4;
+constexpr size_t TextureUploadBudgetPerScene = 8 * 1024 * 1024;
 typedef uint64_t TextureCacheTimestamp;
-typedef uint32_t TextureCacheHash;
+typedef uint64_t TextureCacheHash;
 
 typedef std::array<SceGxmTexture, TextureCacheSize> TextureCacheGxmTextures;
-typedef std::array<TextureCacheTimestamp, TextureCacheSize> TextureCacheTimestamps;
 typedef std::array<TextureCacheHash, TextureCacheSize> TextureCacheHashes;
+typedef std::array<uint64_t, TextureCacheSize> TextureCacheGenerations;
+typedef std::unordered_map<uint64_t, size_t> TextureCacheIndex; // control-word hash -> slot
+typedef std::list<size_t> TextureCacheLRU; // most recently used at the front
+typedef std::array<TextureCacheLRU::iterator, TextureCacheSize> TextureCacheLRUPositions;
+typedef std::array<uint8_t, TextureCacheSize> TextureCacheMipLevels;
+
+// Telemetry for tuning cache behaviour. Written on the thread doing the
+// binds and read racily by the GUI; approximate values are fine there.
+struct TextureCacheStatistics {
+    uint64_t lookups = 0;
+    uint64_t hits = 0; // binds served without configure or upload
+    uint64_t rehashes = 0;
+    uint64_t uploads = 0;
+    uint64_t evictions = 0;
+    uint64_t bytes_hashed = 0;
+    uint64_t bytes_uploaded = 0;
+    TextureCacheTimestamp last_report_timestamp = 0;
+};
 
 struct TextureCacheState {
     size_t used = 0;
     TextureCacheTimestamp timestamp = 1;
     TextureCacheGxmTextures gxm_textures;
-    TextureCacheTimestamps timestamps;
     TextureCacheHashes hashes;
+
+    // Memory write generation each entry was last validated against; a bind
+    // only re-hashes when pages backing the texture were written since.
+    TextureCacheGenerations generations;
+
+    // O(1) lookup by hashed texture control words, and an LRU list (with a
+    // per-slot position so a touch is a splice) for eviction.
+    TextureCacheIndex index;
+    TextureCacheLRU lru;
+    TextureCacheLRUPositions lru_positions;
+
     GLObjectArray<TextureCacheSize> textures;
+
+    // Pixel-buffer ring uploads stage through; the driver transfers out of
+    // the orphaned buffer asynchronously instead of copying inline.
+    GLObjectArray<TextureUploadRingSize> upload_buffers;
+    size_t upload_buffer_index = 0;
+
+    // Mip levels resident per entry, and a per-scene byte budget so a burst
+    // of arrivals streams over several frames instead of hitching one. The
+    // budget starts at the default and can be overridden by a title profile.
+    TextureCacheMipLevels mip_levels;
+    uint64_t upload_budget_per_scene = TextureUploadBudgetPerScene;
+    uint64_t upload_bytes_this_scene = 0;
+    TextureCacheTimestamp upload_budget_timestamp = 0;
+
+    TextureCacheStatistics statistics;
 };
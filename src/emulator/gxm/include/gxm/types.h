@@ -1,5 +1,7 @@
 #pragma once
 
+#include "gpu_timer_state.h"
+#include "surface_cache_state.h"
 #include "texture_cache_state.h"
 
 #include <crypto/hash.h>
@@ -13,9 +15,14 @@
 
 #include <array>
 #include <condition_variable>
+#include <deque>
+#include <functional>
 #include <map>
 #include <mutex>
+#include <set>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
 
 namespace emu {
     struct SceGxmBlendInfo {
@@ -52,9 +59,28 @@ namespace emu {
     };
 }
 
+struct SceGxmProgram;
+
 typedef std::unique_ptr<void, std::function<void(SDL_GLContext)>> GLContextPtr;
 typedef std::tuple<std::string, std::string> ProgramGLSLs;
 typedef std::map<ProgramGLSLs, SharedGLObject> ProgramCache;
+typedef std::map<std::pair<GLuint, const SceGxmProgram *>, std::vector<GLint>> UniformLocationCache;
+typedef std::map<size_t, SharedGLObject> VertexArrayCache;
+
+// One guest index buffer mirrored in a GL buffer, with the index range it
+// references so a hit skips the per-draw minmax scan as well as the upload.
+// The range bounds the vertex window each stream actually needs - titles
+// bind multi-megabyte streams for draws touching a few hundred vertices.
+// write_generation is the tracking snapshot taken at upload time.
+struct IndexBufferCacheEntry {
+    SharedGLObject buffer;
+    size_t size = 0; // bytes resident, also distinguishes draw ranges
+    size_t min_index = 0;
+    size_t max_index = 0;
+    uint64_t write_generation = 0;
+};
+
+typedef std::map<Address, IndexBufferCacheEntry> IndexBufferCache;
 typedef std::array<Ptr<void>, 16> UniformBuffers;
 
 struct GxmViewport {
@@ -94,9 +120,12 @@ struct GxmContextState {
     Ptr<const SceGxmFragmentProgram> fragment_program;
     Ptr<const SceGxmVertexProgram> vertex_program;
 
-    // Uniforms.
+    // Uniforms. The generations are bumped whenever a buffer slot is
+    // rebound, so unchanged uniform state can be skipped across draws.
     UniformBuffers fragment_uniform_buffers;
     UniformBuffers vertex_uniform_buffers;
+    uint64_t fragment_uniform_generation = 1;
+    uint64_t vertex_uniform_generation = 1;
     size_t fragment_ring_buffer_used = 0;
     size_t vertex_ring_buffer_used = 0;
 
@@ -115,13 +144,185 @@ struct GxmContextState {
     std::array<SceGxmTexture, SCE_GXM_MAX_TEXTURE_UNITS> fragment_textures;
 };
 
+// The context state a deferred draw dereferences, copied by value when the
+// draw is recorded. The setters mutate GxmContextState immediately on the
+// guest thread, so a queued draw reading it at replay time would race and
+// could pick up programs or streams bound for a *later* draw - the same
+// reason sceGxmSetFragmentTexture copies its control words.
+struct GxmDrawStateSnapshot {
+    Ptr<const SceGxmFragmentProgram> fragment_program;
+    Ptr<const SceGxmVertexProgram> vertex_program;
+    UniformBuffers fragment_uniform_buffers;
+    UniformBuffers vertex_uniform_buffers;
+    uint64_t fragment_uniform_generation = 0;
+    uint64_t vertex_uniform_generation = 0;
+    std::array<Ptr<const void>, SCE_GXM_MAX_VERTEX_STREAMS> stream_data;
+};
+
+typedef std::map<GLuint, std::string> AttributeLocations;
+
+// Everything a program link needs, copied up front so the worker never
+// touches guest memory.
+struct ShaderCompileJob {
+    ProgramGLSLs glsls;
+    AttributeLocations attribute_locations;
+    std::string binary_path;
+    std::string pref_path;
+    // Prewarm jobs only restore the saved driver binary; they carry no
+    // attribute locations, so falling back to a source compile would link a
+    // program with the wrong bindings.
+    bool binary_only = false;
+};
+
+// Worker thread that links shader programs off the render thread. Its GL
+// context shares objects with the render context, so finished programs can
+// be used there directly.
+struct ShaderCompiler {
+    GLContextPtr gl;
+    std::thread worker;
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::deque<ShaderCompileJob> queue;
+    std::set<ProgramGLSLs> in_flight;
+    std::vector<std::pair<ProgramGLSLs, SharedGLObject>> finished;
+    bool stop = false;
+
+    ~ShaderCompiler() {
+        if (worker.joinable()) {
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            work_available.notify_one();
+            worker.join();
+        }
+    }
+};
+
+// One recorded piece of GL work. A closure rather than a tagged struct so
+// recording sites stay next to the state handling they defer, at the cost of
+// an allocation per command.
+typedef std::function<void()> RenderCommand;
+
+// Dedicated thread that owns the render GL context and replays recorded
+// commands in submission order. Guest threads never issue GL directly, so
+// CPU emulation overlaps driver work and the context stops migrating across
+// threads. Exports that need a GL result (readbacks, object creation)
+// record the command and then wait with render_sync.
+struct RenderThread {
+    std::thread worker;
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable batch_done;
+    std::deque<RenderCommand> queue;
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    bool stop = false;
+
+    ~RenderThread() {
+        if (worker.joinable()) {
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            work_available.notify_one();
+            worker.join();
+        }
+    }
+};
+
+// The state most recently handed to GL, kept and read only on the render
+// thread. Requested state is compared against it first and no-op GL calls
+// are skipped - in 2D titles most state calls repeat the previous value.
+// Zero object names mean "unknown"; glGen* never returns 0 and nothing here
+// draws with program or VAO 0.
+struct GLShadowState {
+    GLuint program = 0;
+    GLuint vertex_array = 0;
+    std::array<GLuint, SCE_GXM_MAX_TEXTURE_UNITS> textures = {};
+
+    bool blend_valid = false;
+    GLboolean color_mask_red = GL_TRUE;
+    GLboolean color_mask_green = GL_TRUE;
+    GLboolean color_mask_blue = GL_TRUE;
+    GLboolean color_mask_alpha = GL_TRUE;
+    bool blend_enabled = false;
+    GLenum color_func = GL_FUNC_ADD;
+    GLenum alpha_func = GL_FUNC_ADD;
+    GLenum color_src = GL_ONE;
+    GLenum color_dst = GL_ZERO;
+    GLenum alpha_src = GL_ONE;
+    GLenum alpha_dst = GL_ZERO;
+
+    bool depth_func_valid = false;
+    GLenum depth_func = GL_ALWAYS;
+    bool depth_mask_valid = false;
+    GLboolean depth_mask = GL_TRUE;
+
+    bool cull_valid = false;
+    SceGxmCullMode cull_mode = SCE_GXM_CULL_NONE;
+
+    bool viewport_valid = false;
+    GxmViewport viewport;
+    uint32_t viewport_multiplier = 1;
+};
+
 struct RendererContextState {
     GLContextPtr gl;
     ProgramCache program_cache;
     TextureCacheState texture_cache;
+    SurfaceCacheState surface_cache;
     GLObjectArray<1> vertex_array;
-    GLObjectArray<1> element_buffer;
     GLObjectArray<SCE_GXM_MAX_VERTEX_STREAMS> stream_vertex_buffers;
+
+    // Target of the flipped end-of-scene blit. The GPU reorders the rows,
+    // so the readback comes out in guest order without a CPU pass over the
+    // whole frame.
+    GLObjectArray<1> flip_framebuffer;
+    GLObjectArray<1> flip_renderbuffer;
+    uint32_t flip_width = 0;
+    uint32_t flip_height = 0;
+
+    // Current storage size of each stream buffer. Draw uploads only
+    // reallocate storage when they need more, and write through an
+    // invalidating map otherwise.
+    std::array<size_t, SCE_GXM_MAX_VERTEX_STREAMS> stream_vertex_buffer_sizes = {};
+    ShaderCompiler shader_compiler;
+    RenderThread render_thread;
+    GLShadowState shadow;
+    GpuTimerState gpu_timer;
+
+    // Most-recently-used program pair. Consecutive draws overwhelmingly
+    // reuse the previous (vertex, fragment) pair, so comparing the two
+    // guest pointers skips building the GLSL tuple key and the cache lookup
+    // entirely. Invalidated when either program is released - its guest
+    // address can be handed out again.
+    Ptr<const SceGxmFragmentProgram> last_fragment_program;
+    Ptr<const SceGxmVertexProgram> last_vertex_program;
+    SharedGLObject last_program;
+
+    // Uniform locations per (GL program, GXM program) pair, resolved once so
+    // draws do no glGetUniformLocation string lookups.
+    UniformLocationCache uniform_locations;
+
+    // What the last uniform upload was for; matching generations mean the
+    // guest has not touched uniform state since and the upload is skipped.
+    GLuint last_uniform_program = 0;
+    uint64_t last_fragment_uniform_generation = 0;
+    uint64_t last_vertex_uniform_generation = 0;
+    uint64_t last_uniform_write_generation = 0;
+
+    // One configured VAO per vertex program instance, keyed by renderer_id.
+    // Entries outlive released programs, but ids are never reused so a stale
+    // entry can only waste a VAO, not corrupt a draw.
+    VertexArrayCache vertex_array_cache;
+
+    // Index buffers keyed by guest address. Entries are revalidated against
+    // the page write tracking, so a static mesh drawn every frame keeps its
+    // GL buffer instead of being re-read, re-scanned and re-uploaded.
+    IndexBufferCache index_buffer_cache;
 };
 
 struct SceGxmContext {
@@ -246,6 +447,13 @@ struct SceGxmRegisteredProgram {
 struct SceGxmRenderTarget {
     GLObjectArray<2> renderbuffers;
     GLObjectArray<1> framebuffer;
+
+    // Guest dimensions and the resolution multiplier the renderbuffer
+    // storage was last specified at; scene begin respecifies the storage
+    // when the multiplier setting has changed since.
+    GLsizei width = 0;
+    GLsizei height = 0;
+    uint32_t multiplier = 1;
 };
 
 struct FragmentProgramCacheKey {
@@ -253,7 +461,13 @@ struct FragmentProgramCacheKey {
     emu::SceGxmBlendInfo blend_info;
 };
 
-typedef std::map<FragmentProgramCacheKey, Ptr<SceGxmFragmentProgram>> FragmentProgramCache;
+// Folds the registered program address and the packed blend word - the
+// whole key - so a lookup is a single hash probe.
+struct FragmentProgramCacheKeyHash {
+    size_t operator()(const FragmentProgramCacheKey &key) const;
+};
+
+typedef std::unordered_map<FragmentProgramCacheKey, Ptr<SceGxmFragmentProgram>, FragmentProgramCacheKeyHash> FragmentProgramCache;
 typedef std::map<Sha256Hash, std::string> GLSLCache;
 
 struct SceGxmShaderPatcher {
@@ -261,6 +475,7 @@ struct SceGxmShaderPatcher {
     FragmentProgramCache fragment_program_cache;
     GLSLCache fragment_glsl_cache;
     GLSLCache vertex_glsl_cache;
+    size_t next_vertex_program_id = 1;
 };
 
 namespace emu {
@@ -312,11 +527,10 @@ namespace emu {
     static_assert(sizeof(SceGxmVertexAttribute) == 8, "Structure has been incorrectly packed.");
 }
 
-typedef std::map<GLuint, std::string> AttributeLocations;
-
 struct SceGxmVertexProgram {
     // TODO I think this is an opaque type.
     size_t reference_count = 1;
+    size_t renderer_id = 0; // unique per instance, keys renderer-side caches
 
     Ptr<const SceGxmProgram> program;
     std::string glsl;
@@ -0,0 +1,82 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <gxm/capture.h>
+
+#include <util/log.h>
+
+bool gxm_capture_begin(GxmCaptureState &capture, const std::string &path) {
+    const std::lock_guard<std::mutex> lock(capture.mutex);
+    if (capture.enabled) {
+        return false;
+    }
+
+    capture.file.open(path, std::ofstream::binary | std::ofstream::trunc);
+    if (!capture.file.is_open()) {
+        LOG_ERROR("Could not open GXM capture {} for writing.", path);
+        return false;
+    }
+
+    const GxmCaptureHeader header;
+    capture.file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    capture.commands = 0;
+    capture.bytes = sizeof(header);
+    capture.enabled = true;
+
+    LOG_INFO("GXM capture started: {}.", path);
+    return true;
+}
+
+void gxm_capture_end(GxmCaptureState &capture) {
+    const std::lock_guard<std::mutex> lock(capture.mutex);
+    if (!capture.enabled) {
+        return;
+    }
+
+    capture.enabled = false;
+    capture.file.close();
+    LOG_INFO("GXM capture finished: {} commands, {} bytes.", capture.commands, capture.bytes);
+}
+
+void gxm_capture_command(GxmCaptureState &capture, GxmCaptureOp op, const void *args, uint32_t args_size, const GxmCaptureRange *ranges, uint32_t range_count) {
+    const std::lock_guard<std::mutex> lock(capture.mutex);
+    if (!capture.enabled) {
+        return;
+    }
+
+    GxmCaptureRecordHeader record;
+    record.op = static_cast<uint16_t>(op);
+    record.range_count = static_cast<uint16_t>(range_count);
+    record.args_size = args_size;
+    capture.file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    if (args_size > 0) {
+        capture.file.write(reinterpret_cast<const char *>(args), args_size);
+    }
+    capture.bytes += sizeof(record) + args_size;
+
+    for (uint32_t i = 0; i < range_count; ++i) {
+        const GxmCaptureRange &range = ranges[i];
+        capture.file.write(reinterpret_cast<const char *>(&range.address), sizeof(range.address));
+        capture.file.write(reinterpret_cast<const char *>(&range.size), sizeof(range.size));
+        if (range.size > 0) {
+            capture.file.write(reinterpret_cast<const char *>(range.host_data), range.size);
+        }
+        capture.bytes += sizeof(range.address) + sizeof(range.size) + range.size;
+    }
+
+    ++capture.commands;
+}
@@ -0,0 +1,91 @@
+#include <gxm/gpu_timer_functions.h>
+
+#include <util/log.h>
+
+const char *const gpu_timer_stage_names[GpuTimerStageCount] = {
+    "texture_upload",
+    "vertex_upload",
+    "draw",
+    "present",
+};
+
+bool init(GpuTimerState &timer) {
+    for (GpuTimerStageState &stage : timer.stages) {
+        if (!stage.queries.init(&glGenQueries, &glDeleteQueries)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void gpu_timer_begin(GpuTimerState &timer, GpuTimerStage stage) {
+    GpuTimerStageState &state = timer.stages[stage];
+    if (state.pending[state.next]) {
+        // Every query in the ring still has an uncollected result. Skip the
+        // region rather than wait for the driver to catch up.
+        ++state.timings.dropped;
+        return;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, state.queries[state.next]);
+    state.active = true;
+}
+
+void gpu_timer_end(GpuTimerState &timer, GpuTimerStage stage) {
+    GpuTimerStageState &state = timer.stages[stage];
+    if (!state.active) {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    state.active = false;
+    state.pending[state.next] = true;
+    state.next = (state.next + 1) % GpuTimerQueriesPerStage;
+}
+
+void gpu_timer_end_frame(GpuTimerState &timer) {
+    for (GpuTimerStageState &stage : timer.stages) {
+        // Collect whatever finished - results usually land a frame or two
+        // after issue, so the totals lag the work they describe slightly.
+        for (size_t i = 0; i < GpuTimerQueriesPerStage; ++i) {
+            if (!stage.pending[i]) {
+                continue;
+            }
+
+            GLuint available = 0;
+            glGetQueryObjectuiv(stage.queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available == 0) {
+                continue;
+            }
+
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(stage.queries[i], GL_QUERY_RESULT, &elapsed);
+            stage.pending[i] = false;
+            stage.timings.frame_ns += elapsed;
+        }
+
+        GpuTimerStageTimings &timings = stage.timings;
+        timings.last_frame_ns = timings.frame_ns;
+        timings.average_frame_ns = (timings.average_frame_ns * 7 + timings.frame_ns) / 8;
+        timings.report_ns += timings.frame_ns;
+        timings.frame_ns = 0;
+    }
+
+    ++timer.frames;
+    if (timer.frames - timer.last_report_frame >= GpuTimerReportInterval) {
+        const uint64_t frames = timer.frames - timer.last_report_frame;
+        timer.last_report_frame = timer.frames;
+
+        LOG_INFO("gpu_timer f={} texture_upload_ns={} vertex_upload_ns={} draw_ns={} present_ns={}",
+            timer.frames,
+            timer.stages[GPU_TIMER_STAGE_TEXTURE_UPLOAD].timings.report_ns / frames,
+            timer.stages[GPU_TIMER_STAGE_VERTEX_UPLOAD].timings.report_ns / frames,
+            timer.stages[GPU_TIMER_STAGE_DRAW].timings.report_ns / frames,
+            timer.stages[GPU_TIMER_STAGE_PRESENT].timings.report_ns / frames);
+
+        for (GpuTimerStageState &stage : timer.stages) {
+            stage.timings.report_ns = 0;
+        }
+    }
+}
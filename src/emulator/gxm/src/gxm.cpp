@@ -3,21 +3,40 @@
 #include "profile.h"
 
 #include <crypto/hash.h>
+#include <gxm/shaders_db.h>
+#include <gxm/state.h>
 #include <gxm/types.h>
+#include <util/fs.h>
+#include <util/hitch.h>
 #include <util/log.h>
+#include <util/mapped_file.h>
 
 #include <glbinding/AbstractFunction.h>
 #include <glbinding/FunctionCall.h>
 #include <microprofile.h>
 
+#include <SDL_thread.h>
+
 #include <algorithm>
 #include <cstring> // memcmp
 #include <fstream>
+#include <functional> // hash
+#include <limits>
 #include <sstream>
 
-static std::string load_shader(const char *hash, const char *extension, const char *base_path) {
+static std::string load_shader(const ShadersDB &shaders_db, const char *hash, const char *extension, const char *base_path) {
+    std::ostringstream name;
+    name << hash << "." << extension;
+
+    // The packed container covers the common case; loose files remain the
+    // fallback so new shaders can be dropped in during development.
+    std::string packed = find_shader(shaders_db, name.str().c_str());
+    if (!packed.empty()) {
+        return packed;
+    }
+
     std::ostringstream path;
-    path << base_path << "shaders/" << hash << "." << extension;
+    path << base_path << "shaders/" << name.str();
 
     std::ifstream is(path.str());
     if (is.fail()) {
@@ -127,57 +146,73 @@ static const char *vector_prefix(SceGxmParameterType type) {
     return "?";
 }
 
-static void output_sampler_decl(std::ostream &glsl, const SceGxmProgramParameter &parameter) {
-    glsl << "sampler2D " << parameter_name_raw(parameter);
+static void output_sampler_decl(std::string &glsl, const SceGxmProgramParameter &parameter) {
+    glsl += "sampler2D ";
+    glsl += parameter_name_raw(parameter);
 }
 
-static void output_scalar_decl(std::ostream &glsl, const SceGxmProgramParameter &parameter) {
+static void output_scalar_decl(std::string &glsl, const SceGxmProgramParameter &parameter) {
     assert(parameter.component_count == 1);
 
-    glsl << scalar_type(parameter_type(parameter)) << " " << parameter_name(parameter);
+    glsl += scalar_type(parameter_type(parameter));
+    glsl += " ";
+    glsl += parameter_name(parameter);
     if (parameter.array_size > 1) {
-        glsl << "[" << parameter.array_size << "]";
+        glsl += "[";
+        glsl += std::to_string(parameter.array_size);
+        glsl += "]";
     }
 }
 
-static void output_vector_decl(std::ostream &glsl, const SceGxmProgramParameter &parameter) {
+static void output_vector_decl(std::string &glsl, const SceGxmProgramParameter &parameter) {
     assert(parameter.component_count > 1);
     assert(parameter.component_count <= 4);
 
-    const auto vector = vector_prefix(parameter_type(parameter));
-
-    glsl << vector << "vec" << parameter.component_count << " " << parameter_name(parameter);
+    glsl += vector_prefix(parameter_type(parameter));
+    glsl += "vec";
+    glsl += std::to_string(uint16_t(parameter.component_count));
+    glsl += " ";
+    glsl += parameter_name(parameter);
     if (parameter.array_size > 1) {
-        glsl << "[" << parameter.array_size << "]";
+        glsl += "[";
+        glsl += std::to_string(parameter.array_size);
+        glsl += "]";
     }
 }
 
-static void output_matrix_decl(std::ostream &glsl, const SceGxmProgramParameter &parameter) {
+static void output_matrix_decl(std::string &glsl, const SceGxmProgramParameter &parameter) {
     assert(parameter.component_count > 1);
     assert(parameter.array_size >= 2);
     assert(parameter.array_size <= 4);
 
-    glsl << vector_prefix(parameter_type(parameter)) << "mat";
+    glsl += vector_prefix(parameter_type(parameter));
+    glsl += "mat";
     if (parameter.component_count == parameter.array_size) {
-        glsl << parameter.component_count;
+        glsl += std::to_string(uint16_t(parameter.component_count));
     } else {
-        glsl << parameter.component_count << "x" << parameter.array_size;
+        glsl += std::to_string(uint16_t(parameter.component_count));
+        glsl += "x";
+        glsl += std::to_string(parameter.array_size);
     }
-    glsl << " " << parameter_name(parameter);
+    glsl += " ";
+    glsl += parameter_name(parameter);
 }
 
-void output_struct_decl_begin(std::ostream &glsl, const std::string &qualifier) {
-    if (!qualifier.empty())
-        glsl << qualifier << " ";
-    glsl << "struct {\n";
+void output_struct_decl_begin(std::string &glsl, const std::string &qualifier) {
+    if (!qualifier.empty()) {
+        glsl += qualifier;
+        glsl += " ";
+    }
+    glsl += "struct {\n";
 }
 
-void output_struct_decl_end(std::ostream &glsl, const std::string &struct_name) {
-    glsl << "} " << struct_name;
-    glsl << ";\n";
+void output_struct_decl_end(std::string &glsl, const std::string &struct_name) {
+    glsl += "} ";
+    glsl += struct_name;
+    glsl += ";\n";
 }
 
-static void output_glsl_decl(std::ostream &glsl, std::string &cur_struct_decl, const SceGxmProgramParameter &parameter, const std::string &qualifier, bool is_sampler = false) {
+static void output_glsl_decl(std::string &glsl, std::string &cur_struct_decl, const SceGxmProgramParameter &parameter, const std::string &qualifier, bool is_sampler = false) {
     const std::string param_name_raw = parameter_name_raw(parameter);
     const auto struct_idx = param_name_raw.find('.');
     const bool is_struct_field = struct_idx != std::string::npos;
@@ -193,11 +228,13 @@ static void output_glsl_decl(std::ostream &glsl, std::string &cur_struct_decl, c
 
     // Indent if struct field
     if (is_struct_field)
-        glsl << "   ";
+        glsl += "   ";
 
     // No qualifier if struct field. They're only present once in the struct declaration.
-    if (!is_struct_field)
-        glsl << qualifier << " ";
+    if (!is_struct_field) {
+        glsl += qualifier;
+        glsl += " ";
+    }
 
     // TODO: Should be using param type here
     if (is_sampler) {
@@ -213,14 +250,14 @@ static void output_glsl_decl(std::ostream &glsl, std::string &cur_struct_decl, c
         output_scalar_decl(glsl, parameter);
     }
 
-    glsl << ";\n";
+    glsl += ";\n";
 
     cur_struct_decl = struct_name;
 }
 
-static void output_glsl_parameters(std::ostream &glsl, const SceGxmProgram &program) {
+static void output_glsl_parameters(std::string &glsl, const SceGxmProgram &program) {
     if (program.parameter_count > 0) {
-        glsl << "\n";
+        glsl += "\n";
     }
 
     // Keeps track of current struct declaration
@@ -266,56 +303,127 @@ static void output_glsl_parameters(std::ostream &glsl, const SceGxmProgram &prog
     }
 }
 
+// Shared between the generators and reused across calls, so steady-state
+// generation does not reallocate. Generation only happens on the GXM thread.
+static std::string &generation_buffer() {
+    static std::string glsl;
+    glsl.clear();
+    glsl.reserve(8 * 1024);
+
+    return glsl;
+}
+
 static std::string generate_fragment_glsl(const SceGxmProgram &program) {
     GXM_PROFILE(__FUNCTION__);
 
-    std::ostringstream glsl;
-    glsl << "// Fragment shader.\n";
-    glsl << "#version 410\n";
+    std::string &glsl = generation_buffer();
+    glsl += "// Fragment shader.\n";
+    glsl += "#version 410\n";
     output_glsl_parameters(glsl, program);
-    glsl << "\n";
-    glsl << "out vec4 fragColor;\n";
-    glsl << "\n";
-    glsl << "void main() {\n";
-    glsl << "    fragColor = vec4(0, 1, 0, 1);\n";
-    glsl << "}\n";
-
-    return glsl.str();
+    glsl += "\n";
+    glsl += "out vec4 fragColor;\n";
+    glsl += "\n";
+    glsl += "void main() {\n";
+    glsl += "    fragColor = vec4(0, 1, 0, 1);\n";
+    glsl += "}\n";
+
+    return glsl;
 }
 
 static std::string generate_vertex_glsl(const SceGxmProgram &program) {
     GXM_PROFILE(__FUNCTION__);
 
-    std::ostringstream glsl;
-    glsl << "// Vertex shader.\n";
-    glsl << "#version 410\n";
+    std::string &glsl = generation_buffer();
+    glsl += "// Vertex shader.\n";
+    glsl += "#version 410\n";
     output_glsl_parameters(glsl, program);
-    glsl << "\n";
-    glsl << "void main() {\n";
-    glsl << "    gl_Position = vec4(0, 0, 0, 1);\n";
-    glsl << "}\n";
+    glsl += "\n";
+    glsl += "void main() {\n";
+    glsl += "    gl_Position = vec4(0, 0, 0, 1);\n";
+    glsl += "}\n";
+
+    return glsl;
+}
+
+// Missing shaders are dumped by a background writer so a discovery run does
+// not add file I/O stalls on top of the compile stall it is already taking.
+// Queue memory is bounded; dumps past the cap are dropped and will simply be
+// captured on a later run.
+struct DumpJob {
+    std::string path;
+    std::string data;
+};
+
+struct DumpWriter {
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::deque<DumpJob> queue;
+    size_t queued_bytes = 0;
+    bool stop = false;
+    std::thread worker;
+
+    ~DumpWriter() {
+        if (worker.joinable()) {
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            work_available.notify_one();
+            worker.join();
+        }
+    }
+};
+
+static DumpWriter dump_writer;
+static constexpr size_t DUMP_QUEUE_LIMIT = 16 * 1024 * 1024;
 
-    return glsl.str();
+static void dump_writer_run() {
+    std::unique_lock<std::mutex> lock(dump_writer.mutex);
+    for (;;) {
+        if (dump_writer.queue.empty()) {
+            if (dump_writer.stop) {
+                return; // stop only once the queue has drained
+            }
+            dump_writer.work_available.wait(lock);
+            continue;
+        }
+
+        const DumpJob job = std::move(dump_writer.queue.front());
+        dump_writer.queue.pop_front();
+        dump_writer.queued_bytes -= job.data.size();
+        lock.unlock();
+
+        std::ofstream file(job.path, std::ofstream::binary);
+        if (!file.fail()) {
+            file.write(job.data.data(), job.data.size());
+        }
+
+        lock.lock();
+    }
+}
+
+static void queue_dump(std::string path, std::string data) {
+    const std::lock_guard<std::mutex> lock(dump_writer.mutex);
+    if (!dump_writer.worker.joinable()) {
+        dump_writer.worker = std::thread(dump_writer_run);
+    }
+
+    if (dump_writer.queued_bytes + data.size() > DUMP_QUEUE_LIMIT) {
+        LOG_WARN("Dump queue full - not dumping {}.", path);
+        return;
+    }
+
+    dump_writer.queued_bytes += data.size();
+    dump_writer.queue.push_back({ std::move(path), std::move(data) });
+    dump_writer.work_available.notify_one();
 }
 
 static void dump_missing_shader(const char *hash, const char *extension, const SceGxmProgram &program, const char *source) {
     // Dump missing shader GLSL.
-    std::ostringstream glsl_path;
-    glsl_path << hash << "." << extension;
-    std::ofstream glsl_file(glsl_path.str());
-    if (!glsl_file.fail()) {
-        glsl_file << source;
-        glsl_file.close();
-    }
+    queue_dump(std::string(hash) + "." + extension, source);
 
     // Dump missing shader binary.
-    std::ostringstream gxp_path;
-    gxp_path << hash << ".gxp";
-    std::ofstream gxp(gxp_path.str(), std::ofstream::binary);
-    if (!gxp.fail()) {
-        gxp.write(reinterpret_cast<const char *>(&program), program.size);
-        gxp.close();
-    }
+    queue_dump(std::string(hash) + ".gxp", std::string(reinterpret_cast<const char *>(&program), program.size));
 }
 
 static SharedGLObject compile_glsl(GLenum type, const std::string &source) {
@@ -353,14 +461,343 @@ static SharedGLObject compile_glsl(GLenum type, const std::string &source) {
     return shader;
 }
 
-static void bind_attribute_locations(GLuint gl_program, const SceGxmVertexProgram &program) {
+// Warm boots restore linked programs with glProgramBinary instead of
+// recompiling GLSL through the driver. Binaries are driver-specific, so a
+// stale or foreign file simply fails to load and we fall back to compiling.
+static std::string program_binary_path(const char *pref_path, const char *vs_hash, const char *fs_hash) {
+    std::ostringstream path;
+    path << pref_path << "shadercache/" << vs_hash << "-" << fs_hash << ".bin";
+
+    return path.str();
+}
+
+static SharedGLObject load_program_binary(const std::string &path) {
+    // Mapped shared read-only and fed to the driver straight from the
+    // mapping - no private heap copy, and instances restoring the same
+    // title's cache share the file's pages.
+    MappedFile file;
+    if (!file.open(path) || (file.size() <= sizeof(uint32_t))) {
+        return SharedGLObject();
+    }
+
+    uint32_t raw_format = 0;
+    memcpy(&raw_format, file.data(), sizeof(raw_format));
+
+    const SharedGLObject program = std::make_shared<GLObject>();
+    if (!program->init(glCreateProgram(), &glDeleteProgram)) {
+        return SharedGLObject();
+    }
+
+    glProgramBinary(program->get(), static_cast<GLenum>(raw_format), file.data() + sizeof(raw_format), static_cast<GLsizei>(file.size() - sizeof(raw_format)));
+
+    GLboolean is_linked = GL_FALSE;
+    glGetProgramiv(program->get(), GL_LINK_STATUS, &is_linked);
+    if (is_linked == GL_FALSE) {
+        return SharedGLObject();
+    }
+
+    return program;
+}
+
+static void save_program_binary(const char *pref_path, const std::string &path, GLuint gl_program) {
+    GLint binary_size = 0;
+    glGetProgramiv(gl_program, GL_PROGRAM_BINARY_LENGTH, &binary_size);
+    if (binary_size <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(binary_size);
+    GLsizei written = 0;
+    GLenum format = GL_NONE;
+    glGetProgramBinary(gl_program, binary_size, &written, &format, binary.data());
+
+    fs::create_directory(std::string(pref_path) + "shadercache");
+
+    std::ofstream file(path, std::ofstream::binary);
+    if (file.fail()) {
+        return;
+    }
+
+    const uint32_t raw_format = static_cast<uint32_t>(format);
+    file.write(reinterpret_cast<const char *>(&raw_format), sizeof(raw_format));
+    file.write(binary.data(), written);
+}
+
+static void bind_attribute_locations(GLuint gl_program, const AttributeLocations &locations) {
     GXM_PROFILE(__FUNCTION__);
 
-    for (const AttributeLocations::value_type &binding : program.attribute_locations) {
+    for (const AttributeLocations::value_type &binding : locations) {
         glBindAttribLocation(gl_program, binding.first / sizeof(uint32_t), binding.second.c_str());
     }
 }
 
+// TODO A SPIR-V path (GL 4.6 glShaderBinary or a Vulkan backend) would skip
+// the driver's GLSL front-end entirely, but we pin GL 4.1 core for macOS and
+// the shaders-db sources are hand-written GLSL with no IR to retarget. Until
+// a real GXM shader translator exists, the binary cache plus the background
+// compiler below are the practical mitigations for compile cost.
+//
+// Runs on the compiler thread against its own GL context. A failed build
+// returns an empty object, which get_program caches so the link is only
+// attempted once.
+static SharedGLObject build_program(const ShaderCompileJob &job) {
+    const SharedGLObject restored = load_program_binary(job.binary_path);
+    if (restored || job.binary_only) {
+        return restored;
+    }
+
+    const std::string &fragment_glsl = std::get<0>(job.glsls);
+    const std::string &vertex_glsl = std::get<1>(job.glsls);
+
+    const SharedGLObject fragment_shader = compile_glsl(GL_FRAGMENT_SHADER, fragment_glsl);
+    if (!fragment_shader) {
+        LOG_CRITICAL("Error in compiled fragment shader:\n{}", fragment_glsl);
+        return SharedGLObject();
+    }
+    const SharedGLObject vertex_shader = compile_glsl(GL_VERTEX_SHADER, vertex_glsl);
+    if (!vertex_shader) {
+        LOG_CRITICAL("Error in compiled vertex shader:\n{}", vertex_glsl);
+        return SharedGLObject();
+    }
+
+    const SharedGLObject program = std::make_shared<GLObject>();
+    if (!program->init(glCreateProgram(), &glDeleteProgram)) {
+        return SharedGLObject();
+    }
+
+    glAttachShader(program->get(), fragment_shader->get());
+    glAttachShader(program->get(), vertex_shader->get());
+
+    bind_attribute_locations(program->get(), job.attribute_locations);
+
+    glProgramParameteri(program->get(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program->get());
+
+    GLint log_length = 0;
+    glGetProgramiv(program->get(), GL_INFO_LOG_LENGTH, &log_length);
+
+    if (log_length > 0) {
+        std::vector<GLchar> log;
+        log.resize(log_length);
+        glGetProgramInfoLog(program->get(), log_length, nullptr, log.data());
+
+        LOG_ERROR("{}\nProgram: {}\n", log.data(), job.binary_path);
+    }
+
+    GLboolean is_linked = GL_FALSE;
+    glGetProgramiv(program->get(), GL_LINK_STATUS, &is_linked);
+    assert(is_linked != GL_FALSE);
+    if (is_linked == GL_FALSE) {
+        return SharedGLObject();
+    }
+
+    glDetachShader(program->get(), fragment_shader->get());
+    glDetachShader(program->get(), vertex_shader->get());
+
+    save_program_binary(job.pref_path.c_str(), job.binary_path, program->get());
+
+    return program;
+}
+
+void shader_compiler_run(ShaderCompiler &compiler) {
+    std::unique_lock<std::mutex> lock(compiler.mutex);
+    while (!compiler.stop) {
+        if (compiler.queue.empty()) {
+            compiler.work_available.wait(lock);
+            continue;
+        }
+
+        const ShaderCompileJob job = std::move(compiler.queue.front());
+        compiler.queue.pop_front();
+        lock.unlock();
+
+        SharedGLObject program;
+        {
+            // Attributed time means "a compile was in flight during the
+            // frame" - the stall the guest sees is the draws skipped while
+            // waiting, and this is what they were waiting on.
+            const HitchStageScope hitch(HITCH_STAGE_SHADER_COMPILE);
+            program = build_program(job);
+
+            // Make sure the link has completed before the render context can
+            // see the program object.
+            glFinish();
+        }
+
+        lock.lock();
+        if (!program && job.binary_only) {
+            // The binary was stale or missing. Forget the pair so a real
+            // request compiles it from source instead of inheriting a
+            // cached failure.
+            compiler.in_flight.erase(job.glsls);
+        } else {
+            compiler.finished.emplace_back(job.glsls, program);
+        }
+    }
+}
+
+void prewarm_shader_programs(SceGxmContext &context, GxmState &gxm, const char *base_path, const char *pref_path) {
+    const std::vector<std::string> entries = prewarm_log_entries(gxm.prewarm);
+    if (entries.empty()) {
+        return;
+    }
+
+    // Queue one binary-only job per recorded pair. The GLSL key the program
+    // cache uses is rebuilt from the shaders db by hash; a pair whose source
+    // came from the generated fallback can't be rebuilt here and is skipped.
+    ShaderCompiler &compiler = context.renderer.shader_compiler;
+    size_t queued = 0;
+    for (const std::string &entry : entries) {
+        const size_t space = entry.find(' ');
+        if ((space == std::string::npos) || (space + 1 >= entry.size())) {
+            continue;
+        }
+        const std::string vs_hash = entry.substr(0, space);
+        const std::string fs_hash = entry.substr(space + 1);
+
+        const std::string vertex_glsl = load_shader(gxm.shaders_db, vs_hash.c_str(), "vert", base_path);
+        const std::string fragment_glsl = load_shader(gxm.shaders_db, fs_hash.c_str(), "frag", base_path);
+        if (vertex_glsl.empty() || fragment_glsl.empty()) {
+            continue;
+        }
+
+        ShaderCompileJob job;
+        job.glsls = ProgramGLSLs(fragment_glsl, vertex_glsl);
+        job.binary_path = program_binary_path(pref_path, vs_hash.c_str(), fs_hash.c_str());
+        job.pref_path = pref_path;
+        job.binary_only = true;
+
+        {
+            const std::lock_guard<std::mutex> lock(compiler.mutex);
+            if (!compiler.in_flight.insert(job.glsls).second) {
+                continue;
+            }
+            compiler.queue.push_back(std::move(job));
+        }
+        ++queued;
+    }
+
+    if (queued > 0) {
+        compiler.work_available.notify_one();
+        LOG_INFO("Prewarming {} shader programs from the session manifest.", queued);
+    }
+}
+
+void render_thread_run(RenderThread &renderer) {
+    // Every scene ends with a synchronous readback through this thread, so
+    // losing the core to a bulk worker stalls the frame - pin it above them.
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+    std::unique_lock<std::mutex> lock(renderer.mutex);
+    while (!renderer.stop) {
+        if (renderer.queue.empty()) {
+            renderer.work_available.wait(lock);
+            continue;
+        }
+
+        const RenderCommand command = std::move(renderer.queue.front());
+        renderer.queue.pop_front();
+        lock.unlock();
+
+        command();
+
+        lock.lock();
+        ++renderer.completed;
+        if (renderer.completed == renderer.submitted) {
+            renderer.batch_done.notify_all();
+        }
+    }
+}
+
+void render_queue(RenderThread &renderer, RenderCommand command) {
+    {
+        const std::lock_guard<std::mutex> lock(renderer.mutex);
+        renderer.queue.push_back(std::move(command));
+        ++renderer.submitted;
+    }
+    renderer.work_available.notify_one();
+}
+
+// Blocks until every command queued so far has executed. Commands that read
+// GL state back record like any other command and the caller syncs
+// afterwards, so results become visible to the guest in program order.
+void render_sync(RenderThread &renderer) {
+    std::unique_lock<std::mutex> lock(renderer.mutex);
+    while (renderer.completed != renderer.submitted) {
+        renderer.batch_done.wait(lock);
+    }
+}
+
+// Applies the current pacing mode to the display queue's pending cap,
+// waking a producer blocked on a cap that was just raised.
+void apply_display_pacing(GxmState &gxm) {
+    unsigned int cap = gxm.params.displayQueueMaxPendingCount;
+    switch (gxm.pacing) {
+    case DISPLAY_PACING_STRICT:
+        break;
+    case DISPLAY_PACING_TRIPLE:
+        cap += 1;
+        break;
+    case DISPLAY_PACING_UNLOCKED:
+        cap = std::numeric_limits<unsigned int>::max();
+        break;
+    }
+
+    gxm.display_queue.set_max_pending_count(cap);
+}
+
+void register_mapped_region(GxmState &gxm, Address base, uint32_t size, MappedRegionKind kind, bool writable) {
+    MappedRegion region;
+    region.base = base;
+    region.size = size;
+    region.kind = kind;
+    region.writable = writable;
+
+    const std::lock_guard<std::mutex> lock(gxm.mappings.mutex);
+    gxm.mappings.regions[base] = region;
+}
+
+bool unregister_mapped_region(GxmState &gxm, Address base) {
+    const std::lock_guard<std::mutex> lock(gxm.mappings.mutex);
+    return gxm.mappings.regions.erase(base) != 0;
+}
+
+bool resolve_mapped_region(const GxmState &gxm, Address address, MappedRegion *region) {
+    const std::lock_guard<std::mutex> lock(gxm.mappings.mutex);
+    const auto &regions = gxm.mappings.regions;
+
+    // The containing region, if there is one, is the last region starting
+    // at or below the address.
+    auto it = regions.upper_bound(address);
+    if (it == regions.begin()) {
+        return false;
+    }
+    --it;
+    if (address >= it->second.base + it->second.size) {
+        return false;
+    }
+    if (region) {
+        *region = it->second;
+    }
+    return true;
+}
+
+// Drains the queue and joins the worker. After this the caller can take the
+// render context back and delete GL objects on its own thread.
+void render_stop(RenderThread &renderer) {
+    if (!renderer.worker.joinable()) {
+        return;
+    }
+
+    render_sync(renderer);
+    {
+        const std::lock_guard<std::mutex> lock(renderer.mutex);
+        renderer.stop = true;
+    }
+    renderer.work_available.notify_one();
+    renderer.worker.join();
+}
+
 template <class T>
 void uniform_4(GLint location, GLsizei count, const T *value);
 
@@ -424,8 +861,10 @@ void set_uniform(GLint location, size_t component_count, GLsizei array_size, con
     }
 }
 
-static void set_uniforms(GLuint gl_program, const UniformBuffers &uniform_buffers, const SceGxmProgram &gxm_program, const MemState &mem) {
-    GXM_PROFILE(__FUNCTION__);
+// Resolves every uniform parameter's location in one pass, done once per
+// (GL program, GXM program) pair. Non-uniform parameters resolve to -1.
+static std::vector<GLint> resolve_uniform_locations(GLuint gl_program, const SceGxmProgram &gxm_program) {
+    std::vector<GLint> locations(gxm_program.parameter_count, -1);
 
     const SceGxmProgramParameter *const parameters = program_parameters(gxm_program);
     for (size_t i = 0; i < gxm_program.parameter_count; ++i) {
@@ -434,17 +873,42 @@ static void set_uniforms(GLuint gl_program, const UniformBuffers &uniform_buffer
             continue;
         }
 
-        auto name = parameter_name(parameter);
-        const GLint location = glGetUniformLocation(gl_program, name.c_str());
-        if (location < 0) {
+        const auto name = parameter_name(parameter);
+        locations[i] = glGetUniformLocation(gl_program, name.c_str());
+        if (locations[i] < 0) {
             LOG_WARN("Uniform parameter {} not found in current OpenGL program.", name);
+        }
+    }
+
+    return locations;
+}
+
+static void set_uniforms(GLuint gl_program, UniformLocationCache &cache, const UniformBuffers &uniform_buffers, const SceGxmProgram &gxm_program, const MemState &mem) {
+    GXM_PROFILE(__FUNCTION__);
+
+    const UniformLocationCache::key_type key(gl_program, &gxm_program);
+    UniformLocationCache::iterator cached = cache.find(key);
+    if (cached == cache.end()) {
+        cached = cache.emplace(key, resolve_uniform_locations(gl_program, gxm_program)).first;
+    }
+    const std::vector<GLint> &locations = cached->second;
+
+    const SceGxmProgramParameter *const parameters = program_parameters(gxm_program);
+    for (size_t i = 0; i < gxm_program.parameter_count; ++i) {
+        const SceGxmProgramParameter &parameter = parameters[i];
+        if (parameter.category != SCE_GXM_PARAMETER_CATEGORY_UNIFORM) {
             continue;
         }
 
+        const GLint location = locations[i];
+        if (location < 0) {
+            continue; // warned once at resolve time
+        }
+
         const SceGxmParameterType type = static_cast<SceGxmParameterType>(static_cast<uint16_t>(parameter.type));
         const Ptr<const void> uniform_buffer = uniform_buffers[parameter.container_index];
         if (!uniform_buffer) {
-            LOG_WARN("Uniform buffer {} not set for parameter {}.", parameter.container_index, name);
+            LOG_WARN("Uniform buffer {} not set for parameter {}.", parameter.container_index, parameter_name(parameter));
             continue;
         }
 
@@ -462,35 +926,30 @@ static void set_uniforms(GLuint gl_program, const UniformBuffers &uniform_buffer
             set_uniform<GLfloat>(location, parameter.component_count, parameter.array_size, src_f32);
             break;
         default:
-            LOG_WARN("Type {} not handled for uniform parameter {}.", type, name);
+            LOG_WARN("Type {} not handled for uniform parameter {}.", type, parameter_name(parameter));
             break;
         }
     }
 }
 
-static bool operator<(const SceGxmRegisteredProgram &a, const SceGxmRegisteredProgram &b) {
-    return a.program < b.program;
-}
-
-static bool operator<(const emu::SceGxmBlendInfo &a, const emu::SceGxmBlendInfo &b) {
-    return memcmp(&a, &b, sizeof(a)) < 0;
-}
-
-void set_viewport(const GxmViewport &viewport, GLsizei display_w, GLsizei display_h) {
+void set_viewport(const GxmViewport &viewport, GLsizei display_w, GLsizei display_h, uint32_t multiplier) {
+    // Guest coordinates are scaled up by the resolution multiplier to cover
+    // the internally larger framebuffer.
+    const GLfloat scale = static_cast<GLfloat>(multiplier);
     if (viewport.enable == SCE_GXM_VIEWPORT_ENABLED) {
-        const GLfloat w = viewport.scale.x * 2;
-        const GLfloat h = viewport.scale.y * -2;
-        const GLfloat x = viewport.offset.x - viewport.scale.x;
-        const GLfloat y = display_h - (viewport.offset.y - viewport.scale.y);
+        const GLfloat w = viewport.scale.x * 2 * scale;
+        const GLfloat h = viewport.scale.y * -2 * scale;
+        const GLfloat x = (viewport.offset.x - viewport.scale.x) * scale;
+        const GLfloat y = (display_h - (viewport.offset.y - viewport.scale.y)) * scale;
         glViewportIndexedf(0, x, y, w, h);
         glDepthRange(viewport.offset.z - viewport.scale.z, viewport.offset.z + viewport.scale.z);
     } else {
-        glViewport(0, 0, display_w, display_h);
+        glViewport(0, 0, display_w * multiplier, display_h * multiplier);
         glDepthRange(0, 1);
     }
 }
 
-std::string get_fragment_glsl(SceGxmShaderPatcher &shader_patcher, const SceGxmProgram &fragment_program, const char *base_path) {
+std::string get_fragment_glsl(SceGxmShaderPatcher &shader_patcher, const ShadersDB &shaders_db, const SceGxmProgram &fragment_program, const char *base_path) {
     const Sha256Hash hash_bytes = sha256(&fragment_program, fragment_program.size);
     const GLSLCache::const_iterator cached = shader_patcher.fragment_glsl_cache.find(hash_bytes);
     if (cached != shader_patcher.fragment_glsl_cache.end()) {
@@ -498,7 +957,7 @@ std::string get_fragment_glsl(SceGxmShaderPatcher &shader_patcher, const SceGxmP
     }
 
     const Sha256HashText hash_text = hex(hash_bytes);
-    std::string source = load_shader(hash_text.data(), "frag", base_path);
+    std::string source = load_shader(shaders_db, hash_text.data(), "frag", base_path);
     if (source.empty()) {
         LOG_ERROR("Missing fragment shader {}", hash_text.data());
         source = generate_fragment_glsl(fragment_program);
@@ -510,7 +969,7 @@ std::string get_fragment_glsl(SceGxmShaderPatcher &shader_patcher, const SceGxmP
     return source;
 }
 
-std::string get_vertex_glsl(SceGxmShaderPatcher &shader_patcher, const SceGxmProgram &vertex_program, const char *base_path) {
+std::string get_vertex_glsl(SceGxmShaderPatcher &shader_patcher, const ShadersDB &shaders_db, const SceGxmProgram &vertex_program, const char *base_path) {
     const Sha256Hash hash_bytes = sha256(&vertex_program, vertex_program.size);
     const GLSLCache::const_iterator cached = shader_patcher.vertex_glsl_cache.find(hash_bytes);
     if (cached != shader_patcher.vertex_glsl_cache.end()) {
@@ -518,7 +977,7 @@ std::string get_vertex_glsl(SceGxmShaderPatcher &shader_patcher, const SceGxmPro
     }
 
     const Sha256HashText hash_text = hex(hash_bytes);
-    std::string source = load_shader(hash_text.data(), "vert", base_path);
+    std::string source = load_shader(shaders_db, hash_text.data(), "vert", base_path);
     if (source.empty()) {
         LOG_ERROR("Missing vertex shader {}", hash_text.data());
         source = generate_vertex_glsl(vertex_program);
@@ -549,74 +1008,87 @@ AttributeLocations attribute_locations(const SceGxmProgram &vertex_program) {
     return locations;
 }
 
-SharedGLObject get_program(SceGxmContext &context, const MemState &mem) {
+SharedGLObject get_program(SceGxmContext &context, const GxmDrawStateSnapshot &state, const MemState &mem, GxmState &gxm, const char *pref_path) {
     GXM_PROFILE(__FUNCTION__);
 
-    assert(context.state.fragment_program);
-    assert(context.state.vertex_program);
+    assert(state.fragment_program);
+    assert(state.vertex_program);
 
-    const SceGxmFragmentProgram &fragment_program = *context.state.fragment_program.get(mem);
-    const SceGxmVertexProgram &vertex_program = *context.state.vertex_program.get(mem);
+    // Hot exit: the previous draw used the same pair.
+    if (context.renderer.last_program
+        && (state.fragment_program == context.renderer.last_fragment_program)
+        && (state.vertex_program == context.renderer.last_vertex_program)) {
+        return context.renderer.last_program;
+    }
+
+    const SceGxmFragmentProgram &fragment_program = *state.fragment_program.get(mem);
+    const SceGxmVertexProgram &vertex_program = *state.vertex_program.get(mem);
     const ProgramGLSLs glsls(fragment_program.glsl, vertex_program.glsl);
-    const ProgramCache::const_iterator cached = context.renderer.program_cache.find(glsls);
+    ProgramCache::const_iterator cached = context.renderer.program_cache.find(glsls);
     if (cached != context.renderer.program_cache.end()) {
+        // Failed builds are cached as empty objects; keep those out of the
+        // hot slot so they keep taking the full lookup.
+        if (cached->second) {
+            context.renderer.last_fragment_program = state.fragment_program;
+            context.renderer.last_vertex_program = state.vertex_program;
+            context.renderer.last_program = cached->second;
+        }
         return cached->second;
     }
 
-    const SharedGLObject fragment_shader = compile_glsl(GL_FRAGMENT_SHADER, fragment_program.glsl);
-    if (!fragment_shader) {
-        LOG_CRITICAL("Error in compiled fragment shader:\n{}", fragment_program.glsl);
-        return SharedGLObject();
-    }
-    const SharedGLObject vertex_shader = compile_glsl(GL_VERTEX_SHADER, vertex_program.glsl);
-    if (!vertex_shader) {
-        LOG_CRITICAL("Error in compiled vertex shader:\n{}", vertex_program.glsl);
-        return SharedGLObject();
-    }
-
-    const SharedGLObject program = std::make_shared<GLObject>();
-    if (!program->init(glCreateProgram(), &glDeleteProgram)) {
-        return SharedGLObject();
+    // Install programs the worker has finished since the last miss. Failed
+    // builds land in the cache as empty objects so they are only tried once.
+    ShaderCompiler &compiler = context.renderer.shader_compiler;
+    {
+        const std::lock_guard<std::mutex> lock(compiler.mutex);
+        for (const std::pair<ProgramGLSLs, SharedGLObject> &result : compiler.finished) {
+            compiler.in_flight.erase(result.first);
+            context.renderer.program_cache.emplace(result.first, result.second);
+        }
+        compiler.finished.clear();
     }
 
-    glAttachShader(program->get(), fragment_shader->get());
-    glAttachShader(program->get(), vertex_shader->get());
-
-    bind_attribute_locations(program->get(), vertex_program);
-
-    glLinkProgram(program->get());
-
-    GLint log_length = 0;
-    glGetProgramiv(program->get(), GL_INFO_LOG_LENGTH, &log_length);
-
-    if (log_length > 0) {
-        std::vector<GLchar> log;
-        log.resize(log_length);
-        glGetProgramInfoLog(program->get(), log_length, nullptr, log.data());
-
-        const SceGxmProgram &vs_gxp = *vertex_program.program.get(mem);
-        const SceGxmProgram &fs_gxp = *fragment_program.program.get(mem);
-        const Sha256Hash vs_hash_bytes = sha256(&vs_gxp, vs_gxp.size);
-        const Sha256Hash fs_hash_bytes = sha256(&fs_gxp, fs_gxp.size);
-        const Sha256HashText vs_hash_text = hex(vs_hash_bytes);
-        const Sha256HashText fs_hash_text = hex(fs_hash_bytes);
-
-        LOG_ERROR("{}\nVS: {}\nFS: {}\n", log.data(), vs_hash_text.data(), fs_hash_text.data());
+    cached = context.renderer.program_cache.find(glsls);
+    if (cached != context.renderer.program_cache.end()) {
+        if (cached->second) {
+            context.renderer.last_fragment_program = state.fragment_program;
+            context.renderer.last_vertex_program = state.vertex_program;
+            context.renderer.last_program = cached->second;
+        }
+        return cached->second;
     }
 
-    GLboolean is_linked = GL_FALSE;
-    glGetProgramiv(program->get(), GL_LINK_STATUS, &is_linked);
-    assert(is_linked != GL_FALSE);
-    if (is_linked == GL_FALSE) {
-        return SharedGLObject();
+    // Key the on-disk binary by the GXM program hashes - the same identity
+    // the shader database uses.
+    const SceGxmProgram &vs_gxp = *vertex_program.program.get(mem);
+    const SceGxmProgram &fs_gxp = *fragment_program.program.get(mem);
+    const Sha256HashText vs_hash_text = hex(sha256(&vs_gxp, vs_gxp.size));
+    const Sha256HashText fs_hash_text = hex(sha256(&fs_gxp, fs_gxp.size));
+
+    ShaderCompileJob job;
+    job.glsls = glsls;
+    job.attribute_locations = vertex_program.attribute_locations;
+    job.binary_path = program_binary_path(pref_path, vs_hash_text.data(), fs_hash_text.data());
+    job.pref_path = pref_path;
+
+    // First request of this pair in the session - note it in the manifest
+    // so the next session restores it before it is asked for.
+    std::string pair_key(vs_hash_text.data());
+    pair_key += ' ';
+    pair_key += fs_hash_text.data();
+    prewarm_log_record(gxm.prewarm, pair_key);
+
+    {
+        const std::lock_guard<std::mutex> lock(compiler.mutex);
+        if (compiler.in_flight.insert(glsls).second) {
+            compiler.queue.push_back(std::move(job));
+        }
     }
+    compiler.work_available.notify_one();
 
-    glDetachShader(program->get(), fragment_shader->get());
-    glDetachShader(program->get(), vertex_shader->get());
-
-    context.renderer.program_cache.emplace(glsls, program);
-
-    return program;
+    // Not ready yet - the caller skips this draw and picks the program up
+    // on a later call.
+    return SharedGLObject();
 }
 
 GLenum attribute_format_to_gl_type(SceGxmAttributeFormat format) {
@@ -684,32 +1156,29 @@ bool attribute_format_normalised(SceGxmAttributeFormat format) {
     }
 }
 
-void set_uniforms(GLuint program, const SceGxmContext &context, const MemState &mem) {
+void set_uniforms(GLuint program, SceGxmContext &context, const GxmDrawStateSnapshot &state, const MemState &mem, uint64_t uniform_write_generation) {
     GXM_PROFILE(__FUNCTION__);
 
-    assert(context.state.fragment_program);
-    assert(context.state.vertex_program);
+    assert(state.fragment_program);
+    assert(state.vertex_program);
 
-    const SceGxmFragmentProgram &fragment_program = *context.state.fragment_program.get(mem);
-    const SceGxmVertexProgram &vertex_program = *context.state.vertex_program.get(mem);
+    RendererContextState &renderer = context.renderer;
+    if ((renderer.last_uniform_program == program) && (renderer.last_fragment_uniform_generation == state.fragment_uniform_generation) && (renderer.last_vertex_uniform_generation == state.vertex_uniform_generation) && (renderer.last_uniform_write_generation == uniform_write_generation)) {
+        return; // nothing touched uniform state since the last draw
+    }
+
+    const SceGxmFragmentProgram &fragment_program = *state.fragment_program.get(mem);
+    const SceGxmVertexProgram &vertex_program = *state.vertex_program.get(mem);
     assert(fragment_program.program);
     assert(vertex_program.program);
 
-    set_uniforms(program, context.state.fragment_uniform_buffers, *fragment_program.program.get(mem), mem);
-    set_uniforms(program, context.state.vertex_uniform_buffers, *vertex_program.program.get(mem), mem);
-}
-
-void flip_vertically(uint32_t *pixels, size_t width, size_t height, size_t stride_in_pixels) {
-    GXM_PROFILE(__FUNCTION__);
+    set_uniforms(program, context.renderer.uniform_locations, state.fragment_uniform_buffers, *fragment_program.program.get(mem), mem);
+    set_uniforms(program, context.renderer.uniform_locations, state.vertex_uniform_buffers, *vertex_program.program.get(mem), mem);
 
-    uint32_t *row1 = &pixels[0];
-    uint32_t *row2 = &pixels[(height - 1) * stride_in_pixels];
-
-    while (row1 < row2) {
-        std::swap_ranges(&row1[0], &row1[width], &row2[0]);
-        row1 += stride_in_pixels;
-        row2 -= stride_in_pixels;
-    }
+    renderer.last_uniform_program = program;
+    renderer.last_fragment_uniform_generation = state.fragment_uniform_generation;
+    renderer.last_vertex_uniform_generation = state.vertex_uniform_generation;
+    renderer.last_uniform_write_generation = uniform_write_generation;
 }
 
 GLenum translate_blend_func(SceGxmBlendFunc src) {
@@ -819,6 +1288,10 @@ namespace texture {
         }
     }
 
+    // The palette expansions below process eight pixels per iteration so the
+    // lookups pipeline instead of serializing on one load at a time. Hardware
+    // gather instructions were measured no faster for tables this small.
+
     void palette_texture_to_rgba_4(uint32_t *dst, const uint8_t *src, size_t width, size_t height, const uint32_t *palette) {
         LOG_WARN("4-bit palettes are not yet tested.");
 
@@ -826,12 +1299,25 @@ namespace texture {
         for (size_t y = 0; y < height; ++y) {
             uint32_t *const dst_row = &dst[y * width];
             const uint8_t *const src_row = &src[y * stride];
-            for (size_t x = 0; x < width; ++x) {
+            size_t x = 0;
+            for (; x + 8 <= width; x += 8) {
+                const uint8_t b0 = src_row[x / 2 + 0];
+                const uint8_t b1 = src_row[x / 2 + 1];
+                const uint8_t b2 = src_row[x / 2 + 2];
+                const uint8_t b3 = src_row[x / 2 + 3];
+                dst_row[x + 0] = palette[b0 & 0xf];
+                dst_row[x + 1] = palette[b0 >> 4];
+                dst_row[x + 2] = palette[b1 & 0xf];
+                dst_row[x + 3] = palette[b1 >> 4];
+                dst_row[x + 4] = palette[b2 & 0xf];
+                dst_row[x + 5] = palette[b2 >> 4];
+                dst_row[x + 6] = palette[b3 & 0xf];
+                dst_row[x + 7] = palette[b3 >> 4];
+            }
+            for (; x < width; x += 2) {
                 const uint8_t lohi = src_row[x / 2];
-                const uint8_t lo = lohi & 0xf;
-                const uint8_t hi = lohi >> 4;
-                dst_row[x + 0] = palette[lo];
-                dst_row[x + 1] = palette[hi];
+                dst_row[x + 0] = palette[lohi & 0xf];
+                dst_row[x + 1] = palette[lohi >> 4];
             }
         }
     }
@@ -841,11 +1327,119 @@ namespace texture {
         for (size_t y = 0; y < height; ++y) {
             uint32_t *const dst_row = &dst[y * width];
             const uint8_t *const src_row = &src[y * stride];
-            for (size_t x = 0; x < width; ++x) {
+            size_t x = 0;
+            for (; x + 8 <= width; x += 8) {
+                dst_row[x + 0] = palette[src_row[x + 0]];
+                dst_row[x + 1] = palette[src_row[x + 1]];
+                dst_row[x + 2] = palette[src_row[x + 2]];
+                dst_row[x + 3] = palette[src_row[x + 3]];
+                dst_row[x + 4] = palette[src_row[x + 4]];
+                dst_row[x + 5] = palette[src_row[x + 5]];
+                dst_row[x + 6] = palette[src_row[x + 6]];
+                dst_row[x + 7] = palette[src_row[x + 7]];
+            }
+            for (; x < width; ++x) {
                 dst_row[x] = palette[src_row[x]];
             }
         }
     }
+
+    // Fixed-point BT.601 video-range conversion; 8.8 coefficients keep the
+    // whole thing in integers.
+    static uint32_t yuv_to_rgba(int y, int u, int v) {
+        const int c = y - 16;
+        const int d = u - 128;
+        const int e = v - 128;
+
+        int r = (298 * c + 409 * e + 128) >> 8;
+        int g = (298 * c - 100 * d - 208 * e + 128) >> 8;
+        int b = (298 * c + 516 * d + 128) >> 8;
+        r = (r < 0) ? 0 : ((r > 255) ? 255 : r);
+        g = (g < 0) ? 0 : ((g > 255) ? 255 : g);
+        b = (b < 0) ? 0 : ((b > 255) ? 255 : b);
+
+        return 0xff000000 | (b << 16) | (g << 8) | r;
+    }
+
+    void yuv420_texture_to_rgba(uint32_t *dst, const uint8_t *y_plane, const uint8_t *u_plane, const uint8_t *v_plane, size_t width, size_t height, size_t uv_step) {
+        // uv_step is 1 for planar U/V (P3) and 2 for an interleaved UV plane
+        // (P2), where u_plane/v_plane point at the first U and V bytes.
+        for (size_t y = 0; y < height; ++y) {
+            const uint8_t *const y_row = &y_plane[y * width];
+            const uint8_t *const u_row = &u_plane[(y / 2) * (width / 2) * uv_step];
+            const uint8_t *const v_row = &v_plane[(y / 2) * (width / 2) * uv_step];
+            uint32_t *const dst_row = &dst[y * width];
+            for (size_t x = 0; x < width; ++x) {
+                const size_t uv = (x / 2) * uv_step;
+                dst_row[x] = yuv_to_rgba(y_row[x], u_row[uv], v_row[uv]);
+            }
+        }
+    }
+
+    void yuv422_texture_to_rgba(uint32_t *dst, const uint8_t *src, size_t width, size_t height) {
+        // Packed YUYV: two pixels share one U/V pair.
+        for (size_t y = 0; y < height; ++y) {
+            const uint8_t *const src_row = &src[y * width * 2];
+            uint32_t *const dst_row = &dst[y * width];
+            for (size_t x = 0; x < width; x += 2) {
+                const uint8_t y0 = src_row[x * 2 + 0];
+                const uint8_t u = src_row[x * 2 + 1];
+                const uint8_t y1 = src_row[x * 2 + 2];
+                const uint8_t v = src_row[x * 2 + 3];
+                dst_row[x + 0] = yuv_to_rgba(y0, u, v);
+                dst_row[x + 1] = yuv_to_rgba(y1, u, v);
+            }
+        }
+    }
+
+    // Compacts the even bits of a Morton code into a linear coordinate.
+    // https://fgiesen.wordpress.com/2009/12/13/decoding-morton-codes/
+    static uint32_t decode_morton2(uint32_t code) {
+        code &= 0x55555555;
+        code = (code ^ (code >> 1)) & 0x33333333;
+        code = (code ^ (code >> 2)) & 0x0f0f0f0f;
+        code = (code ^ (code >> 4)) & 0x00ff00ff;
+        code = (code ^ (code >> 8)) & 0x0000ffff;
+        return code;
+    }
+
+    void untwiddle(uint8_t *dst, const uint8_t *src, size_t width, size_t height, size_t bytes_per_pixel) {
+        // Swizzled textures follow a Morton curve over the lower
+        // min(log2 width, log2 height) bits of each coordinate; the excess
+        // bits of the larger dimension sit above the curve. Walking the
+        // source sequentially keeps the reads streaming; only the writes
+        // scatter.
+        const size_t min_dim = (width < height) ? width : height;
+        const size_t curve_mask = min_dim * min_dim - 1;
+        for (size_t i = 0; i < width * height; ++i) {
+            const uint32_t curve = static_cast<uint32_t>(i & curve_mask);
+            const size_t excess = (i & ~curve_mask) / min_dim;
+            size_t x = decode_morton2(curve >> 1);
+            size_t y = decode_morton2(curve);
+            if (width >= height) {
+                x += excess;
+            } else {
+                y += excess;
+            }
+            memcpy(&dst[(y * width + x) * bytes_per_pixel], &src[i * bytes_per_pixel], bytes_per_pixel);
+        }
+    }
+
+    void detile(uint8_t *dst, const uint8_t *src, size_t width, size_t height, size_t bytes_per_pixel) {
+        // Tiled textures pack 32x32 texel tiles row-major, texels row-major
+        // within each tile, so each tile row is one contiguous run.
+        const size_t tile = 32;
+        const size_t tiles_x = width / tile;
+        const size_t tile_row_bytes = tile * bytes_per_pixel;
+        for (size_t ty = 0; ty < height / tile; ++ty) {
+            for (size_t tx = 0; tx < tiles_x; ++tx) {
+                const uint8_t *src_tile = &src[(ty * tiles_x + tx) * tile * tile * bytes_per_pixel];
+                for (size_t y = 0; y < tile; ++y) {
+                    memcpy(&dst[((ty * tile + y) * width + tx * tile) * bytes_per_pixel], &src_tile[y * tile_row_bytes], tile_row_bytes);
+                }
+            }
+        }
+    }
 } // namespace texture
 
 GLenum translate_primitive(SceGxmPrimitiveType primType) {
@@ -944,12 +1538,15 @@ GLenum translate_depth_func(SceGxmDepthFunc depth_func) {
     return GL_ALWAYS;
 }
 
-bool operator<(const FragmentProgramCacheKey &a, const FragmentProgramCacheKey &b) {
-    if (a.fragment_program < b.fragment_program) {
-        return true;
-    }
-    if (b.fragment_program < a.fragment_program) {
-        return false;
-    }
-    return b.blend_info < a.blend_info;
+bool operator==(const FragmentProgramCacheKey &a, const FragmentProgramCacheKey &b) {
+    return (a.fragment_program.program == b.fragment_program.program) && (memcmp(&a.blend_info, &b.blend_info, sizeof(a.blend_info)) == 0);
+}
+
+size_t FragmentProgramCacheKeyHash::operator()(const FragmentProgramCacheKey &key) const {
+    uint32_t blend_word;
+    memcpy(&blend_word, &key.blend_info, sizeof(blend_word));
+
+    const uint64_t folded = (static_cast<uint64_t>(key.fragment_program.program.address()) << 32) | blend_word;
+
+    return std::hash<uint64_t>()(folded);
 }
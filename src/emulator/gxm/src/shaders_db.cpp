@@ -0,0 +1,143 @@
+#include <gxm/shaders_db.h>
+
+#include <util/log.h>
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <dirent.h>
+
+#ifdef WIN32
+#include <util/string_convert.h>
+#endif
+
+static constexpr uint32_t SHADERS_DB_MAGIC = 0x42445356; // "VSDB"
+static constexpr uint32_t SHADERS_DB_VERSION = 1;
+
+static std::string db_path(const char *base_path) {
+    return std::string(base_path) + "shaders.db";
+}
+
+bool load_shaders_db(ShadersDB &db, const char *base_path) {
+    // Mapped shared read-only: instances of the same build serve GLSL from
+    // one physical copy of the pack instead of a private heap copy each.
+    if (!db.file.open(db_path(base_path))) {
+        return false;
+    }
+
+    if (db.file.size() < sizeof(ShadersDBHeader)) {
+        db.file.close();
+        return false;
+    }
+    const ShadersDBHeader *const header = reinterpret_cast<const ShadersDBHeader *>(db.file.data());
+    if ((header->magic != SHADERS_DB_MAGIC) || (header->version != SHADERS_DB_VERSION)) {
+        db.file.close();
+        return false;
+    }
+
+    db.blob_offset = sizeof(ShadersDBHeader) + static_cast<uint64_t>(header->entry_count) * sizeof(ShadersDBEntry);
+    if (db.blob_offset > db.file.size()) {
+        db.file.close();
+        return false;
+    }
+    const uint64_t blob_size = db.file.size() - db.blob_offset;
+
+    const ShadersDBEntry *const entries = reinterpret_cast<const ShadersDBEntry *>(db.file.data() + sizeof(ShadersDBHeader));
+    for (uint32_t i = 0; i < header->entry_count; ++i) {
+        const ShadersDBEntry &entry = entries[i];
+        if (static_cast<uint64_t>(entry.offset) + entry.size > blob_size) {
+            LOG_WARN("Shader {} points outside shaders.db - skipped.", entry.name);
+            continue;
+        }
+        db.index.emplace(entry.name, std::make_pair(entry.offset, entry.size));
+    }
+
+    return true;
+}
+
+bool build_shaders_db(const char *base_path) {
+    const std::string dir_path = std::string(base_path) + "shaders";
+
+#ifdef WIN32
+    _WDIR *const d = _wopendir(utf_to_wide(dir_path).c_str());
+    _wdirent *dp;
+#else
+    DIR *const d = opendir(dir_path.c_str());
+    dirent *dp;
+#endif
+    if (d == nullptr) {
+        return false;
+    }
+
+    std::vector<ShadersDBEntry> entries;
+    std::string blob;
+    do {
+        std::string name;
+#ifdef WIN32
+        if ((dp = _wreaddir(d)) != NULL) {
+            name = wide_to_utf(dp->d_name);
+#else
+        if ((dp = readdir(d)) != NULL) {
+            name = dp->d_name;
+#endif
+            const size_t dot = name.rfind('.');
+            if ((dot == std::string::npos) || ((name.compare(dot, std::string::npos, ".frag") != 0) && (name.compare(dot, std::string::npos, ".vert") != 0))) {
+                continue;
+            }
+            if (name.size() >= sizeof(ShadersDBEntry::name)) {
+                LOG_WARN("Shader name {} too long for shaders.db - skipped.", name);
+                continue;
+            }
+
+            std::ifstream source(dir_path + "/" + name, std::ifstream::binary);
+            if (source.fail()) {
+                continue;
+            }
+            source.seekg(0, std::ios::end);
+            const std::streamoff size = source.tellg();
+            source.seekg(0);
+
+            ShadersDBEntry entry = {};
+            strncpy(entry.name, name.c_str(), sizeof(entry.name) - 1);
+            entry.offset = static_cast<uint32_t>(blob.size());
+            entry.size = static_cast<uint32_t>(size);
+            entries.push_back(entry);
+
+            blob.resize(blob.size() + size);
+            source.read(&blob[entry.offset], size);
+        }
+    } while (dp);
+
+#ifdef WIN32
+    _wclosedir(d);
+#else
+    closedir(d);
+#endif
+
+    if (entries.empty()) {
+        return false;
+    }
+
+    std::ofstream file(db_path(base_path), std::ofstream::binary);
+    if (file.fail()) {
+        return false;
+    }
+
+    const ShadersDBHeader header = { SHADERS_DB_MAGIC, SHADERS_DB_VERSION, static_cast<uint32_t>(entries.size()), 0 };
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(ShadersDBEntry));
+    file.write(blob.data(), blob.size());
+
+    return !file.fail();
+}
+
+std::string find_shader(const ShadersDB &db, const char *name) {
+    const ShadersDBIndex::const_iterator entry = db.index.find(name);
+    if (entry == db.index.end()) {
+        return std::string();
+    }
+
+    const char *const blob = reinterpret_cast<const char *>(db.file.data()) + db.blob_offset;
+    return std::string(blob + entry->second.first, entry->second.second);
+}
@@ -0,0 +1,50 @@
+#include <gxm/surface_cache_functions.h>
+
+#include <gxm/surface_cache_state.h>
+
+#include <glutil/gl.h>
+
+// Returns the texture backing the surface at address, creating or resizing
+// it as needed. Must run where the render context is current.
+SharedGLObject get_surface_texture(SurfaceCacheState &cache, Address address, uint32_t width, uint32_t height, uint32_t multiplier) {
+    SurfaceCacheEntry &entry = cache.surfaces[address];
+    if (entry.texture && (entry.width == width) && (entry.height == height) && (entry.multiplier == multiplier)) {
+        return entry.texture;
+    }
+
+    if (!entry.texture) {
+        entry.texture = std::make_shared<GLObject>();
+        GLuint name = 0;
+        glGenTextures(1, &name);
+        if (!entry.texture->init(name, [](GLuint name) { glDeleteTextures(1, &name); })) {
+            cache.surfaces.erase(address);
+            return SharedGLObject();
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, entry.texture->get());
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width * multiplier, height * multiplier, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    entry.width = width;
+    entry.height = height;
+    entry.multiplier = multiplier;
+
+    return entry.texture;
+}
+
+// Returns the surface texture at address if one of matching size has been
+// rendered, or null so the caller falls back to the texture cache.
+SharedGLObject find_surface_texture(const SurfaceCacheState &cache, Address address, uint32_t width, uint32_t height) {
+    const SurfaceCache::const_iterator entry = cache.surfaces.find(address);
+    if (entry == cache.surfaces.end()) {
+        return SharedGLObject();
+    }
+    if ((entry->second.width != width) || (entry->second.height != height)) {
+        return SharedGLObject();
+    }
+
+    return entry->second.texture;
+}
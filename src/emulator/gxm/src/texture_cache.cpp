@@ -5,12 +5,12 @@
 #include <gxm/functions.h>
 #include <gxm/texture_cache_state.h>
 
+#include <crypto/hash.h>
+#include <mem/mem.h>
 #include <mem/ptr.h>
 #include <util/log.h>
 
-#include <algorithm> // find
 #include <cstring> // memcmp
-#include <numeric> // accumulate
 
 static size_t bits_per_pixel(SceGxmTextureBaseFormat base_format) {
     switch (base_format) {
@@ -64,8 +64,9 @@ static size_t bits_per_pixel(SceGxmTextureBaseFormat base_format) {
         return 8;
     case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P2:
     case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P3:
+        return 12; // Full-res Y plane plus quarter-res U and V.
     case SCE_GXM_TEXTURE_BASE_FORMAT_YUV422:
-        return 16; // NOTE: I'm not sure this is right.
+        return 16;
     case SCE_GXM_TEXTURE_BASE_FORMAT_P4:
         return 4;
     case SCE_GXM_TEXTURE_BASE_FORMAT_P8:
@@ -86,9 +87,7 @@ static const uint32_t *get_texture_palette(const SceGxmTexture &texture, const M
 }
 
 static TextureCacheHash hash_data(const void *data, size_t size) {
-    const uint8_t *const begin = static_cast<const uint8_t *>(data);
-    const uint8_t *const end = begin + size;
-    return std::accumulate(begin, end, TextureCacheHash(0));
+    return hash64(data, size);
 }
 
 static TextureCacheHash hash_palette_data(const SceGxmTexture &texture, size_t count, const MemState &mem) {
@@ -97,48 +96,98 @@ static TextureCacheHash hash_palette_data(const SceGxmTexture &texture, size_t c
     return palette_hash;
 }
 
-static TextureCacheHash hash_texture_data(const SceGxmTexture &texture, const MemState &mem) {
-    GXM_PROFILE(__func__);
-
-    const SceGxmTextureFormat format = texture::get_format(&texture);
-    const SceGxmTextureBaseFormat base_format = texture::get_base_format(format);
+// Number of levels in the mip chain, bounded by where the dimensions bottom out.
+static size_t texture_mip_count(const SceGxmTexture &texture) {
+    const size_t max_levels = texture.mip_count + 1;
     const size_t width = texture::get_width(&texture);
     const size_t height = texture::get_height(&texture);
+
+    size_t levels = 1;
+    while ((levels < max_levels) && (((width >> levels) > 0) || ((height >> levels) > 0))) {
+        ++levels;
+    }
+
+    return levels;
+}
+
+static size_t texture_level_data_size(const SceGxmTexture &texture, size_t width, size_t height) {
+    const SceGxmTextureFormat format = texture::get_format(&texture);
+
+    if (texture::is_compressed_format(format)) {
+        return texture::compressed_data_size(format, width, height);
+    }
+
     const size_t stride = (width + 7) & ~7; // NOTE: This is correct only with linear textures.
-    const size_t bpp = bits_per_pixel(base_format);
-    const size_t size = (bpp * stride * height) / 8;
-    const Ptr<const void> data(texture.data_addr << 2);
-    const TextureCacheHash data_hash = hash_data(data.get(mem), size);
+    const size_t bpp = bits_per_pixel(texture::get_base_format(format));
 
-    switch (base_format) {
+    return (bpp * stride * height) / 8;
+}
+
+// Size of the whole mip chain, as stored in guest memory.
+static size_t texture_data_size(const SceGxmTexture &texture) {
+    const size_t levels = texture_mip_count(texture);
+    size_t width = texture::get_width(&texture);
+    size_t height = texture::get_height(&texture);
+
+    size_t size = 0;
+    for (size_t level = 0; level < levels; ++level) {
+        size += texture_level_data_size(texture, width, height);
+        width = (width > 1) ? (width >> 1) : 1;
+        height = (height > 1) ? (height >> 1) : 1;
+    }
+
+    return size;
+}
+
+// Palette entry count, or zero for non-paletted formats.
+static size_t texture_palette_count(const SceGxmTexture &texture) {
+    const SceGxmTextureFormat format = texture::get_format(&texture);
+    switch (texture::get_base_format(format)) {
     case SCE_GXM_TEXTURE_BASE_FORMAT_P4:
-        return data_hash ^ hash_palette_data(texture, 16, mem);
+        return 16;
     case SCE_GXM_TEXTURE_BASE_FORMAT_P8:
-        return data_hash ^ hash_palette_data(texture, 256, mem);
+        return 256;
     default:
-        return data_hash;
+        return 0;
     }
 }
 
-static const bool operator==(const SceGxmTexture &a, const SceGxmTexture &b) {
-    return memcmp(&a, &b, sizeof(a)) == 0;
+static TextureCacheHash hash_texture_data(const SceGxmTexture &texture, const MemState &mem) {
+    GXM_PROFILE(__func__);
+
+    const Ptr<const void> data(texture.data_addr << 2);
+    const TextureCacheHash data_hash = hash_data(data.get(mem), texture_data_size(texture));
+
+    const size_t palette_count = texture_palette_count(texture);
+    if (palette_count > 0) {
+        return data_hash ^ hash_palette_data(texture, palette_count, mem);
+    }
+
+    return data_hash;
 }
 
-static size_t find_lru(const TextureCacheTimestamps &timestamps, TextureCacheTimestamp current_time) {
-    GXM_PROFILE(__func__);
+// Arms write tracking on the pages backing the texture (and its palette) so
+// the next bind can tell whether a re-hash is needed at all.
+static void track_texture_memory(const SceGxmTexture &texture, MemState &mem) {
+    track_writes(mem, texture.data_addr << 2, texture_data_size(texture));
 
-    uint64_t oldest_age = current_time - timestamps.front();
-    size_t oldest_index = 0;
+    const size_t palette_count = texture_palette_count(texture);
+    if (palette_count > 0) {
+        track_writes(mem, texture.palette_addr << 6, palette_count * sizeof(uint32_t));
+    }
+}
 
-    for (size_t index = 1; index < timestamps.size(); ++index) {
-        const uint64_t age = current_time - timestamps[index];
-        if (age > oldest_age) {
-            oldest_age = age;
-            oldest_index = index;
-        }
+static bool texture_written_since(const SceGxmTexture &texture, const MemState &mem, uint64_t generation) {
+    if (range_written_since(mem, texture.data_addr << 2, texture_data_size(texture), generation)) {
+        return true;
     }
 
-    return oldest_index;
+    const size_t palette_count = texture_palette_count(texture);
+    return (palette_count > 0) && range_written_since(mem, texture.palette_addr << 6, palette_count * sizeof(uint32_t), generation);
+}
+
+static const bool operator==(const SceGxmTexture &a, const SceGxmTexture &b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
 }
 
 static void configure_bound_texture(const SceGxmTexture &gxm_texture) {
@@ -149,116 +198,276 @@ static void configure_bound_texture(const SceGxmTexture &gxm_texture) {
     const SceGxmTextureAddrMode vaddr = (SceGxmTextureAddrMode)(gxm_texture.vaddr_mode);
     const GLenum *const swizzle = texture::translate_swizzle(fmt);
 
-    // TODO Support mip-mapping.
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    GLenum min_filter = texture::translate_minmag_filter((SceGxmTextureFilter)gxm_texture.min_filter);
+    if (gxm_texture.mip_filter && (texture_mip_count(gxm_texture) > 1)) {
+        min_filter = (min_filter == GL_LINEAR) ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR;
+    }
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texture::translate_wrap_mode(uaddr));
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texture::translate_wrap_mode(vaddr));
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture::translate_minmag_filter((SceGxmTextureFilter)gxm_texture.min_filter));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_filter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture::translate_minmag_filter((SceGxmTextureFilter)gxm_texture.mag_filter));
     glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
 
-    const GLenum internal_format = texture::translate_internal_format(fmt);
-    const unsigned int width = texture::get_width(&gxm_texture);
-    const unsigned int height = texture::get_height(&gxm_texture);
-    const GLenum format = texture::translate_format(fmt);
-    const GLenum type = texture::translate_type(fmt);
-
-    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, type, nullptr);
+    // Storage for each level is allocated at upload, where the data is at
+    // hand; GL_TEXTURE_MAX_LEVEL tracks how much of the chain is resident.
 }
 
-static void upload_bound_texture(const SceGxmTexture &gxm_texture, const MemState &mem) {
+static void upload_bound_texture_level(TextureCacheState &cache, const SceGxmTexture &gxm_texture, const MemState &mem, size_t level, unsigned int width, unsigned int height, const uint8_t *texture_data) {
     GXM_PROFILE(__func__);
 
     const SceGxmTextureFormat fmt = texture::get_format(&gxm_texture);
-    const unsigned int width = texture::get_width(&gxm_texture);
-    const unsigned int height = texture::get_height(&gxm_texture);
-    const Ptr<const uint8_t> data(gxm_texture.data_addr << 2);
-    const uint8_t *const texture_data = data.get(mem);
-    std::vector<uint32_t> palette_texture_pixels; // TODO Move to context to avoid frequent allocation?
+    std::vector<uint32_t> rgba_texture_pixels; // TODO Move to context to avoid frequent allocation?
+    std::vector<uint8_t> detiled_texture_pixels; // TODO Move to context to avoid frequent allocation?
+
+    const uint32_t texture_type = gxm_texture.type << 29;
+    const size_t bpp = bits_per_pixel(texture::get_base_format(fmt));
+    const bool compressed = texture::is_compressed_format(fmt);
 
     const void *pixels = nullptr;
     size_t stride = 0;
-    if (texture::is_paletted_format(fmt)) {
+    size_t upload_size = 0;
+    if (compressed) {
+        // BC data uploads as-is - no CPU decode pass, and a quarter (or less)
+        // of the transfer an RGBA expansion would take.
+        // NOTE: This is correct only with linear textures.
+        pixels = texture_data;
+        upload_size = texture::compressed_data_size(fmt, width, height);
+    } else if (texture::is_paletted_format(fmt)) {
         const auto base_format = texture::get_base_format(fmt);
         const uint32_t *const palette_bytes = get_texture_palette(gxm_texture, mem);
-        palette_texture_pixels.resize(width * height);
+        rgba_texture_pixels.resize(width * height);
         if (base_format == SCE_GXM_TEXTURE_BASE_FORMAT_P8) {
-            texture::palette_texture_to_rgba_8(palette_texture_pixels.data(), texture_data, width, height, palette_bytes);
+            texture::palette_texture_to_rgba_8(rgba_texture_pixels.data(), texture_data, width, height, palette_bytes);
         } else {
-            texture::palette_texture_to_rgba_4(palette_texture_pixels.data(), texture_data, width, height, palette_bytes);
+            texture::palette_texture_to_rgba_4(rgba_texture_pixels.data(), texture_data, width, height, palette_bytes);
         }
-        pixels = palette_texture_pixels.data();
+        pixels = rgba_texture_pixels.data();
         stride = width;
+        upload_size = width * height * sizeof(uint32_t);
+    } else if (texture::is_yuv_format(fmt)) {
+        // Expand video planes to RGBA. A shader-side conversion would skip
+        // this pass, but our fragment GLSL comes from a fixed database.
+        const auto base_format = texture::get_base_format(fmt);
+        rgba_texture_pixels.resize(width * height);
+        if (base_format == SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P2) {
+            const uint8_t *const uv_plane = texture_data + width * height;
+            texture::yuv420_texture_to_rgba(rgba_texture_pixels.data(), texture_data, uv_plane, uv_plane + 1, width, height, 2);
+        } else if (base_format == SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P3) {
+            const uint8_t *const u_plane = texture_data + width * height;
+            const uint8_t *const v_plane = u_plane + (width / 2) * (height / 2);
+            texture::yuv420_texture_to_rgba(rgba_texture_pixels.data(), texture_data, u_plane, v_plane, width, height, 1);
+        } else {
+            texture::yuv422_texture_to_rgba(rgba_texture_pixels.data(), texture_data, width, height);
+        }
+        pixels = rgba_texture_pixels.data();
+        stride = width;
+        upload_size = width * height * sizeof(uint32_t);
+    } else if ((texture_type == SCE_GXM_TEXTURE_SWIZZLED || texture_type == SCE_GXM_TEXTURE_TILED) && ((bpp % 8) == 0)) {
+        // Resolve the GPU layout into a linear staging buffer.
+        // TODO Paletted and sub-byte formats still upload as if linear.
+        const size_t bytes_per_pixel = bpp / 8;
+        detiled_texture_pixels.resize(width * height * bytes_per_pixel);
+        if (texture_type == SCE_GXM_TEXTURE_SWIZZLED) {
+            texture::untwiddle(detiled_texture_pixels.data(), texture_data, width, height, bytes_per_pixel);
+        } else {
+            texture::detile(detiled_texture_pixels.data(), texture_data, width, height, bytes_per_pixel);
+        }
+        pixels = detiled_texture_pixels.data();
+        stride = width;
+        upload_size = width * height * bytes_per_pixel;
     } else {
         pixels = texture_data;
         stride = (width + 7) & ~7; // NOTE: This is correct only with linear textures.
+        upload_size = texture_level_data_size(gxm_texture, width, height);
     }
 
-    const GLenum format = texture::translate_format(fmt);
-    const GLenum type = texture::translate_type(fmt);
+    // Stage through the next pixel buffer in the ring so the driver DMAs out
+    // of it asynchronously instead of copying inside glTexSubImage2D.
+    // Orphaning keeps the previous upload's transfer out of our way.
+    cache.upload_buffer_index = (cache.upload_buffer_index + 1) % TextureUploadRingSize;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, cache.upload_buffers[cache.upload_buffer_index]);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(upload_size), nullptr, GL_STREAM_DRAW);
+    void *const staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(upload_size), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (staging != nullptr) {
+        memcpy(staging, pixels, upload_size);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        pixels = nullptr; // Offset zero into the bound buffer.
+    } else {
+        // The driver refused the mapping - upload synchronously.
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    if (compressed) {
+        const GLenum internal_format = texture::translate_compressed_internal_format(fmt);
+        glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), internal_format, width, height, 0, static_cast<GLsizei>(upload_size), pixels);
+    } else {
+        const GLenum internal_format = texture::translate_internal_format(fmt);
+        const GLenum format = texture::translate_format(fmt);
+        const GLenum type = texture::translate_type(fmt);
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, stride);
+        glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), internal_format, width, height, 0, format, type, pixels);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
 
-    glPixelStorei(GL_UNPACK_ROW_LENGTH, stride);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, type, pixels);
-    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    if (staging != nullptr) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+}
+
+// Uploads the mip chain from base_level on, stopping early once the per-scene
+// upload budget is spent so a burst of arrivals is spread over several frames.
+// Returns the number of levels now resident.
+static size_t upload_bound_texture(TextureCacheState &cache, const SceGxmTexture &gxm_texture, const MemState &mem, size_t base_level) {
+    GXM_PROFILE(__func__);
+
+    const Ptr<const uint8_t> data(gxm_texture.data_addr << 2);
+    const uint8_t *level_data = data.get(mem);
+    const size_t levels = texture_mip_count(gxm_texture);
+
+    // A fresh timestamp opens a fresh budget.
+    if (cache.upload_budget_timestamp != cache.timestamp) {
+        cache.upload_budget_timestamp = cache.timestamp;
+        cache.upload_bytes_this_scene = 0;
+    }
+
+    unsigned int width = texture::get_width(&gxm_texture);
+    unsigned int height = texture::get_height(&gxm_texture);
+    size_t resident = base_level;
+    for (size_t level = 0; level < levels; ++level) {
+        const size_t level_size = texture_level_data_size(gxm_texture, width, height);
+        if (level >= base_level) {
+            // Level 0 is never deferred - a texture with no data at all is
+            // worse than one with no mips yet.
+            if ((level > 0) && (cache.upload_bytes_this_scene >= cache.upload_budget_per_scene)) {
+                break;
+            }
+            upload_bound_texture_level(cache, gxm_texture, mem, level, width, height, level_data);
+            cache.upload_bytes_this_scene += level_size;
+            cache.statistics.bytes_uploaded += level_size;
+            resident = level + 1;
+        }
+        level_data += level_size;
+        width = (width > 1) ? (width >> 1) : 1;
+        height = (height > 1) ? (height >> 1) : 1;
+    }
+
+    // Sample only the resident part of the chain so a partially streamed
+    // texture never shows unwritten levels.
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(resident - 1));
+
+    return resident;
 }
 
 bool init(TextureCacheState &cache) {
-    return cache.textures.init(&glGenTextures, &glDeleteTextures);
+    return cache.textures.init(&glGenTextures, &glDeleteTextures) && cache.upload_buffers.init(&glGenBuffers, &glDeleteBuffers);
 }
 
-void cache_and_bind_texture(TextureCacheState &cache, const SceGxmTexture &gxm_texture, const MemState &mem, bool enabled) {
+GLuint cache_and_bind_texture(TextureCacheState &cache, const SceGxmTexture &gxm_texture, MemState &mem, bool enabled, GLuint bound_texture) {
     GXM_PROFILE(__func__);
 
     if (!enabled) {
         glBindTexture(GL_TEXTURE_2D, cache.textures[0]);
         configure_bound_texture(gxm_texture);
-        upload_bound_texture(gxm_texture, mem);
-        return;
+        upload_bound_texture(cache, gxm_texture, mem, 0);
+        return cache.textures[0];
     }
 
     size_t index = 0;
     bool configure = false;
     bool upload = false;
-    // TODO Palettes are probably quicker to hash than texture data, so if we find games use palette animation this could be optimised:
-    // Skip data hash if palette hashes differ.
-    const TextureCacheHash hash = hash_texture_data(gxm_texture, mem);
+
+    ++cache.statistics.lookups;
+
+    // One machine-readable line every ~10s of scenes, for charting cache
+    // efficiency across titles.
+    if (cache.timestamp - cache.statistics.last_report_timestamp >= 600) {
+        cache.statistics.last_report_timestamp = cache.timestamp;
+        LOG_INFO("texture_cache t={} lookups={} hits={} rehashes={} uploads={} evictions={} bytes_hashed={} bytes_uploaded={}",
+            cache.timestamp, cache.statistics.lookups, cache.statistics.hits, cache.statistics.rehashes,
+            cache.statistics.uploads, cache.statistics.evictions, cache.statistics.bytes_hashed, cache.statistics.bytes_uploaded);
+    }
 
     // Try to find GXM texture in cache.
-    const TextureCacheGxmTextures::const_iterator gxm_begin = cache.gxm_textures.cbegin();
-    const TextureCacheGxmTextures::const_iterator gxm_end = gxm_begin + cache.used;
-    const TextureCacheGxmTextures::const_iterator cached_gxm_texture = std::find(gxm_begin, gxm_end, gxm_texture);
-    if (cached_gxm_texture == gxm_end) {
+    const uint64_t key = hash64(&gxm_texture, sizeof(gxm_texture));
+    const TextureCacheIndex::const_iterator cached = cache.index.find(key);
+    bool replace = (cached == cache.index.end());
+    if (!replace) {
+        index = cached->second;
+        // Guard against a control-word hash collision mapping to a slot
+        // holding a different texture.
+        replace = !(cache.gxm_textures[index] == gxm_texture);
+    }
+
+    if (replace) {
         // Texture not found in cache.
-        if (cache.used < TextureCacheSize) {
+        if (cached != cache.index.end()) {
+            // Collision - reuse the colliding slot.
+        } else if (cache.used < TextureCacheSize) {
             // Cache is not full. Add texture to cache.
             index = cache.used;
             ++cache.used;
+            cache.lru.push_front(index);
+            cache.lru_positions[index] = cache.lru.begin();
         } else {
-            // Cache is full. Find least recently used texture.
-            index = find_lru(cache.timestamps, cache.timestamp);
-            LOG_DEBUG("Evicting texture {} (t = {}) from cache. Current t = {}.", index, cache.timestamps[index], cache.timestamp);
+            // Cache is full. Evict the least recently used texture.
+            index = cache.lru.back();
+            LOG_DEBUG("Evicting texture {} from cache. Current t = {}.", index, cache.timestamp);
+            ++cache.statistics.evictions;
+            cache.index.erase(hash64(&cache.gxm_textures[index], sizeof(SceGxmTexture)));
         }
         configure = true;
         upload = true;
         cache.gxm_textures[index] = gxm_texture;
+        cache.index[key] = index;
+        cache.generations[index] = current_write_generation(mem);
+        cache.hashes[index] = hash_texture_data(gxm_texture, mem);
+        cache.statistics.bytes_hashed += texture_data_size(gxm_texture);
+        track_texture_memory(gxm_texture, mem);
     } else {
-        // Texture is cached.
-        index = cached_gxm_texture - gxm_begin;
+        // Texture is cached. Only re-hash when pages backing it were
+        // actually written since the entry was last validated.
         configure = false;
-        upload = (hash != cache.hashes[index]);
+        if (texture_written_since(gxm_texture, mem, cache.generations[index])) {
+            // Snapshot the generation before hashing so a write that lands
+            // mid-hash is caught on the next bind.
+            const uint64_t generation = current_write_generation(mem);
+            const TextureCacheHash hash = hash_texture_data(gxm_texture, mem);
+            ++cache.statistics.rehashes;
+            cache.statistics.bytes_hashed += texture_data_size(gxm_texture);
+            upload = (hash != cache.hashes[index]);
+            cache.hashes[index] = hash;
+            cache.generations[index] = generation;
+            track_texture_memory(gxm_texture, mem); // a fault disarms the page it hits
+        }
+        if (!upload) {
+            ++cache.statistics.hits;
+        }
     }
 
+    // Touch the entry: move it to the recently-used end of the list.
+    cache.lru.splice(cache.lru.begin(), cache.lru, cache.lru_positions[index]);
+
     const GLuint gl_texture = cache.textures[index];
+    const bool stream = !upload && (cache.mip_levels[index] < texture_mip_count(gxm_texture));
+
+    // A pure hit on the texture the unit already has bound needs no GL work.
+    if ((gl_texture == bound_texture) && !configure && !upload && !stream) {
+        return gl_texture;
+    }
     glBindTexture(GL_TEXTURE_2D, gl_texture);
 
     if (configure) {
         configure_bound_texture(gxm_texture);
     }
     if (upload) {
-        upload_bound_texture(gxm_texture, mem);
-        cache.hashes[index] = hash;
+        ++cache.statistics.uploads;
+        cache.mip_levels[index] = upload_bound_texture(cache, gxm_texture, mem, 0);
+    } else if (stream) {
+        // Continue streaming a mip chain that ran out of budget earlier.
+        cache.mip_levels[index] = upload_bound_texture(cache, gxm_texture, mem, cache.mip_levels[index]);
     }
 
-    cache.timestamps[index] = cache.timestamp;
+    return gl_texture;
 }
@@ -2,6 +2,8 @@
 
 #include <util/log.h>
 
+#include <glbinding/gl/enum.h> // S3TC enums are extensions, not in gl41core.
+
 // SceGxmTextureSwizzle1Mode
 static const GLenum swizzle_r[4] = { GL_RED, GL_ZERO, GL_ZERO, GL_ONE };
 static const GLenum swizzle_000r[4] = { GL_RED, GL_ZERO, GL_ZERO, GL_ZERO };
@@ -199,6 +201,28 @@ namespace texture {
         return base_format == SCE_GXM_TEXTURE_BASE_FORMAT_P8 || base_format == SCE_GXM_TEXTURE_BASE_FORMAT_P4;
     }
 
+    bool is_yuv_format(SceGxmTextureFormat src) {
+        switch (get_base_format(src)) {
+        case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P2:
+        case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P3:
+        case SCE_GXM_TEXTURE_BASE_FORMAT_YUV422:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool is_compressed_format(SceGxmTextureFormat src) {
+        switch (get_base_format(src)) {
+        case SCE_GXM_TEXTURE_BASE_FORMAT_UBC1:
+        case SCE_GXM_TEXTURE_BASE_FORMAT_UBC2:
+        case SCE_GXM_TEXTURE_BASE_FORMAT_UBC3:
+            return true;
+        default:
+            return false;
+        }
+    }
+
     GLenum translate_internal_format(SceGxmTextureFormat src) {
         const SceGxmTextureBaseFormat base_format = get_base_format(src);
         switch (base_format) {
@@ -424,15 +448,13 @@ namespace texture {
         case SCE_GXM_TEXTURE_BASE_FORMAT_UBC3:
             LOG_WARN("Unhandled base format SCE_GXM_TEXTURE_BASE_FORMAT_UBC3");
             return GL_BYTE;
+        // YUV formats are expanded to RGBA on upload.
         case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P2:
-            LOG_WARN("Unhandled base format SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P2");
-            return GL_BYTE;
+            return GL_UNSIGNED_INT_8_8_8_8_REV;
         case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P3:
-            LOG_WARN("Unhandled base format SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P3");
-            return GL_BYTE;
+            return GL_UNSIGNED_INT_8_8_8_8_REV;
         case SCE_GXM_TEXTURE_BASE_FORMAT_YUV422:
-            LOG_WARN("Unhandled base format SCE_GXM_TEXTURE_BASE_FORMAT_YUV422");
-            return GL_BYTE;
+            return GL_UNSIGNED_INT_8_8_8_8_REV;
         case SCE_GXM_TEXTURE_BASE_FORMAT_P4:
             return GL_UNSIGNED_INT_8_8_8_8_REV;
         case SCE_GXM_TEXTURE_BASE_FORMAT_P8:
@@ -522,4 +544,30 @@ namespace texture {
             return translate_swizzle(static_cast<SceGxmTextureSwizzleYUV422Mode>(swizzle));
         }
     }
+
+    GLenum translate_compressed_internal_format(SceGxmTextureFormat src) {
+        // UBC1/2/3 are BC1/2/3, which desktop GL exposes as the S3TC DXT
+        // formats. EXT_texture_compression_s3tc is ubiquitous on the hardware
+        // that can run us, so no decode pass is needed.
+        switch (get_base_format(src)) {
+        case SCE_GXM_TEXTURE_BASE_FORMAT_UBC1:
+            return gl::GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case SCE_GXM_TEXTURE_BASE_FORMAT_UBC2:
+            return gl::GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+        case SCE_GXM_TEXTURE_BASE_FORMAT_UBC3:
+            return gl::GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        default:
+            LOG_WARN("Unhandled compressed base format {}", log_hex(get_base_format(src)));
+            return gl::GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        }
+    }
+
+    size_t compressed_data_size(SceGxmTextureFormat src, size_t width, size_t height) {
+        // BC encodes 4x4 blocks: 8 bytes per block for BC1, 16 for BC2/3.
+        const size_t block_size = (get_base_format(src) == SCE_GXM_TEXTURE_BASE_FORMAT_UBC1) ? 8 : 16;
+        const size_t blocks_x = (width + 3) / 4;
+        const size_t blocks_y = (height + 3) / 4;
+
+        return blocks_x * blocks_y * block_size;
+    }
 } // namespace texture
@@ -19,6 +19,7 @@
 
 #include <glbinding/gl/types.h>
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -57,8 +58,14 @@ enum class AppRunType {
     Extracted,
     /// Zipped in HENKaku-style .vpk file
     Vpk,
+    /// .vpk left in place and read directly from the archive
+    VpkStream,
 };
 
+/// Called as extraction proceeds, with the number of archive entries
+/// finished so far out of the total. Invoked from the installing thread.
+typedef std::function<void(size_t entries_done, size_t entries_total)> InstallProgressCallback;
+
 void error_dialog(const std::string &message, SDL_Window *window = nullptr);
 ExitCode load_app(Ptr<const void> &entry_point, HostState &host, const std::wstring &path, AppRunType run_type);
 ExitCode run_app(HostState &host, Ptr<const void> &entry_point);
@@ -42,3 +42,18 @@ namespace emu {
         uint8_t reserved[36];
     };
 };
+
+// Cached save-slot metadata, keyed by slot id. Nothing but our own
+// SceAppUtil exports touches the SlotParam files, so entries stay valid
+// until one of those writes invalidates them - steady-state slot queries
+// from autosaving titles never reach the filesystem. A negative entry
+// caches "slot not found" the same way.
+struct SaveDataSlotEntry {
+    bool exists = false;
+    SceAppUtilSaveDataSlotParam param = {};
+};
+
+struct SaveDataSlotCache {
+    std::mutex mutex;
+    std::map<unsigned int, SaveDataSlotEntry> slots;
+};
@@ -0,0 +1,38 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <glutil/gl.h>
+
+#include <cstdint>
+
+// Guest display pixel format -> GL unpack description. Every format the
+// display accepts has an unpack type the GPU consumes directly from guest
+// memory, so presents never pay a CPU conversion pass regardless of the
+// format a title sets through sceDisplaySetFrameBuf.
+struct DisplayFormatGL {
+    GLenum internal_format;
+    GLenum format;
+    GLenum type;
+    uint32_t bytes_per_pixel;
+};
+
+// Fills out and returns true for formats the present path can upload
+// directly; unknown formats return false and should be rejected at
+// sceDisplaySetFrameBuf.
+bool display_format_to_gl(uint32_t pixelformat, DisplayFormatGL &out);
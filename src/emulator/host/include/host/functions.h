@@ -17,11 +17,18 @@
 
 #pragma once
 
+#include <mem/mem.h> // Address.
 #include <psp2/types.h>
 
+#include <string>
+
 struct CPUState;
+struct DisplayState;
 struct HostState;
 
 bool init(HostState &state);
 bool handle_events(HostState &host);
-void call_import(HostState &host, CPUState &cpu, uint32_t nid, SceUID thread_id);
+void notify_vblank(DisplayState &display);
+void call_import(HostState &host, CPUState &cpu, uint32_t imm, Address pc, SceUID thread_id);
+void resolve_loaded_imports(HostState &host);
+bool dump_hle_telemetry(HostState &host, const std::string &path);
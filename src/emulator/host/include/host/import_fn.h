@@ -19,9 +19,11 @@
 
 #include <psp2/types.h>
 
-#include <functional>
-
 struct CPUState;
 struct HostState;
 
-typedef std::function<void(HostState &host, CPUState &cpu, SceUID thread_id)> ImportFn;
+// A compiled marshaling trampoline - one per export, emitted by BRIDGE_IMPL
+// with the argument extraction plan baked in. A plain function pointer so a
+// call is one indirect branch, with no std::function storage or dispatch
+// behind it.
+typedef void (*ImportFn)(HostState &host, CPUState &cpu, SceUID thread_id);
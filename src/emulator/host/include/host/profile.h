@@ -0,0 +1,42 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+struct HostState;
+
+// Per-title performance profile, loaded from
+// pref_path/profiles/<TITLE_ID>.cfg when the title is known and applied
+// straight to the live state - so one title's workaround never leaks into
+// the rest of the catalog. "key = value" lines, '#' starts a comment.
+//
+// Recognised keys:
+//   display_pacing         strict | triple | unlocked
+//   resolution_multiplier  1..4
+//   texture_upload_budget_mb  per-scene texture streaming budget
+//   unlocked_speed         0 | 1
+//   turbo_multiplier       vblank rate multiplier, 1 disables
+//   auto_frame_skip        0 | 1
+//   cpu_backend            unicorn | dynarmic
+//   cpu_quantum            scheduler slice in guest instructions, 0 disables
+//   log_level              trace | debug | info | warn | error | critical | off
+//   hle_telemetry          0 | 1
+//   io_telemetry           0 | 1
+//
+// A missing file or an unknown key is not an error; every applied setting
+// is logged.
+void load_title_profile(HostState &host);
@@ -0,0 +1,38 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <string>
+
+struct HostState;
+
+// Whole-machine save states: guest memory (allocator bookkeeping plus every
+// allocated page, deflated), each thread's register file, and the fd table
+// with reopen-and-seek restore, written as one compressed stream under
+// pref_path.
+//
+// Scope: a state is restored into a running session of the same title - the
+// kernel object graph (threads, sync primitives, loaded modules) is the live
+// one, verified by thread id, and only memory, register files and file
+// cursors are rewound. Host-side GPU caches are not serialized; they key off
+// guest data and rebuild on demand after the restored memory is rendered.
+bool save_state(HostState &host, const std::string &path);
+bool load_state(HostState &host, const std::string &path);
+
+// pref_path/savestates/<title_id>.sav, creating the directory on demand.
+std::string save_state_path(HostState &host);
@@ -18,16 +18,33 @@
 #pragma once
 
 #include <glutil/shader.h>
+#include <gxm/gpu_timer_state.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 struct DisplayState;
 struct MemState;
 
+// One frame handed from the readback ring to the encoder thread. Rows are
+// bottom-up as glReadPixels delivers them; the encoder flips.
+struct CaptureFrame {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint64_t index = 0;
+    bool screenshot = false; // one-shot request rather than continuous capture
+    std::vector<uint8_t> rgba;
+};
+
 class gl_screen_renderer {
 public:
     gl_screen_renderer() {}
     ~gl_screen_renderer();
 
-    bool init(const std::string &base_path);
+    bool init(const std::string &base_path, const std::string &pref_path);
     void render(DisplayState &display, MemState &mem);
     GLuint get_screen_texture() const;
     void destroy();
@@ -48,4 +65,47 @@ private:
     GLuint m_vbo{ 0 };
     SharedGLObject m_render_shader;
     GLuint m_screen_texture{ 0 };
+
+    // Double-buffered pixel unpack ring for the frame upload. The frame is
+    // written into one buffer while the driver still reads the other, so the
+    // copy and the texture transfer overlap instead of stalling the present.
+    GLuint m_pbos[2]{ 0, 0 };
+    int m_next_pbo{ 0 };
+    uint32_t m_texture_width{ 0 };
+    uint32_t m_texture_height{ 0 };
+    uint32_t m_texture_pixelformat{ 0xffffffff }; // forces the first (re)spec
+
+    // The present runs on its own GL context, so it needs its own query
+    // objects; only the present stage of this timer is used.
+    GpuTimerState m_gpu_timer;
+
+private:
+    void capture_frame(DisplayState &display);
+    void start_encoder();
+    void stop_encoder();
+    void encoder_run();
+
+    // Pack-buffer ring for capture readback. glReadPixels targets one slot
+    // per frame and the oldest slot is mapped, so a transfer has the whole
+    // ring's worth of frames to drain before anything waits on it.
+    static constexpr int capture_ring_size = 3;
+    GLuint m_capture_pbos[capture_ring_size]{};
+    uint32_t m_capture_widths[capture_ring_size]{};
+    uint32_t m_capture_heights[capture_ring_size]{};
+    bool m_capture_pending[capture_ring_size]{};
+    bool m_capture_screenshot[capture_ring_size]{};
+    uint64_t m_capture_indices[capture_ring_size]{};
+    int m_capture_slot = 0;
+    uint64_t m_capture_frame_index = 0;
+    uint64_t m_capture_dropped = 0;
+    std::string m_capture_dir;
+
+    // Encoder thread, started on the first captured frame. The queue is
+    // bounded; when the encoder falls behind, frames are dropped rather
+    // than letting the backlog grow without limit.
+    std::thread m_encoder;
+    std::mutex m_encoder_mutex;
+    std::condition_variable m_encoder_cv;
+    std::deque<CaptureFrame> m_encoder_queue;
+    bool m_encoder_stop = false;
 };
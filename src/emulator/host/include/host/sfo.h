@@ -49,6 +49,12 @@ struct SfoFile {
     std::vector<SfoEntry> entries;
 };
 
+bool load_sfo(SfoFile &file, const uint8_t *data, size_t size);
 bool load_sfo(SfoFile &file, const std::vector<uint8_t> &data);
+
+// Maps the file read-only and parses straight from the view - no Buffer
+// copy. Falls back to a plain read if the host refuses the mapping.
+bool load_sfo_file(SfoFile &file, const std::string &host_path);
+
 bool find_data(std::string &out_data, SfoFile &file, const std::string &key);
 bool get_data(std::string &out_data, SfoFile &file, int id);
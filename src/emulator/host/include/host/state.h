@@ -21,15 +21,25 @@
 #include <ctrl/state.h>
 #include <gui/state.h>
 #include <gxm/state.h>
+#include <host/app_util.h>
+#include <host/import_fn.h>
 #include <host/sfo.h>
+#include <host/watchdog.h>
 #include <io/state.h>
 #include <kernel/state.h>
 #include <net/state.h>
 #include <psp2/display.h>
+#include <psp2/touch.h>
+
+#include <array>
 
 #include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 struct SDL_Window;
 typedef void *SDL_GLContext;
@@ -63,6 +73,33 @@ struct DisplayState {
     std::atomic<bool> abort{ false };
     std::atomic<bool> imgui_render{ true };
 
+    // Vblank prediction for the adaptive waiter: timestamp and smoothed
+    // period of the notifications, plus a generation count the spin phase
+    // watches. Written only by notify_vblank.
+    std::atomic<uint64_t> vblank_count{ 0 };
+    std::atomic<uint64_t> last_vblank_us{ 0 };
+    std::atomic<uint64_t> vblank_period_us{ 16667 };
+
+    // Speed governor. Unlocked waives the vblank wait entirely, turbo
+    // releases waiters at a multiple of the real rate off a synthetic
+    // timeline, and auto frame-skip drops host presentation - never
+    // simulation - when the window loop falls behind the vblank period.
+    std::atomic<bool> unlocked_speed{ false };
+    std::atomic<uint32_t> turbo_multiplier{ 1 };
+    std::atomic<bool> auto_frame_skip{ false };
+    std::atomic<uint64_t> synthetic_vblank_us{ 0 };
+    std::atomic<uint64_t> skipped_presents{ 0 };
+
+    // Present-stage GPU time, written by the screen renderer for the GUI.
+    // Frozen while the imgui path presents instead.
+    uint64_t present_time_last_ns = 0;
+    uint64_t present_time_avg_ns = 0;
+
+    // Capture requests, serviced by the screen renderer at present time.
+    // Screenshots queue; continuous capture writes a numbered PNG sequence.
+    std::atomic<uint32_t> screenshot_requests{ 0 };
+    std::atomic<bool> continuous_capture{ false };
+
     void set_dims(std::uint32_t image_width, std::uint32_t image_height, std::uint32_t border_width, std::uint32_t border_height) {
         image_size = { image_width, image_height };
         border_size = { border_width, border_height };
@@ -70,12 +107,71 @@ struct DisplayState {
     }
 };
 
+// Fixed-rate touch sampling. The main loop samples both panels at the
+// panel's 60 Hz timing into a small per-port ring; sceTouchPeek copies
+// recent samples, sceTouchRead blocks on the next tick via the condvar, and
+// multi-buffer reads drain consecutive samples instead of resampling.
+struct TouchState {
+    static constexpr size_t ring_size = 8;
+
+    std::mutex mutex;
+    std::condition_variable condvar;
+    uint64_t sample_seq = 0; // sequence number of the newest sample, 0 = none yet
+    uint64_t read_seq[2] = { 0, 0 }; // newest sample each port's reader consumed
+    std::array<std::array<SceTouchData, ring_size>, 2> ring = {}; // [port][seq % ring_size]
+};
+
+// Resolved target of one import stub, cached so a hot import skips both the
+// NID re-read and the resolution on every call after the first. Slots are
+// dispatched by the index in the stub's svc immediate; the PC-keyed map only
+// serves plain svc #0 sites. A deque keeps references stable while it grows.
+struct ImportCallSite {
+    uint32_t nid = 0;
+    bool resolved = false;
+    ImportFn fn = nullptr; // HLE trampoline, null for LLE imports
+    Address export_pc = 0; // LLE target, 0 for HLE imports
+};
+
+typedef std::deque<ImportCallSite> ImportSlots;
+typedef std::unordered_map<Address, ImportCallSite> ImportCallSites;
+
+// Per-import call counters for the HLE profiler. Keyed by the export name
+// literal baked into each bridge, so recording hashes a pointer rather than
+// a string. Off by default - the disabled path is a single branch per call.
+struct ImportCallStats {
+    uint64_t calls = 0;
+    uint64_t total_ns = 0;
+    uint64_t worst_ns = 0;
+};
+
+struct HleTelemetry {
+    bool enabled = false;
+    std::mutex mutex;
+    std::unordered_map<const char *, ImportCallStats> imports;
+};
+
+// Published by the background loader thread and consumed by the imgui loop,
+// so the window keeps pumping while a title installs and loads.
+struct BootStatus {
+    std::mutex mutex;
+    std::condition_variable decision;
+    std::string stage;
+    float progress = -1.0f; // 0..1 within the stage, negative while indeterminate
+    // The loader blocks on the reinstall prompt; the UI loop draws it and
+    // posts the GenericDialogState choice back (0 = still undecided).
+    bool reinstall_pending = false;
+    int reinstall_choice = 0;
+    std::atomic<bool> done{ false };
+};
+
 struct HostState {
     std::string game_title;
     std::string base_path;
     std::string pref_path;
     size_t frame_count = 0;
+    size_t total_frame_count = 0; // never reset, for headless run limits and stats
     uint32_t sdl_ticks = 0;
+    bool headless = false; // no window, no GL context, no presentation
     WindowPtr window;
     GLContextPtr glcontext;
     MemState mem;
@@ -85,7 +181,18 @@ struct HostState {
     GxmState gxm;
     IOState io;
     NetState net;
+    HttpState http;
     DisplayState display;
+    TouchState touch;
     GuiState gui;
     SfoFile sfo_handle;
+    ImportSlots import_slots;
+    ImportCallSites import_call_sites;
+    std::mutex import_call_sites_mutex;
+    HleTelemetry hle_telemetry;
+    SaveDataSlotCache savedata_slots;
+    BootStatus boot_status;
+    // Last so its destructor joins the worker while everything it samples is
+    // still alive.
+    WatchdogState watchdog;
 };
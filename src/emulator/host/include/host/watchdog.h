@@ -0,0 +1,46 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+struct HostState;
+
+// Hang watchdog. A host worker watches the presented-frame and draw
+// counters; when neither advances for the timeout it logs a diagnostic
+// bundle - per-thread PC/LR with disassembly around each, plus every sync
+// primitive with waiters - without stopping the process, then stays quiet
+// until the title makes progress again.
+struct WatchdogState {
+    std::atomic<bool> running{ false };
+    uint32_t timeout_seconds = 0;
+    std::thread worker;
+
+    ~WatchdogState() {
+        if (worker.joinable()) {
+            running = false;
+            worker.join();
+        }
+    }
+};
+
+// Starts the watchdog once the title's threads are running. The timeout
+// defaults to 10 seconds; VITA3K_WATCHDOG_SECONDS overrides it, 0 disables.
+void start_watchdog(HostState &host);
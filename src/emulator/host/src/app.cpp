@@ -18,14 +18,20 @@
 #include <kernel/load_self.h>
 #include <kernel/state.h>
 
+#include <crypto/hash.h>
 #include <host/app.h>
 #include <host/functions.h>
+#include <host/profile.h>
 #include <host/sfo.h>
 #include <host/state.h>
 #include <host/version.h>
+#include <host/watchdog.h>
 #include <io/functions.h>
 #include <io/state.h>
 #include <kernel/thread/thread_functions.h>
+#include <kernel/thread/thread_pool.h>
+#include <util/boot_timeline.h>
+#include <util/mapped_file.h>
 #include <util/find.h>
 #include <util/fs.h>
 #include <util/log.h>
@@ -34,11 +40,16 @@
 #include <SDL.h>
 #include <glutil/gl.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdio>
 #include <cstring>
+#include <thread>
 #include <fstream>
 #include <iostream>
 #include <istream>
+#include <memory>
 #include <iterator>
 #include <sstream>
 
@@ -48,6 +59,10 @@
 // clang-format on
 #include <gui/functions.h>
 
+#ifdef __APPLE__
+#include <unistd.h>
+#endif
+
 using namespace gl;
 
 void error_dialog(const std::string &message, SDL_Window *window) {
@@ -71,7 +86,49 @@ static size_t write_to_buffer(void *pOpaque, mz_uint64 file_ofs, const void *pBu
     return n;
 }
 
+// Publishes what the loader is doing for the boot progress overlay.
+static void set_boot_stage(HostState &host, const char *stage, float progress = -1.0f) {
+    const std::lock_guard<std::mutex> lock(host.boot_status.mutex);
+    host.boot_status.stage = stage;
+    host.boot_status.progress = progress;
+}
+
+// Streams a SELF straight from its source - mounted VPK entry or extracted
+// app directory - so load_self needs no full-file staging buffer.
+static SelfReadFn open_self_source(HostState &host, const char *file) {
+    if (host.io.vpk) {
+        const auto entry = host.io.vpk->entries.find(file);
+        if ((entry == host.io.vpk->entries.end()) || entry->second.is_dir) {
+            return SelfReadFn();
+        }
+
+        VpkEntry *const vpk_entry = &entry->second;
+        IOState *const io = &host.io;
+        return [io, vpk_entry](void *dst, size_t size, uint64_t offset) {
+            return vpk_read(*io, *vpk_entry, dst, static_cast<SceSize>(size), static_cast<int64_t>(offset)) == static_cast<int>(size);
+        };
+    }
+
+    const std::string file_path = host.pref_path + "ux0/app/" + host.io.title_id + "/" + file;
+    const auto stream = std::make_shared<std::ifstream>(file_path, std::ifstream::binary);
+    if (stream->fail()) {
+        return SelfReadFn();
+    }
+
+    return [stream](void *dst, size_t size, uint64_t offset) {
+        stream->clear();
+        stream->seekg(offset);
+        stream->read(static_cast<char *>(dst), size);
+        return !stream->fail();
+    };
+}
+
 bool read_file_from_disk(Buffer &buf, const char *file, HostState &host) {
+    // A streamed VPK holds the app files; nothing was extracted to disk.
+    if (host.io.vpk && read_mounted_file(buf, host.io, file)) {
+        return true;
+    }
+
     std::string file_path = host.pref_path + "ux0/app/" + host.io.title_id + "/" + file;
     std::ifstream f(file_path, std::ifstream::binary);
     if (f.fail()) {
@@ -102,7 +159,96 @@ static bool read_file_from_zip(Buffer &buf, FILE *&vpk_fp, const char *file, con
     return true;
 }
 
-bool install_vpk(Ptr<const void> &entry_point, HostState &host, const std::wstring &path) {
+// Makes output_path a hard link to the store file, falling back to a byte
+// copy on filesystems without hard links. Any previous install of the file
+// is removed first so the link never fails on an existing name.
+static bool link_from_store(const std::string &store_path, const std::string &output_path) {
+    fs::remove(output_path);
+
+#ifdef __APPLE__
+    if (::link(store_path.c_str(), output_path.c_str()) == 0) {
+        return true;
+    }
+#else
+    std::error_code err;
+    fs::create_hard_link(store_path, output_path, err);
+    if (!err) {
+        return true;
+    }
+#endif
+
+    std::ifstream src(store_path, std::ifstream::binary);
+    std::ofstream dst(output_path, std::ofstream::binary | std::ofstream::trunc);
+    dst << src.rdbuf();
+    return src.good() && dst.good();
+}
+
+// Moves a freshly extracted temp file into the content-addressed store and
+// links it into the install tree. Regional versions and updates of a title
+// share most of their files byte for byte; storing each distinct content
+// once means those installs cost one set of disk blocks and one set of host
+// page-cache pages between them.
+static bool store_and_link(const std::string &store_root, const std::string &temp_path, const std::string &output_path) {
+    MappedFile temp;
+    if (!temp.open(temp_path)) {
+        return false;
+    }
+
+    const Sha256HashText digest = hex(sha256(temp.data(), temp.size()));
+    temp.close();
+    const std::string store_path = store_root + digest.data();
+
+    std::ifstream probe(store_path, std::ifstream::binary);
+    if (probe.good()) {
+        // Already stored by an earlier install (or a sibling worker) -
+        // the temp copy is redundant.
+        fs::remove(temp_path);
+    } else if (::rename(temp_path.c_str(), store_path.c_str()) != 0) {
+        // Lost a rename race; the winner's file has the same content.
+        fs::remove(temp_path);
+    }
+
+    return link_from_store(store_path, output_path);
+}
+
+// Mounts the VPK in place instead of extracting it: the central directory is
+// indexed once and io resolves ux0:app reads straight from the archive, so
+// first launch skips the extraction pass entirely.
+static bool mount_vpk(HostState &host, const std::wstring &path) {
+    FILE *vpk_fp;
+
+#ifdef WIN32
+    if (_wfopen_s(&vpk_fp, path.c_str(), L"rb")) {
+#else
+    if (!(vpk_fp = fopen(wide_to_utf(path).c_str(), "rb"))) {
+#endif
+        LOG_CRITICAL("Failed to open the vpk.");
+        return false;
+    }
+
+    if (!init_vpk_mount(host.io, vpk_fp)) {
+        fclose(vpk_fp);
+        return false;
+    }
+
+    Buffer params;
+    if (!read_mounted_file(params, host.io, "sce_sys/param.sfo")) {
+        LOG_CRITICAL("Failed to read param.sfo from the vpk.");
+        return false;
+    }
+
+    SfoFile sfo_handle;
+    load_sfo(sfo_handle, params);
+    find_data(host.io.title_id, sfo_handle, "TITLE_ID");
+
+    std::string savedata_path = host.pref_path + "ux0/user/00/savedata/" + host.io.title_id;
+    fs::create_directory(savedata_path);
+
+    LOG_INFO("{} mounted from vpk", host.io.title_id);
+    return true;
+}
+
+bool install_vpk(Ptr<const void> &entry_point, HostState &host, const std::wstring &path, const InstallProgressCallback &progress) {
     const ZipPtr zip(new mz_zip_archive, delete_zip);
     std::memset(zip.get(), 0, sizeof(*zip));
 
@@ -155,25 +301,30 @@ bool install_vpk(Ptr<const void> &entry_point, HostState &host, const std::wstri
     title_base_path += host.io.title_id;
     bool created = fs::create_directory(title_base_path);
     if (!created) {
-        GenericDialogState status = UNK_STATE;
-        while (handle_events(host) && (status == 0)) {
-            ImGui_ImplSdlGL3_NewFrame(host.window.get());
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            DrawUI(host);
-            DrawReinstallDialog(host, &status);
-            glViewport(0, 0, static_cast<int>(ImGui::GetIO().DisplaySize.x), static_cast<int>(ImGui::GetIO().DisplaySize.y));
-            ImGui::Render();
-            ImGui_ImplSdlGL3_RenderDrawData(ImGui::GetDrawData());
-            SDL_GL_SwapWindow(host.window.get());
+        // The loader runs off the UI thread and cannot draw the prompt
+        // itself - publish the question and block until the imgui loop
+        // posts an answer (or a negative value when the window is closed).
+        // Headless runs have nobody to answer, so they reuse the install.
+        int choice = CANCEL_STATE;
+        if (!host.headless) {
+            std::unique_lock<std::mutex> lock(host.boot_status.mutex);
+            host.boot_status.reinstall_choice = 0;
+            host.boot_status.reinstall_pending = true;
+            host.boot_status.decision.wait(lock, [&host]() { return host.boot_status.reinstall_choice != 0; });
+            choice = host.boot_status.reinstall_choice;
+            host.boot_status.reinstall_pending = false;
         }
-        if (status == CANCEL_STATE) {
+        if (choice == CANCEL_STATE) {
             LOG_INFO("{} already installed, launching application...", host.io.title_id);
             return true;
-        } else if (status == UNK_STATE) {
+        } else if (choice != CONFIRM_STATE) {
             exit(0);
         }
     }
 
+    // Directories first, in order, so the workers below never race a mkdir
+    // against a file being extracted into it.
+    std::atomic<size_t> entries_done{ 0 };
     for (int i = 0; i < num_files; i++) {
         mz_zip_archive_file_stat file_stat;
         if (!mz_zip_reader_file_stat(zip.get(), i, &file_stat)) {
@@ -184,16 +335,112 @@ bool install_vpk(Ptr<const void> &entry_point, HostState &host, const std::wstri
         output_path += file_stat.m_filename;
         if (mz_zip_reader_is_file_a_directory(zip.get(), i)) {
             fs::create_directories(output_path);
+            ++entries_done;
         } else {
             const size_t slash = output_path.rfind('/');
             if (std::string::npos != slash) {
                 std::string directory = output_path.substr(0, slash);
                 fs::create_directories(directory);
             }
+        }
+    }
+
+    // Every file lands in the content-addressed store and the install tree
+    // only holds links into it, so the bytes shared between regional
+    // versions and updates of a title exist once on disk.
+    const std::string store_root = host.pref_path + "store/";
+    fs::create_directory(store_root);
+
+    // Files are divided between workers by an atomic cursor, each worker
+    // inflating through its own reader over the same archive, so extraction
+    // is bounded by disk bandwidth rather than one core's inflate speed.
+    std::atomic<int> next_file{ 0 };
+    std::atomic<bool> failed{ false };
+    std::mutex progress_mutex;
+
+    const auto extract_worker = [&]() {
+        FILE *worker_fp;
+#ifdef WIN32
+        if (_wfopen_s(&worker_fp, path.c_str(), L"rb")) {
+#else
+        if (!(worker_fp = fopen(wide_to_utf(path).c_str(), "rb"))) {
+#endif
+            failed = true;
+            return;
+        }
+
+        mz_zip_archive worker_zip;
+        std::memset(&worker_zip, 0, sizeof(worker_zip));
+        if (!mz_zip_reader_init_cfile(&worker_zip, worker_fp, 0, 0)) {
+            fclose(worker_fp);
+            failed = true;
+            return;
+        }
+
+        for (;;) {
+            const int i = next_file.fetch_add(1);
+            if ((i >= num_files) || failed) {
+                break;
+            }
+
+            mz_zip_archive_file_stat file_stat;
+            if (!mz_zip_reader_file_stat(&worker_zip, i, &file_stat)) {
+                continue;
+            }
+            if (mz_zip_reader_is_file_a_directory(&worker_zip, i)) {
+                continue; // already created above
+            }
+
+            std::string output_path = output_base_path;
+            output_path += "/";
+            output_path += file_stat.m_filename;
 
             LOG_INFO("Extracting {}", output_path);
-            mz_zip_reader_extract_to_file(zip.get(), i, output_path.c_str(), 0);
+            BootSlice extract_slice(std::string("extract ") + file_stat.m_filename, file_stat.m_uncomp_size);
+            if (file_stat.m_uncomp_size == 0) {
+                // Nothing to deduplicate; the store cannot address it anyway.
+                std::ofstream empty(output_path, std::ofstream::binary | std::ofstream::trunc);
+                if (empty.fail()) {
+                    LOG_CRITICAL("Failed to extract {}.", output_path);
+                    failed = true;
+                    break;
+                }
+            } else {
+                // Extract next to its final store location so moving it in
+                // is a rename, then link the install tree to the store.
+                const std::string temp_path = store_root + "tmp-" + host.io.title_id + "-" + std::to_string(i);
+                if (!mz_zip_reader_extract_to_file(&worker_zip, i, temp_path.c_str(), 0)
+                    || !store_and_link(store_root, temp_path, output_path)) {
+                    LOG_CRITICAL("Failed to extract {}.", output_path);
+                    fs::remove(temp_path);
+                    failed = true;
+                    break;
+                }
+            }
+
+            const size_t done = ++entries_done;
+            if (progress) {
+                const std::lock_guard<std::mutex> lock(progress_mutex);
+                progress(done, num_files);
+            }
         }
+
+        mz_zip_reader_end(&worker_zip);
+        fclose(worker_fp);
+    };
+
+    const unsigned worker_count = std::max(1u, std::min(std::thread::hardware_concurrency(), static_cast<unsigned>(num_files)));
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < worker_count; i++) {
+        workers.emplace_back(extract_worker);
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    if (failed) {
+        LOG_CRITICAL("Failed to extract the vpk.");
+        return false;
     }
 
     std::string savedata_path = host.pref_path + "ux0/user/00/savedata/" + host.io.title_id;
@@ -208,7 +455,22 @@ bool load_app_impl(Ptr<const void> &entry_point, HostState &host, const std::wst
         return InvalidApplicationPath;
 
     if (run_type == AppRunType::Vpk) {
-        if (!install_vpk(entry_point, host, path)) {
+        set_boot_stage(host, "Installing");
+        size_t last_logged_percent = 0;
+        const InstallProgressCallback progress = [&host, &last_logged_percent](size_t done, size_t total) {
+            const size_t percent = (done * 100) / total;
+            if (percent >= last_logged_percent + 10) {
+                last_logged_percent = percent - (percent % 10);
+                LOG_INFO("Installing: {}%", percent);
+            }
+            set_boot_stage(host, "Installing", static_cast<float>(done) / static_cast<float>(total));
+        };
+        if (!install_vpk(entry_point, host, path, progress)) {
+            return false;
+        }
+    } else if (run_type == AppRunType::VpkStream) {
+        set_boot_stage(host, "Mounting VPK");
+        if (!mount_vpk(host, path)) {
             return false;
         }
     } else if (run_type == AppRunType::Extracted) {
@@ -231,29 +493,67 @@ bool load_app_impl(Ptr<const void> &entry_point, HostState &host, const std::wst
     LOG_INFO("Serial: {}", host.io.title_id);
     LOG_INFO("Category: {}", category);
 
+    // The title id is known from here, so per-title tuning can override the
+    // defaults before any subsystem the settings cover does real work.
+    load_title_profile(host);
+
     init_device_paths(host.io);
 
-    Buffer eboot;
-    if (!read_file_from_disk(eboot, "eboot.bin", host)) {
+    // Open the per-title prewarm manifest and stream the files prior
+    // sessions read heavily on a pool worker, so their bytes are already in
+    // the host caches when the title first asks. The shader half of the
+    // manifest is replayed once the render context exists.
+    fs::create_directory(host.pref_path + "prewarm");
+    prewarm_log_open(host.io.prewarm, host.pref_path + "prewarm/" + host.io.title_id + ".files");
+    run_on_worker(host.kernel.thread_pool, [&host]() {
+        const BootSlice prewarm_slice("prewarm files");
+        prewarm_files(host.io, host.pref_path.c_str());
+    });
+
+    const std::string module_cache_path = host.pref_path + "modulecache";
+    fs::create_directory(module_cache_path);
+
+    const SelfReadFn eboot = open_self_source(host, "eboot.bin");
+    if (!eboot) {
         return false;
     }
 
-    Buffer libc;
-    if (read_file_from_disk(libc, "sce_module/libc.suprx", host)) {
-        if (load_self(entry_point, host.kernel, host.mem, libc.data(), "app0:sce_module/libc.suprx") == 0) {
+    const SelfReadFn libc = open_self_source(host, "sce_module/libc.suprx");
+    if (libc) {
+        set_boot_stage(host, "Loading libc.suprx");
+        if (load_self(entry_point, host.kernel, host.mem, libc, "app0:sce_module/libc.suprx", module_cache_path.c_str()) == 0) {
             LOG_INFO("LIBC loaded");
         }
     }
 
-    if (load_self(entry_point, host.kernel, host.mem, eboot.data(), "app0:eboot.bin") < 0) {
+    set_boot_stage(host, "Loading eboot.bin");
+    if (load_self(entry_point, host.kernel, host.mem, eboot, "app0:eboot.bin", module_cache_path.c_str()) < 0) {
         return false;
     }
 
+    // Resolve every import written by the loads above before the first
+    // instruction runs, so no call pays first-call resolution.
+    set_boot_stage(host, "Resolving imports");
+    {
+        const BootSlice resolve_slice("resolve imports");
+        resolve_loaded_imports(host);
+    }
+
     return true;
 }
 
 ExitCode load_app(Ptr<const void> &entry_point, HostState &host, const std::wstring &path, AppRunType run_type) {
-    if (!load_app_impl(entry_point, host, path, run_type)) {
+    const bool loaded = load_app_impl(entry_point, host, path, run_type);
+
+    // Boot is over either way - drop the timeline next to the caches so a
+    // perf regression report can attach the trace and diff it between
+    // builds (chrome://tracing or ui.perfetto.dev).
+    const std::string timeline_path = host.pref_path + "boot_timeline.json";
+    if (finish_boot_timeline(timeline_path)) {
+        LOG_INFO("Boot timeline written to {}.", timeline_path);
+    }
+
+    if (!loaded) {
         std::string message = "Failed to load \"";
         message += wide_to_utf(path);
         message += "\"";
@@ -266,8 +566,8 @@ ExitCode load_app(Ptr<const void> &entry_point, HostState &host, const std::wstr
 }
 
 ExitCode run_app(HostState &host, Ptr<const void> &entry_point) {
-    const CallImport call_import = [&host](CPUState &cpu, uint32_t nid, SceUID main_thread_id) {
-        ::call_import(host, cpu, nid, main_thread_id);
+    const CallImport call_import = [&host](CPUState &cpu, uint32_t imm, Address pc, SceUID main_thread_id) {
+        ::call_import(host, cpu, imm, pc, main_thread_id);
     };
 
     const SceUID main_thread_id = create_thread(entry_point, host.kernel, host.mem, host.io.title_id.c_str(), SCE_KERNEL_DEFAULT_PRIORITY_USER, SCE_KERNEL_STACK_SIZE_USER_MAIN, call_import, false);
@@ -285,6 +585,7 @@ ExitCode run_app(HostState &host, Ptr<const void> &entry_point) {
         libc_thread->to_do = ThreadToDo::exit;
         libc_thread->something_to_do.notify_all(); // TODO Should this be notify_one()?
         host.kernel.running_threads.erase(libc_thread_id);
+        release_cpu(host.kernel.cpu_pool, std::move(libc_thread->cpu));
         host.kernel.threads.erase(libc_thread_id);
     }
 
@@ -293,6 +594,10 @@ ExitCode run_app(HostState &host, Ptr<const void> &entry_point) {
         return RunThreadFailed;
     }
 
+    // The title is running from here, so a stalled frame counter means a
+    // hang rather than a slow boot.
+    start_watchdog(host);
+
     return Success;
 }
 
@@ -0,0 +1,37 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <host/display_format.h>
+
+#include <psp2/display.h>
+
+bool display_format_to_gl(uint32_t pixelformat, DisplayFormatGL &out) {
+    switch (pixelformat) {
+    case SCE_DISPLAY_PIXELFORMAT_A8B8G8R8:
+        // R in the low byte - plain RGBA bytes to GL.
+        out = { GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4 };
+        return true;
+#ifdef SCE_DISPLAY_PIXELFORMAT_A2B10G10R10
+    // Only in newer vita-headers; lights up when the submodule has it.
+    case SCE_DISPLAY_PIXELFORMAT_A2B10G10R10:
+        out = { GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV, 4 };
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
@@ -25,12 +25,18 @@
 #include <audio/functions.h>
 #include <cpu/functions.h>
 #include <glutil/gl.h>
+#include <glutil/gl_debug.h>
+#include <gxm/shaders_db.h>
 #include <io/functions.h>
 #include <kernel/functions.h>
+#include <kernel/thread/thread_pool.h>
 #include <kernel/thread/thread_state.h>
+#include <mem/ptr.h>
 #include <nids/functions.h>
 #include <rtc/rtc.h>
+#include <util/boot_timeline.h>
 #include <util/lock_and_find.h>
+#include <util/trace.h>
 #include <util/log.h>
 
 #include <SDL_events.h>
@@ -40,11 +46,21 @@
 #include <glbinding-aux/types_to_string.h>
 #include <glbinding/Binding.h>
 #include <microprofile.h>
+#include <miniz.h>
 
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
 #include <sstream>
+#include <vector>
 
 // clang-format off
 #include <imgui.h>
@@ -69,27 +85,59 @@ static const bool LOG_IMPORT_CALLS = false;
 #include <nids/nids.h>
 #undef NID
 
-static ImportFn resolve_import(uint32_t nid) {
-    switch (nid) {
-#define NID(name, nid) \
-    case nid:          \
-        return import_##name;
-#include <nids/nids.h>
+// Flat tables over the build-time-sorted NID list: one contiguous array of
+// keys and a parallel array of bridges, built entirely at compile time.
+static constexpr uint32_t import_nids[] = {
+#define NID(name, nid) nid,
+#include <nids/sorted_nids.h>
+#undef NID
+};
+
+static constexpr const ImportFn *const import_fns[] = {
+#define NID(name, nid) &import_##name,
+#include <nids/sorted_nids.h>
 #undef NID
+};
+
+static constexpr size_t import_nid_count = sizeof(import_nids) / sizeof(import_nids[0]);
+
+static ImportFn resolve_import(uint32_t nid) {
+    // Branch-free lower bound - each halving step compiles to a conditional
+    // move and touches one cache line of the key array, so the only
+    // unpredictable branch in a lookup is the final equality check.
+    const uint32_t *base = import_nids;
+    size_t n = import_nid_count;
+    while (n > 1) {
+        const size_t half = n / 2;
+        base = (base[half - 1] < nid) ? (base + half) : base;
+        n -= half;
     }
 
-    return ImportFn();
+    if (*base != nid) {
+        return ImportFn();
+    }
+    return *import_fns[base - import_nids];
 }
 
+// Debug-only fallback when KHR_debug is unavailable (4.1 core on macOS):
+// every per-call glGetError is a pipeline flush, so release builds never
+// set this and install no checking at all.
+static bool check_gl_errors = false;
+
 void before_callback(const glbinding::FunctionCall &fn) {
 #if MICROPROFILE_ENABLED
     const MicroProfileToken token = MicroProfileGetToken("OpenGL", fn.function->name(), MP_CYAN, MicroProfileTokenTypeCpu);
     MICROPROFILE_ENTER_TOKEN(token);
 #endif // MICROPROFILE_ENABLED
+    gl_call_begin();
 }
 
 void after_callback(const glbinding::FunctionCall &fn) {
     MICROPROFILE_LEAVE();
+    gl_call_end(fn.function->name());
+    if (!check_gl_errors) {
+        return;
+    }
     for (GLenum error = glGetError(); error != GL_NO_ERROR; error = glGetError()) {
         std::stringstream gl_error;
         gl_error << error;
@@ -98,55 +146,293 @@ void after_callback(const glbinding::FunctionCall &fn) {
     }
 }
 
-bool init(HostState &state) {
-    const std::unique_ptr<char, void (&)(void *)> base_path(SDL_GetBasePath(), SDL_free);
-    const std::unique_ptr<char, void (&)(void *)> pref_path(SDL_GetPrefPath(org_name, app_name), SDL_free);
+// One cached game-list entry: the title shown in the selector plus the
+// size and mtime of the param.sfo it came from, for invalidation.
+struct CachedTitle {
+    uint64_t sfo_size = 0;
+    uint64_t sfo_mtime = 0;
+    std::string title;
+};
 
-    const ResumeAudioThread resume_thread = [&state](SceUID thread_id) {
-        const ThreadStatePtr thread = lock_and_find(thread_id, state.kernel.threads, state.kernel.mutex);
-        const std::lock_guard<std::mutex> lock(thread->mutex);
-        if (thread->to_do == ThreadToDo::wait) {
-            thread->to_do = ThreadToDo::run;
-        }
-        thread->something_to_do.notify_all();
-    };
+static bool stat_file(const std::string &path, uint64_t &size, uint64_t &mtime) {
+#ifdef WIN32
+    WIN32_FILE_ATTRIBUTE_DATA attrs;
+    if (!GetFileAttributesExW(utf_to_wide(path).c_str(), GetFileExInfoStandard, &attrs)) {
+        return false;
+    }
+    size = (static_cast<uint64_t>(attrs.nFileSizeHigh) << 32) | attrs.nFileSizeLow;
+    mtime = (static_cast<uint64_t>(attrs.ftLastWriteTime.dwHighDateTime) << 32) | attrs.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat sb;
+    if (stat(path.c_str(), &sb) != 0) {
+        return false;
+    }
+    size = sb.st_size;
+    mtime = sb.st_mtime;
+#endif
+    return true;
+}
 
-    state.base_path = base_path.get();
-    state.pref_path = pref_path.get();
-    state.display.set_dims(DEFAULT_RES_WIDTH, DEFAULT_RES_HEIGHT, WINDOW_BORDER_WIDTH, WINDOW_BORDER_HEIGHT);
-    state.window = WindowPtr(SDL_CreateWindow(window_title, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, state.display.window_size.width, state.display.window_size.height, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE), SDL_DestroyWindow);
-    if (!state.window || !init(state.mem) || !init(state.audio, resume_thread) || !init(state.io, state.pref_path.c_str())) {
+// One decoded icon0.png cached in pref_path/titles.icx, keyed like the title
+// cache on the source file's size and mtime.
+struct CachedIcon {
+    uint64_t png_size = 0;
+    uint64_t png_mtime = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> rgba;
+};
+
+static bool read_file_bytes(const std::string &path, std::vector<uint8_t> &bytes) {
+    std::ifstream file(path, std::ifstream::binary | std::ifstream::ate);
+    if (!file) {
         return false;
     }
+    bytes.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(bytes.data()), bytes.size());
+    return static_cast<bool>(file);
+}
 
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+// Icons stay well under this; anything bigger is treated as corrupt rather
+// than decoded into an unbounded buffer.
+static const uint32_t MAX_ICON_DIM = 1024;
 
-    state.glcontext = GLContextPtr(SDL_GL_CreateContext(state.window.get()), SDL_GL_DeleteContext);
-    if (!state.glcontext) {
-        LOG_ERROR("Could not create OpenGL context.");
+static uint32_t png_u32(const uint8_t *bytes) {
+    return (static_cast<uint32_t>(bytes[0]) << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+}
+
+static int png_paeth(int left, int above, int corner) {
+    const int estimate = left + above - corner;
+    const int da = std::abs(estimate - left);
+    const int db = std::abs(estimate - above);
+    const int dc = std::abs(estimate - corner);
+    if ((da <= db) && (da <= dc)) {
+        return left;
+    }
+    return (db <= dc) ? above : corner;
+}
+
+// Minimal PNG reader for icon0.png - 8-bit greyscale, RGB, palette and alpha
+// variants, no interlacing. The zlib stream inside IDAT goes through the
+// miniz the emulator already links, and every format is expanded to RGBA.
+static bool decode_png(const std::vector<uint8_t> &png, uint32_t &width, uint32_t &height, std::vector<uint8_t> &rgba) {
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    if ((png.size() < 8) || (memcmp(png.data(), signature, 8) != 0)) {
         return false;
     }
 
-    // Try adaptive vsync first, falling back to regular vsync.
-    if (SDL_GL_SetSwapInterval(-1) < 0) {
-        SDL_GL_SetSwapInterval(1);
+    width = 0;
+    height = 0;
+    uint32_t color_type = 0;
+    std::vector<uint8_t> palette; // expanded to RGBA entries as it loads
+    std::vector<uint8_t> idat;
+
+    size_t pos = 8;
+    while (pos + 12 <= png.size()) {
+        const uint32_t length = png_u32(&png[pos]);
+        if ((length > png.size()) || (pos + 12 + length > png.size())) {
+            return false;
+        }
+        const uint8_t *const type = &png[pos + 4];
+        const uint8_t *const data = &png[pos + 8];
+        if (memcmp(type, "IHDR", 4) == 0) {
+            if (length < 13) {
+                return false;
+            }
+            width = png_u32(data);
+            height = png_u32(data + 4);
+            color_type = data[9];
+            if ((data[8] != 8) || (data[12] != 0)) {
+                return false; // exotic bit depth or interlaced
+            }
+        } else if (memcmp(type, "PLTE", 4) == 0) {
+            for (uint32_t i = 0; i + 2 < length; i += 3) {
+                palette.push_back(data[i]);
+                palette.push_back(data[i + 1]);
+                palette.push_back(data[i + 2]);
+                palette.push_back(0xff);
+            }
+        } else if (memcmp(type, "tRNS", 4) == 0) {
+            for (uint32_t i = 0; (i < length) && (i * 4 + 3 < palette.size()); ++i) {
+                palette[i * 4 + 3] = data[i];
+            }
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            idat.insert(idat.end(), data, data + length);
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + length;
     }
-    LOG_INFO("Swap interval = {}", SDL_GL_GetSwapInterval());
 
-    const glbinding::GetProcAddress get_proc_address = [](const char *name) {
-        return reinterpret_cast<ProcAddress>(SDL_GL_GetProcAddress(name));
-    };
-    Binding::initialize(get_proc_address, false);
-    Binding::setCallbackMaskExcept(CallbackMask::Before | CallbackMask::After, { "glGetError" });
-#if MICROPROFILE_ENABLED != 0
-    Binding::setBeforeCallback(before_callback);
-#endif // MICROPROFILE_ENABLED
-    Binding::setAfterCallback(after_callback);
+    static const uint32_t channels_for_type[7] = { 1, 0, 3, 1, 2, 0, 4 };
+    if ((width == 0) || (width > MAX_ICON_DIM) || (height == 0) || (height > MAX_ICON_DIM) || (color_type > 6) || (channels_for_type[color_type] == 0) || idat.empty()) {
+        return false;
+    }
+    if ((color_type == 3) && palette.empty()) {
+        return false;
+    }
+    const uint32_t channels = channels_for_type[color_type];
 
-    state.kernel.base_tick = { rtc_base_ticks() };
+    // One filter byte per scanline ahead of the samples.
+    const size_t stride = static_cast<size_t>(width) * channels;
+    std::vector<uint8_t> raw((stride + 1) * height);
+    mz_ulong raw_size = static_cast<mz_ulong>(raw.size());
+    if ((mz_uncompress(raw.data(), &raw_size, idat.data(), static_cast<mz_ulong>(idat.size())) != MZ_OK) || (raw_size != raw.size())) {
+        return false;
+    }
+
+    std::vector<uint8_t> pixels(stride * height);
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint8_t filter = raw[y * (stride + 1)];
+        if (filter > 4) {
+            return false;
+        }
+        const uint8_t *const src = &raw[y * (stride + 1) + 1];
+        uint8_t *const dst = &pixels[y * stride];
+        const uint8_t *const up = (y > 0) ? (dst - stride) : nullptr;
+        for (size_t x = 0; x < stride; ++x) {
+            const int left = (x >= channels) ? dst[x - channels] : 0;
+            const int above = up ? up[x] : 0;
+            const int corner = (up && (x >= channels)) ? up[x - channels] : 0;
+            int value = src[x];
+            switch (filter) {
+            case 1:
+                value += left;
+                break;
+            case 2:
+                value += above;
+                break;
+            case 3:
+                value += (left + above) / 2;
+                break;
+            case 4:
+                value += png_paeth(left, above, corner);
+                break;
+            }
+            dst[x] = static_cast<uint8_t>(value);
+        }
+    }
 
+    rgba.resize(static_cast<size_t>(width) * height * 4);
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i) {
+        const uint8_t *const px = &pixels[i * channels];
+        uint8_t *const out = &rgba[i * 4];
+        switch (color_type) {
+        case 0:
+            out[0] = out[1] = out[2] = px[0];
+            out[3] = 0xff;
+            break;
+        case 2:
+            out[0] = px[0];
+            out[1] = px[1];
+            out[2] = px[2];
+            out[3] = 0xff;
+            break;
+        case 3: {
+            const size_t entry = static_cast<size_t>(px[0]) * 4;
+            if (entry + 4 > palette.size()) {
+                return false;
+            }
+            memcpy(out, &palette[entry], 4);
+            break;
+        }
+        case 4:
+            out[0] = out[1] = out[2] = px[0];
+            out[3] = px[1];
+            break;
+        case 6:
+            memcpy(out, px, 4);
+            break;
+        }
+    }
+
+    return true;
+}
+
+static const char icon_index_magic[4] = { 'V', '3', 'K', 'I' };
+
+static void load_icon_index(const std::string &path, std::map<std::string, CachedIcon> &cache) {
+    std::ifstream index(path, std::ifstream::binary);
+    char magic[4];
+    uint32_t count = 0;
+    if (!index.read(magic, sizeof(magic)) || (memcmp(magic, icon_index_magic, sizeof(magic)) != 0) || !index.read(reinterpret_cast<char *>(&count), sizeof(count))) {
+        return;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t id_length = 0;
+        if (!index.read(reinterpret_cast<char *>(&id_length), sizeof(id_length)) || (id_length > 255)) {
+            return;
+        }
+        std::string title_id(id_length, '\0');
+        CachedIcon entry;
+        index.read(&title_id[0], id_length);
+        index.read(reinterpret_cast<char *>(&entry.png_size), sizeof(entry.png_size));
+        index.read(reinterpret_cast<char *>(&entry.png_mtime), sizeof(entry.png_mtime));
+        index.read(reinterpret_cast<char *>(&entry.width), sizeof(entry.width));
+        index.read(reinterpret_cast<char *>(&entry.height), sizeof(entry.height));
+        if (!index || (entry.width == 0) || (entry.width > MAX_ICON_DIM) || (entry.height == 0) || (entry.height > MAX_ICON_DIM)) {
+            return;
+        }
+        entry.rgba.resize(static_cast<size_t>(entry.width) * entry.height * 4);
+        if (!index.read(reinterpret_cast<char *>(entry.rgba.data()), entry.rgba.size())) {
+            return;
+        }
+        cache.emplace(title_id, std::move(entry));
+    }
+}
+
+static void save_icon_index(const std::string &path, const std::map<std::string, CachedIcon> &cache) {
+    std::ofstream index(path, std::ofstream::binary | std::ofstream::trunc);
+    const uint32_t count = static_cast<uint32_t>(cache.size());
+    index.write(icon_index_magic, sizeof(icon_index_magic));
+    index.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    for (const auto &entry : cache) {
+        const uint32_t id_length = static_cast<uint32_t>(entry.first.size());
+        index.write(reinterpret_cast<const char *>(&id_length), sizeof(id_length));
+        index.write(entry.first.data(), id_length);
+        index.write(reinterpret_cast<const char *>(&entry.second.png_size), sizeof(entry.second.png_size));
+        index.write(reinterpret_cast<const char *>(&entry.second.png_mtime), sizeof(entry.second.png_mtime));
+        index.write(reinterpret_cast<const char *>(&entry.second.width), sizeof(entry.second.width));
+        index.write(reinterpret_cast<const char *>(&entry.second.height), sizeof(entry.second.height));
+        index.write(reinterpret_cast<const char *>(entry.second.rgba.data()), entry.second.rgba.size());
+    }
+}
+
+// Builds the game selector list from the installed titles under ux0/app.
+// Extracted titles are cached in pref_path/titles.idx keyed on each
+// param.sfo's size and mtime, so enumerating dozens of installed games
+// doesn't re-open and re-parse every SFO; misses parse straight from a
+// mapped view of the file. Icons get the same treatment through
+// pref_path/titles.icx, which stores each icon0.png already decoded to RGBA
+// so a relaunch never runs the PNG decoder for an unchanged title.
+static bool list_installed_games(HostState &state) {
+    const std::string index_path = state.pref_path + "titles.idx";
+    const std::string icon_index_path = state.pref_path + "titles.icx";
+
+    std::map<std::string, CachedIcon> icon_cache;
+    load_icon_index(icon_index_path, icon_cache);
+
+    std::map<std::string, CachedTitle> cache;
+    {
+        std::ifstream index(index_path);
+        std::string line;
+        while (std::getline(index, line)) {
+            std::istringstream fields(line);
+            std::string title_id;
+            std::string size_text;
+            std::string mtime_text;
+            CachedTitle entry;
+            if (std::getline(fields, title_id, '\t') && std::getline(fields, size_text, '\t') && std::getline(fields, mtime_text, '\t') && std::getline(fields, entry.title)) {
+                entry.sfo_size = strtoull(size_text.c_str(), nullptr, 10);
+                entry.sfo_mtime = strtoull(mtime_text.c_str(), nullptr, 10);
+                cache.emplace(title_id, entry);
+            }
+        }
+    }
+
+    bool cache_dirty = false;
+    bool icon_cache_dirty = false;
     std::string dir_path = state.pref_path + "ux0/app";
 #ifdef WIN32
     _WDIR *d = _wopendir((utf_to_wide(dir_path)).c_str());
@@ -165,15 +451,50 @@ bool init(HostState &state) {
             d_name_utf8 = dp->d_name;
 #endif
             if ((strcmp(d_name_utf8.c_str(), ".")) && (strcmp(d_name_utf8.c_str(), ".."))) {
-                Buffer params;
-                state.io.title_id = d_name_utf8;
-                if (read_file_from_disk(params, "sce_sys/param.sfo", state)) {
+                const std::string sfo_path = dir_path + "/" + d_name_utf8 + "/sce_sys/param.sfo";
+                uint64_t sfo_size = 0;
+                uint64_t sfo_mtime = 0;
+                if (!stat_file(sfo_path, sfo_size, sfo_mtime)) {
+                    continue;
+                }
+
+                std::string title;
+                const auto cached = cache.find(d_name_utf8);
+                if ((cached != cache.end()) && (cached->second.sfo_size == sfo_size) && (cached->second.sfo_mtime == sfo_mtime)) {
+                    title = cached->second.title;
+                } else {
                     SfoFile sfo_handle;
-                    load_sfo(sfo_handle, params);
-                    find_data(state.game_title, sfo_handle, "TITLE");
-                    state.gui.game_selector.title_ids.push_back(std::string(state.io.title_id));
-                    state.gui.game_selector.titles.push_back(std::string(state.game_title));
+                    if (!load_sfo_file(sfo_handle, sfo_path) || !find_data(title, sfo_handle, "TITLE")) {
+                        continue;
+                    }
+                    cache[d_name_utf8] = { sfo_size, sfo_mtime, title };
+                    cache_dirty = true;
                 }
+
+                GameIcon icon;
+                const std::string icon_path = dir_path + "/" + d_name_utf8 + "/sce_sys/icon0.png";
+                uint64_t png_size = 0;
+                uint64_t png_mtime = 0;
+                if (stat_file(icon_path, png_size, png_mtime)) {
+                    const auto cached_icon = icon_cache.find(d_name_utf8);
+                    if ((cached_icon != icon_cache.end()) && (cached_icon->second.png_size == png_size) && (cached_icon->second.png_mtime == png_mtime)) {
+                        icon.width = cached_icon->second.width;
+                        icon.height = cached_icon->second.height;
+                        icon.rgba = cached_icon->second.rgba;
+                    } else {
+                        std::vector<uint8_t> png;
+                        if (read_file_bytes(icon_path, png) && decode_png(png, icon.width, icon.height, icon.rgba)) {
+                            icon_cache[d_name_utf8] = { png_size, png_mtime, icon.width, icon.height, icon.rgba };
+                            icon_cache_dirty = true;
+                        } else {
+                            icon = GameIcon();
+                        }
+                    }
+                }
+
+                state.gui.game_selector.title_ids.push_back(d_name_utf8);
+                state.gui.game_selector.titles.push_back(title);
+                state.gui.game_selector.icons.push_back(std::move(icon));
             }
         }
     } while (dp);
@@ -184,13 +505,261 @@ bool init(HostState &state) {
     closedir(d);
 #endif
 
+    if (cache_dirty) {
+        std::ofstream index(index_path, std::ofstream::trunc);
+        for (const auto &entry : cache) {
+            index << entry.first << '\t' << entry.second.sfo_size << '\t' << entry.second.sfo_mtime << '\t' << entry.second.title << '\n';
+        }
+    }
+
+    return true;
+}
+
+// Tracks a batch of startup phases running on pool workers: how many are
+// still in flight and whether every finished one succeeded.
+struct StartupPhases {
+    std::mutex mutex;
+    std::condition_variable all_done;
+    size_t remaining = 0;
+    bool ok = true;
+};
+
+static bool run_startup_phase(const char *name, const std::function<bool()> &work) {
+    const BootSlice slice(name);
+    const auto start = std::chrono::steady_clock::now();
+    const bool ok = work();
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    if (ok) {
+        LOG_INFO("Startup: {} took {} ms.", name, ms);
+    } else {
+        LOG_ERROR("Startup: {} FAILED after {} ms.", name, ms);
+    }
+    return ok;
+}
+
+bool init(HostState &state) {
+    const auto boot_start = std::chrono::steady_clock::now();
+    const std::unique_ptr<char, void (&)(void *)> base_path(SDL_GetBasePath(), SDL_free);
+    const std::unique_ptr<char, void (&)(void *)> pref_path(SDL_GetPrefPath(org_name, app_name), SDL_free);
+
+    const ResumeAudioThread resume_thread = [&state](SceUID thread_id) {
+        const ThreadStatePtr thread = lock_and_find(thread_id, state.kernel.threads, state.kernel.mutex);
+        const std::lock_guard<std::mutex> lock(thread->mutex);
+        if (thread->to_do == ThreadToDo::wait) {
+            thread->to_do = ThreadToDo::run;
+        }
+        thread->something_to_do.notify_all();
+    };
+
+    state.base_path = base_path.get();
+    state.pref_path = pref_path.get();
+    state.display.set_dims(DEFAULT_RES_WIDTH, DEFAULT_RES_HEIGHT, WINDOW_BORDER_WIDTH, WINDOW_BORDER_HEIGHT);
+    if (!state.headless) {
+        state.window = WindowPtr(SDL_CreateWindow(window_title, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, state.display.window_size.width, state.display.window_size.height, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE), SDL_DestroyWindow);
+        if (!state.window) {
+            return false;
+        }
+    }
+
+    // The subsystems below have no ordering dependency on each other or on
+    // the GL bring-up, so they run on pool workers while the main thread -
+    // where SDL requires the GL context to be created - does the GL work.
+    StartupPhases phases;
+    const auto launch = [&phases, &state](const char *name, std::function<bool()> work) {
+        {
+            const std::lock_guard<std::mutex> lock(phases.mutex);
+            ++phases.remaining;
+        }
+        const auto job = [&phases, name, work = std::move(work)]() {
+            const bool ok = run_startup_phase(name, work);
+            const std::lock_guard<std::mutex> lock(phases.mutex);
+            phases.ok &= ok;
+            --phases.remaining;
+            phases.all_done.notify_one();
+        };
+        if (!run_on_worker(state.kernel.thread_pool, job)) {
+            job();
+        }
+    };
+
+    const char *const huge_pages = SDL_getenv("VITA3K_HUGE_PAGES");
+    launch("mem", [&state, huge_pages]() {
+        return init(state.mem, huge_pages && (SDL_strcmp(huge_pages, "0") != 0));
+    });
+    launch("audio", [&state, resume_thread]() {
+        return init(state.audio, resume_thread);
+    });
+    launch("io + game list", [&state]() {
+        // The game list reads through the device paths io sets up.
+        return init(state.io, state.pref_path.c_str()) && list_installed_games(state);
+    });
+    launch("shaders db", [&state]() {
+        // Pack the loose shaders-db files on first boot; later boots load the
+        // container in one read. Delete shaders.db to pick up edited shaders.
+        if (!load_shaders_db(state.gxm.shaders_db, state.base_path.c_str())) {
+            if (build_shaders_db(state.base_path.c_str()) && load_shaders_db(state.gxm.shaders_db, state.base_path.c_str())) {
+                LOG_INFO("Packed {} shaders into shaders.db.", state.gxm.shaders_db.index.size());
+            }
+        }
+        return true;
+    });
+
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+
+    const bool gl_ok = state.headless || run_startup_phase("gl context", [&state]() {
+        state.glcontext = GLContextPtr(SDL_GL_CreateContext(state.window.get()), SDL_GL_DeleteContext);
+        if (!state.glcontext) {
+            LOG_ERROR("Could not create OpenGL context.");
+            return false;
+        }
+
+        // Try adaptive vsync first, falling back to regular vsync.
+        if (SDL_GL_SetSwapInterval(-1) < 0) {
+            SDL_GL_SetSwapInterval(1);
+        }
+        LOG_INFO("Swap interval = {}", SDL_GL_GetSwapInterval());
+
+        const glbinding::GetProcAddress get_proc_address = [](const char *name) {
+            return reinterpret_cast<ProcAddress>(SDL_GL_GetProcAddress(name));
+        };
+        Binding::initialize(get_proc_address, false);
+
+#ifndef NDEBUG
+        // Prefer the driver's own validation; the glGetError loop in
+        // after_callback only backstops drivers without KHR_debug.
+        check_gl_errors = !install_khr_debug_callback();
+#endif
+        const char *const slow_call = SDL_getenv("VITA3K_GL_SLOW_CALL_US");
+        if (slow_call) {
+            set_gl_slow_call_threshold_us(SDL_strtoull(slow_call, nullptr, 10));
+        }
+
+        // Only pay for the per-call hooks when something consumes them - a
+        // release build with the shim off dispatches GL calls directly.
+        bool per_call_hooks = check_gl_errors || (gl_slow_call_threshold_us() != 0);
+#if MICROPROFILE_ENABLED != 0
+        per_call_hooks = true;
+#endif // MICROPROFILE_ENABLED
+        if (per_call_hooks) {
+            Binding::setCallbackMaskExcept(CallbackMask::Before | CallbackMask::After, { "glGetError" });
+            Binding::setBeforeCallback(before_callback);
+            Binding::setAfterCallback(after_callback);
+        }
+        return true;
+    });
+
+    state.kernel.base_tick = { rtc_base_ticks() };
+
+    // The hot time NIDs read this cache instead of the host clock. 100 us
+    // default granularity; override when a title's timing code cares.
+    uint64_t coarse_granularity_us = 0;
+    const char *const coarse_time = SDL_getenv("VITA3K_COARSE_TIME_US");
+    if (coarse_time) {
+        coarse_granularity_us = SDL_strtoull(coarse_time, nullptr, 10);
+    }
+    rtc_start_coarse(state.kernel.coarse_time, state.kernel.base_tick.tick, coarse_granularity_us);
+
+    // Default stays on Unicorn until the recompiler has seen wider testing.
+    const char *const cpu_backend = SDL_getenv("VITA3K_CPU_BACKEND");
+    if (cpu_backend && (SDL_strcasecmp(cpu_backend, "dynarmic") == 0)) {
+        state.kernel.cpu_backend = CPUBackend::Dynarmic;
+    }
+
+    // Scheduler time slice in guest instructions; 0 disables slicing.
+    const char *const cpu_quantum = SDL_getenv("VITA3K_CPU_QUANTUM");
+    if (cpu_quantum) {
+        state.kernel.execution_quantum = SDL_strtoull(cpu_quantum, nullptr, 10);
+    }
+
+    // Every launched job references this frame, so wait for all of them
+    // even when something has already failed.
+    {
+        std::unique_lock<std::mutex> lock(phases.mutex);
+        phases.all_done.wait(lock, [&phases]() { return phases.remaining == 0; });
+        if (!gl_ok || !phases.ok) {
+            return false;
+        }
+    }
+
+    const auto boot_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - boot_start).count();
+    LOG_INFO("Startup: host init took {} ms.", boot_ms);
+
     return true;
 }
 
+// Stamps a vblank and wakes the waiters. The smoothed interval feeds the
+// prediction the adaptive waiter in sceDisplayWaitVblankStart sleeps
+// against; intervals past 100 ms (pauses, debugger stops, dragged windows)
+// are kept out of the average.
+void notify_vblank(DisplayState &display) {
+    const uint64_t now = trace_now_us();
+    const uint64_t last = display.last_vblank_us.load(std::memory_order_relaxed);
+    if (last != 0) {
+        const uint64_t interval = now - last;
+        if (interval < 100000) {
+            const uint64_t period = display.vblank_period_us.load(std::memory_order_relaxed);
+            display.vblank_period_us.store((period * 7 + interval) / 8, std::memory_order_relaxed);
+        }
+    }
+    display.last_vblank_us.store(now, std::memory_order_relaxed);
+    display.vblank_count.fetch_add(1, std::memory_order_release);
+    display.condvar.notify_all();
+}
+
+// Samples both touch panels from the host mouse into the fixed-rate ring
+// the SceTouch exports serve from. Runs on the main loop at the panel's
+// 60 Hz default timing, so guest peeks become snapshot copies and guest
+// reads block on a real sampling tick instead of polling SDL per call.
+static void sample_touch(HostState &host) {
+    const uint64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+                                .count();
+
+    static uint64_t last_sample_us = 0;
+    if ((now_us - last_sample_us) < (1000000 / 60)) {
+        return;
+    }
+    last_sample_us = now_us;
+
+    int window_x = 0;
+    int window_y = 0;
+    const uint32_t buttons = SDL_GetMouseState(&window_x, &window_y);
+
+    int window_w = 0;
+    int window_h = 0;
+    SDL_Window *const window = SDL_GetMouseFocus();
+    SDL_GetWindowSize(window, &window_w, &window_h);
+
+    const float normalised_x = window_x / static_cast<float>(std::max(window_w, 1));
+    const float normalised_y = window_y / static_cast<float>(std::max(window_h, 1));
+
+    const std::lock_guard<std::mutex> lock(host.touch.mutex);
+    const uint64_t seq = host.touch.sample_seq + 1;
+    for (uint32_t port = 0; port < 2; ++port) {
+        SceTouchData &sample = host.touch.ring[port][seq % TouchState::ring_size];
+        memset(&sample, 0, sizeof(sample));
+        sample.timeStamp = now_us;
+
+        // Left button is the front panel, right button the back one.
+        const uint32_t mask = (port == 1) ? SDL_BUTTON_RMASK : SDL_BUTTON_LMASK;
+        if ((buttons & mask) && host.gui.renderer_focused) {
+            sample.report[sample.reportNum].x = static_cast<uint16_t>(normalised_x * 1920);
+            sample.report[sample.reportNum].y = static_cast<uint16_t>(normalised_y * 1088);
+            ++sample.reportNum;
+        }
+    }
+    host.touch.sample_seq = seq;
+    host.touch.condvar.notify_all();
+}
+
 bool handle_events(HostState &host) {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         ImGui_ImplSdlGL3_ProcessEvent(&event);
+        // Any event can change what the widgets would draw.
+        host.gui.rebuild_requested = true;
         if (event.type == SDL_QUIT) {
             stop_all_threads(host.kernel);
             host.gxm.display_queue.abort();
@@ -217,8 +786,47 @@ bool handle_events(HostState &host) {
 
             SDL_SetWindowSize(host.window.get(), display.window_size.width, display.window_size.height);
         }
+
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_r) {
+            // Toggle GXM command-stream capture for the replay tool.
+            if (host.gxm.capture.enabled) {
+                gxm_capture_end(host.gxm.capture);
+            } else {
+                gxm_capture_begin(host.gxm.capture, host.pref_path + "gxm_capture.v3gc");
+            }
+        }
+
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_p) {
+            // Queue a screenshot; the present path reads it back through the
+            // pack-buffer ring and encodes it off the render thread.
+            host.display.screenshot_requests.fetch_add(1);
+        }
+
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_v) {
+            const bool capturing = !host.display.continuous_capture.load();
+            host.display.continuous_capture = capturing;
+            LOG_INFO("Frame capture {}.", capturing ? "started" : "stopped");
+        }
+
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_t) {
+            // Toggle trace capture; stopping writes the rings out for
+            // chrome://tracing.
+            if (is_tracing_enabled()) {
+                const std::string path = host.pref_path + "trace.json";
+                if (dump_trace(path)) {
+                    LOG_INFO("Trace written to {}.", path);
+                } else {
+                    LOG_ERROR("Failed to write trace to {}.", path);
+                }
+            } else {
+                set_tracing_enabled(true);
+                LOG_INFO("Trace capture started.");
+            }
+        }
     }
 
+    sample_touch(host);
+
     return true;
 }
 
@@ -229,37 +837,138 @@ bool handle_events(HostState &host) {
  * \return Resolved address, 0 if not found
  */
 Address resolve_export(KernelState &kernel, uint32_t nid) {
-    const ExportNids::iterator export_address = kernel.export_nids.find(nid);
-    if (export_address == kernel.export_nids.end()) {
-        return 0;
+    return find_export(kernel.export_nids, nid);
+}
+
+static void resolve_call_site(HostState &host, ImportCallSite &site) {
+    site.export_pc = resolve_export(host.kernel, site.nid);
+    if (!site.export_pc) {
+        site.fn = resolve_import(site.nid);
+    }
+    site.resolved = true;
+}
+
+// Load-time pass: sizes the slot table to cover every import stub written so
+// far and resolves each slot once, so steady state and first calls alike hit
+// an already-resolved site. A NID that resolves to nothing is left
+// unresolved - it may be exported by a module loaded later, and the lazy
+// path retries it on first call.
+void resolve_loaded_imports(HostState &host) {
+    const std::lock_guard<std::mutex> lock(host.import_call_sites_mutex);
+
+    {
+        std::shared_lock<std::shared_mutex> kernel_lock(host.kernel.mutex);
+        const size_t slot_count = host.kernel.import_nid_slots.size();
+        const size_t known = host.import_slots.size();
+        if (known < slot_count) {
+            host.import_slots.resize(slot_count);
+            for (size_t slot = known; slot < slot_count; ++slot) {
+                host.import_slots[slot].nid = host.kernel.import_nid_slots[slot];
+            }
+        }
+    }
+
+    for (ImportCallSite &site : host.import_slots) {
+        if (!site.resolved) {
+            resolve_call_site(host, site);
+            if (!site.export_pc && !site.fn) {
+                site.resolved = false;
+            }
+        }
+    }
+}
+
+static const ImportCallSite *import_slot_site(HostState &host, uint32_t imm) {
+    const std::lock_guard<std::mutex> lock(host.import_call_sites_mutex);
+    if (host.import_slots.size() < imm) {
+        std::shared_lock<std::shared_mutex> kernel_lock(host.kernel.mutex);
+        const size_t slot_count = host.kernel.import_nid_slots.size();
+        assert(imm <= slot_count);
+        host.import_slots.resize(slot_count);
+        for (size_t slot = 0; slot < slot_count; ++slot) {
+            host.import_slots[slot].nid = host.kernel.import_nid_slots[slot];
+        }
+    }
+
+    ImportCallSite &site = host.import_slots[imm - 1];
+    if (!site.resolved) {
+        // Modules are loaded before their imports are callable, so the
+        // resolution is stable once made.
+        resolve_call_site(host, site);
+    }
+
+    return &site;
+}
+
+static const ImportCallSite *import_pc_site(HostState &host, Address pc) {
+    {
+        const std::lock_guard<std::mutex> lock(host.import_call_sites_mutex);
+        const ImportCallSites::const_iterator cached = host.import_call_sites.find(pc);
+        if (cached != host.import_call_sites.end()) {
+            return &cached->second;
+        }
+    }
+
+    // First call through this SVC site - decode the NID that follows the
+    // svc instruction and resolve it once.
+    ImportCallSite new_site;
+    new_site.nid = *Ptr<const uint32_t>(pc + 4).get(host.mem);
+    resolve_call_site(host, new_site);
+
+    const std::lock_guard<std::mutex> lock(host.import_call_sites_mutex);
+    return &host.import_call_sites.emplace(pc, std::move(new_site)).first->second;
+}
+
+// Writes the collected per-import counters as JSON, one record per export,
+// for ranking which HLE functions dominate a title offline.
+bool dump_hle_telemetry(HostState &host, const std::string &path) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    const std::lock_guard<std::mutex> lock(host.hle_telemetry.mutex);
+
+    out << "{ \"imports\": [";
+    bool first = true;
+    for (const auto &entry : host.hle_telemetry.imports) {
+        const ImportCallStats &stats = entry.second;
+        out << (first ? "" : ",") << "\n  { \"name\": \"" << entry.first << "\""
+            << ", \"calls\": " << stats.calls
+            << ", \"total_ns\": " << stats.total_ns
+            << ", \"worst_ns\": " << stats.worst_ns << " }";
+        first = false;
     }
+    out << "\n] }\n";
 
-    return export_address->second;
+    return out.good();
 }
 
-void call_import(HostState &host, CPUState &cpu, uint32_t nid, SceUID thread_id) {
-    Address export_pc = resolve_export(host.kernel, nid);
+void call_import(HostState &host, CPUState &cpu, uint32_t imm, Address pc, SceUID thread_id) {
+    // Stubs written by the loader carry their slot number in the svc
+    // immediate; a plain svc #0 falls back to decoding the NID word at the
+    // call site.
+    const ImportCallSite *const site = (imm != 0) ? import_slot_site(host, imm) : import_pc_site(host, pc);
 
-    if (!export_pc) {
+    if (!site->export_pc) {
         // HLE - call our C++ function
 
         if (LOG_IMPORT_CALLS) {
-            const char *const name = import_name(nid);
-            LOG_TRACE("THREAD_ID {} NID {} ({}) called", thread_id, log_hex(nid), name);
+            const char *const name = import_name(site->nid);
+            LOG_TRACE("THREAD_ID {} NID {} ({}) called", thread_id, log_hex(site->nid), name);
         }
-        const ImportFn fn = resolve_import(nid);
-        if (fn) {
-            fn(host, cpu, thread_id);
+        if (site->fn) {
+            site->fn(host, cpu, thread_id);
         }
     } else {
         // LLE - directly run ARM code imported from some loaded module
 
         if (LOG_IMPORT_CALLS) {
-            const char *const name = import_name(nid);
-            LOG_TRACE("THREAD_ID {} EXPORTED NID {} at {} ({})) called", thread_id, log_hex(nid), log_hex(export_pc), name);
+            const char *const name = import_name(site->nid);
+            LOG_TRACE("THREAD_ID {} EXPORTED NID {} at {} ({})) called", thread_id, log_hex(site->nid), log_hex(site->export_pc), name);
         }
         const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
         const std::lock_guard<std::mutex> lock(thread->mutex);
-        write_pc(*thread->cpu, export_pc);
+        write_pc(*thread->cpu, site->export_pc);
     }
 }
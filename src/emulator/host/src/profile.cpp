@@ -0,0 +1,132 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <host/profile.h>
+
+#include <host/state.h>
+#include <util/log.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+static std::string trim(const std::string &text) {
+    const size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return std::string();
+    }
+    const size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+// Applies one setting to the live state. Returns false for unknown keys.
+static bool apply_setting(HostState &host, const std::string &key, const std::string &value) {
+    const uint64_t number = strtoull(value.c_str(), nullptr, 10);
+
+    if (key == "display_pacing") {
+        if (value == "strict") {
+            host.gxm.pacing = DISPLAY_PACING_STRICT;
+        } else if (value == "triple") {
+            host.gxm.pacing = DISPLAY_PACING_TRIPLE;
+        } else if (value == "unlocked") {
+            host.gxm.pacing = DISPLAY_PACING_UNLOCKED;
+        } else {
+            return false;
+        }
+    } else if (key == "resolution_multiplier") {
+        host.gxm.resolution_multiplier = static_cast<uint32_t>(std::max<uint64_t>(1, std::min<uint64_t>(number, 4)));
+    } else if (key == "texture_upload_budget_mb") {
+        host.gxm.texture_upload_budget = number * 1024 * 1024;
+    } else if (key == "unlocked_speed") {
+        host.display.unlocked_speed.store(number != 0);
+    } else if (key == "turbo_multiplier") {
+        host.display.turbo_multiplier.store(static_cast<uint32_t>(std::max<uint64_t>(1, number)));
+    } else if (key == "auto_frame_skip") {
+        host.display.auto_frame_skip.store(number != 0);
+    } else if (key == "cpu_backend") {
+        if (value == "unicorn") {
+            host.kernel.cpu_backend = CPUBackend::Unicorn;
+        } else if (value == "dynarmic") {
+            host.kernel.cpu_backend = CPUBackend::Dynarmic;
+        } else {
+            return false;
+        }
+    } else if (key == "cpu_quantum") {
+        host.kernel.execution_quantum = number;
+    } else if (key == "log_level") {
+        if (value == "trace") {
+            spdlog::set_level(spdlog::level::trace);
+        } else if (value == "debug") {
+            spdlog::set_level(spdlog::level::debug);
+        } else if (value == "info") {
+            spdlog::set_level(spdlog::level::info);
+        } else if (value == "warn") {
+            spdlog::set_level(spdlog::level::warn);
+        } else if (value == "error") {
+            spdlog::set_level(spdlog::level::err);
+        } else if (value == "critical") {
+            spdlog::set_level(spdlog::level::critical);
+        } else if (value == "off") {
+            spdlog::set_level(spdlog::level::off);
+        } else {
+            return false;
+        }
+    } else if (key == "hle_telemetry") {
+        host.hle_telemetry.enabled = (number != 0);
+    } else if (key == "io_telemetry") {
+        host.io.telemetry.enabled = (number != 0);
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+void load_title_profile(HostState &host) {
+    const std::string path = host.pref_path + "profiles/" + host.io.title_id + ".cfg";
+    std::ifstream profile(path);
+    if (!profile) {
+        return;
+    }
+
+    LOG_INFO("Applying title profile {}.", path);
+
+    std::string line;
+    while (std::getline(profile, line)) {
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.resize(comment);
+        }
+        const size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            continue;
+        }
+
+        const std::string key = trim(line.substr(0, equals));
+        const std::string value = trim(line.substr(equals + 1));
+        if (key.empty() || value.empty()) {
+            continue;
+        }
+
+        if (apply_setting(host, key, value)) {
+            LOG_INFO("Profile: {} = {}", key, value);
+        } else {
+            LOG_WARN("Profile: ignoring unknown setting {} = {}", key, value);
+        }
+    }
+}
@@ -0,0 +1,348 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <host/save_state.h>
+
+#include <host/state.h>
+
+#include <io/functions.h>
+#include <kernel/functions.h>
+#include <mem/snapshot.h>
+#include <util/fs.h>
+#include <util/log.h>
+
+#include <miniz.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+static constexpr uint32_t SAVE_STATE_MAGIC = 0x53533356; // "V3SS"
+static constexpr uint32_t SAVE_STATE_VERSION = 1;
+
+// Little helpers over a flat byte stream. Everything is written raw and
+// little-endian; states are a local debugging artifact, not an interchange
+// format.
+struct StateWriter {
+    std::vector<uint8_t> bytes;
+
+    void write(const void *data, size_t size) {
+        const uint8_t *const src = static_cast<const uint8_t *>(data);
+        bytes.insert(bytes.end(), src, src + size);
+    }
+
+    template <typename T>
+    void write_value(const T &value) {
+        write(&value, sizeof(value));
+    }
+
+    void write_string(const std::string &value) {
+        write_value(static_cast<uint32_t>(value.size()));
+        write(value.data(), value.size());
+    }
+};
+
+struct StateReader {
+    const uint8_t *cursor = nullptr;
+    const uint8_t *end = nullptr;
+    bool failed = false;
+
+    bool read(void *data, size_t size) {
+        if (failed || (static_cast<size_t>(end - cursor) < size)) {
+            failed = true;
+            return false;
+        }
+        std::memcpy(data, cursor, size);
+        cursor += size;
+        return true;
+    }
+
+    template <typename T>
+    T read_value() {
+        T value{};
+        read(&value, sizeof(value));
+        return value;
+    }
+
+    std::string read_string() {
+        const uint32_t size = read_value<uint32_t>();
+        if (failed || (static_cast<size_t>(end - cursor) < size)) {
+            failed = true;
+            return std::string();
+        }
+        std::string value(reinterpret_cast<const char *>(cursor), size);
+        cursor += size;
+        return value;
+    }
+};
+
+static void write_threads(StateWriter &out, const ThreadContexts &contexts) {
+    out.write_value(static_cast<uint32_t>(contexts.size()));
+    for (const ThreadContexts::value_type &context : contexts) {
+        out.write_value(static_cast<int32_t>(context.first));
+        out.write_value(context.second);
+    }
+}
+
+static void write_io(StateWriter &out, const SavedIoState &io) {
+    out.write_value(static_cast<uint64_t>(io.slot_count));
+    out.write_value(static_cast<uint32_t>(io.fds.size()));
+    for (const SavedFd &fd : io.fds) {
+        out.write_value(static_cast<int32_t>(fd.fd));
+        out.write_value(static_cast<int32_t>(fd.kind));
+        out.write_value(static_cast<int32_t>(fd.tty));
+        out.write_string(fd.guest_path);
+        out.write_string(fd.host_path);
+        out.write_value(static_cast<int32_t>(fd.open_flags));
+        out.write_value(static_cast<int64_t>(fd.position));
+    }
+}
+
+static void write_mem(StateWriter &out, const MemSnapshot &snapshot, size_t page_size) {
+    out.write_value(static_cast<uint64_t>(page_size));
+    out.write_value(static_cast<uint64_t>(snapshot.used_pages));
+    out.write_value(static_cast<uint64_t>(snapshot.generation));
+
+    out.write_value(static_cast<uint64_t>(snapshot.allocated_pages.size()));
+    for (const Generation generation : snapshot.allocated_pages) {
+        out.write_value(static_cast<uint64_t>(generation));
+    }
+
+    out.write_value(static_cast<uint64_t>(snapshot.free_blocks.size()));
+    for (const FreeBlocks::value_type &block : snapshot.free_blocks) {
+        out.write_value(static_cast<uint64_t>(block.first));
+        out.write_value(static_cast<uint64_t>(block.second));
+    }
+
+    out.write_value(static_cast<uint64_t>(snapshot.generation_name_ids.size()));
+    for (const NameId name_id : snapshot.generation_name_ids) {
+        out.write_value(static_cast<uint32_t>(name_id));
+    }
+
+    out.write_value(static_cast<uint64_t>(snapshot.generation_sizes.size()));
+    for (const GenerationSizes::value_type &size : snapshot.generation_sizes) {
+        out.write_value(static_cast<uint64_t>(size.first));
+        out.write_value(static_cast<uint64_t>(size.second));
+    }
+
+    out.write_value(static_cast<uint64_t>(snapshot.pages.size()));
+    for (const std::map<size_t, std::vector<uint8_t>>::value_type &page : snapshot.pages) {
+        out.write_value(static_cast<uint64_t>(page.first));
+        out.write(page.second.data(), page.second.size());
+    }
+}
+
+static bool read_threads(StateReader &in, ThreadContexts &contexts) {
+    const uint32_t count = in.read_value<uint32_t>();
+    for (uint32_t i = 0; i < count && !in.failed; ++i) {
+        const SceUID thread_id = in.read_value<int32_t>();
+        contexts[thread_id] = in.read_value<CPUContext>();
+    }
+    return !in.failed;
+}
+
+static bool read_io(StateReader &in, SavedIoState &io) {
+    io.slot_count = static_cast<size_t>(in.read_value<uint64_t>());
+    const uint32_t count = in.read_value<uint32_t>();
+    for (uint32_t i = 0; i < count && !in.failed; ++i) {
+        SavedFd fd;
+        fd.fd = in.read_value<int32_t>();
+        fd.kind = in.read_value<int32_t>();
+        fd.tty = in.read_value<int32_t>();
+        fd.guest_path = in.read_string();
+        fd.host_path = in.read_string();
+        fd.open_flags = in.read_value<int32_t>();
+        fd.position = in.read_value<int64_t>();
+        io.fds.push_back(std::move(fd));
+    }
+    return !in.failed;
+}
+
+static bool read_mem(StateReader &in, MemSnapshot &snapshot, size_t page_size) {
+    if (in.read_value<uint64_t>() != page_size) {
+        LOG_ERROR("Save state was taken with a different page size.");
+        return false;
+    }
+    snapshot.used_pages = static_cast<size_t>(in.read_value<uint64_t>());
+    snapshot.generation = static_cast<Generation>(in.read_value<uint64_t>());
+
+    const uint64_t allocated = in.read_value<uint64_t>();
+    snapshot.allocated_pages.resize(static_cast<size_t>(allocated));
+    for (uint64_t i = 0; i < allocated && !in.failed; ++i) {
+        snapshot.allocated_pages[i] = static_cast<Generation>(in.read_value<uint64_t>());
+    }
+
+    const uint64_t free_blocks = in.read_value<uint64_t>();
+    for (uint64_t i = 0; i < free_blocks && !in.failed; ++i) {
+        const uint64_t first_page = in.read_value<uint64_t>();
+        const uint64_t page_count = in.read_value<uint64_t>();
+        snapshot.free_blocks.emplace(static_cast<size_t>(first_page), static_cast<size_t>(page_count));
+        snapshot.free_blocks_by_size.emplace(static_cast<size_t>(page_count), static_cast<size_t>(first_page));
+    }
+
+    const uint64_t name_ids = in.read_value<uint64_t>();
+    snapshot.generation_name_ids.resize(static_cast<size_t>(name_ids));
+    for (uint64_t i = 0; i < name_ids && !in.failed; ++i) {
+        snapshot.generation_name_ids[i] = in.read_value<uint32_t>();
+    }
+
+    const uint64_t sizes = in.read_value<uint64_t>();
+    for (uint64_t i = 0; i < sizes && !in.failed; ++i) {
+        const uint64_t generation = in.read_value<uint64_t>();
+        const uint64_t pages = in.read_value<uint64_t>();
+        snapshot.generation_sizes.emplace(static_cast<Generation>(generation), static_cast<size_t>(pages));
+    }
+
+    const uint64_t pages = in.read_value<uint64_t>();
+    for (uint64_t i = 0; i < pages && !in.failed; ++i) {
+        const size_t index = static_cast<size_t>(in.read_value<uint64_t>());
+        std::vector<uint8_t> &contents = snapshot.pages[index];
+        contents.resize(page_size);
+        in.read(contents.data(), page_size);
+    }
+
+    // restore_snapshot treats generation 0 as "never captured".
+    snapshot.write_generation = 1;
+
+    return !in.failed;
+}
+
+bool save_state(HostState &host, const std::string &path) {
+    // Capture with every guest thread parked so memory, registers and file
+    // cursors describe one instant.
+    const std::vector<SceUID> paused = pause_all_threads(host.kernel);
+
+    ThreadContexts contexts;
+    capture_thread_contexts(host.kernel, contexts);
+
+    SavedIoState io_saved;
+    capture_io_state(host.io, io_saved);
+
+    MemSnapshot snapshot;
+    capture_snapshot(host.mem, snapshot);
+
+    resume_threads(host.kernel, paused);
+
+    StateWriter body;
+    body.write_string(host.io.title_id);
+    write_threads(body, contexts);
+    write_io(body, io_saved);
+    write_mem(body, snapshot, host.mem.page_size);
+
+    std::vector<uint8_t> compressed(mz_compressBound(static_cast<mz_ulong>(body.bytes.size())));
+    mz_ulong compressed_size = static_cast<mz_ulong>(compressed.size());
+    if (mz_compress2(compressed.data(), &compressed_size, body.bytes.data(), static_cast<mz_ulong>(body.bytes.size()), MZ_BEST_SPEED) != MZ_OK) {
+        return false;
+    }
+
+    std::ofstream out(path, std::ofstream::binary | std::ofstream::trunc);
+    if (out.fail()) {
+        return false;
+    }
+    const uint64_t uncompressed_size = body.bytes.size();
+    out.write(reinterpret_cast<const char *>(&SAVE_STATE_MAGIC), sizeof(SAVE_STATE_MAGIC));
+    out.write(reinterpret_cast<const char *>(&SAVE_STATE_VERSION), sizeof(SAVE_STATE_VERSION));
+    out.write(reinterpret_cast<const char *>(&uncompressed_size), sizeof(uncompressed_size));
+    out.write(reinterpret_cast<const char *>(compressed.data()), compressed_size);
+    if (!out.good()) {
+        return false;
+    }
+
+    LOG_INFO("Saved state to {} ({} pages, {} -> {} bytes).", path, snapshot.pages.size(), uncompressed_size, compressed_size);
+    return true;
+}
+
+bool load_state(HostState &host, const std::string &path) {
+    std::ifstream in(path, std::ifstream::binary);
+    if (in.fail()) {
+        LOG_ERROR("No save state at {}.", path);
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t uncompressed_size = 0;
+    in.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    in.read(reinterpret_cast<char *>(&version), sizeof(version));
+    in.read(reinterpret_cast<char *>(&uncompressed_size), sizeof(uncompressed_size));
+    if (in.fail() || (magic != SAVE_STATE_MAGIC) || (version != SAVE_STATE_VERSION)) {
+        LOG_ERROR("{} is not a save state this build can read.", path);
+        return false;
+    }
+
+    std::vector<uint8_t> compressed(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    std::vector<uint8_t> body(static_cast<size_t>(uncompressed_size));
+    mz_ulong body_size = static_cast<mz_ulong>(body.size());
+    if (mz_uncompress(body.data(), &body_size, compressed.data(), static_cast<mz_ulong>(compressed.size())) != MZ_OK || (body_size != uncompressed_size)) {
+        LOG_ERROR("Save state {} is corrupt.", path);
+        return false;
+    }
+
+    StateReader reader;
+    reader.cursor = body.data();
+    reader.end = body.data() + body.size();
+
+    const std::string title_id = reader.read_string();
+    if (title_id != host.io.title_id) {
+        LOG_ERROR("Save state is for {}, running title is {}.", title_id, host.io.title_id);
+        return false;
+    }
+
+    ThreadContexts contexts;
+    SavedIoState io_saved;
+    MemSnapshot snapshot;
+    if (!read_threads(reader, contexts) || !read_io(reader, io_saved) || !read_mem(reader, snapshot, host.mem.page_size)) {
+        LOG_ERROR("Save state {} is truncated.", path);
+        return false;
+    }
+
+    // Same-session check: every captured thread must still exist, since the
+    // restored registers only mean anything on the kernel objects they came
+    // from.
+    {
+        const std::shared_lock<std::shared_mutex> lock(host.kernel.mutex);
+        for (const ThreadContexts::value_type &context : contexts) {
+            if (!host.kernel.threads.find(context.first)) {
+                LOG_ERROR("Save state thread {} no longer exists - states restore into a running session of the same title.", context.first);
+                return false;
+            }
+        }
+    }
+
+    const std::vector<SceUID> paused = pause_all_threads(host.kernel);
+
+    restore_snapshot(host.mem, snapshot);
+    restore_thread_contexts(host.kernel, contexts);
+    const bool io_ok = restore_io_state(host.io, io_saved);
+
+    resume_threads(host.kernel, paused);
+
+    if (!io_ok) {
+        LOG_ERROR("File table restore failed - guest file handles are stale.");
+        return false;
+    }
+
+    LOG_INFO("Restored state from {} ({} pages).", path, snapshot.pages.size());
+    return true;
+}
+
+std::string save_state_path(HostState &host) {
+    const std::string directory = host.pref_path + "savestates";
+    fs::create_directory(directory);
+    return directory + "/" + host.io.title_id + ".sav";
+}
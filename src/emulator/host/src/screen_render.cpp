@@ -16,11 +16,34 @@
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
 #include <host/screen_render.h>
+
+#include <host/display_format.h>
 #include <host/state.h>
+#include <util/fs.h>
 #include <util/log.h>
 
-bool gl_screen_renderer::init(const std::string &base_path) {
+#include <gxm/gpu_timer_functions.h>
+
+#include <miniz.h>
+
+#include <cinttypes>
+#include <cstring>
+#include <fstream>
+
+// Frames the encoder may hold before new ones are dropped. Three 960x544
+// RGBA frames is ~6 MB; a slow disk stalls capture, never the present.
+static constexpr size_t ENCODER_QUEUE_LIMIT = 8;
+
+bool gl_screen_renderer::init(const std::string &base_path, const std::string &pref_path) {
     glGenTextures(1, &m_screen_texture);
+    glGenBuffers(2, m_pbos);
+    glGenBuffers(capture_ring_size, m_capture_pbos);
+    m_capture_dir = pref_path + "captures/";
+
+    if (!::init(m_gpu_timer)) {
+        LOG_ERROR("Couldn't create GPU timer queries for the present path.");
+        return false;
+    }
 
     const auto builtin_shaders_path = base_path + "shaders-builtin/";
 
@@ -82,22 +105,188 @@ void gl_screen_renderer::render(DisplayState &display, MemState &mem) {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     if (display.image_size.width > 0) {
+        gpu_timer_begin(m_gpu_timer, GPU_TIMER_STAGE_PRESENT);
+
         glViewport(0, 0, display.image_size.width, display.image_size.height);
         glUseProgram(*m_render_shader);
         glBindVertexArray(m_vao);
 
         glBindTexture(GL_TEXTURE_2D, m_screen_texture);
-        const auto pixels = display.base.cast<void>().get(mem);
+
+        // The unpack format tracks the guest pixel format, so the GPU
+        // consumes whatever layout the title set with no CPU conversion.
+        DisplayFormatGL gl_format = {};
+        if (!display_format_to_gl(display.pixelformat, gl_format)) {
+            // SetFrameBuf rejects unknown formats; belt and braces.
+            display_format_to_gl(SCE_DISPLAY_PIXELFORMAT_A8B8G8R8, gl_format);
+        }
+
+        // Storage is only (re)specified when the frame size or format
+        // changes; each present then streams into the existing texture.
+        const uint32_t width = display.window_size.width;
+        const uint32_t height = display.window_size.height;
+        if ((width != m_texture_width) || (height != m_texture_height) || (display.pixelformat != m_texture_pixelformat)) {
+            glTexImage2D(GL_TEXTURE_2D, 0, gl_format.internal_format, width, height, 0, gl_format.format, gl_format.type, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            m_texture_width = width;
+            m_texture_height = height;
+            m_texture_pixelformat = display.pixelformat;
+        }
+
+        // Stage the frame in this present's half of the unpack ring. The
+        // buffer is orphaned first so the map never waits on the transfer
+        // still draining from the previous frame, and the copy keeps the
+        // guest pitch - the unpack row length skips the padding.
+        const void *pixels = display.base.cast<const void>().get(mem);
+        const void *unpack_offset = pixels;
+        const size_t frame_bytes = static_cast<size_t>(display.pitch) * height * gl_format.bytes_per_pixel;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbos[m_next_pbo]);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(frame_bytes), nullptr, GL_STREAM_DRAW);
+        void *const staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(frame_bytes), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (staging != nullptr) {
+            memcpy(staging, pixels, frame_bytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            unpack_offset = nullptr;
+        } else {
+            // The driver refused the mapping - upload from client memory.
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
 
         glPixelStorei(GL_UNPACK_ROW_LENGTH, display.pitch);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, display.window_size.width, display.window_size.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, gl_format.format, gl_format.type, unpack_offset);
         glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glBindTexture(GL_TEXTURE_2D, m_screen_texture);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        m_next_pbo = (m_next_pbo + 1) % 2;
 
         glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+        if (display.continuous_capture.load(std::memory_order_relaxed) || (display.screenshot_requests.load(std::memory_order_relaxed) != 0)) {
+            capture_frame(display);
+        }
+
+        gpu_timer_end(m_gpu_timer, GPU_TIMER_STAGE_PRESENT);
+        gpu_timer_end_frame(m_gpu_timer);
+
+        // Mirrored into the display state so the GUI can show the present
+        // alongside the render-thread stages it has no other path to.
+        const GpuTimerStageTimings &present = m_gpu_timer.stages[GPU_TIMER_STAGE_PRESENT].timings;
+        display.present_time_last_ns = present.last_frame_ns;
+        display.present_time_avg_ns = present.average_frame_ns;
+    }
+}
+
+// Issues this frame's readback into the current pack slot and harvests the
+// oldest one. By the time a slot comes around again its transfer has had the
+// whole ring to drain, so the map returns without stalling the pipeline.
+void gl_screen_renderer::capture_frame(DisplayState &display) {
+    const uint32_t width = display.image_size.width;
+    const uint32_t height = display.image_size.height;
+    if ((width == 0) || (height == 0)) {
+        return;
+    }
+
+    start_encoder();
+
+    const int slot = m_capture_slot;
+    const size_t frame_bytes = static_cast<size_t>(width) * height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_capture_pbos[slot]);
+    if ((m_capture_widths[slot] != width) || (m_capture_heights[slot] != height)) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(frame_bytes), nullptr, GL_STREAM_READ);
+        m_capture_widths[slot] = width;
+        m_capture_heights[slot] = height;
+    }
+    glReadBuffer(GL_BACK);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    m_capture_pending[slot] = true;
+    m_capture_indices[slot] = m_capture_frame_index++;
+    uint32_t shots = display.screenshot_requests.load(std::memory_order_relaxed);
+    while ((shots != 0) && !display.screenshot_requests.compare_exchange_weak(shots, shots - 1)) {
+    }
+    m_capture_screenshot[slot] = (shots != 0);
+    m_capture_slot = (slot + 1) % capture_ring_size;
+
+    const int oldest = m_capture_slot;
+    if (m_capture_pending[oldest]) {
+        const size_t oldest_bytes = static_cast<size_t>(m_capture_widths[oldest]) * m_capture_heights[oldest] * 4;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_capture_pbos[oldest]);
+        const void *const data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(oldest_bytes), GL_MAP_READ_BIT);
+        if (data != nullptr) {
+            CaptureFrame frame;
+            frame.width = m_capture_widths[oldest];
+            frame.height = m_capture_heights[oldest];
+            frame.index = m_capture_indices[oldest];
+            frame.screenshot = m_capture_screenshot[oldest];
+            frame.rgba.assign(static_cast<const uint8_t *>(data), static_cast<const uint8_t *>(data) + oldest_bytes);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+            const std::lock_guard<std::mutex> lock(m_encoder_mutex);
+            if (m_encoder_queue.size() < ENCODER_QUEUE_LIMIT) {
+                m_encoder_queue.push_back(std::move(frame));
+                m_encoder_cv.notify_one();
+            } else {
+                ++m_capture_dropped;
+            }
+        }
+        m_capture_pending[oldest] = false;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void gl_screen_renderer::start_encoder() {
+    if (m_encoder.joinable()) {
+        return;
+    }
+    fs::create_directory(m_capture_dir);
+    m_encoder_stop = false;
+    m_encoder = std::thread(&gl_screen_renderer::encoder_run, this);
+}
+
+void gl_screen_renderer::stop_encoder() {
+    if (!m_encoder.joinable()) {
+        return;
+    }
+    {
+        const std::lock_guard<std::mutex> lock(m_encoder_mutex);
+        m_encoder_stop = true;
+    }
+    m_encoder_cv.notify_one();
+    m_encoder.join();
+    if (m_capture_dropped != 0) {
+        LOG_WARN("Capture encoder fell behind; {} frames dropped.", m_capture_dropped);
+        m_capture_dropped = 0;
+    }
+}
+
+// Runs off the render thread: drains queued frames and writes each as a
+// PNG. The flip to top-down rows happens inside the encoder.
+void gl_screen_renderer::encoder_run() {
+    for (;;) {
+        CaptureFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(m_encoder_mutex);
+            m_encoder_cv.wait(lock, [this]() { return m_encoder_stop || !m_encoder_queue.empty(); });
+            if (m_encoder_queue.empty()) {
+                break;
+            }
+            frame = std::move(m_encoder_queue.front());
+            m_encoder_queue.pop_front();
+        }
+
+        size_t png_size = 0;
+        void *const png = tdefl_write_image_to_png_file_in_memory_ex(frame.rgba.data(), frame.width, frame.height, 4, &png_size, MZ_DEFAULT_LEVEL, MZ_TRUE);
+        if (png == nullptr) {
+            continue;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), frame.screenshot ? "screenshot-%06" PRIu64 ".png" : "frame-%06" PRIu64 ".png", frame.index);
+        const std::string path = m_capture_dir + name;
+        std::ofstream out(path, std::ofstream::binary);
+        out.write(static_cast<const char *>(png), png_size);
+        mz_free(png);
+        if (frame.screenshot) {
+            LOG_INFO("Screenshot written to {}.", path);
+        }
     }
 }
 
@@ -106,6 +295,16 @@ GLuint gl_screen_renderer::get_screen_texture() const {
 }
 
 void gl_screen_renderer::destroy() {
+    stop_encoder();
+
+    glDeleteBuffers(capture_ring_size, m_capture_pbos);
+    for (int i = 0; i < capture_ring_size; ++i) {
+        m_capture_pbos[i] = 0;
+        m_capture_widths[i] = 0;
+        m_capture_heights[i] = 0;
+        m_capture_pending[i] = false;
+    }
+
     const GLuint vbos[] = { m_vbo };
     glDeleteBuffers(1, vbos);
     m_vbo = 0;
@@ -117,6 +316,13 @@ void gl_screen_renderer::destroy() {
     const GLuint textures[] = { m_screen_texture };
     glDeleteTextures(1, textures);
     m_screen_texture = 0;
+
+    glDeleteBuffers(2, m_pbos);
+    m_pbos[0] = 0;
+    m_pbos[1] = 0;
+    m_texture_width = 0;
+    m_texture_height = 0;
+    m_texture_pixelformat = 0xffffffff;
 }
 
 gl_screen_renderer::~gl_screen_renderer() {
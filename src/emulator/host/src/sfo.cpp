@@ -17,31 +17,51 @@
 
 #include <host/sfo.h>
 
+#include <util/string_convert.h>
+
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
-
-bool load_sfo(SfoFile &sfile, const std::vector<uint8_t> &content) {
-    if (content.empty()) {
+#include <fstream>
+
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool load_sfo(SfoFile &sfile, const uint8_t *content, size_t size) {
+    if (size < sizeof(SfoHeader)) {
         return false;
     }
 
-    memcpy(static_cast<void *>(&sfile.header), content.data(), sizeof(SfoHeader));
+    memcpy(static_cast<void *>(&sfile.header), content, sizeof(SfoHeader));
+
+    const size_t index_table_end = sizeof(SfoHeader) + sfile.header.tables_entries * sizeof(SfoIndexTableEntry);
+    if ((index_table_end > size) || (sfile.header.key_table_start > size) || (sfile.header.data_table_start > size)) {
+        return false;
+    }
 
     sfile.entries.resize(sfile.header.tables_entries + 1);
 
     for (uint32_t i = 0; i < sfile.header.tables_entries; i++) {
-        memcpy(static_cast<void *>(&sfile.entries[i].entry), content.data() + sizeof(SfoHeader) + i * sizeof(SfoIndexTableEntry), sizeof(SfoIndexTableEntry));
+        memcpy(static_cast<void *>(&sfile.entries[i].entry), content + sizeof(SfoHeader) + i * sizeof(SfoIndexTableEntry), sizeof(SfoIndexTableEntry));
     }
 
     sfile.entries[sfile.header.tables_entries].entry.key_offset = sfile.header.data_table_start - sfile.header.key_table_start;
 
     for (uint32_t i = 0; i < sfile.header.tables_entries; i++) {
         uint32_t keySize = sfile.entries[i + 1].entry.key_offset - sfile.entries[i].entry.key_offset;
+        if (sfile.header.key_table_start + sfile.entries[i].entry.key_offset + keySize > size) {
+            return false;
+        }
 
         sfile.entries[i].data.first.resize(keySize);
 
-        memcpy(&sfile.entries[i].data.first[0], &content[sfile.header.key_table_start + sfile.entries[i].entry.key_offset], keySize);
+        memcpy(&sfile.entries[i].data.first[0], content + sfile.header.key_table_start + sfile.entries[i].entry.key_offset, keySize);
 
         //Quick hack to remove garbage null terminator caused by reading directly
         //to buffer
@@ -50,11 +70,14 @@ bool load_sfo(SfoFile &sfile, const std::vector<uint8_t> &content) {
 
     for (uint32_t i = 0; i < sfile.header.tables_entries; i++) {
         uint32_t dataSize = sfile.entries[i].entry.data_len;
+        if ((dataSize == 0) || (sfile.header.data_table_start + sfile.entries[i].entry.data_offset + dataSize > size)) {
+            continue;
+        }
 
         sfile.entries[i].data.second.resize(dataSize);
 
         // The last of data is a terminator
-        memcpy(&sfile.entries[i].data.second[0], &content[sfile.header.data_table_start + sfile.entries[i].entry.data_offset], dataSize - 1);
+        memcpy(&sfile.entries[i].data.second[0], content + sfile.header.data_table_start + sfile.entries[i].entry.data_offset, dataSize - 1);
 
         //Quick hack to remove garbage null terminator caused by reading directly
         //to buffer
@@ -64,6 +87,72 @@ bool load_sfo(SfoFile &sfile, const std::vector<uint8_t> &content) {
     return true;
 }
 
+bool load_sfo(SfoFile &sfile, const std::vector<uint8_t> &content) {
+    if (content.empty()) {
+        return false;
+    }
+
+    return load_sfo(sfile, content.data(), content.size());
+}
+
+bool load_sfo_file(SfoFile &file, const std::string &host_path) {
+#ifdef WIN32
+    const HANDLE handle = CreateFileW(utf_to_wide(host_path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(handle, &file_size) || (file_size.QuadPart == 0)) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    const HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping != nullptr) {
+        const void *const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view != nullptr) {
+            const bool ok = load_sfo(file, static_cast<const uint8_t *>(view), static_cast<size_t>(file_size.QuadPart));
+            UnmapViewOfFile(view);
+            CloseHandle(mapping);
+            CloseHandle(handle);
+            return ok;
+        }
+        CloseHandle(mapping);
+    }
+    CloseHandle(handle);
+#else
+    const int fd = open(host_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat sb;
+    if ((fstat(fd, &sb) != 0) || (sb.st_size == 0)) {
+        close(fd);
+        return false;
+    }
+
+    void *const base = mmap(nullptr, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (base != MAP_FAILED) {
+        const bool ok = load_sfo(file, static_cast<const uint8_t *>(base), sb.st_size);
+        munmap(base, sb.st_size);
+        close(fd);
+        return ok;
+    }
+    close(fd);
+#endif
+
+    // Mapping failed - fall back to a plain read.
+    std::ifstream in(host_path, std::ifstream::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    const std::vector<uint8_t> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    return load_sfo(file, content);
+}
+
 bool find_data(std::string &out_data, SfoFile &file, const std::string &key) {
     auto res = std::find_if(file.entries.begin(), file.entries.end(),
         [key](auto et) { return et.data.first == key; });
@@ -0,0 +1,182 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <host/watchdog.h>
+
+#include <host/state.h>
+
+#include <cpu/functions.h>
+#include <disasm/functions.h>
+#include <disasm/state.h>
+#include <kernel/debug_snapshot.h>
+#include <kernel/state.h>
+#include <kernel/thread/thread_state.h>
+#include <mem/ptr.h>
+#include <util/log.h>
+
+#include <SDL_stdinc.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+static constexpr uint32_t WATCHDOG_DEFAULT_SECONDS = 10;
+
+static const char *to_do_label(ThreadToDo to_do) {
+    switch (to_do) {
+    case ThreadToDo::run:
+        return "run";
+    case ThreadToDo::wait:
+        return "wait";
+    case ThreadToDo::exit:
+        return "exit";
+    }
+    return "?";
+}
+
+// Logs a few instructions at address. Thumb-2 wide instructions make the
+// naive 2-byte step land mid-instruction occasionally; for a hang dump an
+// off-by-one line beats no disassembly.
+static void dump_code_around(HostState &host, DisasmState &disasm, const char *label, Address address, bool thumb) {
+    Address current = address & ~1;
+    for (int i = 0; i < 4; ++i) {
+        if (!is_valid_address(host.mem, current) || !is_valid_address(host.mem, current + 3)) {
+            break;
+        }
+        const uint8_t *const code = Ptr<const uint8_t>(current).get(host.mem);
+        const std::string line = disassemble(disasm, code, 4, current, thumb);
+        LOG_ERROR("Watchdog:     {} {}: {}", label, log_hex(current), line);
+        current += thumb ? 2 : 4;
+    }
+}
+
+static void dump_hang_bundle(HostState &host) {
+    LOG_ERROR("Watchdog: no frame or draw for {} seconds - capturing guest state (process keeps running).", host.watchdog.timeout_seconds);
+
+    std::vector<ThreadStatePtr> threads;
+    {
+        const std::shared_lock<std::shared_mutex> lock(host.kernel.mutex);
+        for (const ThreadStatePtrs::value_type &entry : host.kernel.threads) {
+            threads.push_back(entry.second);
+        }
+    }
+
+    DisasmState disasm;
+    if (!init(disasm)) {
+        return;
+    }
+
+    for (const ThreadStatePtr &thread : threads) {
+        if (!thread->cpu) {
+            continue;
+        }
+
+        // Best-effort reads - the register file is sampled while the engine
+        // may be executing, same as the sampling profiler does.
+        const Address pc = read_pc(*thread->cpu);
+        const Address lr = read_lr(*thread->cpu);
+        const Address sp = read_sp(*thread->cpu);
+        const bool thumb = is_thumb_mode(*thread->cpu);
+        LOG_ERROR("Watchdog: thread {} \"{}\" ({}) pc={} lr={} sp={}", thread->id, thread->name, to_do_label(thread->to_do), log_hex(pc), log_hex(lr), log_hex(sp));
+        dump_code_around(host, disasm, "pc", pc, thumb);
+        if (lr != 0) {
+            dump_code_around(host, disasm, "lr", lr, (lr & 1) != 0);
+        }
+    }
+
+    // The wait graph: every sync primitive somebody is blocked on, with the
+    // owner where one exists - enough to read a deadlock cycle from the log.
+    KernelDebugSnapshot snapshot;
+    capture_debug_snapshot(host.kernel, snapshot);
+    for (const MutexSnapshotRow &row : snapshot.mutexes) {
+        if (row.waiters > 0) {
+            LOG_ERROR("Watchdog: mutex {} \"{}\" lock_count={} owner=\"{}\" waiters={}", row.id, row.name, row.lock_count, row.owner, row.waiters);
+        }
+    }
+    for (const MutexSnapshotRow &row : snapshot.lwmutexes) {
+        if (row.waiters > 0) {
+            LOG_ERROR("Watchdog: lwmutex {} \"{}\" lock_count={} owner=\"{}\" waiters={}", row.id, row.name, row.lock_count, row.owner, row.waiters);
+        }
+    }
+    for (const SemaphoreSnapshotRow &row : snapshot.semaphores) {
+        if (row.waiters > 0) {
+            LOG_ERROR("Watchdog: semaphore {} \"{}\" val={}/{} waiters={}", row.id, row.name, row.val, row.max, row.waiters);
+        }
+    }
+    for (const CondvarSnapshotRow &row : snapshot.condvars) {
+        if (row.waiters > 0) {
+            LOG_ERROR("Watchdog: condvar {} \"{}\" waiters={}", row.id, row.name, row.waiters);
+        }
+    }
+    for (const CondvarSnapshotRow &row : snapshot.lwcondvars) {
+        if (row.waiters > 0) {
+            LOG_ERROR("Watchdog: lwcondvar {} \"{}\" waiters={}", row.id, row.name, row.waiters);
+        }
+    }
+    for (const EventFlagSnapshotRow &row : snapshot.eventflags) {
+        if (row.waiters > 0) {
+            LOG_ERROR("Watchdog: eventflag {} \"{}\" flags={} waiters={}", row.id, row.name, log_hex(row.flags), row.waiters);
+        }
+    }
+}
+
+static void watchdog_worker(HostState &host) {
+    WatchdogState &watchdog = host.watchdog;
+
+    // Racy reads of the counters are fine: any torn value differs from the
+    // last one and registers as progress, which only delays a dump.
+    uint64_t last_frames = host.total_frame_count;
+    uint64_t last_draws = host.gxm.draw_count;
+    auto last_progress = std::chrono::steady_clock::now();
+    bool dumped = false;
+
+    while (watchdog.running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+        const uint64_t frames = host.total_frame_count;
+        const uint64_t draws = host.gxm.draw_count;
+        if ((frames != last_frames) || (draws != last_draws)) {
+            last_frames = frames;
+            last_draws = draws;
+            last_progress = std::chrono::steady_clock::now();
+            dumped = false;
+            continue;
+        }
+
+        const auto stalled = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - last_progress).count();
+        if (!dumped && (stalled >= watchdog.timeout_seconds)) {
+            dump_hang_bundle(host);
+            // One bundle per hang; progress re-arms the dump.
+            dumped = true;
+        }
+    }
+}
+
+void start_watchdog(HostState &host) {
+    uint32_t seconds = WATCHDOG_DEFAULT_SECONDS;
+    const char *const override_seconds = SDL_getenv("VITA3K_WATCHDOG_SECONDS");
+    if (override_seconds) {
+        seconds = static_cast<uint32_t>(strtoul(override_seconds, nullptr, 10));
+    }
+    if (seconds == 0) {
+        return;
+    }
+
+    host.watchdog.timeout_seconds = seconds;
+    host.watchdog.running = true;
+    host.watchdog.worker = std::thread(watchdog_worker, std::ref(host));
+}
@@ -0,0 +1,91 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <psp2/types.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct IOState;
+
+enum class AsyncIoOpType {
+    Open,
+    Read,
+    Close,
+};
+
+// One queued operation. The submitter and the worker share it through a
+// shared_ptr so a deleted op cannot be completed into freed memory.
+struct AsyncIoOp {
+    AsyncIoOpType type;
+    SceUID fd = -1;
+    void *buffer = nullptr;
+    SceSize size = 0;
+    int64_t offset = -1; // -1 reads at the current file position
+    SceUID *fd_out = nullptr; // open: receives the new fd on completion
+    std::string path; // open
+    std::string pref_path; // open
+    int flags = 0; // open
+    std::string export_name; // for the io helpers' logging
+
+    std::mutex mutex;
+    std::condition_variable done_cond;
+    bool done = false;
+    int error = 0;
+    int64_t actual = 0; // bytes transferred, or the fd for opens
+};
+
+typedef std::shared_ptr<AsyncIoOp> AsyncIoOpPtr;
+
+// Async engine behind the Fios2 operation handles - one host worker services
+// a FIFO of operations and completes them into the op records. The worker
+// starts lazily on the first submit.
+struct AsyncIoState {
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::deque<AsyncIoOpPtr> queue;
+    std::map<int32_t, AsyncIoOpPtr> ops;
+    int32_t next_op = 1;
+    bool initialized = false;
+    bool stop = false;
+    std::thread worker;
+
+    ~AsyncIoState();
+};
+
+int32_t async_submit_open(IOState &io, const char *path, int flags, SceUID *fd_out, const char *pref_path, const char *export_name);
+int32_t async_submit_read(IOState &io, SceUID fd, void *buffer, SceSize size, int64_t offset, const char *export_name);
+int32_t async_submit_close(IOState &io, SceUID fd, const char *export_name);
+
+// Registers an already-finished operation, for requests the caller served
+// inline (archive mounts, cache-backed archive reads) that still hand an op
+// handle back to the title.
+int32_t async_register_completed(IOState &io, int error, int64_t actual);
+
+AsyncIoOpPtr async_find_op(IOState &io, int32_t op_id);
+int async_wait_op(IOState &io, int32_t op_id);
+bool async_delete_op(IOState &io, int32_t op_id);
+bool async_is_idle(IOState &io);
+void async_shutdown(AsyncIoState &async);
@@ -0,0 +1,117 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <psp2/types.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct IOState;
+
+// Archive file handles live above this base so they never collide with the
+// fd table - the Fios2 exports route by range.
+constexpr SceUID FIOS_ARCHIVE_FH_BASE = 0x40000000;
+
+// One file of a mounted PSARC, from the table of contents.
+struct FiosArchiveEntry {
+    uint32_t first_block = 0; // index into the mount's block table
+    int64_t size = 0; // uncompressed
+    int64_t data_offset = 0; // first block's stored bytes within the archive
+};
+
+// A PSARC mounted at a Fios2 mount point. The central index - table of
+// contents, block table and manifest names - is loaded once at mount time;
+// after that a lookup is a map find and reads touch only the blocks they
+// cover. The archive itself stays open through the regular io layer, so a
+// PSARC inside the title's VPK works the same as one on disk.
+struct FiosArchiveMount {
+    SceUID id = -1; // the handle the mount was issued as
+    SceUID fd = -1; // the archive, open through the io layer
+    std::string mount_point; // normalized, no leading or trailing slash
+    uint32_t block_size = 0;
+    bool ignore_case = false;
+    std::vector<uint32_t> block_table; // stored size per block, 0 = full raw block
+    std::vector<uint64_t> block_prefix; // running sum of stored sizes
+    std::map<std::string, FiosArchiveEntry> entries; // keyed by normalized name
+};
+
+typedef std::shared_ptr<FiosArchiveMount> FiosArchiveMountPtr;
+
+struct FiosArchiveFile {
+    FiosArchiveMountPtr mount;
+    const FiosArchiveEntry *entry = nullptr;
+    int64_t position = 0;
+};
+
+typedef std::shared_ptr<std::vector<uint8_t>> FiosBlockPtr;
+
+struct FiosCachedBlock {
+    FiosBlockPtr data;
+    uint64_t last_used = 0;
+};
+
+struct FiosOverlay {
+    uint8_t type = 0;
+    uint8_t order = 0;
+    int32_t id = 0;
+    std::string dst; // the path prefix the title asks for
+    std::string src; // where it actually resolves
+};
+
+// Fios2 layer state: archive mounts with a decompressed-block cache shared
+// across all handles, and the overlay set plus the resolution table it is
+// baked into (sorted by order then id) whenever an overlay is added,
+// removed or modified.
+struct FiosState {
+    std::mutex mutex;
+    std::map<SceUID, FiosArchiveMountPtr> mounts; // keyed by mount handle
+    std::map<SceUID, FiosArchiveFile> files;
+    SceUID next_fh = FIOS_ARCHIVE_FH_BASE;
+    std::map<std::pair<SceUID, uint32_t>, FiosCachedBlock> blocks; // mount id, block index
+    uint64_t block_bytes = 0;
+    uint64_t use_counter = 0;
+    std::vector<FiosOverlay> overlays; // as added
+    std::vector<FiosOverlay> overlay_table; // resolution order
+    int32_t next_overlay_id = 1;
+    int decompressor_threads = 1;
+};
+
+int fios_mount_archive(IOState &io, const char *path, const char *mount_point, SceUID *fh_out, const char *pref_path, const char *export_name);
+int fios_unmount_archive(IOState &io, SceUID fh, const char *export_name);
+
+// Overlay-mapped candidates for a path, highest priority first, with the
+// original path last as the fallback.
+std::vector<std::string> fios_resolve_overlays(IOState &io, const char *path);
+
+SceUID fios_open_archive_file(IOState &io, const char *path);
+bool fios_is_archive_fh(SceUID fh);
+int fios_read_archive_file(IOState &io, SceUID fh, void *buffer, SceSize size, int64_t offset, const char *export_name);
+int64_t fios_seek_archive_file(IOState &io, SceUID fh, int64_t offset, int whence);
+int64_t fios_archive_file_size(IOState &io, SceUID fh);
+void fios_close_archive_file(IOState &io, SceUID fh);
+
+int fios_overlay_add(IOState &io, uint8_t type, uint8_t order, const char *dst, const char *src, int32_t *id_out);
+int fios_overlay_remove(IOState &io, int32_t id);
+int fios_overlay_modify(IOState &io, int32_t id, uint8_t type, uint8_t order, const char *dst, const char *src);
+bool fios_overlay_get(IOState &io, int32_t id, FiosOverlay &out);
+std::vector<int32_t> fios_overlay_ids(IOState &io);
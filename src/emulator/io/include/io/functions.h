@@ -19,27 +19,70 @@
 
 #include <psp2/types.h>
 
+#include <io/io.h>
 #include <io/types.h>
 
 #include <miniz.h>
+#include <cstdio>
+#include <memory>
 #include <string>
+#include <vector>
 
+struct DirSnapshot;
 struct IOState;
 struct SceIoStat;
 struct SceIoDirent;
+struct TranslatedPath;
+struct VpkEntry;
 
 void init_device_paths(IOState &io);
+const TranslatedPath &translate_path_cached(IOState &io, const std::string &path);
+std::string to_host_path(const std::string &path, const std::string &pref_path, VitaIoDevice device);
 
 bool init(IOState &io, const char *pref_path);
 SceUID open_file(IOState &io, const std::string &path_, int flags, const char *pref_path, const char *export_name);
 int read_file(void *data, IOState &io, SceUID fd, SceSize size, const char *export_name);
-int write_file(SceUID fd, const void *data, SceSize size, const IOState &io, const char *export_name);
+int pread_file(void *data, IOState &io, SceUID fd, SceSize size, SceOff offset, const char *export_name);
+int write_file(SceUID fd, const void *data, SceSize size, IOState &io, const char *export_name);
 int seek_file(SceUID fd, int offset, int whence, IOState &io, const char *export_name);
+int sync_file(IOState &io, SceUID fd, const char *export_name);
 void close_file(IOState &io, SceUID fd, const char *export_name);
 int create_dir(IOState &io, const char *dir, int mode, const char *pref_path, const char *export_name);
 int remove_file(IOState &io, const char *file, const char *pref_path, const char *export_name);
 int remove_dir(IOState &io, const char *dir, const char *pref_path, const char *export_name);
 int stat_file(IOState &io, const char *file, SceIoStat *stat, const char *pref_path, uint64_t base_tick, const char *export_name);
+// Streams every file in the prewarm manifest through the normal read path,
+// priming the host page cache and the VPK block cache before the title asks.
+void prewarm_files(IOState &io, const char *pref_path);
+
+bool init_vpk_mount(IOState &io, FILE *fp);
+VpkEntry *vpk_find_entry(IOState &io, const std::string &translated_path);
+int vpk_read(IOState &io, VpkEntry &entry, void *data, SceSize size, int64_t offset);
+std::shared_ptr<DirSnapshot> vpk_snapshot_dir(IOState &io, const std::string &translated_path);
+bool read_mounted_file(std::vector<uint8_t> &buf, IOState &io, const char *path);
+
+bool dump_io_telemetry(IOState &io, const std::string &path);
+
+// Save states: a serializable description of the fd table. Files and VPK
+// entries record enough to reopen and seek; file contents are whatever is on
+// disk at restore time, and open directory handles are not restored.
+struct SavedFd {
+    SceUID fd = -1;
+    int kind = 0; // FdKind
+    int tty = 0; // TtyType
+    std::string guest_path;
+    std::string host_path;
+    int open_flags = 0;
+    int64_t position = 0;
+};
+
+struct SavedIoState {
+    size_t slot_count = 0;
+    std::vector<SavedFd> fds;
+};
+
+void capture_io_state(IOState &io, SavedIoState &saved);
+bool restore_io_state(IOState &io, const SavedIoState &saved);
 
 int open_dir(IOState &io, const char *path, const char *pref_path, const char *export_name);
 int read_dir(IOState &io, SceUID fd, emu::SceIoDirent *dent, const char *export_name);
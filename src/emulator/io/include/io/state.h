@@ -20,36 +20,232 @@
 #include <miniz.h>
 #include <psp2/types.h>
 
+#include <io/async.h>
 #include <io/file.h>
+#include <io/fios.h>
+#include <io/io.h>
+#include <io/types.h>
 
+#include <util/prewarm.h>
+
+#include <chrono>
 #include <cstdio>
+#include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
 
+// A guest file over a raw host descriptor. Reads and writes are positioned
+// at our own cursor (pread/pwrite style), so concurrent operations on one fd
+// never race on a shared kernel offset, and read-only files above the
+// mapping threshold are mmapped so reads become a memcpy from the page
+// cache.
+struct StdFile {
+    int fd = -1;
+    int64_t position = 0; // sequential read/write/seek cursor
+    int64_t size = 0; // size at open, kept current by writes
+    std::string guest_path; // for stat cache invalidation on write
+    std::string host_path; // for save states: reopen-and-seek restore
+    int open_flags = 0; // host flags the fd was opened with
+    // Write-behind: small sequential writes coalesce here until the run
+    // breaks, the buffer fills, or the fd is synced or closed.
+    std::vector<uint8_t> pending;
+    int64_t pending_ofs = 0;
+    const uint8_t *mapped_base = nullptr;
 #ifdef WIN32
-struct _WDIR;
-#else
-#include <dirent.h>
+    void *mapping_handle = nullptr;
 #endif
 
-typedef std::shared_ptr<FILE> FilePtr;
+    ~StdFile();
+};
+
+typedef std::shared_ptr<StdFile> StdFilePtr;
 typedef std::shared_ptr<mz_zip_archive> ZipPtr;
 typedef std::shared_ptr<mz_zip_reader_extract_iter_state> ZipFilePtr;
 
-#ifdef _WIN32
-typedef std::shared_ptr<_WDIR> DirPtr;
-#else
-typedef std::shared_ptr<DIR> DirPtr;
-#endif
+// Listing of a host directory taken in one pass at open_dir time, with the
+// names already converted, so each read_dir is a bounds-checked copy of the
+// next record. Snapshots are shared and briefly cached by host path for the
+// boot-time pattern of re-enumerating the same asset directories.
+struct DirSnapshot {
+    std::vector<emu::SceIoDirent> entries;
+    std::chrono::steady_clock::time_point taken_at;
+};
+
+typedef std::shared_ptr<DirSnapshot> DirSnapshotPtr;
+
+struct OpenDir {
+    DirSnapshotPtr snapshot;
+    size_t next = 0;
+};
+
+typedef std::map<std::string, DirSnapshotPtr> DirSnapshotCache;
+
+// Recent stat results keyed by guest path - titles poll their save files
+// every frame. Entries expire after a short TTL and are evicted by our own
+// mutating operations (write/create/remove), so repeated stats of unchanged
+// files cost a map lookup instead of a host syscall.
+struct CachedStat {
+    SceIoStat stat;
+    std::chrono::steady_clock::time_point taken_at;
+};
+
+typedef std::map<std::string, CachedStat> StatCache;
+
+// One entry of a VPK mounted in place, indexed from the central directory at
+// mount time. Stored entries are read straight from the archive at their raw
+// data offset, which is resolved from the local header on first use.
+struct VpkEntry {
+    mz_uint index = 0;
+    int64_t size = 0;
+    uint64_t local_header_ofs = 0;
+    int64_t data_ofs = -1; // raw stored data, -1 until resolved
+    time_t mtime = 0;
+    bool compressed = false;
+    bool is_dir = false;
+};
+
+typedef std::shared_ptr<std::vector<uint8_t>> VpkDataPtr;
+
+struct VpkInflated {
+    VpkDataPtr data;
+    uint64_t last_used = 0;
+};
+
+// The title's VPK mounted in place instead of extracted to pref_path: the
+// central directory is indexed once at mount, stored entries are served by
+// positioned reads of the archive itself, and deflated entries are inflated
+// once into a bounded least-recently-used cache.
+struct VpkMount {
+    ZipPtr zip;
+    FILE *fp = nullptr;
+    int fd = -1; // descriptor behind fp, for positioned stored-entry reads
+    std::map<std::string, VpkEntry> entries; // keyed by app-root-relative path
+    std::map<mz_uint, VpkInflated> inflated;
+    uint64_t inflated_bytes = 0;
+    uint64_t use_counter = 0;
+    std::mutex mutex;
+
+    ~VpkMount();
+};
+
+typedef std::shared_ptr<VpkMount> VpkMountPtr;
+
+struct VpkFile {
+    VpkEntry *entry = nullptr;
+    int64_t position = 0;
+    std::string guest_path; // for telemetry and stat invalidation parity
+};
+
+typedef std::shared_ptr<VpkFile> VpkFilePtr;
 
 enum TtyType {
     TTY_IN,
     TTY_OUT
 };
 
-typedef std::map<SceUID, TtyType> TtyFiles;
-typedef std::map<SceUID, FilePtr> StdFiles;
-typedef std::map<SceUID, DirPtr> DirEntries;
+// Memoized device-prefix translation - repeat operations on the same guest
+// path reuse the resolved path and device instead of rescanning the string.
+// Cleared when init_device_paths remounts the title devices.
+struct TranslatedPath {
+    std::string path;
+    VitaIoDevice device = VitaIoDevice::_UKNONWN;
+};
+
+typedef std::map<std::string, TranslatedPath> PathCache;
+
+// Opt-in I/O telemetry, aggregated per guest path across opens. Latency
+// histograms use power-of-two microsecond buckets (bucket n covers
+// [2^(n-1), 2^n) us, bucket 0 is sub-microsecond), which is enough to tell
+// page-cache hits from disk stalls at a glance.
+constexpr size_t IO_LATENCY_BUCKETS = 16;
+
+struct IoOpStats {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    uint64_t latency_us_hist[IO_LATENCY_BUCKETS] = {};
+};
+
+struct IoFdStats {
+    uint64_t opens = 0;
+    uint64_t seeks = 0;
+    uint64_t sequential_reads = 0;
+    uint64_t random_reads = 0;
+    int64_t next_sequential = 0; // where the next read lands if sequential
+    IoOpStats reads;
+    IoOpStats writes;
+    std::map<std::string, uint64_t> callers; // ops per HLE export
+};
+
+struct IoTelemetry {
+    bool enabled = false; // costs nothing until flipped on
+    std::mutex mutex; // guards files; held only while recording, not while timing
+    std::map<std::string, IoFdStats> files;
+};
+
+enum class FdKind {
+    Free,
+    Tty,
+    File,
+    VpkFile,
+    Dir,
+};
+
+// One open handle. Every flavor shares the slot array, so resolving any fd
+// on the read/write/seek/close paths is a bounds check and an array index
+// instead of a map walk, and closed fds are reissued through a free list.
+struct FdSlot {
+    FdKind kind = FdKind::Free;
+    TtyType tty = TTY_IN;
+    StdFilePtr file;
+    VpkFilePtr vpk_file;
+    OpenDir dir;
+};
+
+struct FdTable {
+    // A deque so slot storage is stable while the table grows: get() hands
+    // out pointers that parallel guest threads keep using across an emplace
+    // from another thread, where a vector reallocation would leave them
+    // dangling. The lock serializes the slot and free-list bookkeeping -
+    // shared on the hot resolve path, exclusive for open/close. Operating on
+    // an fd while another thread closes it stays a guest bug, as on the real
+    // kernel.
+    std::deque<FdSlot> slots;
+    std::vector<SceUID> free_fds;
+    mutable std::shared_mutex mutex;
+
+    // Issues an fd for the slot, reusing a closed one when available.
+    SceUID emplace(FdSlot slot) {
+        const std::lock_guard<std::shared_mutex> lock(mutex);
+        if (!free_fds.empty()) {
+            const SceUID fd = free_fds.back();
+            free_fds.pop_back();
+            slots[fd] = std::move(slot);
+            return fd;
+        }
+        slots.push_back(std::move(slot));
+        return static_cast<SceUID>(slots.size() - 1);
+    }
+
+    FdSlot *get(SceUID fd) {
+        const std::shared_lock<std::shared_mutex> lock(mutex);
+        if ((fd < 0) || (static_cast<size_t>(fd) >= slots.size()) || (slots[fd].kind == FdKind::Free)) {
+            return nullptr;
+        }
+        return &slots[fd];
+    }
+
+    void close(SceUID fd) {
+        const std::lock_guard<std::shared_mutex> lock(mutex);
+        if ((fd < 0) || (static_cast<size_t>(fd) >= slots.size()) || (slots[fd].kind == FdKind::Free)) {
+            return;
+        }
+        slots[fd] = FdSlot();
+        free_fds.push_back(fd);
+    }
+};
 
 struct IOState {
     struct DevicePaths {
@@ -59,8 +255,24 @@ struct IOState {
     } device_paths;
 
     std::string title_id;
-    SceUID next_fd = 0;
-    TtyFiles tty_files;
-    StdFiles std_files;
-    DirEntries dir_entries;
+    FdTable fds;
+    VpkMountPtr vpk;
+    // Taken shared on the hit path - once the working set of paths is
+    // cached, every io call is a lookup and they should not serialize.
+    std::shared_mutex path_cache_mutex;
+    PathCache path_cache;
+    std::mutex dir_snapshots_mutex;
+    DirSnapshotCache dir_snapshots;
+    // A plain mutex: even the stat hit path erases expired entries, so a
+    // shared lock would buy nothing.
+    std::mutex stat_cache_mutex;
+    StatCache stat_cache;
+    IoTelemetry telemetry;
+    // Large read-only opens this session; the next boot streams them into
+    // the host caches ahead of demand (see prewarm_files).
+    PrewarmLog prewarm;
+    FiosState fios;
+    // Last so its destructor joins the worker while the file tables above are
+    // still alive.
+    AsyncIoState async;
 };
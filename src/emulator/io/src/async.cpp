@@ -0,0 +1,196 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <io/async.h>
+
+#include <io/functions.h>
+#include <io/state.h>
+
+AsyncIoState::~AsyncIoState() {
+    async_shutdown(*this);
+}
+
+static void complete_op(const AsyncIoOpPtr &op, int error, int64_t actual) {
+    {
+        const std::lock_guard<std::mutex> lock(op->mutex);
+        op->error = error;
+        op->actual = actual;
+        op->done = true;
+    }
+    op->done_cond.notify_all();
+}
+
+static void async_io_worker(IOState &io) {
+    AsyncIoState &async = io.async;
+
+    for (;;) {
+        AsyncIoOpPtr op;
+        {
+            std::unique_lock<std::mutex> lock(async.mutex);
+            async.work_ready.wait(lock, [&async]() { return async.stop || !async.queue.empty(); });
+            if (async.queue.empty()) {
+                return; // stop requested and nothing left to service
+            }
+            op = async.queue.front();
+            async.queue.pop_front();
+        }
+
+        int error = 0;
+        int64_t actual = 0;
+
+        switch (op->type) {
+        case AsyncIoOpType::Open: {
+            const SceUID fd = open_file(io, op->path, op->flags, op->pref_path.c_str(), op->export_name.c_str());
+            if (fd < 0) {
+                error = fd;
+            } else {
+                actual = fd;
+                if (op->fd_out) {
+                    *op->fd_out = fd;
+                }
+            }
+            break;
+        }
+        case AsyncIoOpType::Read: {
+            // Positioned reads go straight to pread_file, so adjacent
+            // requests coalesce in the page cache without seeking between
+            // them.
+            const int read = (op->offset >= 0)
+                ? pread_file(op->buffer, io, op->fd, op->size, op->offset, op->export_name.c_str())
+                : read_file(op->buffer, io, op->fd, op->size, op->export_name.c_str());
+            if (read < 0) {
+                error = read;
+            } else {
+                actual = read;
+            }
+            break;
+        }
+        case AsyncIoOpType::Close:
+            close_file(io, op->fd, op->export_name.c_str());
+            break;
+        }
+
+        complete_op(op, error, actual);
+    }
+}
+
+static int32_t submit(IOState &io, AsyncIoOpPtr op) {
+    AsyncIoState &async = io.async;
+    const std::lock_guard<std::mutex> lock(async.mutex);
+    if (!async.worker.joinable()) {
+        async.worker = std::thread(async_io_worker, std::ref(io));
+    }
+
+    const int32_t op_id = async.next_op++;
+    async.ops.emplace(op_id, op);
+    async.queue.push_back(std::move(op));
+    async.work_ready.notify_one();
+
+    return op_id;
+}
+
+int32_t async_submit_open(IOState &io, const char *path, int flags, SceUID *fd_out, const char *pref_path, const char *export_name) {
+    const AsyncIoOpPtr op = std::make_shared<AsyncIoOp>();
+    op->type = AsyncIoOpType::Open;
+    op->path = path;
+    op->pref_path = pref_path;
+    op->flags = flags;
+    op->fd_out = fd_out;
+    op->export_name = export_name;
+
+    return submit(io, op);
+}
+
+int32_t async_submit_read(IOState &io, SceUID fd, void *buffer, SceSize size, int64_t offset, const char *export_name) {
+    const AsyncIoOpPtr op = std::make_shared<AsyncIoOp>();
+    op->type = AsyncIoOpType::Read;
+    op->fd = fd;
+    op->buffer = buffer;
+    op->size = size;
+    op->offset = offset;
+    op->export_name = export_name;
+
+    return submit(io, op);
+}
+
+int32_t async_submit_close(IOState &io, SceUID fd, const char *export_name) {
+    const AsyncIoOpPtr op = std::make_shared<AsyncIoOp>();
+    op->type = AsyncIoOpType::Close;
+    op->fd = fd;
+    op->export_name = export_name;
+
+    return submit(io, op);
+}
+
+int32_t async_register_completed(IOState &io, int error, int64_t actual) {
+    const AsyncIoOpPtr op = std::make_shared<AsyncIoOp>();
+    op->done = true;
+    op->error = error;
+    op->actual = actual;
+
+    AsyncIoState &async = io.async;
+    const std::lock_guard<std::mutex> lock(async.mutex);
+    const int32_t op_id = async.next_op++;
+    async.ops.emplace(op_id, op);
+    return op_id;
+}
+
+AsyncIoOpPtr async_find_op(IOState &io, int32_t op_id) {
+    const std::lock_guard<std::mutex> lock(io.async.mutex);
+    const auto found = io.async.ops.find(op_id);
+    if (found == io.async.ops.end()) {
+        return AsyncIoOpPtr();
+    }
+    return found->second;
+}
+
+int async_wait_op(IOState &io, int32_t op_id) {
+    const AsyncIoOpPtr op = async_find_op(io, op_id);
+    if (!op) {
+        return -1;
+    }
+
+    std::unique_lock<std::mutex> lock(op->mutex);
+    op->done_cond.wait(lock, [&op]() { return op->done; });
+    return op->error;
+}
+
+bool async_delete_op(IOState &io, int32_t op_id) {
+    const std::lock_guard<std::mutex> lock(io.async.mutex);
+    return io.async.ops.erase(op_id) != 0;
+}
+
+bool async_is_idle(IOState &io) {
+    const std::lock_guard<std::mutex> lock(io.async.mutex);
+    return io.async.queue.empty();
+}
+
+void async_shutdown(AsyncIoState &async) {
+    {
+        const std::lock_guard<std::mutex> lock(async.mutex);
+        async.stop = true;
+    }
+    async.work_ready.notify_one();
+    if (async.worker.joinable()) {
+        async.worker.join();
+    }
+
+    const std::lock_guard<std::mutex> lock(async.mutex);
+    async.stop = false;
+    async.queue.clear();
+    async.ops.clear();
+}
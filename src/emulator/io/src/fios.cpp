@@ -0,0 +1,488 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <io/fios.h>
+
+#include <io/functions.h>
+#include <io/state.h>
+
+#include <psp2/io/fcntl.h>
+#include <psp2/kernel/error.h>
+
+#include <util/log.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+// Decompressed PSARC blocks are kept up to this budget across all mounts and
+// handles, least recently used first out, so the blocks behind a title's hot
+// assets are inflated once rather than on every read.
+static constexpr uint64_t FIOS_BLOCK_CACHE_BUDGET = 32 * 1024 * 1024;
+
+// PSARC is big-endian throughout.
+static uint16_t be16(const uint8_t *p) {
+    return (uint16_t(p[0]) << 8) | p[1];
+}
+
+static uint32_t be32(const uint8_t *p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+static uint64_t be40(const uint8_t *p) {
+    return (uint64_t(p[0]) << 32) | (uint64_t(p[1]) << 24) | (uint64_t(p[2]) << 16) | (uint64_t(p[3]) << 8) | p[4];
+}
+
+// Manifest names, mount points and lookups all go through the same
+// normalization so the map keys compare exactly.
+static std::string normalize_archive_path(const std::string &path, bool ignore_case) {
+    std::string out = path;
+    std::replace(out.begin(), out.end(), '\\', '/');
+    while (!out.empty() && (out.front() == '/')) {
+        out.erase(out.begin());
+    }
+    while (!out.empty() && (out.back() == '/')) {
+        out.pop_back();
+    }
+    if (ignore_case) {
+        std::transform(out.begin(), out.end(), out.begin(), [](char ch) { return char(tolower(ch)); });
+    }
+    return out;
+}
+
+// Decompressed block, through the shared cache. Caller holds the state
+// mutex. expected is the block's decompressed size - the entry's tail block
+// is shorter than block_size.
+static FiosBlockPtr load_block(IOState &io, FiosState &state, FiosArchiveMount &mount, uint32_t block, int64_t data_offset, int64_t expected, const char *export_name) {
+    const std::pair<SceUID, uint32_t> key(mount.id, block);
+    const auto cached = state.blocks.find(key);
+    if (cached != state.blocks.end()) {
+        cached->second.last_used = ++state.use_counter;
+        return cached->second.data;
+    }
+
+    const uint32_t stored = mount.block_table[block] ? mount.block_table[block] : mount.block_size;
+    std::vector<uint8_t> raw(stored);
+    if (pread_file(raw.data(), io, mount.fd, stored, data_offset, export_name) != static_cast<int>(stored)) {
+        return FiosBlockPtr();
+    }
+
+    const FiosBlockPtr data = std::make_shared<std::vector<uint8_t>>(expected);
+    if (stored == static_cast<uint32_t>(expected)) {
+        // Stored raw - either a full uncompressed block or an
+        // incompressible tail.
+        memcpy(data->data(), raw.data(), stored);
+    } else {
+        mz_ulong inflated = static_cast<mz_ulong>(expected);
+        if (mz_uncompress(data->data(), &inflated, raw.data(), stored) != MZ_OK) {
+            LOG_CRITICAL("Failed to inflate psarc block {}.", block);
+            return FiosBlockPtr();
+        }
+        data->resize(inflated);
+    }
+
+    state.blocks[key] = { data, ++state.use_counter };
+    state.block_bytes += data->size();
+
+    while ((state.block_bytes > FIOS_BLOCK_CACHE_BUDGET) && (state.blocks.size() > 1)) {
+        auto victim = state.blocks.begin();
+        for (auto it = state.blocks.begin(); it != state.blocks.end(); ++it) {
+            if (it->second.last_used < victim->second.last_used) {
+                victim = it;
+            }
+        }
+        if (victim->second.data == data) {
+            break; // never evict the block being served
+        }
+        state.block_bytes -= victim->second.data->size();
+        state.blocks.erase(victim);
+    }
+
+    return data;
+}
+
+// Positioned read of one entry's uncompressed bytes. Caller holds the state
+// mutex.
+static int read_entry(IOState &io, FiosState &state, FiosArchiveMount &mount, const FiosArchiveEntry &entry, void *buffer, SceSize size, int64_t offset, const char *export_name) {
+    if ((offset < 0) || (offset >= entry.size)) {
+        return 0;
+    }
+    const int64_t to_read = std::min<int64_t>(size, entry.size - offset);
+
+    uint8_t *dst = static_cast<uint8_t *>(buffer);
+    int64_t copied = 0;
+    while (copied < to_read) {
+        const int64_t at = offset + copied;
+        const uint32_t relative = static_cast<uint32_t>(at / mount.block_size);
+        const uint32_t block = entry.first_block + relative;
+        if (block >= mount.block_table.size()) {
+            break;
+        }
+        const int64_t block_ofs = at % mount.block_size;
+        const int64_t expected = std::min<int64_t>(mount.block_size, entry.size - (int64_t(relative) * mount.block_size));
+        const int64_t data_offset = entry.data_offset + (mount.block_prefix[block] - mount.block_prefix[entry.first_block]);
+
+        const FiosBlockPtr data = load_block(io, state, mount, block, data_offset, expected, export_name);
+        if (!data || (block_ofs >= static_cast<int64_t>(data->size()))) {
+            break;
+        }
+        const int64_t chunk = std::min<int64_t>(to_read - copied, data->size() - block_ofs);
+        memcpy(dst + copied, data->data() + block_ofs, static_cast<size_t>(chunk));
+        copied += chunk;
+    }
+    return static_cast<int>(copied);
+}
+
+int fios_mount_archive(IOState &io, const char *path, const char *mount_point, SceUID *fh_out, const char *pref_path, const char *export_name) {
+    if (!path || !mount_point || !fh_out) {
+        return SCE_ERROR_ERRNO_EINVAL;
+    }
+
+    const SceUID fd = open_file(io, path, SCE_O_RDONLY, pref_path, export_name);
+    if (fd < 0) {
+        return fd;
+    }
+
+    uint8_t header[32];
+    if ((pread_file(header, io, fd, sizeof(header), 0, export_name) != sizeof(header)) || (memcmp(header, "PSAR", 4) != 0)) {
+        close_file(io, fd, export_name);
+        LOG_CRITICAL("{} is not a psarc archive.", path);
+        return SCE_ERROR_ERRNO_EINVAL;
+    }
+
+    const uint32_t compression = be32(header + 8);
+    const uint32_t toc_length = be32(header + 12);
+    const uint32_t toc_entry_size = be32(header + 16);
+    const uint32_t toc_entries = be32(header + 20);
+    const uint32_t block_size = be32(header + 24);
+    const uint32_t flags = be32(header + 28);
+
+    if ((compression != 0x7a6c6962 /* zlib */) || (toc_entry_size < 30) || (toc_entries == 0) || (block_size == 0) || (toc_length <= sizeof(header))) {
+        close_file(io, fd, export_name);
+        LOG_CRITICAL("Unsupported psarc layout in {}.", path);
+        return SCE_ERROR_ERRNO_EINVAL;
+    }
+
+    // The whole central index - table of contents plus the block size table
+    // - in one read.
+    std::vector<uint8_t> index(toc_length - sizeof(header));
+    if (pread_file(index.data(), io, fd, static_cast<SceSize>(index.size()), sizeof(header), export_name) != static_cast<int>(index.size())) {
+        close_file(io, fd, export_name);
+        return SCE_ERROR_ERRNO_EIO;
+    }
+
+    const FiosArchiveMountPtr mount = std::make_shared<FiosArchiveMount>();
+    mount->fd = fd;
+    mount->block_size = block_size;
+    mount->ignore_case = (flags & 1) != 0;
+    mount->mount_point = normalize_archive_path(mount_point, false);
+
+    // Stored block sizes take as few bytes as block_size needs.
+    uint32_t width = 1;
+    while ((uint64_t(1) << (8 * width)) < block_size) {
+        ++width;
+    }
+
+    const size_t toc_bytes = size_t(toc_entries) * toc_entry_size;
+    if (toc_bytes > index.size()) {
+        close_file(io, fd, export_name);
+        return SCE_ERROR_ERRNO_EINVAL;
+    }
+    const size_t block_count = (index.size() - toc_bytes) / width;
+    mount->block_table.reserve(block_count);
+    mount->block_prefix.reserve(block_count + 1);
+    mount->block_prefix.push_back(0);
+    for (size_t i = 0; i < block_count; ++i) {
+        const uint8_t *p = index.data() + toc_bytes + (i * width);
+        uint32_t stored = 0;
+        for (uint32_t b = 0; b < width; ++b) {
+            stored = (stored << 8) | p[b];
+        }
+        mount->block_table.push_back(stored);
+        mount->block_prefix.push_back(mount->block_prefix.back() + (stored ? stored : block_size));
+    }
+
+    // Table of contents: a 16-byte name digest we ignore, then block index,
+    // 40-bit size and 40-bit offset. Entry 0 is the manifest that names the
+    // rest.
+    std::vector<FiosArchiveEntry> toc(toc_entries);
+    for (uint32_t i = 0; i < toc_entries; ++i) {
+        const uint8_t *p = index.data() + (size_t(i) * toc_entry_size);
+        toc[i].first_block = be32(p + 16);
+        toc[i].size = static_cast<int64_t>(be40(p + 20));
+        toc[i].data_offset = static_cast<int64_t>(be40(p + 25));
+    }
+
+    FiosState &state = io.fios;
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    mount->id = state.next_fh++;
+
+    std::vector<uint8_t> manifest(toc[0].size);
+    if (read_entry(io, state, *mount, toc[0], manifest.data(), static_cast<SceSize>(manifest.size()), 0, export_name) != static_cast<int>(manifest.size())) {
+        close_file(io, fd, export_name);
+        return SCE_ERROR_ERRNO_EIO;
+    }
+
+    size_t name_start = 0;
+    uint32_t entry = 1;
+    for (size_t i = 0; (i <= manifest.size()) && (entry < toc_entries); ++i) {
+        if ((i == manifest.size()) || (manifest[i] == '\n')) {
+            const std::string name(reinterpret_cast<const char *>(manifest.data()) + name_start, i - name_start);
+            if (!name.empty()) {
+                mount->entries[normalize_archive_path(name, mount->ignore_case)] = toc[entry++];
+            }
+            name_start = i + 1;
+        }
+    }
+
+    state.mounts[mount->id] = mount;
+    *fh_out = mount->id;
+
+    LOG_INFO("Mounted psarc {} at {} ({} entries, {} byte blocks).", path, mount->mount_point, mount->entries.size(), block_size);
+    return 0;
+}
+
+int fios_unmount_archive(IOState &io, SceUID fh, const char *export_name) {
+    FiosState &state = io.fios;
+    FiosArchiveMountPtr mount;
+    {
+        const std::lock_guard<std::mutex> lock(state.mutex);
+        const auto found = state.mounts.find(fh);
+        if (found == state.mounts.end()) {
+            return SCE_ERROR_ERRNO_EBADF;
+        }
+        mount = found->second;
+        state.mounts.erase(found);
+
+        // Open handles into the mount go with it, as do its cached blocks.
+        for (auto file = state.files.begin(); file != state.files.end();) {
+            file = (file->second.mount == mount) ? state.files.erase(file) : std::next(file);
+        }
+        for (auto block = state.blocks.begin(); block != state.blocks.end();) {
+            if (block->first.first == fh) {
+                state.block_bytes -= block->second.data->size();
+                block = state.blocks.erase(block);
+            } else {
+                ++block;
+            }
+        }
+    }
+    close_file(io, mount->fd, export_name);
+    return 0;
+}
+
+static void rebuild_overlay_table(FiosState &state) {
+    state.overlay_table = state.overlays;
+    std::stable_sort(state.overlay_table.begin(), state.overlay_table.end(), [](const FiosOverlay &a, const FiosOverlay &b) {
+        return (a.order != b.order) ? (a.order < b.order) : (a.id < b.id);
+    });
+}
+
+std::vector<std::string> fios_resolve_overlays(IOState &io, const char *path) {
+    std::vector<std::string> candidates;
+    if (!path) {
+        return candidates;
+    }
+
+    FiosState &state = io.fios;
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    for (const FiosOverlay &overlay : state.overlay_table) {
+        if (strncmp(path, overlay.dst.c_str(), overlay.dst.size()) == 0) {
+            candidates.push_back(overlay.src + (path + overlay.dst.size()));
+        }
+    }
+    // The original path is the lowest-priority candidate, so translucent
+    // overlays fall through to the underlying file when the source side has
+    // no match.
+    candidates.push_back(path);
+    return candidates;
+}
+
+SceUID fios_open_archive_file(IOState &io, const char *path) {
+    if (!path) {
+        return -1;
+    }
+
+    FiosState &state = io.fios;
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    const std::string wanted = normalize_archive_path(path, false);
+    for (const auto &pair : state.mounts) {
+        const FiosArchiveMountPtr &mount = pair.second;
+        const std::string &point = mount->mount_point;
+        std::string below;
+        if (point.empty()) {
+            below = wanted; // mounted at the root
+        } else if ((wanted.size() > point.size() + 1) && (wanted.compare(0, point.size(), point) == 0) && (wanted[point.size()] == '/')) {
+            below = wanted.substr(point.size() + 1);
+        } else {
+            continue;
+        }
+        const std::string relative = normalize_archive_path(below, mount->ignore_case);
+        const auto entry = mount->entries.find(relative);
+        if (entry == mount->entries.end()) {
+            continue;
+        }
+        const SceUID fh = state.next_fh++;
+        state.files[fh] = { mount, &entry->second, 0 };
+        return fh;
+    }
+    return -1;
+}
+
+bool fios_is_archive_fh(SceUID fh) {
+    return fh >= FIOS_ARCHIVE_FH_BASE;
+}
+
+int fios_read_archive_file(IOState &io, SceUID fh, void *buffer, SceSize size, int64_t offset, const char *export_name) {
+    FiosState &state = io.fios;
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    const auto found = state.files.find(fh);
+    if (found == state.files.end()) {
+        return SCE_ERROR_ERRNO_EBADF;
+    }
+    FiosArchiveFile &file = found->second;
+
+    const bool sequential = offset < 0;
+    const int read = read_entry(io, state, *file.mount, *file.entry, buffer, size, sequential ? file.position : offset, export_name);
+    if (sequential && (read > 0)) {
+        file.position += read;
+    }
+    return read;
+}
+
+int64_t fios_seek_archive_file(IOState &io, SceUID fh, int64_t offset, int whence) {
+    FiosState &state = io.fios;
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    const auto found = state.files.find(fh);
+    if (found == state.files.end()) {
+        return SCE_ERROR_ERRNO_EBADF;
+    }
+    FiosArchiveFile &file = found->second;
+
+    int64_t base = 0;
+    switch (whence) {
+    case SEEK_SET:
+        break;
+    case SEEK_CUR:
+        base = file.position;
+        break;
+    case SEEK_END:
+        base = file.entry->size;
+        break;
+    default:
+        return SCE_ERROR_ERRNO_EINVAL;
+    }
+    if ((base + offset) < 0) {
+        return SCE_ERROR_ERRNO_EINVAL;
+    }
+    file.position = base + offset;
+    return file.position;
+}
+
+int64_t fios_archive_file_size(IOState &io, SceUID fh) {
+    FiosState &state = io.fios;
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    const auto found = state.files.find(fh);
+    if (found == state.files.end()) {
+        return SCE_ERROR_ERRNO_EBADF;
+    }
+    return found->second.entry->size;
+}
+
+void fios_close_archive_file(IOState &io, SceUID fh) {
+    FiosState &state = io.fios;
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    state.files.erase(fh);
+}
+
+int fios_overlay_add(IOState &io, uint8_t type, uint8_t order, const char *dst, const char *src, int32_t *id_out) {
+    if (!dst || !src) {
+        return SCE_ERROR_ERRNO_EINVAL;
+    }
+
+    FiosState &state = io.fios;
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    FiosOverlay overlay;
+    overlay.type = type;
+    overlay.order = order;
+    overlay.id = state.next_overlay_id++;
+    overlay.dst = dst;
+    overlay.src = src;
+    state.overlays.push_back(overlay);
+    rebuild_overlay_table(state);
+
+    if (id_out) {
+        *id_out = overlay.id;
+    }
+    return 0;
+}
+
+int fios_overlay_remove(IOState &io, int32_t id) {
+    FiosState &state = io.fios;
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    for (auto overlay = state.overlays.begin(); overlay != state.overlays.end(); ++overlay) {
+        if (overlay->id == id) {
+            state.overlays.erase(overlay);
+            rebuild_overlay_table(state);
+            return 0;
+        }
+    }
+    return SCE_ERROR_ERRNO_EINVAL;
+}
+
+int fios_overlay_modify(IOState &io, int32_t id, uint8_t type, uint8_t order, const char *dst, const char *src) {
+    if (!dst || !src) {
+        return SCE_ERROR_ERRNO_EINVAL;
+    }
+
+    FiosState &state = io.fios;
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    for (FiosOverlay &overlay : state.overlays) {
+        if (overlay.id == id) {
+            overlay.type = type;
+            overlay.order = order;
+            overlay.dst = dst;
+            overlay.src = src;
+            rebuild_overlay_table(state);
+            return 0;
+        }
+    }
+    return SCE_ERROR_ERRNO_EINVAL;
+}
+
+bool fios_overlay_get(IOState &io, int32_t id, FiosOverlay &out) {
+    FiosState &state = io.fios;
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    for (const FiosOverlay &overlay : state.overlays) {
+        if (overlay.id == id) {
+            out = overlay;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<int32_t> fios_overlay_ids(IOState &io) {
+    FiosState &state = io.fios;
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    std::vector<int32_t> ids;
+    ids.reserve(state.overlays.size());
+    for (const FiosOverlay &overlay : state.overlays) {
+        ids.push_back(overlay.id);
+    }
+    return ids;
+}
@@ -28,6 +28,7 @@
 #include <util/fs.h>
 #include <util/log.h>
 #include <util/preprocessor.h>
+#include <util/trace.h>
 
 #include <psp2/io/fcntl.h>
 
@@ -35,14 +36,21 @@
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <io.h>
 #include <util/string_convert.h>
 #else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #endif
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <tuple>
@@ -59,29 +67,206 @@ int io_error_impl(int retval, const char *export_name, const char *func_name) {
 #define IO_ERROR(retval) io_error_impl(retval, export_name, __func__)
 #define IO_ERROR_UNK() IO_ERROR(-1)
 
-const char *
-translate_open_mode(int flags) {
-    if (flags & SCE_O_WRONLY) {
-        if (flags & SCE_O_RDONLY) {
-            if (flags & SCE_O_CREAT) {
-                if (flags & SCE_O_APPEND) {
-                    return "ab+";
-                } else {
-                    return "wb+";
-                }
-            } else {
-                return "rb+";
-            }
-        } else {
-            if (flags & SCE_O_APPEND) {
-                return "ab";
-            } else {
-                return "wb";
-            }
-        }
+static void record_io_latency(IoOpStats &op, uint64_t bytes, std::chrono::steady_clock::time_point begin) {
+    op.count++;
+    op.bytes += bytes;
+
+    const uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+    size_t bucket = 0;
+    while ((bucket + 1 < IO_LATENCY_BUCKETS) && (us >= (1ull << bucket))) {
+        ++bucket;
+    }
+    op.latency_us_hist[bucket]++;
+}
+
+static void record_read(IOState &io, const std::string &path, const char *export_name, int64_t offset, int read, std::chrono::steady_clock::time_point begin) {
+    const std::lock_guard<std::mutex> lock(io.telemetry.mutex);
+    IoFdStats &stats = io.telemetry.files[path];
+    if (offset == stats.next_sequential) {
+        stats.sequential_reads++;
     } else {
-        return "rb";
+        stats.random_reads++;
+    }
+    stats.next_sequential = offset + std::max(read, 0);
+    stats.callers[export_name]++;
+    record_io_latency(stats.reads, (read > 0) ? read : 0, begin);
+}
+
+static void record_write(IOState &io, const std::string &path, const char *export_name, int written, std::chrono::steady_clock::time_point begin) {
+    const std::lock_guard<std::mutex> lock(io.telemetry.mutex);
+    IoFdStats &stats = io.telemetry.files[path];
+    stats.callers[export_name]++;
+    record_io_latency(stats.writes, (written > 0) ? written : 0, begin);
+}
+
+static int translate_open_flags(int flags) {
+    if (!(flags & SCE_O_WRONLY)) {
+        return O_RDONLY;
+    }
+    if (flags & SCE_O_RDONLY) {
+        if (flags & SCE_O_CREAT) {
+            return (flags & SCE_O_APPEND) ? (O_RDWR | O_CREAT | O_APPEND) : (O_RDWR | O_CREAT | O_TRUNC);
+        }
+        return O_RDWR;
+    }
+    return (flags & SCE_O_APPEND) ? (O_WRONLY | O_CREAT | O_APPEND) : (O_WRONLY | O_CREAT | O_TRUNC);
+}
+
+static int64_t host_file_size(int fd) {
+#ifdef WIN32
+    return _filelengthi64(fd);
+#else
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        return 0;
+    }
+    return file_stat.st_size;
+#endif
+}
+
+// Read-only files at least this big are mapped instead of read through the
+// descriptor, so guest reads become a memcpy from the page cache.
+static constexpr int64_t MMAP_THRESHOLD = 1024 * 1024;
+
+// Read-only opens at least this big land in the per-title prewarm manifest,
+// so the next session can stream them into the host caches ahead of demand.
+static constexpr int64_t PREWARM_THRESHOLD = 1024 * 1024;
+
+static void map_readonly_file(StdFile &file) {
+#ifdef WIN32
+    const HANDLE os_handle = reinterpret_cast<HANDLE>(_get_osfhandle(file.fd));
+    const HANDLE mapping = CreateFileMappingW(os_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        return; // fall back to descriptor reads
+    }
+    const void *const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        return;
+    }
+    file.mapping_handle = mapping;
+    file.mapped_base = static_cast<const uint8_t *>(view);
+#else
+    void *const base = mmap(nullptr, file.size, PROT_READ, MAP_SHARED, file.fd, 0);
+    if (base == MAP_FAILED) {
+        return; // fall back to descriptor reads
+    }
+    file.mapped_base = static_cast<const uint8_t *>(base);
+#endif
+}
+
+static bool flush_writes(StdFile &file);
+
+StdFile::~StdFile() {
+    flush_writes(*this);
+    if (mapped_base) {
+#ifdef WIN32
+        UnmapViewOfFile(mapped_base);
+        CloseHandle(static_cast<HANDLE>(mapping_handle));
+#else
+        munmap(const_cast<uint8_t *>(mapped_base), size);
+#endif
+    }
+    if (fd >= 0) {
+#ifdef WIN32
+        _close(fd);
+#else
+        close(fd);
+#endif
+    }
+}
+
+// Positioned read - never touches the descriptor's own offset, so reads on
+// one fd from several guest threads do not serialize on a shared cursor.
+static int read_at(const StdFile &file, void *data, SceSize size, int64_t offset) {
+    if (file.mapped_base) {
+        if (offset >= file.size) {
+            return 0;
+        }
+        const int64_t to_copy = std::min(static_cast<int64_t>(size), file.size - offset);
+        memcpy(data, file.mapped_base + offset, static_cast<size_t>(to_copy));
+        return static_cast<int>(to_copy);
+    }
+#ifdef WIN32
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD transferred = 0;
+    if (!ReadFile(reinterpret_cast<HANDLE>(_get_osfhandle(file.fd)), data, size, &transferred, &overlapped)) {
+        return (GetLastError() == ERROR_HANDLE_EOF) ? 0 : -1;
+    }
+    return static_cast<int>(transferred);
+#else
+    return static_cast<int>(pread(file.fd, data, size, offset));
+#endif
+}
+
+static int write_at(StdFile &file, const void *data, SceSize size, int64_t offset) {
+#ifdef WIN32
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD transferred = 0;
+    if (!WriteFile(reinterpret_cast<HANDLE>(_get_osfhandle(file.fd)), data, size, &transferred, &overlapped)) {
+        return -1;
+    }
+    const int written = static_cast<int>(transferred);
+#else
+    const int written = static_cast<int>(pwrite(file.fd, data, size, offset));
+#endif
+    if ((written > 0) && (offset + written > file.size)) {
+        file.size = offset + written;
+    }
+    return written;
+}
+
+// Game saves arrive as bursts of tiny sequential writes - traced down to
+// four bytes per call - each of which used to hit the host synchronously.
+// Runs shorter than this coalesce in the file's pending buffer; anything
+// bigger is flushed through directly.
+static constexpr SceSize WRITE_BEHIND_DIRECT = 4 * 1024;
+static constexpr size_t WRITE_BEHIND_LIMIT = 256 * 1024;
+
+static bool flush_writes(StdFile &file) {
+    if (file.pending.empty()) {
+        return true;
     }
+    const int written = write_at(file, file.pending.data(), static_cast<SceSize>(file.pending.size()), file.pending_ofs);
+    const bool ok = written == static_cast<int>(file.pending.size());
+    file.pending.clear();
+    return ok;
+}
+
+static int buffered_write(StdFile &file, const void *data, SceSize size, int64_t offset) {
+    if (size >= WRITE_BEHIND_DIRECT) {
+        if (!flush_writes(file)) {
+            return -1;
+        }
+        return write_at(file, data, size, offset);
+    }
+
+    // A non-contiguous write breaks the run; flush before starting another.
+    if (!file.pending.empty() && (offset != file.pending_ofs + static_cast<int64_t>(file.pending.size()))) {
+        if (!flush_writes(file)) {
+            return -1;
+        }
+    }
+
+    if (file.pending.empty()) {
+        file.pending_ofs = offset;
+    }
+    const uint8_t *const first = static_cast<const uint8_t *>(data);
+    file.pending.insert(file.pending.end(), first, first + size);
+    if (offset + size > file.size) {
+        file.size = offset + size; // logical size includes buffered bytes
+    }
+
+    if (file.pending.size() >= WRITE_BEHIND_LIMIT) {
+        if (!flush_writes(file)) {
+            return -1;
+        }
+    }
+    return size;
 }
 
 void trim_leading_slash(std::string path) {
@@ -196,6 +381,10 @@ void init_device_paths(IOState &io) {
     io.device_paths.savedata0 = "ux0:/user/00/savedata/" + io.title_id + "/";
     io.device_paths.app0 = "ux0:/app/" + io.title_id + "/";
     io.device_paths.addcont0 = "ux0:/addcont/" + io.title_id + "/";
+
+    // The mounts changed, so cached translations are stale.
+    const std::lock_guard<std::shared_mutex> lock(io.path_cache_mutex);
+    io.path_cache.clear();
 }
 
 void translate_path(std::string &path, VitaIoDevice &device, const IOState::DevicePaths &device_paths) {
@@ -221,11 +410,34 @@ void translate_path(std::string &path, VitaIoDevice &device, const IOState::Devi
     }
 }
 
-SceUID open_file(IOState &io, const std::string &path, int flags, const char *pref_path, const char *export_name) {
-    std::string translated_path(path);
-    VitaIoDevice device = get_device(translated_path);
+// Games stat and reopen the same handful of paths every frame; memoize the
+// scan so repeat operations reuse the resolved entry. Map nodes are stable,
+// so the returned reference outlives later insertions.
+const TranslatedPath &translate_path_cached(IOState &io, const std::string &path) {
+    {
+        const std::shared_lock<std::shared_mutex> lock(io.path_cache_mutex);
+        const PathCache::const_iterator cached = io.path_cache.find(path);
+        if (cached != io.path_cache.end()) {
+            return cached->second;
+        }
+    }
+
+    // Miss: translate outside any lock, then publish. A racing thread may
+    // have inserted the same path meanwhile; emplace keeps its entry.
+    TranslatedPath translated;
+    translated.path = path;
+    translated.device = get_device(translated.path);
+    translate_path(translated.path, translated.device, io.device_paths);
 
-    translate_path(translated_path, device, io.device_paths);
+    const std::lock_guard<std::shared_mutex> lock(io.path_cache_mutex);
+    return io.path_cache.emplace(path, std::move(translated)).first->second;
+}
+
+SceUID open_file(IOState &io, const std::string &path, int flags, const char *pref_path, const char *export_name) {
+    const TraceScope trace("io open");
+    const TranslatedPath &translated = translate_path_cached(io, path);
+    const std::string &translated_path = translated.path;
+    const VitaIoDevice device = translated.device;
 
     LOG_TRACE("{}: Opening file {} ({})", export_name, path, translated_path);
 
@@ -241,36 +453,83 @@ SceUID open_file(IOState &io, const std::string &path, int flags, const char *pr
             type = TTY_OUT;
         }
 
-        const SceUID fd = io.next_fd++;
-        io.tty_files.emplace(fd, type);
+        FdSlot slot;
+        slot.kind = FdKind::Tty;
+        slot.tty = type;
 
-        return fd;
+        return io.fds.emplace(std::move(slot));
     }
     case VitaIoDevice::UX0:
     case VitaIoDevice::UMA0: {
-        std::string file_path = to_host_path(translated_path, pref_path, device);
+        // A streamed VPK serves read-only opens under the app root in place;
+        // anything else falls through to the host filesystem.
+        if (io.vpk && !(flags & SCE_O_WRONLY)) {
+            VpkEntry *const entry = vpk_find_entry(io, translated_path);
+            if (entry && !entry->is_dir) {
+                const VpkFilePtr file = std::make_shared<VpkFile>();
+                file->entry = entry;
+                file->guest_path = path;
+
+                if (io.telemetry.enabled) {
+                    const std::lock_guard<std::mutex> telemetry_lock(io.telemetry.mutex);
+                    io.telemetry.files[path].opens++;
+                }
+                if (entry->size >= PREWARM_THRESHOLD) {
+                    prewarm_log_record(io.prewarm, path);
+                }
 
-        const char *const open_mode = translate_open_mode(flags);
+                FdSlot slot;
+                slot.kind = FdKind::VpkFile;
+                slot.vpk_file = file;
 
-        auto delete_file = [](FILE *file) {
-            if (file != nullptr) {
-                fclose(file);
+                return io.fds.emplace(std::move(slot));
             }
-        };
+        }
+
+        std::string file_path = to_host_path(translated_path, pref_path, device);
+
+        const int open_flags = translate_open_flags(flags);
 
 #ifdef WIN32
-        const FilePtr file(_wfopen(utf_to_wide(file_path).c_str(), utf_to_wide(open_mode).c_str()), delete_file);
+        const int host_fd = _wopen(utf_to_wide_cached(file_path).c_str(), open_flags | _O_BINARY, _S_IREAD | _S_IWRITE);
 #else
-        const FilePtr file(fopen(file_path.c_str(), open_mode), delete_file);
+        const int host_fd = open(file_path.c_str(), open_flags, 0644);
 #endif
-        if (!file) {
+        if (host_fd < 0) {
             return IO_ERROR_UNK();
         }
 
-        const SceUID fd = io.next_fd++;
-        io.std_files.emplace(fd, file);
+        const StdFilePtr file = std::make_shared<StdFile>();
+        file->fd = host_fd;
+        file->size = host_file_size(host_fd);
+        file->guest_path = path;
+        file->host_path = file_path;
+        file->open_flags = open_flags;
+        if (flags & SCE_O_WRONLY) {
+            // Creation or truncation may already have changed the file.
+            const std::lock_guard<std::mutex> stat_lock(io.stat_cache_mutex);
+            io.stat_cache.erase(path);
+        }
+        if (flags & SCE_O_APPEND) {
+            file->position = file->size;
+        }
+        if ((open_flags == O_RDONLY) && (file->size >= MMAP_THRESHOLD)) {
+            map_readonly_file(*file);
+        }
+        if ((open_flags == O_RDONLY) && (file->size >= PREWARM_THRESHOLD)) {
+            prewarm_log_record(io.prewarm, path);
+        }
+
+        if (io.telemetry.enabled) {
+            const std::lock_guard<std::mutex> telemetry_lock(io.telemetry.mutex);
+            io.telemetry.files[path].opens++;
+        }
+
+        FdSlot slot;
+        slot.kind = FdKind::File;
+        slot.file = file;
 
-        return fd;
+        return io.fds.emplace(std::move(slot));
     }
     case VitaIoDevice::SAVEDATA1:
     case VitaIoDevice::_UKNONWN: {
@@ -286,30 +545,106 @@ SceUID open_file(IOState &io, const std::string &path, int flags, const char *pr
 }
 
 int read_file(void *data, IOState &io, SceUID fd, SceSize size, const char *export_name) {
+    const TraceScope trace("io read");
     assert(data != nullptr);
     assert(fd >= 0);
     assert(size >= 0);
 
     LOG_TRACE("{}: Reading file: fd: {}, size: {}", export_name, log_hex(fd), size);
 
-    const StdFiles::const_iterator file = io.std_files.find(fd);
-    if (file != io.std_files.end()) {
-        return fread(data, 1, size, file->second.get());
+    FdSlot *const slot = io.fds.get(fd);
+    if (!slot) {
+        return IO_ERROR(SCE_ERROR_ERRNO_EBADF);
     }
 
-    const TtyFiles::const_iterator tty_file = io.tty_files.find(fd);
-    if (tty_file != io.tty_files.end()) {
-        if (tty_file->second == TTY_IN) {
+    switch (slot->kind) {
+    case FdKind::File: {
+        StdFile &std_file = *slot->file;
+        flush_writes(std_file); // reads must see buffered bytes
+        const bool telemetry = io.telemetry.enabled;
+        const auto begin = telemetry ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        const int read = read_at(std_file, data, size, std_file.position);
+        if (read < 0) {
+            return IO_ERROR_UNK();
+        }
+        if (telemetry) {
+            record_read(io, std_file.guest_path, export_name, std_file.position, read, begin);
+        }
+        std_file.position += read;
+        return read;
+    }
+    case FdKind::VpkFile: {
+        VpkFile &file = *slot->vpk_file;
+        const bool telemetry = io.telemetry.enabled;
+        const auto begin = telemetry ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        const int read = vpk_read(io, *file.entry, data, size, file.position);
+        if (read < 0) {
+            return IO_ERROR_UNK();
+        }
+        if (telemetry) {
+            record_read(io, file.guest_path, export_name, file.position, read, begin);
+        }
+        file.position += read;
+        return read;
+    }
+    case FdKind::Tty: {
+        if (slot->tty == TTY_IN) {
             std::cin.read(reinterpret_cast<char *>(data), size);
             return size;
         }
         return IO_ERROR_UNK();
     }
+    default:
+        return IO_ERROR(SCE_ERROR_ERRNO_EBADF);
+    }
+}
+
+int pread_file(void *data, IOState &io, SceUID fd, SceSize size, SceOff offset, const char *export_name) {
+    assert(data != nullptr);
+    assert(fd >= 0);
+
+    LOG_TRACE("{}: Reading file: fd: {}, size: {} at offset: {}", export_name, log_hex(fd), size, offset);
+
+    FdSlot *const slot = io.fds.get(fd);
+    if (!slot) {
+        return IO_ERROR(SCE_ERROR_ERRNO_EBADF);
+    }
 
-    return IO_ERROR(SCE_ERROR_ERRNO_EBADF);
+    // The cursor is left alone, so positioned reads from several threads can
+    // overlap on one fd.
+    switch (slot->kind) {
+    case FdKind::File: {
+        flush_writes(*slot->file); // reads must see buffered bytes
+        const bool telemetry = io.telemetry.enabled;
+        const auto begin = telemetry ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        const int read = read_at(*slot->file, data, size, offset);
+        if (read < 0) {
+            return IO_ERROR_UNK();
+        }
+        if (telemetry) {
+            record_read(io, slot->file->guest_path, export_name, offset, read, begin);
+        }
+        return read;
+    }
+    case FdKind::VpkFile: {
+        const bool telemetry = io.telemetry.enabled;
+        const auto begin = telemetry ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        const int read = vpk_read(io, *slot->vpk_file->entry, data, size, offset);
+        if (read < 0) {
+            return IO_ERROR_UNK();
+        }
+        if (telemetry) {
+            record_read(io, slot->vpk_file->guest_path, export_name, offset, read, begin);
+        }
+        return read;
+    }
+    default:
+        return IO_ERROR(SCE_ERROR_ERRNO_EBADF);
+    }
 }
 
-int write_file(SceUID fd, const void *data, SceSize size, const IOState &io, const char *export_name) {
+int write_file(SceUID fd, const void *data, SceSize size, IOState &io, const char *export_name) {
+    const TraceScope trace("io write");
     assert(data != nullptr);
     assert(size >= 0);
     if (fd < 0) {
@@ -320,14 +655,32 @@ int write_file(SceUID fd, const void *data, SceSize size, const IOState &io, con
 
     LOG_TRACE("{}: Writing file: fd: {}, size: {}", export_name, log_hex(fd), size);
 
-    const StdFiles::const_iterator file = io.std_files.find(fd);
-    if (file != io.std_files.end()) {
-        return fwrite(data, 1, size, file->second.get());
+    FdSlot *const slot = io.fds.get(fd);
+    if (!slot) {
+        return IO_ERROR(SCE_ERROR_ERRNO_EBADF);
     }
 
-    const TtyFiles::const_iterator tty_file = io.tty_files.find(fd);
-    if (tty_file != io.tty_files.end()) {
-        if (tty_file->second == TTY_OUT) {
+    switch (slot->kind) {
+    case FdKind::File: {
+        StdFile &std_file = *slot->file;
+        const bool telemetry = io.telemetry.enabled;
+        const auto begin = telemetry ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        const int written = buffered_write(std_file, data, size, std_file.position);
+        if (written < 0) {
+            return IO_ERROR_UNK();
+        }
+        if (telemetry) {
+            record_write(io, std_file.guest_path, export_name, written, begin);
+        }
+        std_file.position += written;
+        {
+            const std::lock_guard<std::mutex> stat_lock(io.stat_cache_mutex);
+            io.stat_cache.erase(std_file.guest_path);
+        }
+        return written;
+    }
+    case FdKind::Tty: {
+        if (slot->tty == TTY_OUT) {
             std::string s(reinterpret_cast<char const *>(data), size);
 
             // trim newline
@@ -340,16 +693,15 @@ int write_file(SceUID fd, const void *data, SceSize size, const IOState &io, con
 
         return IO_ERROR_UNK();
     }
-
-    return IO_ERROR(SCE_ERROR_ERRNO_EBADF);
+    default:
+        return IO_ERROR(SCE_ERROR_ERRNO_EBADF);
+    }
 }
 
 int seek_file(SceUID fd, int offset, int whence, IOState &io, const char *export_name) {
     assert(fd >= 0);
     assert((whence == SCE_SEEK_SET) || (whence == SCE_SEEK_CUR) || (whence == SCE_SEEK_END));
 
-    const StdFiles::const_iterator std_file = io.std_files.find(fd);
-
     auto log_whence = [](int whence) -> const char * {
         switch (whence) {
             STR_CASE(SCE_SEEK_SET);
@@ -362,40 +714,67 @@ int seek_file(SceUID fd, int offset, int whence, IOState &io, const char *export
 
     LOG_TRACE("{}: Seeking file: fd: {} at offset: {}, whence: {}", export_name, log_hex(fd), log_hex(offset), log_whence(whence));
 
-    assert(std_file != io.std_files.end());
+    FdSlot *const slot = io.fds.get(fd);
 
-    if (std_file == io.std_files.end()) {
+    int64_t *position = nullptr;
+    int64_t size = 0;
+    if (slot && (slot->kind == FdKind::File)) {
+        position = &slot->file->position;
+        size = slot->file->size;
+    } else if (slot && (slot->kind == FdKind::VpkFile)) {
+        position = &slot->vpk_file->position;
+        size = slot->vpk_file->entry->size;
+    } else {
+        assert(false);
         return IO_ERROR(SCE_ERROR_ERRNO_EBADF);
     }
 
-    int base = SEEK_SET;
+    // Just cursor arithmetic - the descriptor's own offset is never used.
+    int64_t base = 0;
     switch (whence) {
     case SCE_SEEK_SET:
-        base = SEEK_SET;
+        base = 0;
         break;
     case SCE_SEEK_CUR:
-        base = SEEK_CUR;
+        base = *position;
         break;
     case SCE_SEEK_END:
-        base = SEEK_END;
+        base = size;
         break;
     }
 
-    int ret = 0;
-    long pos = 0;
+    const int64_t new_position = base + offset;
+    if (new_position < 0) {
+        return IO_ERROR_UNK();
+    }
+
+    *position = new_position;
 
-    if (std_file != io.std_files.end()) {
-        ret = fseek(std_file->second.get(), offset, base);
+    if (io.telemetry.enabled) {
+        const std::string &path = (slot->kind == FdKind::File) ? slot->file->guest_path : slot->vpk_file->guest_path;
+        const std::lock_guard<std::mutex> telemetry_lock(io.telemetry.mutex);
+        io.telemetry.files[path].seeks++;
     }
 
-    if (ret != 0) {
-        return IO_ERROR_UNK();
+    return static_cast<int>(new_position);
+}
+
+int sync_file(IOState &io, SceUID fd, const char *export_name) {
+    assert(fd >= 0);
+
+    LOG_TRACE("{}: Syncing file: fd: {}", export_name, log_hex(fd));
+
+    FdSlot *const slot = io.fds.get(fd);
+    if (!slot) {
+        return IO_ERROR(SCE_ERROR_ERRNO_EBADF);
     }
 
-    if (std_file != io.std_files.end()) {
-        pos = ftell(std_file->second.get());
+    // Only host-backed files buffer writes; the other flavors have nothing
+    // to push out.
+    if ((slot->kind == FdKind::File) && !flush_writes(*slot->file)) {
+        return IO_ERROR_UNK();
     }
-    return pos;
+    return 0;
 }
 
 void close_file(IOState &io, SceUID fd, const char *export_name) {
@@ -403,15 +782,48 @@ void close_file(IOState &io, SceUID fd, const char *export_name) {
 
     LOG_TRACE("{}: Closing file: fd: {}", export_name, log_hex(fd));
 
-    io.tty_files.erase(fd);
-    io.std_files.erase(fd);
+    FdSlot *const slot = io.fds.get(fd);
+    if (slot && (slot->kind != FdKind::Dir)) {
+        // Any coalesced writes go out with the handle's destructor.
+        io.fds.close(fd);
+    }
 }
 
-int remove_file(IOState &io, const char *file, const char *pref_path, const char *export_name) {
-    VitaIoDevice device = get_device(file);
-    std::string translated_path = file;
+void prewarm_files(IOState &io, const char *pref_path) {
+    const std::vector<std::string> paths = prewarm_log_entries(io.prewarm);
+    if (paths.empty()) {
+        return;
+    }
+
+    // Reads go through the normal pread path, so compressed VPK entries land
+    // decompressed in the block cache and plain files end up in the OS page
+    // cache - the same state a first-session read would have left behind.
+    std::vector<char> buffer(256 * 1024);
+    size_t warmed = 0;
+    for (const std::string &path : paths) {
+        const SceUID fd = open_file(io, path, SCE_O_RDONLY, pref_path, "prewarm");
+        if (fd < 0) {
+            continue; // deleted or renamed since it was recorded
+        }
+        int64_t offset = 0;
+        for (;;) {
+            const int read = pread_file(buffer.data(), io, fd, static_cast<SceSize>(buffer.size()), offset, "prewarm");
+            if (read <= 0) {
+                break;
+            }
+            offset += read;
+        }
+        close_file(io, fd, "prewarm");
+        ++warmed;
+    }
 
-    translate_path(translated_path, device, io.device_paths);
+    LOG_INFO("Prewarmed {} of {} recorded files.", warmed, paths.size());
+}
+
+int remove_file(IOState &io, const char *file, const char *pref_path, const char *export_name) {
+    const TranslatedPath &translated = translate_path_cached(io, file);
+    const std::string &translated_path = translated.path;
+    const VitaIoDevice device = translated.device;
 
     LOG_TRACE("{}: Removing file {} ({})", export_name, file, translated_path);
 
@@ -420,6 +832,8 @@ int remove_file(IOState &io, const char *file, const char *pref_path, const char
     case VitaIoDevice::UMA0: {
         std::string file_path = to_host_path(translated_path, pref_path, device);
         fs::remove(file_path);
+        const std::lock_guard<std::mutex> stat_lock(io.stat_cache_mutex);
+        io.stat_cache.erase(file);
         return 0;
     }
     default: {
@@ -430,10 +844,9 @@ int remove_file(IOState &io, const char *file, const char *pref_path, const char
 }
 
 int create_dir(IOState &io, const char *dir, int mode, const char *pref_path, const char *export_name) {
-    VitaIoDevice device = get_device(dir);
-    std::string translated_path = dir;
-
-    translate_path(translated_path, device, io.device_paths);
+    const TranslatedPath &translated = translate_path_cached(io, dir);
+    const std::string &translated_path = translated.path;
+    const VitaIoDevice device = translated.device;
 
     LOG_TRACE("{}: Removing dir {} ({})", export_name, dir, translated_path);
 
@@ -443,6 +856,8 @@ int create_dir(IOState &io, const char *dir, int mode, const char *pref_path, co
         std::string dir_path = to_host_path(translated_path, pref_path, device);
 
         fs::create_directory(dir_path);
+        const std::lock_guard<std::mutex> stat_lock(io.stat_cache_mutex);
+        io.stat_cache.erase(dir);
         return 0;
     }
     default: {
@@ -453,10 +868,9 @@ int create_dir(IOState &io, const char *dir, int mode, const char *pref_path, co
 }
 
 int remove_dir(IOState &io, const char *dir, const char *pref_path, const char *export_name) {
-    VitaIoDevice device = get_device(dir);
-    std::string translated_path = dir;
-
-    translate_path(translated_path, device, io.device_paths);
+    const TranslatedPath &translated = translate_path_cached(io, dir);
+    const std::string &translated_path = translated.path;
+    const VitaIoDevice device = translated.device;
 
     LOG_TRACE("{}: Removing dir {} ({})", export_name, dir, translated_path);
 
@@ -465,6 +879,8 @@ int remove_dir(IOState &io, const char *dir, const char *pref_path, const char *
     case VitaIoDevice::UMA0: {
         std::string dir_path = to_host_path(translated_path, pref_path, device);
         fs::remove(dir_path);
+        const std::lock_guard<std::mutex> stat_lock(io.stat_cache_mutex);
+        io.stat_cache.erase(dir);
         return 0;
     }
     default: {
@@ -474,13 +890,31 @@ int remove_dir(IOState &io, const char *dir, const char *pref_path, const char *
     }
 }
 
+// Stat results stay valid this long - titles poll their save files every
+// frame, and our own writes evict the entry immediately anyway.
+static constexpr auto STAT_CACHE_TTL = std::chrono::seconds(1);
+
 int stat_file(IOState &io, const char *file, SceIoStat *statp, const char *pref_path, uint64_t base_tick, const char *export_name) {
     assert(statp != NULL);
 
+    {
+        const std::lock_guard<std::mutex> stat_lock(io.stat_cache_mutex);
+        const auto cached = io.stat_cache.find(file);
+        if (cached != io.stat_cache.end()) {
+            if (std::chrono::steady_clock::now() - cached->second.taken_at < STAT_CACHE_TTL) {
+                LOG_TRACE("{}: Statting file {} (cached)", export_name, file);
+                *statp = cached->second.stat;
+                return 0;
+            }
+            io.stat_cache.erase(cached);
+        }
+    }
+
     memset(statp, '\0', sizeof(SceIoStat));
 
-    VitaIoDevice device = get_device(file);
-    std::string translated_path = file;
+    const TranslatedPath &translated = translate_path_cached(io, file);
+    const std::string &translated_path = translated.path;
+    const VitaIoDevice device = translated.device;
 
     // read and execute access rights
     statp->st_mode = SCE_S_IRUSR | SCE_S_IRGRP | SCE_S_IROTH | SCE_S_IXUSR | SCE_S_IXGRP | SCE_S_IXOTH;
@@ -489,10 +923,38 @@ int stat_file(IOState &io, const char *file, SceIoStat *statp, const char *pref_
     std::uint64_t last_modification_time_ticks;
     std::uint64_t creation_time_ticks{ 0 };
 
-    translate_path(translated_path, device, io.device_paths);
-
     LOG_TRACE("{}: Statting file {} ({})", export_name, file, translated_path);
 
+    if (io.vpk) {
+        const VpkEntry *const entry = vpk_find_entry(io, translated_path);
+        if (entry) {
+            statp->st_mode |= entry->is_dir ? SCE_S_IFDIR : SCE_S_IFREG;
+            statp->st_size = entry->size;
+
+            // The archive only records one timestamp per entry.
+            const uint64_t mtime_ticks = (uint64_t)entry->mtime * VITA_CLOCKS_PER_SEC;
+            __RtcTicksToPspTime(statp->st_atime, mtime_ticks);
+            __RtcTicksToPspTime(statp->st_mtime, mtime_ticks);
+            __RtcTicksToPspTime(statp->st_ctime, mtime_ticks);
+
+            const std::lock_guard<std::mutex> stat_lock(io.stat_cache_mutex);
+            io.stat_cache[file] = { *statp, std::chrono::steady_clock::now() };
+
+            return 0;
+        }
+    }
+
+    // A pending write-behind buffer holds bytes the host has not seen yet;
+    // push out any open handle on this path before statting it.
+    {
+        const std::shared_lock<std::shared_mutex> fds_lock(io.fds.mutex);
+        for (FdSlot &slot : io.fds.slots) {
+            if ((slot.kind == FdKind::File) && (slot.file->guest_path == file)) {
+                flush_writes(*slot.file);
+            }
+        }
+    }
+
     switch (device) {
     case VitaIoDevice::UX0:
     case VitaIoDevice::UMA0: {
@@ -500,7 +962,7 @@ int stat_file(IOState &io, const char *file, SceIoStat *statp, const char *pref_
 
 #ifdef WIN32
         WIN32_FIND_DATAW find_data;
-        HANDLE handle = FindFirstFileW(utf_to_wide(file_path).c_str(), &find_data);
+        HANDLE handle = FindFirstFileW(utf_to_wide_cached(file_path).c_str(), &find_data);
         if (handle == INVALID_HANDLE_VALUE) {
             return IO_ERROR_UNK();
         }
@@ -549,17 +1011,83 @@ int stat_file(IOState &io, const char *file, SceIoStat *statp, const char *pref_
     __RtcTicksToPspTime(statp->st_mtime, last_modification_time_ticks);
     __RtcTicksToPspTime(statp->st_ctime, creation_time_ticks);
 
+    {
+        const std::lock_guard<std::mutex> stat_lock(io.stat_cache_mutex);
+        io.stat_cache[file] = { *statp, std::chrono::steady_clock::now() };
+    }
+
     return 0;
 }
 
-int open_dir(IOState &io, const char *path, const char *pref_path, const char *export_name) {
-    std::string translated_path = path;
-    VitaIoDevice device = get_device(translated_path);
+// Listings stay valid this long before open_dir walks the host directory
+// again - long enough to cover a boot-time enumeration burst, short enough
+// that changes show up promptly.
+static constexpr auto DIR_SNAPSHOT_TTL = std::chrono::seconds(1);
+
+static DirSnapshotPtr snapshot_dir(const std::string &dir_path) {
+#ifdef WIN32
+    const std::shared_ptr<_WDIR> dir(_wopendir(utf_to_wide_cached(dir_path).c_str()), _wclosedir);
+#else
+    const std::shared_ptr<DIR> dir(opendir(dir_path.c_str()), [](DIR *dir) {
+        if (dir != nullptr) {
+            closedir(dir);
+        }
+    });
+#endif
+    if (!dir) {
+        return DirSnapshotPtr();
+    }
+
+    const DirSnapshotPtr snapshot = std::make_shared<DirSnapshot>();
+    for (;;) {
+#ifdef WIN32
+        _wdirent *const d = _wreaddir(dir.get());
+#else
+        dirent *const d = readdir(dir.get());
+#endif
+        if (!d) {
+            break;
+        }
+
+        emu::SceIoDirent dent;
+        memset(&dent, '\0', sizeof(dent));
+#ifdef WIN32
+        const std::string d_name_utf8 = wide_to_utf(d->d_name);
+        strncpy(dent.d_name, d_name_utf8.c_str(), sizeof(dent.d_name));
+#else
+        strncpy(dent.d_name, d->d_name, sizeof(dent.d_name));
+#endif
+        if (!strcmp(dent.d_name, ".") || !strcmp(dent.d_name, "..")) {
+            // Skip . and .. folders
+            continue;
+        }
 
-    translate_path(translated_path, device, io.device_paths);
+        dent.d_stat.st_mode = d->d_type == DT_DIR ? SCE_S_IFDIR : SCE_S_IFREG;
+        snapshot->entries.push_back(dent);
+    }
+
+    snapshot->taken_at = std::chrono::steady_clock::now();
+    return snapshot;
+}
+
+int open_dir(IOState &io, const char *path, const char *pref_path, const char *export_name) {
+    const TranslatedPath &translated = translate_path_cached(io, path);
+    const std::string &translated_path = translated.path;
+    const VitaIoDevice device = translated.device;
 
     LOG_TRACE("{}: Opening dir {} ({})", export_name, translated_path, translated_path);
 
+    if (io.vpk) {
+        const DirSnapshotPtr snapshot = vpk_snapshot_dir(io, translated_path);
+        if (snapshot) {
+            FdSlot slot;
+            slot.kind = FdKind::Dir;
+            slot.dir.snapshot = snapshot;
+
+            return io.fds.emplace(std::move(slot));
+        }
+    }
+
     std::string dir_path;
     switch (device) {
     case VitaIoDevice::UX0:
@@ -573,70 +1101,255 @@ int open_dir(IOState &io, const char *path, const char *pref_path, const char *e
     }
     }
 
-#ifdef WIN32
-    const DirPtr dir(_wopendir((utf_to_wide(dir_path)).c_str()), _wclosedir);
-#else
-    const DirPtr dir(opendir(dir_path.c_str()), [](DIR *dir) {
-        if (dir != nullptr) {
-            closedir(dir);
+    DirSnapshotPtr snapshot;
+    {
+        const std::lock_guard<std::mutex> snapshots_lock(io.dir_snapshots_mutex);
+        const DirSnapshotCache::const_iterator cached = io.dir_snapshots.find(dir_path);
+        if ((cached != io.dir_snapshots.end()) && (std::chrono::steady_clock::now() - cached->second->taken_at < DIR_SNAPSHOT_TTL)) {
+            snapshot = cached->second;
         }
-    });
-#endif
-    if (!dir) {
-        return -1;
+    }
+    if (!snapshot) {
+        // Enumerate outside the lock; concurrent opens of the same directory
+        // may both snapshot it, and the last insert wins.
+        snapshot = snapshot_dir(dir_path);
+        const std::lock_guard<std::mutex> snapshots_lock(io.dir_snapshots_mutex);
+        if (!snapshot) {
+            io.dir_snapshots.erase(dir_path);
+            return -1;
+        }
+        io.dir_snapshots[dir_path] = snapshot;
     }
 
-    const SceUID fd = io.next_fd++;
-    io.dir_entries.emplace(fd, dir);
+    FdSlot slot;
+    slot.kind = FdKind::Dir;
+    slot.dir.snapshot = snapshot;
 
-    return fd;
+    return io.fds.emplace(std::move(slot));
 }
 
 int read_dir(IOState &io, SceUID fd, emu::SceIoDirent *dent, const char *export_name) {
     assert(dent != nullptr);
 
-    memset(dent->d_name, '\0', sizeof(dent->d_name));
-
     LOG_TRACE("{}: Reading dir fd: {}", export_name, log_hex(fd));
 
-    const DirEntries::const_iterator dir = io.dir_entries.find(fd);
-    if (dir != io.dir_entries.end()) {
-#ifdef WIN32
-        _wdirent *d = _wreaddir(dir->second.get());
-#else
-        dirent *d = readdir(dir->second.get());
-#endif
+    FdSlot *const slot = io.fds.get(fd);
+    if (!slot || (slot->kind != FdKind::Dir)) {
+        return IO_ERROR(SCE_ERROR_ERRNO_EBADF);
+    }
 
-        if (!d) {
-            return 0;
+    OpenDir &open_dir_state = slot->dir;
+    if (open_dir_state.next >= open_dir_state.snapshot->entries.size()) {
+        return 0;
+    }
+
+    *dent = open_dir_state.snapshot->entries[open_dir_state.next++];
+    return 1;
+}
+
+static std::string json_escape(const std::string &s) {
+    std::string escaped;
+    for (const char c : s) {
+        if ((c == '"') || (c == '\\')) {
+            escaped += '\\';
         }
+        escaped += c;
+    }
+    return escaped;
+}
+
+static void dump_op_stats(std::ofstream &out, const char *name, const IoOpStats &op) {
+    out << "\"" << name << "\": { \"count\": " << op.count << ", \"bytes\": " << op.bytes << ", \"latency_us_hist\": [";
+    for (size_t i = 0; i < IO_LATENCY_BUCKETS; i++) {
+        out << ((i > 0) ? ", " : "") << op.latency_us_hist[i];
+    }
+    out << "] }";
+}
 
+// Writes the collected telemetry as JSON, one record per guest path, for
+// characterizing a title's I/O pattern offline before tuning cache and
+// prefetch settings.
+bool dump_io_telemetry(IOState &io, const std::string &path) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    out << "{ \"files\": [";
+    bool first = true;
+    const std::lock_guard<std::mutex> telemetry_lock(io.telemetry.mutex);
+    for (const auto &entry : io.telemetry.files) {
+        const IoFdStats &stats = entry.second;
+        out << (first ? "" : ",") << "\n  { \"path\": \"" << json_escape(entry.first) << "\""
+            << ", \"opens\": " << stats.opens
+            << ", \"seeks\": " << stats.seeks
+            << ", \"sequential_reads\": " << stats.sequential_reads
+            << ", \"random_reads\": " << stats.random_reads << ", ";
+        dump_op_stats(out, "reads", stats.reads);
+        out << ", ";
+        dump_op_stats(out, "writes", stats.writes);
+        out << ", \"callers\": {";
+        bool first_caller = true;
+        for (const auto &caller : stats.callers) {
+            out << (first_caller ? " " : ", ") << "\"" << json_escape(caller.first) << "\": " << caller.second;
+            first_caller = false;
+        }
+        out << " } }";
+        first = false;
+    }
+    out << "\n] }\n";
+
+    return out.good();
+}
+
+void capture_io_state(IOState &io, SavedIoState &saved) {
+    const std::shared_lock<std::shared_mutex> fds_lock(io.fds.mutex);
+    saved.slot_count = io.fds.slots.size();
+    saved.fds.clear();
+
+    for (size_t fd = 0; fd < io.fds.slots.size(); ++fd) {
+        FdSlot &slot = io.fds.slots[fd];
+        if (slot.kind == FdKind::Free) {
+            continue;
+        }
+
+        SavedFd entry;
+        entry.fd = static_cast<SceUID>(fd);
+        entry.kind = static_cast<int>(slot.kind);
+
+        switch (slot.kind) {
+        case FdKind::Tty:
+            entry.tty = static_cast<int>(slot.tty);
+            break;
+        case FdKind::File:
+            // The restored fd reads whatever is on disk, so the cursor has
+            // to describe the flushed file.
+            flush_writes(*slot.file);
+            entry.guest_path = slot.file->guest_path;
+            entry.host_path = slot.file->host_path;
+            entry.open_flags = slot.file->open_flags;
+            entry.position = slot.file->position;
+            break;
+        case FdKind::VpkFile:
+            entry.guest_path = slot.vpk_file->guest_path;
+            entry.position = slot.vpk_file->position;
+            break;
+        case FdKind::Dir:
+            // A directory handle records no path to reopen from; the guest
+            // re-enumerating after a restore is the documented gap.
+            LOG_WARN("Save state: open directory fd {} will not be restored.", fd);
+            continue;
+        default:
+            continue;
+        }
+
+        saved.fds.push_back(std::move(entry));
+    }
+}
+
+bool restore_io_state(IOState &io, const SavedIoState &saved) {
+    FdTable fds;
+    fds.slots.resize(saved.slot_count);
+
+    for (const SavedFd &entry : saved.fds) {
+        if ((entry.fd < 0) || (static_cast<size_t>(entry.fd) >= fds.slots.size())) {
+            return false;
+        }
+        FdSlot &slot = fds.slots[entry.fd];
+
+        switch (static_cast<FdKind>(entry.kind)) {
+        case FdKind::Tty:
+            slot.kind = FdKind::Tty;
+            slot.tty = static_cast<TtyType>(entry.tty);
+            break;
+        case FdKind::File: {
+            // Never truncate on reopen - the file's current contents ARE the
+            // state being restored into.
+            const int open_flags = entry.open_flags & ~O_TRUNC;
 #ifdef WIN32
-        std::string d_name_utf8 = wide_to_utf(d->d_name);
-        strncpy(dent->d_name, d_name_utf8.c_str(), sizeof(dent->d_name));
+            const int host_fd = _wopen(utf_to_wide(entry.host_path).c_str(), open_flags | _O_BINARY, _S_IREAD | _S_IWRITE);
 #else
-        strncpy(dent->d_name, d->d_name, sizeof(dent->d_name));
+            const int host_fd = open(entry.host_path.c_str(), open_flags, 0644);
 #endif
-        if (!strcmp(dent->d_name, ".") || !strcmp(dent->d_name, "..")) {
-            // Skip . and .. folders
-            return read_dir(io, fd, dent, export_name);
+            if (host_fd < 0) {
+                LOG_ERROR("Save state: could not reopen {} ({}).", entry.guest_path, entry.host_path);
+                return false;
+            }
+
+            const StdFilePtr file = std::make_shared<StdFile>();
+            file->fd = host_fd;
+            file->size = host_file_size(host_fd);
+            file->guest_path = entry.guest_path;
+            file->host_path = entry.host_path;
+            file->open_flags = open_flags;
+            file->position = entry.position;
+            if ((open_flags == O_RDONLY) && (file->size >= MMAP_THRESHOLD)) {
+                map_readonly_file(*file);
+            }
+
+            slot.kind = FdKind::File;
+            slot.file = file;
+            break;
         }
+        case FdKind::VpkFile: {
+            if (!io.vpk) {
+                LOG_ERROR("Save state: fd {} was a VPK entry but no VPK is mounted.", entry.fd);
+                return false;
+            }
+            const TranslatedPath &translated = translate_path_cached(io, entry.guest_path);
+            VpkEntry *const vpk_entry = vpk_find_entry(io, translated.path);
+            if (!vpk_entry || vpk_entry->is_dir) {
+                LOG_ERROR("Save state: VPK entry {} not found.", entry.guest_path);
+                return false;
+            }
+            const VpkFilePtr file = std::make_shared<VpkFile>();
+            file->entry = vpk_entry;
+            file->guest_path = entry.guest_path;
+            file->position = entry.position;
+            slot.kind = FdKind::VpkFile;
+            slot.vpk_file = file;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
 
-        dent->d_stat.st_mode = d->d_type == DT_DIR ? SCE_S_IFDIR : SCE_S_IFREG;
+    // Everything not restored goes back on the free list, mirroring what
+    // emplace would have produced.
+    for (size_t fd = fds.slots.size(); fd-- > 0;) {
+        if (fds.slots[fd].kind == FdKind::Free) {
+            fds.free_fds.push_back(static_cast<SceUID>(fd));
+        }
+    }
 
-        return 1;
+    // FdTable owns a mutex and cannot be moved wholesale; swap in the
+    // rebuilt tables under it (emulation is paused, but stay disciplined).
+    {
+        const std::lock_guard<std::shared_mutex> fds_lock(io.fds.mutex);
+        io.fds.slots = std::move(fds.slots);
+        io.fds.free_fds = std::move(fds.free_fds);
+    }
+    {
+        const std::lock_guard<std::mutex> stat_lock(io.stat_cache_mutex);
+        io.stat_cache.clear();
+    }
+    {
+        const std::lock_guard<std::mutex> snapshots_lock(io.dir_snapshots_mutex);
+        io.dir_snapshots.clear();
     }
 
-    return IO_ERROR(SCE_ERROR_ERRNO_EBADF);
+    return true;
 }
 
 int close_dir(IOState &io, SceUID fd, const char *export_name) {
-    const auto erased_entries = io.dir_entries.erase(fd);
-
     LOG_TRACE("{}: Closing dir fd: {}", export_name, log_hex(fd));
 
-    if (erased_entries == 0)
+    FdSlot *const slot = io.fds.get(fd);
+    if (!slot || (slot->kind != FdKind::Dir)) {
         return IO_ERROR(SCE_ERROR_ERRNO_EBADF);
-    else
-        return 0;
+    }
+
+    io.fds.close(fd);
+    return 0;
 }
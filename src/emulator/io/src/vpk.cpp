@@ -0,0 +1,334 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <io/functions.h>
+#include <io/state.h>
+
+#include <psp2/io/dirent.h>
+#include <psp2/io/stat.h>
+
+#include <util/log.h>
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+// Inflated deflated entries are kept around up to this budget, so the
+// archive's hot compressed assets are decompressed once rather than on every
+// read. Stored entries never enter the cache - they are read in place.
+static constexpr uint64_t VPK_INFLATED_BUDGET = 64 * 1024 * 1024;
+
+static void delete_mount_zip(mz_zip_archive *zip) {
+    mz_zip_reader_end(zip);
+    delete zip;
+}
+
+VpkMount::~VpkMount() {
+    zip.reset(); // end the reader before its backing stream goes away
+    if (fp) {
+        fclose(fp);
+    }
+}
+
+// Positioned read of the archive itself - same idea as read_at on a StdFile,
+// so stored-entry reads never contend on the shared FILE cursor miniz uses.
+static int pread_host(int fd, void *data, size_t size, int64_t offset) {
+#ifdef WIN32
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD transferred = 0;
+    if (!ReadFile(reinterpret_cast<HANDLE>(_get_osfhandle(fd)), data, static_cast<DWORD>(size), &transferred, &overlapped)) {
+        return (GetLastError() == ERROR_HANDLE_EOF) ? 0 : -1;
+    }
+    return static_cast<int>(transferred);
+#else
+    return static_cast<int>(pread(fd, data, size, offset));
+#endif
+}
+
+// The central directory only records where the local header starts; the raw
+// data follows the header's variable-length name and extra fields.
+static bool resolve_data_ofs(VpkMount &mount, VpkEntry &entry) {
+    uint8_t local_header[30];
+    if (pread_host(mount.fd, local_header, sizeof(local_header), entry.local_header_ofs) != sizeof(local_header)) {
+        return false;
+    }
+
+    const uint16_t filename_len = local_header[26] | (local_header[27] << 8);
+    const uint16_t extra_len = local_header[28] | (local_header[29] << 8);
+    entry.data_ofs = entry.local_header_ofs + sizeof(local_header) + filename_len + extra_len;
+    return true;
+}
+
+// Inflates a deflated entry into the cache, evicting least recently used
+// buffers once over budget. Caller holds the mount mutex.
+static VpkDataPtr inflate_entry(VpkMount &mount, const VpkEntry &entry) {
+    const auto cached = mount.inflated.find(entry.index);
+    if (cached != mount.inflated.end()) {
+        cached->second.last_used = ++mount.use_counter;
+        return cached->second.data;
+    }
+
+    const VpkDataPtr data = std::make_shared<std::vector<uint8_t>>(entry.size);
+    if (!mz_zip_reader_extract_to_mem(mount.zip.get(), entry.index, data->data(), data->size(), 0)) {
+        LOG_CRITICAL("Failed to inflate vpk entry {}.", entry.index);
+        return VpkDataPtr();
+    }
+
+    mount.inflated[entry.index] = { data, ++mount.use_counter };
+    mount.inflated_bytes += data->size();
+
+    while ((mount.inflated_bytes > VPK_INFLATED_BUDGET) && (mount.inflated.size() > 1)) {
+        auto victim = mount.inflated.begin();
+        for (auto it = mount.inflated.begin(); it != mount.inflated.end(); ++it) {
+            if (it->second.last_used < victim->second.last_used) {
+                victim = it;
+            }
+        }
+        if (victim->second.data == data) {
+            break; // never evict the entry being served
+        }
+        mount.inflated_bytes -= victim->second.data->size();
+        mount.inflated.erase(victim);
+    }
+
+    return data;
+}
+
+static void add_dir_entry(VpkMount &mount, const std::string &path) {
+    VpkEntry &entry = mount.entries[path];
+    entry.is_dir = true;
+}
+
+bool init_vpk_mount(IOState &io, FILE *fp) {
+    const ZipPtr zip(new mz_zip_archive, delete_mount_zip);
+    std::memset(zip.get(), 0, sizeof(*zip));
+
+    if (!mz_zip_reader_init_cfile(zip.get(), fp, 0, 0)) {
+        LOG_CRITICAL("Cannot init miniz reader");
+        return false;
+    }
+
+    const mz_uint num_files = mz_zip_reader_get_num_files(zip.get());
+
+    // Archives either hold the app at the root or under a single title
+    // directory; locate param.sfo to learn which, as install_vpk does.
+    static const char *const SFO_SUFFIX = "sce_sys/param.sfo";
+    std::string root_prefix;
+    bool sfo_found = false;
+    for (mz_uint i = 0; i < num_files; i++) {
+        mz_zip_archive_file_stat file_stat;
+        if (!mz_zip_reader_file_stat(zip.get(), i, &file_stat)) {
+            continue;
+        }
+        const std::string name = file_stat.m_filename;
+        if ((name.length() >= strlen(SFO_SUFFIX)) && (name.compare(name.length() - strlen(SFO_SUFFIX), strlen(SFO_SUFFIX), SFO_SUFFIX) == 0)) {
+            root_prefix = name.substr(0, name.length() - strlen(SFO_SUFFIX));
+            sfo_found = true;
+            break;
+        }
+    }
+    if (!sfo_found) {
+        LOG_CRITICAL("Failed to locate {} in the vpk.", SFO_SUFFIX);
+        return false;
+    }
+
+    const VpkMountPtr mount = std::make_shared<VpkMount>();
+    mount->zip = zip;
+    mount->fp = fp;
+#ifdef WIN32
+    mount->fd = _fileno(fp);
+#else
+    mount->fd = fileno(fp);
+#endif
+
+    add_dir_entry(*mount, ""); // the app root itself
+
+    for (mz_uint i = 0; i < num_files; i++) {
+        mz_zip_archive_file_stat file_stat;
+        if (!mz_zip_reader_file_stat(zip.get(), i, &file_stat)) {
+            continue;
+        }
+
+        std::string name = file_stat.m_filename;
+        if (name.compare(0, root_prefix.length(), root_prefix) != 0) {
+            continue; // outside the app root
+        }
+        name.erase(0, root_prefix.length());
+
+        const bool is_dir = mz_zip_reader_is_file_a_directory(zip.get(), i);
+        while (!name.empty() && (name.back() == '/')) {
+            name.pop_back();
+        }
+        if (name.empty()) {
+            continue;
+        }
+
+        // Not every archive records its directories; synthesize the parents.
+        for (size_t slash = name.find('/'); slash != std::string::npos; slash = name.find('/', slash + 1)) {
+            add_dir_entry(*mount, name.substr(0, slash));
+        }
+
+        VpkEntry &entry = mount->entries[name];
+        entry.index = i;
+        entry.size = file_stat.m_uncomp_size;
+        entry.local_header_ofs = file_stat.m_local_header_ofs;
+        entry.mtime = file_stat.m_time;
+        entry.compressed = file_stat.m_method != 0;
+        entry.is_dir = is_dir;
+    }
+
+    io.vpk = mount;
+    return true;
+}
+
+// Resolves a translated ux0 path to a path relative to the mounted app root,
+// or returns false if it lies outside the mount. Component-wise, so stray or
+// doubled slashes from the app0 redirect do not defeat the lookup.
+static bool vpk_relative_path(std::string &rel, const IOState &io, const std::string &translated_path) {
+    if (translated_path.compare(0, 4, "ux0:") != 0) {
+        return false;
+    }
+
+    std::vector<std::string> components;
+    std::string component;
+    for (size_t pos = 4; pos <= translated_path.length(); pos++) {
+        if ((pos == translated_path.length()) || (translated_path[pos] == '/')) {
+            if (!component.empty()) {
+                components.push_back(component);
+                component.clear();
+            }
+        } else {
+            component += translated_path[pos];
+        }
+    }
+
+    if ((components.size() < 2) || (components[0] != "app") || (components[1] != io.title_id)) {
+        return false;
+    }
+
+    rel.clear();
+    for (size_t i = 2; i < components.size(); i++) {
+        if (!rel.empty()) {
+            rel += '/';
+        }
+        rel += components[i];
+    }
+    return true;
+}
+
+VpkEntry *vpk_find_entry(IOState &io, const std::string &translated_path) {
+    std::string rel;
+    if (!io.vpk || !vpk_relative_path(rel, io, translated_path)) {
+        return nullptr;
+    }
+
+    const auto entry = io.vpk->entries.find(rel);
+    if (entry == io.vpk->entries.end()) {
+        return nullptr;
+    }
+    return &entry->second;
+}
+
+int vpk_read(IOState &io, VpkEntry &entry, void *data, SceSize size, int64_t offset) {
+    if (offset >= entry.size) {
+        return 0;
+    }
+    const int64_t to_copy = std::min(static_cast<int64_t>(size), entry.size - offset);
+
+    VpkMount &mount = *io.vpk;
+
+    if (entry.compressed) {
+        const std::lock_guard<std::mutex> lock(mount.mutex);
+        const VpkDataPtr inflated = inflate_entry(mount, entry);
+        if (!inflated) {
+            return -1;
+        }
+        memcpy(data, inflated->data() + offset, static_cast<size_t>(to_copy));
+        return static_cast<int>(to_copy);
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(mount.mutex);
+        if ((entry.data_ofs < 0) && !resolve_data_ofs(mount, entry)) {
+            return -1;
+        }
+    }
+
+    // Stored entry - straight out of the archive, no staging buffer.
+    return pread_host(mount.fd, data, static_cast<size_t>(to_copy), entry.data_ofs + offset);
+}
+
+bool read_mounted_file(std::vector<uint8_t> &buf, IOState &io, const char *path) {
+    if (!io.vpk) {
+        return false;
+    }
+
+    const auto entry = io.vpk->entries.find(path);
+    if ((entry == io.vpk->entries.end()) || entry->second.is_dir) {
+        return false;
+    }
+
+    buf.resize(entry->second.size);
+    return vpk_read(io, entry->second, buf.data(), static_cast<SceSize>(buf.size()), 0) == entry->second.size;
+}
+
+std::shared_ptr<DirSnapshot> vpk_snapshot_dir(IOState &io, const std::string &translated_path) {
+    std::string rel;
+    if (!io.vpk || !vpk_relative_path(rel, io, translated_path)) {
+        return DirSnapshotPtr();
+    }
+
+    const auto dir = io.vpk->entries.find(rel);
+    if ((dir == io.vpk->entries.end()) || !dir->second.is_dir) {
+        return DirSnapshotPtr();
+    }
+
+    const std::string prefix = rel.empty() ? rel : rel + '/';
+    const DirSnapshotPtr snapshot = std::make_shared<DirSnapshot>();
+
+    // The index is sorted, so the directory's children are one contiguous
+    // range of immediate descendants - entries with a deeper slash are
+    // represented by their synthesized parent.
+    for (auto it = io.vpk->entries.upper_bound(prefix); it != io.vpk->entries.end(); ++it) {
+        if (it->first.compare(0, prefix.length(), prefix) != 0) {
+            break;
+        }
+        const std::string name = it->first.substr(prefix.length());
+        if (name.find('/') != std::string::npos) {
+            continue;
+        }
+
+        emu::SceIoDirent dent;
+        memset(&dent, '\0', sizeof(dent));
+        strncpy(dent.d_name, name.c_str(), sizeof(dent.d_name));
+        dent.d_stat.st_mode = it->second.is_dir ? SCE_S_IFDIR : SCE_S_IFREG;
+        dent.d_stat.st_size = it->second.size;
+        snapshot->entries.push_back(dent);
+    }
+
+    snapshot->taken_at = std::chrono::steady_clock::now();
+    return snapshot;
+}
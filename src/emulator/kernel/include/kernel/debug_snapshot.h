@@ -0,0 +1,85 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <mem/mem.h> // Address.
+
+#include <psp2/types.h>
+
+#include <string>
+#include <vector>
+
+struct KernelState;
+
+// Plain rows for the kernel debug dialogs, decoupled from the live kernel
+// objects so rendering never touches KernelState or its lock.
+
+struct ThreadSnapshotRow {
+    SceUID id;
+    std::string name;
+    const char *state; // static label, e.g. "Running"
+    Address stack;
+};
+
+struct MutexSnapshotRow {
+    SceUID id;
+    std::string name;
+    int lock_count;
+    uint32_t attr;
+    size_t waiters;
+    std::string owner; // empty when not owned
+};
+
+struct SemaphoreSnapshotRow {
+    SceUID id;
+    std::string name;
+    int val;
+    int max;
+    size_t waiters;
+};
+
+struct CondvarSnapshotRow {
+    SceUID id;
+    std::string name;
+    uint32_t attr;
+    size_t waiters;
+};
+
+struct EventFlagSnapshotRow {
+    SceUID id;
+    std::string name;
+    int flags;
+    uint32_t attr;
+    size_t waiters;
+};
+
+struct KernelDebugSnapshot {
+    std::vector<ThreadSnapshotRow> threads;
+    std::vector<MutexSnapshotRow> mutexes;
+    std::vector<MutexSnapshotRow> lwmutexes;
+    std::vector<SemaphoreSnapshotRow> semaphores;
+    std::vector<CondvarSnapshotRow> condvars;
+    std::vector<CondvarSnapshotRow> lwcondvars;
+    std::vector<EventFlagSnapshotRow> eventflags;
+};
+
+// Copies the rows the debug dialogs render out of the live kernel tables,
+// holding the kernel lock shared only for the microseconds the copy takes.
+// Row vectors are cleared rather than shrunk, so capturing into a reused
+// snapshot settles into zero allocation.
+void capture_debug_snapshot(KernelState &kernel, KernelDebugSnapshot &snapshot);
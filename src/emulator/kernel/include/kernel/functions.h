@@ -17,12 +17,47 @@
 
 #pragma once
 
+#include <cpu/functions.h> // CPUContext.
+#include <mem/mem.h> // Address.
+
 #include <psp2/types.h>
 
+#include <map>
+#include <vector>
+
 template <class T>
 class Ptr;
+struct ExportNids;
 struct KernelState;
 struct MemState;
 
+typedef std::map<SceUID, CPUContext> ThreadContexts;
+
+// Duplicate NIDs keep the first registration, like the map these replaced.
+void add_export(ExportNids &exports, uint32_t nid, Address entry);
+// Returns 0 when the NID is not exported. Merges any pending inserts first,
+// so callers need the same exclusive access a map insert would have needed.
+Address find_export(ExportNids &exports, uint32_t nid);
+
 Ptr<Ptr<void>> get_thread_tls_addr(KernelState &kernel, MemState &mem, SceUID thread_id, int key);
+
+// Guest callbacks (sceKernelCreateCallback and friends). callback_notify
+// only queues the callback on its owning thread; deliver_pending_callbacks
+// runs the queued batch and must be called from the owning thread at one of
+// its check points. Returns the number of callbacks delivered.
+SceUID callback_create(KernelState &kernel, const char *export_name, SceUID thread_id, const char *name, SceUInt attr, Ptr<const void> entry, Ptr<void> common);
+int callback_delete(KernelState &kernel, const char *export_name, SceUID cbid);
+int callback_notify(KernelState &kernel, const char *export_name, SceUID cbid, SceInt32 notify_arg);
+int callback_cancel(KernelState &kernel, const char *export_name, SceUID cbid);
+int callback_count(KernelState &kernel, const char *export_name, SceUID cbid);
+int deliver_pending_callbacks(KernelState &kernel, const char *export_name, SceUID thread_id);
 void stop_all_threads(KernelState &kernel);
+// Register-file capture for save states - pairs with the MemState snapshot.
+void capture_thread_contexts(KernelState &kernel, ThreadContexts &contexts);
+void restore_thread_contexts(KernelState &kernel, const ThreadContexts &contexts);
+// Parks every running guest thread outside the CPU and returns their ids so
+// resume_threads can wake exactly those. Threads blocked inside an HLE wait
+// never re-enter the run loop, but they are not executing guest code either,
+// so a bounded wait per thread is enough for a consistent capture.
+std::vector<SceUID> pause_all_threads(KernelState &kernel);
+void resume_threads(KernelState &kernel, const std::vector<SceUID> &thread_ids);
@@ -18,8 +18,23 @@
 #pragma once
 #include "kernel/state.h"
 #include "psp2/types.h"
+
+#include <functional>
+
 struct MemState;
 template <class T>
 class Ptr;
 
-SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &mem, const void *self, const char *path);
+// Pull-based view of a SELF image: copies size bytes at offset into dst and
+// returns false on a short or failed read. Lets segment payloads stream
+// straight into their guest destinations without staging the whole file.
+typedef std::function<bool(void *dst, size_t size, uint64_t offset)> SelfReadFn;
+
+// If cache_dir is given, the fully loaded and relocated segment images are
+// cached there after the first load, keyed by a hash of the module. On later
+// boots they are copied straight into guest memory, skipping the inflate and
+// relocation passes. The cache is only used when the allocator hands back
+// the same segment bases the image was relocated for; anything else falls
+// back to the normal path.
+SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &mem, const SelfReadFn &read_at, const char *path, const char *cache_dir = nullptr);
+SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &mem, const void *self, const char *path, const char *cache_dir = nullptr);
@@ -0,0 +1,59 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <mem/mem.h> // Address.
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct KernelState;
+
+// One aggregated entry of the hot-function report.
+struct ProfilerHotFunction {
+    Address address = 0;
+    std::string name;
+    uint64_t samples = 0;
+};
+
+// Wall-clock sampling profiler. A host worker periodically captures PC/LR
+// from every running guest CPUState and attributes the hits to the nearest
+// known export, so the report stays cheap enough to leave running while
+// playing.
+struct SamplingProfiler {
+    std::atomic<bool> running{ false };
+    std::thread worker;
+    std::mutex mutex;
+    std::map<Address, uint64_t> samples; // keyed by attributed function address
+    uint64_t total_samples = 0;
+
+    ~SamplingProfiler() {
+        if (worker.joinable()) {
+            running = false;
+            worker.join();
+        }
+    }
+};
+
+void start_sampling_profiler(KernelState &kernel);
+void stop_sampling_profiler(KernelState &kernel);
+std::vector<ProfilerHotFunction> profiler_hot_functions(KernelState &kernel, size_t max_functions);
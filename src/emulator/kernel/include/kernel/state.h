@@ -17,37 +17,62 @@
 
 #pragma once
 
+#include <cpu/functions.h>
+#include <kernel/profiler.h>
+#include <kernel/thread/thread_pool.h>
 #include <kernel/thread/thread_state.h>
+#include <kernel/timer.h>
 #include <kernel/types.h>
 #include <mem/ptr.h>
+#include <rtc/rtc.h>
+#include <util/object_pool.h>
+#include <util/uid_table.h>
 
 #include <psp2/rtc.h>
 #include <psp2/types.h>
 
 #include <atomic>
+#include <chrono>
 #include <map>
 #include <mutex>
 #include <queue>
+#include <shared_mutex>
 #include <vector>
 
 struct ThreadState;
 
-struct SDL_Thread;
-
 typedef std::map<SceUID, Ptr<void>> Blocks;
 typedef std::map<SceUID, Ptr<Ptr<void>>> SlotToAddress;
 typedef std::map<SceUID, SlotToAddress> ThreadToSlotToAddress;
 typedef std::shared_ptr<ThreadState> ThreadStatePtr;
-typedef std::map<SceUID, ThreadStatePtr> ThreadStatePtrs;
-typedef std::shared_ptr<SDL_Thread> ThreadPtr;
+// The per-call handle tables are flat slot tables - a UID's low bits index
+// the slot and its high bits must match the slot generation - so the HLE hot
+// path resolves handles without walking a tree.
+typedef UIDTable<ThreadState> ThreadStatePtrs;
+// The worker currently lent to a started guest thread; the deleter tells the
+// guest thread to exit so the worker can return to the pool.
+typedef std::shared_ptr<PooledWorker> ThreadPtr;
 typedef std::map<SceUID, ThreadPtr> ThreadPtrs;
 typedef std::shared_ptr<emu::SceKernelModuleInfo> SceKernelModuleInfoPtr;
 typedef std::map<SceUID, SceKernelModuleInfoPtr> SceKernelModuleInfoPtrs;
-typedef std::map<uint32_t, Address> ExportNids;
+// Module exports, NID -> entry address, kept as a flat array sorted by NID.
+// load_exports stages its inserts in the pending block; the first lookup
+// afterwards sorts the block and merges it in, so import resolution binary
+// searches contiguous memory instead of chasing map nodes. Go through
+// add_export/find_export in kernel/functions.h.
+struct ExportNids {
+    typedef std::pair<uint32_t, Address> value_type;
+    std::vector<value_type> sorted;
+    std::vector<value_type> pending;
+};
+// NID of each import stub, indexed by the slot number the loader encoded in
+// the stub's svc immediate (slot n -> svc #(n + 1), 0 stays a plain svc).
+typedef std::vector<uint32_t> ImportNidSlots;
 
 struct WaitingThreadData {
     ThreadStatePtr thread;
     int32_t priority;
+    uint64_t seq; // arrival order, stamped by WaitingThreadQueue
 
     // additional fields for each primitive
     union {
@@ -66,7 +91,11 @@ struct WaitingThreadData {
     };
 
     bool operator>(const WaitingThreadData &rhs) const {
-        return priority > rhs.priority;
+        // Earlier arrivals win ties so FIFO-attribute primitives (all waiters
+        // at priority 0) wake threads in the order they blocked.
+        if (priority != rhs.priority)
+            return priority > rhs.priority;
+        return seq > rhs.seq;
     }
 
     bool operator==(const WaitingThreadData &rhs) const {
@@ -80,8 +109,18 @@ struct WaitingThreadData {
 
 class WaitingThreadQueue : public std::priority_queue<WaitingThreadData, std::vector<WaitingThreadData>, std::greater<WaitingThreadData>> {
 public:
+    WaitingThreadQueue() {
+        // Keep the wait/wake hot path allocation-free for realistic waiter
+        // counts.
+        this->c.reserve(16);
+    }
+
     auto begin() const { return this->c.begin(); }
     auto end() const { return this->c.end(); }
+    void emplace(WaitingThreadData data) {
+        data.seq = next_seq++;
+        this->push(data);
+    }
     bool remove(const WaitingThreadData &value) {
         auto it = std::find(this->c.begin(), this->c.end(), value);
         if (it != this->c.end()) {
@@ -98,11 +137,26 @@ public:
     auto find(const ThreadStatePtr &value) {
         return std::find(this->c.begin(), this->c.end(), value);
     }
+
+private:
+    uint64_t next_seq = 0;
 };
 
 // NOTE: uid is copied to sync primitives here for debugging,
 //       not really needed since they are put in std::map's
 
+// Contention counters sampled on the sync paths. Updated under the owning
+// primitive's mutex, so plain fields suffice; hold times only apply to
+// mutexes. acquired_at tracks when the current owner took the lock.
+struct SyncStats {
+    uint64_t acquisitions = 0;
+    uint64_t contentions = 0; // operations that had to block
+    uint64_t total_hold_us = 0;
+    uint64_t max_hold_us = 0;
+    size_t max_waiters = 0;
+    std::chrono::steady_clock::time_point acquired_at;
+};
+
 struct Semaphore {
     SceUID uid;
     int val;
@@ -110,10 +164,9 @@ struct Semaphore {
     uint32_t attr;
     std::mutex mutex;
     WaitingThreadQueue waiting_threads;
+    SyncStats stats;
     char name[KERNELOBJECT_MAX_NAME_LENGTH + 1];
 };
-typedef std::shared_ptr<Semaphore> SemaphorePtr;
-typedef std::map<SceUID, SemaphorePtr> SemaphorePtrs;
 
 struct Mutex {
     SceUID uid;
@@ -122,6 +175,10 @@ struct Mutex {
     std::mutex mutex;
     WaitingThreadQueue waiting_threads;
     ThreadStatePtr owner;
+    // Lightweight mutexes keep owner/lock_count in the guest work area and
+    // use this object only as the parking lot for contended waiters.
+    emu::SceKernelLwMutexWork *workarea = nullptr;
+    SyncStats stats;
     char name[KERNELOBJECT_MAX_NAME_LENGTH + 1];
 };
 
@@ -131,15 +188,16 @@ struct EventFlag {
     uint32_t attr;
     std::mutex mutex;
     WaitingThreadQueue waiting_threads;
+    SyncStats stats;
     char name[KERNELOBJECT_MAX_NAME_LENGTH + 1];
 };
 
 typedef std::shared_ptr<Semaphore> SemaphorePtr;
-typedef std::map<SceUID, SemaphorePtr> SemaphorePtrs;
+typedef UIDTable<Semaphore> SemaphorePtrs;
 typedef std::shared_ptr<Mutex> MutexPtr;
-typedef std::map<SceUID, MutexPtr> MutexPtrs;
+typedef UIDTable<Mutex> MutexPtrs;
 typedef std::shared_ptr<EventFlag> EventFlagPtr;
-typedef std::map<SceUID, EventFlagPtr> EventFlagPtrs;
+typedef UIDTable<EventFlag> EventFlagPtrs;
 
 struct Condvar {
     struct SignalTarget {
@@ -164,10 +222,53 @@ struct Condvar {
     MutexPtr associated_mutex;
     std::mutex mutex;
     WaitingThreadQueue waiting_threads;
+    SyncStats stats;
     char name[KERNELOBJECT_MAX_NAME_LENGTH + 1];
 };
 typedef std::shared_ptr<Condvar> CondvarPtr;
-typedef std::map<SceUID, CondvarPtr> CondvarPtrs;
+typedef UIDTable<Condvar> CondvarPtrs;
+
+// Guest callback: a function the title registers to run on a specific
+// thread. Notifying one only marks it pending on that thread; delivery
+// happens in a batch when the owning thread reaches one of its own check
+// points (sceKernelCheckCallback, the *CB waits) - see
+// deliver_pending_callbacks. A callback is bound to its thread for life,
+// so the mutable fields are guarded by the owning thread's mutex.
+struct Callback {
+    SceUID uid;
+    SceUID thread_id; // the only thread this callback ever runs on
+    Ptr<const void> entry;
+    Ptr<void> common; // the title's context pointer, passed through in r3
+    uint32_t attr;
+    // Notifications before delivery coalesce into the one pending slot: the
+    // count accumulates and the latest argument wins.
+    SceInt32 notify_count = 0;
+    SceInt32 notify_arg = 0;
+    char name[KERNELOBJECT_MAX_NAME_LENGTH + 1];
+};
+typedef std::shared_ptr<Callback> CallbackPtr;
+typedef UIDTable<Callback> CallbackPtrs;
+
+// A SceFiber guest object, tracked host-side and keyed by the guest address
+// of the title's (opaque to us) SceFiber structure. A suspended fiber is
+// just a parked register file: switching fibers is a context save plus a
+// context load on the running thread's CPU, never a host scheduler
+// round-trip.
+struct Fiber {
+    Address addr = 0; // guest SceFiber address, the lookup key
+    Address entry = 0;
+    uint32_t arg_on_initialize = 0;
+    Address context_base = 0; // bottom of the fiber's stack
+    SceSize context_size = 0;
+    bool pooled_context = false; // stack borrowed from the fiber stack pool
+    bool started = false; // entered at least once; ctx is valid when suspended
+    bool running = false;
+    Address return_ptr = 0; // guest SceUInt32* the suspending call wants filled on resume
+    CPUContext ctx;
+    char name[KERNELOBJECT_MAX_NAME_LENGTH + 1] = {};
+};
+typedef std::shared_ptr<Fiber> FiberPtr;
+typedef std::map<Address, FiberPtr> FiberPtrs;
 
 namespace emu {
     typedef Ptr<int(SceSize args, Ptr<void> argp)> SceKernelThreadEntry;
@@ -180,22 +281,43 @@ struct WaitingThreadState {
 typedef std::map<SceUID, WaitingThreadState> KernelWaitingThreadStates;
 
 struct KernelState {
-    std::mutex mutex;
+    CPUBackend cpu_backend = CPUBackend::Unicorn;
+    // Scheduler time slice in guest instructions, applied to every thread at
+    // creation. Roughly a few milliseconds of guest work; 0 disables slicing
+    // and restores run-to-next-SVC behaviour.
+    uint64_t execution_quantum = 1000000;
+    // Guards the kernel object maps only. Object state is protected by the
+    // per-object mutexes, so lookups from concurrently running guest threads
+    // take this shared.
+    std::shared_mutex mutex;
     Blocks blocks;
-    ThreadToSlotToAddress tls;
+    ThreadToSlotToAddress tls; // diagnostics mirror; resolution uses ThreadState::tls
     SemaphorePtrs semaphores;
     CondvarPtrs condvars;
     CondvarPtrs lwcondvars;
     MutexPtrs mutexes;
     MutexPtrs lwmutexes; // also Mutexes for now
     EventFlagPtrs eventflags;
+    CallbackPtrs callbacks;
+    FiberPtrs fibers;
+    // Recycled guest stacks for fibers whose titles did not supply a
+    // context buffer, by size - ULT-style worker pools churn fibers, and a
+    // recycled stack skips the allocator entirely.
+    std::map<SceSize, std::vector<Address>> fiber_stack_pool;
     ThreadStatePtrs threads;
     ThreadPtrs running_threads;
     KernelWaitingThreadStates waiting_threads;
     SceKernelModuleInfoPtrs loaded_modules;
     ExportNids export_nids;
+    ImportNidSlots import_nid_slots;
     SceRtcTick base_tick;
+    CoarseTimeState coarse_time; // cached ticks for the hot time NIDs
     Ptr<uint32_t> process_param;
+    SamplingProfiler profiler;
+    ObjectPool object_pool; // recycles kernel object nodes
+    ThreadPool thread_pool; // recycles host threads for guest threads
+    CPUPool cpu_pool; // recycles CPU engines across guest thread churn
+    TimerState timer; // batches guest delays onto one deadline thread
 
     SceUID get_next_uid() {
         return next_uid++;
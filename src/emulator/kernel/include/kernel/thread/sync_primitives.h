@@ -27,11 +27,17 @@ enum class SyncWeight {
 };
 
 // Mutex
-SceUID mutex_create(SceUID *uid_out, KernelState &kernel, const char *export_name, SceUID thread_id, const char *name, SceUInt attr, int init_count, SyncWeight weight);
+SceUID mutex_create(SceUID *uid_out, KernelState &kernel, const char *export_name, SceUID thread_id, const char *name, SceUInt attr, int init_count, emu::SceKernelLwMutexWork *workarea, SyncWeight weight);
 int mutex_lock(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, int lock_count, unsigned int *timeout, SyncWeight weight);
 int mutex_unlock(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, int unlock_count, SyncWeight weight);
 int mutex_delete(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, SyncWeight weight);
 
+// Lightweight mutex userland protocol - uncontended lock/unlock is a
+// compare-exchange on the guest work area; the kernel is only involved when
+// a thread has to park or be handed the lock.
+int lw_mutex_lock(KernelState &kernel, const char *export_name, SceUID thread_id, emu::SceKernelLwMutexWork *workarea, int lock_count);
+int lw_mutex_unlock(KernelState &kernel, const char *export_name, SceUID thread_id, emu::SceKernelLwMutexWork *workarea, int unlock_count);
+
 // Semaphore
 SceUID semaphore_create(KernelState &kernel, const char *export_name, const char *name, SceUInt attr, int initVal, int maxVal);
 int semaphore_wait(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID semaid, SceInt32 signal, SceUInt *timeout);
@@ -0,0 +1,51 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct ThreadPool;
+
+typedef std::function<void()> ThreadPoolJob;
+
+// A recycled host thread. A guest thread blocks inside its run loop, so every
+// live guest thread keeps hold of one worker for as long as it exists; what
+// the pool removes is the host spawn/teardown cost when a title churns
+// through short-lived threads.
+struct PooledWorker {
+    ThreadPool *pool = nullptr;
+    std::mutex mutex;
+    std::condition_variable job_ready;
+    ThreadPoolJob job;
+    bool busy = false;
+};
+
+struct ThreadPool {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<PooledWorker>> workers; // owns every worker for the emulator's lifetime
+    std::deque<PooledWorker *> idle;
+};
+
+// Runs the job on an idle worker, spawning a new host thread only when none
+// is parked. Returns nullptr if a host thread could not be created.
+PooledWorker *run_on_worker(ThreadPool &pool, ThreadPoolJob job);
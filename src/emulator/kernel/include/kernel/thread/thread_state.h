@@ -17,12 +17,19 @@
 
 #pragma once
 
+#include <cpu/functions.h> // CPUContext.
 #include <mem/mem.h> // Address.
+#include <mem/ptr.h>
 
+#include <psp2/types.h>
+
+#include <array>
 #include <condition_variable>
 #include <mutex>
 #include <string>
+#include <vector>
 
+struct Callback;
 struct CPUState;
 template <typename T>
 class Resource;
@@ -31,6 +38,10 @@ typedef Resource<Address> ThreadStack;
 typedef std::shared_ptr<ThreadStack> ThreadStackPtr;
 typedef std::unique_ptr<CPUState, std::function<void(CPUState *)>> CPUStatePtr;
 
+// Covers the guest kernel's TLS key space with room to spare; 256 guest
+// pointers cost 1 KB per thread.
+constexpr size_t TLS_SLOT_COUNT = 0x100;
+
 enum class ThreadToDo {
     exit,
     run,
@@ -38,13 +49,36 @@ enum class ThreadToDo {
 };
 
 struct ThreadState {
-    ThreadStackPtr stack;
+    // Hot scheduling fields first so a state transition - read status and
+    // priority, take the lock - touches the leading cache line and leaves the
+    // cold bookkeeping below untouched.
+    SceUID id = 0;
     int priority;
-    int stack_size;
-    CPUStatePtr cpu;
     ThreadToDo to_do = ThreadToDo::run;
+    bool parked = false; // sitting in the run loop's wait state, see pause_all_threads
+    uint32_t zero_delay_count = 0; // consecutive zero-length delays, see sceKernelDelayThread
     std::mutex mutex;
     std::condition_variable something_to_do;
+
+    ThreadStackPtr stack;
+    int stack_size;
+    CPUStatePtr cpu;
+
+    // TLS slots as a flat array, so resolution on a path guest runtimes hit
+    // constantly (errno, locale) is two indexed loads. A zero entry means
+    // the slot has no storage yet.
+    std::array<Ptr<Ptr<void>>, TLS_SLOT_COUNT> tls = {};
+    // Callbacks notified but not yet run, guarded by mutex. Drained as one
+    // batch when this thread reaches a callback check point, so the context
+    // save/restore is paid once per check rather than once per callback.
+    std::vector<std::shared_ptr<Callback>> pending_callbacks;
     std::vector<std::shared_ptr<ThreadState>> waiting_threads;
+    // SceFiber: the fiber currently running on this thread (guest address
+    // of its SceFiber, 0 when in thread context), the thread context saved
+    // by sceFiberRun, and that call's argOnReturn pointer. Only the owning
+    // thread's own SVCs touch these, so they need no locking.
+    Address running_fiber = 0;
+    CPUContext fiber_caller_ctx;
+    Address fiber_caller_return = 0;
     std::string name;
 };
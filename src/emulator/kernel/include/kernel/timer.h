@@ -0,0 +1,61 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// One pending guest deadline. Heap-allocated so the expiry notification stays
+// valid even if the sleeper is woken spuriously and re-checks after the timer
+// worker has already dropped its reference.
+struct TimerWaiter {
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool expired = false;
+};
+typedef std::shared_ptr<TimerWaiter> TimerWaiterPtr;
+
+// Central deadline service. All guest sleeps park on one deadline-ordered map
+// owned by a single host worker, which sleeps until the earliest deadline and
+// wakes every expired thread in one pass instead of arming one host timer per
+// sleeping guest thread.
+struct TimerState {
+    std::mutex mutex;
+    std::condition_variable rescheduled;
+    std::multimap<std::chrono::steady_clock::time_point, TimerWaiterPtr> deadlines;
+    bool stop = false;
+    std::thread worker; // started on the first sleep
+
+    ~TimerState() {
+        if (worker.joinable()) {
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            rescheduled.notify_one();
+            worker.join();
+        }
+    }
+};
+
+// Blocks the calling host thread for the given guest delay.
+void timer_sleep(TimerState &timer, uint64_t microseconds);
@@ -57,11 +57,17 @@ namespace emu {
         SceUInt type; //!< 6 = user-mode PRX?
     };
 
-    // We only use workarea for uid
+    // The work area carries the fast-path lock state: an uncontended
+    // lock/unlock is a compare-exchange on owner in the calling thread's trap
+    // handler, and the kernel object only serves as the parking lot.
     struct SceKernelLwMutexWork {
         SceUID uid;
+        SceUID owner; // thread that holds the lock, 0 when free
+        std::int32_t lock_count; // only touched by the owner
+        std::int32_t waiters; // threads parked in the kernel
+        std::uint32_t attr;
 
-        std::uint8_t padding[28];
+        std::uint8_t padding[12];
     };
 
     // We only use workarea for uid
@@ -0,0 +1,188 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <kernel/functions.h>
+
+#include <kernel/state.h>
+#include <kernel/thread/thread_functions.h>
+
+#include <cpu/functions.h>
+#include <module/module.h>
+#include <util/lock_and_find.h>
+#include <util/object_pool.h>
+
+#include <psp2/kernel/error.h>
+
+#include <algorithm>
+#include <cstring>
+
+SceUID callback_create(KernelState &kernel, const char *export_name, SceUID thread_id, const char *name, SceUInt attr, Ptr<const void> entry, Ptr<void> common) {
+    if ((strlen(name) > 31) && ((attr & 0x80) == 0x80)) {
+        return RET_ERROR(SCE_KERNEL_ERROR_UID_NAME_TOO_LONG);
+    }
+
+    const CallbackPtr callback = make_pooled<Callback>(kernel.object_pool);
+    callback->thread_id = thread_id;
+    callback->entry = entry;
+    callback->common = common;
+    callback->attr = attr;
+    callback->notify_count = 0;
+    callback->notify_arg = 0;
+    std::copy(name, name + KERNELOBJECT_MAX_NAME_LENGTH, callback->name);
+
+    const std::lock_guard<std::shared_mutex> lock(kernel.mutex);
+    const SceUID uid = kernel.callbacks.alloc();
+    callback->uid = uid;
+    kernel.callbacks.set(uid, callback);
+
+    return uid;
+}
+
+int callback_delete(KernelState &kernel, const char *export_name, SceUID cbid) {
+    const CallbackPtr callback = lock_and_find(cbid, kernel.callbacks, kernel.mutex);
+    if (!callback) {
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_CALLBACK_ID);
+    }
+
+    // Drop any pending notification so the owning thread's next check does
+    // not run a deleted callback.
+    const ThreadStatePtr thread = lock_and_find(callback->thread_id, kernel.threads, kernel.mutex);
+    if (thread) {
+        const std::lock_guard<std::mutex> lock(thread->mutex);
+        const auto pending = std::find(thread->pending_callbacks.begin(), thread->pending_callbacks.end(), callback);
+        if (pending != thread->pending_callbacks.end()) {
+            thread->pending_callbacks.erase(pending);
+        }
+    }
+
+    const std::lock_guard<std::shared_mutex> lock(kernel.mutex);
+    kernel.callbacks.erase(cbid);
+
+    return SCE_KERNEL_OK;
+}
+
+int callback_notify(KernelState &kernel, const char *export_name, SceUID cbid, SceInt32 notify_arg) {
+    const CallbackPtr callback = lock_and_find(cbid, kernel.callbacks, kernel.mutex);
+    if (!callback) {
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_CALLBACK_ID);
+    }
+    const ThreadStatePtr thread = lock_and_find(callback->thread_id, kernel.threads, kernel.mutex);
+    if (!thread) {
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_THREAD_ID);
+    }
+
+    // Queue on the owning thread only - no wakeup, no context switch. The
+    // thread picks the whole batch up at its next check point.
+    const std::lock_guard<std::mutex> lock(thread->mutex);
+    if (callback->notify_count == 0) {
+        thread->pending_callbacks.push_back(callback);
+    }
+    ++callback->notify_count;
+    callback->notify_arg = notify_arg;
+
+    return SCE_KERNEL_OK;
+}
+
+int callback_cancel(KernelState &kernel, const char *export_name, SceUID cbid) {
+    const CallbackPtr callback = lock_and_find(cbid, kernel.callbacks, kernel.mutex);
+    if (!callback) {
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_CALLBACK_ID);
+    }
+    const ThreadStatePtr thread = lock_and_find(callback->thread_id, kernel.threads, kernel.mutex);
+    if (!thread) {
+        return SCE_KERNEL_OK;
+    }
+
+    const std::lock_guard<std::mutex> lock(thread->mutex);
+    callback->notify_count = 0;
+    callback->notify_arg = 0;
+    const auto pending = std::find(thread->pending_callbacks.begin(), thread->pending_callbacks.end(), callback);
+    if (pending != thread->pending_callbacks.end()) {
+        thread->pending_callbacks.erase(pending);
+    }
+
+    return SCE_KERNEL_OK;
+}
+
+int callback_count(KernelState &kernel, const char *export_name, SceUID cbid) {
+    const CallbackPtr callback = lock_and_find(cbid, kernel.callbacks, kernel.mutex);
+    if (!callback) {
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_CALLBACK_ID);
+    }
+    const ThreadStatePtr thread = lock_and_find(callback->thread_id, kernel.threads, kernel.mutex);
+    if (!thread) {
+        return callback->notify_count;
+    }
+
+    const std::lock_guard<std::mutex> lock(thread->mutex);
+    return callback->notify_count;
+}
+
+int deliver_pending_callbacks(KernelState &kernel, const char *export_name, SceUID thread_id) {
+    const ThreadStatePtr thread = lock_and_find(thread_id, kernel.threads, kernel.mutex);
+    if (!thread) {
+        return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_THREAD_ID);
+    }
+
+    std::unique_lock<std::mutex> lock(thread->mutex);
+    if (thread->pending_callbacks.empty()) {
+        return 0;
+    }
+
+    // Detach the batch so a handler that notifies again queues for the next
+    // check instead of extending this one.
+    std::vector<CallbackPtr> batch;
+    batch.swap(thread->pending_callbacks);
+
+    // One context save/restore brackets the whole batch - the cost of
+    // diverting the thread to run code out of line is paid once, however
+    // many notifications accumulated since the last check.
+    CPUContext context;
+    save_context(*thread->cpu, context);
+
+    int delivered = 0;
+    std::vector<SceUID> finished; // handlers that asked to be unregistered
+    for (const CallbackPtr &callback : batch) {
+        write_reg(*thread->cpu, 0, callback->uid);
+        write_reg(*thread->cpu, 1, callback->notify_count);
+        write_reg(*thread->cpu, 2, callback->notify_arg);
+        write_reg(*thread->cpu, 3, callback->common.address());
+        write_pc(*thread->cpu, callback->entry.address());
+        callback->notify_count = 0;
+        callback->notify_arg = 0;
+        lock.unlock();
+        run_thread(*thread, true);
+        lock.lock();
+        ++delivered;
+        // A nonzero return unregisters the callback, as on the real kernel.
+        if (read_reg(*thread->cpu, 0) != 0) {
+            finished.push_back(callback->uid);
+        }
+    }
+
+    load_context(*thread->cpu, context);
+    lock.unlock();
+
+    if (!finished.empty()) {
+        const std::lock_guard<std::shared_mutex> kernel_lock(kernel.mutex);
+        for (const SceUID uid : finished) {
+            kernel.callbacks.erase(uid);
+        }
+    }
+
+    return delivered;
+}
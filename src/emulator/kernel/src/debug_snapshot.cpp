@@ -0,0 +1,109 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <kernel/debug_snapshot.h>
+
+#include <kernel/state.h>
+#include <kernel/thread/thread_state.h>
+#include <util/resource.h>
+
+#include <shared_mutex>
+
+static const char *thread_state_label(ThreadToDo to_do) {
+    switch (to_do) {
+    case ThreadToDo::run:
+        return "Running";
+    case ThreadToDo::wait:
+        return "Waiting";
+    case ThreadToDo::exit:
+        return "Exiting";
+    }
+    return "Unknown";
+}
+
+static void capture_mutexes(std::vector<MutexSnapshotRow> &rows, const MutexPtrs &mutexes) {
+    for (const MutexPtrs::value_type &mutex : mutexes) {
+        MutexSnapshotRow row;
+        row.id = mutex.first;
+        row.name = mutex.second->name;
+        row.lock_count = mutex.second->lock_count;
+        row.attr = mutex.second->attr;
+        row.waiters = mutex.second->waiting_threads.size();
+        if (mutex.second->owner) {
+            row.owner = mutex.second->owner->name;
+        }
+        rows.push_back(std::move(row));
+    }
+}
+
+static void capture_condvars(std::vector<CondvarSnapshotRow> &rows, const CondvarPtrs &condvars) {
+    for (const CondvarPtrs::value_type &condvar : condvars) {
+        CondvarSnapshotRow row;
+        row.id = condvar.first;
+        row.name = condvar.second->name;
+        row.attr = condvar.second->attr;
+        row.waiters = condvar.second->waiting_threads.size();
+        rows.push_back(std::move(row));
+    }
+}
+
+void capture_debug_snapshot(KernelState &kernel, KernelDebugSnapshot &snapshot) {
+    snapshot.threads.clear();
+    snapshot.mutexes.clear();
+    snapshot.lwmutexes.clear();
+    snapshot.semaphores.clear();
+    snapshot.condvars.clear();
+    snapshot.lwcondvars.clear();
+    snapshot.eventflags.clear();
+
+    const std::shared_lock<std::shared_mutex> lock(kernel.mutex);
+
+    for (const ThreadStatePtrs::value_type &thread : kernel.threads) {
+        ThreadSnapshotRow row;
+        row.id = thread.first;
+        row.name = thread.second->name;
+        row.state = thread_state_label(thread.second->to_do);
+        row.stack = thread.second->stack ? thread.second->stack->get() : 0;
+        snapshot.threads.push_back(std::move(row));
+    }
+
+    capture_mutexes(snapshot.mutexes, kernel.mutexes);
+    capture_mutexes(snapshot.lwmutexes, kernel.lwmutexes);
+
+    for (const SemaphorePtrs::value_type &semaphore : kernel.semaphores) {
+        SemaphoreSnapshotRow row;
+        row.id = semaphore.first;
+        row.name = semaphore.second->name;
+        row.val = semaphore.second->val;
+        row.max = semaphore.second->max;
+        row.waiters = semaphore.second->waiting_threads.size();
+        snapshot.semaphores.push_back(std::move(row));
+    }
+
+    capture_condvars(snapshot.condvars, kernel.condvars);
+    capture_condvars(snapshot.lwcondvars, kernel.lwcondvars);
+
+    for (const EventFlagPtrs::value_type &event : kernel.eventflags) {
+        EventFlagSnapshotRow row;
+        row.id = event.first;
+        row.name = event.second->name;
+        row.flags = event.second->flags;
+        row.attr = event.second->attr;
+        row.waiters = event.second->waiting_threads.size();
+        snapshot.eventflags.push_back(std::move(row));
+    }
+}
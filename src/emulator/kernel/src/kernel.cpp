@@ -23,31 +23,137 @@
 #include <cpu/functions.h>
 #include <mem/mem.h>
 #include <mem/ptr.h>
+#include <util/lock_and_find.h>
+
+#include <algorithm>
+#include <chrono>
+
+void add_export(ExportNids &exports, uint32_t nid, Address entry) {
+    exports.pending.emplace_back(nid, entry);
+}
+
+Address find_export(ExportNids &exports, uint32_t nid) {
+    if (!exports.pending.empty()) {
+        // Stable order keeps the earliest registration of a duplicate NID
+        // first, where lower_bound will find it.
+        const auto by_nid = [](const ExportNids::value_type &lhs, const ExportNids::value_type &rhs) {
+            return lhs.first < rhs.first;
+        };
+        std::stable_sort(exports.pending.begin(), exports.pending.end(), by_nid);
+        const size_t merge_point = exports.sorted.size();
+        exports.sorted.insert(exports.sorted.end(), exports.pending.begin(), exports.pending.end());
+        std::inplace_merge(exports.sorted.begin(), exports.sorted.begin() + merge_point, exports.sorted.end(), by_nid);
+        exports.pending.clear();
+    }
+
+    const auto found = std::lower_bound(exports.sorted.begin(), exports.sorted.end(), nid, [](const ExportNids::value_type &lhs, uint32_t rhs) {
+        return lhs.first < rhs;
+    });
+    if ((found == exports.sorted.end()) || (found->first != nid)) {
+        return 0;
+    }
+
+    return found->second;
+}
 
 Ptr<Ptr<void>> get_thread_tls_addr(KernelState &kernel, MemState &mem, SceUID thread_id, int key) {
-    SlotToAddress &slot_to_address = kernel.tls[thread_id];
+    if ((key < 0) || (static_cast<size_t>(key) >= TLS_SLOT_COUNT)) {
+        return Ptr<Ptr<void>>();
+    }
+
+    const ThreadStatePtr thread = lock_and_find(thread_id, kernel.threads, kernel.mutex);
+    if (!thread) {
+        return Ptr<Ptr<void>>();
+    }
 
-    const SlotToAddress::const_iterator existing = slot_to_address.find(key);
-    if (existing != slot_to_address.end()) {
-        return existing->second;
+    // The flat array makes the hit path two indexed loads; the map below is
+    // only mirrored for debug views.
+    const Ptr<Ptr<void>> existing = thread->tls[key];
+    if (existing) {
+        return existing;
     }
 
     // TODO Use a finer-grained allocator.
     // TODO This is a memory leak.
     const Ptr<Ptr<void>> address(alloc<Ptr<void>>(mem, "TLS"));
-    slot_to_address.insert(SlotToAddress::value_type(key, address));
+    thread->tls[key] = address;
+    kernel.tls[thread_id][key] = address;
 
     return address;
 }
 
+void capture_thread_contexts(KernelState &kernel, ThreadContexts &contexts) {
+    const std::shared_lock<std::shared_mutex> lock(kernel.mutex);
+    for (const ThreadStatePtrs::value_type &thread : kernel.threads) {
+        const std::lock_guard<std::mutex> thread_lock(thread.second->mutex);
+        save_context(*thread.second->cpu, contexts[thread.first]);
+    }
+}
+
+void restore_thread_contexts(KernelState &kernel, const ThreadContexts &contexts) {
+    const std::shared_lock<std::shared_mutex> lock(kernel.mutex);
+    for (const ThreadContexts::value_type &context : contexts) {
+        const ThreadStatePtr thread = kernel.threads.find(context.first);
+        if (!thread) {
+            continue; // the thread exited after the capture
+        }
+        const std::lock_guard<std::mutex> thread_lock(thread->mutex);
+        load_context(*thread->cpu, context.second);
+    }
+}
+
+std::vector<SceUID> pause_all_threads(KernelState &kernel) {
+    std::vector<ThreadStatePtr> paused_threads;
+    std::vector<SceUID> paused_ids;
+    {
+        const std::shared_lock<std::shared_mutex> lock(kernel.mutex);
+        for (const ThreadStatePtrs::value_type &thread : kernel.threads) {
+            const std::lock_guard<std::mutex> thread_lock(thread.second->mutex);
+            if (thread.second->to_do == ThreadToDo::run) {
+                thread.second->to_do = ThreadToDo::wait;
+                stop(*thread.second->cpu);
+                paused_ids.push_back(thread.first);
+                paused_threads.push_back(thread.second);
+            }
+        }
+    }
+
+    // Wait for each to park in the run loop. A thread that is blocked in a
+    // host-side HLE wait will not park, but it is not running guest code
+    // either, so give up on it after a bounded wait.
+    for (const ThreadStatePtr &thread : paused_threads) {
+        std::unique_lock<std::mutex> thread_lock(thread->mutex);
+        thread->something_to_do.wait_for(thread_lock, std::chrono::milliseconds(100), [&thread]() { return thread->parked; });
+    }
+
+    return paused_ids;
+}
+
+void resume_threads(KernelState &kernel, const std::vector<SceUID> &thread_ids) {
+    const std::shared_lock<std::shared_mutex> lock(kernel.mutex);
+    for (const SceUID thread_id : thread_ids) {
+        const ThreadStatePtr thread = kernel.threads.find(thread_id);
+        if (!thread) {
+            continue;
+        }
+        {
+            const std::lock_guard<std::mutex> thread_lock(thread->mutex);
+            if (thread->to_do == ThreadToDo::wait) {
+                thread->to_do = ThreadToDo::run;
+            }
+        }
+        thread->something_to_do.notify_all();
+    }
+}
+
 void stop_all_threads(KernelState &kernel) {
-    const std::lock_guard<std::mutex> lock(kernel.mutex);
-    for (ThreadStatePtrs::iterator thread = kernel.threads.begin(); thread != kernel.threads.end(); ++thread) {
+    const std::shared_lock<std::shared_mutex> lock(kernel.mutex);
+    for (const ThreadStatePtrs::value_type &thread : kernel.threads) {
         {
-            const std::lock_guard<std::mutex> lock2(thread->second->mutex);
-            thread->second->to_do = ThreadToDo::exit;
+            const std::lock_guard<std::mutex> lock2(thread.second->mutex);
+            thread.second->to_do = ThreadToDo::exit;
         }
-        thread->second->something_to_do.notify_all();
-        stop(*thread->second->cpu);
+        thread.second->something_to_do.notify_all();
+        stop(*thread.second->cpu);
     }
 }
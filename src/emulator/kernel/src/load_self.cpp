@@ -15,13 +15,17 @@
 // with this program; if not, write to the Free Software Foundation, Inc.,
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
+#include <kernel/functions.h>
 #include <kernel/load_self.h>
 #include <kernel/relocation.h>
 #include <kernel/state.h>
 #include <kernel/types.h>
 
+#include <crypto/hash.h>
 #include <nids/functions.h>
+#include <util/boot_timeline.h>
 #include <util/log.h>
+#include <util/mapped_file.h>
 
 #include <elfio/elf_types.hpp>
 #define SCE_ELF_DEFS_TARGET
@@ -42,10 +46,16 @@
 
 #include <miniz.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cinttypes>
 #include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 using namespace ELFIO;
 
@@ -69,13 +79,13 @@ static bool load_var_imports(const uint32_t *nids, const Ptr<uint32_t> *entries,
             continue;
         }
 
-        const ExportNids::iterator export_address = kernel.export_nids.find(nid);
-        if (export_address == kernel.export_nids.end()) {
+        const Address export_address = find_export(kernel.export_nids, nid);
+        if (!export_address) {
             const char *const name = import_name(nid);
             LOG_ERROR("\tNID NOT FOUND {} ({}) at {}: {}", log_hex(nid), name, log_hex(entry.address()), log_hex(stub[0]));
             continue;
         }
-        uint32_t *const export_ptr = Ptr<uint32_t>(export_address->second).get(mem);
+        uint32_t *const export_ptr = Ptr<uint32_t>(export_address).get(mem);
         stub[0] = export_ptr[0];
     }
 
@@ -126,14 +136,25 @@ static bool load_func_imports(const uint32_t *nids, const Ptr<uint32_t> *entries
             LOG_DEBUG("\tNID {} ({}) at {}", log_hex(nid), name, log_hex(entry.address()));
         }
 
-        const ExportNids::iterator export_address = kernel.export_nids.find(nid);
-        if (export_address == kernel.export_nids.end()) {
+        const Address export_address = find_export(kernel.export_nids, nid);
+        if (!export_address) {
+            // Hand the stub a slot number in the svc immediate so the
+            // interrupt hook can dispatch by index instead of re-reading the
+            // NID word from guest memory on every call.
+            uint32_t slot = 0;
+            {
+                const std::lock_guard<std::shared_mutex> lock(kernel.mutex);
+                kernel.import_nid_slots.push_back(nid);
+                slot = static_cast<uint32_t>(kernel.import_nid_slots.size());
+            }
+            assert(slot <= 0xffffff);
+
             uint32_t *const stub = entry.get(mem);
-            stub[0] = 0xef000000; // svc #0 - Call our interrupt hook.
+            stub[0] = 0xef000000 | slot; // svc #slot - Call our interrupt hook.
             stub[1] = 0xe1a0f00e; // mov pc, lr - Return to the caller.
-            stub[2] = nid; // Our interrupt hook will read this.
+            stub[2] = nid; // Kept for the svc #0 fallback and for debugging.
         } else {
-            Address func_address = export_address->second;
+            Address func_address = export_address;
             uint32_t *const stub = entry.get(mem);
             stub[0] = encode_arm_inst(INSTRUCTION_MOVW, (uint16_t)func_address, 12);
             stub[1] = encode_arm_inst(INSTRUCTION_MOVT, (uint16_t)(func_address >> 16), 12);
@@ -186,7 +207,7 @@ static bool load_func_exports(Ptr<const void> &entry_point, const uint32_t *nids
         if (nid == NID_MODULE_STOP || nid == NID_MODULE_EXIT)
             continue;
 
-        kernel.export_nids.emplace(nid, entry.address());
+        add_export(kernel.export_nids, nid, entry.address());
 
         if (LOG_EXPORTS) {
             const char *const name = import_name(nid);
@@ -225,7 +246,7 @@ static bool load_var_exports(Ptr<const void> &entry_point, const uint32_t *nids,
             LOG_DEBUG("\tNID {} ({}) at {}", log_hex(nid), name, log_hex(entry.address()));
         }
 
-        kernel.export_nids.emplace(nid, entry.address());
+        add_export(kernel.export_nids, nid, entry.address());
     }
 
     return true;
@@ -257,27 +278,46 @@ static bool load_exports(Ptr<const void> &entry_point, const sce_module_info_raw
     return true;
 }
 
-SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &mem, const void *self, const char *path) {
-    const uint8_t *const self_bytes = static_cast<const uint8_t *>(self);
-    const SCE_header &self_header = *static_cast<const SCE_header *>(self);
-
-    // assumes little endian host
-    if (!memcmp(&self_header.magic, "\0ECS", 4)) {
-        LOG_CRITICAL("(S)ELF is corrupt or encrypted. Decryption not yet supported.");
-        return -1;
+// Compressed payloads are read sequentially (the source view need not be
+// thread-safe) but inflated on worker threads - each segment targets a
+// disjoint destination, so the inflates are independent. Relocations are
+// applied only after every load segment has finished, because SCE
+// relocations read their addends in place from the loaded segments.
+static bool inflate_segment_async(uint8_t *dst, unsigned long dest_bytes, const segment_info &info, const SelfReadFn &read_at, std::vector<std::thread> &inflaters, std::atomic<bool> &failed) {
+    std::vector<uint8_t> compressed(info.length);
+    if (!read_at(compressed.data(), compressed.size(), info.offset)) {
+        return false;
     }
 
-    const uint8_t *const elf_bytes = self_bytes + self_header.elf_offset;
-    const Elf32_Ehdr &elf = *reinterpret_cast<const Elf32_Ehdr *>(elf_bytes);
-    const uint32_t module_info_offset = elf.e_entry & 0x3fffffff;
-    const Elf32_Phdr *const segments = reinterpret_cast<const Elf32_Phdr *>(self_bytes + self_header.phdr_offset);
+    inflaters.emplace_back([dst, dest_bytes, compressed = std::move(compressed), &failed]() mutable {
+        unsigned long actual_bytes = dest_bytes;
+        const int res = mz_uncompress(dst, &actual_bytes, compressed.data(), static_cast<unsigned long>(compressed.size()));
+        assert(res == MZ_OK);
+        if (res != MZ_OK) {
+            failed = true;
+        }
+    });
 
-    const segment_info *const segment_infos = reinterpret_cast<const segment_info *>(self_bytes + self_header.section_info_offset);
+    return true;
+}
+
+// The cold path: allocate, inflate and relocate every segment from the
+// (S)ELF source.
+static bool load_segments(SegmentAddresses &segment_addrs, MemState &mem, const Elf32_Ehdr &elf, const std::vector<Elf32_Phdr> &segments, const std::vector<segment_info> &segment_infos, const SCE_header &self_header, const SelfReadFn &read_at, const char *path) {
+    std::vector<std::thread> inflaters;
+    std::atomic<bool> inflate_failed{ false };
+    std::vector<std::vector<uint8_t>> pending_relocations;
+
+    const auto join_inflaters = [&inflaters]() {
+        for (std::thread &inflater : inflaters) {
+            inflater.join();
+        }
+        inflaters.clear();
+    };
 
-    SegmentAddresses segment_addrs;
     for (Elf_Half segment_index = 0; segment_index < elf.e_phnum; ++segment_index) {
         const Elf32_Phdr &src = segments[segment_index];
-        const uint8_t *const segment_bytes = self_bytes + self_header.header_len + src.p_offset;
+        const uint64_t segment_offset = static_cast<uint64_t>(self_header.header_len) + src.p_offset;
 
         assert(segment_infos[segment_index].encryption == 2);
         if (src.p_type == PT_LOAD) {
@@ -290,36 +330,254 @@ SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &me
             const Ptr<void> address(segment_address);
             if (!address) {
                 LOG_ERROR("Failed to allocate memory for segment.");
-                return -1;
+                join_inflaters();
+                return false;
             }
 
+            // The payload lands straight in its guest destination - the
+            // source never has to be resident in full.
+            uint8_t *const dst = reinterpret_cast<uint8_t *>(address.get(mem));
             if (segment_infos[segment_index].compression == 2) {
-                unsigned long dest_bytes = src.p_filesz;
-                const uint8_t *const compressed_segment_bytes = self_bytes + segment_infos[segment_index].offset;
-
-                int res = mz_uncompress(reinterpret_cast<uint8_t *>(address.get(mem)), &dest_bytes, compressed_segment_bytes, segment_infos[segment_index].length);
-                assert(res == MZ_OK);
+                if (!inflate_segment_async(dst, src.p_filesz, segment_infos[segment_index], read_at, inflaters, inflate_failed)) {
+                    join_inflaters();
+                    return false;
+                }
             } else {
-                memcpy(address.get(mem), segment_bytes, src.p_filesz);
+                if (!read_at(dst, src.p_filesz, segment_offset)) {
+                    join_inflaters();
+                    return false;
+                }
             }
 
             segment_addrs[segment_index] = address;
         } else if (src.p_type == PT_LOOS) {
+            std::vector<uint8_t> entries(src.p_filesz);
             if (segment_infos[segment_index].compression == 2) {
-                unsigned long dest_bytes = src.p_filesz;
-                const uint8_t *const compressed_segment_bytes = self_bytes + segment_infos[segment_index].offset;
-                std::unique_ptr<uint8_t> uncompressed(new uint8_t[dest_bytes]);
-
-                int res = mz_uncompress(uncompressed.get(), &dest_bytes, compressed_segment_bytes, segment_infos[segment_index].length);
-                assert(res == MZ_OK);
-                if (!relocate(uncompressed.get(), src.p_filesz, segment_addrs, mem)) {
-                    return -1;
+                if (!inflate_segment_async(entries.data(), src.p_filesz, segment_infos[segment_index], read_at, inflaters, inflate_failed)) {
+                    join_inflaters();
+                    return false;
                 }
             } else {
-                if (!relocate(segment_bytes, src.p_filesz, segment_addrs, mem)) {
-                    return -1;
+                if (!read_at(entries.data(), entries.size(), segment_offset)) {
+                    join_inflaters();
+                    return false;
                 }
             }
+            pending_relocations.push_back(std::move(entries));
+        }
+    }
+
+    join_inflaters();
+    if (inflate_failed) {
+        return false;
+    }
+
+    for (const std::vector<uint8_t> &entries : pending_relocations) {
+        if (!relocate(entries.data(), entries.size(), segment_addrs, mem)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// A cached module image holds every PT_LOAD segment exactly as it sits in
+// guest memory after inflation and relocation, so a warm boot is a straight
+// copy. The image is only valid at the bases it was relocated for, so the
+// warm path makes the same allocation calls as the normal path and bails if
+// any of them lands elsewhere - a deterministic boot sequence makes that
+// rare, and any mismatch just falls through to a full load.
+static constexpr uint32_t IMAGE_CACHE_MAGIC = 0x43494D56; // "VMIC"
+static constexpr uint32_t IMAGE_CACHE_VERSION = 1;
+
+static std::string image_cache_file(const char *cache_dir, uint64_t key) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016" PRIx64 ".img", key);
+    return std::string(cache_dir) + "/" + name;
+}
+
+static bool load_cached_image(SegmentAddresses &segment_addrs, MemState &mem, const Elf32_Ehdr &elf, const std::vector<Elf32_Phdr> &segments, const std::string &file, const char *path) {
+    // Mapped shared read-only so instances booting the same title read the
+    // image out of one physical copy; the copy into guest memory is still
+    // private, but the source pages are not duplicated per instance.
+    MappedFile cache;
+    if (!cache.open(file)) {
+        return false;
+    }
+
+    uint64_t cursor = 0;
+    const auto read = [&cache, &cursor](void *dst, size_t size) {
+        if (cursor + size > cache.size()) {
+            return false;
+        }
+        memcpy(dst, cache.data() + cursor, size);
+        cursor += size;
+        return true;
+    };
+
+    // Undo every allocation the attempt made so the normal path starts from
+    // the same allocator state it would have seen on a cache miss.
+    const auto bail = [&segment_addrs, &mem]() {
+        for (const SegmentAddresses::value_type &segment : segment_addrs) {
+            free(mem, segment.second.address());
+        }
+        segment_addrs.clear();
+        return false;
+    };
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t count = 0;
+    if (!read(&magic, sizeof(magic)) || !read(&version, sizeof(version)) || !read(&count, sizeof(count))) {
+        return false;
+    }
+    if ((magic != IMAGE_CACHE_MAGIC) || (version != IMAGE_CACHE_VERSION)) {
+        return false;
+    }
+
+    uint32_t load_segment_count = 0;
+    for (const Elf32_Phdr &segment : segments) {
+        if (segment.p_type == PT_LOAD) {
+            ++load_segment_count;
+        }
+    }
+    if (count != load_segment_count) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t segment_index = 0;
+        Address base = 0;
+        uint32_t filesz = 0;
+        if (!read(&segment_index, sizeof(segment_index)) || !read(&base, sizeof(base)) || !read(&filesz, sizeof(filesz))) {
+            return bail();
+        }
+        if ((segment_index >= segments.size()) || (segments[segment_index].p_type != PT_LOAD) || (filesz > segments[segment_index].p_memsz)) {
+            return bail();
+        }
+
+        Address segment_address = 0;
+        if (elf.e_type == ET_SCE_EXEC) {
+            segment_address = alloc_at(mem, segments[segment_index].p_vaddr, segments[segment_index].p_memsz, path);
+        } else {
+            segment_address = alloc(mem, segments[segment_index].p_memsz, path);
+        }
+        if (!segment_address) {
+            return bail();
+        }
+        segment_addrs[segment_index] = Ptr<void>(segment_address);
+
+        if (segment_address != base) {
+            return bail();
+        }
+        if (!read(Ptr<uint8_t>(segment_address).get(mem), filesz)) {
+            return bail();
+        }
+    }
+
+    return true;
+}
+
+static void save_cached_image(const SegmentAddresses &segment_addrs, const MemState &mem, const std::vector<Elf32_Phdr> &segments, const std::string &file) {
+    // Best effort - a failed write just means the next boot loads cold.
+    std::ofstream cache(file, std::ofstream::binary | std::ofstream::trunc);
+    if (cache.fail()) {
+        return;
+    }
+
+    const auto write = [&cache](const void *data, size_t size) {
+        cache.write(static_cast<const char *>(data), size);
+    };
+
+    const uint32_t count = static_cast<uint32_t>(segment_addrs.size());
+    write(&IMAGE_CACHE_MAGIC, sizeof(IMAGE_CACHE_MAGIC));
+    write(&IMAGE_CACHE_VERSION, sizeof(IMAGE_CACHE_VERSION));
+    write(&count, sizeof(count));
+
+    for (const SegmentAddresses::value_type &segment : segment_addrs) {
+        const uint32_t segment_index = static_cast<uint32_t>(segment.first);
+        const Address base = segment.second.address();
+        const uint32_t filesz = segments[segment_index].p_filesz;
+        write(&segment_index, sizeof(segment_index));
+        write(&base, sizeof(base));
+        write(&filesz, sizeof(filesz));
+        write(segment.second.cast<const uint8_t>().get(mem), filesz);
+    }
+}
+
+SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &mem, const SelfReadFn &read_at, const char *path, const char *cache_dir) {
+    BootSlice load_slice(std::string("load_self ") + path);
+
+    SCE_header self_header;
+    if (!read_at(&self_header, sizeof(self_header), 0)) {
+        LOG_CRITICAL("Failed to read (S)ELF header.");
+        return -1;
+    }
+
+    // assumes little endian host
+    if (!memcmp(&self_header.magic, "\0ECS", 4)) {
+        LOG_CRITICAL("(S)ELF is corrupt or encrypted. Decryption not yet supported.");
+        return -1;
+    }
+
+    Elf32_Ehdr elf;
+    if (!read_at(&elf, sizeof(elf), self_header.elf_offset)) {
+        return -1;
+    }
+    const uint32_t module_info_offset = elf.e_entry & 0x3fffffff;
+
+    std::vector<Elf32_Phdr> segments(elf.e_phnum);
+    if (!read_at(segments.data(), segments.size() * sizeof(Elf32_Phdr), self_header.phdr_offset)) {
+        return -1;
+    }
+
+    std::vector<segment_info> segment_infos(elf.e_phnum);
+    if (!read_at(segment_infos.data(), segment_infos.size() * sizeof(segment_info), self_header.section_info_offset)) {
+        return -1;
+    }
+
+    std::string cache_file;
+    if (cache_dir) {
+        // Key on everything the loader reads before the segment data - the
+        // header tables pin down offsets, sizes and load addresses, and the
+        // compressed segment lengths vary with content - plus a sample of
+        // the first segment's bytes to catch a rebuild with an identical
+        // layout.
+        std::vector<uint8_t> identity;
+        const auto append = [&identity](const void *data, size_t size) {
+            const uint8_t *const bytes = static_cast<const uint8_t *>(data);
+            identity.insert(identity.end(), bytes, bytes + size);
+        };
+        append(&self_header, sizeof(self_header));
+        append(&elf, sizeof(elf));
+        append(segments.data(), segments.size() * sizeof(Elf32_Phdr));
+        append(segment_infos.data(), segment_infos.size() * sizeof(segment_info));
+        if (!segment_infos.empty() && (segment_infos.front().length > 0)) {
+            std::vector<uint8_t> sample(std::min<uint64_t>(segment_infos.front().length, 4096));
+            if (read_at(sample.data(), sample.size(), segment_infos.front().offset)) {
+                append(sample.data(), sample.size());
+            }
+        }
+        cache_file = image_cache_file(cache_dir, hash64(identity.data(), identity.size()));
+    }
+
+    for (const Elf32_Phdr &segment : segments) {
+        if (segment.p_type == PT_LOAD) {
+            load_slice.bytes += segment.p_filesz;
+        }
+    }
+
+    SegmentAddresses segment_addrs;
+    const uint64_t segments_start_us = boot_timeline_now_us();
+    if (!cache_file.empty() && load_cached_image(segment_addrs, mem, elf, segments, cache_file, path)) {
+        add_boot_slice(std::string("cached image ") + path, segments_start_us, boot_timeline_now_us() - segments_start_us, load_slice.bytes);
+        LOG_INFO("Loaded pre-relocated image of {} from cache.", path);
+    } else if (!load_segments(segment_addrs, mem, elf, segments, segment_infos, self_header, read_at, path)) {
+        return -1;
+    } else {
+        add_boot_slice(std::string("cold segments ") + path, segments_start_us, boot_timeline_now_us() - segments_start_us, load_slice.bytes);
+        if (!cache_file.empty()) {
+            save_cached_image(segment_addrs, mem, segments, cache_file);
         }
     }
 
@@ -372,10 +630,20 @@ SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &me
 
     sceKernelModuleInfo->module_start = entry_point;
 
-    const std::lock_guard<std::mutex> lock(kernel.mutex);
+    const std::lock_guard<std::shared_mutex> lock(kernel.mutex);
     const SceUID uid = kernel.get_next_uid();
     sceKernelModuleInfo->handle = uid;
     kernel.loaded_modules.emplace(uid, sceKernelModuleInfo);
 
     return uid;
 }
+
+SceUID load_self(Ptr<const void> &entry_point, KernelState &kernel, MemState &mem, const void *self, const char *path, const char *cache_dir) {
+    const uint8_t *const self_bytes = static_cast<const uint8_t *>(self);
+    const SelfReadFn read_at = [self_bytes](void *dst, size_t size, uint64_t offset) {
+        memcpy(dst, self_bytes + offset, size);
+        return true;
+    };
+
+    return load_self(entry_point, kernel, mem, read_at, path, cache_dir);
+}
@@ -0,0 +1,162 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <kernel/profiler.h>
+
+#include <kernel/state.h>
+#include <kernel/thread/thread_state.h>
+
+#include <cpu/functions.h>
+#include <nids/functions.h>
+#include <util/log.h>
+
+#include <algorithm>
+#include <chrono>
+
+static constexpr std::chrono::microseconds SAMPLE_INTERVAL(1000);
+
+// Map a sampled PC to the start address of the nearest known export at or
+// below it. Returns the PC itself when nothing is known, so unsymbolized
+// code still shows up (per address) rather than vanishing.
+static Address attribute_sample(const std::map<Address, uint32_t> &functions_by_address, Address pc) {
+    if (functions_by_address.empty()) {
+        return pc;
+    }
+
+    std::map<Address, uint32_t>::const_iterator above = functions_by_address.upper_bound(pc);
+    if (above == functions_by_address.begin()) {
+        return pc;
+    }
+
+    return std::prev(above)->first;
+}
+
+static void profiler_worker(KernelState &kernel) {
+    SamplingProfiler &profiler = kernel.profiler;
+
+    while (profiler.running) {
+        std::this_thread::sleep_for(SAMPLE_INTERVAL);
+
+        // Reverse the NID -> address export table once per pass - modules can
+        // still be loaded while the profiler runs.
+        std::map<Address, uint32_t> functions_by_address;
+        std::vector<ThreadStatePtr> threads;
+        {
+            const std::shared_lock<std::shared_mutex> lock(kernel.mutex);
+            // Walk both blocks directly rather than probing - flushing the
+            // pending block would be a write under a read lock.
+            for (const ExportNids::value_type &entry : kernel.export_nids.sorted) {
+                functions_by_address.emplace(entry.second & 0xfffffffe, entry.first);
+            }
+            for (const ExportNids::value_type &entry : kernel.export_nids.pending) {
+                functions_by_address.emplace(entry.second & 0xfffffffe, entry.first);
+            }
+            for (const ThreadStatePtrs::value_type &entry : kernel.threads) {
+                threads.push_back(entry.second);
+            }
+        }
+
+        for (const ThreadStatePtr &thread : threads) {
+            if (thread->to_do != ThreadToDo::run) {
+                continue;
+            }
+
+            // Best-effort read - the register file is sampled while the
+            // engine is executing, which is fine for statistical profiling.
+            const Address pc = read_pc(*thread->cpu);
+            if (pc == 0) {
+                continue;
+            }
+
+            const Address function = attribute_sample(functions_by_address, pc);
+            const std::lock_guard<std::mutex> lock(profiler.mutex);
+            ++profiler.samples[function];
+            ++profiler.total_samples;
+        }
+    }
+}
+
+void start_sampling_profiler(KernelState &kernel) {
+    SamplingProfiler &profiler = kernel.profiler;
+    if (profiler.running) {
+        return;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(profiler.mutex);
+        profiler.samples.clear();
+        profiler.total_samples = 0;
+    }
+
+    profiler.running = true;
+    profiler.worker = std::thread(profiler_worker, std::ref(kernel));
+}
+
+void stop_sampling_profiler(KernelState &kernel) {
+    SamplingProfiler &profiler = kernel.profiler;
+    if (!profiler.running) {
+        return;
+    }
+
+    profiler.running = false;
+    profiler.worker.join();
+}
+
+std::vector<ProfilerHotFunction> profiler_hot_functions(KernelState &kernel, size_t max_functions) {
+    SamplingProfiler &profiler = kernel.profiler;
+
+    std::vector<ProfilerHotFunction> report;
+    {
+        const std::lock_guard<std::mutex> lock(profiler.mutex);
+        report.reserve(profiler.samples.size());
+        for (const std::map<Address, uint64_t>::value_type &entry : profiler.samples) {
+            ProfilerHotFunction function;
+            function.address = entry.first;
+            function.samples = entry.second;
+            report.push_back(function);
+        }
+    }
+
+    std::sort(report.begin(), report.end(), [](const ProfilerHotFunction &lhs, const ProfilerHotFunction &rhs) {
+        return lhs.samples > rhs.samples;
+    });
+    if (report.size() > max_functions) {
+        report.resize(max_functions);
+    }
+
+    // Symbolize the survivors only.
+    std::map<Address, uint32_t> functions_by_address;
+    {
+        const std::shared_lock<std::shared_mutex> lock(kernel.mutex);
+        for (const ExportNids::value_type &entry : kernel.export_nids.sorted) {
+            functions_by_address.emplace(entry.second & 0xfffffffe, entry.first);
+        }
+        for (const ExportNids::value_type &entry : kernel.export_nids.pending) {
+            functions_by_address.emplace(entry.second & 0xfffffffe, entry.first);
+        }
+    }
+    for (ProfilerHotFunction &function : report) {
+        const std::map<Address, uint32_t>::const_iterator found = functions_by_address.find(function.address);
+        if (found != functions_by_address.end()) {
+            function.name = import_name(found->second);
+        } else {
+            function.name = "<unknown>";
+        }
+    }
+
+    return report;
+}
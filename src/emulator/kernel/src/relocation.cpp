@@ -18,9 +18,11 @@
 #include <kernel/relocation.h>
 #include <util/log.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
+#include <vector>
 
 enum Code {
     None = 0,
@@ -198,7 +200,20 @@ static bool relocate(void *data, Code code, uint32_t s, uint32_t a, uint32_t p)
     return true;
 }
 
+// One relocation, fully decoded: everything the apply pass needs with no
+// further table parsing or segment lookups.
+struct DecodedReloc {
+    Address p;
+    uint32_t s;
+    uint32_t a;
+    uint8_t code;
+};
+
 bool relocate(const void *entries, size_t size, const SegmentAddresses &segments, const MemState &mem) {
+    // Pass 1: decode the variable-length table into a flat array.
+    std::vector<DecodedReloc> decoded;
+    decoded.reserve(size / sizeof(ShortEntry));
+
     const void *const end = static_cast<const uint8_t *>(entries) + size;
     const Entry *entry = static_cast<const Entry *>(entries);
     while (entry < end) {
@@ -210,31 +225,40 @@ bool relocate(const void *entries, size_t size, const SegmentAddresses &segments
             const Ptr<void> segment_start = segments.find(short_entry->data_segment)->second;
             const Address offset = short_entry->offset_lo | (short_entry->offset_hi << 12);
             const Address p = segment_start.address() + offset;
-            const Address a = short_entry->addend;
-            if (!relocate(Ptr<uint32_t>(p).get(mem), static_cast<Code>(entry->code), s, a, p)) {
-                return false;
-            }
+
+            decoded.push_back({ p, s, short_entry->addend, entry->code });
 
             entry = short_entry + 1;
         } else {
             const LongEntry *const long_entry = static_cast<const LongEntry *>(entry);
-
             const Ptr<void> segment_start = segments.find(long_entry->data_segment)->second;
             const Address p = segment_start.address() + long_entry->offset;
-            const Address a = long_entry->addend;
-            if (!relocate(Ptr<uint32_t>(p).get(mem), static_cast<Code>(entry->code), s, a, p)) {
-                return false;
-            }
 
+            decoded.push_back({ p, s, long_entry->addend, entry->code });
             if (long_entry->code2 != 0) {
-                if (!relocate(Ptr<uint32_t>(p + (long_entry->dist2 * 2)).get(mem), static_cast<Code>(long_entry->code2), s, a, p)) {
-                    return false;
-                }
+                decoded.push_back({ p + (long_entry->dist2 * 2), s, long_entry->addend, long_entry->code2 });
             }
 
             entry = long_entry + 1;
         }
     }
 
+    // Pass 2: apply grouped by code. Entries are independent - each fully
+    // specifies s, a and p, and every writer only touches its own bits of
+    // its own word - so reordering is safe. Within each run the per-entry
+    // switch is perfectly predicted, which is the effect of one tight loop
+    // per type without thirteen copies of the loop.
+    std::stable_sort(decoded.begin(), decoded.end(), [](const DecodedReloc &lhs, const DecodedReloc &rhs) {
+        return lhs.code < rhs.code;
+    });
+
+    for (const DecodedReloc &reloc : decoded) {
+        if (!relocate(Ptr<uint32_t>(reloc.p).get(mem), static_cast<Code>(reloc.code), reloc.s, reloc.a, reloc.p)) {
+            return false;
+        }
+    }
+
+    LOG_DEBUG("Applied {} relocations from a {} byte table.", decoded.size(), size);
+
     return true;
 }
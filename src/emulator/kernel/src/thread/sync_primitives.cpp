@@ -26,7 +26,9 @@
 #include <kernel/types.h>
 #include <module/module.h>
 #include <util/lock_and_find.h>
+#include <util/object_pool.h>
 #include <util/log.h>
+#include <util/trace.h>
 
 static constexpr bool LOG_SYNC_PRIMITIVES = false;
 
@@ -54,7 +56,7 @@ inline CondvarPtrs &get_condvars(KernelState &kernel, SyncWeight weight) {
     return weight == SyncWeight::Light ? kernel.lwcondvars : kernel.condvars;
 }
 
-inline int find_mutex(MutexPtr &mutex_out, MutexPtrs *mutexes_out, KernelState &kernel, const char *export_name, SceUID mutexid, SyncWeight weight) {
+inline int find_mutex(MutexPtr &mutex_out, MutexPtrs **mutexes_out, KernelState &kernel, const char *export_name, SceUID mutexid, SyncWeight weight) {
     MutexPtrs &mutexes = get_mutexes(kernel, weight);
     mutex_out = lock_and_find(mutexid, mutexes, kernel.mutex);
     if (!mutex_out) {
@@ -65,15 +67,47 @@ inline int find_mutex(MutexPtr &mutex_out, MutexPtrs *mutexes_out, KernelState &
     }
 
     if (mutexes_out)
-        *mutexes_out = mutexes;
+        *mutexes_out = &mutexes;
     return SCE_KERNEL_OK;
 }
 
+// The primitive and the calling thread sit in different tables behind the
+// same kernel lock; one shared acquisition serves both lookups, so an
+// operation touches the global lock once instead of twice.
+template <typename T>
+inline std::shared_ptr<T> find_primitive_and_thread(ThreadStatePtr &thread_out, KernelState &kernel, const UIDTable<T> &primitives, SceUID primitive_id, SceUID thread_id) {
+    const std::shared_lock<std::shared_mutex> lock(kernel.mutex);
+    thread_out = find(thread_id, kernel.threads);
+    return find(primitive_id, primitives);
+}
+
+// Contention sampling - a few increments under locks the callers already
+// hold, cheap enough to keep always on. Hold times are only tracked where
+// the kernel sees both the acquire and the release, so the lightweight
+// mutex fast path (which never traps) stays invisible by design.
+inline void stat_blocked(SyncStats &stats, size_t waiters) {
+    ++stats.contentions;
+    if (waiters > stats.max_waiters)
+        stats.max_waiters = waiters;
+}
+
+inline void stat_mutex_acquired(SyncStats &stats) {
+    ++stats.acquisitions;
+    stats.acquired_at = std::chrono::steady_clock::now();
+}
+
+inline void stat_mutex_released(SyncStats &stats) {
+    const uint64_t held_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - stats.acquired_at).count();
+    stats.total_hold_us += held_us;
+    if (held_us > stats.max_hold_us)
+        stats.max_hold_us = held_us;
+}
+
 // *********
 // * Mutex *
 // *********
 
-SceUID mutex_create(SceUID *uid_out, KernelState &kernel, const char *export_name, SceUID thread_id, const char *mutex_name, SceUInt attr, int init_count, SyncWeight weight) {
+SceUID mutex_create(SceUID *uid_out, KernelState &kernel, const char *export_name, SceUID thread_id, const char *mutex_name, SceUInt attr, int init_count, emu::SceKernelLwMutexWork *workarea, SyncWeight weight) {
     if ((strlen(mutex_name) > 31) && ((attr & 0x80) == 0x80)) {
         return RET_ERROR(SCE_KERNEL_ERROR_UID_NAME_TOO_LONG);
     }
@@ -84,9 +118,7 @@ SceUID mutex_create(SceUID *uid_out, KernelState &kernel, const char *export_nam
         return RET_ERROR(SCE_KERNEL_ERROR_ILLEGAL_COUNT);
     }
 
-    const MutexPtr mutex = std::make_shared<Mutex>();
-    const SceUID uid = kernel.get_next_uid();
-    mutex->uid = uid;
+    const MutexPtr mutex = make_pooled<Mutex>(kernel.object_pool);
     mutex->lock_count = init_count;
     std::copy(mutex_name, mutex_name + KERNELOBJECT_MAX_NAME_LENGTH, mutex->name);
     mutex->attr = attr;
@@ -96,9 +128,21 @@ SceUID mutex_create(SceUID *uid_out, KernelState &kernel, const char *export_nam
         mutex->owner = thread;
     }
 
-    const std::lock_guard<std::mutex> lock(kernel.mutex);
+    if (workarea) {
+        // Lightweight mutexes keep their lock state in the guest work area;
+        // the kernel object only parks contended waiters.
+        mutex->workarea = workarea;
+        workarea->owner = (init_count > 0) ? thread_id : 0;
+        workarea->lock_count = init_count;
+        workarea->waiters = 0;
+        workarea->attr = attr;
+    }
+
+    const std::lock_guard<std::shared_mutex> lock(kernel.mutex);
     auto &mutexes = get_mutexes(kernel, weight);
-    mutexes.emplace(uid, mutex);
+    const SceUID uid = mutexes.alloc();
+    mutex->uid = uid;
+    mutexes.set(uid, mutex);
 
     if (LOG_SYNC_PRIMITIVES) {
         LOG_DEBUG("{}: uid:{} thread_id:{} name:\"{}\" attr:{} init_count:{}",
@@ -112,7 +156,7 @@ SceUID mutex_create(SceUID *uid_out, KernelState &kernel, const char *export_nam
     return SCE_KERNEL_OK;
 }
 
-inline int mutex_lock_impl(KernelState &kernel, const char *export_name, SceUID thread_id, int lock_count, MutexPtr mutex) {
+inline int mutex_lock_impl(const char *export_name, SceUID thread_id, const ThreadStatePtr &thread, int lock_count, MutexPtr mutex) {
     if (LOG_SYNC_PRIMITIVES) {
         LOG_DEBUG("{}: uid:{} thread_id:{} name:\"{}\" attr:{} lock_count:{}",
             export_name, mutex->uid, thread_id, mutex->name, mutex->attr, mutex->lock_count);
@@ -120,8 +164,6 @@ inline int mutex_lock_impl(KernelState &kernel, const char *export_name, SceUID
 
     const std::lock_guard<std::mutex> lock(mutex->mutex);
 
-    const ThreadStatePtr thread = lock_and_find(thread_id, kernel.threads, kernel.mutex);
-
     bool is_recursive = (mutex->attr & SCE_KERNEL_MUTEX_ATTR_RECURSIVE);
     bool is_fifo = (mutex->attr & SCE_KERNEL_ATTR_TH_FIFO);
 
@@ -133,6 +175,7 @@ inline int mutex_lock_impl(KernelState &kernel, const char *export_name, SceUID
 
             if (is_recursive) {
                 mutex->lock_count += lock_count;
+                ++mutex->stats.acquisitions;
                 return SCE_KERNEL_OK;
             } else {
                 return SCE_KERNEL_ERROR_LW_MUTEX_RECURSIVE;
@@ -151,6 +194,7 @@ inline int mutex_lock_impl(KernelState &kernel, const char *export_name, SceUID
             data.priority = is_fifo ? 0 : thread->priority;
 
             mutex->waiting_threads.emplace(data);
+            stat_blocked(mutex->stats, mutex->waiting_threads.size());
             stop(*thread->cpu);
         }
     } else {
@@ -159,25 +203,27 @@ inline int mutex_lock_impl(KernelState &kernel, const char *export_name, SceUID
 
         mutex->lock_count += lock_count;
         mutex->owner = thread;
+        stat_mutex_acquired(mutex->stats);
     }
 
     return SCE_KERNEL_OK;
 }
 
 int mutex_lock(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, int lock_count, unsigned int *timeout, SyncWeight weight) {
+    const TraceScope trace("mutex_lock");
     assert(!timeout);
 
-    MutexPtr mutex;
-    if (auto error = find_mutex(mutex, nullptr, kernel, export_name, mutexid, weight))
-        return error;
+    ThreadStatePtr thread;
+    const MutexPtr mutex = find_primitive_and_thread(thread, kernel, get_mutexes(kernel, weight), mutexid, thread_id);
+    if (!mutex)
+        return unknown_mutex_id(export_name, weight);
 
-    return mutex_lock_impl(kernel, export_name, thread_id, lock_count, mutex);
+    return mutex_lock_impl(export_name, thread_id, thread, lock_count, mutex);
 }
 
-inline int mutex_unlock_impl(KernelState &kernel, const char *export_name, SceUID thread_id, int unlock_count, MutexPtr mutex) {
+inline int mutex_unlock_impl(const char *export_name, const ThreadStatePtr &cur_thread, int unlock_count, MutexPtr mutex) {
     const std::lock_guard<std::mutex> lock(mutex->mutex);
 
-    const ThreadStatePtr cur_thread = lock_and_find(thread_id, kernel.threads, kernel.mutex);
     if (cur_thread == mutex->owner) {
         if (unlock_count > mutex->lock_count) {
             return RET_ERROR(SCE_KERNEL_ERROR_LW_MUTEX_UNLOCK_UDF);
@@ -185,6 +231,7 @@ inline int mutex_unlock_impl(KernelState &kernel, const char *export_name, SceUI
         mutex->lock_count -= unlock_count;
         if (mutex->lock_count == 0) {
             mutex->owner = nullptr;
+            stat_mutex_released(mutex->stats);
             if (mutex->waiting_threads.size() > 0) {
                 const auto waiting_thread_data = mutex->waiting_threads.top();
                 const auto waiting_thread = waiting_thread_data.thread;
@@ -195,6 +242,7 @@ inline int mutex_unlock_impl(KernelState &kernel, const char *export_name, SceUI
                 mutex->waiting_threads.pop();
                 mutex->lock_count += waiting_lock_count;
                 mutex->owner = waiting_thread;
+                stat_mutex_acquired(mutex->stats);
                 waiting_thread->something_to_do.notify_one();
             }
         }
@@ -204,21 +252,22 @@ inline int mutex_unlock_impl(KernelState &kernel, const char *export_name, SceUI
 }
 
 int mutex_unlock(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, int unlock_count, SyncWeight weight) {
-    MutexPtr mutex;
-    if (auto error = find_mutex(mutex, nullptr, kernel, export_name, mutexid, weight))
-        return error;
+    ThreadStatePtr thread;
+    const MutexPtr mutex = find_primitive_and_thread(thread, kernel, get_mutexes(kernel, weight), mutexid, thread_id);
+    if (!mutex)
+        return unknown_mutex_id(export_name, weight);
 
     if (LOG_SYNC_PRIMITIVES) {
         LOG_DEBUG("{}: uid:{} thread_id:{} name:\"{}\" attr:{} lock_count:{}",
             export_name, mutexid, thread_id, mutex->name, mutex->attr, mutex->lock_count, unlock_count);
     }
 
-    return mutex_unlock_impl(kernel, export_name, thread_id, unlock_count, mutex);
+    return mutex_unlock_impl(export_name, thread, unlock_count, mutex);
 }
 
 int mutex_delete(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, SyncWeight weight) {
     MutexPtr mutex;
-    MutexPtrs mutexes;
+    MutexPtrs *mutexes = nullptr;
     if (auto error = find_mutex(mutex, &mutexes, kernel, export_name, mutexid, weight))
         return error;
 
@@ -229,7 +278,8 @@ int mutex_delete(KernelState &kernel, const char *export_name, SceUID thread_id,
 
     if (mutex->waiting_threads.empty()) {
         const std::lock_guard<std::mutex> lock(mutex->mutex);
-        mutexes.erase(mutexid);
+        const std::lock_guard<std::shared_mutex> kernel_lock(kernel.mutex);
+        mutexes->erase(mutexid);
     } else {
         // TODO:
     }
@@ -237,6 +287,131 @@ int mutex_delete(KernelState &kernel, const char *export_name, SceUID thread_id,
     return SCE_KERNEL_OK;
 }
 
+// ***********************
+// * Lightweight mutexes *
+// ***********************
+
+// The owner and waiter-count words live in guest memory, but every access to
+// them happens from a trap handler on the host side, so host atomics on the
+// mapped addresses are sufficient.
+inline std::atomic<SceUID> &lw_owner(emu::SceKernelLwMutexWork *workarea) {
+    static_assert(sizeof(std::atomic<SceUID>) == sizeof(SceUID), "Owner word must stay guest-sized");
+    return *reinterpret_cast<std::atomic<SceUID> *>(&workarea->owner);
+}
+
+inline std::atomic<std::int32_t> &lw_waiters(emu::SceKernelLwMutexWork *workarea) {
+    static_assert(sizeof(std::atomic<std::int32_t>) == sizeof(std::int32_t), "Waiter word must stay guest-sized");
+    return *reinterpret_cast<std::atomic<std::int32_t> *>(&workarea->waiters);
+}
+
+static int lw_mutex_lock_contended(KernelState &kernel, const char *export_name, SceUID thread_id, emu::SceKernelLwMutexWork *workarea, int lock_count) {
+    ThreadStatePtr thread;
+    const MutexPtr mutex = find_primitive_and_thread(thread, kernel, kernel.lwmutexes, workarea->uid, thread_id);
+    if (!mutex)
+        return unknown_mutex_id(export_name, SyncWeight::Light);
+
+    const std::lock_guard<std::mutex> lock(mutex->mutex);
+
+    // Announce the waiter before retrying, futex-style. Unlock stores
+    // owner = 0 and then early-returns if the waiter count is zero - without
+    // ever taking mutex->mutex - so the count has to be up by the time our
+    // compare-exchange can still fail, or that unlock slips through the
+    // window and we park on a free mutex forever.
+    lw_waiters(workarea).fetch_add(1);
+
+    // The holder may have released between the failed fast-path
+    // compare-exchange and here; retry now that we are announced.
+    SceUID expected = 0;
+    if (lw_owner(workarea).compare_exchange_strong(expected, thread_id)) {
+        lw_waiters(workarea).fetch_sub(1);
+        workarea->lock_count = lock_count;
+        ++mutex->stats.acquisitions;
+        return SCE_KERNEL_OK;
+    }
+
+    const std::lock_guard<std::mutex> lock2(thread->mutex);
+    assert(thread->to_do == ThreadToDo::run);
+    thread->to_do = ThreadToDo::wait;
+
+    WaitingThreadData data;
+    data.thread = thread;
+    data.lock_count = lock_count;
+    data.priority = (mutex->attr & SCE_KERNEL_ATTR_TH_FIFO) ? 0 : thread->priority;
+
+    mutex->waiting_threads.emplace(data);
+    stat_blocked(mutex->stats, mutex->waiting_threads.size());
+    stop(*thread->cpu);
+
+    return SCE_KERNEL_OK;
+}
+
+int lw_mutex_lock(KernelState &kernel, const char *export_name, SceUID thread_id, emu::SceKernelLwMutexWork *workarea, int lock_count) {
+    const TraceScope trace("lw_mutex_lock");
+    SceUID expected = 0;
+    if (lw_owner(workarea).compare_exchange_strong(expected, thread_id)) {
+        workarea->lock_count = lock_count;
+        return SCE_KERNEL_OK;
+    }
+
+    if (expected == thread_id) {
+        if (workarea->attr & SCE_KERNEL_MUTEX_ATTR_RECURSIVE) {
+            workarea->lock_count += lock_count;
+            return SCE_KERNEL_OK;
+        }
+        return SCE_KERNEL_ERROR_LW_MUTEX_RECURSIVE;
+    }
+
+    return lw_mutex_lock_contended(kernel, export_name, thread_id, workarea, lock_count);
+}
+
+int lw_mutex_unlock(KernelState &kernel, const char *export_name, SceUID thread_id, emu::SceKernelLwMutexWork *workarea, int unlock_count) {
+    if (lw_owner(workarea).load() != thread_id) {
+        return SCE_KERNEL_OK; // the heavyweight path also ignores non-owner unlocks
+    }
+    if (unlock_count > workarea->lock_count) {
+        return RET_ERROR(SCE_KERNEL_ERROR_LW_MUTEX_UNLOCK_UDF);
+    }
+
+    workarea->lock_count -= unlock_count;
+    if (workarea->lock_count > 0) {
+        return SCE_KERNEL_OK;
+    }
+
+    lw_owner(workarea).store(0);
+    if (lw_waiters(workarea).load() == 0) {
+        return SCE_KERNEL_OK; // uncontended: never touches the kernel
+    }
+
+    const MutexPtr mutex = lock_and_find(workarea->uid, kernel.lwmutexes, kernel.mutex);
+    if (!mutex)
+        return unknown_mutex_id(export_name, SyncWeight::Light);
+
+    const std::lock_guard<std::mutex> lock(mutex->mutex);
+    if (mutex->waiting_threads.empty()) {
+        return SCE_KERNEL_OK;
+    }
+
+    // Hand the lock straight to the best waiter - it resumes guest code
+    // already owning the mutex - unless a barger grabbed it since the release
+    // above, in which case the barger's own unlock comes back here.
+    const WaitingThreadData data = mutex->waiting_threads.top();
+    SceUID expected = 0;
+    if (!lw_owner(workarea).compare_exchange_strong(expected, data.thread->id)) {
+        return SCE_KERNEL_OK;
+    }
+    workarea->lock_count = data.lock_count;
+    mutex->waiting_threads.pop();
+    lw_waiters(workarea).fetch_sub(1);
+    ++mutex->stats.acquisitions;
+
+    const std::lock_guard<std::mutex> lock2(data.thread->mutex);
+    assert(data.thread->to_do == ThreadToDo::wait);
+    data.thread->to_do = ThreadToDo::run;
+    data.thread->something_to_do.notify_one();
+
+    return SCE_KERNEL_OK;
+}
+
 // **************
 // * Sempaphore *
 // **************
@@ -246,32 +421,36 @@ SceUID semaphore_create(KernelState &kernel, const char *export_name, const char
         return RET_ERROR(SCE_KERNEL_ERROR_UID_NAME_TOO_LONG);
     }
 
-    const SemaphorePtr semaphore = std::make_shared<Semaphore>();
-    const SceUID uid = kernel.get_next_uid();
-    semaphore->uid = uid;
+    const SemaphorePtr semaphore = make_pooled<Semaphore>(kernel.object_pool);
     semaphore->val = init_val;
     semaphore->max = max_val;
     semaphore->attr = attr;
     std::copy(name, name + KERNELOBJECT_MAX_NAME_LENGTH, semaphore->name);
 
+    SceUID uid;
+    {
+        const std::lock_guard<std::shared_mutex> lock(kernel.mutex);
+        uid = kernel.semaphores.alloc();
+        semaphore->uid = uid;
+        kernel.semaphores.set(uid, semaphore);
+    }
+
     if (LOG_SYNC_PRIMITIVES) {
         LOG_DEBUG("{}: uid:{} name:\"{}\" attr:{} init_val:{} max_val:{}",
             export_name, uid, name, attr, init_val, max_val);
     }
 
-    const std::lock_guard<std::mutex> lock(kernel.mutex);
-    kernel.semaphores.emplace(uid, semaphore);
-
     return uid;
 }
 
 int semaphore_wait(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID semaid, SceInt32 signal, SceUInt *timeout) {
+    const TraceScope trace("semaphore_wait");
     assert(semaid >= 0);
     assert(signal == 1);
     assert(timeout == nullptr);
 
-    // TODO Don't lock twice.
-    const SemaphorePtr semaphore = lock_and_find(semaid, kernel.semaphores, kernel.mutex);
+    ThreadStatePtr thread;
+    const SemaphorePtr semaphore = find_primitive_and_thread(thread, kernel, kernel.semaphores, semaid, thread_id);
     if (!semaphore) {
         return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_SEMA_ID);
     }
@@ -283,8 +462,6 @@ int semaphore_wait(KernelState &kernel, const char *export_name, SceUID thread_i
 
     const std::lock_guard<std::mutex> lock(semaphore->mutex);
 
-    const ThreadStatePtr thread = lock_and_find(thread_id, kernel.threads, kernel.mutex);
-
     bool is_fifo = (semaphore->attr & SCE_KERNEL_ATTR_TH_FIFO);
 
     if (semaphore->val <= 0) {
@@ -298,9 +475,11 @@ int semaphore_wait(KernelState &kernel, const char *export_name, SceUID thread_i
         data.signal = signal;
 
         semaphore->waiting_threads.emplace(data);
+        stat_blocked(semaphore->stats, semaphore->waiting_threads.size());
         stop(*thread->cpu);
     } else {
         semaphore->val -= signal;
+        ++semaphore->stats.acquisitions;
     }
 
     return SCE_KERNEL_OK;
@@ -334,6 +513,7 @@ int semaphore_signal(KernelState &kernel, const char *export_name, SceUID semaid
         waiting_thread->to_do = ThreadToDo::run;
         semaphore->waiting_threads.pop();
         semaphore->val -= waiting_signal_count;
+        ++semaphore->stats.acquisitions;
         waiting_thread->something_to_do.notify_one();
     }
 
@@ -352,34 +532,37 @@ SceUID condvar_create(SceUID *uid_out, KernelState &kernel, const char *export_n
     if (auto error = find_mutex(assoc_mutex, nullptr, kernel, export_name, assoc_mutexid, weight))
         return error;
 
-    const SceUID uid = kernel.get_next_uid();
+    const CondvarPtr condvar = make_pooled<Condvar>(kernel.object_pool);
+    condvar->attr = attr;
+    condvar->associated_mutex = std::move(assoc_mutex);
+    std::copy(name, name + KERNELOBJECT_MAX_NAME_LENGTH, condvar->name);
+
+    SceUID uid;
+    {
+        const std::lock_guard<std::shared_mutex> lock(kernel.mutex);
+        auto &condvars = get_condvars(kernel, weight);
+        uid = condvars.alloc();
+        condvar->uid = uid;
+        condvars.set(uid, condvar);
+    }
 
     if (LOG_SYNC_PRIMITIVES) {
         LOG_DEBUG("{}: uid:{} name:\"{}\" attr:{} assoc_mutexid:{}",
             export_name, uid, name, attr, assoc_mutexid);
     }
 
-    const CondvarPtr condvar = std::make_shared<Condvar>();
-    condvar->attr = attr;
-    condvar->associated_mutex = std::move(assoc_mutex);
-    std::copy(name, name + KERNELOBJECT_MAX_NAME_LENGTH, condvar->name);
-
-    const std::lock_guard<std::mutex> lock(kernel.mutex);
-    auto &condvars = get_condvars(kernel, weight);
-    condvars.emplace(uid, condvar);
-
     if (uid_out)
         *uid_out = uid;
     return SCE_KERNEL_OK;
 }
 
 int condvar_wait(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID condid, SceUInt *timeout, SyncWeight weight) {
+    const TraceScope trace("condvar_wait");
     assert(timeout == nullptr);
     assert(condid >= 0);
 
-    auto &condvars = get_condvars(kernel, weight);
-    // TODO Don't lock twice.
-    const CondvarPtr condvar = lock_and_find(condid, condvars, kernel.mutex);
+    ThreadStatePtr thread;
+    const CondvarPtr condvar = find_primitive_and_thread(thread, kernel, get_condvars(kernel, weight), condid, thread_id);
     if (!condvar) {
         return unknown_cond_id(export_name, weight);
     }
@@ -391,12 +574,14 @@ int condvar_wait(KernelState &kernel, const char *export_name, SceUID thread_id,
 
     const std::lock_guard<std::mutex> lock(condvar->mutex);
 
-    const ThreadStatePtr thread = lock_and_find(thread_id, kernel.threads, kernel.mutex);
-
     bool is_fifo = (condvar->attr & SCE_KERNEL_ATTR_TH_FIFO);
 
-    if (auto error = mutex_unlock_impl(kernel, export_name, thread_id, 1, condvar->associated_mutex))
-        return error;
+    const MutexPtr assoc_mutex = condvar->associated_mutex;
+    const int unlock_error = assoc_mutex->workarea
+        ? lw_mutex_unlock(kernel, export_name, thread_id, assoc_mutex->workarea, 1)
+        : mutex_unlock_impl(export_name, thread, 1, assoc_mutex);
+    if (unlock_error)
+        return unlock_error;
 
     const std::lock_guard<std::mutex> lock2(thread->mutex);
     assert(thread->to_do == ThreadToDo::run);
@@ -407,15 +592,57 @@ int condvar_wait(KernelState &kernel, const char *export_name, SceUID thread_id,
     data.priority = is_fifo ? 0 : thread->priority;
 
     condvar->waiting_threads.emplace(data);
+    stat_blocked(condvar->stats, condvar->waiting_threads.size());
     stop(*thread->cpu);
 
     return SCE_KERNEL_OK;
 }
 
+// Hands a waiter detached from a condvar over to the condvar's associated
+// mutex. If the mutex is free the waiter takes ownership and resumes; if it
+// is held the waiter moves onto the mutex's queue without waking, since it
+// would only run as far as the mutex and block again. A broadcast therefore
+// resumes exactly one thread and the rest wake one at a time as the mutex is
+// handed along, instead of stampeding the host scheduler.
+static void requeue_on_mutex(const MutexPtr &mutex, WaitingThreadData waiter) {
+    const std::lock_guard<std::mutex> lock(mutex->mutex);
+
+    waiter.lock_count = 1; // condvar_wait released exactly one count
+    waiter.priority = (mutex->attr & SCE_KERNEL_ATTR_TH_FIFO) ? 0 : waiter.thread->priority;
+
+    if (mutex->workarea) {
+        // Same futex discipline as lw_mutex_lock_contended: the waiter count
+        // goes up before the compare-exchange, so an unlock racing us cannot
+        // read zero and skip the handover while this thread ends up parked.
+        lw_waiters(mutex->workarea).fetch_add(1);
+        SceUID expected = 0;
+        if (!lw_owner(mutex->workarea).compare_exchange_strong(expected, waiter.thread->id)) {
+            mutex->waiting_threads.emplace(waiter);
+            stat_blocked(mutex->stats, mutex->waiting_threads.size());
+            return;
+        }
+        lw_waiters(mutex->workarea).fetch_sub(1);
+        mutex->workarea->lock_count = 1;
+        ++mutex->stats.acquisitions;
+    } else {
+        if (mutex->lock_count > 0) {
+            mutex->waiting_threads.emplace(waiter);
+            stat_blocked(mutex->stats, mutex->waiting_threads.size());
+            return;
+        }
+        mutex->lock_count = 1;
+        mutex->owner = waiter.thread;
+        stat_mutex_acquired(mutex->stats);
+    }
+
+    const std::lock_guard<std::mutex> lock2(waiter.thread->mutex);
+    assert(waiter.thread->to_do == ThreadToDo::wait);
+    waiter.thread->to_do = ThreadToDo::run;
+    waiter.thread->something_to_do.notify_one();
+}
+
 int condvar_signal(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID condid, Condvar::SignalTarget signal_target, SyncWeight weight) {
-    auto &condvars = get_condvars(kernel, weight);
-    // TODO Don't lock twice.
-    const CondvarPtr condvar = lock_and_find(condid, condvars, kernel.mutex);
+    const CondvarPtr condvar = lock_and_find(condid, get_condvars(kernel, weight), kernel.mutex);
     if (!condvar) {
         return unknown_cond_id(export_name, weight);
     }
@@ -425,61 +652,45 @@ int condvar_signal(KernelState &kernel, const char *export_name, SceUID thread_i
             export_name, condvar->uid, condvar->name, condvar->attr, condvar->associated_mutex->uid);
     }
 
-    const std::lock_guard<std::mutex> lock(condvar->mutex);
-
-    const auto target_type = signal_target.type;
-
-    WaitingThreadData waiting_thread_data;
-    if (target_type == Condvar::SignalTarget::Type::Specific) {
-        ThreadStatePtr waiting_thread = lock_and_find(signal_target.thread_id, kernel.threads, kernel.mutex);
-
-        // Search for specified waiting thread
-        auto waiting_thread_iter = condvar->waiting_threads.find(waiting_thread);
-        if (waiting_thread_iter != condvar->waiting_threads.end()) {
-            LOG_ERROR("{}: Target thread {} not found", export_name, waiting_thread->name);
-        } else {
-            waiting_thread_data = *waiting_thread_iter;
-        }
-
-        if (!condvar->waiting_threads.remove(waiting_thread_data))
-            LOG_ERROR("{}: Target thread {} not found", export_name, waiting_thread->name);
-
-        {
-            const std::lock_guard<std::mutex> lock2(waiting_thread->mutex);
-
-            assert(waiting_thread->to_do == ThreadToDo::wait);
-            waiting_thread->to_do = ThreadToDo::run;
+    const MutexPtr assoc_mutex = condvar->associated_mutex;
 
-            condvar->waiting_threads.pop();
+    // Detach everything to signal under one hold of the condvar lock, then
+    // requeue the batch on the associated mutex outside it.
+    std::vector<WaitingThreadData> waiters;
+    {
+        const std::lock_guard<std::mutex> lock(condvar->mutex);
 
-            waiting_thread->something_to_do.notify_one();
+        switch (signal_target.type) {
+        case Condvar::SignalTarget::Type::Specific: {
+            const ThreadStatePtr target = lock_and_find(signal_target.thread_id, kernel.threads, kernel.mutex);
+            const auto waiting_thread_iter = condvar->waiting_threads.find(target);
+            if (waiting_thread_iter == condvar->waiting_threads.end()) {
+                LOG_ERROR("{}: Target thread {} not found", export_name, signal_target.thread_id);
+            } else {
+                waiters.push_back(*waiting_thread_iter);
+                condvar->waiting_threads.remove(*waiting_thread_iter);
+            }
+            break;
         }
-
-        if (auto error = mutex_lock_impl(kernel, export_name, thread_id, 1, condvar->associated_mutex))
-            return error;
-
-    } else {
-        while (condvar->waiting_threads.size() > 0) {
-            ThreadStatePtr waiting_thread;
-
-            waiting_thread_data = condvar->waiting_threads.top();
-
-            waiting_thread = waiting_thread_data.thread;
-
-            {
-                const std::lock_guard<std::mutex> lock2(waiting_thread->mutex);
-
-                assert(waiting_thread->to_do == ThreadToDo::wait);
-                waiting_thread->to_do = ThreadToDo::run;
-
+        case Condvar::SignalTarget::Type::Any:
+            if (condvar->waiting_threads.size() > 0) {
+                waiters.push_back(condvar->waiting_threads.top());
                 condvar->waiting_threads.pop();
-
-                waiting_thread->something_to_do.notify_one();
             }
-
-            if (auto error = mutex_lock_impl(kernel, export_name, thread_id, 1, condvar->associated_mutex))
-                return error;
+            break;
+        case Condvar::SignalTarget::Type::All:
+            while (condvar->waiting_threads.size() > 0) {
+                waiters.push_back(condvar->waiting_threads.top());
+                condvar->waiting_threads.pop();
+            }
+            break;
         }
+
+        condvar->stats.acquisitions += waiters.size();
+    }
+
+    for (const WaitingThreadData &waiter : waiters) {
+        requeue_on_mutex(assoc_mutex, waiter);
     }
 
     return SCE_KERNEL_OK;
@@ -490,31 +701,34 @@ SceUID create_eventflag(KernelState &kernel, const char *export_name, SceUID thr
         return RET_ERROR(SCE_KERNEL_ERROR_UID_NAME_TOO_LONG);
     }
 
-    const SceUID uid = kernel.get_next_uid();
+    const EventFlagPtr event = make_pooled<EventFlag>(kernel.object_pool);
+    event->flags = flags;
+    std::copy(event_name, event_name + KERNELOBJECT_MAX_NAME_LENGTH, event->name);
+    event->attr = attr;
+
+    SceUID uid;
+    {
+        const std::lock_guard<std::shared_mutex> lock(kernel.mutex);
+        uid = kernel.eventflags.alloc();
+        event->uid = uid;
+        kernel.eventflags.set(uid, event);
+    }
 
     if (LOG_SYNC_PRIMITIVES) {
         LOG_DEBUG("{}: uid:{} thread_id:{} name:\"{}\" attr:{} flags:{:#b}",
             export_name, uid, thread_id, event_name, attr, flags);
     }
 
-    const EventFlagPtr event = std::make_shared<EventFlag>();
-    event->uid = uid;
-    event->flags = flags;
-    std::copy(event_name, event_name + KERNELOBJECT_MAX_NAME_LENGTH, event->name);
-    event->attr = attr;
-
-    const std::lock_guard<std::mutex> lock(kernel.mutex);
-    kernel.eventflags.emplace(uid, event);
-
     return uid;
 }
 
 int wait_eventflag(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID event_id, unsigned int flags, unsigned int wait, SceUInt *timeout) {
+    const TraceScope trace("wait_eventflag");
     assert(event_id >= 0);
     assert(timeout == nullptr);
 
-    // TODO Don't lock twice.
-    const EventFlagPtr event = lock_and_find(event_id, kernel.eventflags, kernel.mutex);
+    ThreadStatePtr thread;
+    const EventFlagPtr event = find_primitive_and_thread(thread, kernel, kernel.eventflags, event_id, thread_id);
     if (!event) {
         return RET_ERROR(SCE_KERNEL_ERROR_UNKNOWN_SEMA_ID);
     }
@@ -526,8 +740,6 @@ int wait_eventflag(KernelState &kernel, const char *export_name, SceUID thread_i
 
     const std::lock_guard<std::mutex> lock(event->mutex);
 
-    const ThreadStatePtr thread = lock_and_find(thread_id, kernel.threads, kernel.mutex);
-
     bool is_fifo = (event->attr & SCE_KERNEL_ATTR_TH_FIFO);
 
     bool condition = false;
@@ -546,6 +758,8 @@ int wait_eventflag(KernelState &kernel, const char *export_name, SceUID thread_i
         if (wait & SCE_EVENT_WAITCLEAR_PAT) {
             event->flags &= flags;
         }
+
+        ++event->stats.acquisitions;
     } else {
         const std::lock_guard<std::mutex> lock2(thread->mutex);
         assert(thread->to_do == ThreadToDo::run);
@@ -558,6 +772,7 @@ int wait_eventflag(KernelState &kernel, const char *export_name, SceUID thread_i
         data.priority = is_fifo ? 0 : thread->priority;
 
         event->waiting_threads.emplace(data);
+        stat_blocked(event->stats, event->waiting_threads.size());
         stop(*thread->cpu);
     }
 
@@ -576,40 +791,54 @@ int set_eventflag(KernelState &kernel, const char *export_name, SceUID event_id,
             export_name, event->uid, event->name, event->attr, event->flags, flags);
     }
 
-    const std::lock_guard<std::mutex> lock(event->mutex);
-    event->flags |= flags;
-
-    WaitingThreadQueue waiting_threads_copy = event->waiting_threads;
-    while (!waiting_threads_copy.empty()) {
-        bool condition = false;
+    // Collect every satisfied waiter in one pass under the lock, then wake
+    // them after releasing it so a broadcast flag resumes its whole worker
+    // pool without the woken threads contending on the event.
+    std::vector<WaitingThreadData> woken;
+    {
+        const std::lock_guard<std::mutex> lock(event->mutex);
+        event->flags |= flags;
+
+        // Pop in wakeup order so each waiter's clear bits apply before the
+        // next candidate is evaluated, as with one-at-a-time wakeup.
+        WaitingThreadQueue still_waiting;
+        while (!event->waiting_threads.empty()) {
+            const WaitingThreadData waiter = event->waiting_threads.top();
+            event->waiting_threads.pop();
+
+            bool condition = false;
+            if (waiter.wait & SCE_EVENT_WAITOR) {
+                condition = event->flags & waiter.flags;
+            } else {
+                condition = (event->flags & waiter.flags) == waiter.flags;
+            }
 
-        auto waiter = waiting_threads_copy.top();
+            if (condition) {
+                if (waiter.wait & SCE_EVENT_WAITCLEAR) {
+                    event->flags = 0;
+                }
 
-        if (waiter.wait & SCE_EVENT_WAITOR) {
-            condition = event->flags & waiter.flags;
-        } else {
-            condition = (event->flags & waiter.flags) == waiter.flags;
-        }
+                if (waiter.wait & SCE_EVENT_WAITCLEAR_PAT) {
+                    event->flags &= ~waiter.flags;
+                }
 
-        if (condition) {
-            if (waiter.wait & SCE_EVENT_WAITCLEAR) {
-                event->flags = 0;
-            }
-
-            if (waiter.wait & SCE_EVENT_WAITCLEAR_PAT) {
-                event->flags &= ~waiter.flags;
+                woken.push_back(waiter);
+                ++event->stats.acquisitions;
+            } else {
+                still_waiting.emplace(waiter);
             }
+        }
+        event->waiting_threads = std::move(still_waiting);
+    }
 
-            event->waiting_threads.remove(waiter);
-
-            const ThreadStatePtr waiting_thread = waiter.thread;
+    for (const WaitingThreadData &waiter : woken) {
+        const ThreadStatePtr waiting_thread = waiter.thread;
+        {
             const std::lock_guard<std::mutex> lock2(waiting_thread->mutex);
             assert(waiting_thread->to_do == ThreadToDo::wait);
             waiting_thread->to_do = ThreadToDo::run;
-            waiting_thread->something_to_do.notify_one();
         }
-
-        waiting_threads_copy.pop();
+        waiting_thread->something_to_do.notify_one();
     }
 
     return 0;
@@ -634,7 +863,7 @@ int delete_eventflag(KernelState &kernel, const char *export_name, SceUID thread
     }
 
     if (event->waiting_threads.empty()) {
-        const std::lock_guard<std::mutex> lock(event->mutex);
+        const std::lock_guard<std::shared_mutex> kernel_lock(kernel.mutex);
         kernel.eventflags.erase(event_id);
     } else {
         // TODO:
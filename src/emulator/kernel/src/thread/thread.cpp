@@ -25,42 +25,68 @@
 #include <cpu/functions.h>
 #include <util/find.h>
 #include <util/lock_and_find.h>
+#include <util/object_pool.h>
 #include <util/resource.h>
+#include <util/trace.h>
 
 #include <SDL_thread.h>
 
 #include <cassert>
 #include <cstring>
+#include <thread>
 
 struct ThreadParams {
     KernelState *kernel = nullptr;
     SceUID thid = SCE_KERNEL_ERROR_ILLEGAL_THREAD_ID;
     SceSize arglen = 0;
     Ptr<void> argp;
-    std::shared_ptr<SDL_semaphore> host_may_destroy_params = std::shared_ptr<SDL_semaphore>(SDL_CreateSemaphore(0), SDL_DestroySemaphore);
 };
 
-static int SDLCALL thread_function(void *data) {
-    assert(data != nullptr);
-    const ThreadParams params = *static_cast<const ThreadParams *>(data);
-    SDL_SemPost(params.host_may_destroy_params.get());
+// Maps guest priority bands onto the host's three SDL levels so the host
+// scheduler sees the same urgency the title expressed - render- and
+// audio-servicing threads sit in the top guest band, bulk loaders in the
+// bottom one. Values outside the user range (the unresolved
+// SCE_KERNEL_DEFAULT_PRIORITY encodings) stay at normal.
+static void apply_host_priority(int guest_priority) {
+    SDL_ThreadPriority host_priority = SDL_THREAD_PRIORITY_NORMAL;
+    constexpr int band = (SCE_KERNEL_LOWEST_PRIORITY_USER - SCE_KERNEL_HIGHEST_PRIORITY_USER) / 3;
+    if ((guest_priority >= SCE_KERNEL_HIGHEST_PRIORITY_USER) && (guest_priority <= SCE_KERNEL_LOWEST_PRIORITY_USER)) {
+        if (guest_priority <= SCE_KERNEL_HIGHEST_PRIORITY_USER + band) {
+            host_priority = SDL_THREAD_PRIORITY_HIGH;
+        } else if (guest_priority > SCE_KERNEL_LOWEST_PRIORITY_USER - band) {
+            host_priority = SDL_THREAD_PRIORITY_LOW;
+        }
+    }
+    SDL_SetThreadPriority(host_priority);
+}
+
+static void thread_function(const ThreadParams &params) {
     const ThreadStatePtr thread = lock_and_find(params.thid, params.kernel->threads, params.kernel->mutex);
+    apply_host_priority(thread->priority);
     write_reg(*thread->cpu, 0, params.arglen);
     write_reg(*thread->cpu, 1, params.argp.address());
     const bool succeeded = run_thread(*thread, false);
     assert(succeeded);
-    const uint32_t r0 = read_reg(*thread->cpu, 0);
-    return r0;
+    // The worker is recycled - do not let the next guest thread inherit
+    // this one's host priority.
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_NORMAL);
 }
 
 SceUID create_thread(Ptr<const void> entry_point, KernelState &kernel, MemState &mem, const char *name, int init_priority, int stack_size, CallImport call_import, bool log_code) {
-    SceUID thid = kernel.get_next_uid();
+    SceUID thid;
+    {
+        // Reserve the handle up front - the import dispatch closure needs it
+        // before the thread is published.
+        const std::unique_lock<std::shared_mutex> lock(kernel.mutex);
+        thid = kernel.threads.alloc();
+    }
 
     const ThreadStack::Deleter stack_deleter = [&mem](Address stack) {
         free(mem, stack);
     };
 
-    const ThreadStatePtr thread = std::make_shared<ThreadState>();
+    const ThreadStatePtr thread = make_pooled<ThreadState>(kernel.object_pool);
+    thread->id = thid;
     thread->name = name;
     // TODO: needs testing
     if (init_priority & (SCE_KERNEL_DEFAULT_PRIORITY & 0xF0000000)) {
@@ -73,28 +99,29 @@ SceUID create_thread(Ptr<const void> entry_point, KernelState &kernel, MemState
     const Address stack_top = thread->stack->get() + stack_size;
     memset(Ptr<void>(thread->stack->get()).get(mem), 0xcc, stack_size);
 
-    const CallSVC call_svc = [call_import, thid, &mem](CPUState &cpu, uint32_t imm, Address pc) {
-        assert(imm == 0);
-        const uint32_t nid = *Ptr<uint32_t>(pc + 4).get(mem);
-        call_import(cpu, nid, thid);
+    const CallSVC call_svc = [call_import, thid](CPUState &cpu, uint32_t imm, Address pc) {
+        call_import(cpu, imm, pc, thid);
     };
 
-    thread->cpu = init_cpu(entry_point.address(), stack_top, log_code, call_svc, mem);
+    thread->cpu = acquire_cpu(kernel.cpu_pool, kernel.cpu_backend, entry_point.address(), stack_top, log_code, call_svc, mem);
     if (!thread->cpu) {
+        const std::unique_lock<std::shared_mutex> lock(kernel.mutex);
+        kernel.threads.erase(thid);
         return SCE_KERNEL_ERROR_ERROR;
     }
+    set_execution_quantum(*thread->cpu, kernel.execution_quantum);
 
     WaitingThreadState waiting{ name };
 
-    const std::unique_lock<std::mutex> lock(kernel.mutex);
-    kernel.threads.emplace(thid, thread);
+    const std::unique_lock<std::shared_mutex> lock(kernel.mutex);
+    kernel.threads.set(thid, thread);
     kernel.waiting_threads.emplace(thid, waiting);
 
     return thid;
 }
 
 int start_thread(KernelState &kernel, const SceUID &thid, SceSize arglen, const Ptr<void> &argp) {
-    const std::unique_lock<std::mutex> lock(kernel.mutex);
+    const std::unique_lock<std::shared_mutex> lock(kernel.mutex);
 
     const KernelWaitingThreadStates::const_iterator waiting = kernel.waiting_threads.find(thid);
     if (waiting == kernel.waiting_threads.end()) {
@@ -110,23 +137,30 @@ int start_thread(KernelState &kernel, const SceUID &thid, SceSize arglen, const
     params.arglen = arglen;
     params.argp = argp;
 
-    const std::function<void(SDL_Thread *)> delete_thread = [thread](SDL_Thread *running_thread) {
+    // Signalled when the guest thread has left its run loop, standing in for
+    // the SDL_WaitThread join the dedicated host thread used to provide.
+    const std::shared_ptr<SDL_semaphore> guest_exited(SDL_CreateSemaphore(0), SDL_DestroySemaphore);
+
+    const std::function<void(PooledWorker *)> delete_thread = [thread, guest_exited](PooledWorker *) {
         {
             const std::unique_lock<std::mutex> lock(thread->mutex);
             thread->to_do = ThreadToDo::exit;
         }
         thread->something_to_do.notify_all(); // TODO Should this be notify_one()?
-        SDL_WaitThread(running_thread, nullptr);
+        SDL_SemWait(guest_exited.get());
     };
 
-    const ThreadPtr running_thread(SDL_CreateThread(&thread_function, waiting->second.name.c_str(), &params), delete_thread);
-    if (!running_thread) {
+    PooledWorker *const worker = run_on_worker(kernel.thread_pool, [params, guest_exited]() {
+        thread_function(params);
+        SDL_SemPost(guest_exited.get());
+    });
+    if (!worker) {
         return SCE_KERNEL_ERROR_THREAD_ERROR;
     }
+    const ThreadPtr running_thread(worker, delete_thread);
 
     kernel.waiting_threads.erase(waiting);
     kernel.running_threads.emplace(thid, running_thread);
-    SDL_SemWait(params.host_may_destroy_params.get());
     return SCE_KERNEL_OK;
 }
 
@@ -134,7 +168,7 @@ Ptr<void> copy_stack(SceUID thid, SceUID thread_id, const Ptr<void> &argp, Kerne
     const ThreadStatePtr new_thread = lock_and_find(thid, kernel.threads, kernel.mutex);
     const ThreadStatePtr old_thread = lock_and_find(thread_id, kernel.threads, kernel.mutex);
 
-    const std::unique_lock<std::mutex> lock(kernel.mutex);
+    const std::shared_lock<std::shared_mutex> lock(kernel.mutex);
 
     const Address old_stack_address = old_thread->stack->get();
     const Address new_stack_address = new_thread->stack->get();
@@ -173,30 +207,56 @@ bool run_thread(ThreadState &thread, bool callback) {
             if (callback) {
                 return true;
             }
+            // A slice expired or the run was interrupted. Give equal-priority
+            // host threads a turn before the next slice so the guest threads
+            // sharing this core round-robin fairly.
+            std::this_thread::yield();
             lock.lock();
             break;
-        case ThreadToDo::wait:
+        case ThreadToDo::wait: {
+            // The flag plus notify lets pause_all_threads wait until the
+            // thread is genuinely outside the CPU; the run loop tolerates
+            // the spurious wakeup.
+            const TraceScope trace("thread parked");
+            thread.parked = true;
+            thread.something_to_do.notify_all();
             thread.something_to_do.wait(lock);
+            thread.parked = false;
             break;
         }
+        }
     }
 }
 
 bool run_callback(ThreadState &thread, Address &pc, Address &data) {
     std::unique_lock<std::mutex> lock(thread.mutex);
+    CPUContext context;
+    save_context(*thread.cpu, context);
     write_reg(*thread.cpu, 0, data);
     write_pc(*thread.cpu, pc);
     lock.unlock();
-    return run_thread(thread, true);
+
+    const bool callback = run_thread(thread, true);
+
+    lock.lock();
+    load_context(*thread.cpu, context);
+    return callback;
 }
 
 uint32_t run_on_current(ThreadState &thread, const Ptr<const void> entry_point, SceSize arglen, Ptr<void> &argp) {
     std::unique_lock<std::mutex> lock(thread.mutex);
     stop(*thread.cpu);
+    CPUContext context;
+    save_context(*thread.cpu, context);
     write_reg(*thread.cpu, 0, arglen);
     write_reg(*thread.cpu, 1, argp.address());
     write_pc(*thread.cpu, entry_point.address());
     lock.unlock();
+
     run_thread(thread, false);
-    return read_reg(*thread.cpu, 0);
+
+    lock.lock();
+    const uint32_t ret = read_reg(*thread.cpu, 0);
+    load_context(*thread.cpu, context);
+    return ret;
 }
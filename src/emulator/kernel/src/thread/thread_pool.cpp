@@ -0,0 +1,75 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <kernel/thread/thread_pool.h>
+
+#include <SDL_thread.h>
+
+static int SDLCALL worker_function(void *data) {
+    PooledWorker *const worker = static_cast<PooledWorker *>(data);
+    for (;;) {
+        ThreadPoolJob job;
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->job_ready.wait(lock, [worker] { return worker->busy; });
+            job = std::move(worker->job);
+        }
+        job();
+        {
+            const std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->busy = false;
+        }
+        const std::lock_guard<std::mutex> lock(worker->pool->mutex);
+        worker->pool->idle.push_back(worker);
+    }
+    return 0;
+}
+
+PooledWorker *run_on_worker(ThreadPool &pool, ThreadPoolJob job) {
+    PooledWorker *worker = nullptr;
+    {
+        const std::lock_guard<std::mutex> lock(pool.mutex);
+        if (!pool.idle.empty()) {
+            worker = pool.idle.front();
+            pool.idle.pop_front();
+        }
+    }
+
+    if (!worker) {
+        std::unique_ptr<PooledWorker> owned = std::make_unique<PooledWorker>();
+        owned->pool = &pool;
+        worker = owned.get();
+
+        // Workers run until process exit; nobody joins them.
+        SDL_Thread *const host_thread = SDL_CreateThread(&worker_function, "kernel worker", worker);
+        if (!host_thread) {
+            return nullptr;
+        }
+        SDL_DetachThread(host_thread);
+
+        const std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.workers.push_back(std::move(owned));
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->job = std::move(job);
+        worker->busy = true;
+    }
+    worker->job_ready.notify_one();
+    return worker;
+}
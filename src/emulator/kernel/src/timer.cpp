@@ -0,0 +1,67 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <kernel/timer.h>
+
+static void timer_worker(TimerState &timer) {
+    std::unique_lock<std::mutex> lock(timer.mutex);
+    while (!timer.stop) {
+        if (timer.deadlines.empty()) {
+            timer.rescheduled.wait(lock);
+            continue;
+        }
+
+        // Sleep until the earliest deadline; rescheduled interrupts the wait
+        // when a nearer deadline arrives or the service shuts down.
+        timer.rescheduled.wait_until(lock, timer.deadlines.begin()->first);
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        while (!timer.deadlines.empty() && (timer.deadlines.begin()->first <= now)) {
+            const TimerWaiterPtr waiter = timer.deadlines.begin()->second;
+            timer.deadlines.erase(timer.deadlines.begin());
+            {
+                const std::lock_guard<std::mutex> waiter_lock(waiter->mutex);
+                waiter->expired = true;
+            }
+            waiter->cond.notify_one();
+        }
+    }
+}
+
+void timer_sleep(TimerState &timer, uint64_t microseconds) {
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(microseconds);
+    const TimerWaiterPtr waiter = std::make_shared<TimerWaiter>();
+
+    bool wake_worker = false;
+    {
+        const std::lock_guard<std::mutex> lock(timer.mutex);
+        if (!timer.worker.joinable()) {
+            timer.worker = std::thread(timer_worker, std::ref(timer));
+        }
+
+        // The worker only needs a nudge when the new deadline becomes the
+        // earliest one; otherwise its current wait already covers it.
+        wake_worker = timer.deadlines.empty() || (deadline < timer.deadlines.begin()->first);
+        timer.deadlines.emplace(deadline, waiter);
+    }
+    if (wake_worker) {
+        timer.rescheduled.notify_one();
+    }
+
+    std::unique_lock<std::mutex> lock(waiter->mutex);
+    waiter->cond.wait(lock, [&waiter] { return waiter->expired; });
+}
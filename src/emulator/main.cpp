@@ -15,12 +15,15 @@
 // with this program; if not, write to the Free Software Foundation, Inc.,
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
+#include <cpu/functions.h>
+#include <gxm/types.h>
 #include <host/app.h>
 #include <host/functions.h>
 #include <host/screen_render.h>
 #include <host/state.h>
 #include <host/version.h>
 #include <kernel/thread/thread_functions.h>
+#include <util/hitch.h>
 #include <util/log.h>
 #include <util/string_convert.h>
 
@@ -29,7 +32,180 @@
 #include <gui/functions.h>
 #include <gui/imgui_impl.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Percentile over the collected frame intervals. The copy is cheap next to
+// a benchmark run and keeps the caller's sample order intact.
+static double percentile(std::vector<float> samples, const float fraction) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    const size_t nth = static_cast<size_t>((samples.size() - 1) * fraction);
+    std::nth_element(samples.begin(), samples.begin() + nth, samples.end());
+    return samples[nth];
+}
+
+// One machine-readable record per benchmark run, in the same hand-written
+// JSON style as the telemetry dumps. Scalars only - the nightly harness
+// diffs these across builds, so every field is a number it can threshold.
+static bool write_benchmark_results(HostState &host, const std::string &path, const double seconds_run,
+    const std::vector<float> &frame_ms, const uint64_t instructions, const uint64_t underruns) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    uint64_t io_opens = 0;
+    uint64_t io_reads = 0;
+    uint64_t io_read_bytes = 0;
+    uint64_t io_writes = 0;
+    uint64_t io_write_bytes = 0;
+    for (const auto &entry : host.io.telemetry.files) {
+        io_opens += entry.second.opens;
+        io_reads += entry.second.reads.count;
+        io_read_bytes += entry.second.reads.bytes;
+        io_writes += entry.second.writes.count;
+        io_write_bytes += entry.second.writes.bytes;
+    }
+
+    double frame_ms_avg = 0.0;
+    for (const float ms : frame_ms) {
+        frame_ms_avg += ms;
+    }
+    if (!frame_ms.empty()) {
+        frame_ms_avg /= frame_ms.size();
+    }
+
+    const uint64_t frames = host.total_frame_count;
+    out << "{\n";
+    out << "  \"title_id\": \"" << host.io.title_id << "\",\n";
+    out << "  \"frames\": " << frames << ",\n";
+    out << "  \"seconds\": " << seconds_run << ",\n";
+    out << "  \"fps\": " << ((seconds_run > 0.0) ? (frames / seconds_run) : 0.0) << ",\n";
+    out << "  \"frame_ms\": { \"avg\": " << frame_ms_avg
+        << ", \"p50\": " << percentile(frame_ms, 0.5f)
+        << ", \"p95\": " << percentile(frame_ms, 0.95f)
+        << ", \"p99\": " << percentile(frame_ms, 0.99f) << " },\n";
+    out << "  \"guest_mips\": " << ((seconds_run > 0.0) ? (instructions / seconds_run / 1e6) : 0.0) << ",\n";
+    out << "  \"draws\": " << host.gxm.draw_count << ",\n";
+    out << "  \"draws_per_frame\": " << ((frames > 0) ? (static_cast<double>(host.gxm.draw_count) / frames) : 0.0) << ",\n";
+
+    const Ptr<SceGxmContext> context = host.gxm.context;
+    if (context) {
+        const TextureCacheStatistics &stats = context.get(host.mem)->renderer.texture_cache.statistics;
+        out << "  \"texture_cache\": { \"lookups\": " << stats.lookups
+            << ", \"hits\": " << stats.hits
+            << ", \"hit_rate\": " << ((stats.lookups > 0) ? (static_cast<double>(stats.hits) / stats.lookups) : 0.0)
+            << ", \"bytes_uploaded\": " << stats.bytes_uploaded << " },\n";
+    }
+
+    const HitchHistogram hitches = hitch_histogram_snapshot();
+    out << "  \"hitches\": { \"frames\": " << hitches.frames
+        << ", \"slow_frames\": " << hitches.slow_frames
+        << ", \"by_cause\": {";
+    for (int stage = 0; stage < HitchStageCount; ++stage) {
+        out << ((stage > 0) ? ", " : " ") << "\"" << hitch_stage_names[stage] << "\": " << hitches.counts[stage];
+    }
+    out << " } },\n";
+
+    out << "  \"io\": { \"opens\": " << io_opens
+        << ", \"reads\": " << io_reads
+        << ", \"read_bytes\": " << io_read_bytes
+        << ", \"writes\": " << io_writes
+        << ", \"write_bytes\": " << io_write_bytes << " },\n";
+    out << "  \"audio_underruns\": " << underruns << "\n";
+    out << "}\n";
+
+    return out.good();
+}
+
+// The vblank pump the window loop normally provides - guest threads block
+// in sceDisplayWaitVblankStart on the display condvar and every set frame
+// buffer bumps total_frame_count. Runs until the frame or time limit, then
+// tears the guest down and logs the collected stats. A non-empty
+// benchmark_output additionally writes the machine-readable result file.
+static ExitCode run_headless(HostState &host, const uint64_t max_frames, const uint64_t max_seconds, const uint32_t turbo_multiplier, const std::string &benchmark_output) {
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t start_instructions = cpu_instructions_executed();
+
+    // Frame intervals are observed at pump resolution (~16.7 ms), so the
+    // percentiles quantize to vblank periods - exactly the granularity the
+    // guest presents at, and enough to spot dropped-frame regressions.
+    std::vector<float> frame_ms;
+    uint64_t last_frame_count = host.total_frame_count;
+    auto last_frame_time = start;
+
+    // The governor shortens the pump: turbo ticks at a multiple of 60 Hz,
+    // unlocked just keeps waking condvar sleepers while the waiters skip
+    // pacing entirely.
+    const uint64_t pump_us = host.display.unlocked_speed.load() ? 1000 : (16667 / std::max(turbo_multiplier, 1u));
+
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::microseconds(pump_us));
+        notify_vblank(host.display);
+
+        const uint64_t frame_count = host.total_frame_count;
+        if (frame_count > last_frame_count) {
+            const auto now = std::chrono::steady_clock::now();
+            const uint64_t delta = frame_count - last_frame_count;
+            const float ms = std::chrono::duration<float, std::milli>(now - last_frame_time).count() / delta;
+            frame_ms.insert(frame_ms.end(), delta, ms);
+            last_frame_count = frame_count;
+            last_frame_time = now;
+        }
+
+        if ((max_frames > 0) && (host.total_frame_count >= max_frames)) {
+            break;
+        }
+        if ((max_seconds > 0) && (std::chrono::steady_clock::now() - start >= std::chrono::seconds(max_seconds))) {
+            break;
+        }
+    }
+
+    const double seconds_run = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    stop_all_threads(host.kernel);
+    host.gxm.display_queue.abort();
+    host.display.abort.exchange(true);
+    host.display.condvar.notify_all();
+
+    uint64_t underruns = 0;
+    {
+        const std::shared_lock<std::shared_mutex> lock(host.audio.shared.mutex);
+        for (const AudioOutPortPtr &port : host.audio.shared.out_ports) {
+            if (port) {
+                underruns += port->stats.underruns;
+            }
+        }
+    }
+
+    const uint64_t instructions = cpu_instructions_executed() - start_instructions;
+    LOG_INFO("Headless run: {} frames in {:.1f} s ({:.1f} fps), {} draws, {:.1f} guest MIPS, {} audio underruns.",
+        host.total_frame_count, seconds_run,
+        (seconds_run > 0.0) ? (host.total_frame_count / seconds_run) : 0.0,
+        host.gxm.draw_count,
+        (seconds_run > 0.0) ? (instructions / seconds_run / 1e6) : 0.0,
+        underruns);
+
+    if (!benchmark_output.empty()) {
+        if (write_benchmark_results(host, benchmark_output, seconds_run, frame_ms, instructions, underruns)) {
+            LOG_INFO("Benchmark results written to {}.", benchmark_output);
+        } else {
+            LOG_ERROR("Could not write benchmark results to {}.", benchmark_output);
+            return IncorrectArgs;
+        }
+    }
+
+    return Success;
+}
 
 int main(int argc, char *argv[]) {
     init_logging();
@@ -38,19 +214,69 @@ int main(int argc, char *argv[]) {
 
     ProgramArgsWide argv_wide = process_args(argc, argv);
 
+    // Filter out switches and an argument that macOS Finder appends
+    bool stream_vpk = false;
+    bool headless = false;
+    bool cpu_bench = false;
+    bool unlocked_speed = false;
+    uint32_t turbo_multiplier = 1;
+    uint64_t headless_frames = 0;
+    uint64_t headless_seconds = 0;
+    std::string record_input_path;
+    std::string replay_input_path;
+    std::string benchmark_output;
+    const char *const *const path_arg = std::find_if_not(&argv[1], &argv[argc], [&stream_vpk, &headless, &cpu_bench, &unlocked_speed, &turbo_multiplier, &headless_frames, &headless_seconds, &record_input_path, &replay_input_path, &benchmark_output](const char *arg) {
+        if (strcmp(arg, "--stream") == 0) {
+            stream_vpk = true;
+            return true;
+        }
+        if (strcmp(arg, "--headless") == 0) {
+            headless = true;
+            return true;
+        }
+        if (strcmp(arg, "--cpu-bench") == 0) {
+            cpu_bench = true;
+            return true;
+        }
+        if (strncmp(arg, "--frames=", 9) == 0) {
+            headless_frames = strtoull(arg + 9, nullptr, 10);
+            return true;
+        }
+        if (strncmp(arg, "--seconds=", 10) == 0) {
+            headless_seconds = strtoull(arg + 10, nullptr, 10);
+            return true;
+        }
+        if (strncmp(arg, "--record-input=", 15) == 0) {
+            record_input_path = arg + 15;
+            return true;
+        }
+        if (strncmp(arg, "--replay-input=", 15) == 0) {
+            replay_input_path = arg + 15;
+            return true;
+        }
+        if (strncmp(arg, "--benchmark=", 12) == 0) {
+            benchmark_output = arg + 12;
+            return true;
+        }
+        if (strcmp(arg, "--unlocked") == 0) {
+            unlocked_speed = true;
+            return true;
+        }
+        if (strncmp(arg, "--turbo=", 8) == 0) {
+            turbo_multiplier = static_cast<uint32_t>(std::max<unsigned long>(1, strtoul(arg + 8, nullptr, 10)));
+            return true;
+        }
+        return strncmp(arg, "-psn_", 5) == 0;
+    });
+
     std::atexit(SDL_Quit);
-    if (SDL_Init(SDL_INIT_AUDIO | SDL_INIT_GAMECONTROLLER | SDL_INIT_VIDEO) < 0) {
+    if (SDL_Init(SDL_INIT_AUDIO | SDL_INIT_GAMECONTROLLER | (headless ? 0 : SDL_INIT_VIDEO)) < 0) {
         error_dialog("SDL initialisation failed.");
         return SDLInitFailed;
     }
 
     SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 
-    // Filter out an argument that macOS Finder appends
-    const char *const *const path_arg = std::find_if_not(&argv[1], &argv[argc], [](const char *arg) {
-        return strncmp(arg, "-psn_", 5) == 0;
-    });
-
     std::wstring path;
     if (path_arg != &argv[argc]) {
         path = utf_to_wide(*path_arg);
@@ -65,12 +291,74 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    // Benchmark mode is the headless pump plus telemetry and a result file;
+    // pair it with --replay-input and --frames/--seconds for runs the
+    // nightly harness can compare between builds.
+    if (!benchmark_output.empty()) {
+        headless = true;
+    }
+
     HostState host;
+    host.headless = headless;
+    if (!benchmark_output.empty()) {
+        host.io.telemetry.enabled = true;
+    }
+    host.display.unlocked_speed = unlocked_speed;
+    // Headless turbo comes from the pump rate below; setting the waiter
+    // multiplier as well would compound to turbo squared.
+    host.display.turbo_multiplier = headless ? 1 : turbo_multiplier;
+    if (unlocked_speed) {
+        // No vblank pacing means no point blocking producers on the display
+        // queue cap either.
+        host.gxm.pacing = DISPLAY_PACING_UNLOCKED;
+    }
+    if (!replay_input_path.empty()) {
+        host.ctrl.record_mode = CtrlRecordMode::replay;
+        host.ctrl.record_path = replay_input_path;
+    } else if (!record_input_path.empty()) {
+        host.ctrl.record_mode = CtrlRecordMode::record;
+        host.ctrl.record_path = record_input_path;
+    }
     if (!init(host)) {
         error_dialog("Host initialisation failed.", host.window.get());
         return HostInitFailed;
     }
 
+    // Needs no title, so it runs straight after init - pair it with
+    // --headless for a scriptable backend throughput check.
+    if (cpu_bench) {
+        const double mips = run_cpu_benchmark(host.kernel.cpu_backend, host.mem);
+        if (mips < 0.0) {
+            LOG_ERROR("CPU benchmark failed to run.");
+            return RunThreadFailed;
+        }
+        LOG_INFO("CPU benchmark: {:.1f} MIPS ({}).", mips,
+            (host.kernel.cpu_backend == CPUBackend::Dynarmic) ? "dynarmic" : "unicorn");
+        return Success;
+    }
+
+    if (headless) {
+        if (path.empty()) {
+            LOG_ERROR("Headless mode needs a title path on the command line.");
+            return IncorrectArgs;
+        }
+        if ((headless_frames == 0) && (headless_seconds == 0)) {
+            headless_seconds = 60;
+        }
+
+        // No window, so the loader runs right here - progress goes to the log.
+        Ptr<const void> entry_point;
+        const ExitCode load_result = load_app(entry_point, host, path, stream_vpk ? AppRunType::VpkStream : AppRunType::Vpk);
+        if (load_result != Success) {
+            return load_result;
+        }
+        if (auto err = run_app(host, entry_point) != Success) {
+            return err;
+        }
+
+        return run_headless(host, headless_frames, headless_seconds, turbo_multiplier, benchmark_output);
+    }
+
     imgui::init(host.window);
 
     auto run_type = AppRunType::Vpk;
@@ -86,37 +374,96 @@ int main(int argc, char *argv[]) {
 
     if (run_type == AppRunType::Extracted) {
         path = utf_to_wide(host.gui.game_selector.title_id);
+    } else if (stream_vpk) {
+        run_type = AppRunType::VpkStream;
     }
 
+    // Install/load runs on a background thread so the window keeps pumping
+    // events and drawing progress instead of freezing for the duration.
     Ptr<const void> entry_point;
-    if (auto err = load_app(entry_point, host, path, run_type) != Success)
-        return err;
+    ExitCode load_result = Success;
+    std::thread loader([&entry_point, &host, &path, run_type, &load_result]() {
+        load_result = load_app(entry_point, host, path, run_type);
+        host.boot_status.done = true;
+    });
+
+    bool window_open = true;
+    while (!host.boot_status.done && (window_open = handle_events(host))) {
+        imgui::draw_begin(host.window);
+
+        DrawUI(host);
+        DrawBootProgress(host);
+
+        imgui::draw_end(host.window);
+    }
+
+    if (!window_open) {
+        // Wake the loader if it is blocked on the reinstall prompt so it
+        // can shut down.
+        const std::lock_guard<std::mutex> lock(host.boot_status.mutex);
+        host.boot_status.reinstall_choice = -1;
+        host.boot_status.decision.notify_all();
+    }
+    loader.join();
+
+    if (!window_open)
+        return Success;
+
+    if (load_result != Success)
+        return load_result;
 
     if (auto err = run_app(host, entry_point) != Success)
         return err;
 
     gl_screen_renderer gl_renderer;
 
-    if (!gl_renderer.init(host.base_path))
+    if (!gl_renderer.init(host.base_path, host.pref_path))
         return RendererInitFailed;
 
+    auto last_loop = std::chrono::steady_clock::now();
+    auto last_ui_rebuild = last_loop;
+    uint32_t consecutive_skips = 0;
     while (handle_events(host)) {
+        const auto loop_start = std::chrono::steady_clock::now();
+        const uint64_t loop_us = std::chrono::duration_cast<std::chrono::microseconds>(loop_start - last_loop).count();
+        last_loop = loop_start;
+
         if (host.display.imgui_render) {
-            imgui::draw_begin(host.window);
+            // Widgets are only re-traversed on input or on the periodic
+            // refresh that keeps live counters and guest dialogs current;
+            // other frames replay the cached draw data under a fresh game
+            // image.
+            const bool refresh_due = (loop_start - last_ui_rebuild) >= std::chrono::milliseconds(100);
+            bool rebuild = host.gui.rebuild_requested.exchange(false) || refresh_due;
+            if (!rebuild && !imgui::draw_cached(host, gl_renderer.get_screen_texture(), host.window)) {
+                rebuild = true;
+            }
+            if (rebuild) {
+                imgui::draw_begin(host.window);
 
-            imgui::draw_main(host, gl_renderer.get_screen_texture());
+                imgui::draw_main(host, gl_renderer.get_screen_texture());
 
-            DrawUI(host);
-            DrawCommonDialog(host);
+                DrawUI(host);
+                DrawCommonDialog(host);
 
-            imgui::draw_end(host.window);
+                imgui::draw_end(host.window);
+                last_ui_rebuild = loop_start;
+            }
+        } else if (host.display.auto_frame_skip.load() && (loop_us > host.display.vblank_period_us.load())
+            && (consecutive_skips < 3)) {
+            // Behind the vblank period: skip the host present, capped so the
+            // screen never freezes outright. Simulation is untouched - the
+            // guest keeps its vblank below and presents into memory.
+            ++consecutive_skips;
+            ++host.display.skipped_presents;
         } else {
             gl_renderer.render(host.display, host.mem);
 
             SDL_GL_SwapWindow(host.window.get());
+            consecutive_skips = 0;
         }
 
-        host.display.condvar.notify_all();
+        notify_vblank(host.display);
 
         set_window_title(host);
     }
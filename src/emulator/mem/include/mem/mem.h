@@ -17,9 +17,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -27,16 +30,50 @@ typedef uint32_t Address;
 typedef size_t Generation;
 typedef std::unique_ptr<uint8_t[], std::function<void(uint8_t *)>> Memory;
 typedef std::vector<Generation> Allocated;
-typedef std::map<Generation, std::string> GenerationNames;
+typedef uint32_t NameId;
+// The transparent comparator lets interning look a literal up without
+// constructing a temporary std::string.
+typedef std::map<std::string, NameId, std::less<>> NameIds;
+typedef std::deque<std::string> Names; // id -> name, references stay stable
+typedef std::vector<NameId> GenerationNameIds; // generation -> interned name
+typedef std::map<Generation, size_t> GenerationSizes; // pages per live allocation
+// Runs of unallocated pages, indexed twice: by first page for address
+// lookups and splitting, and by size for best-fit allocation. The two views
+// always describe the same blocks.
+typedef std::map<size_t, size_t> FreeBlocks; // first page -> page count
+typedef std::multimap<size_t, size_t> FreeBlocksBySize; // page count -> first page
 
 struct MemState {
+    // Serializes the allocator's bookkeeping - the free lists, generation
+    // tables and interned names below. Guest threads allocate concurrently
+    // through HLE imports (memblocks, stacks, heap refills), which run with
+    // no global lock. Mutable so const diagnostics paths can take it.
+    mutable std::mutex mutex;
     size_t page_size = 0;
     Generation generation = 0;
     Memory memory;
     Allocated allocated_pages;
-    GenerationNames generation_names;
+    size_t used_pages = 0;
+    // Write tracking - tracked pages are write-protected and the first write
+    // to each stamps it with a fresh write generation via the fault handler.
+    std::atomic<uint64_t> write_generation{ 0 };
+    std::vector<uint64_t> page_write_generations;
+    std::vector<uint8_t> tracked_pages;
+    FreeBlocks free_blocks;
+    FreeBlocksBySize free_blocks_by_size;
+    NameIds name_ids;
+    Names names;
+    GenerationNameIds generation_name_ids;
+    GenerationSizes generation_sizes;
 };
 
+// True if the page holding address belongs to a live allocation. Cheap
+// enough for the checked Ptr dereference to call on every HLE argument.
+inline bool is_valid_address(const MemState &state, Address address) {
+    const size_t page = address / state.page_size;
+    return (page < state.allocated_pages.size()) && (state.allocated_pages[page] != 0);
+}
+
 constexpr size_t KB(size_t kb) {
     return kb * 1024;
 }
@@ -49,9 +86,28 @@ constexpr size_t GB(size_t gb) {
     return gb * MB(1024);
 }
 
-bool init(MemState &state);
+// huge_pages asks the host kernel to back the arena with huge pages to cut
+// TLB pressure; hosts that cannot honor it fall back to normal pages.
+bool init(MemState &state, bool huge_pages = false);
 Address alloc(MemState &state, size_t size, const char *name);
 Address alloc_at(MemState &state, Address address, size_t size, const char *name);
 void free(MemState &state, Address address);
 uint32_t mem_available(MemState &state);
 const char *mem_name(Address address, const MemState &state);
+
+// One aggregated row of the allocation report - all live allocations that
+// share a name, e.g. every thread stack or every block a module mapped.
+struct MemAllocationTotal {
+    std::string name;
+    size_t size = 0; // bytes
+};
+
+std::vector<MemAllocationTotal> mem_allocation_totals(const MemState &state);
+
+// Write tracking. Callers snapshot current_write_generation, arm the pages
+// they care about with track_writes, and later ask whether anything in the
+// range was written since the snapshot. A page reports each arming once -
+// re-arm after consuming a change to keep watching it.
+uint64_t current_write_generation(const MemState &state);
+void track_writes(MemState &state, Address address, size_t size);
+bool range_written_since(const MemState &state, Address address, size_t size, uint64_t generation);
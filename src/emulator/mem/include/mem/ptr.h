@@ -19,6 +19,10 @@
 
 #include <mem/mem.h>
 
+#ifdef MEM_PTR_CHECKS
+#include <cassert>
+#endif
+
 template <class T>
 class Ptr {
 public:
@@ -49,6 +53,11 @@ public:
         if (addr == 0) {
             return nullptr;
         } else {
+#ifdef MEM_PTR_CHECKS
+            // Bring-up builds validate every dereference; release builds
+            // compile this down to the add alone.
+            assert(is_valid_address(mem, addr));
+#endif
             return reinterpret_cast<T *>(&mem.memory[addr]);
         }
     }
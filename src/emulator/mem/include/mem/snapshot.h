@@ -0,0 +1,42 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <mem/mem.h>
+
+#include <map>
+#include <vector>
+
+// Incremental snapshot of the guest arena. The first capture copies every
+// allocated page; later captures into the same snapshot copy only pages the
+// write-tracking service stamped since, so refreshing a snapshot costs time
+// proportional to what the guest actually wrote, not 4GB.
+struct MemSnapshot {
+    uint64_t write_generation = 0; // tracking generation the pages are current to
+    std::map<size_t, std::vector<uint8_t>> pages; // page index -> contents
+    Allocated allocated_pages;
+    size_t used_pages = 0;
+    Generation generation = 0;
+    FreeBlocks free_blocks;
+    FreeBlocksBySize free_blocks_by_size;
+    GenerationNameIds generation_name_ids;
+    GenerationSizes generation_sizes;
+};
+
+void capture_snapshot(MemState &state, MemSnapshot &snapshot);
+void restore_snapshot(MemState &state, const MemSnapshot &snapshot);
@@ -27,10 +27,95 @@
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 #else
+#include <csignal>
 #include <sys/mman.h>
 #include <unistd.h>
 #endif
 
+// The fault handler has no context argument, so the (single) tracked arena
+// is reached through this pointer.
+static MemState *write_tracking_state = nullptr;
+
+// Returns true if the fault was a first write to a tracked page - the page
+// is stamped, unprotected and the faulting write can be retried.
+static bool handle_write_fault(uint8_t *fault_address) {
+    MemState *const state = write_tracking_state;
+    if (state == nullptr) {
+        return false;
+    }
+
+    uint8_t *const base = state->memory.get();
+    if ((fault_address < base) || (fault_address >= base + GB(4))) {
+        return false;
+    }
+
+    const size_t page = (fault_address - base) / state->page_size;
+    if (!state->tracked_pages[page]) {
+        return false;
+    }
+
+    state->tracked_pages[page] = 0;
+    state->page_write_generations[page] = ++state->write_generation;
+
+    uint8_t *const page_address = base + page * state->page_size;
+#ifdef WIN32
+    DWORD old_protect = 0;
+    VirtualProtect(page_address, state->page_size, PAGE_READWRITE, &old_protect);
+#else
+    mprotect(page_address, state->page_size, PROT_READ | PROT_WRITE);
+#endif
+
+    return true;
+}
+
+#ifdef WIN32
+static LONG CALLBACK write_fault_handler(PEXCEPTION_POINTERS exception) {
+    if (exception->ExceptionRecord->ExceptionCode != EXCEPTION_ACCESS_VIOLATION) {
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+    const bool is_write = exception->ExceptionRecord->ExceptionInformation[0] == 1;
+    uint8_t *const fault_address = reinterpret_cast<uint8_t *>(exception->ExceptionRecord->ExceptionInformation[1]);
+    if (!is_write || !handle_write_fault(fault_address)) {
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+
+    return EXCEPTION_CONTINUE_EXECUTION;
+}
+#else
+static struct sigaction previous_segv_action;
+
+static void write_fault_handler(int signal_number, siginfo_t *info, void *context) {
+    if (handle_write_fault(static_cast<uint8_t *>(info->si_addr))) {
+        return;
+    }
+
+    // Not ours - hand the fault to whoever was installed before us.
+    if (previous_segv_action.sa_flags & SA_SIGINFO) {
+        previous_segv_action.sa_sigaction(signal_number, info, context);
+    } else if ((previous_segv_action.sa_handler != SIG_IGN) && (previous_segv_action.sa_handler != SIG_DFL)) {
+        previous_segv_action.sa_handler(signal_number);
+    } else {
+        signal(signal_number, SIG_DFL);
+        raise(signal_number);
+    }
+}
+#endif
+
+static void install_write_fault_handler(MemState &state) {
+    write_tracking_state = &state;
+#ifdef WIN32
+    AddVectoredExceptionHandler(1, &write_fault_handler);
+#else
+    struct sigaction action = {};
+    action.sa_sigaction = &write_fault_handler;
+    action.sa_flags = SA_SIGINFO;
+    sigaction(SIGSEGV, &action, &previous_segv_action);
+#ifdef __APPLE__
+    sigaction(SIGBUS, &action, nullptr);
+#endif
+#endif
+}
+
 static void delete_memory(uint8_t *memory) {
     if (memory != nullptr) {
 #ifdef WIN32
@@ -42,13 +127,50 @@ static void delete_memory(uint8_t *memory) {
     }
 }
 
+// Allocation names are almost always the same few literals, so they are
+// interned once and the hot path only stores an id.
+static NameId intern_name(MemState &state, const char *name) {
+    const NameIds::const_iterator existing = state.name_ids.find(name);
+    if (existing != state.name_ids.end()) {
+        return existing->second;
+    }
+
+    const NameId id = static_cast<NameId>(state.names.size());
+    state.names.push_back(name);
+    state.name_ids.emplace(state.names.back(), id);
+
+    return id;
+}
+
 static void alloc_inner(MemState &state, Address address, size_t page_count, Allocated::iterator block, const char *name) {
     uint8_t *const memory = &state.memory[address];
     const size_t aligned_size = page_count * state.page_size;
 
+    // Keep the running counters exact even when alloc_at re-tags pages that
+    // already belong to another allocation.
+    const size_t first_page = address / state.page_size;
+    for (size_t i = 0; i < page_count; ++i) {
+        // The zeroing below writes the page, so stamp it and drop tracking.
+        state.tracked_pages[first_page + i] = 0;
+        state.page_write_generations[first_page + i] = ++state.write_generation;
+
+        const Generation owner = block[i];
+        if (owner == 0) {
+            ++state.used_pages;
+        } else {
+            const GenerationSizes::iterator owner_size = state.generation_sizes.find(owner);
+            assert(owner_size != state.generation_sizes.end());
+            --owner_size->second;
+        }
+    }
+
     const Generation generation = ++state.generation;
     std::fill_n(block, page_count, generation);
-    state.generation_names[generation] = name;
+    if (state.generation_name_ids.size() <= generation) {
+        state.generation_name_ids.resize(generation + 1);
+    }
+    state.generation_name_ids[generation] = intern_name(state, name);
+    state.generation_sizes[generation] = page_count;
 
 #ifdef WIN32
     const void *const ret = VirtualAlloc(memory, aligned_size, MEM_COMMIT, PAGE_READWRITE);
@@ -59,7 +181,69 @@ static void alloc_inner(MemState &state, Address address, size_t page_count, All
     std::memset(memory, 0, aligned_size);
 }
 
-bool init(MemState &state) {
+static void add_free_block(MemState &state, size_t first_page, size_t page_count) {
+    state.free_blocks[first_page] = page_count;
+    state.free_blocks_by_size.emplace(page_count, first_page);
+}
+
+static void remove_free_block(MemState &state, FreeBlocks::iterator block) {
+    const auto matching_size = state.free_blocks_by_size.equal_range(block->second);
+    for (FreeBlocksBySize::iterator entry = matching_size.first; entry != matching_size.second; ++entry) {
+        if (entry->second == block->first) {
+            state.free_blocks_by_size.erase(entry);
+            break;
+        }
+    }
+    state.free_blocks.erase(block);
+}
+
+// Remove [first_page, first_page + page_count) from any free blocks it
+// overlaps, splitting the neighbors that extend beyond the range.
+static void carve_free_pages(MemState &state, size_t first_page, size_t page_count) {
+    const size_t last_page = first_page + page_count;
+
+    FreeBlocks::iterator block = state.free_blocks.upper_bound(first_page);
+    if (block != state.free_blocks.begin()) {
+        --block;
+    }
+
+    while ((block != state.free_blocks.end()) && (block->first < last_page)) {
+        const size_t block_first = block->first;
+        const size_t block_last = block_first + block->second;
+        const FreeBlocks::iterator next = std::next(block);
+
+        if (block_last > first_page) {
+            remove_free_block(state, block);
+            if (block_first < first_page) {
+                add_free_block(state, block_first, first_page - block_first);
+            }
+            if (block_last > last_page) {
+                add_free_block(state, last_page, block_last - last_page);
+            }
+        }
+
+        block = next;
+    }
+}
+
+static void enable_huge_pages(uint8_t *memory, size_t length) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // Transparent huge pages - the kernel upgrades the backing as the arena
+    // is touched, and quietly keeps 4KiB pages if it cannot.
+    const int ret = madvise(memory, length, MADV_HUGEPAGE);
+    if (ret != 0) {
+        LOG_WARN("madvise(MADV_HUGEPAGE) failed - falling back to normal pages.");
+    }
+#else
+    // Windows large pages need SeLockMemoryPrivilege and up-front commit,
+    // which does not fit the lazy per-page commit the allocator relies on.
+    (void)memory;
+    (void)length;
+    LOG_WARN("Huge-page backing is not supported on this host - using normal pages.");
+#endif
+}
+
+bool init(MemState &state, bool huge_pages) {
 #ifdef WIN32
     SYSTEM_INFO system_info = {};
     GetSystemInfo(&system_info);
@@ -86,7 +270,15 @@ bool init(MemState &state) {
         return false;
     }
 
+    if (huge_pages) {
+        enable_huge_pages(state.memory.get(), length);
+    }
+
     state.allocated_pages.resize(length / state.page_size);
+    state.page_write_generations.resize(length / state.page_size);
+    state.tracked_pages.resize(length / state.page_size);
+    add_free_block(state, 0, length / state.page_size);
+    install_write_fault_handler(state);
     const Address null_address = alloc(state, 1, "NULL");
     assert(null_address == 0);
 #ifdef WIN32
@@ -102,15 +294,26 @@ bool init(MemState &state) {
 }
 
 Address alloc(MemState &state, size_t size, const char *name) {
+    const std::lock_guard<std::mutex> lock(state.mutex);
+
     const size_t page_count = (size + (state.page_size - 1)) / state.page_size;
-    const Allocated::iterator block = std::search_n(state.allocated_pages.begin(), state.allocated_pages.end(), page_count, 0);
-    if (block == state.allocated_pages.end()) {
+
+    // Best fit - the smallest free block that covers the request.
+    const FreeBlocksBySize::iterator best_fit = state.free_blocks_by_size.lower_bound(page_count);
+    if (best_fit == state.free_blocks_by_size.end()) {
         assert(false);
         return 0;
     }
 
-    const size_t block_page_index = block - state.allocated_pages.begin();
+    const size_t block_page_index = best_fit->second;
+    const size_t block_page_count = best_fit->first;
+    remove_free_block(state, state.free_blocks.find(block_page_index));
+    if (block_page_count > page_count) {
+        add_free_block(state, block_page_index + page_count, block_page_count - page_count);
+    }
+
     const Address address = static_cast<Address>(block_page_index * state.page_size);
+    const Allocated::iterator block = state.allocated_pages.begin() + block_page_index;
 
     alloc_inner(state, address, page_count, block, name);
 
@@ -118,15 +321,32 @@ Address alloc(MemState &state, size_t size, const char *name) {
 }
 
 Address alloc_at(MemState &state, Address address, size_t size, const char *name) {
+    const std::lock_guard<std::mutex> lock(state.mutex);
+
     const size_t page_count = (size + (state.page_size - 1)) / state.page_size;
-    const Allocated::iterator block = state.allocated_pages.begin() + (address / state.page_size);
+    const size_t first_page = address / state.page_size;
+    const Allocated::iterator block = state.allocated_pages.begin() + first_page;
 
+    // Overlapping a live allocation is tolerated - consecutive module
+    // segments legitimately share boundary pages - but worth reporting,
+    // since anything else points at a loader or guest bug.
+    for (size_t page = first_page; page < first_page + page_count; ++page) {
+        if (state.allocated_pages[page] != 0) {
+            const Address overlap = static_cast<Address>(page * state.page_size);
+            LOG_WARN("alloc_at {} ({} bytes, {}) overlaps live allocation {} at {}", log_hex(address), size, name, mem_name(overlap, state), log_hex(overlap));
+            break;
+        }
+    }
+
+    carve_free_pages(state, first_page, page_count);
     alloc_inner(state, address, page_count, block, name);
 
     return address;
 }
 
 void free(MemState &state, Address address) {
+    const std::lock_guard<std::mutex> lock(state.mutex);
+
     const size_t page = address / state.page_size;
     assert(page >= 0);
     assert(page < state.allocated_pages.size());
@@ -139,21 +359,103 @@ void free(MemState &state, Address address) {
     const Allocated::iterator last_page = std::find_if(first_page, state.allocated_pages.end(), different_generation);
     std::fill(first_page, last_page, 0);
 
+    const size_t run_length = last_page - first_page;
+    state.used_pages -= run_length;
+    state.generation_sizes.erase(generation);
+
+    // Coalesce with free neighbors so long sessions do not shatter the
+    // address space into unusable slivers.
+    size_t free_first = page;
+    size_t free_count = run_length;
+
+    const FreeBlocks::iterator after = state.free_blocks.lower_bound(page);
+    if (after != state.free_blocks.begin()) {
+        const FreeBlocks::iterator before = std::prev(after);
+        if (before->first + before->second == free_first) {
+            free_first = before->first;
+            free_count += before->second;
+            remove_free_block(state, before);
+        }
+    }
+
+    const FreeBlocks::iterator next = state.free_blocks.find(page + run_length);
+    if (next != state.free_blocks.end()) {
+        free_count += next->second;
+        remove_free_block(state, next);
+    }
+
+    add_free_block(state, free_first, free_count);
+
     // TODO Decommit/protect freed memory.
 }
 
 uint32_t mem_available(MemState &state) {
-    const size_t page_count = 1;
-    const Allocated::iterator block = std::search_n(state.allocated_pages.begin(), state.allocated_pages.end(), page_count, 0);
-    if (block == state.allocated_pages.end()) {
-        assert(false);
-        return 0;
+    const std::lock_guard<std::mutex> lock(state.mutex);
+
+    const size_t free_pages = state.allocated_pages.size() - state.used_pages;
+
+    return static_cast<uint32_t>(free_pages * state.page_size);
+}
+
+std::vector<MemAllocationTotal> mem_allocation_totals(const MemState &state) {
+    const std::lock_guard<std::mutex> lock(state.mutex);
+
+    // Aggregate by name - the dozen or so distinct names cover thousands of
+    // generations. Diagnostics path, so the temporary map is fine.
+    std::map<NameId, size_t> totals_by_name;
+    for (const GenerationSizes::value_type &generation_size : state.generation_sizes) {
+        assert(generation_size.first < state.generation_name_ids.size());
+        totals_by_name[state.generation_name_ids[generation_size.first]] += generation_size.second * state.page_size;
+    }
+
+    std::vector<MemAllocationTotal> totals;
+    totals.reserve(totals_by_name.size());
+    for (const std::map<NameId, size_t>::value_type &total : totals_by_name) {
+        totals.push_back({ state.names[total.first], total.second });
     }
 
-    const size_t block_page_index = block - state.allocated_pages.begin();
-    const Address address = GB(4) - static_cast<Address>(block_page_index * state.page_size);
+    std::sort(totals.begin(), totals.end(), [](const MemAllocationTotal &a, const MemAllocationTotal &b) {
+        return a.size > b.size;
+    });
 
-    return address;
+    return totals;
+}
+
+uint64_t current_write_generation(const MemState &state) {
+    return state.write_generation;
+}
+
+void track_writes(MemState &state, Address address, size_t size) {
+    const size_t first_page = address / state.page_size;
+    const size_t page_count = (size + (address % state.page_size) + (state.page_size - 1)) / state.page_size;
+    assert(first_page + page_count <= state.tracked_pages.size());
+
+    for (size_t page = first_page; page < first_page + page_count; ++page) {
+        state.tracked_pages[page] = 1;
+    }
+
+    uint8_t *const first_page_address = &state.memory[static_cast<Address>(first_page * state.page_size)];
+#ifdef WIN32
+    DWORD old_protect = 0;
+    const BOOL ret = VirtualProtect(first_page_address, page_count * state.page_size, PAGE_READONLY, &old_protect);
+    assert(ret);
+#else
+    mprotect(first_page_address, page_count * state.page_size, PROT_READ);
+#endif
+}
+
+bool range_written_since(const MemState &state, Address address, size_t size, uint64_t generation) {
+    const size_t first_page = address / state.page_size;
+    const size_t page_count = (size + (address % state.page_size) + (state.page_size - 1)) / state.page_size;
+    assert(first_page + page_count <= state.page_write_generations.size());
+
+    for (size_t page = first_page; page < first_page + page_count; ++page) {
+        if (state.page_write_generations[page] > generation) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 const char *mem_name(Address address, const MemState &state) {
@@ -166,11 +468,9 @@ const char *mem_name(Address address, const MemState &state) {
         return "UNALLOCATED";
     }
 
-    const GenerationNames::const_iterator found = state.generation_names.find(generation);
-    assert(found != state.generation_names.end());
-    if (found == state.generation_names.end()) {
+    if (generation >= state.generation_name_ids.size()) {
         return "UNNAMED";
     }
 
-    return found->second.c_str();
+    return state.names[state.generation_name_ids[generation]].c_str();
 }
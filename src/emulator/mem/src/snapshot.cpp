@@ -0,0 +1,90 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <mem/snapshot.h>
+
+#include <cassert>
+#include <cstring>
+
+static bool page_needs_capture(const MemState &state, const MemSnapshot &snapshot, size_t page) {
+    if (state.allocated_pages[page] == 0) {
+        return false;
+    }
+    if (snapshot.write_generation == 0) {
+        // First capture - take everything that is allocated.
+        return true;
+    }
+
+    return state.page_write_generations[page] > snapshot.write_generation;
+}
+
+void capture_snapshot(MemState &state, MemSnapshot &snapshot) {
+    const size_t page_count = state.allocated_pages.size();
+
+    for (size_t page = 0; page < page_count; ++page) {
+        if (!page_needs_capture(state, snapshot, page)) {
+            continue;
+        }
+
+        std::vector<uint8_t> &contents = snapshot.pages[page];
+        contents.resize(state.page_size);
+        std::memcpy(contents.data(), &state.memory[static_cast<Address>(page * state.page_size)], state.page_size);
+    }
+
+    // Drop pages that were freed since the last capture.
+    for (std::map<size_t, std::vector<uint8_t>>::iterator page = snapshot.pages.begin(); page != snapshot.pages.end();) {
+        if (state.allocated_pages[page->first] == 0) {
+            page = snapshot.pages.erase(page);
+        } else {
+            ++page;
+        }
+    }
+
+    snapshot.write_generation = state.write_generation;
+    snapshot.allocated_pages = state.allocated_pages;
+    snapshot.used_pages = state.used_pages;
+    snapshot.generation = state.generation;
+    snapshot.free_blocks = state.free_blocks;
+    snapshot.free_blocks_by_size = state.free_blocks_by_size;
+    snapshot.generation_name_ids = state.generation_name_ids;
+    snapshot.generation_sizes = state.generation_sizes;
+
+    // Arm tracking on the captured pages so the next capture only has to
+    // revisit what the guest writes from here on.
+    for (const std::map<size_t, std::vector<uint8_t>>::value_type &page : snapshot.pages) {
+        track_writes(state, static_cast<Address>(page.first * state.page_size), state.page_size);
+    }
+}
+
+void restore_snapshot(MemState &state, const MemSnapshot &snapshot) {
+    assert(snapshot.write_generation != 0); // capture before restoring
+
+    // Pages allocated after the capture go back to being unreachable; their
+    // contents do not matter, only the bookkeeping does.
+    for (const std::map<size_t, std::vector<uint8_t>>::value_type &page : snapshot.pages) {
+        uint8_t *const destination = &state.memory[static_cast<Address>(page.first * state.page_size)];
+        std::memcpy(destination, page.second.data(), state.page_size);
+    }
+
+    state.allocated_pages = snapshot.allocated_pages;
+    state.used_pages = snapshot.used_pages;
+    state.generation = snapshot.generation;
+    state.free_blocks = snapshot.free_blocks;
+    state.free_blocks_by_size = snapshot.free_blocks_by_size;
+    state.generation_name_ids = snapshot.generation_name_ids;
+    state.generation_sizes = snapshot.generation_sizes;
+}
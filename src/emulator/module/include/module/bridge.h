@@ -26,27 +26,44 @@
 
 #include <microprofile.h>
 
-// Function returns a value that is written to CPU registers.
+#include <algorithm>
+#include <chrono>
+
+// Function returns a value that is written to CPU registers. The argument
+// extraction plan is baked into each read instantiation at compile time, so
+// no layout is carried through the bridge at run time.
 template <typename Ret, typename... Args, size_t... indices>
-void call(Ret (*export_fn)(HostState &, SceUID, const char *, Args...), const char *export_name, const ArgsLayout<Args...> &args_layout, std::index_sequence<indices...>, SceUID thread_id, CPUState &cpu, HostState &host) {
-    const Ret ret = (*export_fn)(host, thread_id, export_name, read<Args, indices, Args...>(cpu, args_layout, host.mem)...);
+void call(Ret (*export_fn)(HostState &, SceUID, const char *, Args...), const char *export_name, std::index_sequence<indices...>, SceUID thread_id, CPUState &cpu, HostState &host) {
+    const Ret ret = (*export_fn)(host, thread_id, export_name, read<Args, indices, Args...>(cpu, host.mem)...);
     write_return_value(cpu, ret);
 }
 
 // Function does not return a value.
 template <typename... Args, size_t... indices>
-void call(void (*export_fn)(HostState &, SceUID, const char *, Args...), const char *export_name, const ArgsLayout<Args...> &args_layout, std::index_sequence<indices...>, SceUID thread_id, CPUState &cpu, HostState &host) {
-    (*export_fn)(host, thread_id, export_name, read<Args, indices, Args...>(cpu, args_layout, host.mem)...);
+void call(void (*export_fn)(HostState &, SceUID, const char *, Args...), const char *export_name, std::index_sequence<indices...>, SceUID thread_id, CPUState &cpu, HostState &host) {
+    (*export_fn)(host, thread_id, export_name, read<Args, indices, Args...>(cpu, host.mem)...);
 }
 
+// Body of one trampoline. Each BRIDGE_IMPL wraps this in a named static
+// function with the export baked in as a constant, so the layout analysis
+// above is done once per signature at compile time and a call site reuses
+// the same compiled marshaling code every time.
 template <typename Ret, typename... Args>
-ImportFn bridge(Ret (*export_fn)(HostState &, SceUID, const char *, Args...), const char *export_name) {
-    constexpr ArgsLayout<Args...> args_layout = lay_out<typename BridgeTypes<Args>::ArmType...>();
+void bridge_call(Ret (*export_fn)(HostState &, SceUID, const char *, Args...), const char *export_name, HostState &host, CPUState &cpu, SceUID thread_id) {
+    MICROPROFILE_SCOPEI("HLE", export_name, MP_YELLOW);
 
-    return [export_fn, export_name, args_layout](HostState &host, CPUState &cpu, SceUID thread_id) {
-        MICROPROFILE_SCOPEI("HLE", export_name, MP_YELLOW);
+    using Indices = std::index_sequence_for<Args...>;
+    if (host.hle_telemetry.enabled) {
+        const auto start = std::chrono::steady_clock::now();
+        call(export_fn, export_name, Indices(), thread_id, cpu, host);
+        const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
 
-        using Indices = std::index_sequence_for<Args...>;
-        call(export_fn, export_name, args_layout, Indices(), thread_id, cpu, host);
-    };
+        const std::lock_guard<std::mutex> lock(host.hle_telemetry.mutex);
+        ImportCallStats &stats = host.hle_telemetry.imports[export_name];
+        stats.calls++;
+        stats.total_ns += ns;
+        stats.worst_ns = std::max(stats.worst_ns, ns);
+    } else {
+        call(export_fn, export_name, Indices(), thread_id, cpu, host);
+    }
 }
@@ -23,6 +23,12 @@
 #include <host/state.h>
 
 #include <cassert>
+#include <map>
+#include <string>
+
+// Snapshot of per-export stub call counts, keyed by export name.
+typedef std::map<std::string, std::uint64_t> StubCallCounts;
+StubCallCounts stub_call_counts();
 
 int unimplemented_impl(const char *name);
 #define UNIMPLEMENTED() unimplemented_impl(export_name)
@@ -33,7 +39,14 @@ int stubbed_impl(const char *name, const char *info);
 int ret_error_impl(const char *name, const char *error_str, std::uint32_t error_val);
 #define RET_ERROR(error) ret_error_impl(export_name, #error, error)
 
+// The bridge objects are constexpr so every one of them - and the resolver
+// tables built from their addresses - is constant-initialized into the
+// read-only segment, with no dynamic initializers run before main.
 #define BRIDGE_DECL(name) extern const ImportFn import_##name;
-#define BRIDGE_IMPL(name) const ImportFn import_##name = bridge(&export_##name, #name);
+#define BRIDGE_IMPL(name)                                                        \
+    static void bridge_##name(HostState &host, CPUState &cpu, SceUID thread_id) { \
+        bridge_call(&export_##name, #name, host, cpu, thread_id);                 \
+    }                                                                             \
+    constexpr ImportFn import_##name = &bridge_##name;
 
 #define EXPORT(ret, name, ...) ret export_##name(HostState &host, SceUID thread_id, const char *export_name, ##__VA_ARGS__)
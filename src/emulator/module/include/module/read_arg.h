@@ -19,55 +19,55 @@
 
 #include "args_layout.h"
 #include "bridge_types.h"
+#include "lay_out_args.h"
 
 #include <cpu/functions.h>
 
 // Read 32-bit (or smaller) values from a single register.
-template <typename T>
-std::enable_if_t<sizeof(T) <= 4, T> read_from_gpr(CPUState &cpu, const ArgLayout &arg) {
-    const uint32_t reg = read_reg(cpu, arg.offset);
+template <typename T, size_t reg_index>
+std::enable_if_t<sizeof(T) <= 4, T> read_from_gpr(CPUState &cpu) {
+    const uint32_t reg = read_reg(cpu, reg_index);
     return static_cast<T>(reg);
 }
 
 // Read 64-bit values from 2 registers.
-template <typename T>
-std::enable_if_t<sizeof(T) == 8, T> read_from_gpr(CPUState &cpu, const ArgLayout &arg) {
-    const uint64_t lo32 = read_reg(cpu, arg.offset);
-    const uint64_t hi32 = read_reg(cpu, arg.offset + 1);
+template <typename T, size_t reg_index>
+std::enable_if_t<sizeof(T) == 8, T> read_from_gpr(CPUState &cpu) {
+    const uint64_t lo32 = read_reg(cpu, reg_index);
+    const uint64_t hi32 = read_reg(cpu, reg_index + 1);
     const uint64_t both = lo32 | (hi32 << 32);
     return static_cast<T>(both);
 }
 
 // Read float value from register.
-template <typename T>
-T read_from_fp(CPUState &cpu, const ArgLayout &arg) {
-    const float reg = read_float_reg(cpu, arg.offset);
+template <typename T, size_t reg_index>
+T read_from_fp(CPUState &cpu) {
+    const float reg = read_float_reg(cpu, reg_index);
     return static_cast<T>(reg);
 }
 
-// Read variable from register or stack, as specified by arg layout.
-template <typename T>
-T read(CPUState &cpu, const ArgLayout &arg, const MemState &mem) {
-    switch (arg.location) {
-    case ArgLocation::gpr:
-        return read_from_gpr<T>(cpu, arg);
-    case ArgLocation::stack: {
+// Read one argument of a bridged call. Signatures are fixed, so the whole
+// layout is recomputed as a constant expression here and the argument's
+// location and offset dispatch with if constexpr - each read compiles down
+// to the direct register or stack access, with no layout consulted at call
+// time.
+template <typename Arg, size_t index, typename... Args>
+Arg read(CPUState &cpu, const MemState &mem) {
+    using ArmType = typename BridgeTypes<Arg>::ArmType;
+
+    constexpr ArgsLayout<Args...> layout = lay_out<typename BridgeTypes<Args>::ArmType...>();
+    constexpr ArgLayout arg = layout[index];
+
+    ArmType bridged = ArmType();
+    if constexpr (arg.location == ArgLocation::gpr) {
+        bridged = read_from_gpr<ArmType, arg.offset>(cpu);
+    } else if constexpr (arg.location == ArgLocation::stack) {
         const Address sp = read_sp(cpu);
         const Address address_on_stack = static_cast<Address>(sp + arg.offset);
-        return *Ptr<T>(address_on_stack).get(mem);
-    }
-    case ArgLocation::fp:
-        if constexpr (std::is_same_v<T, float>)
-            return read_from_fp<T>(cpu, arg);
+        bridged = *Ptr<ArmType>(address_on_stack).get(mem);
+    } else if constexpr (std::is_same_v<ArmType, float>) {
+        bridged = read_from_fp<ArmType, arg.offset>(cpu);
     }
 
-    return T();
-}
-
-template <typename Arg, size_t index, typename... Args>
-Arg read(CPUState &cpu, const ArgsLayout<Args...> &args, const MemState &mem) {
-    using ArmType = typename BridgeTypes<Arg>::ArmType;
-
-    const ArmType bridged = read<ArmType>(cpu, args[index], mem);
     return BridgeTypes<Arg>::arm_to_host(bridged, mem);
 }
@@ -20,51 +20,63 @@
 
 #include <iostream>
 #include <mutex>
-#include <set>
 
-typedef std::set<std::string> NameSet;
+// Titles call stubbed exports in tight loops - one unimplemented
+// sceTouchPeek per frame is 3600 log lines a minute. Log the first few
+// calls of each export, then only a periodic summary with the running
+// count. Counts keep accumulating either way and can be queried to see
+// what a title actually needs.
+static constexpr std::uint64_t STUB_LOG_FIRST = 5;
+static constexpr std::uint64_t STUB_LOG_EVERY = 100000;
 
 static std::mutex mutex;
-static NameSet logged;
+static StubCallCounts counts;
 
-int unimplemented_impl(const char *name) {
-    bool inserted = false;
-    {
-        const std::lock_guard<std::mutex> lock(mutex);
-        inserted = logged.insert(name).second;
-    }
+static bool should_log(const char *name, std::uint64_t &count) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    count = ++counts[name];
+    return (count <= STUB_LOG_FIRST) || ((count % STUB_LOG_EVERY) == 0);
+}
 
-    if (inserted) {
-        LOG_WARN("Unimplemented {} import called.", name);
+StubCallCounts stub_call_counts() {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return counts;
+}
+
+int unimplemented_impl(const char *name) {
+    std::uint64_t count = 0;
+    if (should_log(name, count)) {
+        if (count <= STUB_LOG_FIRST) {
+            LOG_WARN("Unimplemented {} import called.", name);
+        } else {
+            LOG_WARN("Unimplemented {} import called {} times so far.", name, count);
+        }
     }
 
     return 0;
 }
 
 int stubbed_impl(const char *name, const char *info) {
-    bool inserted = false;
-    {
-        const std::lock_guard<std::mutex> lock(mutex);
-        inserted = logged.insert(name).second;
-    }
-
-    if (inserted) {
-        LOG_WARN("Stubbed {} import called. ({})", name, info);
+    std::uint64_t count = 0;
+    if (should_log(name, count)) {
+        if (count <= STUB_LOG_FIRST) {
+            LOG_WARN("Stubbed {} import called. ({})", name, info);
+        } else {
+            LOG_WARN("Stubbed {} import called {} times so far. ({})", name, count, info);
+        }
     }
 
     return 0;
 }
 
 int ret_error_impl(const char *name, const char *error_str, std::uint32_t error_val) {
-    bool inserted = false;
-
-    {
-        const std::lock_guard<std::mutex> lock(mutex);
-        inserted = logged.insert(name).second;
-    }
-
-    if (inserted) {
-        LOG_ERROR("{} returned {} ({})", name, error_str, log_hex(error_val));
+    std::uint64_t count = 0;
+    if (should_log(name, count)) {
+        if (count <= STUB_LOG_FIRST) {
+            LOG_ERROR("{} returned {} ({})", name, error_str, log_hex(error_val));
+        } else {
+            LOG_ERROR("{} returned {} ({}) {} times so far.", name, error_str, log_hex(error_val), count);
+        }
     }
 
     return error_val;
@@ -23,6 +23,23 @@ static bool operator==(const ArgLayout &a, const ArgLayout &b) {
     return (a.location == b.location) && (a.offset == b.offset);
 }
 
+// The bridge relies on layouts being constant expressions - read<> bakes
+// each argument's location and offset into its instantiation. These mirror
+// the runtime cases below and fail the build, not the test run, if layout
+// computation stops being constexpr or regresses.
+constexpr bool layout_is(const ArgLayout &arg, ArgLocation location, size_t offset) {
+    return (arg.location == location) && (arg.offset == offset);
+}
+
+static_assert(layout_is(lay_out<int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t>()[3], ArgLocation::gpr, 3), "fourth word argument goes in r3");
+static_assert(layout_is(lay_out<int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t>()[4], ArgLocation::stack, 0), "fifth word argument overflows to the stack");
+static_assert(layout_is(lay_out<int64_t, int32_t>()[0], ArgLocation::gpr, 0), "leading dword takes r0:r1");
+static_assert(layout_is(lay_out<int64_t, int32_t>()[1], ArgLocation::gpr, 2), "word after a dword lands in r2");
+static_assert(layout_is(lay_out<int32_t, int64_t>()[1], ArgLocation::gpr, 2), "dword is aligned to an even register pair");
+static_assert(layout_is(lay_out<int32_t, int64_t, int32_t>()[2], ArgLocation::stack, 0), "register wasted by dword alignment is not refilled");
+static_assert(layout_is(lay_out<float, int32_t>()[0], ArgLocation::fp, 0), "float goes to a VFP register");
+static_assert(layout_is(lay_out<float, int32_t>()[1], ArgLocation::gpr, 0), "float does not consume a gpr");
+
 static std::ostream &operator<<(std::ostream &out, const ArgLayout &layout) {
     switch (layout.location) {
     case ArgLocation::gpr:
@@ -23,6 +23,13 @@
 #include <host/app_util.h>
 #include <io/functions.h>
 
+// The savedata0: root itself is resolved once by the io path cache; the
+// per-slot metadata below is cached here so repeated slot queries skip the
+// open/read/close round trip entirely.
+static std::string slot_param_path(unsigned int slot_id) {
+    return "savedata0:/SlotParam_" + std::to_string(slot_id) + ".bin";
+}
+
 EXPORT(int, sceAppUtilAddCookieWebBrowser) {
     return UNIMPLEMENTED();
 }
@@ -155,10 +162,10 @@ EXPORT(int, sceAppUtilSaveDataDataRemove, emu::SceAppUtilSaveDataFileSlot *slot,
     }
 
     if (files[0].mode == SCE_APPUTIL_SAVEDATA_DATA_REMOVE_MODE_DEFAULT) {
-        std::string slot_path = "savedata0:/SlotParam_";
-        slot_path += std::to_string(slot->id);
-        slot_path += ".bin";
-        remove_file(host.io, slot_path.c_str(), host.pref_path.c_str(), export_name);
+        remove_file(host.io, slot_param_path(slot->id).c_str(), host.pref_path.c_str(), export_name);
+
+        const std::lock_guard<std::mutex> lock(host.savedata_slots.mutex);
+        host.savedata_slots.slots[slot->id] = SaveDataSlotEntry();
     }
     return 0;
 }
@@ -188,12 +195,16 @@ EXPORT(int, sceAppUtilSaveDataDataSave, emu::SceAppUtilSaveDataFileSlot *slot, e
         }
     }
 
-    std::string slot_path = "savedata0:/SlotParam_";
-    slot_path += std::to_string(slot->id);
-    slot_path += ".bin";
-    fd = open_file(host.io, slot_path, SCE_O_WRONLY | SCE_O_CREAT, host.pref_path.c_str(), export_name);
+    fd = open_file(host.io, slot_param_path(slot->id), SCE_O_WRONLY | SCE_O_CREAT, host.pref_path.c_str(), export_name);
     write_file(fd, &slot->slotParam, sizeof(SceAppUtilSaveDataSlotParam), host.io, export_name);
     close_file(host.io, fd, export_name);
+
+    // The file changed without going through a param pointer we can cache
+    // from; drop the entry so the next query re-reads it.
+    {
+        const std::lock_guard<std::mutex> lock(host.savedata_slots.mutex);
+        host.savedata_slots.slots.erase(slot->id);
+    }
     return 0;
 }
 
@@ -206,32 +217,50 @@ EXPORT(int, sceAppUtilSaveDataMount) {
 }
 
 EXPORT(int, sceAppUtilSaveDataSlotCreate, unsigned int slotId, SceAppUtilSaveDataSlotParam *param, SceAppUtilSaveDataMountPoint *mountPoint) {
-    std::string slot_path = "savedata0:/SlotParam_";
-    slot_path += std::to_string(slotId);
-    slot_path += ".bin";
-    SceUID fd = open_file(host.io, slot_path, SCE_O_WRONLY | SCE_O_CREAT, host.pref_path.c_str(), export_name);
+    SceUID fd = open_file(host.io, slot_param_path(slotId), SCE_O_WRONLY | SCE_O_CREAT, host.pref_path.c_str(), export_name);
     write_file(fd, param, sizeof(SceAppUtilSaveDataSlotParam), host.io, export_name);
     close_file(host.io, fd, export_name);
+
+    const std::lock_guard<std::mutex> lock(host.savedata_slots.mutex);
+    SaveDataSlotEntry &entry = host.savedata_slots.slots[slotId];
+    entry.exists = true;
+    entry.param = *param;
     return 0;
 }
 
 EXPORT(int, sceAppUtilSaveDataSlotDelete, unsigned int slotId, SceAppUtilSaveDataMountPoint *mountPoint) {
-    std::string slot_path = "savedata0:/SlotParam_";
-    slot_path += std::to_string(slotId);
-    slot_path += ".bin";
-    remove_file(host.io, slot_path.c_str(), host.pref_path.c_str(), export_name);
+    remove_file(host.io, slot_param_path(slotId).c_str(), host.pref_path.c_str(), export_name);
+
+    const std::lock_guard<std::mutex> lock(host.savedata_slots.mutex);
+    host.savedata_slots.slots[slotId] = SaveDataSlotEntry();
     return 0;
 }
 
 EXPORT(int, sceAppUtilSaveDataSlotGetParam, unsigned int slotId, SceAppUtilSaveDataSlotParam *param, SceAppUtilSaveDataMountPoint *mountPoint) {
-    std::string slot_path = "savedata0:/SlotParam_";
-    slot_path += std::to_string(slotId);
-    slot_path += ".bin";
-    SceUID fd = open_file(host.io, slot_path, SCE_O_RDONLY, host.pref_path.c_str(), export_name);
-    if (fd < 0)
+    {
+        const std::lock_guard<std::mutex> lock(host.savedata_slots.mutex);
+        const auto entry = host.savedata_slots.slots.find(slotId);
+        if (entry != host.savedata_slots.slots.end()) {
+            if (!entry->second.exists)
+                return RET_ERROR(SCE_APPUTIL_ERROR_SAVEDATA_SLOT_NOT_FOUND);
+            *param = entry->second.param;
+            return 0;
+        }
+    }
+
+    SceUID fd = open_file(host.io, slot_param_path(slotId), SCE_O_RDONLY, host.pref_path.c_str(), export_name);
+    if (fd < 0) {
+        const std::lock_guard<std::mutex> lock(host.savedata_slots.mutex);
+        host.savedata_slots.slots[slotId] = SaveDataSlotEntry();
         return RET_ERROR(SCE_APPUTIL_ERROR_SAVEDATA_SLOT_NOT_FOUND);
+    }
     read_file(param, host.io, fd, sizeof(SceAppUtilSaveDataSlotParam), export_name);
     close_file(host.io, fd, export_name);
+
+    const std::lock_guard<std::mutex> lock(host.savedata_slots.mutex);
+    SaveDataSlotEntry &entry = host.savedata_slots.slots[slotId];
+    entry.exists = true;
+    entry.param = *param;
     return 0;
 }
 
@@ -240,14 +269,19 @@ EXPORT(int, sceAppUtilSaveDataSlotSearch) {
 }
 
 EXPORT(int, sceAppUtilSaveDataSlotSetParam, unsigned int slotId, SceAppUtilSaveDataSlotParam *param, SceAppUtilSaveDataMountPoint *mountPoint) {
-    std::string slot_path = "savedata0:/SlotParam_";
-    slot_path += std::to_string(slotId);
-    slot_path += ".bin";
-    SceUID fd = open_file(host.io, slot_path, SCE_O_WRONLY, host.pref_path.c_str(), export_name);
-    if (fd < 0)
+    SceUID fd = open_file(host.io, slot_param_path(slotId), SCE_O_WRONLY, host.pref_path.c_str(), export_name);
+    if (fd < 0) {
+        const std::lock_guard<std::mutex> lock(host.savedata_slots.mutex);
+        host.savedata_slots.slots[slotId] = SaveDataSlotEntry();
         return RET_ERROR(SCE_APPUTIL_ERROR_SAVEDATA_SLOT_NOT_FOUND);
+    }
     write_file(fd, param, sizeof(SceAppUtilSaveDataSlotParam), host.io, export_name);
     close_file(host.io, fd, export_name);
+
+    const std::lock_guard<std::mutex> lock(host.savedata_slots.mutex);
+    SaveDataSlotEntry &entry = host.savedata_slots.slots[slotId];
+    entry.exists = true;
+    entry.param = *param;
     return 0;
 }
 
@@ -21,6 +21,8 @@
 
 #include <psp2/audioout.h>
 
+#include <thread>
+
 EXPORT(int, sceAudioOutGetAdopt) {
     return UNIMPLEMENTED();
 }
@@ -48,47 +50,77 @@ EXPORT(int, sceAudioOutOpenPort, SceAudioOutPortType type, int len, int freq, Sc
     }
 
     const int channels = (mode == SCE_AUDIO_OUT_MODE_MONO) ? 1 : 2;
-    const AudioStreamPtr stream(SDL_NewAudioStream(AUDIO_S16LSB, channels, freq, host.audio.ro.spec.format, host.audio.ro.spec.channels, host.audio.ro.spec.freq), SDL_FreeAudioStream);
-    if (!stream) {
-        return RET_ERROR(SCE_AUDIO_OUT_ERROR_NOT_OPENED);
-    }
 
     const AudioOutPortPtr port = std::make_shared<AudioOutPort>();
     port->ro.len_bytes = len * channels * sizeof(int16_t);
-    port->callback.stream = stream;
+    port->callback.resampler = std::make_shared<AudioResampler>(channels, freq, host.audio.ro.spec.channels, host.audio.ro.spec.freq);
 
-    const std::lock_guard<std::mutex> lock(host.audio.shared.mutex);
-    const int port_id = host.audio.shared.next_port_id++;
-    host.audio.shared.out_ports.emplace(port_id, port);
+    const std::lock_guard<std::shared_mutex> lock(host.audio.shared.mutex);
+    const int port_id = static_cast<int>(host.audio.shared.out_ports.size());
+    host.audio.shared.out_ports.push_back(port);
 
     return port_id;
 }
 
+// Indexed lookup into the flat port table - the lock only guards against
+// concurrent growth, taken shared so lookups from parallel guest threads
+// never serialize against each other.
+static AudioOutPortPtr find_port(HostState &host, int port) {
+    const std::shared_lock<std::shared_mutex> lock(host.audio.shared.mutex);
+    if ((port < 0) || (port >= static_cast<int>(host.audio.shared.out_ports.size()))) {
+        return AudioOutPortPtr();
+    }
+    return host.audio.shared.out_ports[port];
+}
+
+// How many buffers a port may hold in flight before its producer blocks.
+// Below the limit the samples are copied and the call returns immediately;
+// at the limit the guest blocks zero-copy until the callback drains its
+// buffer, so steady state pays one block/wake cycle per credit batch
+// instead of one per period.
+static constexpr uint32_t AUDIO_OUT_CREDITS = 2;
+
 EXPORT(int, sceAudioOutOutput, int port, const void *buf) {
-    const AudioOutPortPtr prt = lock_and_find(port, host.audio.shared.out_ports, host.audio.shared.mutex);
+    const AudioOutPortPtr prt = find_port(host, port);
     if (!prt) {
         return RET_ERROR(SCE_AUDIO_OUT_ERROR_INVALID_PORT);
     }
 
+    // A full ring only happens if several guest threads share the port -
+    // each producer blocks after queueing, so yield until the callback
+    // drains a slot rather than dropping the buffer.
+    AudioOutput *slot;
+    while (!(slot = prt->shared.outputs.begin_push())) {
+        std::this_thread::yield();
+    }
+    slot->buf = static_cast<const uint8_t *>(buf);
+    slot->len_bytes = prt->ro.len_bytes;
+
+    if (prt->shared.outputs.size() < AUDIO_OUT_CREDITS) {
+        // Credit available: own the samples, since the guest is free to
+        // reuse its buffer the moment we return. assign reuses the
+        // pooled storage the slot kept from its last lap of the ring.
+        slot->data.assign(slot->buf, slot->buf + slot->len_bytes);
+        slot->buf = slot->data.data();
+        slot->thread = -1;
+        prt->shared.outputs.commit_push();
+        return 0;
+    }
+
     const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
     if (!thread) {
         return RET_ERROR(SCE_AUDIO_OUT_ERROR_INVALID_PORT);
     }
 
+    // Park the thread before publishing, so the callback cannot consume
+    // the buffer and wake us first.
     const std::lock_guard<std::mutex> lock(thread->mutex);
     assert(thread->to_do == ThreadToDo::run);
     thread->to_do = ThreadToDo::wait;
     stop(*thread->cpu);
 
-    AudioOutput output;
-    output.buf = static_cast<const uint8_t *>(buf);
-    output.len_bytes = prt->ro.len_bytes;
-    output.thread = thread_id;
-
-    {
-        const std::lock_guard<std::mutex> lock(prt->shared.mutex);
-        prt->shared.outputs.push(output);
-    }
+    slot->thread = thread_id;
+    prt->shared.outputs.commit_push();
 
     return 0;
 }
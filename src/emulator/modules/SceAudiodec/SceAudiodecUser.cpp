@@ -17,6 +17,15 @@
 
 #include "SceAudiodecUser.h"
 
+// Implementation notes for whoever picks this module up: titles stream BGM
+// through these exports every frame, so the decode surface should sit on a
+// host decoder library (ATRAC9 needs LibAtrac9 or FFmpeg's decoder; AAC and
+// MP3 are plain FFmpeg), with decoding running on a worker that stays a few
+// output buffers ahead so sceAudiodecDecode returns pre-decoded PCM instead
+// of blocking on codec work. Neither library is a dependency of this tree
+// yet, and the guest-visible SceAudiodecCtrl/SceAudiodecInfo layouts are in
+// the psp2/audiodec.h we do not carry, so the exports stay stubs for now.
+
 EXPORT(int, sceAudiodecClearContext) {
     return UNIMPLEMENTED();
 }
@@ -20,14 +20,19 @@
 #include <psp2/ctrl.h>
 #include <psp2/kernel/error.h>
 
+#include <util/log.h>
+#include <util/trace.h>
+
 #include <SDL_gamecontroller.h>
 #include <SDL_keyboard.h>
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <fstream>
+#include <thread>
 
 // TODO Move elsewhere.
-static uint64_t timestamp;
 static SceCtrlPadInputMode input_mode;
 static SceCtrlPadInputMode input_mode_ext;
 
@@ -168,36 +173,196 @@ static void add_new_controllers(CtrlState &state) {
     }
 }
 
-static int peek_buffer_positive(HostState &host, SceCtrlData *&pad_data) {
-    CtrlState &state = host.ctrl;
+// One full SDL scan into the next ring slot. Runs only on the sampler
+// thread, once per sampling interval - the NIDs never touch SDL again no
+// matter how often a title polls.
+static void sample_pad(CtrlState &state) {
     remove_disconnected_controllers(state);
     add_new_controllers(state);
 
-    memset(pad_data, 0, sizeof(*pad_data));
-    pad_data->timeStamp = timestamp++; // TODO Use the real time and units.
+    CtrlSample sample;
+    sample.timestamp_us = trace_now_us();
 
     std::array<float, 4> axes;
     axes.fill(0);
-    apply_keyboard(&pad_data->buttons, axes.data());
+    apply_keyboard(&sample.buttons, axes.data());
     for (const GameControllerList::value_type &controller : state.controllers) {
-        apply_controller(&pad_data->buttons, axes.data(), controller.second.get());
+        apply_controller(&sample.buttons, axes.data(), controller.second.get());
+    }
+    sample.lx = float_to_byte(axes[0]);
+    sample.ly = float_to_byte(axes[1]);
+    sample.rx = float_to_byte(axes[2]);
+    sample.ry = float_to_byte(axes[3]);
+
+    // Publish under the mutex so a reader blocked in wait cannot miss the
+    // tick; peek stays lock-free against the count.
+    {
+        const std::lock_guard<std::mutex> lock(state.sample_mutex);
+        const uint64_t count = state.sample_count.load(std::memory_order_relaxed);
+        state.samples[count % state.samples.size()] = sample;
+        state.sample_count.store(count + 1, std::memory_order_release);
+    }
+    state.sample_tick.notify_all();
+}
+
+static void sampler_run(CtrlState *state) {
+    while (!state->sampler_stop.load()) {
+        sample_pad(*state);
+        std::this_thread::sleep_for(std::chrono::microseconds(state->sampling_interval_us));
+    }
+}
+
+// Started lazily on the first pad NID, so machines that never poll input
+// (headless soak runs) never pay for the scan.
+static void ensure_sampler(CtrlState &state) {
+    const std::lock_guard<std::mutex> lock(state.sample_mutex);
+    if (!state.sampler.joinable()) {
+        state.sampler = std::thread(sampler_run, &state);
+    }
+}
+
+// Latest published sample. The writer bumps the count only after filling
+// the slot, and the slot being written is never the latest one, so this is
+// safe without a lock.
+static void latest_sample(CtrlState &state, CtrlSample &out) {
+    const uint64_t count = state.sample_count.load(std::memory_order_acquire);
+    if (count > 0) {
+        out = state.samples[(count - 1) % state.samples.size()];
+    }
+}
+
+// Transitions are text lines of "frame buttons lx ly rx ry" (buttons in
+// hex), ordered by frame. The state on a line holds until the next one.
+static void load_input_recording(CtrlState &state) {
+    state.record_ready = true;
+
+    std::ifstream in(state.record_path);
+    if (!in.is_open()) {
+        LOG_ERROR("Could not open input recording {}.", state.record_path);
+        state.record_mode = CtrlRecordMode::off;
+        return;
+    }
+
+    CtrlRecordEntry entry;
+    unsigned int lx, ly, rx, ry;
+    while (in >> std::dec >> entry.frame >> std::hex >> entry.buttons >> std::dec >> lx >> ly >> rx >> ry) {
+        entry.lx = static_cast<uint8_t>(lx);
+        entry.ly = static_cast<uint8_t>(ly);
+        entry.rx = static_cast<uint8_t>(rx);
+        entry.ry = static_cast<uint8_t>(ry);
+        state.replay_entries.push_back(entry);
     }
 
+    LOG_INFO("Replaying {} input transitions from {}.", state.replay_entries.size(), state.record_path);
+}
+
+static void record_input_sample(CtrlState &state, uint64_t frame, const SceCtrlData &pad) {
+    if (!state.record_ready) {
+        state.record_ready = true;
+        state.record_file.open(state.record_path, std::ofstream::trunc);
+        if (!state.record_file.is_open()) {
+            LOG_ERROR("Could not open input recording {} for writing.", state.record_path);
+            state.record_mode = CtrlRecordMode::off;
+            return;
+        }
+        LOG_INFO("Recording input transitions to {}.", state.record_path);
+    }
+
+    const bool same = state.have_last_recorded && (pad.buttons == state.last_recorded.buttons)
+        && (pad.lx == state.last_recorded.lx) && (pad.ly == state.last_recorded.ly)
+        && (pad.rx == state.last_recorded.rx) && (pad.ry == state.last_recorded.ry);
+    if (same) {
+        return;
+    }
+
+    state.record_file << std::dec << frame << " " << std::hex << pad.buttons << std::dec
+                      << " " << static_cast<unsigned int>(pad.lx) << " " << static_cast<unsigned int>(pad.ly)
+                      << " " << static_cast<unsigned int>(pad.rx) << " " << static_cast<unsigned int>(pad.ry) << "\n";
+    state.record_file.flush();
+
+    state.last_recorded = { frame, pad.buttons, pad.lx, pad.ly, pad.rx, pad.ry };
+    state.have_last_recorded = true;
+}
+
+static void apply_replay(CtrlState &state, uint64_t frame, SceCtrlData *pad_data) {
+    while ((state.replay_pos < state.replay_entries.size()) && (state.replay_entries[state.replay_pos].frame <= frame)) {
+        ++state.replay_pos;
+    }
+
+    // replay_pos is the first entry still in the future; the one before it
+    // (if any) is the state holding on this frame. Neutral until the first.
+    const CtrlRecordEntry neutral;
+    const CtrlRecordEntry &entry = (state.replay_pos > 0) ? state.replay_entries[state.replay_pos - 1] : neutral;
+    pad_data->buttons = entry.buttons;
+    pad_data->lx = entry.lx;
+    pad_data->ly = entry.ly;
+    pad_data->rx = entry.rx;
+    pad_data->ry = entry.ry;
+}
+
+static int peek_buffer_positive(HostState &host, SceCtrlData *&pad_data) {
+    CtrlState &state = host.ctrl;
+
+    memset(pad_data, 0, sizeof(*pad_data));
+    pad_data->timeStamp = trace_now_us(); // microseconds, like the console
+
+
+    // Replay never touches SDL, so a run is deterministic regardless of
+    // what is plugged into the machine.
+    if (state.record_mode == CtrlRecordMode::replay) {
+        if (!state.record_ready) {
+            load_input_recording(state);
+        }
+        if (state.record_mode == CtrlRecordMode::replay) {
+            apply_replay(state, host.total_frame_count, pad_data);
+            return 0;
+        }
+    }
+
+    ensure_sampler(state);
+
+    CtrlSample sample;
+    latest_sample(state, sample);
+    pad_data->timeStamp = sample.timestamp_us;
+    pad_data->buttons = sample.buttons;
+
     if (input_mode == SCE_CTRL_MODE_DIGITAL) {
         pad_data->lx = 0x80;
         pad_data->ly = 0x80;
         pad_data->rx = 0x80;
         pad_data->ry = 0x80;
     } else {
-        pad_data->lx = float_to_byte(axes[0]);
-        pad_data->ly = float_to_byte(axes[1]);
-        pad_data->rx = float_to_byte(axes[2]);
-        pad_data->ry = float_to_byte(axes[3]);
+        pad_data->lx = sample.lx;
+        pad_data->ly = sample.ly;
+        pad_data->rx = sample.rx;
+        pad_data->ry = sample.ry;
+    }
+
+    if (state.record_mode == CtrlRecordMode::record) {
+        record_input_sample(state, host.total_frame_count, *pad_data);
     }
 
     return 0;
 }
 
+// Read semantics: block precisely until the sampler publishes its next
+// tick, then hand that sample out. Replay runs are frame-locked instead of
+// time-locked, so they return immediately like peek.
+static int read_buffer_positive(HostState &host, SceCtrlData *&pad_data) {
+    CtrlState &state = host.ctrl;
+
+    if (state.record_mode != CtrlRecordMode::replay) {
+        ensure_sampler(state);
+        const uint64_t seen = state.sample_count.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(state.sample_mutex);
+        state.sample_tick.wait(lock, [&state, seen]() {
+            return (state.sample_count.load(std::memory_order_acquire) != seen) || state.sampler_stop.load();
+        });
+    }
+
+    return peek_buffer_positive(host, pad_data);
+}
+
 EXPORT(int, sceCtrlClearRapidFire) {
     return UNIMPLEMENTED();
 }
@@ -290,7 +455,10 @@ EXPORT(int, sceCtrlReadBufferNegative2) {
 }
 
 EXPORT(int, sceCtrlReadBufferPositive, int port, SceCtrlData *pad_data, int count) {
-    return peek_buffer_positive(host, pad_data);
+    assert(pad_data != nullptr);
+    assert(count == 1);
+
+    return read_buffer_positive(host, pad_data);
 }
 
 EXPORT(int, sceCtrlReadBufferPositive2) {
@@ -18,9 +18,15 @@
 #include "SceDisplay.h"
 
 #include <host/functions.h>
+#include <util/hitch.h>
+#include <util/trace.h>
 
 #include <psp2/display.h>
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 EXPORT(int, _sceDisplayGetFrameBuf) {
     return UNIMPLEMENTED();
 }
@@ -90,11 +96,64 @@ EXPORT(int, sceDisplayWaitSetFrameBufMultiCB) {
     return UNIMPLEMENTED();
 }
 
+// Spin this close to the predicted vblank instead of parking - condvar wake
+// latency runs a millisecond-plus on loaded hosts, straight out of the
+// 16.6 ms budget of every title that waits here.
+static constexpr uint64_t VBLANK_SPIN_MARGIN_US = 2000;
+
 EXPORT(int, sceDisplayWaitVblankStart) {
+    const HitchStageScope hitch(HITCH_STAGE_VBLANK_WAIT);
+    DisplayState &display = host.display;
+    const uint64_t waited_count = display.vblank_count.load(std::memory_order_acquire);
+    const uint64_t last = display.last_vblank_us.load(std::memory_order_relaxed);
+    const uint64_t period = display.vblank_period_us.load(std::memory_order_relaxed);
+
+    // Governor overrides: unlocked does not pace at all, turbo releases the
+    // waiter off a synthetic timeline at a multiple of the real rate. The
+    // guest still sees vblanks in order - just denser.
+    if (display.unlocked_speed.load(std::memory_order_relaxed)) {
+        return SCE_DISPLAY_ERROR_OK;
+    }
+    const uint32_t turbo = display.turbo_multiplier.load(std::memory_order_relaxed);
+    if ((turbo > 1) && (last != 0)) {
+        const uint64_t step = period / turbo;
+        const uint64_t base = std::max(last, display.synthetic_vblank_us.load(std::memory_order_relaxed));
+        const uint64_t target = base + step;
+        const uint64_t now = trace_now_us();
+        if (target > now) {
+            std::this_thread::sleep_for(std::chrono::microseconds(target - now));
+        }
+        display.synthetic_vblank_us.store(target, std::memory_order_relaxed);
+        return display.abort.load() ? SCE_DISPLAY_ERROR_NO_PIXEL_DATA : SCE_DISPLAY_ERROR_OK;
+    }
+
+    if (last != 0) {
+        // Sleep through most of the wait, then yield-spin the last stretch
+        // watching the generation count. A prediction overshot by a whole
+        // period means the pump stalled - fall back to parking.
+        const uint64_t predicted = last + period;
+        const uint64_t now = trace_now_us();
+        if (predicted > now + VBLANK_SPIN_MARGIN_US) {
+            std::this_thread::sleep_for(std::chrono::microseconds(predicted - now - VBLANK_SPIN_MARGIN_US));
+        }
+        while (!display.abort.load()) {
+            if (display.vblank_count.load(std::memory_order_acquire) != waited_count) {
+                return SCE_DISPLAY_ERROR_OK;
+            }
+            if (trace_now_us() >= predicted + period) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // First wait of the session, a stalled pump, or an abort in flight.
     {
-        std::unique_lock<std::mutex> lock(host.display.mutex);
-        host.display.condvar.wait(lock);
-        if (host.display.abort.load()) {
+        std::unique_lock<std::mutex> lock(display.mutex);
+        if ((display.vblank_count.load(std::memory_order_acquire) == waited_count) && !display.abort.load()) {
+            display.condvar.wait(lock);
+        }
+        if (display.abort.load()) {
 #ifndef WIN32
             lock.release();
 #endif
@@ -17,7 +17,9 @@
 
 #include "SceDisplayUser.h"
 
+#include <host/display_format.h>
 #include <host/version.h>
+#include <util/hitch.h>
 
 #include <SDL_timer.h>
 #include <SDL_video.h>
@@ -65,7 +67,10 @@ EXPORT(int, sceDisplaySetFrameBuf, const emu::SceDisplayFrameBuf *pParam, SceDis
     if (pParam->pitch < pParam->width) {
         return RET_ERROR(SCE_DISPLAY_ERROR_INVALID_PITCH);
     }
-    if (pParam->pixelformat != SCE_DISPLAY_PIXELFORMAT_A8B8G8R8) {
+    // Accept every format the present path can upload directly; the GPU
+    // consumes those from guest memory with no CPU conversion.
+    DisplayFormatGL gl_format = {};
+    if (!display_format_to_gl(pParam->pixelformat, gl_format)) {
         return RET_ERROR(SCE_DISPLAY_ERROR_INVALID_PIXELFORMAT);
     }
     if (sync != SCE_DISPLAY_SETBUF_NEXTFRAME && sync != SCE_DISPLAY_SETBUF_IMMEDIATE) {
@@ -78,6 +83,8 @@ EXPORT(int, sceDisplaySetFrameBuf, const emu::SceDisplayFrameBuf *pParam, SceDis
     host.display.image_size.width = pParam->width;
     host.display.image_size.height = pParam->height;
     ++host.frame_count;
+    ++host.total_frame_count;
+    hitch_frame_boundary();
 
     MicroProfileFlip(nullptr);
 
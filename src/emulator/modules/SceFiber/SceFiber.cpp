@@ -17,6 +17,118 @@
 
 #include "SceFiber.h"
 
+#include <cpu/functions.h>
+#include <kernel/state.h>
+#include <util/lock_and_find.h>
+
+#include <cstring>
+
+// Fibers are cooperative contexts multiplexed onto the calling guest
+// thread. A switch saves the current register file and loads another on the
+// thread's own CPU instance - the host scheduler, the thread pool, and the
+// kernel lock-and-wake machinery are never involved, so a guest fiber
+// switch costs about as much as the SVC that requested it.
+
+// Error codes from the SDK; psp2/fiber.h is not among our checked-in
+// headers.
+enum SceFiberErrorCode {
+    SCE_FIBER_ERROR_NULL = 0x80590001,
+    SCE_FIBER_ERROR_RANGE = 0x80590002,
+    SCE_FIBER_ERROR_INVALID = 0x80590003,
+    SCE_FIBER_ERROR_PERMISSION = 0x80590004,
+    SCE_FIBER_ERROR_STATE = 0x80590005,
+};
+
+// Stack given to a fiber initialized without a context buffer. ULT worker
+// fibers run small jobs; recycled through the pool below, the size only
+// costs address space.
+static constexpr SceSize FIBER_DEFAULT_CONTEXT_SIZE = 64 * 1024;
+
+static Address acquire_fiber_stack(HostState &host, SceSize size) {
+    {
+        const std::lock_guard<std::shared_mutex> lock(host.kernel.mutex);
+        std::vector<Address> &pool = host.kernel.fiber_stack_pool[size];
+        if (!pool.empty()) {
+            const Address base = pool.back();
+            pool.pop_back();
+            return base;
+        }
+    }
+    return alloc(host.mem, size, "fiber stack");
+}
+
+static void release_fiber_stack(HostState &host, SceSize size, Address base) {
+    // Stacks park in the pool instead of freeing - titles with fiber worker
+    // pools finalize and reinitialize constantly, and the handful of sizes
+    // in play keeps the pool tiny.
+    const std::lock_guard<std::shared_mutex> lock(host.kernel.mutex);
+    host.kernel.fiber_stack_pool[size].push_back(base);
+}
+
+// Points the thread's CPU at the fiber. Returns the value the bridge's
+// return write must leave in r0 of the newly loaded context: a first entry
+// receives argOnInitialize as its first argument there, while a resumed
+// fiber is sitting in its own suspending run/switch SVC, which thereby
+// returns SCE_OK.
+static int resume_fiber(HostState &host, ThreadState &thread, Fiber &fiber, SceUInt32 arg_on_run) {
+    if (!fiber.started) {
+        fiber.started = true;
+        CPUContext ctx;
+        save_context(*thread.cpu, ctx); // inherit the status registers
+        ctx.cpu_registers[1] = arg_on_run;
+        ctx.cpu_registers[13] = (fiber.context_base + fiber.context_size) & ~7u;
+        ctx.cpu_registers[14] = 0; // a fiber entry never returns
+        ctx.cpu_registers[15] = fiber.entry & ~1u;
+        if (fiber.entry & 1) {
+            ctx.cpsr |= 0x20;
+        } else {
+            ctx.cpsr &= ~0x20u;
+        }
+        ctx.fpu_used = false;
+        load_context(*thread.cpu, ctx);
+        return static_cast<int>(fiber.arg_on_initialize);
+    }
+
+    // Deliver the new argOnRunTo through the pointer the fiber's suspending
+    // call captured, then drop back into it.
+    if (fiber.return_ptr) {
+        SceUInt32 *const out = Ptr<SceUInt32>(fiber.return_ptr).get(host.mem);
+        if (out) {
+            *out = arg_on_run;
+        }
+        fiber.return_ptr = 0;
+    }
+    load_context(*thread.cpu, fiber.ctx);
+    return 0;
+}
+
+// Registers the fiber. Returns false when a pooled stack could not be
+// allocated; argument validation stays with the exports.
+static bool initialize_fiber(HostState &host, Ptr<void> fiber, const char *name, Ptr<void> entry, SceUInt32 argOnInitialize, Ptr<void> addrContext, SceSize sizeContext) {
+    const FiberPtr f = std::make_shared<Fiber>();
+    f->addr = fiber.address();
+    f->entry = entry.address();
+    f->arg_on_initialize = argOnInitialize;
+    if (addrContext && (sizeContext != 0)) {
+        f->context_base = addrContext.address();
+        f->context_size = sizeContext;
+    } else {
+        f->context_size = FIBER_DEFAULT_CONTEXT_SIZE;
+        f->context_base = acquire_fiber_stack(host, f->context_size);
+        f->pooled_context = true;
+        if (!f->context_base) {
+            return false;
+        }
+    }
+    if (name) {
+        strncpy(f->name, name, KERNELOBJECT_MAX_NAME_LENGTH);
+    }
+
+    const std::lock_guard<std::shared_mutex> lock(host.kernel.mutex);
+    host.kernel.fibers[f->addr] = f;
+    return true;
+}
+
 EXPORT(int, _sceFiberAttachContextAndRun) {
     return UNIMPLEMENTED();
 }
@@ -25,28 +137,75 @@ EXPORT(int, _sceFiberAttachContextAndSwitch) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _sceFiberInitializeImpl) {
-    return UNIMPLEMENTED();
+EXPORT(int, _sceFiberInitializeImpl, Ptr<void> fiber, const char *name, Ptr<void> entry, SceUInt32 argOnInitialize, Ptr<void> addrContext, SceSize sizeContext, Ptr<void> optParam) {
+    if (!fiber || !entry) {
+        return RET_ERROR(SCE_FIBER_ERROR_NULL);
+    }
+    if (!initialize_fiber(host, fiber, name, entry, argOnInitialize, addrContext, sizeContext)) {
+        return RET_ERROR(SCE_FIBER_ERROR_RANGE);
+    }
+    return 0;
 }
 
-EXPORT(int, _sceFiberInitializeWithInternalOptionImpl) {
-    return UNIMPLEMENTED();
+EXPORT(int, _sceFiberInitializeWithInternalOptionImpl, Ptr<void> fiber, const char *name, Ptr<void> entry, SceUInt32 argOnInitialize, Ptr<void> addrContext, SceSize sizeContext) {
+    // The internal option only tunes context-size checking; initialization
+    // is otherwise the public one.
+    if (!fiber || !entry) {
+        return RET_ERROR(SCE_FIBER_ERROR_NULL);
+    }
+    if (!initialize_fiber(host, fiber, name, entry, argOnInitialize, addrContext, sizeContext)) {
+        return RET_ERROR(SCE_FIBER_ERROR_RANGE);
+    }
+    return 0;
 }
 
-EXPORT(int, sceFiberFinalize) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiberFinalize, Ptr<void> fiber) {
+    if (!fiber) {
+        return RET_ERROR(SCE_FIBER_ERROR_NULL);
+    }
+    const FiberPtr f = lock_and_find(fiber.address(), host.kernel.fibers, host.kernel.mutex);
+    if (!f) {
+        return RET_ERROR(SCE_FIBER_ERROR_INVALID);
+    }
+    if (f->running) {
+        return RET_ERROR(SCE_FIBER_ERROR_STATE);
+    }
+    if (f->pooled_context) {
+        release_fiber_stack(host, f->context_size, f->context_base);
+    }
+
+    const std::lock_guard<std::shared_mutex> lock(host.kernel.mutex);
+    host.kernel.fibers.erase(fiber.address());
+    return 0;
 }
 
 EXPORT(int, sceFiberGetInfo) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiberGetSelf) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiberGetSelf, Ptr<Ptr<void>> fiber) {
+    if (!fiber) {
+        return RET_ERROR(SCE_FIBER_ERROR_NULL);
+    }
+    const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
+    if (!thread) {
+        return RET_ERROR(SCE_FIBER_ERROR_INVALID);
+    }
+    *fiber.get(host.mem) = Ptr<void>(thread->running_fiber);
+    if (!thread->running_fiber) {
+        return RET_ERROR(SCE_FIBER_ERROR_PERMISSION); // called from thread context
+    }
+    return 0;
 }
 
-EXPORT(int, sceFiberOptParamInitialize) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiberOptParamInitialize, Ptr<void> optParam) {
+    if (!optParam) {
+        return RET_ERROR(SCE_FIBER_ERROR_NULL);
+    }
+    // The opt param carries no options we honor; zeroing matches the SDK's
+    // "initialized to defaults" contract. The structure is 128 bytes.
+    memset(optParam.get(host.mem), 0, 128);
+    return 0;
 }
 
 EXPORT(int, sceFiberPopUserMarkerWithHud) {
@@ -57,16 +216,77 @@ EXPORT(int, sceFiberPushUserMarkerWithHud) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiberRenameSelf) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiberRenameSelf, const char *name) {
+    if (!name) {
+        return RET_ERROR(SCE_FIBER_ERROR_NULL);
+    }
+    const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
+    if (!thread || !thread->running_fiber) {
+        return RET_ERROR(SCE_FIBER_ERROR_PERMISSION);
+    }
+    const FiberPtr f = lock_and_find(thread->running_fiber, host.kernel.fibers, host.kernel.mutex);
+    if (!f) {
+        return RET_ERROR(SCE_FIBER_ERROR_INVALID);
+    }
+    strncpy(f->name, name, KERNELOBJECT_MAX_NAME_LENGTH);
+    return 0;
 }
 
-EXPORT(int, sceFiberReturnToThread) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiberReturnToThread, SceUInt32 argOnReturnTo, Ptr<SceUInt32> argOnRun) {
+    const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
+    if (!thread) {
+        return RET_ERROR(SCE_FIBER_ERROR_INVALID);
+    }
+    if (!thread->running_fiber) {
+        return RET_ERROR(SCE_FIBER_ERROR_PERMISSION); // already in thread context
+    }
+    const FiberPtr current = lock_and_find(thread->running_fiber, host.kernel.fibers, host.kernel.mutex);
+    if (!current) {
+        return RET_ERROR(SCE_FIBER_ERROR_INVALID);
+    }
+
+    // Park the fiber inside this call; resume_fiber drops it back here with
+    // SCE_OK in r0 and *argOnRun filled.
+    save_context(*thread->cpu, current->ctx);
+    current->return_ptr = argOnRun.address();
+    current->running = false;
+    thread->running_fiber = 0;
+
+    if (thread->fiber_caller_return) {
+        SceUInt32 *const out = Ptr<SceUInt32>(thread->fiber_caller_return).get(host.mem);
+        if (out) {
+            *out = argOnReturnTo;
+        }
+        thread->fiber_caller_return = 0;
+    }
+    load_context(*thread->cpu, thread->fiber_caller_ctx);
+    return 0; // lands in r0 of the restored context: sceFiberRun's SCE_OK
 }
 
-EXPORT(int, sceFiberRun) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiberRun, Ptr<void> fiber, SceUInt32 argOnRunTo, Ptr<SceUInt32> argOnReturn) {
+    if (!fiber) {
+        return RET_ERROR(SCE_FIBER_ERROR_NULL);
+    }
+    const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
+    if (!thread) {
+        return RET_ERROR(SCE_FIBER_ERROR_INVALID);
+    }
+    if (thread->running_fiber) {
+        return RET_ERROR(SCE_FIBER_ERROR_PERMISSION); // run only enters from thread context
+    }
+    const FiberPtr f = lock_and_find(fiber.address(), host.kernel.fibers, host.kernel.mutex);
+    if (!f) {
+        return RET_ERROR(SCE_FIBER_ERROR_INVALID);
+    }
+    if (f->running) {
+        return RET_ERROR(SCE_FIBER_ERROR_STATE);
+    }
+
+    save_context(*thread->cpu, thread->fiber_caller_ctx);
+    thread->fiber_caller_return = argOnReturn.address();
+    thread->running_fiber = f->addr;
+    f->running = true;
+    return resume_fiber(host, *thread, *f, argOnRunTo);
 }
 
 EXPORT(int, sceFiberStartContextSizeCheck) {
@@ -77,8 +297,35 @@ EXPORT(int, sceFiberStopContextSizeCheck) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiberSwitch) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiberSwitch, Ptr<void> fiber, SceUInt32 argOnRunTo, Ptr<SceUInt32> argOnReturn) {
+    if (!fiber) {
+        return RET_ERROR(SCE_FIBER_ERROR_NULL);
+    }
+    const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
+    if (!thread) {
+        return RET_ERROR(SCE_FIBER_ERROR_INVALID);
+    }
+    if (!thread->running_fiber) {
+        return RET_ERROR(SCE_FIBER_ERROR_PERMISSION); // switch only runs fiber to fiber
+    }
+    const FiberPtr target = lock_and_find(fiber.address(), host.kernel.fibers, host.kernel.mutex);
+    if (!target) {
+        return RET_ERROR(SCE_FIBER_ERROR_INVALID);
+    }
+    if (target->running) {
+        return RET_ERROR(SCE_FIBER_ERROR_STATE);
+    }
+    const FiberPtr current = lock_and_find(thread->running_fiber, host.kernel.fibers, host.kernel.mutex);
+    if (!current) {
+        return RET_ERROR(SCE_FIBER_ERROR_INVALID);
+    }
+
+    save_context(*thread->cpu, current->ctx);
+    current->return_ptr = argOnReturn.address();
+    current->running = false;
+    thread->running_fiber = target->addr;
+    target->running = true;
+    return resume_fiber(host, *thread, *target, argOnRunTo);
 }
 
 BRIDGE_IMPL(_sceFiberAttachContextAndRun)
@@ -17,36 +17,78 @@
 
 #include "SceFios2.h"
 
+#include <io/async.h>
+#include <io/fios.h>
+#include <io/functions.h>
+#include <io/state.h>
+
+#include <psp2/io/fcntl.h>
+#include <psp2/kernel/error.h>
+
+#include <cstring>
+
+// Async operations go through the engine in io/src/async.cpp and are
+// observed through the op handle queries below. SceFiosOpAttr completion
+// callbacks are not dispatched - HLE cannot call into guest code from a host
+// worker - so titles that wait through the Sync variants, sceFiosOpWait or
+// sceFiosOpIsDone polling work, callback-driven ones do not yet.
+//
+// Archive (PSARC) mounts and overlays live in io/src/fios.cpp. FH values
+// from FIOS_ARCHIVE_FH_BASE up are archive entries; everything below is a
+// regular fd from the io layer, so the FH exports route by range.
+
+namespace emu {
+constexpr size_t SCE_FIOS_OVERLAY_POINT_MAX = 292;
+
+struct SceFiosOverlay {
+    uint8_t type;
+    uint8_t order;
+    uint16_t dst_len;
+    uint16_t src_len;
+    uint16_t unk2;
+    SceInt32 id;
+    char dst[SCE_FIOS_OVERLAY_POINT_MAX];
+    char src[SCE_FIOS_OVERLAY_POINT_MAX];
+};
+}
+
 EXPORT(int, sceFiosArchiveGetDecompressorThreadCount) {
-    return UNIMPLEMENTED();
+    return host.io.fios.decompressor_threads;
 }
 
 EXPORT(int, sceFiosArchiveGetMountBufferSize) {
-    return UNIMPLEMENTED();
+    // The index is kept host-side, so no guest work buffer is needed.
+    return async_register_completed(host.io, 0, 0);
 }
 
 EXPORT(int, sceFiosArchiveGetMountBufferSizeSync) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
-EXPORT(int, sceFiosArchiveMount) {
-    return UNIMPLEMENTED();
+EXPORT(SceFiosOp, sceFiosArchiveMount, Ptr<void> attr, SceFiosFH *fh_out, const char *path, const char *mount_point, Ptr<void> buffer, SceSize buffer_size) {
+    // Mounting only reads the central index - done inline, the op comes
+    // back already completed.
+    const int error = fios_mount_archive(host.io, path, mount_point, fh_out, host.pref_path.c_str(), export_name);
+    return async_register_completed(host.io, error, (error == 0) && fh_out ? *fh_out : 0);
 }
 
-EXPORT(int, sceFiosArchiveMountSync) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosArchiveMountSync, Ptr<void> attr, SceFiosFH *fh_out, const char *path, const char *mount_point, Ptr<void> buffer, SceSize buffer_size) {
+    return fios_mount_archive(host.io, path, mount_point, fh_out, host.pref_path.c_str(), export_name);
 }
 
-EXPORT(int, sceFiosArchiveSetDecompressorThreadCount) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosArchiveSetDecompressorThreadCount, int count) {
+    // Recorded but not acted on - blocks are inflated inline on the reading
+    // thread, through the shared cache.
+    host.io.fios.decompressor_threads = count;
+    return 0;
 }
 
-EXPORT(int, sceFiosArchiveUnmount) {
-    return UNIMPLEMENTED();
+EXPORT(SceFiosOp, sceFiosArchiveUnmount, Ptr<void> attr, SceFiosFH fh) {
+    return async_register_completed(host.io, fios_unmount_archive(host.io, fh, export_name), 0);
 }
 
-EXPORT(int, sceFiosArchiveUnmountSync) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosArchiveUnmountSync, Ptr<void> attr, SceFiosFH fh) {
+    return fios_unmount_archive(host.io, fh, export_name);
 }
 
 EXPORT(int, sceFiosCacheContainsFileRangeSync) {
@@ -237,12 +279,21 @@ EXPORT(int, sceFiosExistsSync) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiosFHClose) {
-    return UNIMPLEMENTED();
+EXPORT(SceFiosOp, sceFiosFHClose, Ptr<void> attr, SceFiosFH fh) {
+    if (fios_is_archive_fh(fh)) {
+        fios_close_archive_file(host.io, fh);
+        return async_register_completed(host.io, 0, 0);
+    }
+    return async_submit_close(host.io, fh, export_name);
 }
 
-EXPORT(int, sceFiosFHCloseSync) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosFHCloseSync, Ptr<void> attr, SceFiosFH fh) {
+    if (fios_is_archive_fh(fh)) {
+        fios_close_archive_file(host.io, fh);
+        return 0;
+    }
+    close_file(host.io, fh, export_name);
+    return 0;
 }
 
 EXPORT(int, sceFiosFHGetOpenParams) {
@@ -253,8 +304,19 @@ EXPORT(int, sceFiosFHGetPath) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiosFHGetSize) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosFHGetSize, SceFiosFH fh) {
+    if (fios_is_archive_fh(fh)) {
+        return static_cast<int>(fios_archive_file_size(host.io, fh));
+    }
+    // Round trip through the cursor - the io layer keeps no stat shortcut
+    // for an open fd.
+    const int position = seek_file(fh, 0, SEEK_CUR, host.io, export_name);
+    if (position < 0) {
+        return position;
+    }
+    const int size = seek_file(fh, 0, SEEK_END, host.io, export_name);
+    seek_file(fh, position, SEEK_SET, host.io, export_name);
+    return size;
 }
 
 EXPORT(int, sceFiosFHIoctl) {
@@ -265,12 +327,62 @@ EXPORT(int, sceFiosFHIoctlSync) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiosFHOpen) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, sceFiosFHOpenSync) {
-    return UNIMPLEMENTED();
+EXPORT(SceFiosOp, sceFiosFHOpen, Ptr<void> attr, SceFiosFH *fh_out, const char *path, Ptr<void> params) {
+    if (path == nullptr) {
+        return RET_ERROR(SCE_ERROR_ERRNO_EINVAL);
+    }
+    const auto candidates = fios_resolve_overlays(host.io, path);
+    for (const auto &candidate : candidates) {
+        const SceUID fh = fios_open_archive_file(host.io, candidate.c_str());
+        if (fh >= 0) {
+            if (fh_out) {
+                *fh_out = fh;
+            }
+            // An archive open is an index lookup - it completes in place.
+            return async_register_completed(host.io, 0, fh);
+        }
+    }
+    if (candidates.size() > 1) {
+        // With overlays in play existence picks the winner, so resolve
+        // inline and hand back a completed op.
+        SceUID fd = -1;
+        for (const auto &candidate : candidates) {
+            fd = open_file(host.io, candidate, SCE_O_RDONLY, host.pref_path.c_str(), export_name);
+            if (fd >= 0) {
+                break;
+            }
+        }
+        if ((fd >= 0) && fh_out) {
+            *fh_out = fd;
+        }
+        return async_register_completed(host.io, (fd < 0) ? fd : 0, (fd < 0) ? 0 : fd);
+    }
+    // Open params are not decoded yet - Fios2 streaming opens are read-only.
+    return async_submit_open(host.io, path, SCE_O_RDONLY, fh_out, host.pref_path.c_str(), export_name);
+}
+
+EXPORT(int, sceFiosFHOpenSync, Ptr<void> attr, SceFiosFH *fh_out, const char *path, Ptr<void> params) {
+    if ((path == nullptr) || (fh_out == nullptr)) {
+        return RET_ERROR(SCE_ERROR_ERRNO_EINVAL);
+    }
+    // Overlay-mapped candidates first, the path as given last; the first
+    // that resolves - archive entry or real file - wins.
+    const auto candidates = fios_resolve_overlays(host.io, path);
+    SceUID fd = -1;
+    for (const auto &candidate : candidates) {
+        fd = fios_open_archive_file(host.io, candidate.c_str());
+        if (fd < 0) {
+            fd = open_file(host.io, candidate, SCE_O_RDONLY, host.pref_path.c_str(), export_name);
+        }
+        if (fd >= 0) {
+            break;
+        }
+    }
+    if (fd < 0) {
+        return fd;
+    }
+    *fh_out = fd;
+    return 0;
 }
 
 EXPORT(int, sceFiosFHOpenWithMode) {
@@ -281,12 +393,26 @@ EXPORT(int, sceFiosFHOpenWithModeSync) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiosFHPread) {
-    return UNIMPLEMENTED();
+EXPORT(SceFiosOp, sceFiosFHPread, Ptr<void> attr, SceFiosFH fh, void *buffer, SceFiosSize length, SceFiosOffset offset) {
+    if (buffer == nullptr) {
+        return RET_ERROR(SCE_ERROR_ERRNO_EINVAL);
+    }
+    if (fios_is_archive_fh(fh)) {
+        // Archive reads come out of the block cache - serve inline.
+        const int read = fios_read_archive_file(host.io, fh, buffer, static_cast<SceSize>(length), offset, export_name);
+        return async_register_completed(host.io, (read < 0) ? read : 0, (read < 0) ? 0 : read);
+    }
+    return async_submit_read(host.io, fh, buffer, static_cast<SceSize>(length), offset, export_name);
 }
 
-EXPORT(int, sceFiosFHPreadSync) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosFHPreadSync, Ptr<void> attr, SceFiosFH fh, void *buffer, SceFiosSize length, SceFiosOffset offset) {
+    if (buffer == nullptr) {
+        return RET_ERROR(SCE_ERROR_ERRNO_EINVAL);
+    }
+    if (fios_is_archive_fh(fh)) {
+        return fios_read_archive_file(host.io, fh, buffer, static_cast<SceSize>(length), offset, export_name);
+    }
+    return pread_file(buffer, host.io, fh, static_cast<SceSize>(length), offset, export_name);
 }
 
 EXPORT(int, sceFiosFHPreadv) {
@@ -313,12 +439,25 @@ EXPORT(int, sceFiosFHPwritevSync) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiosFHRead) {
-    return UNIMPLEMENTED();
+EXPORT(SceFiosOp, sceFiosFHRead, Ptr<void> attr, SceFiosFH fh, void *buffer, SceFiosSize length) {
+    if (buffer == nullptr) {
+        return RET_ERROR(SCE_ERROR_ERRNO_EINVAL);
+    }
+    if (fios_is_archive_fh(fh)) {
+        const int read = fios_read_archive_file(host.io, fh, buffer, static_cast<SceSize>(length), -1, export_name);
+        return async_register_completed(host.io, (read < 0) ? read : 0, (read < 0) ? 0 : read);
+    }
+    return async_submit_read(host.io, fh, buffer, static_cast<SceSize>(length), -1, export_name);
 }
 
-EXPORT(int, sceFiosFHReadSync) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosFHReadSync, Ptr<void> attr, SceFiosFH fh, void *buffer, SceFiosSize length) {
+    if (buffer == nullptr) {
+        return RET_ERROR(SCE_ERROR_ERRNO_EINVAL);
+    }
+    if (fios_is_archive_fh(fh)) {
+        return fios_read_archive_file(host.io, fh, buffer, static_cast<SceSize>(length), -1, export_name);
+    }
+    return read_file(buffer, host.io, fh, static_cast<SceSize>(length), export_name);
 }
 
 EXPORT(int, sceFiosFHReadv) {
@@ -329,8 +468,12 @@ EXPORT(int, sceFiosFHReadvSync) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiosFHSeek) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosFHSeek, SceFiosFH fh, SceFiosOffset offset, int whence) {
+    if (fios_is_archive_fh(fh)) {
+        return static_cast<int>(fios_seek_archive_file(host.io, fh, offset, whence));
+    }
+    // SCE_FIOS_SEEK_SET/CUR/END match SEEK_SET/CUR/END.
+    return seek_file(fh, static_cast<int>(offset), whence, host.io, export_name);
 }
 
 EXPORT(int, sceFiosFHStat) {
@@ -349,8 +492,11 @@ EXPORT(int, sceFiosFHSyncSync) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiosFHTell) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosFHTell, SceFiosFH fh) {
+    if (fios_is_archive_fh(fh)) {
+        return static_cast<int>(fios_seek_archive_file(host.io, fh, 0, SEEK_CUR));
+    }
+    return seek_file(fh, 0, SEEK_CUR, host.io, export_name);
 }
 
 EXPORT(int, sceFiosFHToFileno) {
@@ -477,16 +623,19 @@ EXPORT(int, sceFiosIOFilterRemove) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiosInitialize) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosInitialize, Ptr<void> params) {
+    // Scheduler parameters (thread counts, priorities) are ignored - the
+    // engine runs one host worker regardless.
+    host.io.async.initialized = true;
+    return 0;
 }
 
 EXPORT(int, sceFiosIsIdle) {
-    return UNIMPLEMENTED();
+    return async_is_idle(host.io);
 }
 
-EXPORT(int, sceFiosIsInitialized) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosIsInitialized, Ptr<void> params_out) {
+    return host.io.async.initialized;
 }
 
 EXPORT(int, sceFiosIsSuspended) {
@@ -501,12 +650,18 @@ EXPORT(int, sceFiosOpCancel) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiosOpDelete) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosOpDelete, SceFiosOp op) {
+    async_delete_op(host.io, op);
+    return 0;
 }
 
-EXPORT(int, sceFiosOpGetActualCount) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosOpGetActualCount, SceFiosOp op) {
+    const AsyncIoOpPtr record = async_find_op(host.io, op);
+    if (!record) {
+        return 0;
+    }
+    const std::lock_guard<std::mutex> lock(record->mutex);
+    return static_cast<int>(record->actual);
 }
 
 EXPORT(int, sceFiosOpGetAttr) {
@@ -517,8 +672,13 @@ EXPORT(int, sceFiosOpGetBuffer) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiosOpGetError) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosOpGetError, SceFiosOp op) {
+    const AsyncIoOpPtr record = async_find_op(host.io, op);
+    if (!record) {
+        return RET_ERROR(SCE_ERROR_ERRNO_EINVAL);
+    }
+    const std::lock_guard<std::mutex> lock(record->mutex);
+    return record->error;
 }
 
 EXPORT(int, sceFiosOpGetOffset) {
@@ -537,8 +697,13 @@ EXPORT(int, sceFiosOpIsCancelled) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiosOpIsDone) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosOpIsDone, SceFiosOp op) {
+    const AsyncIoOpPtr record = async_find_op(host.io, op);
+    if (!record) {
+        return 1; // deleted ops count as done
+    }
+    const std::lock_guard<std::mutex> lock(record->mutex);
+    return record->done;
 }
 
 EXPORT(int, sceFiosOpReschedule) {
@@ -557,36 +722,80 @@ EXPORT(int, sceFiosOpSyncWaitForIO) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceFiosOpWait) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosOpWait, SceFiosOp op) {
+    // Blocks the calling guest thread's host worker, as the synchronous io
+    // path already does.
+    return async_wait_op(host.io, op);
 }
 
-EXPORT(int, sceFiosOpWaitUntil) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosOpWaitUntil, SceFiosOp op, SceFiosTime deadline) {
+    // The deadline is not honoured yet; waits run to completion.
+    return async_wait_op(host.io, op);
 }
 
-EXPORT(int, sceFiosOverlayAdd) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosOverlayAdd, emu::SceFiosOverlay *overlay, SceInt32 *id_out) {
+    if (overlay == nullptr) {
+        return RET_ERROR(SCE_ERROR_ERRNO_EINVAL);
+    }
+    return fios_overlay_add(host.io, overlay->type, overlay->order, overlay->dst, overlay->src, id_out);
 }
 
-EXPORT(int, sceFiosOverlayGetInfo) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosOverlayGetInfo, SceInt32 id, emu::SceFiosOverlay *out) {
+    if (out == nullptr) {
+        return RET_ERROR(SCE_ERROR_ERRNO_EINVAL);
+    }
+    FiosOverlay overlay;
+    if (!fios_overlay_get(host.io, id, overlay)) {
+        return RET_ERROR(SCE_ERROR_ERRNO_EINVAL);
+    }
+    memset(out, 0, sizeof(*out));
+    out->type = overlay.type;
+    out->order = overlay.order;
+    out->id = overlay.id;
+    strncpy(out->dst, overlay.dst.c_str(), sizeof(out->dst) - 1);
+    strncpy(out->src, overlay.src.c_str(), sizeof(out->src) - 1);
+    out->dst_len = static_cast<uint16_t>(strlen(out->dst));
+    out->src_len = static_cast<uint16_t>(strlen(out->src));
+    return 0;
 }
 
-EXPORT(int, sceFiosOverlayGetList) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosOverlayGetList, SceInt32 *out_ids, SceSize max_ids, SceSize *count_out) {
+    const std::vector<SceInt32> ids = fios_overlay_ids(host.io);
+    if (count_out) {
+        *count_out = static_cast<SceSize>(ids.size());
+    }
+    if (out_ids) {
+        for (SceSize i = 0; (i < max_ids) && (i < ids.size()); ++i) {
+            out_ids[i] = ids[i];
+        }
+    }
+    return 0;
 }
 
-EXPORT(int, sceFiosOverlayModify) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosOverlayModify, SceInt32 id, emu::SceFiosOverlay *overlay) {
+    if (overlay == nullptr) {
+        return RET_ERROR(SCE_ERROR_ERRNO_EINVAL);
+    }
+    return fios_overlay_modify(host.io, id, overlay->type, overlay->order, overlay->dst, overlay->src);
 }
 
-EXPORT(int, sceFiosOverlayRemove) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosOverlayRemove, SceInt32 id) {
+    return fios_overlay_remove(host.io, id);
 }
 
-EXPORT(int, sceFiosOverlayResolveSync) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceFiosOverlayResolveSync, int resolve_flag, const char *in_path, char *out_path, SceSize max_path) {
+    if ((in_path == nullptr) || (out_path == nullptr) || (max_path == 0)) {
+        return RET_ERROR(SCE_ERROR_ERRNO_EINVAL);
+    }
+    // Highest priority candidate; with no matching overlay this is the path
+    // unchanged.
+    const auto candidates = fios_resolve_overlays(host.io, in_path);
+    const std::string &resolved = candidates.front();
+    if (resolved.size() >= max_path) {
+        return RET_ERROR(SCE_ERROR_ERRNO_ENAMETOOLONG);
+    }
+    strcpy(out_path, resolved.c_str());
+    return 0;
 }
 
 EXPORT(int, sceFiosPathNormalize) {
@@ -666,7 +875,9 @@ EXPORT(int, sceFiosSyncSync) {
 }
 
 EXPORT(int, sceFiosTerminate) {
-    return UNIMPLEMENTED();
+    async_shutdown(host.io.async);
+    host.io.async.initialized = false;
+    return 0;
 }
 
 EXPORT(int, sceFiosTimeGetCurrent) {
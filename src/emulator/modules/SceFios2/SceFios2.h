@@ -19,6 +19,15 @@
 
 #include <module/module.h>
 
+// Minimal Fios2 types, enough for the FH/Op subset implemented here. File
+// handles map straight onto io fds and op handles onto the async engine's
+// operation ids.
+typedef SceInt32 SceFiosOp;
+typedef SceInt32 SceFiosFH;
+typedef SceInt64 SceFiosOffset;
+typedef SceInt64 SceFiosSize;
+typedef SceInt64 SceFiosTime;
+
 BRIDGE_DECL(sceFiosArchiveGetDecompressorThreadCount)
 BRIDGE_DECL(sceFiosArchiveGetMountBufferSize)
 BRIDGE_DECL(sceFiosArchiveGetMountBufferSizeSync)
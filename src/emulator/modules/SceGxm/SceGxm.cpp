@@ -17,20 +17,28 @@
 
 #include "SceGxm.h"
 
+#include <gxm/capture.h>
 #include <gxm/functions.h>
+#include <gxm/gpu_timer_functions.h>
+#include <gxm/surface_cache_functions.h>
 #include <gxm/texture_cache_functions.h>
 #include <gxm/types.h>
 
 #include <cpu/functions.h>
+#include <glutil/gl_debug.h>
 #include <host/functions.h>
 #include <kernel/thread/thread_functions.h>
+#include <util/fs.h>
 #include <util/lock_and_find.h>
 #include <util/log.h>
+#include <util/hitch.h>
+#include <util/trace.h>
 
 #include <glbinding/Binding.h>
 #include <psp2/kernel/error.h>
 
 #include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -80,6 +88,7 @@ EXPORT(int, sceGxmBeginScene, SceGxmContext *context, unsigned int flags, const
     }
 
     if (fragmentSyncObject != nullptr) {
+        const TraceScope trace("gxm begin scene sync wait");
         std::unique_lock<std::mutex> lock(fragmentSyncObject->mutex);
         while (fragmentSyncObject->value == 0) {
             fragmentSyncObject->cond_var.wait(lock);
@@ -92,31 +101,80 @@ EXPORT(int, sceGxmBeginScene, SceGxmContext *context, unsigned int flags, const
     context->state.vertex_ring_buffer_used = 0;
     context->state.color_surface = *colorSurface;
 
+    if (host.gxm.capture.enabled) {
+        struct {
+            uint32_t flags;
+            emu::SceGxmColorSurface color_surface;
+            emu::SceGxmDepthStencilSurface depth_stencil;
+        } args = { flags, *colorSurface, *depthStencil };
+        gxm_capture_command(host.gxm.capture, GxmCaptureOp::begin_scene, &args, sizeof(args), nullptr, 0);
+    }
+
     host.gxm.isInScene = true;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, renderTarget->framebuffer[0]);
+    // The renderbuffer storage is respecified when the resolution
+    // multiplier changed, which only mutates host-side GL state.
+    SceGxmRenderTarget *const rt = const_cast<SceGxmRenderTarget *>(renderTarget);
+    const SceGxmCullMode cull_mode = context->state.cull_mode;
+    const GLsizei display_width = host.display.image_size.width;
+    const GLsizei display_height = host.display.image_size.height;
+    const uint32_t surface_width = colorSurface->pbeEmitWords[0];
+    const uint32_t surface_height = colorSurface->pbeEmitWords[1];
+    const Address surface_data = colorSurface->pbeEmitWords[3];
+    const uint32_t multiplier = host.gxm.resolution_multiplier;
+    render_queue(context->renderer.render_thread, [context, rt, cull_mode, display_width, display_height, surface_width, surface_height, surface_data, multiplier]() {
+        GLShadowState &shadow = context->renderer.shadow;
+
+        if (rt->multiplier != multiplier) {
+            glBindRenderbuffer(GL_RENDERBUFFER, rt->renderbuffers[0]);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA, rt->width * multiplier, rt->height * multiplier);
+            glBindRenderbuffer(GL_RENDERBUFFER, rt->renderbuffers[1]);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, rt->width * multiplier, rt->height * multiplier);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+            rt->multiplier = multiplier;
+        }
 
-    // Re-load GL machine settings for multiple contexts support
-    // TODO This shouldn't be necessary, as each GXM context gets its own OpenGL context.
-    switch (context->state.cull_mode) {
-    case SCE_GXM_CULL_CCW:
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_FRONT);
-        break;
-    case SCE_GXM_CULL_CW:
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
-        break;
-    case SCE_GXM_CULL_NONE:
-        glDisable(GL_CULL_FACE);
-        break;
-    }
+        glBindFramebuffer(GL_FRAMEBUFFER, rt->framebuffer[0]);
 
-    glEnable(GL_SCISSOR_TEST);
-    glScissor(0, 0, host.display.image_size.width, host.display.image_size.height);
+        // Back the colour surface with a texture tracked by its guest
+        // address, so a scene that later samples this surface binds the
+        // rendered image directly instead of re-uploading the pixels.
+        const SharedGLObject surface_texture = get_surface_texture(context->renderer.surface_cache, surface_data, surface_width, surface_height, multiplier);
+        if (surface_texture) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, surface_texture->get(), 0);
+        }
 
-    // TODO This is just for debugging.
-    glClear(GL_COLOR_BUFFER_BIT);
+        // Creating the surface texture may have bound it to whichever unit
+        // was active, so the per-unit bindings are no longer known (0 means
+        // unknown, not texture name zero).
+        shadow.textures = {};
+
+        // Re-load GL machine settings for multiple contexts support
+        // TODO This shouldn't be necessary, as each GXM context gets its own OpenGL context.
+        if (!shadow.cull_valid || (shadow.cull_mode != cull_mode)) {
+            switch (cull_mode) {
+            case SCE_GXM_CULL_CCW:
+                glEnable(GL_CULL_FACE);
+                glCullFace(GL_FRONT);
+                break;
+            case SCE_GXM_CULL_CW:
+                glEnable(GL_CULL_FACE);
+                glCullFace(GL_BACK);
+                break;
+            case SCE_GXM_CULL_NONE:
+                glDisable(GL_CULL_FACE);
+                break;
+            }
+            shadow.cull_valid = true;
+            shadow.cull_mode = cull_mode;
+        }
+
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(0, 0, display_width * multiplier, display_height * multiplier);
+
+        // TODO This is just for debugging.
+        glClear(GL_COLOR_BUFFER_BIT);
+    });
 
     return 0;
 }
@@ -230,16 +288,18 @@ EXPORT(int, sceGxmCreateContext, const emu::SceGxmContextParams *params, Ptr<Sce
         return reinterpret_cast<ProcAddress>(SDL_GL_GetProcAddress(name));
     };
     Binding::initialize(get_proc_address, false);
+    // KHR_debug state is per context; a no-op in release builds.
+    install_khr_debug_callback();
 
     LOG_INFO("GL_VERSION = {}", glGetString(GL_VERSION));
     LOG_INFO("GL_SHADING_LANGUAGE_VERSION = {}", glGetString(GL_SHADING_LANGUAGE_VERSION));
 
-    set_viewport(ctx->state.viewport, host.display.image_size.width, host.display.image_size.height);
+    set_viewport(ctx->state.viewport, host.display.image_size.width, host.display.image_size.height, host.gxm.resolution_multiplier);
 
     // TODO This is just for debugging.
     glClearColor(0.0625f, 0.125f, 0.25f, 0);
 
-    if (!init(ctx->renderer.texture_cache) || !ctx->renderer.vertex_array.init(glGenVertexArrays, glDeleteVertexArrays) || !ctx->renderer.element_buffer.init(glGenBuffers, glDeleteBuffers) || !ctx->renderer.stream_vertex_buffers.init(glGenBuffers, glDeleteBuffers)) {
+    if (!init(ctx->renderer.texture_cache) || !init(ctx->renderer.gpu_timer) || !ctx->renderer.vertex_array.init(glGenVertexArrays, glDeleteVertexArrays) || !ctx->renderer.stream_vertex_buffers.init(glGenBuffers, glDeleteBuffers) || !ctx->renderer.flip_framebuffer.init(glGenFramebuffers, glDeleteFramebuffers) || !ctx->renderer.flip_renderbuffer.init(glGenRenderbuffers, glDeleteRenderbuffers)) {
         free(host.mem, *context);
         context->reset();
 
@@ -247,7 +307,56 @@ EXPORT(int, sceGxmCreateContext, const emu::SceGxmContextParams *params, Ptr<Sce
     }
 
     glBindVertexArray(ctx->renderer.vertex_array[0]);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ctx->renderer.element_buffer[0]);
+
+    if (host.gxm.texture_upload_budget != 0) {
+        ctx->renderer.texture_cache.upload_budget_per_scene = host.gxm.texture_upload_budget;
+    }
+
+    // Shader programs are linked on a worker thread whose GL context shares
+    // objects with the render context.
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+    ctx->renderer.shader_compiler.gl = GLContextPtr(SDL_GL_CreateContext(host.window.get()), SDL_GL_DeleteContext);
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+    assert(ctx->renderer.shader_compiler.gl != nullptr);
+
+    // Creating the worker context made it current - release it. This thread
+    // does no more GL; both contexts now belong to worker threads.
+    SDL_GL_MakeCurrent(host.window.get(), nullptr);
+
+    SDL_Window *const window = host.window.get();
+    ShaderCompiler *const compiler = &ctx->renderer.shader_compiler;
+    compiler->worker = std::thread([window, compiler, get_proc_address]() {
+        SDL_GL_MakeCurrent(window, compiler->gl.get());
+        Binding::initialize(get_proc_address, false);
+        install_khr_debug_callback();
+        shader_compiler_run(*compiler);
+    });
+
+    // Replay the previous session's manifest: every program pair recorded
+    // then is restored from its saved driver binary on the compiler thread
+    // now, ahead of the title's first draw, and new pairs keep appending as
+    // they appear.
+    if (!host.io.title_id.empty()) {
+        fs::create_directory(host.pref_path + "prewarm");
+        prewarm_log_open(host.gxm.prewarm, host.pref_path + "prewarm/" + host.io.title_id + ".shaders");
+        prewarm_shader_programs(*ctx, host.gxm, host.base_path.c_str(), host.pref_path.c_str());
+    }
+
+    // Hand the render context to the render thread. From here on the
+    // GL-touching exports record commands for it instead of calling GL.
+    RenderThread *const renderer = &ctx->renderer.render_thread;
+    SDL_GLContext const render_gl = ctx->renderer.gl.get();
+    renderer->worker = std::thread([window, renderer, render_gl, get_proc_address]() {
+        SDL_GL_MakeCurrent(window, render_gl);
+        Binding::initialize(get_proc_address, false);
+        install_khr_debug_callback();
+        render_thread_run(*renderer);
+
+        // Release the context so sceGxmDestroyContext can take it back.
+        SDL_GL_MakeCurrent(window, nullptr);
+    });
+
+    host.gxm.context = *context;
 
     return 0;
 }
@@ -265,22 +374,47 @@ EXPORT(int, sceGxmCreateRenderTarget, const SceGxmRenderTargetParams *params, Pt
         return RET_ERROR(SCE_GXM_ERROR_OUT_OF_MEMORY);
     }
 
-    SceGxmRenderTarget *const rt = renderTarget->get(host.mem);
-    if (!rt->renderbuffers.init(glGenRenderbuffers, glDeleteRenderbuffers) || !rt->framebuffer.init(glGenFramebuffers, glDeleteFramebuffers)) {
+    // The GL objects have to be created where the render context is current,
+    // so the work runs on the render thread of the context created earlier.
+    SceGxmContext *const ctx = host.gxm.context ? host.gxm.context.get(host.mem) : nullptr;
+    if (ctx == nullptr) {
         free(host.mem, *renderTarget);
         return RET_ERROR(SCE_GXM_ERROR_DRIVER);
     }
 
-    glBindRenderbuffer(GL_RENDERBUFFER, rt->renderbuffers[0]);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA, params->width, params->height);
-    glBindRenderbuffer(GL_RENDERBUFFER, rt->renderbuffers[1]);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, params->width, params->height);
-    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    SceGxmRenderTarget *const rt = renderTarget->get(host.mem);
+    const GLsizei width = params->width;
+    const GLsizei height = params->height;
+    const uint32_t multiplier = host.gxm.resolution_multiplier;
+    bool ok = false;
+    render_queue(ctx->renderer.render_thread, [rt, width, height, multiplier, &ok]() {
+        if (!rt->renderbuffers.init(glGenRenderbuffers, glDeleteRenderbuffers) || !rt->framebuffer.init(glGenFramebuffers, glDeleteFramebuffers)) {
+            return;
+        }
+
+        rt->width = width;
+        rt->height = height;
+        rt->multiplier = multiplier;
+
+        glBindRenderbuffer(GL_RENDERBUFFER, rt->renderbuffers[0]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA, width * multiplier, height * multiplier);
+        glBindRenderbuffer(GL_RENDERBUFFER, rt->renderbuffers[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width * multiplier, height * multiplier);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, rt->framebuffer[0]);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rt->renderbuffers[0]);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rt->renderbuffers[1]);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, rt->framebuffer[0]);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rt->renderbuffers[0]);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rt->renderbuffers[1]);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        ok = true;
+    });
+    render_sync(ctx->renderer.render_thread);
+
+    if (!ok) {
+        free(host.mem, *renderTarget);
+        return RET_ERROR(SCE_GXM_ERROR_DRIVER);
+    }
 
     return 0;
 }
@@ -358,6 +492,16 @@ EXPORT(int, sceGxmDepthStencilSurfaceSetForceStoreMode) {
 EXPORT(int, sceGxmDestroyContext, Ptr<SceGxmContext> context) {
     assert(context);
 
+    if (host.gxm.context == context) {
+        host.gxm.context.reset();
+    }
+
+    // Stop the render thread and take the render context back so the GL
+    // objects the renderer state owns can be deleted on this thread.
+    SceGxmContext *const ctx = context.get(host.mem);
+    render_stop(ctx->renderer.render_thread);
+    SDL_GL_MakeCurrent(host.window.get(), ctx->renderer.gl.get());
+
     free(host.mem, context);
 
     return 0;
@@ -371,12 +515,25 @@ EXPORT(int, sceGxmDestroyRenderTarget, Ptr<SceGxmRenderTarget> renderTarget) {
     MemState &mem = host.mem;
     assert(renderTarget);
 
-    free(mem, renderTarget);
+    // The destructor deletes the framebuffer and renderbuffers, which has to
+    // happen where the render context is current.
+    SceGxmContext *const ctx = host.gxm.context ? host.gxm.context.get(mem) : nullptr;
+    if (ctx != nullptr) {
+        MemState *const mem_ptr = &mem;
+        render_queue(ctx->renderer.render_thread, [mem_ptr, renderTarget]() {
+            free(*mem_ptr, renderTarget);
+        });
+        render_sync(ctx->renderer.render_thread);
+    } else {
+        // No context - the GL objects went away with it, only free the memory.
+        free(mem, renderTarget);
+    }
 
     return 0;
 }
 
 EXPORT(void, sceGxmDisplayQueueAddEntry, Ptr<SceGxmSyncObject> oldBuffer, Ptr<SceGxmSyncObject> newBuffer, Ptr<const void> callbackData) {
+    const TraceScope trace("sceGxmDisplayQueueAddEntry");
     //assert(oldBuffer != nullptr);
     //assert(newBuffer != nullptr);
     assert(callbackData);
@@ -390,6 +547,28 @@ EXPORT(void, sceGxmDisplayQueueAddEntry, Ptr<SceGxmSyncObject> oldBuffer, Ptr<Sc
     display_callback->pc = host.gxm.params.displayQueueCallback.address();
     display_callback->old_buffer = oldBuffer.address();
     display_callback->new_buffer = newBuffer.address();
+
+    // The interval between entries is the guest's present cadence - track it
+    // per pacing mode so the modes can be compared for a title.
+    const auto now = std::chrono::steady_clock::now();
+    if (host.gxm.last_display_entry != std::chrono::steady_clock::time_point()) {
+        const uint64_t frame_time_us = std::chrono::duration_cast<std::chrono::microseconds>(now - host.gxm.last_display_entry).count();
+        DisplayQueueStatistics &stats = host.gxm.display_statistics[host.gxm.pacing];
+        ++stats.frames;
+        stats.frame_time_total_us += frame_time_us;
+        stats.frame_time_min_us = (stats.frame_time_min_us == 0) ? frame_time_us : std::min(stats.frame_time_min_us, frame_time_us);
+        stats.frame_time_max_us = std::max(stats.frame_time_max_us, frame_time_us);
+
+        // One machine-readable line every ~10s of frames.
+        if ((stats.frames % 600) == 0) {
+            static const char *const pacing_names[DisplayQueuePacingCount] = { "strict", "triple", "unlocked" };
+            LOG_INFO("display_queue pacing={} frames={} avg_us={} min_us={} max_us={}",
+                pacing_names[host.gxm.pacing], stats.frames, stats.frame_time_total_us / stats.frames,
+                stats.frame_time_min_us, stats.frame_time_max_us);
+        }
+    }
+    host.gxm.last_display_entry = now;
+
     host.gxm.display_queue.push(*display_callback);
 
     // TODO Return success if/when we call callback not as a tail call.
@@ -399,81 +578,226 @@ EXPORT(int, sceGxmDisplayQueueFinish) {
     return 0;
 }
 
-EXPORT(int, sceGxmDraw, SceGxmContext *context, SceGxmPrimitiveType primType, SceGxmIndexFormat indexType, const void *indexData, unsigned int indexCount) {
+// Uploads draw data into the buffer bound to target, growing its storage
+// only when a draw needs more. Writing through an invalidating map lets the
+// driver hand back fresh memory instead of stalling on draws still reading
+// the old contents, and avoids the per-draw reallocation of glBufferData.
+static bool same_viewport(const GxmViewport &a, const GxmViewport &b) {
+    if (a.enable != b.enable) {
+        return false;
+    }
+    if (b.enable == SCE_GXM_VIEWPORT_DISABLED) {
+        return true;
+    }
+
+    return (a.offset.x == b.offset.x) && (a.offset.y == b.offset.y) && (a.offset.z == b.offset.z)
+        && (a.scale.x == b.scale.x) && (a.scale.y == b.scale.y) && (a.scale.z == b.scale.z);
+}
+
+// Uploads [offset, offset + size) of a buffer whose earlier bytes are never
+// read this draw - indices below the scanned minimum do not occur, so the
+// window can land at its natural offset without copying what precedes it.
+static void upload_draw_buffer(GLenum target, size_t &capacity, const void *data, size_t offset, size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    const size_t required = offset + size;
+    if (required > capacity) {
+        glBufferData(target, static_cast<GLsizeiptr>(required), nullptr, GL_STREAM_DRAW);
+        capacity = required;
+    }
+
+    void *const staging = glMapBufferRange(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    if (staging != nullptr) {
+        memcpy(staging, data, size);
+        glUnmapBuffer(target);
+    } else {
+        // The driver refused the mapping - upload synchronously.
+        glBufferSubData(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+    }
+}
+
+EXPORT(int, sceGxmDraw, SceGxmContext *context, SceGxmPrimitiveType primType, SceGxmIndexFormat indexType, Ptr<const void> indexData, unsigned int indexCount) {
     assert(context != nullptr);
-    assert(indexData != nullptr);
+    assert(indexData);
 
     if (!host.gxm.isInScene) {
         return RET_ERROR(SCE_GXM_ERROR_NOT_WITHIN_SCENE);
     }
 
-    // TODO Use some kind of caching to avoid setting every draw call?
-    const SharedGLObject program = get_program(*context, host.mem);
-    if (!program) {
-        return RET_ERROR(SCE_GXM_ERROR_DRIVER);
-    }
-    glUseProgram(program->get());
+    ++host.gxm.draw_count;
+
+    if (host.gxm.capture.enabled) {
+        const uint32_t args[] = { static_cast<uint32_t>(primType), static_cast<uint32_t>(indexType), indexData.address(), indexCount };
+        const uint32_t index_bytes = ((indexType == SCE_GXM_INDEX_FORMAT_U16) ? 2 : 4) * indexCount;
+        const GxmCaptureRange range = { indexData.address(), index_bytes, indexData.get(host.mem) };
+        gxm_capture_command(host.gxm.capture, GxmCaptureOp::draw, args, sizeof(args), &range, 1);
+    }
+
+    // The guest thread keeps mutating context->state through the setters
+    // after this call returns, so everything the replay dereferences is
+    // copied into the closure now: programs, uniform-buffer bindings and
+    // stream bases belong to *this* draw, not to whatever is bound when the
+    // render thread catches up.
+    GxmDrawStateSnapshot draw_state;
+    draw_state.fragment_program = context->state.fragment_program;
+    draw_state.vertex_program = context->state.vertex_program;
+    draw_state.fragment_uniform_buffers = context->state.fragment_uniform_buffers;
+    draw_state.vertex_uniform_buffers = context->state.vertex_uniform_buffers;
+    draw_state.fragment_uniform_generation = context->state.fragment_uniform_generation;
+    draw_state.vertex_uniform_generation = context->state.vertex_uniform_generation;
+    draw_state.stream_data = context->state.stream_data;
+    const uint64_t uniform_write_generation = host.gxm.uniform_write_generation;
+
+    // The whole draw - program lookup, uniform upload, index scan, vertex
+    // upload - runs on the render thread. The deferred reads of guest memory
+    // are safe because the guest must leave index and vertex buffers alone
+    // until the scene ends, just like on a real GPU.
+    render_queue(context->renderer.render_thread, [&host, context, draw_state, uniform_write_generation, primType, indexType, indexData, indexCount]() {
+        // TODO Use some kind of caching to avoid setting every draw call?
+        const SharedGLObject program = get_program(*context, draw_state, host.mem, host.gxm, host.pref_path.c_str());
+        if (!program) {
+            // Still compiling on the worker thread - skip the draw rather than
+            // stall the scene. The program is picked up on a later call.
+            return;
+        }
 
-    // TODO Use some kind of caching to avoid setting every draw call?
-    set_uniforms(program->get(), *context, host.mem);
+        GLShadowState &shadow = context->renderer.shadow;
+        if (shadow.program != program->get()) {
+            glUseProgram(program->get());
+            shadow.program = program->get();
+        }
 
-    // Upload index data.
-    const GLsizeiptr index_size = (indexType == SCE_GXM_INDEX_FORMAT_U16) ? 2 : 4;
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_size * indexCount, indexData, GL_STREAM_DRAW);
+        // TODO Use some kind of caching to avoid setting every draw call?
+        set_uniforms(program->get(), *context, draw_state, host.mem, uniform_write_generation);
+
+        const SceGxmVertexProgram *const vertex_program = draw_state.vertex_program.get(host.mem);
+
+        // Bind the configured VAO for this vertex program, specifying the
+        // attribute layout only the first time the program is drawn with.
+        SharedGLObject &vao = context->renderer.vertex_array_cache[vertex_program->renderer_id];
+        if (!vao) {
+            vao = std::make_shared<GLObject>();
+            GLuint name = 0;
+            glGenVertexArrays(1, &name);
+            if (!vao->init(name, [](GLuint name) { glDeleteVertexArrays(1, &name); })) {
+                context->renderer.vertex_array_cache.erase(vertex_program->renderer_id);
+                LOG_ERROR("Failed to initialise a vertex array object - dropping the draw.");
+                return;
+            }
+            glBindVertexArray(vao->get());
+
+            for (const emu::SceGxmVertexAttribute &attribute : vertex_program->attributes) {
+                const SceGxmVertexStream &stream = vertex_program->streams[attribute.streamIndex];
+                const SceGxmAttributeFormat attribute_format = static_cast<SceGxmAttributeFormat>(attribute.format);
+                const GLenum type = attribute_format_to_gl_type(attribute_format);
+                const GLboolean normalised = attribute_format_normalised(attribute_format) ? GL_TRUE : GL_FALSE;
+                const int attrib_location = attribute.regIndex / sizeof(uint32_t);
+
+                glBindBuffer(GL_ARRAY_BUFFER, context->renderer.stream_vertex_buffers[attribute.streamIndex]);
+                glVertexAttribPointer(attrib_location, attribute.componentCount, type, normalised, stream.stride, reinterpret_cast<const GLvoid *>(attribute.offset));
+                glEnableVertexAttribArray(attrib_location);
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        } else if (shadow.vertex_array != vao->get()) {
+            glBindVertexArray(vao->get());
+        }
+        shadow.vertex_array = vao->get();
+
+        gpu_timer_begin(context->renderer.gpu_timer, GPU_TIMER_STAGE_VERTEX_UPLOAD);
+        const uint64_t vertex_upload_start_us = trace_now_us();
+
+        // Bind the cached GL copy of the index buffer. The element buffer
+        // binding is VAO state, so this has to happen with the VAO bound.
+        const size_t index_size = (indexType == SCE_GXM_INDEX_FORMAT_U16) ? 2 : 4;
+        const size_t index_bytes = index_size * indexCount;
+        IndexBufferCacheEntry &entry = context->renderer.index_buffer_cache[indexData.address()];
+        if (!entry.buffer) {
+            entry.buffer = std::make_shared<GLObject>();
+            GLuint name = 0;
+            glGenBuffers(1, &name);
+            if (!entry.buffer->init(name, [](GLuint name) { glDeleteBuffers(1, &name); })) {
+                context->renderer.index_buffer_cache.erase(indexData.address());
+                LOG_ERROR("Failed to initialise an index buffer object - dropping the draw.");
+                return;
+            }
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, entry.buffer->get());
+
+        // Re-read, re-scan and re-upload only when the guest wrote the range
+        // since the last upload, or when this draw covers a different range.
+        // A clean hit reuses both the GL storage and the recorded max index.
+        size_t min_index = entry.min_index;
+        size_t max_index = entry.max_index;
+        if ((entry.size != index_bytes) || range_written_since(host.mem, indexData.address(), index_bytes, entry.write_generation)) {
+            entry.write_generation = current_write_generation(host.mem);
+            track_writes(host.mem, indexData.address(), index_bytes);
+
+            // One pass over the indices yields both window bounds. The loop
+            // is branch-light enough for the compiler to vectorise.
+            const void *const index_data = indexData.get(host.mem);
+            if (indexType == SCE_GXM_INDEX_FORMAT_U16) {
+                const uint16_t *const indices = static_cast<const uint16_t *>(index_data);
+                const auto bounds = std::minmax_element(&indices[0], &indices[indexCount]);
+                min_index = *bounds.first;
+                max_index = *bounds.second;
+            } else {
+                const uint32_t *const indices = static_cast<const uint32_t *>(index_data);
+                const auto bounds = std::minmax_element(&indices[0], &indices[indexCount]);
+                min_index = *bounds.first;
+                max_index = *bounds.second;
+            }
 
-    // Compute size of vertex data.
-    size_t max_index = 0;
-    if (indexType == SCE_GXM_INDEX_FORMAT_U16) {
-        const uint16_t *const indices = static_cast<const uint16_t *>(indexData);
-        max_index = *std::max_element(&indices[0], &indices[indexCount]);
-    } else {
-        const uint32_t *const indices = static_cast<const uint32_t *>(indexData);
-        max_index = *std::max_element(&indices[0], &indices[indexCount]);
-    }
-    const SceGxmVertexProgram *const vertex_program = context->state.vertex_program.get(host.mem);
-    size_t max_data_length[SCE_GXM_MAX_VERTEX_STREAMS] = {};
-    for (const emu::SceGxmVertexAttribute &attribute : vertex_program->attributes) {
-        const SceGxmAttributeFormat attribute_format = static_cast<SceGxmAttributeFormat>(attribute.format);
-        const size_t attribute_size = attribute_format_size(attribute_format) * attribute.componentCount;
-        const SceGxmVertexStream &stream = vertex_program->streams[attribute.streamIndex];
-        const size_t data_length = attribute.offset + (max_index * stream.stride) + attribute_size;
-        max_data_length[attribute.streamIndex] = std::max(max_data_length[attribute.streamIndex], data_length);
-    }
-
-    // Upload vertex data.
-    for (size_t stream_index = 0; stream_index < SCE_GXM_MAX_VERTEX_STREAMS; ++stream_index) {
-        const size_t data_length = max_data_length[stream_index];
-        const void *const data = context->state.stream_data[stream_index].get(host.mem);
-        glBindBuffer(GL_ARRAY_BUFFER, context->renderer.stream_vertex_buffers[stream_index]);
-        glBufferData(GL_ARRAY_BUFFER, data_length, data, GL_STREAM_DRAW);
-    }
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    // Set vertex attribute parameters.
-    // TODO Only set attrib pointer when changed.
-    // TODO Move vertex array object to program cache?
-    for (const emu::SceGxmVertexAttribute &attribute : vertex_program->attributes) {
-        const SceGxmVertexStream &stream = vertex_program->streams[attribute.streamIndex];
-        const SceGxmAttributeFormat attribute_format = static_cast<SceGxmAttributeFormat>(attribute.format);
-        const GLenum type = attribute_format_to_gl_type(attribute_format);
-        const GLboolean normalised = attribute_format_normalised(attribute_format) ? GL_TRUE : GL_FALSE;
-        const int attrib_location = attribute.regIndex / sizeof(uint32_t);
-
-        glBindBuffer(GL_ARRAY_BUFFER, context->renderer.stream_vertex_buffers[attribute.streamIndex]);
-        glVertexAttribPointer(attrib_location, attribute.componentCount, type, normalised, stream.stride, reinterpret_cast<const GLvoid *>(attribute.offset));
-        glEnableVertexAttribArray(attrib_location);
-    }
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    const GLenum mode = translate_primitive(primType);
-    const GLenum type = indexType == SCE_GXM_INDEX_FORMAT_U16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
-    glDrawElements(mode, indexCount, type, nullptr);
-
-    // Disable vertex attribute arrays.
-    for (const emu::SceGxmVertexAttribute &attribute : vertex_program->attributes) {
-        const int attrib_location = attribute.regIndex / sizeof(uint32_t);
-        glDisableVertexAttribArray(attrib_location);
-    }
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(index_bytes), index_data, GL_STATIC_DRAW);
+            entry.size = index_bytes;
+            entry.min_index = min_index;
+            entry.max_index = max_index;
+        }
+
+        size_t max_data_length[SCE_GXM_MAX_VERTEX_STREAMS] = {};
+        for (const emu::SceGxmVertexAttribute &attribute : vertex_program->attributes) {
+            const SceGxmAttributeFormat attribute_format = static_cast<SceGxmAttributeFormat>(attribute.format);
+            const size_t attribute_size = attribute_format_size(attribute_format) * attribute.componentCount;
+            const SceGxmVertexStream &stream = vertex_program->streams[attribute.streamIndex];
+            const size_t data_length = attribute.offset + (max_index * stream.stride) + attribute_size;
+            max_data_length[attribute.streamIndex] = std::max(max_data_length[attribute.streamIndex], data_length);
+        }
+
+        // Upload vertex data. The byte range per stream was computed above
+        // from the attribute strides and the index range actually drawn -
+        // bytes below min_index * stride are unreferenced and stay behind.
+        for (size_t stream_index = 0; stream_index < SCE_GXM_MAX_VERTEX_STREAMS; ++stream_index) {
+            size_t data_length = max_data_length[stream_index];
+            if (data_length == 0) {
+                continue;
+            }
+
+            // The attribute scan over-estimates for sparse index ranges;
+            // clamp to the sceGxmMapMemory region so the upload never reads
+            // past what the title actually mapped.
+            const Address stream_base = draw_state.stream_data[stream_index].address();
+            MappedRegion region;
+            if (resolve_mapped_region(host.gxm, stream_base, &region)) {
+                data_length = std::min<size_t>(data_length, region.base + region.size - stream_base);
+            }
+
+            const size_t window_start = std::min<size_t>(min_index * vertex_program->streams[stream_index].stride, data_length);
+
+            const uint8_t *const data = Ptr<const uint8_t>(stream_base).get(host.mem);
+            glBindBuffer(GL_ARRAY_BUFFER, context->renderer.stream_vertex_buffers[stream_index]);
+            upload_draw_buffer(GL_ARRAY_BUFFER, context->renderer.stream_vertex_buffer_sizes[stream_index], data + window_start, window_start, data_length - window_start);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        gpu_timer_end(context->renderer.gpu_timer, GPU_TIMER_STAGE_VERTEX_UPLOAD);
+        hitch_add_stage_time(HITCH_STAGE_VERTEX_UPLOAD, trace_now_us() - vertex_upload_start_us);
+
+        const GLenum mode = translate_primitive(primType);
+        const GLenum type = indexType == SCE_GXM_INDEX_FORMAT_U16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        gpu_timer_begin(context->renderer.gpu_timer, GPU_TIMER_STAGE_DRAW);
+        glDrawElements(mode, indexCount, type, nullptr);
+        gpu_timer_end(context->renderer.gpu_timer, GPU_TIMER_STAGE_DRAW);
+    });
 
     return 0;
 }
@@ -491,6 +815,7 @@ EXPORT(int, sceGxmEndCommandList) {
 }
 
 EXPORT(int, sceGxmEndScene, SceGxmContext *context, const emu::SceGxmNotification *vertexNotification, const emu::SceGxmNotification *fragmentNotification) {
+    const TraceScope trace("sceGxmEndScene");
     const MemState &mem = host.mem;
     assert(context != nullptr);
     assert(vertexNotification == nullptr);
@@ -500,23 +825,63 @@ EXPORT(int, sceGxmEndScene, SceGxmContext *context, const emu::SceGxmNotificatio
         return RET_ERROR(SCE_GXM_ERROR_NOT_WITHIN_SCENE);
     }
 
+    gxm_capture_command(host.gxm.capture, GxmCaptureOp::end_scene, nullptr, 0, nullptr, 0);
+
     const GLsizei width = context->state.color_surface.pbeEmitWords[0];
     const GLsizei height = context->state.color_surface.pbeEmitWords[1];
     const GLsizei stride_in_pixels = context->state.color_surface.pbeEmitWords[2];
     const Address data = context->state.color_surface.pbeEmitWords[3];
     uint32_t *const pixels = Ptr<uint32_t>(data).get(mem);
-    glPixelStorei(GL_PACK_ROW_LENGTH, stride_in_pixels); // TODO Reset to 0?
-    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
-    flip_vertically(pixels, width, height, stride_in_pixels);
+
+    // Reading the frame back is the hard sync point of a scene - wait for
+    // every recorded command so the guest sees the finished image.
+    const uint32_t multiplier = host.gxm.resolution_multiplier;
+    render_queue(context->renderer.render_thread, [context, width, height, stride_in_pixels, pixels, multiplier]() {
+        RendererContextState &renderer = context->renderer;
+
+        // Blit the scene into the flip framebuffer upside down, so the
+        // readback comes out in guest row order and the CPU never has to
+        // reorder the whole frame. The flip target stays at guest size, so
+        // this blit also downsamples when rendering at a higher internal
+        // resolution and the readback cost does not grow with it.
+        if ((renderer.flip_width != static_cast<uint32_t>(width)) || (renderer.flip_height != static_cast<uint32_t>(height))) {
+            glBindRenderbuffer(GL_RENDERBUFFER, renderer.flip_renderbuffer[0]);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA, width, height);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, renderer.flip_framebuffer[0]);
+            glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderer.flip_renderbuffer[0]);
+            renderer.flip_width = width;
+            renderer.flip_height = height;
+        } else {
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, renderer.flip_framebuffer[0]);
+        }
+        const GLenum filter = (multiplier > 1) ? GL_LINEAR : GL_NEAREST;
+        glBlitFramebuffer(0, 0, width * multiplier, height * multiplier, 0, height, width, 0, GL_COLOR_BUFFER_BIT, filter);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, renderer.flip_framebuffer[0]);
+        glPixelStorei(GL_PACK_ROW_LENGTH, stride_in_pixels); // TODO Reset to 0?
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+        // The texture cache's scene clock lives on this thread now.
+        ++renderer.texture_cache.timestamp;
+
+        // Scene end is the frame boundary for the stage timers.
+        gpu_timer_end_frame(renderer.gpu_timer);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    });
+    render_sync(context->renderer.render_thread);
+
     if (fragmentNotification) {
         volatile uint32_t *fragment_address = fragmentNotification->address.get(host.mem);
-        *fragment_address = fragmentNotification->value;
+        {
+            const std::lock_guard<std::mutex> lock(host.gxm.notification_mutex);
+            *fragment_address = fragmentNotification->value;
+        }
+        host.gxm.notification_cv.notify_all();
     }
 
     host.gxm.isInScene = false;
-    ++context->renderer.texture_cache.timestamp;
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
     return 0;
 }
@@ -526,8 +891,13 @@ EXPORT(int, sceGxmExecuteCommandList) {
 }
 
 EXPORT(void, sceGxmFinish, SceGxmContext *context) {
+    const TraceScope trace("sceGxmFinish");
     assert(context != nullptr);
-    glFinish();
+
+    render_queue(context->renderer.render_thread, []() {
+        glFinish();
+    });
+    render_sync(context->renderer.render_thread);
 }
 
 EXPORT(int, sceGxmFragmentProgramGetPassType) {
@@ -588,12 +958,9 @@ struct GxmThreadParams {
     MemState *mem = nullptr;
     SceUID thid = SCE_KERNEL_ERROR_ILLEGAL_THREAD_ID;
     GxmState *gxm = nullptr;
-    std::shared_ptr<SDL_semaphore> host_may_destroy_params = std::shared_ptr<SDL_semaphore>(SDL_CreateSemaphore(0), SDL_DestroySemaphore);
 };
 
-static int SDLCALL thread_function(void *data) {
-    const GxmThreadParams params = *static_cast<const GxmThreadParams *>(data);
-    SDL_SemPost(params.host_may_destroy_params.get());
+static void thread_function(const GxmThreadParams &params) {
     while (true) {
         auto display_callback = params.gxm->display_queue.pop();
         if (!display_callback)
@@ -611,19 +978,18 @@ static int SDLCALL thread_function(void *data) {
         newBuffer.get(*params.mem)->cond_var.notify_all();
         free(*params.mem, display_callback->data);
     }
-    return 0;
 }
 
 EXPORT(int, sceGxmInitialize, const emu::SceGxmInitializeParams *params) {
     assert(params != nullptr);
 
     host.gxm.params = *params;
-    host.gxm.display_queue.displayQueueMaxPendingCount_ = params->displayQueueMaxPendingCount;
+    apply_display_pacing(host.gxm);
 
     const ThreadStatePtr main_thread = find(thread_id, host.kernel.threads);
 
-    const CallImport call_import = [&host](CPUState &cpu, uint32_t nid, SceUID thread_id) {
-        ::call_import(host, cpu, nid, thread_id);
+    const CallImport call_import = [&host](CPUState &cpu, uint32_t imm, Address pc, SceUID thread_id) {
+        ::call_import(host, cpu, imm, pc, thread_id);
     };
 
     const auto stack_size = SCE_KERNEL_STACK_SIZE_USER_DEFAULT; // TODO: Verify this is the correct stack size
@@ -636,7 +1002,7 @@ EXPORT(int, sceGxmInitialize, const emu::SceGxmInitializeParams *params) {
 
     const ThreadStatePtr display_thread = find(display_thread_id, host.kernel.threads);
 
-    const std::function<void(SDL_Thread *)> delete_thread = [display_thread](SDL_Thread *running_thread) {
+    const std::function<void(PooledWorker *)> delete_thread = [display_thread](PooledWorker *) {
         {
             const std::lock_guard<std::mutex> lock(display_thread->mutex);
             display_thread->to_do = ThreadToDo::exit;
@@ -650,8 +1016,13 @@ EXPORT(int, sceGxmInitialize, const emu::SceGxmInitializeParams *params) {
     gxm_params.thid = display_thread_id;
     gxm_params.gxm = &host.gxm;
 
-    const ThreadPtr running_thread(SDL_CreateThread(&thread_function, "SceGxmDisplayQueue", &gxm_params), delete_thread);
-    SDL_SemWait(gxm_params.host_may_destroy_params.get());
+    PooledWorker *const worker = run_on_worker(host.kernel.thread_pool, [gxm_params]() {
+        thread_function(gxm_params);
+    });
+    if (!worker) {
+        return RET_ERROR(SCE_GXM_ERROR_DRIVER);
+    }
+    const ThreadPtr running_thread(worker, delete_thread);
     host.kernel.running_threads.emplace(display_thread_id, running_thread);
     host.gxm.notification_region = Ptr<uint32_t>(alloc(host.mem, MB(1), "SceGxmNotificationRegion"));
     memset(host.gxm.notification_region.get(host.mem), 0, MB(1));
@@ -670,14 +1041,16 @@ EXPORT(int, sceGxmMapFragmentUsseMemory, Ptr<void> base, SceSize size, unsigned
     // TODO What should this be?
     *offset = base.address();
 
+    register_mapped_region(host.gxm, base.address(), size, MAPPED_REGION_FRAGMENT_USSE, false);
     return 0;
 }
 
-EXPORT(int, sceGxmMapMemory, void *base, SceSize size, SceGxmMemoryAttribFlags attr) {
-    assert(base != nullptr);
+EXPORT(int, sceGxmMapMemory, Ptr<void> base, SceSize size, SceGxmMemoryAttribFlags attr) {
+    assert(base);
     assert(size > 0);
     assert((attr == SCE_GXM_MEMORY_ATTRIB_READ) || (attr == SCE_GXM_MEMORY_ATTRIB_RW));
 
+    register_mapped_region(host.gxm, base.address(), size, MAPPED_REGION_GENERIC, attr == SCE_GXM_MEMORY_ATTRIB_RW);
     return 0;
 }
 
@@ -689,6 +1062,7 @@ EXPORT(int, sceGxmMapVertexUsseMemory, Ptr<void> base, SceSize size, unsigned in
     // TODO What should this be?
     *offset = base.address();
 
+    register_mapped_region(host.gxm, base.address(), size, MAPPED_REGION_VERTEX_USSE, false);
     return 0;
 }
 
@@ -696,8 +1070,19 @@ EXPORT(int, sceGxmMidSceneFlush) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceGxmNotificationWait) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceGxmNotificationWait, const emu::SceGxmNotification *notification) {
+    assert(notification != nullptr);
+
+    const volatile uint32_t *const address = notification->address.get(host.mem);
+    const uint32_t value = notification->value;
+
+    // Writers update the word under the same mutex before notifying, so the
+    // recheck-and-sleep here cannot miss a signal.
+    std::unique_lock<std::mutex> lock(host.gxm.notification_mutex);
+    host.gxm.notification_cv.wait(lock, [address, value]() {
+        return *address == value;
+    });
+    return 0;
 }
 
 EXPORT(int, sceGxmPadHeartbeat, const emu::SceGxmColorSurface *displaySurface, SceGxmSyncObject *displaySyncObject) {
@@ -985,6 +1370,12 @@ EXPORT(int, sceGxmReserveFragmentDefaultUniformBuffer, SceGxmContext *context, P
     context->state.fragment_ring_buffer_used = next_used;
 
     context->state.fragment_uniform_buffers[14] = *uniformBuffer;
+    ++context->state.fragment_uniform_generation;
+
+    if (host.gxm.capture.enabled) {
+        const uint32_t args[] = { uniformBuffer->address(), static_cast<uint32_t>(size) };
+        gxm_capture_command(host.gxm.capture, GxmCaptureOp::reserve_fragment_uniform, args, sizeof(args), nullptr, 0);
+    }
 
     return 0;
 }
@@ -1008,6 +1399,12 @@ EXPORT(int, sceGxmReserveVertexDefaultUniformBuffer, SceGxmContext *context, Ptr
     context->state.vertex_ring_buffer_used = next_used;
 
     context->state.vertex_uniform_buffers[14] = *uniformBuffer;
+    ++context->state.vertex_uniform_generation;
+
+    if (host.gxm.capture.enabled) {
+        const uint32_t args[] = { uniformBuffer->address(), static_cast<uint32_t>(size) };
+        gxm_capture_command(host.gxm.capture, GxmCaptureOp::reserve_vertex_uniform, args, sizeof(args), nullptr, 0);
+    }
 
     return 0;
 }
@@ -1053,19 +1450,23 @@ EXPORT(void, sceGxmSetBackStencilFunc, SceGxmContext *context, SceGxmStencilFunc
     context->state.back_stencil.write_mask = writeMask;
 
     if (context->state.two_sided == SCE_GXM_TWO_SIDED_ENABLED) {
-        glEnable(GL_STENCIL_TEST);
+        const GLenum gl_func = translate_stencil_func(func);
+        const GLenum sfail = translate_stencil_op(stencilFail);
+        const GLenum dpfail = translate_stencil_op(depthFail);
+        const GLenum dppass = translate_stencil_op(depthPass);
 
-        GLenum gl_func = translate_stencil_func(func);
-        GLenum sfail = translate_stencil_op(stencilFail);
-        GLenum dpfail = translate_stencil_op(depthFail);
-        GLenum dppass = translate_stencil_op(depthPass);
+        // The stencil ref read-back executes in order on the render thread
+        // and never reaches the guest, so no sync is needed.
+        render_queue(context->renderer.render_thread, [gl_func, sfail, dpfail, dppass, compareMask, writeMask]() {
+            glEnable(GL_STENCIL_TEST);
 
-        GLint sref;
-        glGetIntegerv(GL_STENCIL_BACK_REF, &sref);
+            GLint sref;
+            glGetIntegerv(GL_STENCIL_BACK_REF, &sref);
 
-        glStencilOpSeparate(GL_BACK, sfail, dpfail, dppass);
-        glStencilFuncSeparate(GL_BACK, gl_func, sref, compareMask);
-        glStencilMaskSeparate(GL_BACK, writeMask);
+            glStencilOpSeparate(GL_BACK, sfail, dpfail, dppass);
+            glStencilFuncSeparate(GL_BACK, gl_func, sref, compareMask);
+            glStencilMaskSeparate(GL_BACK, writeMask);
+        });
     }
 }
 
@@ -1073,13 +1474,15 @@ EXPORT(void, sceGxmSetBackStencilRef, SceGxmContext *context, unsigned int sref)
     context->state.back_stencil.ref = sref;
 
     if (context->state.two_sided == SCE_GXM_TWO_SIDED_ENABLED) {
-        glEnable(GL_STENCIL_TEST);
+        render_queue(context->renderer.render_thread, [sref]() {
+            glEnable(GL_STENCIL_TEST);
 
-        GLint stencil_config[2];
-        glGetIntegerv(GL_STENCIL_BACK_FUNC, &stencil_config[0]);
-        glGetIntegerv(GL_STENCIL_BACK_VALUE_MASK, &stencil_config[1]);
+            GLint stencil_config[2];
+            glGetIntegerv(GL_STENCIL_BACK_FUNC, &stencil_config[0]);
+            glGetIntegerv(GL_STENCIL_BACK_VALUE_MASK, &stencil_config[1]);
 
-        glStencilFuncSeparate(GL_BACK, static_cast<GLenum>(stencil_config[0]), sref, stencil_config[1]);
+            glStencilFuncSeparate(GL_BACK, static_cast<GLenum>(stencil_config[0]), sref, stencil_config[1]);
+        });
     }
 }
 
@@ -1097,19 +1500,28 @@ EXPORT(int, sceGxmSetBackVisibilityTestOp) {
 
 EXPORT(int, sceGxmSetCullMode, SceGxmContext *context, SceGxmCullMode mode) {
     context->state.cull_mode = mode;
-    switch (mode) {
-    case SCE_GXM_CULL_CCW:
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_FRONT);
-        break;
-    case SCE_GXM_CULL_CW:
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
-        break;
-    case SCE_GXM_CULL_NONE:
-        glDisable(GL_CULL_FACE);
-        break;
-    }
+    render_queue(context->renderer.render_thread, [context, mode]() {
+        GLShadowState &shadow = context->renderer.shadow;
+        if (shadow.cull_valid && (shadow.cull_mode == mode)) {
+            return;
+        }
+
+        switch (mode) {
+        case SCE_GXM_CULL_CCW:
+            glEnable(GL_CULL_FACE);
+            glCullFace(GL_FRONT);
+            break;
+        case SCE_GXM_CULL_CW:
+            glEnable(GL_CULL_FACE);
+            glCullFace(GL_BACK);
+            break;
+        case SCE_GXM_CULL_NONE:
+            glDisable(GL_CULL_FACE);
+            break;
+        }
+        shadow.cull_valid = true;
+        shadow.cull_mode = mode;
+    });
     return 0;
 }
 
@@ -1139,15 +1551,55 @@ EXPORT(void, sceGxmSetFragmentProgram, SceGxmContext *context, Ptr<const SceGxmF
 
     context->state.fragment_program = fragmentProgram;
 
-    const SceGxmFragmentProgram &fragment_program = *fragmentProgram.get(host.mem);
-    glColorMask(fragment_program.color_mask_red, fragment_program.color_mask_green, fragment_program.color_mask_blue, fragment_program.color_mask_alpha);
-    if (fragment_program.blend_enabled) {
-        glEnable(GL_BLEND);
-        glBlendEquationSeparate(fragment_program.color_func, fragment_program.alpha_func);
-        glBlendFuncSeparate(fragment_program.color_src, fragment_program.color_dst, fragment_program.alpha_src, fragment_program.alpha_dst);
-    } else {
-        glDisable(GL_BLEND);
-    }
+    if (host.gxm.capture.enabled) {
+        const uint32_t address = fragmentProgram.address();
+        gxm_capture_command(host.gxm.capture, GxmCaptureOp::set_fragment_program, &address, sizeof(address), nullptr, 0);
+    }
+
+    const SceGxmFragmentProgram *const fragment_program = fragmentProgram.get(host.mem);
+    render_queue(context->renderer.render_thread, [context, fragment_program]() {
+        GLShadowState &shadow = context->renderer.shadow;
+        const bool same = shadow.blend_valid
+            && (shadow.color_mask_red == fragment_program->color_mask_red)
+            && (shadow.color_mask_green == fragment_program->color_mask_green)
+            && (shadow.color_mask_blue == fragment_program->color_mask_blue)
+            && (shadow.color_mask_alpha == fragment_program->color_mask_alpha)
+            && (shadow.blend_enabled == fragment_program->blend_enabled)
+            && (!fragment_program->blend_enabled
+                   || ((shadow.color_func == fragment_program->color_func)
+                          && (shadow.alpha_func == fragment_program->alpha_func)
+                          && (shadow.color_src == fragment_program->color_src)
+                          && (shadow.color_dst == fragment_program->color_dst)
+                          && (shadow.alpha_src == fragment_program->alpha_src)
+                          && (shadow.alpha_dst == fragment_program->alpha_dst)));
+        if (same) {
+            return;
+        }
+
+        glColorMask(fragment_program->color_mask_red, fragment_program->color_mask_green, fragment_program->color_mask_blue, fragment_program->color_mask_alpha);
+        if (fragment_program->blend_enabled) {
+            glEnable(GL_BLEND);
+            glBlendEquationSeparate(fragment_program->color_func, fragment_program->alpha_func);
+            glBlendFuncSeparate(fragment_program->color_src, fragment_program->color_dst, fragment_program->alpha_src, fragment_program->alpha_dst);
+        } else {
+            glDisable(GL_BLEND);
+        }
+
+        shadow.blend_valid = true;
+        shadow.color_mask_red = fragment_program->color_mask_red;
+        shadow.color_mask_green = fragment_program->color_mask_green;
+        shadow.color_mask_blue = fragment_program->color_mask_blue;
+        shadow.color_mask_alpha = fragment_program->color_mask_alpha;
+        shadow.blend_enabled = fragment_program->blend_enabled;
+        if (fragment_program->blend_enabled) {
+            shadow.color_func = fragment_program->color_func;
+            shadow.alpha_func = fragment_program->alpha_func;
+            shadow.color_src = fragment_program->color_src;
+            shadow.color_dst = fragment_program->color_dst;
+            shadow.alpha_src = fragment_program->alpha_src;
+            shadow.alpha_dst = fragment_program->alpha_dst;
+        }
+    });
 }
 
 EXPORT(int, sceGxmSetFragmentTexture, SceGxmContext *context, unsigned int textureIndex, const SceGxmTexture *texture) {
@@ -1156,8 +1608,44 @@ EXPORT(int, sceGxmSetFragmentTexture, SceGxmContext *context, unsigned int textu
 
     context->state.fragment_textures[textureIndex] = *texture;
 
-    glActiveTexture((GLenum)(GL_TEXTURE0 + textureIndex));
-    cache_and_bind_texture(context->renderer.texture_cache, *texture, host.mem, host.gui.texture_cache);
+    if (host.gxm.capture.enabled) {
+        struct {
+            uint32_t texture_index;
+            SceGxmTexture texture;
+        } args = { textureIndex, *texture };
+        gxm_capture_command(host.gxm.capture, GxmCaptureOp::set_fragment_texture, &args, sizeof(args), nullptr, 0);
+    }
+
+    // The control words are copied so a later rebind on the guest thread
+    // cannot change what this command uploads. The texture cache itself is
+    // only ever touched from the render thread.
+    const SceGxmTexture texture_copy = *texture;
+    MemState *const mem = &host.mem;
+    const bool enabled = host.gui.texture_cache;
+    render_queue(context->renderer.render_thread, [context, textureIndex, texture_copy, mem, enabled]() {
+        GLShadowState &shadow = context->renderer.shadow;
+        glActiveTexture((GLenum)(GL_TEXTURE0 + textureIndex));
+
+        // A surface rendered by an earlier scene is sampled straight from
+        // its framebuffer texture - no hash, no upload. The image has GL's
+        // bottom-up orientation, unlike the flipped copy in guest memory.
+        const Address data = texture_copy.data_addr << 2;
+        const SharedGLObject surface = find_surface_texture(context->renderer.surface_cache, data, texture::get_width(&texture_copy), texture::get_height(&texture_copy));
+        if (surface) {
+            if (shadow.textures[textureIndex] != surface->get()) {
+                glBindTexture(GL_TEXTURE_2D, surface->get());
+                shadow.textures[textureIndex] = surface->get();
+            }
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture::translate_minmag_filter((SceGxmTextureFilter)texture_copy.min_filter));
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture::translate_minmag_filter((SceGxmTextureFilter)texture_copy.mag_filter));
+            return;
+        }
+
+        gpu_timer_begin(context->renderer.gpu_timer, GPU_TIMER_STAGE_TEXTURE_UPLOAD);
+        const HitchStageScope hitch(HITCH_STAGE_TEXTURE_UPLOAD);
+        shadow.textures[textureIndex] = cache_and_bind_texture(context->renderer.texture_cache, texture_copy, *mem, enabled, shadow.textures[textureIndex]);
+        gpu_timer_end(context->renderer.gpu_timer, GPU_TIMER_STAGE_TEXTURE_UPLOAD);
+    });
 
     return 0;
 }
@@ -1173,12 +1661,22 @@ EXPORT(int, sceGxmSetFrontDepthBias) {
 EXPORT(void, sceGxmSetFrontDepthFunc, SceGxmContext *context, SceGxmDepthFunc depthFunc) {
     context->state.front_depth_func = depthFunc;
 
-    glEnable(GL_DEPTH_TEST);
     if (context->state.two_sided == SCE_GXM_TWO_SIDED_ENABLED) {
         // TODO: Find a way to implement this since glDepthFuncSeparate doesn't exist
         LOG_WARN("sceGxmSetFrontDepthFunc called with a two sided context, graphical glitches may happen.");
     }
-    glDepthFunc(translate_depth_func(depthFunc));
+
+    const GLenum gl_func = translate_depth_func(depthFunc);
+    render_queue(context->renderer.render_thread, [context, gl_func]() {
+        GLShadowState &shadow = context->renderer.shadow;
+        if (shadow.depth_func_valid && (shadow.depth_func == gl_func)) {
+            return;
+        }
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(gl_func);
+        shadow.depth_func_valid = true;
+        shadow.depth_func = gl_func;
+    });
 }
 
 EXPORT(void, sceGxmSetFrontDepthWriteEnable, SceGxmContext *context, SceGxmDepthWriteMode enable) {
@@ -1188,7 +1686,17 @@ EXPORT(void, sceGxmSetFrontDepthWriteEnable, SceGxmContext *context, SceGxmDepth
         // TODO: Find a way to implement this since glDepthMaskSeparate doesn't exist
         LOG_WARN("sceGxmSetFrontDepthWriteEnable called with a two sided context, graphical glitches may happen.");
     }
-    glDepthMask(enable == SCE_GXM_DEPTH_WRITE_ENABLED ? GL_TRUE : GL_FALSE);
+
+    const GLboolean mask = (enable == SCE_GXM_DEPTH_WRITE_ENABLED) ? GL_TRUE : GL_FALSE;
+    render_queue(context->renderer.render_thread, [context, mask]() {
+        GLShadowState &shadow = context->renderer.shadow;
+        if (shadow.depth_mask_valid && (shadow.depth_mask == mask)) {
+            return;
+        }
+        glDepthMask(mask);
+        shadow.depth_mask_valid = true;
+        shadow.depth_mask = mask;
+    });
 }
 
 EXPORT(int, sceGxmSetFrontFragmentProgramEnable) {
@@ -1215,34 +1723,38 @@ EXPORT(void, sceGxmSetFrontStencilFunc, SceGxmContext *context, SceGxmStencilFun
     context->state.front_stencil.compare_mask = compareMask;
     context->state.front_stencil.write_mask = writeMask;
 
-    glEnable(GL_STENCIL_TEST);
+    const GLenum face = (context->state.two_sided == SCE_GXM_TWO_SIDED_ENABLED) ? GL_FRONT : GL_FRONT_AND_BACK;
+    const GLenum gl_func = translate_stencil_func(func);
+    const GLenum sfail = translate_stencil_op(stencilFail);
+    const GLenum dpfail = translate_stencil_op(depthFail);
+    const GLenum dppass = translate_stencil_op(depthPass);
 
-    GLenum face = (context->state.two_sided == SCE_GXM_TWO_SIDED_ENABLED) ? GL_FRONT : GL_FRONT_AND_BACK;
-    GLenum gl_func = translate_stencil_func(func);
-    GLenum sfail = translate_stencil_op(stencilFail);
-    GLenum dpfail = translate_stencil_op(depthFail);
-    GLenum dppass = translate_stencil_op(depthPass);
+    render_queue(context->renderer.render_thread, [face, gl_func, sfail, dpfail, dppass, compareMask, writeMask]() {
+        glEnable(GL_STENCIL_TEST);
 
-    GLint sref;
-    glGetIntegerv(GL_STENCIL_REF, &sref);
+        GLint sref;
+        glGetIntegerv(GL_STENCIL_REF, &sref);
 
-    glStencilOpSeparate(face, sfail, dpfail, dppass);
-    glStencilFuncSeparate(face, gl_func, sref, compareMask);
-    glStencilMaskSeparate(face, writeMask);
+        glStencilOpSeparate(face, sfail, dpfail, dppass);
+        glStencilFuncSeparate(face, gl_func, sref, compareMask);
+        glStencilMaskSeparate(face, writeMask);
+    });
 }
 
 EXPORT(void, sceGxmSetFrontStencilRef, SceGxmContext *context, unsigned int sref) {
     context->state.front_stencil.ref = sref;
 
-    glEnable(GL_STENCIL_TEST);
+    const GLenum face = (context->state.two_sided == SCE_GXM_TWO_SIDED_ENABLED) ? GL_FRONT : GL_FRONT_AND_BACK;
 
-    GLenum face = (context->state.two_sided == SCE_GXM_TWO_SIDED_ENABLED) ? GL_FRONT : GL_FRONT_AND_BACK;
+    render_queue(context->renderer.render_thread, [face, sref]() {
+        glEnable(GL_STENCIL_TEST);
 
-    GLint stencil_config[2];
-    glGetIntegerv(GL_STENCIL_FUNC, &stencil_config[0]);
-    glGetIntegerv(GL_STENCIL_VALUE_MASK, &stencil_config[1]);
+        GLint stencil_config[2];
+        glGetIntegerv(GL_STENCIL_FUNC, &stencil_config[0]);
+        glGetIntegerv(GL_STENCIL_VALUE_MASK, &stencil_config[1]);
 
-    glStencilFuncSeparate(face, static_cast<GLenum>(stencil_config[0]), sref, stencil_config[1]);
+        glStencilFuncSeparate(face, static_cast<GLenum>(stencil_config[0]), sref, stencil_config[1]);
+    });
 }
 
 EXPORT(int, sceGxmSetFrontVisibilityTestEnable) {
@@ -1276,21 +1788,26 @@ EXPORT(void, sceGxmSetRegionClip, SceGxmContext *context, SceGxmRegionClipMode m
     yMin += yMin % 32;
     xMax += xMax % 32;
     yMax += yMax % 32;
-    switch (mode) {
-    case SCE_GXM_REGION_CLIP_NONE:
-        glScissor(0, 0, host.display.image_size.width, host.display.image_size.height);
-        break;
-    case SCE_GXM_REGION_CLIP_ALL:
-        glScissor(0, 0, 0, 0);
-        break;
-    case SCE_GXM_REGION_CLIP_OUTSIDE:
-        glScissor(xMin, host.display.image_size.height - yMax, xMin + xMax, yMin + yMax);
-        break;
-    case SCE_GXM_REGION_CLIP_INSIDE:
-        // TODO: Implement this
-        LOG_WARN("Unimplemented region clip mode used: SCE_GXM_REGION_CLIP_INSIDE");
-        break;
-    }
+    const GLsizei display_width = host.display.image_size.width;
+    const GLsizei display_height = host.display.image_size.height;
+    const uint32_t multiplier = host.gxm.resolution_multiplier;
+    render_queue(context->renderer.render_thread, [mode, xMin, yMin, xMax, yMax, display_width, display_height, multiplier]() {
+        switch (mode) {
+        case SCE_GXM_REGION_CLIP_NONE:
+            glScissor(0, 0, display_width * multiplier, display_height * multiplier);
+            break;
+        case SCE_GXM_REGION_CLIP_ALL:
+            glScissor(0, 0, 0, 0);
+            break;
+        case SCE_GXM_REGION_CLIP_OUTSIDE:
+            glScissor(xMin * multiplier, (display_height - yMax) * multiplier, (xMin + xMax) * multiplier, (yMin + yMax) * multiplier);
+            break;
+        case SCE_GXM_REGION_CLIP_INSIDE:
+            // TODO: Implement this
+            LOG_WARN("Unimplemented region clip mode used: SCE_GXM_REGION_CLIP_INSIDE");
+            break;
+        }
+    });
 }
 
 EXPORT(void, sceGxmSetTwoSidedEnable, SceGxmContext *context, SceGxmTwoSidedMode mode) {
@@ -1307,6 +1824,11 @@ EXPORT(int, sceGxmSetUniformDataF, void *uniformBuffer, const SceGxmProgramParam
     size_t size = componentCount * sizeof(float);
     size_t offset = componentOffset * sizeof(float);
     memcpy(static_cast<uint8_t *>(uniformBuffer) + offset, sourceData, size);
+
+    // Only the buffer pointer is visible here, so invalidate uniform
+    // skipping globally rather than per context.
+    ++host.gxm.uniform_write_generation;
+
     return 0;
 }
 
@@ -1327,6 +1849,11 @@ EXPORT(void, sceGxmSetVertexProgram, SceGxmContext *context, Ptr<const SceGxmVer
     assert(vertexProgram);
 
     context->state.vertex_program = vertexProgram;
+
+    if (host.gxm.capture.enabled) {
+        const uint32_t address = vertexProgram.address();
+        gxm_capture_command(host.gxm.capture, GxmCaptureOp::set_vertex_program, &address, sizeof(address), nullptr, 0);
+    }
 }
 
 EXPORT(int, sceGxmSetVertexStream, SceGxmContext *context, unsigned int streamIndex, Ptr<const void> streamData) {
@@ -1354,12 +1881,40 @@ EXPORT(void, sceGxmSetViewport, SceGxmContext *context, float xOffset, float xSc
     context->state.viewport.scale.x = xScale;
     context->state.viewport.scale.y = yScale;
     context->state.viewport.scale.z = zScale;
-    set_viewport(context->state.viewport, host.display.image_size.width, host.display.image_size.height);
+
+    const GxmViewport viewport = context->state.viewport;
+    const GLsizei display_width = host.display.image_size.width;
+    const GLsizei display_height = host.display.image_size.height;
+    const uint32_t multiplier = host.gxm.resolution_multiplier;
+    render_queue(context->renderer.render_thread, [context, viewport, display_width, display_height, multiplier]() {
+        GLShadowState &shadow = context->renderer.shadow;
+        if (shadow.viewport_valid && (shadow.viewport_multiplier == multiplier) && same_viewport(shadow.viewport, viewport)) {
+            return;
+        }
+        set_viewport(viewport, display_width, display_height, multiplier);
+        shadow.viewport_valid = true;
+        shadow.viewport = viewport;
+        shadow.viewport_multiplier = multiplier;
+    });
 }
 
 EXPORT(void, sceGxmSetViewportEnable, SceGxmContext *context, SceGxmViewportMode enable) {
     context->state.viewport.enable = enable;
-    set_viewport(context->state.viewport, host.display.image_size.width, host.display.image_size.height);
+
+    const GxmViewport viewport = context->state.viewport;
+    const GLsizei display_width = host.display.image_size.width;
+    const GLsizei display_height = host.display.image_size.height;
+    const uint32_t multiplier = host.gxm.resolution_multiplier;
+    render_queue(context->renderer.render_thread, [context, viewport, display_width, display_height, multiplier]() {
+        GLShadowState &shadow = context->renderer.shadow;
+        if (shadow.viewport_valid && (shadow.viewport_multiplier == multiplier) && same_viewport(shadow.viewport, viewport)) {
+            return;
+        }
+        set_viewport(viewport, display_width, display_height, multiplier);
+        shadow.viewport_valid = true;
+        shadow.viewport = viewport;
+        shadow.viewport_multiplier = multiplier;
+    });
 }
 
 EXPORT(int, sceGxmSetVisibilityBuffer) {
@@ -1454,7 +2009,7 @@ EXPORT(int, sceGxmShaderPatcherCreateFragmentProgram, SceGxmShaderPatcher *shade
 
     SceGxmFragmentProgram *const fp = fragmentProgram->get(mem);
     fp->program = programId->program;
-    fp->glsl = get_fragment_glsl(*shaderPatcher, *programId->program.get(mem), host.base_path.c_str());
+    fp->glsl = get_fragment_glsl(*shaderPatcher, host.gxm.shaders_db, *programId->program.get(mem), host.base_path.c_str());
 
     // Translate blending.
     if (blendInfo != nullptr) {
@@ -1490,7 +2045,7 @@ EXPORT(int, sceGxmShaderPatcherCreateMaskUpdateFragmentProgram, SceGxmShaderPatc
     SceGxmFragmentProgram *const fp = fragmentProgram->get(mem);
     fp->program = alloc(mem, size_mask_gxp, __FUNCTION__);
     memcpy(const_cast<SceGxmProgram *>(fp->program.get(mem)), mask_gxp, size_mask_gxp);
-    fp->glsl = get_fragment_glsl(*shaderPatcher, *fp->program.get(mem), host.base_path.c_str());
+    fp->glsl = get_fragment_glsl(*shaderPatcher, host.gxm.shaders_db, *fp->program.get(mem), host.base_path.c_str());
 
     return STUBBED("Using a null shader");
 }
@@ -1512,8 +2067,9 @@ EXPORT(int, sceGxmShaderPatcherCreateVertexProgram, SceGxmShaderPatcher *shaderP
     }
 
     SceGxmVertexProgram *const vp = vertexProgram->get(mem);
+    vp->renderer_id = shaderPatcher->next_vertex_program_id++;
     vp->program = programId->program;
-    vp->glsl = get_vertex_glsl(*shaderPatcher, *programId->program.get(mem), host.base_path.c_str());
+    vp->glsl = get_vertex_glsl(*shaderPatcher, host.gxm.shaders_db, *programId->program.get(mem), host.base_path.c_str());
     vp->attribute_locations = attribute_locations(*programId->program.get(mem));
     vp->streams.insert(vp->streams.end(), &streams[0], &streams[streamCount]);
     vp->attributes.insert(vp->attributes.end(), &attributes[0], &attributes[attributeCount]);
@@ -1599,6 +2155,12 @@ EXPORT(int, sceGxmShaderPatcherReleaseFragmentProgram, SceGxmShaderPatcher *shad
                 break;
             }
         }
+        // The freed address can be reallocated for a different program, so
+        // drop the hot program-pair slot if it points here.
+        SceGxmContext *const context = host.gxm.context.get(host.mem);
+        if (context && (context->renderer.last_fragment_program.address() == fragmentProgram.address())) {
+            context->renderer.last_program.reset();
+        }
         free(host.mem, fragmentProgram);
     }
 
@@ -1612,6 +2174,11 @@ EXPORT(int, sceGxmShaderPatcherReleaseVertexProgram, SceGxmShaderPatcher *shader
     SceGxmVertexProgram *const vp = vertexProgram.get(host.mem);
     --vp->reference_count;
     if (vp->reference_count == 0) {
+        // See sceGxmShaderPatcherReleaseFragmentProgram.
+        SceGxmContext *const context = host.gxm.context.get(host.mem);
+        if (context && (context->renderer.last_vertex_program.address() == vertexProgram.address())) {
+            context->renderer.last_program.reset();
+        }
         free(host.mem, vertexProgram);
     }
 
@@ -2096,21 +2663,30 @@ EXPORT(int, sceGxmTransferFinish) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceGxmUnmapFragmentUsseMemory, void *base) {
-    assert(base != nullptr);
+EXPORT(int, sceGxmUnmapFragmentUsseMemory, Ptr<void> base) {
+    assert(base);
 
+    if (!unregister_mapped_region(host.gxm, base.address())) {
+        return RET_ERROR(SCE_GXM_ERROR_INVALID_VALUE);
+    }
     return 0;
 }
 
-EXPORT(int, sceGxmUnmapMemory, void *base) {
-    assert(base != nullptr);
+EXPORT(int, sceGxmUnmapMemory, Ptr<void> base) {
+    assert(base);
 
+    if (!unregister_mapped_region(host.gxm, base.address())) {
+        return RET_ERROR(SCE_GXM_ERROR_INVALID_VALUE);
+    }
     return 0;
 }
 
-EXPORT(int, sceGxmUnmapVertexUsseMemory, void *base) {
-    assert(base != nullptr);
+EXPORT(int, sceGxmUnmapVertexUsseMemory, Ptr<void> base) {
+    assert(base);
 
+    if (!unregister_mapped_region(host.gxm, base.address())) {
+        return RET_ERROR(SCE_GXM_ERROR_INVALID_VALUE);
+    }
     return 0;
 }
 
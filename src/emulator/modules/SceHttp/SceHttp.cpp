@@ -17,6 +17,271 @@
 
 #include "SceHttp.h"
 
+#include <net/state.h>
+#include <util/log.h>
+
+#include <psp2/net/http.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+// HTTP rides on the same portable socket layer as SceNet. There is no TLS
+// backend in the tree, so https connections can be created but are rejected
+// when the request is sent.
+
+#ifdef WIN32
+static const abs_socket INVALID_HOST_SOCKET = INVALID_SOCKET;
+#else
+static const abs_socket INVALID_HOST_SOCKET = -1;
+#endif
+
+// Indexed by the SceHttpMethods numbering.
+static const char *const method_names[] = { "GET", "POST", "HEAD", "OPTIONS", "PUT", "DELETE", "TRACE", "CONNECT" };
+
+static void close_host_socket(abs_socket sock) {
+#ifdef WIN32
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+}
+
+static bool parse_url(const char *url, bool &secure, std::string &hostname, uint16_t &port, std::string &path) {
+    if (url == nullptr) {
+        return false;
+    }
+    std::string rest(url);
+    const size_t scheme_end = rest.find("://");
+    if (scheme_end == std::string::npos) {
+        return false;
+    }
+    const std::string scheme = rest.substr(0, scheme_end);
+    if (scheme == "http") {
+        secure = false;
+    } else if (scheme == "https") {
+        secure = true;
+    } else {
+        return false;
+    }
+    rest = rest.substr(scheme_end + 3);
+
+    const size_t path_start = rest.find('/');
+    const std::string authority = (path_start == std::string::npos) ? rest : rest.substr(0, path_start);
+    path = (path_start == std::string::npos) ? "/" : rest.substr(path_start);
+
+    port = secure ? 443 : 80;
+    const size_t colon = authority.rfind(':');
+    if (colon != std::string::npos) {
+        hostname = authority.substr(0, colon);
+        port = static_cast<uint16_t>(atoi(authority.c_str() + colon + 1));
+    } else {
+        hostname = authority;
+    }
+    return !hostname.empty();
+}
+
+static abs_socket connect_to_server(const std::string &hostname, uint16_t port) {
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo *results = nullptr;
+    if (getaddrinfo(hostname.c_str(), std::to_string(port).c_str(), &hints, &results) != 0) {
+        return INVALID_HOST_SOCKET;
+    }
+
+    abs_socket sock = INVALID_HOST_SOCKET;
+    for (const addrinfo *result = results; result != nullptr; result = result->ai_next) {
+        sock = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+        if (sock == INVALID_HOST_SOCKET) {
+            continue;
+        }
+        if (connect(sock, result->ai_addr, static_cast<socklen_t>(result->ai_addrlen)) == 0) {
+            break;
+        }
+        close_host_socket(sock);
+        sock = INVALID_HOST_SOCKET;
+    }
+    freeaddrinfo(results);
+    return sock;
+}
+
+static abs_socket take_pooled_socket(HttpState &http, const std::string &key, bool &reused) {
+    const std::lock_guard<std::mutex> lock(http.pool_mutex);
+    const auto pooled = http.connection_pool.find(key);
+    if (pooled == http.connection_pool.end()) {
+        reused = false;
+        return INVALID_HOST_SOCKET;
+    }
+    const abs_socket sock = pooled->second;
+    http.connection_pool.erase(pooled);
+    reused = true;
+    return sock;
+}
+
+static void park_pooled_socket(HttpState &http, const std::string &key, abs_socket sock) {
+    const std::lock_guard<std::mutex> lock(http.pool_mutex);
+    http.connection_pool.emplace(key, sock);
+}
+
+static bool send_all(abs_socket sock, const char *data, size_t size) {
+    while (size > 0) {
+        const int sent = send(sock, data, static_cast<int>(size), 0);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+// Reads one response into the request. reusable comes back true when the
+// exchange was fully framed and the server did not ask for a close, so the
+// socket can go back to the keep-alive pool.
+static bool read_response(abs_socket sock, HttpRequest &request, bool &reusable) {
+    std::string head;
+    std::vector<uint8_t> pending; // body bytes received past the header
+    char buffer[4096];
+
+    size_t header_end = std::string::npos;
+    while (header_end == std::string::npos) {
+        const int received = recv(sock, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            return false;
+        }
+        head.append(buffer, received);
+        header_end = head.find("\r\n\r\n");
+        if ((header_end == std::string::npos) && (head.size() > 0x10000)) {
+            return false; // runaway header
+        }
+    }
+    pending.assign(head.begin() + header_end + 4, head.end());
+    head.resize(header_end + 4);
+
+    if (head.compare(0, 5, "HTTP/") != 0) {
+        return false;
+    }
+    const size_t space = head.find(' ');
+    if (space == std::string::npos) {
+        return false;
+    }
+    request.status_code = atoi(head.c_str() + space + 1);
+    request.response_headers = head;
+    request.body.clear();
+    request.read_offset = 0;
+
+    std::string lower = head;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) { return static_cast<char>(tolower(c)); });
+    const auto header_value = [&head, &lower](const char *name) -> std::string {
+        const std::string needle = std::string("\r\n") + name + ":";
+        const size_t at = lower.find(needle);
+        if (at == std::string::npos) {
+            return std::string();
+        }
+        size_t begin = at + needle.size();
+        while ((begin < head.size()) && (head[begin] == ' ')) {
+            ++begin;
+        }
+        const size_t end = head.find("\r\n", begin);
+        return lower.substr(begin, end - begin);
+    };
+
+    const bool chunked = header_value("transfer-encoding").find("chunked") != std::string::npos;
+    const std::string content_length = header_value("content-length");
+    const std::string connection = header_value("connection");
+    const bool head_only = (request.method == 2 /* HEAD */) || (request.status_code == 204) || (request.status_code == 304);
+
+    reusable = (head.compare(0, 9, "HTTP/1.1 ") == 0)
+        ? (connection.find("close") == std::string::npos)
+        : (connection.find("keep-alive") != std::string::npos);
+
+    const auto recv_more = [&sock, &pending, &buffer]() -> bool {
+        const int received = recv(sock, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            return false;
+        }
+        pending.insert(pending.end(), buffer, buffer + received);
+        return true;
+    };
+
+    if (head_only) {
+        return true;
+    }
+
+    if (chunked) {
+        static const uint8_t crlf[] = { '\r', '\n' };
+        size_t cursor = 0;
+        for (;;) {
+            size_t line_end;
+            for (;;) {
+                const auto found = std::search(pending.begin() + cursor, pending.end(), crlf, crlf + 2);
+                if (found != pending.end()) {
+                    line_end = found - pending.begin();
+                    break;
+                }
+                if (!recv_more()) {
+                    return false;
+                }
+            }
+            const std::string size_line(pending.begin() + cursor, pending.begin() + line_end);
+            const size_t chunk_size = strtoul(size_line.c_str(), nullptr, 16);
+            const size_t data_start = line_end + 2;
+            if (chunk_size == 0) {
+                // Swallow the common bare "0\r\n\r\n" ending; a trailer
+                // section is rare enough to just retire the socket instead
+                // of parsing it.
+                while (pending.size() < data_start + 2) {
+                    if (!recv_more()) {
+                        reusable = false;
+                        return true;
+                    }
+                }
+                if ((pending[data_start] != '\r') || (pending[data_start + 1] != '\n')) {
+                    reusable = false;
+                }
+                return true;
+            }
+            while (pending.size() < data_start + chunk_size + 2) {
+                if (!recv_more()) {
+                    return false;
+                }
+            }
+            request.body.insert(request.body.end(), pending.begin() + data_start, pending.begin() + data_start + chunk_size);
+            cursor = data_start + chunk_size + 2;
+        }
+    }
+
+    if (!content_length.empty()) {
+        const size_t total = strtoul(content_length.c_str(), nullptr, 10);
+        while (pending.size() < total) {
+            if (!recv_more()) {
+                return false;
+            }
+        }
+        request.body.assign(pending.begin(), pending.begin() + total);
+        return true;
+    }
+
+    // No framing at all - read until the server closes; the socket is spent.
+    reusable = false;
+    for (;;) {
+        const int received = recv(sock, buffer, sizeof(buffer), 0);
+        if (received < 0) {
+            return false;
+        }
+        if (received == 0) {
+            break;
+        }
+        pending.insert(pending.end(), buffer, buffer + received);
+    }
+    request.body = std::move(pending);
+    return true;
+}
+
 EXPORT(int, sceHttpAbortRequest) {
     return UNIMPLEMENTED();
 }
@@ -33,8 +298,16 @@ EXPORT(int, sceHttpAddCookie) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceHttpAddRequestHeader) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpAddRequestHeader, int req_id, const char *name, const char *value, unsigned int mode) {
+    const auto request = host.http.requests.find(req_id);
+    if (request == host.http.requests.end()) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_ID);
+    }
+    if ((name == nullptr) || (value == nullptr)) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_VALUE);
+    }
+    request->second.headers[name] = value;
+    return 0;
 }
 
 EXPORT(int, sceHttpAddRequestHeaderRaw) {
@@ -57,48 +330,128 @@ EXPORT(int, sceHttpCookieImport) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceHttpCreateConnection) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpCreateConnection, int tmpl_id, const char *hostname, const char *scheme, unsigned short port, int enable_keepalive) {
+    if (!host.http.inited) {
+        return RET_ERROR(SCE_HTTP_ERROR_BEFORE_INIT);
+    }
+    if ((hostname == nullptr) || (scheme == nullptr)) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_VALUE);
+    }
+    const bool secure = (strcmp(scheme, "https") == 0);
+    if (!secure && (strcmp(scheme, "http") != 0)) {
+        return RET_ERROR(SCE_HTTP_ERROR_UNKNOWN_SCHEME);
+    }
+
+    HttpConnection connection;
+    connection.template_id = tmpl_id;
+    connection.hostname = hostname;
+    connection.port = (port != 0) ? port : (secure ? 443 : 80);
+    connection.secure = secure;
+    connection.keep_alive = enable_keepalive != 0;
+
+    const int id = host.http.next_id++;
+    host.http.connections.emplace(id, connection);
+    return id;
 }
 
-EXPORT(int, sceHttpCreateConnectionWithURL) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpCreateConnectionWithURL, int tmpl_id, const char *url, int enable_keepalive) {
+    if (!host.http.inited) {
+        return RET_ERROR(SCE_HTTP_ERROR_BEFORE_INIT);
+    }
+
+    HttpConnection connection;
+    std::string path; // the request supplies its own
+    if (!parse_url(url, connection.secure, connection.hostname, connection.port, path)) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_URL);
+    }
+    connection.template_id = tmpl_id;
+    connection.keep_alive = enable_keepalive != 0;
+
+    const int id = host.http.next_id++;
+    host.http.connections.emplace(id, connection);
+    return id;
 }
 
 EXPORT(int, sceHttpCreateEpoll) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceHttpCreateRequest) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpCreateRequest, int conn_id, int method, const char *path, SceULong64 content_length) {
+    if (host.http.connections.find(conn_id) == host.http.connections.end()) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_ID);
+    }
+
+    HttpRequest request;
+    request.connection_id = conn_id;
+    request.method = method;
+    request.path = ((path != nullptr) && (path[0] != '\0')) ? path : "/";
+
+    const int id = host.http.next_id++;
+    host.http.requests.emplace(id, request);
+    return id;
 }
 
 EXPORT(int, sceHttpCreateRequest2) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceHttpCreateRequestWithURL) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpCreateRequestWithURL, int conn_id, int method, const char *url, SceULong64 content_length) {
+    if (host.http.connections.find(conn_id) == host.http.connections.end()) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_ID);
+    }
+
+    HttpRequest request;
+    bool secure;
+    std::string hostname;
+    uint16_t port;
+    if (!parse_url(url, secure, hostname, port, request.path)) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_URL);
+    }
+    request.connection_id = conn_id;
+    request.method = method;
+
+    const int id = host.http.next_id++;
+    host.http.requests.emplace(id, request);
+    return id;
 }
 
 EXPORT(int, sceHttpCreateRequestWithURL2) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceHttpCreateTemplate) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpCreateTemplate, const char *user_agent, int http_ver, int auto_proxy_conf) {
+    if (!host.http.inited) {
+        return RET_ERROR(SCE_HTTP_ERROR_BEFORE_INIT);
+    }
+
+    HttpTemplate tmpl;
+    tmpl.user_agent = (user_agent != nullptr) ? user_agent : "";
+    tmpl.http_version = http_ver;
+
+    const int id = host.http.next_id++;
+    host.http.templates.emplace(id, tmpl);
+    return id;
 }
 
-EXPORT(int, sceHttpDeleteConnection) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpDeleteConnection, int conn_id) {
+    if (host.http.connections.erase(conn_id) == 0) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_ID);
+    }
+    return 0;
 }
 
-EXPORT(int, sceHttpDeleteRequest) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpDeleteRequest, int req_id) {
+    if (host.http.requests.erase(req_id) == 0) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_ID);
+    }
+    return 0;
 }
 
-EXPORT(int, sceHttpDeleteTemplate) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpDeleteTemplate, int tmpl_id) {
+    if (host.http.templates.erase(tmpl_id) == 0) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_ID);
+    }
+    return 0;
 }
 
 EXPORT(int, sceHttpDestroyEpoll) {
@@ -157,16 +510,36 @@ EXPORT(int, sceHttpGetNonblock) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceHttpGetResponseContentLength) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpGetResponseContentLength, int req_id, SceULong64 *content_length) {
+    const auto request = host.http.requests.find(req_id);
+    if (request == host.http.requests.end()) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_ID);
+    }
+    if (content_length == nullptr) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_VALUE);
+    }
+    *content_length = request->second.body.size();
+    return 0;
 }
 
-EXPORT(int, sceHttpGetStatusCode) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpGetStatusCode, int req_id, int *status_code) {
+    const auto request = host.http.requests.find(req_id);
+    if (request == host.http.requests.end()) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_ID);
+    }
+    if (status_code == nullptr) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_VALUE);
+    }
+    *status_code = request->second.status_code;
+    return 0;
 }
 
-EXPORT(int, sceHttpInit) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpInit, SceSize pool_size) {
+    if (host.http.inited) {
+        return RET_ERROR(SCE_HTTP_ERROR_ALREADY_INITED);
+    }
+    host.http.inited = true;
+    return 0;
 }
 
 EXPORT(int, sceHttpParseResponseHeader) {
@@ -177,24 +550,118 @@ EXPORT(int, sceHttpParseStatusLine) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceHttpReadData) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpReadData, int req_id, void *data, SceSize size) {
+    const auto request = host.http.requests.find(req_id);
+    if (request == host.http.requests.end()) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_ID);
+    }
+    if (data == nullptr) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_VALUE);
+    }
+    const size_t remaining = request->second.body.size() - request->second.read_offset;
+    const size_t copied = std::min<size_t>(size, remaining);
+    memcpy(data, request->second.body.data() + request->second.read_offset, copied);
+    request->second.read_offset += copied;
+    return static_cast<int>(copied);
 }
 
 EXPORT(int, sceHttpRedirectCacheFlush) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceHttpRemoveRequestHeader) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpRemoveRequestHeader, int req_id, const char *name) {
+    const auto request = host.http.requests.find(req_id);
+    if (request == host.http.requests.end()) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_ID);
+    }
+    if (name != nullptr) {
+        request->second.headers.erase(name);
+    }
+    return 0;
 }
 
 EXPORT(int, sceHttpRequestGetAllHeaders) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceHttpSendRequest) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceHttpSendRequest, int req_id, const void *post_data, SceSize size) {
+    HttpState &http = host.http;
+    const auto request = http.requests.find(req_id);
+    if (request == http.requests.end()) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_ID);
+    }
+    const auto connection = http.connections.find(request->second.connection_id);
+    if (connection == http.connections.end()) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_ID);
+    }
+    if (connection->second.secure) {
+        LOG_WARN("{}: no TLS backend, refusing https request to {}", export_name, connection->second.hostname);
+        return RET_ERROR(SCE_HTTP_ERROR_SSL);
+    }
+    if ((request->second.method < 0) || (static_cast<size_t>(request->second.method) >= sizeof(method_names) / sizeof(method_names[0]))) {
+        return RET_ERROR(SCE_HTTP_ERROR_INVALID_VALUE);
+    }
+
+    const auto tmpl = http.templates.find(connection->second.template_id);
+
+    std::ostringstream message;
+    message << method_names[request->second.method] << ' ' << request->second.path << " HTTP/1.1\r\n";
+    message << "Host: " << connection->second.hostname;
+    if (connection->second.port != 80) {
+        message << ':' << connection->second.port;
+    }
+    message << "\r\n";
+    if ((tmpl != http.templates.end()) && !tmpl->second.user_agent.empty() && (request->second.headers.find("User-Agent") == request->second.headers.end())) {
+        message << "User-Agent: " << tmpl->second.user_agent << "\r\n";
+    }
+    message << "Connection: " << (connection->second.keep_alive ? "keep-alive" : "close") << "\r\n";
+    for (const auto &header : request->second.headers) {
+        message << header.first << ": " << header.second << "\r\n";
+    }
+    if ((post_data != nullptr) && (size > 0)) {
+        message << "Content-Length: " << size << "\r\n";
+    }
+    message << "\r\n";
+    const std::string text = message.str();
+
+    const std::string pool_key = connection->second.hostname + ':' + std::to_string(connection->second.port);
+
+    // Two passes at most: a warm socket may have been closed by the server
+    // since it was parked, in which case the retry reconnects cold.
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        bool reused = false;
+        abs_socket sock = take_pooled_socket(http, pool_key, reused);
+        if (!reused) {
+            sock = connect_to_server(connection->second.hostname, connection->second.port);
+            if (sock == INVALID_HOST_SOCKET) {
+                return RET_ERROR(SCE_HTTP_ERROR_NETWORK);
+            }
+        }
+
+        bool ok = send_all(sock, text.data(), text.size());
+        if (ok && (post_data != nullptr) && (size > 0)) {
+            ok = send_all(sock, static_cast<const char *>(post_data), size);
+        }
+        bool reusable = false;
+        if (ok) {
+            ok = read_response(sock, request->second, reusable);
+        }
+        if (!ok) {
+            close_host_socket(sock);
+            if (reused) {
+                continue; // stale keep-alive socket
+            }
+            return RET_ERROR(SCE_HTTP_ERROR_NETWORK);
+        }
+
+        if (reusable && connection->second.keep_alive) {
+            park_pooled_socket(http, pool_key, sock);
+        } else {
+            close_host_socket(sock);
+        }
+        return 0;
+    }
+    return RET_ERROR(SCE_HTTP_ERROR_NETWORK);
 }
 
 EXPORT(int, sceHttpSetAcceptEncodingGZIPEnabled) {
@@ -302,7 +769,21 @@ EXPORT(int, sceHttpSslIsCtxCreated) {
 }
 
 EXPORT(int, sceHttpTerm) {
-    return UNIMPLEMENTED();
+    if (!host.http.inited) {
+        return RET_ERROR(SCE_HTTP_ERROR_BEFORE_INIT);
+    }
+    {
+        const std::lock_guard<std::mutex> lock(host.http.pool_mutex);
+        for (const auto &pooled : host.http.connection_pool) {
+            close_host_socket(pooled.second);
+        }
+        host.http.connection_pool.clear();
+    }
+    host.http.templates.clear();
+    host.http.connections.clear();
+    host.http.requests.clear();
+    host.http.inited = false;
+    return 0;
 }
 
 EXPORT(int, sceHttpUnsetEpoll) {
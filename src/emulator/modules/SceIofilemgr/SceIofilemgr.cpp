@@ -88,8 +88,8 @@ EXPORT(int, sceIoSetThreadDefaultPriorityForSystem) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceIoSyncByFd) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceIoSyncByFd, SceUID fd) {
+    return sync_file(host.io, fd, export_name);
 }
 
 EXPORT(int, sceIoSyncByFdAsync) {
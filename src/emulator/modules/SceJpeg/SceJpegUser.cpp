@@ -17,6 +17,15 @@
 
 #include "SceJpegUser.h"
 
+// When this module gets implemented, back it with libjpeg-turbo rather
+// than a scalar decoder - loading screens decode multi-megapixel images
+// and the SIMD color conversion is most of the win. Decode straight into
+// the guest output buffer (it lives in host memory via MemState, so there
+// is no extra copy to elide on our side), and note that sceJpegGetOutputInfo
+// must report buffer sizes before any decode happens. Blocked today on the
+// dependency and on the psp2/jpeg.h structure layouts, neither of which is
+// in this tree.
+
 EXPORT(int, sceJpegCreateSplitDecoder) {
     return UNIMPLEMENTED();
 }
@@ -20,12 +20,15 @@
 #include <host/functions.h>
 #include <kernel/functions.h>
 #include <kernel/thread/sync_primitives.h>
+#include <util/lock_and_find.h>
 
 #include <SDL_timer.h>
 #include <psp2/kernel/error.h>
 
-EXPORT(int, sceKernelCancelCallback) {
-    return UNIMPLEMENTED();
+#include <thread>
+
+EXPORT(int, sceKernelCancelCallback, SceUID cbid) {
+    return callback_cancel(host.kernel, export_name, cbid);
 }
 
 EXPORT(int, sceKernelChangeActiveCpuMask) {
@@ -49,7 +52,9 @@ EXPORT(int, sceKernelChangeThreadVfpException) {
 }
 
 EXPORT(int, sceKernelCheckCallback) {
-    return UNIMPLEMENTED();
+    // The caller is at a check point on its own thread - drain the whole
+    // pending batch here.
+    return deliver_pending_callbacks(host.kernel, export_name, thread_id);
 }
 
 EXPORT(int, sceKernelCheckWaitableStatus) {
@@ -96,20 +101,44 @@ EXPORT(int, sceKernelCloseTimer) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceKernelCreateCallback) {
-    return UNIMPLEMENTED();
+EXPORT(SceUID, sceKernelCreateCallback, const char *name, SceUInt attr, Ptr<const void> func, Ptr<void> common) {
+    return callback_create(host.kernel, export_name, thread_id, name, attr, func, common);
 }
 
 EXPORT(int, sceKernelCreateThreadForUser) {
     return UNIMPLEMENTED();
 }
 
+// Number of consecutive zero-length delays after which a thread is assumed
+// to be spinning on a flag and is parked until the next vblank instead.
+static constexpr uint32_t ZERO_DELAY_SPIN_LIMIT = 100;
+
 EXPORT(int, sceKernelDelayThread, SceUInt delay) {
-#ifdef _WIN32
-    Sleep(delay / 1000);
-#else
-    usleep(delay);
-#endif
+    if (delay == 0) {
+        // Titles poll flags with sceKernelDelayThread(0) in a tight loop,
+        // which burns a whole host core per spinning guest thread. Count the
+        // consecutive zero delays and downgrade persistent spinners to a
+        // condvar wait on the display, waking them once per frame.
+        const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
+        if (thread && (++thread->zero_delay_count >= ZERO_DELAY_SPIN_LIMIT)) {
+            thread->zero_delay_count = 0;
+            std::unique_lock<std::mutex> lock(host.display.mutex);
+            if (!host.display.abort.load()) {
+                host.display.condvar.wait(lock);
+            }
+            return SCE_KERNEL_OK;
+        }
+        std::this_thread::yield();
+        return SCE_KERNEL_OK;
+    }
+
+    {
+        const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
+        if (thread) {
+            thread->zero_delay_count = 0;
+        }
+    }
+    timer_sleep(host.kernel.timer, delay);
     return SCE_KERNEL_OK;
 }
 
@@ -117,16 +146,22 @@ EXPORT(int, sceKernelDelayThread200) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceKernelDelayThreadCB) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceKernelDelayThreadCB, SceUInt delay) {
+    // A *CB wait is a scheduling point the title opted into - drain this
+    // thread's pending callbacks before sleeping.
+    deliver_pending_callbacks(host.kernel, export_name, thread_id);
+    if (delay > 0) {
+        timer_sleep(host.kernel.timer, delay);
+    }
+    return SCE_KERNEL_OK;
 }
 
 EXPORT(int, sceKernelDelayThreadCB200) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceKernelDeleteCallback) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceKernelDeleteCallback, SceUID cbid) {
+    return callback_delete(host.kernel, export_name, cbid);
 }
 
 EXPORT(int, sceKernelDeleteCond) {
@@ -169,8 +204,8 @@ EXPORT(int, sceKernelExitDeleteThread) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceKernelGetCallbackCount) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceKernelGetCallbackCount, SceUID cbid) {
+    return callback_count(host.kernel, export_name, cbid);
 }
 
 EXPORT(int, sceKernelGetMsgPipeCreatorId) {
@@ -206,8 +241,8 @@ EXPORT(int, sceKernelGetTimerTimeWide) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceKernelNotifyCallback) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceKernelNotifyCallback, SceUID cbid, SceInt32 notify_arg) {
+    return callback_notify(host.kernel, export_name, cbid, notify_arg);
 }
 
 EXPORT(int, sceKernelOpenCond) {
@@ -17,60 +17,893 @@
 
 #include "SceLibJson.h"
 
+#include <kernel/thread/thread_functions.h>
+#include <mem/mem.h>
+#include <mem/ptr.h>
+#include <util/lock_and_find.h>
+#include <util/log.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// sce::Json on a host-native parser. A parse runs a recursive descent over
+// the document on the host, then lays the whole value tree out in a single
+// guest allocation (the arena) that the root Value owns and frees on
+// destruction. Accessors are pointer arithmetic over that arena, so
+// JSON-heavy flows cost one emulated call per lookup instead of an emulated
+// parser pass per byte.
+
+namespace emu {
+namespace json {
+    enum ValueType : uint32_t {
+        VALUE_NULL = 0,
+        VALUE_BOOLEAN = 1,
+        VALUE_INTEGER = 2,
+        VALUE_UINTEGER = 3,
+        VALUE_REAL = 4,
+        VALUE_STRING = 5,
+        VALUE_ARRAY = 6,
+        VALUE_OBJECT = 7,
+    };
+
+    constexpr uint32_t TYPE_MASK = 0x7fffffff;
+
+    // Set on the Value a parse or deep copy filled in: that Value owns the
+    // arena holding its whole subtree and frees it when destroyed.
+    constexpr uint32_t OWNS_ARENA = 0x80000000;
+
+    constexpr uint32_t NPOS = 0xffffffff;
+
+    // Guest-visible layouts. Every method of these classes is bridged here
+    // and titles never poke the object bytes directly, so the internals only
+    // have to stay consistent within this file. The hard constraint is size:
+    // titles allocate Value, String and iterator storage with sizeof from
+    // the SDK headers, so these must not outgrow those footprints.
+    struct String {
+        Address data; // NUL-terminated characters
+        uint32_t length;
+    };
+
+    struct Value {
+        uint32_t type; // ValueType, possibly with OWNS_ARENA
+        // Arena base when this Value owns one, parent Value for values that
+        // live inside an arena, 0 for standalone scalars.
+        Address link;
+        union {
+            uint32_t boolean;
+            int64_t integer;
+            uint64_t uinteger;
+            double real;
+            struct {
+                Address data; // String/Array/Object header
+                uint32_t count;
+            } ref;
+        };
+    };
+
+    static_assert(sizeof(Value) == 16, "Value must keep the guest footprint");
+
+    // Array payload: this header, then count Values.
+    struct Array {
+        uint32_t count;
+        uint32_t padding;
+    };
+
+    // Object payload: this header, then count Pairs.
+    struct Object {
+        uint32_t count;
+        uint32_t padding;
+    };
+
+    struct Pair {
+        String name;
+        Value value;
+    };
+
+    static_assert(sizeof(Pair) == 24, "Pair size drives member iteration");
+
+    struct Iterator {
+        Address current;
+    };
+}
+}
+
+typedef emu::json::String JsonString;
+typedef emu::json::Value JsonValue;
+typedef emu::json::Array JsonArray;
+typedef emu::json::Object JsonObject;
+typedef emu::json::Pair JsonPair;
+typedef emu::json::Iterator JsonIterator;
+
+using namespace emu::json;
+
+// Host-side document built by the parser and consumed by the arena writer.
+struct HostJsonValue {
+    uint32_t type = VALUE_NULL;
+    bool boolean = false;
+    int64_t integer = 0;
+    uint64_t uinteger = 0;
+    double real = 0.0;
+    std::string string;
+    std::vector<HostJsonValue> elements;
+    std::vector<std::pair<std::string, HostJsonValue>> members;
+};
+
+static size_t align8(size_t bytes) {
+    return (bytes + 7) & ~size_t(7);
+}
+
+// Character blocks owned by standalone String objects. The 8-byte String has
+// no room for an ownership flag, and arena-backed strings must not be freed
+// individually, so ownership is tracked host-side.
+static std::mutex owned_chars_mutex;
+static std::set<Address> owned_chars;
+
+static Address alloc_chars(HostState &host, const char *text, uint32_t length) {
+    const Address block = alloc(host.mem, length + 1, "SceLibJson string");
+    if (!block) {
+        return 0;
+    }
+    char *dst = Ptr<char>(block).get(host.mem);
+    if (length > 0) {
+        memcpy(dst, text, length);
+    }
+    dst[length] = '\0';
+
+    const std::lock_guard<std::mutex> lock(owned_chars_mutex);
+    owned_chars.insert(block);
+    return block;
+}
+
+static void free_chars(HostState &host, Address data) {
+    if (!data) {
+        return;
+    }
+    const std::lock_guard<std::mutex> lock(owned_chars_mutex);
+    const auto block = owned_chars.find(data);
+    if (block == owned_chars.end()) {
+        return; // arena-backed - freed with the arena
+    }
+    owned_chars.erase(block);
+    free(host.mem, data);
+}
+
+static void assign_string(HostState &host, JsonString *dst, const char *text, uint32_t length) {
+    const Address block = alloc_chars(host, text, length);
+    if (!block) {
+        return;
+    }
+    free_chars(host, dst->data);
+    dst->data = block;
+    dst->length = length;
+}
+
+static std::string string_chars(const MemState &mem, const JsonString *string) {
+    if (!string || !string->data || (string->length == 0)) {
+        return std::string();
+    }
+    return std::string(Ptr<const char>(string->data).get(mem), string->length);
+}
+
+// Shared immutable miss targets - lookups that fail return references to
+// these, mirroring the reference semantics of the real library.
+struct NullBlock {
+    Address value = 0;
+    Address string = 0;
+    Address chars = 0;
+    Address array = 0;
+    Address object = 0;
+};
+
+static const NullBlock &null_block(HostState &host) {
+    static NullBlock cached;
+    static std::mutex mutex;
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (!cached.value) {
+        const Address base = alloc(host.mem, 48, "SceLibJson nulls");
+        if (base) {
+            memset(Ptr<uint8_t>(base).get(host.mem), 0, 48);
+            cached.value = base;
+            cached.string = base + 16;
+            cached.chars = base + 24;
+            cached.array = base + 32;
+            cached.object = base + 40;
+            Ptr<JsonString>(cached.string).get(host.mem)->data = cached.chars;
+        }
+    }
+    return cached;
+}
+
+static void release_value(HostState &host, JsonValue *value) {
+    if ((value->type & OWNS_ARENA) && value->link) {
+        free(host.mem, value->link);
+    }
+    memset(value, 0, sizeof(JsonValue));
+}
+
+// ---------------------------------------------------------------------------
+// Parser: JSON text to a HostJsonValue tree.
+
+struct Cursor {
+    const char *p;
+    const char *end;
+};
+
+static void skip_whitespace(Cursor &c) {
+    while ((c.p < c.end) && ((*c.p == ' ') || (*c.p == '\t') || (*c.p == '\n') || (*c.p == '\r'))) {
+        ++c.p;
+    }
+}
+
+static bool parse_hex4(Cursor &c, uint32_t &out) {
+    if ((c.end - c.p) < 4) {
+        return false;
+    }
+    out = 0;
+    for (int i = 0; i < 4; ++i) {
+        const char digit = *c.p++;
+        out <<= 4;
+        if ((digit >= '0') && (digit <= '9')) {
+            out |= digit - '0';
+        } else if ((digit >= 'a') && (digit <= 'f')) {
+            out |= (digit - 'a') + 10;
+        } else if ((digit >= 'A') && (digit <= 'F')) {
+            out |= (digit - 'A') + 10;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void append_utf8(std::string &out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += char(cp);
+    } else if (cp < 0x800) {
+        out += char(0xc0 | (cp >> 6));
+        out += char(0x80 | (cp & 0x3f));
+    } else if (cp < 0x10000) {
+        out += char(0xe0 | (cp >> 12));
+        out += char(0x80 | ((cp >> 6) & 0x3f));
+        out += char(0x80 | (cp & 0x3f));
+    } else {
+        out += char(0xf0 | (cp >> 18));
+        out += char(0x80 | ((cp >> 12) & 0x3f));
+        out += char(0x80 | ((cp >> 6) & 0x3f));
+        out += char(0x80 | (cp & 0x3f));
+    }
+}
+
+static bool parse_string_token(Cursor &c, std::string &out) {
+    if ((c.p == c.end) || (*c.p != '"')) {
+        return false;
+    }
+    ++c.p;
+    while (c.p < c.end) {
+        const char ch = *c.p++;
+        if (ch == '"') {
+            return true;
+        }
+        if (ch != '\\') {
+            out += ch;
+            continue;
+        }
+        if (c.p == c.end) {
+            return false;
+        }
+        const char escape = *c.p++;
+        switch (escape) {
+        case '"': out += '"'; break;
+        case '\\': out += '\\'; break;
+        case '/': out += '/'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+            uint32_t cp = 0;
+            if (!parse_hex4(c, cp)) {
+                return false;
+            }
+            if ((cp >= 0xd800) && (cp < 0xdc00) && ((c.end - c.p) >= 6) && (c.p[0] == '\\') && (c.p[1] == 'u')) {
+                Cursor saved = c;
+                c.p += 2;
+                uint32_t low = 0;
+                if (parse_hex4(c, low) && (low >= 0xdc00) && (low < 0xe000)) {
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                } else {
+                    c = saved;
+                }
+            }
+            append_utf8(out, cp);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return false;
+}
+
+static bool parse_number(Cursor &c, HostJsonValue &out) {
+    const char *start = c.p;
+    bool real = false;
+    while (c.p < c.end) {
+        const char ch = *c.p;
+        if ((ch >= '0') && (ch <= '9')) {
+            ++c.p;
+        } else if ((ch == '-') || (ch == '+')) {
+            ++c.p;
+        } else if ((ch == '.') || (ch == 'e') || (ch == 'E')) {
+            real = true;
+            ++c.p;
+        } else {
+            break;
+        }
+    }
+    if (c.p == start) {
+        return false;
+    }
+    const std::string token(start, c.p);
+
+    if (!real) {
+        char *token_end = nullptr;
+        errno = 0;
+        if (token[0] == '-') {
+            const int64_t value = strtoll(token.c_str(), &token_end, 10);
+            if ((*token_end == '\0') && (errno != ERANGE)) {
+                out.type = VALUE_INTEGER;
+                out.integer = value;
+                return true;
+            }
+        } else {
+            const uint64_t value = strtoull(token.c_str(), &token_end, 10);
+            if ((*token_end == '\0') && (errno != ERANGE)) {
+                if (value <= uint64_t(INT64_MAX)) {
+                    out.type = VALUE_INTEGER;
+                    out.integer = int64_t(value);
+                } else {
+                    out.type = VALUE_UINTEGER;
+                    out.uinteger = value;
+                }
+                return true;
+            }
+        }
+        real = true; // out of 64-bit range - keep it as a real
+    }
+
+    char *token_end = nullptr;
+    const double value = strtod(token.c_str(), &token_end);
+    if (*token_end != '\0') {
+        return false;
+    }
+    out.type = VALUE_REAL;
+    out.real = value;
+    return true;
+}
+
+static bool parse_json_value(Cursor &c, HostJsonValue &out, int depth) {
+    if (depth > 128) {
+        return false;
+    }
+    skip_whitespace(c);
+    if (c.p == c.end) {
+        return false;
+    }
+    switch (*c.p) {
+    case '{': {
+        ++c.p;
+        out.type = VALUE_OBJECT;
+        skip_whitespace(c);
+        if ((c.p < c.end) && (*c.p == '}')) {
+            ++c.p;
+            return true;
+        }
+        while (true) {
+            skip_whitespace(c);
+            std::string key;
+            if (!parse_string_token(c, key)) {
+                return false;
+            }
+            skip_whitespace(c);
+            if ((c.p == c.end) || (*c.p++ != ':')) {
+                return false;
+            }
+            HostJsonValue member;
+            if (!parse_json_value(c, member, depth + 1)) {
+                return false;
+            }
+            out.members.emplace_back(std::move(key), std::move(member));
+            skip_whitespace(c);
+            if (c.p == c.end) {
+                return false;
+            }
+            const char ch = *c.p++;
+            if (ch == '}') {
+                return true;
+            }
+            if (ch != ',') {
+                return false;
+            }
+        }
+    }
+    case '[': {
+        ++c.p;
+        out.type = VALUE_ARRAY;
+        skip_whitespace(c);
+        if ((c.p < c.end) && (*c.p == ']')) {
+            ++c.p;
+            return true;
+        }
+        while (true) {
+            HostJsonValue element;
+            if (!parse_json_value(c, element, depth + 1)) {
+                return false;
+            }
+            out.elements.push_back(std::move(element));
+            skip_whitespace(c);
+            if (c.p == c.end) {
+                return false;
+            }
+            const char ch = *c.p++;
+            if (ch == ']') {
+                return true;
+            }
+            if (ch != ',') {
+                return false;
+            }
+        }
+    }
+    case '"':
+        out.type = VALUE_STRING;
+        return parse_string_token(c, out.string);
+    case 't':
+        if (((c.end - c.p) >= 4) && (strncmp(c.p, "true", 4) == 0)) {
+            c.p += 4;
+            out.type = VALUE_BOOLEAN;
+            out.boolean = true;
+            return true;
+        }
+        return false;
+    case 'f':
+        if (((c.end - c.p) >= 5) && (strncmp(c.p, "false", 5) == 0)) {
+            c.p += 5;
+            out.type = VALUE_BOOLEAN;
+            out.boolean = false;
+            return true;
+        }
+        return false;
+    case 'n':
+        if (((c.end - c.p) >= 4) && (strncmp(c.p, "null", 4) == 0)) {
+            c.p += 4;
+            out.type = VALUE_NULL;
+            return true;
+        }
+        return false;
+    default:
+        return parse_number(c, out);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Arena writer: a HostJsonValue tree to one guest allocation.
+
+static size_t payload_bytes(const HostJsonValue &value) {
+    switch (value.type) {
+    case VALUE_STRING:
+        return align8(sizeof(JsonString) + value.string.size() + 1);
+    case VALUE_ARRAY: {
+        size_t bytes = align8(sizeof(JsonArray) + (value.elements.size() * sizeof(JsonValue)));
+        for (const HostJsonValue &element : value.elements) {
+            bytes += payload_bytes(element);
+        }
+        return bytes;
+    }
+    case VALUE_OBJECT: {
+        size_t bytes = align8(sizeof(JsonObject) + (value.members.size() * sizeof(JsonPair)));
+        for (const auto &member : value.members) {
+            bytes += align8(member.first.size() + 1);
+            bytes += payload_bytes(member.second);
+        }
+        return bytes;
+    }
+    default:
+        return 0;
+    }
+}
+
+struct Arena {
+    MemState &mem;
+    Address base;
+    size_t cursor = 0;
+
+    Address bump(size_t bytes) {
+        const Address at = base + static_cast<Address>(cursor);
+        cursor += align8(bytes);
+        return at;
+    }
+};
+
+static Address write_chars(Arena &arena, const std::string &text) {
+    const Address at = arena.bump(text.size() + 1);
+    memcpy(Ptr<char>(at).get(arena.mem), text.c_str(), text.size() + 1);
+    return at;
+}
+
+static Address write_string_block(Arena &arena, const std::string &text) {
+    const Address at = arena.bump(sizeof(JsonString) + text.size() + 1);
+    JsonString *header = Ptr<JsonString>(at).get(arena.mem);
+    header->data = at + sizeof(JsonString);
+    header->length = uint32_t(text.size());
+    memcpy(Ptr<char>(header->data).get(arena.mem), text.c_str(), text.size() + 1);
+    return at;
+}
+
+static void write_value(Arena &arena, const HostJsonValue &src, Address dst_addr, Address parent) {
+    JsonValue *dst = Ptr<JsonValue>(dst_addr).get(arena.mem);
+    memset(dst, 0, sizeof(JsonValue));
+    dst->type = src.type;
+    dst->link = parent;
+
+    switch (src.type) {
+    case VALUE_BOOLEAN:
+        dst->boolean = src.boolean ? 1 : 0;
+        break;
+    case VALUE_INTEGER:
+        dst->integer = src.integer;
+        break;
+    case VALUE_UINTEGER:
+        dst->uinteger = src.uinteger;
+        break;
+    case VALUE_REAL:
+        dst->real = src.real;
+        break;
+    case VALUE_STRING:
+        dst->ref.data = write_string_block(arena, src.string);
+        dst->ref.count = uint32_t(src.string.size());
+        break;
+    case VALUE_ARRAY: {
+        const uint32_t count = uint32_t(src.elements.size());
+        const Address header = arena.bump(sizeof(JsonArray) + (count * sizeof(JsonValue)));
+        Ptr<JsonArray>(header).get(arena.mem)->count = count;
+        dst->ref.data = header;
+        dst->ref.count = count;
+        for (uint32_t i = 0; i < count; ++i) {
+            write_value(arena, src.elements[i], header + sizeof(JsonArray) + (i * sizeof(JsonValue)), dst_addr);
+        }
+        break;
+    }
+    case VALUE_OBJECT: {
+        const uint32_t count = uint32_t(src.members.size());
+        const Address header = arena.bump(sizeof(JsonObject) + (count * sizeof(JsonPair)));
+        Ptr<JsonObject>(header).get(arena.mem)->count = count;
+        dst->ref.data = header;
+        dst->ref.count = count;
+        for (uint32_t i = 0; i < count; ++i) {
+            const Address pair = header + sizeof(JsonObject) + (i * sizeof(JsonPair));
+            JsonString *name = Ptr<JsonString>(pair).get(arena.mem);
+            name->data = write_chars(arena, src.members[i].first);
+            name->length = uint32_t(src.members[i].first.size());
+            write_value(arena, src.members[i].second, pair + offsetof(JsonPair, value), dst_addr);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// Lay dom out in a fresh arena owned by dst. dst is written whole, so any
+// previous content must already have been released.
+static int materialize(HostState &host, Ptr<JsonValue> dst, const HostJsonValue &dom) {
+    const size_t bytes = payload_bytes(dom);
+    Address arena_base = 0;
+    if (bytes > 0) {
+        arena_base = alloc(host.mem, bytes, "SceLibJson arena");
+        if (!arena_base) {
+            return -1;
+        }
+    }
+    Arena arena = { host.mem, arena_base };
+    write_value(arena, dom, dst.address(), 0);
+
+    JsonValue *root = dst.get(host.mem);
+    root->type |= OWNS_ARENA;
+    root->link = arena_base;
+    return 0;
+}
+
+static int parse_buffer(HostState &host, Ptr<JsonValue> root, const char *text, size_t size) {
+    if (!root || !text) {
+        return -1;
+    }
+    HostJsonValue dom;
+    Cursor c = { text, text + size };
+    if (!parse_json_value(c, dom, 0)) {
+        return -1;
+    }
+    skip_whitespace(c);
+    if (c.p != c.end) {
+        return -1;
+    }
+    release_value(host, root.get(host.mem));
+    return materialize(host, root, dom);
+}
+
+// ---------------------------------------------------------------------------
+// Guest tree readers - deep copies and serialization.
+
+static void read_value(const MemState &mem, const JsonValue *value, HostJsonValue &out);
+
+static void read_array(const MemState &mem, Address header_addr, HostJsonValue &out) {
+    out.type = VALUE_ARRAY;
+    if (!header_addr) {
+        return;
+    }
+    const JsonArray *header = Ptr<JsonArray>(header_addr).get(mem);
+    for (uint32_t i = 0; i < header->count; ++i) {
+        HostJsonValue element;
+        read_value(mem, Ptr<JsonValue>(header_addr + sizeof(JsonArray) + (i * sizeof(JsonValue))).get(mem), element);
+        out.elements.push_back(std::move(element));
+    }
+}
+
+static void read_object(const MemState &mem, Address header_addr, HostJsonValue &out) {
+    out.type = VALUE_OBJECT;
+    if (!header_addr) {
+        return;
+    }
+    const JsonObject *header = Ptr<JsonObject>(header_addr).get(mem);
+    for (uint32_t i = 0; i < header->count; ++i) {
+        const Address pair = header_addr + sizeof(JsonObject) + (i * sizeof(JsonPair));
+        HostJsonValue member;
+        read_value(mem, Ptr<JsonValue>(pair + offsetof(JsonPair, value)).get(mem), member);
+        out.members.emplace_back(string_chars(mem, Ptr<JsonString>(pair).get(mem)), std::move(member));
+    }
+}
+
+static void read_value(const MemState &mem, const JsonValue *value, HostJsonValue &out) {
+    out.type = value->type & TYPE_MASK;
+    switch (out.type) {
+    case VALUE_BOOLEAN:
+        out.boolean = value->boolean != 0;
+        break;
+    case VALUE_INTEGER:
+        out.integer = value->integer;
+        break;
+    case VALUE_UINTEGER:
+        out.uinteger = value->uinteger;
+        break;
+    case VALUE_REAL:
+        out.real = value->real;
+        break;
+    case VALUE_STRING:
+        if (value->ref.data) {
+            out.string = string_chars(mem, Ptr<JsonString>(value->ref.data).get(mem));
+        }
+        break;
+    case VALUE_ARRAY:
+        read_array(mem, value->ref.data, out);
+        break;
+    case VALUE_OBJECT:
+        read_object(mem, value->ref.data, out);
+        break;
+    default:
+        break;
+    }
+}
+
+static int assign_deep(HostState &host, Ptr<JsonValue> dst, const JsonValue *src) {
+    HostJsonValue dom;
+    read_value(host.mem, src, dom);
+    release_value(host, dst.get(host.mem));
+    return materialize(host, dst, dom);
+}
+
+static void append_escaped(std::string &out, const char *text, uint32_t length) {
+    out += '"';
+    for (uint32_t i = 0; i < length; ++i) {
+        const char ch = text[i];
+        switch (ch) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (uint8_t(ch) < 0x20) {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", ch);
+                out += buf;
+            } else {
+                out += ch;
+            }
+            break;
+        }
+    }
+    out += '"';
+}
+
+static void serialize_value(const MemState &mem, const JsonValue *value, std::string &out) {
+    switch (value->type & TYPE_MASK) {
+    case VALUE_BOOLEAN:
+        out += value->boolean ? "true" : "false";
+        break;
+    case VALUE_INTEGER:
+        out += std::to_string(value->integer);
+        break;
+    case VALUE_UINTEGER:
+        out += std::to_string(value->uinteger);
+        break;
+    case VALUE_REAL: {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.17g", value->real);
+        out += buf;
+        break;
+    }
+    case VALUE_STRING:
+        if (value->ref.data) {
+            const JsonString *string = Ptr<JsonString>(value->ref.data).get(mem);
+            append_escaped(out, string->data ? Ptr<const char>(string->data).get(mem) : "", string->length);
+        } else {
+            out += "\"\"";
+        }
+        break;
+    case VALUE_ARRAY:
+        out += '[';
+        for (uint32_t i = 0; i < value->ref.count; ++i) {
+            if (i > 0) {
+                out += ',';
+            }
+            serialize_value(mem, Ptr<JsonValue>(value->ref.data + sizeof(JsonArray) + (i * sizeof(JsonValue))).get(mem), out);
+        }
+        out += ']';
+        break;
+    case VALUE_OBJECT:
+        out += '{';
+        for (uint32_t i = 0; i < value->ref.count; ++i) {
+            if (i > 0) {
+                out += ',';
+            }
+            const Address pair = value->ref.data + sizeof(JsonObject) + (i * sizeof(JsonPair));
+            const JsonString *name = Ptr<JsonString>(pair).get(mem);
+            append_escaped(out, name->data ? Ptr<const char>(name->data).get(mem) : "", name->length);
+            out += ':';
+            serialize_value(mem, Ptr<JsonValue>(pair + offsetof(JsonPair, value)).get(mem), out);
+        }
+        out += '}';
+        break;
+    default:
+        out += "null";
+        break;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Lookups.
+
+static Address object_member(const MemState &mem, const JsonValue *value, const char *name, uint32_t length) {
+    if (((value->type & TYPE_MASK) != VALUE_OBJECT) || !value->ref.data) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < value->ref.count; ++i) {
+        const Address pair = value->ref.data + sizeof(JsonObject) + (i * sizeof(JsonPair));
+        const JsonString *key = Ptr<JsonString>(pair).get(mem);
+        if (key->length != length) {
+            continue;
+        }
+        const char *chars = key->data ? Ptr<const char>(key->data).get(mem) : "";
+        if (memcmp(chars, name, length) == 0) {
+            return pair + offsetof(JsonPair, value);
+        }
+    }
+    return 0;
+}
+
+static Address child_at(const JsonValue *value, uint32_t index) {
+    if (!value->ref.data || (index >= value->ref.count)) {
+        return 0;
+    }
+    switch (value->type & TYPE_MASK) {
+    case VALUE_ARRAY:
+        return value->ref.data + sizeof(JsonArray) + (index * sizeof(JsonValue));
+    case VALUE_OBJECT:
+        return value->ref.data + sizeof(JsonObject) + (index * sizeof(JsonPair)) + offsetof(JsonPair, value);
+    default:
+        return 0;
+    }
+}
+
+// Convert a Value to an empty container/string of the requested type for the
+// refer* family, giving it a minimal arena of its own.
+static Address convert_for_refer(HostState &host, JsonValue *value, uint32_t type) {
+    release_value(host, value);
+    const size_t bytes = (type == VALUE_STRING) ? align8(sizeof(JsonString) + 1) : sizeof(JsonArray);
+    const Address block = alloc(host.mem, bytes, "SceLibJson refer");
+    if (!block) {
+        return 0;
+    }
+    memset(Ptr<uint8_t>(block).get(host.mem), 0, bytes);
+    if (type == VALUE_STRING) {
+        JsonString *header = Ptr<JsonString>(block).get(host.mem);
+        header->data = block + sizeof(JsonString);
+    }
+    value->type = type | OWNS_ARENA;
+    value->link = block;
+    value->ref.data = block;
+    value->ref.count = 0;
+    return block;
+}
+
 EXPORT(int, _ZN3sce4Json11Initializer10initializeEPKNS0_13InitParameterE) {
-    return UNIMPLEMENTED();
+    // Parsing and the value trees run host-side; the guest allocator the
+    // parameter carries is never used.
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json11Initializer24setAllocatorInfoCallBackEPFviNS0_9ValueTypeEPvES3_) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json11Initializer9terminateEv) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json11InitializerC1Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json11InitializerC2Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json11InitializerD1Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json11InitializerD2Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json12MemAllocator11notifyErrorEijPv) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json12MemAllocatorC1Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json12MemAllocatorC2Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json12MemAllocatorD0Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json12MemAllocatorD1Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json12MemAllocatorD2Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
-EXPORT(int, _ZN3sce4Json5Array5clearEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Array5clearEv, Ptr<JsonArray> self) {
+    self.get(host.mem)->count = 0;
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json5Array5eraseERKNS1_8iteratorE) {
@@ -81,48 +914,61 @@ EXPORT(int, _ZN3sce4Json5Array6insertERKNS1_8iteratorERKNS0_5ValueE) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _ZN3sce4Json5Array8iterator7advanceEj) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Array8iterator7advanceEj, Ptr<JsonIterator> self, uint32_t distance) {
+    self.get(host.mem)->current += distance * sizeof(JsonValue);
+    return 0;
 }
 
-EXPORT(int, _ZN3sce4Json5Array8iteratorC1ERKS2_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json5Array8iteratorC1ERKS2_, Ptr<JsonIterator> self, Ptr<JsonIterator> other) {
+    self.get(host.mem)->current = other.get(host.mem)->current;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5Array8iteratorC1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json5Array8iteratorC1Ev, Ptr<JsonIterator> self) {
+    self.get(host.mem)->current = 0;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5Array8iteratorC2ERKS2_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json5Array8iteratorC2ERKS2_, Ptr<JsonIterator> self, Ptr<JsonIterator> other) {
+    self.get(host.mem)->current = other.get(host.mem)->current;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5Array8iteratorC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json5Array8iteratorC2Ev, Ptr<JsonIterator> self) {
+    self.get(host.mem)->current = 0;
+    return self;
 }
 
 EXPORT(int, _ZN3sce4Json5Array8iteratorD1Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json5Array8iteratorD2Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
-EXPORT(int, _ZN3sce4Json5Array8iteratoraSERKS2_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json5Array8iteratoraSERKS2_, Ptr<JsonIterator> self, Ptr<JsonIterator> other) {
+    self.get(host.mem)->current = other.get(host.mem)->current;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5Array8iteratorppEi) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json5Array8iteratorppEi, Ptr<JsonIterator> result, Ptr<JsonIterator> self, int) {
+    result.get(host.mem)->current = self.get(host.mem)->current;
+    self.get(host.mem)->current += sizeof(JsonValue);
+    return result;
 }
 
-EXPORT(int, _ZN3sce4Json5Array8iteratorppEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json5Array8iteratorppEv, Ptr<JsonIterator> self) {
+    self.get(host.mem)->current += sizeof(JsonValue);
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5Array8pop_backEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Array8pop_backEv, Ptr<JsonArray> self) {
+    JsonArray *array = self.get(host.mem);
+    if (array->count > 0) {
+        --array->count;
+    }
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json5Array9push_backERKNS0_5ValueE) {
@@ -133,240 +979,420 @@ EXPORT(int, _ZN3sce4Json5ArrayC1ERKS1_) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _ZN3sce4Json5ArrayC1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonArray>, _ZN3sce4Json5ArrayC1Ev, Ptr<JsonArray> self) {
+    self.get(host.mem)->count = 0;
+    return self;
 }
 
 EXPORT(int, _ZN3sce4Json5ArrayC2ERKS1_) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _ZN3sce4Json5ArrayC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonArray>, _ZN3sce4Json5ArrayC2Ev, Ptr<JsonArray> self) {
+    self.get(host.mem)->count = 0;
+    return self;
 }
 
 EXPORT(int, _ZN3sce4Json5ArrayD1Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json5ArrayD2Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json5ArrayaSERKS1_) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _ZN3sce4Json5Value10referArrayEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonArray>, _ZN3sce4Json5Value10referArrayEv, Ptr<JsonValue> self) {
+    JsonValue *value = self.get(host.mem);
+    if (((value->type & TYPE_MASK) != VALUE_ARRAY) || !value->ref.data) {
+        convert_for_refer(host, value, VALUE_ARRAY);
+    }
+    return Ptr<JsonArray>(value->ref.data);
 }
 
-EXPORT(int, _ZN3sce4Json5Value10referValueERKNS0_6StringE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5Value10referValueERKNS0_6StringE, Ptr<JsonValue> self, Ptr<JsonString> name) {
+    // Creating absent members would need the fixed arena to grow, so a miss
+    // refers the shared null value instead.
+    const std::string key = string_chars(host.mem, name.get(host.mem));
+    const Address member = object_member(host.mem, self.get(host.mem), key.c_str(), uint32_t(key.size()));
+    return Ptr<JsonValue>(member ? member : null_block(host).value);
 }
 
-EXPORT(int, _ZN3sce4Json5Value10referValueEj) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5Value10referValueEj, Ptr<JsonValue> self, uint32_t index) {
+    const Address child = child_at(self.get(host.mem), index);
+    return Ptr<JsonValue>(child ? child : null_block(host).value);
 }
 
-EXPORT(int, _ZN3sce4Json5Value11referObjectEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonObject>, _ZN3sce4Json5Value11referObjectEv, Ptr<JsonValue> self) {
+    JsonValue *value = self.get(host.mem);
+    if (((value->type & TYPE_MASK) != VALUE_OBJECT) || !value->ref.data) {
+        convert_for_refer(host, value, VALUE_OBJECT);
+    }
+    return Ptr<JsonObject>(value->ref.data);
 }
 
-EXPORT(int, _ZN3sce4Json5Value11referStringEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonString>, _ZN3sce4Json5Value11referStringEv, Ptr<JsonValue> self) {
+    JsonValue *value = self.get(host.mem);
+    if (((value->type & TYPE_MASK) != VALUE_STRING) || !value->ref.data) {
+        convert_for_refer(host, value, VALUE_STRING);
+    }
+    return Ptr<JsonString>(value->ref.data);
 }
 
-EXPORT(int, _ZN3sce4Json5Value12referBooleanEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<uint32_t>, _ZN3sce4Json5Value12referBooleanEv, Ptr<JsonValue> self) {
+    JsonValue *value = self.get(host.mem);
+    if ((value->type & TYPE_MASK) != VALUE_BOOLEAN) {
+        release_value(host, value);
+        value->type = VALUE_BOOLEAN;
+    }
+    return Ptr<uint32_t>(self.address() + offsetof(JsonValue, boolean));
 }
 
-EXPORT(int, _ZN3sce4Json5Value12referIntegerEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<int64_t>, _ZN3sce4Json5Value12referIntegerEv, Ptr<JsonValue> self) {
+    JsonValue *value = self.get(host.mem);
+    if ((value->type & TYPE_MASK) != VALUE_INTEGER) {
+        release_value(host, value);
+        value->type = VALUE_INTEGER;
+    }
+    return Ptr<int64_t>(self.address() + offsetof(JsonValue, integer));
 }
 
-EXPORT(int, _ZN3sce4Json5Value13referUIntegerEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<uint64_t>, _ZN3sce4Json5Value13referUIntegerEv, Ptr<JsonValue> self) {
+    JsonValue *value = self.get(host.mem);
+    if ((value->type & TYPE_MASK) != VALUE_UINTEGER) {
+        release_value(host, value);
+        value->type = VALUE_UINTEGER;
+    }
+    return Ptr<uint64_t>(self.address() + offsetof(JsonValue, uinteger));
 }
 
 EXPORT(int, _ZN3sce4Json5Value21setNullAccessCallBackEPFRKS1_NS0_9ValueTypeEPS2_PvES6_) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _ZN3sce4Json5Value3setENS0_9ValueTypeE) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Value3setENS0_9ValueTypeE, Ptr<JsonValue> self, uint32_t type) {
+    JsonValue *value = self.get(host.mem);
+    release_value(host, value);
+    value->type = type & TYPE_MASK;
+    return 0;
 }
 
-EXPORT(int, _ZN3sce4Json5Value3setERKNS0_5ArrayE) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Value3setERKNS0_5ArrayE, Ptr<JsonValue> self, Ptr<JsonArray> array) {
+    HostJsonValue dom;
+    read_array(host.mem, array.address(), dom);
+    release_value(host, self.get(host.mem));
+    return materialize(host, self, dom);
 }
 
-EXPORT(int, _ZN3sce4Json5Value3setERKNS0_6ObjectE) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Value3setERKNS0_6ObjectE, Ptr<JsonValue> self, Ptr<JsonObject> object) {
+    HostJsonValue dom;
+    read_object(host.mem, object.address(), dom);
+    release_value(host, self.get(host.mem));
+    return materialize(host, self, dom);
 }
 
-EXPORT(int, _ZN3sce4Json5Value3setERKNS0_6StringE) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Value3setERKNS0_6StringE, Ptr<JsonValue> self, Ptr<JsonString> string) {
+    HostJsonValue dom;
+    dom.type = VALUE_STRING;
+    dom.string = string_chars(host.mem, string.get(host.mem));
+    release_value(host, self.get(host.mem));
+    return materialize(host, self, dom);
 }
 
-EXPORT(int, _ZN3sce4Json5Value3setERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Value3setERKS1_, Ptr<JsonValue> self, Ptr<JsonValue> other) {
+    return assign_deep(host, self, other.get(host.mem));
 }
 
-EXPORT(int, _ZN3sce4Json5Value3setEb) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Value3setEb, Ptr<JsonValue> self, int boolean) {
+    JsonValue *value = self.get(host.mem);
+    release_value(host, value);
+    value->type = VALUE_BOOLEAN;
+    value->boolean = boolean ? 1 : 0;
+    return 0;
 }
 
-EXPORT(int, _ZN3sce4Json5Value3setEd) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Value3setEd, Ptr<JsonValue> self, uint64_t raw) {
+    // The double travels in a GPR pair under the softfp ABI.
+    JsonValue *value = self.get(host.mem);
+    release_value(host, value);
+    value->type = VALUE_REAL;
+    memcpy(&value->real, &raw, sizeof(value->real));
+    return 0;
 }
 
-EXPORT(int, _ZN3sce4Json5Value3setEx) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Value3setEx, Ptr<JsonValue> self, uint64_t raw) {
+    JsonValue *value = self.get(host.mem);
+    release_value(host, value);
+    value->type = VALUE_INTEGER;
+    value->integer = int64_t(raw);
+    return 0;
 }
 
-EXPORT(int, _ZN3sce4Json5Value3setEy) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Value3setEy, Ptr<JsonValue> self, uint64_t raw) {
+    JsonValue *value = self.get(host.mem);
+    release_value(host, value);
+    value->type = VALUE_UINTEGER;
+    value->uinteger = raw;
+    return 0;
 }
 
-EXPORT(int, _ZN3sce4Json5Value4swapERS1_) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Value4swapERS1_, Ptr<JsonValue> self, Ptr<JsonValue> other) {
+    JsonValue *a = self.get(host.mem);
+    JsonValue *b = other.get(host.mem);
+    const JsonValue tmp = *a;
+    *a = *b;
+    *b = tmp;
+    return 0;
 }
 
-EXPORT(int, _ZN3sce4Json5Value5clearEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Value5clearEv, Ptr<JsonValue> self) {
+    release_value(host, self.get(host.mem));
+    return 0;
 }
 
-EXPORT(int, _ZN3sce4Json5Value9referRealEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<double>, _ZN3sce4Json5Value9referRealEv, Ptr<JsonValue> self) {
+    JsonValue *value = self.get(host.mem);
+    if ((value->type & TYPE_MASK) != VALUE_REAL) {
+        release_value(host, value);
+        value->type = VALUE_REAL;
+    }
+    return Ptr<double>(self.address() + offsetof(JsonValue, real));
 }
 
-EXPORT(int, _ZN3sce4Json5Value9serializeERNS0_6StringE) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json5Value9serializeERNS0_6StringE, Ptr<JsonValue> self, Ptr<JsonString> out) {
+    std::string text;
+    serialize_value(host.mem, self.get(host.mem), text);
+    assign_string(host, out.get(host.mem), text.c_str(), uint32_t(text.size()));
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json5Value9serializeERNS0_6StringEPFiS3_PvES4_) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC1ENS0_9ValueTypeE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC1ENS0_9ValueTypeE, Ptr<JsonValue> self, uint32_t type) {
+    JsonValue *value = self.get(host.mem);
+    memset(value, 0, sizeof(JsonValue));
+    value->type = type & TYPE_MASK;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC1ERKNS0_5ArrayE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC1ERKNS0_5ArrayE, Ptr<JsonValue> self, Ptr<JsonArray> array) {
+    memset(self.get(host.mem), 0, sizeof(JsonValue));
+    HostJsonValue dom;
+    read_array(host.mem, array.address(), dom);
+    materialize(host, self, dom);
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC1ERKNS0_6ObjectE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC1ERKNS0_6ObjectE, Ptr<JsonValue> self, Ptr<JsonObject> object) {
+    memset(self.get(host.mem), 0, sizeof(JsonValue));
+    HostJsonValue dom;
+    read_object(host.mem, object.address(), dom);
+    materialize(host, self, dom);
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC1ERKNS0_6StringE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC1ERKNS0_6StringE, Ptr<JsonValue> self, Ptr<JsonString> string) {
+    memset(self.get(host.mem), 0, sizeof(JsonValue));
+    HostJsonValue dom;
+    dom.type = VALUE_STRING;
+    dom.string = string_chars(host.mem, string.get(host.mem));
+    materialize(host, self, dom);
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC1ERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC1ERKS1_, Ptr<JsonValue> self, Ptr<JsonValue> other) {
+    memset(self.get(host.mem), 0, sizeof(JsonValue));
+    HostJsonValue dom;
+    read_value(host.mem, other.get(host.mem), dom);
+    materialize(host, self, dom);
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC1Eb) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC1Eb, Ptr<JsonValue> self, int boolean) {
+    JsonValue *value = self.get(host.mem);
+    memset(value, 0, sizeof(JsonValue));
+    value->type = VALUE_BOOLEAN;
+    value->boolean = boolean ? 1 : 0;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC1Ed) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC1Ed, Ptr<JsonValue> self, uint64_t raw) {
+    JsonValue *value = self.get(host.mem);
+    memset(value, 0, sizeof(JsonValue));
+    value->type = VALUE_REAL;
+    memcpy(&value->real, &raw, sizeof(value->real));
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC1Ev, Ptr<JsonValue> self) {
+    memset(self.get(host.mem), 0, sizeof(JsonValue));
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC1Ex) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC1Ex, Ptr<JsonValue> self, uint64_t raw) {
+    JsonValue *value = self.get(host.mem);
+    memset(value, 0, sizeof(JsonValue));
+    value->type = VALUE_INTEGER;
+    value->integer = int64_t(raw);
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC1Ey) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC1Ey, Ptr<JsonValue> self, uint64_t raw) {
+    JsonValue *value = self.get(host.mem);
+    memset(value, 0, sizeof(JsonValue));
+    value->type = VALUE_UINTEGER;
+    value->uinteger = raw;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC2ENS0_9ValueTypeE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC2ENS0_9ValueTypeE, Ptr<JsonValue> self, uint32_t type) {
+    JsonValue *value = self.get(host.mem);
+    memset(value, 0, sizeof(JsonValue));
+    value->type = type & TYPE_MASK;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC2ERKNS0_5ArrayE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC2ERKNS0_5ArrayE, Ptr<JsonValue> self, Ptr<JsonArray> array) {
+    memset(self.get(host.mem), 0, sizeof(JsonValue));
+    HostJsonValue dom;
+    read_array(host.mem, array.address(), dom);
+    materialize(host, self, dom);
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC2ERKNS0_6ObjectE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC2ERKNS0_6ObjectE, Ptr<JsonValue> self, Ptr<JsonObject> object) {
+    memset(self.get(host.mem), 0, sizeof(JsonValue));
+    HostJsonValue dom;
+    read_object(host.mem, object.address(), dom);
+    materialize(host, self, dom);
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC2ERKNS0_6StringE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC2ERKNS0_6StringE, Ptr<JsonValue> self, Ptr<JsonString> string) {
+    memset(self.get(host.mem), 0, sizeof(JsonValue));
+    HostJsonValue dom;
+    dom.type = VALUE_STRING;
+    dom.string = string_chars(host.mem, string.get(host.mem));
+    materialize(host, self, dom);
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC2ERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC2ERKS1_, Ptr<JsonValue> self, Ptr<JsonValue> other) {
+    memset(self.get(host.mem), 0, sizeof(JsonValue));
+    HostJsonValue dom;
+    read_value(host.mem, other.get(host.mem), dom);
+    materialize(host, self, dom);
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC2Eb) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC2Eb, Ptr<JsonValue> self, int boolean) {
+    JsonValue *value = self.get(host.mem);
+    memset(value, 0, sizeof(JsonValue));
+    value->type = VALUE_BOOLEAN;
+    value->boolean = boolean ? 1 : 0;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC2Ed) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC2Ed, Ptr<JsonValue> self, uint64_t raw) {
+    JsonValue *value = self.get(host.mem);
+    memset(value, 0, sizeof(JsonValue));
+    value->type = VALUE_REAL;
+    memcpy(&value->real, &raw, sizeof(value->real));
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC2Ev, Ptr<JsonValue> self) {
+    memset(self.get(host.mem), 0, sizeof(JsonValue));
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC2Ex) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC2Ex, Ptr<JsonValue> self, uint64_t raw) {
+    JsonValue *value = self.get(host.mem);
+    memset(value, 0, sizeof(JsonValue));
+    value->type = VALUE_INTEGER;
+    value->integer = int64_t(raw);
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueC2Ey) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueC2Ey, Ptr<JsonValue> self, uint64_t raw) {
+    JsonValue *value = self.get(host.mem);
+    memset(value, 0, sizeof(JsonValue));
+    value->type = VALUE_UINTEGER;
+    value->uinteger = raw;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueD1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueD1Ev, Ptr<JsonValue> self) {
+    release_value(host, self.get(host.mem));
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueD2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueD2Ev, Ptr<JsonValue> self) {
+    release_value(host, self.get(host.mem));
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json5ValueaSERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json5ValueaSERKS1_, Ptr<JsonValue> self, Ptr<JsonValue> other) {
+    assign_deep(host, self, other.get(host.mem));
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json6Object4PairC1ERKNS0_6StringERKNS0_5ValueE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonPair>, _ZN3sce4Json6Object4PairC1ERKNS0_6StringERKNS0_5ValueE, Ptr<JsonPair> self, Ptr<JsonString> name, Ptr<JsonValue> value) {
+    JsonPair *pair = self.get(host.mem);
+    memset(pair, 0, sizeof(JsonPair));
+    const std::string key = string_chars(host.mem, name.get(host.mem));
+    assign_string(host, &pair->name, key.c_str(), uint32_t(key.size()));
+    HostJsonValue dom;
+    read_value(host.mem, value.get(host.mem), dom);
+    materialize(host, Ptr<JsonValue>(self.address() + offsetof(JsonPair, value)), dom);
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json6Object4PairC1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonPair>, _ZN3sce4Json6Object4PairC1Ev, Ptr<JsonPair> self) {
+    memset(self.get(host.mem), 0, sizeof(JsonPair));
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json6Object4PairC2ERKNS0_6StringERKNS0_5ValueE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonPair>, _ZN3sce4Json6Object4PairC2ERKNS0_6StringERKNS0_5ValueE, Ptr<JsonPair> self, Ptr<JsonString> name, Ptr<JsonValue> value) {
+    JsonPair *pair = self.get(host.mem);
+    memset(pair, 0, sizeof(JsonPair));
+    const std::string key = string_chars(host.mem, name.get(host.mem));
+    assign_string(host, &pair->name, key.c_str(), uint32_t(key.size()));
+    HostJsonValue dom;
+    read_value(host.mem, value.get(host.mem), dom);
+    materialize(host, Ptr<JsonValue>(self.address() + offsetof(JsonPair, value)), dom);
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json6Object4PairC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonPair>, _ZN3sce4Json6Object4PairC2Ev, Ptr<JsonPair> self) {
+    memset(self.get(host.mem), 0, sizeof(JsonPair));
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json6Object4PairD1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonPair>, _ZN3sce4Json6Object4PairD1Ev, Ptr<JsonPair> self) {
+    JsonPair *pair = self.get(host.mem);
+    free_chars(host, pair->name.data);
+    release_value(host, &pair->value);
+    memset(pair, 0, sizeof(JsonPair));
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json6Object4PairD2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonPair>, _ZN3sce4Json6Object4PairD2Ev, Ptr<JsonPair> self) {
+    JsonPair *pair = self.get(host.mem);
+    free_chars(host, pair->name.data);
+    release_value(host, &pair->value);
+    memset(pair, 0, sizeof(JsonPair));
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json6Object5clearEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json6Object5clearEv, Ptr<JsonObject> self) {
+    self.get(host.mem)->count = 0;
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json6Object5eraseERKNS0_6StringE) {
@@ -377,364 +1403,679 @@ EXPORT(int, _ZN3sce4Json6Object6insertERKNS1_4PairE) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _ZN3sce4Json6Object8iterator7advanceEj) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json6Object8iterator7advanceEj, Ptr<JsonIterator> self, uint32_t distance) {
+    self.get(host.mem)->current += distance * sizeof(JsonPair);
+    return 0;
 }
 
-EXPORT(int, _ZN3sce4Json6Object8iteratorC1ERKS2_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json6Object8iteratorC1ERKS2_, Ptr<JsonIterator> self, Ptr<JsonIterator> other) {
+    self.get(host.mem)->current = other.get(host.mem)->current;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json6Object8iteratorC1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json6Object8iteratorC1Ev, Ptr<JsonIterator> self) {
+    self.get(host.mem)->current = 0;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json6Object8iteratorC2ERKS2_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json6Object8iteratorC2ERKS2_, Ptr<JsonIterator> self, Ptr<JsonIterator> other) {
+    self.get(host.mem)->current = other.get(host.mem)->current;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json6Object8iteratorC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json6Object8iteratorC2Ev, Ptr<JsonIterator> self) {
+    self.get(host.mem)->current = 0;
+    return self;
 }
 
 EXPORT(int, _ZN3sce4Json6Object8iteratorD1Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json6Object8iteratorD2Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
-EXPORT(int, _ZN3sce4Json6Object8iteratoraSERKS2_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json6Object8iteratoraSERKS2_, Ptr<JsonIterator> self, Ptr<JsonIterator> other) {
+    self.get(host.mem)->current = other.get(host.mem)->current;
+    return self;
 }
 
-EXPORT(int, _ZN3sce4Json6Object8iteratorppEi) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json6Object8iteratorppEi, Ptr<JsonIterator> result, Ptr<JsonIterator> self, int) {
+    result.get(host.mem)->current = self.get(host.mem)->current;
+    self.get(host.mem)->current += sizeof(JsonPair);
+    return result;
 }
 
-EXPORT(int, _ZN3sce4Json6Object8iteratorppEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZN3sce4Json6Object8iteratorppEv, Ptr<JsonIterator> self) {
+    self.get(host.mem)->current += sizeof(JsonPair);
+    return self;
 }
 
 EXPORT(int, _ZN3sce4Json6ObjectC1ERKS1_) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _ZN3sce4Json6ObjectC1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonObject>, _ZN3sce4Json6ObjectC1Ev, Ptr<JsonObject> self) {
+    self.get(host.mem)->count = 0;
+    return self;
 }
 
 EXPORT(int, _ZN3sce4Json6ObjectC2ERKS1_) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _ZN3sce4Json6ObjectC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonObject>, _ZN3sce4Json6ObjectC2Ev, Ptr<JsonObject> self) {
+    self.get(host.mem)->count = 0;
+    return self;
 }
 
 EXPORT(int, _ZN3sce4Json6ObjectD1Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json6ObjectD2Ev) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce4Json6ObjectaSERKS1_) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _ZN3sce4Json6ObjectixERKNS0_6StringE) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6Parser5parseERNS0_5ValueEPFiRcPvES5_) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6Parser5parseERNS0_5ValueEPKc) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6Parser5parseERNS0_5ValueEPKcj) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZN3sce4Json6ObjectixERKNS0_6StringE, Ptr<JsonObject> self, Ptr<JsonString> name) {
+    const std::string key = string_chars(host.mem, name.get(host.mem));
+    const JsonObject *object = self.get(host.mem);
+    for (uint32_t i = 0; i < object->count; ++i) {
+        const Address pair = self.address() + sizeof(JsonObject) + (i * sizeof(JsonPair));
+        const JsonString *candidate = Ptr<JsonString>(pair).get(host.mem);
+        if (candidate->length != key.size()) {
+            continue;
+        }
+        const char *chars = candidate->data ? Ptr<const char>(candidate->data).get(host.mem) : "";
+        if (memcmp(chars, key.c_str(), key.size()) == 0) {
+            return Ptr<JsonValue>(pair + offsetof(JsonPair, value));
+        }
+    }
+    return Ptr<JsonValue>(null_block(host).value);
+}
+
+EXPORT(int, _ZN3sce4Json6Parser5parseERNS0_5ValueEPFiRcPvES5_, Ptr<JsonValue> value, Ptr<const void> callback, Ptr<void> user) {
+    if (!value || !callback) {
+        return -1;
+    }
+    const ThreadStatePtr thread = lock_and_find(thread_id, host.kernel.threads, host.kernel.mutex);
+    if (!thread) {
+        return -1;
+    }
+    const Address scratch = alloc(host.mem, 1, "SceLibJson parse");
+    if (!scratch) {
+        return -1;
+    }
+
+    // The reader hands over one character per call; pull the whole document
+    // into a host buffer first so the parse itself runs at host speed. The
+    // buffer overloads below skip this and are the fast path.
+    std::string text;
+    while (true) {
+        Ptr<void> argp = user;
+        const int result = int(run_on_current(*thread, callback, scratch, argp));
+        if (result != 0) {
+            break;
+        }
+        const char ch = *Ptr<const char>(scratch).get(host.mem);
+        if (ch == '\0') {
+            break;
+        }
+        text += ch;
+        if (text.size() > (16 * 1024 * 1024)) {
+            break; // runaway reader
+        }
+    }
+    free(host.mem, scratch);
+
+    // The real library returns module-specific negative codes; titles only
+    // test against SCE_OK.
+    return parse_buffer(host, value, text.c_str(), text.size());
+}
+
+EXPORT(int, _ZN3sce4Json6Parser5parseERNS0_5ValueEPKc, Ptr<JsonValue> value, const char *text) {
+    if (!text) {
+        return -1;
+    }
+    return parse_buffer(host, value, text, strlen(text));
+}
+
+EXPORT(int, _ZN3sce4Json6Parser5parseERNS0_5ValueEPKcj, Ptr<JsonValue> value, const char *text, uint32_t size) {
+    return parse_buffer(host, value, text, size);
 }
 
 EXPORT(int, _ZN3sce4Json6String4nposE) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _ZN3sce4Json6String5clearEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6String6appendEPKc) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6String6appendEPKcj) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6String6appendERKS1_) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6String6resizeEj) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6StringC1EPKc) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6StringC1ERKS1_) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6StringC1Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6StringC2EPKc) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6StringC2ERKS1_) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6StringC2Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6StringD1Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6StringD2Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6StringaSERKS1_) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6StringpLEPKc) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce4Json6StringpLEh) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce4Json5Array3endEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce4Json5Array4backEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce4Json5Array4sizeEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce4Json5Array5beginEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json6String5clearEv, Ptr<JsonString> self) {
+    JsonString *string = self.get(host.mem);
+    free_chars(host, string->data);
+    string->data = 0;
+    string->length = 0;
+    return 0;
 }
 
-EXPORT(int, _ZNK3sce4Json5Array5emptyEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json6String6appendEPKc, Ptr<JsonString> self, const char *text) {
+    if (!text) {
+        return 0;
+    }
+    JsonString *string = self.get(host.mem);
+    std::string merged = string_chars(host.mem, string);
+    merged += text;
+    assign_string(host, string, merged.c_str(), uint32_t(merged.size()));
+    return 0;
 }
 
-EXPORT(int, _ZNK3sce4Json5Array8iteratordeEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json6String6appendEPKcj, Ptr<JsonString> self, const char *text, uint32_t size) {
+    if (!text) {
+        return 0;
+    }
+    JsonString *string = self.get(host.mem);
+    std::string merged = string_chars(host.mem, string);
+    merged.append(text, size);
+    assign_string(host, string, merged.c_str(), uint32_t(merged.size()));
+    return 0;
 }
 
-EXPORT(int, _ZNK3sce4Json5Array8iteratorneES2_) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json6String6appendERKS1_, Ptr<JsonString> self, Ptr<JsonString> other) {
+    JsonString *string = self.get(host.mem);
+    std::string merged = string_chars(host.mem, string);
+    merged += string_chars(host.mem, other.get(host.mem));
+    assign_string(host, string, merged.c_str(), uint32_t(merged.size()));
+    return 0;
 }
 
-EXPORT(int, _ZNK3sce4Json5Array8iteratorptEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce4Json6String6resizeEj, Ptr<JsonString> self, uint32_t size) {
+    JsonString *string = self.get(host.mem);
+    std::string resized = string_chars(host.mem, string);
+    resized.resize(size, '\0');
+    assign_string(host, string, resized.c_str(), uint32_t(resized.size()));
+    return 0;
 }
 
-EXPORT(int, _ZNK3sce4Json5Value10getBooleanEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonString>, _ZN3sce4Json6StringC1EPKc, Ptr<JsonString> self, const char *text) {
+    JsonString *string = self.get(host.mem);
+    string->data = 0;
+    string->length = 0;
+    assign_string(host, string, text ? text : "", text ? uint32_t(strlen(text)) : 0);
+    return self;
 }
 
-EXPORT(int, _ZNK3sce4Json5Value10getIntegerEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonString>, _ZN3sce4Json6StringC1ERKS1_, Ptr<JsonString> self, Ptr<JsonString> other) {
+    JsonString *string = self.get(host.mem);
+    string->data = 0;
+    string->length = 0;
+    const std::string copy = string_chars(host.mem, other.get(host.mem));
+    assign_string(host, string, copy.c_str(), uint32_t(copy.size()));
+    return self;
 }
 
-EXPORT(int, _ZNK3sce4Json5Value11getUIntegerEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonString>, _ZN3sce4Json6StringC1Ev, Ptr<JsonString> self) {
+    JsonString *string = self.get(host.mem);
+    string->data = 0;
+    string->length = 0;
+    return self;
 }
 
-EXPORT(int, _ZNK3sce4Json5Value5countEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonString>, _ZN3sce4Json6StringC2EPKc, Ptr<JsonString> self, const char *text) {
+    JsonString *string = self.get(host.mem);
+    string->data = 0;
+    string->length = 0;
+    assign_string(host, string, text ? text : "", text ? uint32_t(strlen(text)) : 0);
+    return self;
 }
 
-EXPORT(int, _ZNK3sce4Json5Value7getRealEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonString>, _ZN3sce4Json6StringC2ERKS1_, Ptr<JsonString> self, Ptr<JsonString> other) {
+    JsonString *string = self.get(host.mem);
+    string->data = 0;
+    string->length = 0;
+    const std::string copy = string_chars(host.mem, other.get(host.mem));
+    assign_string(host, string, copy.c_str(), uint32_t(copy.size()));
+    return self;
 }
 
-EXPORT(int, _ZNK3sce4Json5Value7getRootEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonString>, _ZN3sce4Json6StringC2Ev, Ptr<JsonString> self) {
+    JsonString *string = self.get(host.mem);
+    string->data = 0;
+    string->length = 0;
+    return self;
 }
 
-EXPORT(int, _ZNK3sce4Json5Value7getTypeEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonString>, _ZN3sce4Json6StringD1Ev, Ptr<JsonString> self) {
+    JsonString *string = self.get(host.mem);
+    free_chars(host, string->data);
+    string->data = 0;
+    string->length = 0;
+    return self;
 }
 
-EXPORT(int, _ZNK3sce4Json5Value8getArrayEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonString>, _ZN3sce4Json6StringD2Ev, Ptr<JsonString> self) {
+    JsonString *string = self.get(host.mem);
+    free_chars(host, string->data);
+    string->data = 0;
+    string->length = 0;
+    return self;
 }
 
-EXPORT(int, _ZNK3sce4Json5Value8getValueERKNS0_6StringE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonString>, _ZN3sce4Json6StringaSERKS1_, Ptr<JsonString> self, Ptr<JsonString> other) {
+    const std::string copy = string_chars(host.mem, other.get(host.mem));
+    assign_string(host, self.get(host.mem), copy.c_str(), uint32_t(copy.size()));
+    return self;
 }
 
-EXPORT(int, _ZNK3sce4Json5Value8getValueEj) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonString>, _ZN3sce4Json6StringpLEPKc, Ptr<JsonString> self, const char *text) {
+    if (text) {
+        JsonString *string = self.get(host.mem);
+        std::string merged = string_chars(host.mem, string);
+        merged += text;
+        assign_string(host, string, merged.c_str(), uint32_t(merged.size()));
+    }
+    return self;
 }
 
-EXPORT(int, _ZNK3sce4Json5Value8toStringERNS0_6StringE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonString>, _ZN3sce4Json6StringpLEh, Ptr<JsonString> self, uint32_t ch) {
+    JsonString *string = self.get(host.mem);
+    std::string merged = string_chars(host.mem, string);
+    merged += char(ch);
+    assign_string(host, string, merged.c_str(), uint32_t(merged.size()));
+    return self;
 }
 
-EXPORT(int, _ZNK3sce4Json5Value9getObjectEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZNK3sce4Json5Array3endEv, Ptr<JsonIterator> result, Ptr<JsonArray> self) {
+    const JsonArray *array = self.get(host.mem);
+    result.get(host.mem)->current = self.address() + sizeof(JsonArray) + (array->count * sizeof(JsonValue));
+    return result;
+}
+
+EXPORT(Ptr<JsonValue>, _ZNK3sce4Json5Array4backEv, Ptr<JsonArray> self) {
+    const JsonArray *array = self.get(host.mem);
+    if (array->count == 0) {
+        return Ptr<JsonValue>(null_block(host).value);
+    }
+    return Ptr<JsonValue>(self.address() + sizeof(JsonArray) + ((array->count - 1) * sizeof(JsonValue)));
+}
+
+EXPORT(uint32_t, _ZNK3sce4Json5Array4sizeEv, Ptr<JsonArray> self) {
+    return self.get(host.mem)->count;
+}
+
+EXPORT(Ptr<JsonIterator>, _ZNK3sce4Json5Array5beginEv, Ptr<JsonIterator> result, Ptr<JsonArray> self) {
+    result.get(host.mem)->current = self.address() + sizeof(JsonArray);
+    return result;
+}
+
+EXPORT(int, _ZNK3sce4Json5Array5emptyEv, Ptr<JsonArray> self) {
+    return self.get(host.mem)->count == 0;
+}
+
+EXPORT(Ptr<JsonValue>, _ZNK3sce4Json5Array8iteratordeEv, Ptr<JsonIterator> self) {
+    return Ptr<JsonValue>(self.get(host.mem)->current);
+}
+
+EXPORT(int, _ZNK3sce4Json5Array8iteratorneES2_, Ptr<JsonIterator> self, Ptr<JsonIterator> other) {
+    return self.get(host.mem)->current != other.get(host.mem)->current;
+}
+
+EXPORT(Ptr<JsonValue>, _ZNK3sce4Json5Array8iteratorptEv, Ptr<JsonIterator> self) {
+    return Ptr<JsonValue>(self.get(host.mem)->current);
+}
+
+EXPORT(int, _ZNK3sce4Json5Value10getBooleanEv, Ptr<JsonValue> self) {
+    const JsonValue *value = self.get(host.mem);
+    switch (value->type & TYPE_MASK) {
+    case VALUE_BOOLEAN:
+        return value->boolean != 0;
+    case VALUE_INTEGER:
+        return value->integer != 0;
+    case VALUE_UINTEGER:
+        return value->uinteger != 0;
+    case VALUE_REAL:
+        return value->real != 0.0;
+    default:
+        return 0;
+    }
+}
+
+EXPORT(uint64_t, _ZNK3sce4Json5Value10getIntegerEv, Ptr<JsonValue> self) {
+    const JsonValue *value = self.get(host.mem);
+    switch (value->type & TYPE_MASK) {
+    case VALUE_BOOLEAN:
+        return value->boolean ? 1 : 0;
+    case VALUE_INTEGER:
+        return uint64_t(value->integer);
+    case VALUE_UINTEGER:
+        return value->uinteger;
+    case VALUE_REAL:
+        return uint64_t(int64_t(value->real));
+    default:
+        return 0;
+    }
+}
+
+EXPORT(uint64_t, _ZNK3sce4Json5Value11getUIntegerEv, Ptr<JsonValue> self) {
+    const JsonValue *value = self.get(host.mem);
+    switch (value->type & TYPE_MASK) {
+    case VALUE_BOOLEAN:
+        return value->boolean ? 1 : 0;
+    case VALUE_INTEGER:
+        return uint64_t(value->integer);
+    case VALUE_UINTEGER:
+        return value->uinteger;
+    case VALUE_REAL:
+        return uint64_t(value->real);
+    default:
+        return 0;
+    }
+}
+
+EXPORT(uint32_t, _ZNK3sce4Json5Value5countEv, Ptr<JsonValue> self) {
+    const JsonValue *value = self.get(host.mem);
+    switch (value->type & TYPE_MASK) {
+    case VALUE_ARRAY:
+    case VALUE_OBJECT:
+        return value->ref.count;
+    default:
+        return 0;
+    }
+}
+
+EXPORT(uint64_t, _ZNK3sce4Json5Value7getRealEv, Ptr<JsonValue> self) {
+    // The double goes back in a GPR pair under the softfp ABI.
+    const JsonValue *value = self.get(host.mem);
+    double real = 0.0;
+    switch (value->type & TYPE_MASK) {
+    case VALUE_BOOLEAN:
+        real = value->boolean ? 1.0 : 0.0;
+        break;
+    case VALUE_INTEGER:
+        real = double(value->integer);
+        break;
+    case VALUE_UINTEGER:
+        real = double(value->uinteger);
+        break;
+    case VALUE_REAL:
+        real = value->real;
+        break;
+    default:
+        break;
+    }
+    uint64_t raw = 0;
+    memcpy(&raw, &real, sizeof(raw));
+    return raw;
+}
+
+EXPORT(Ptr<JsonValue>, _ZNK3sce4Json5Value7getRootEv, Ptr<JsonValue> self) {
+    Address at = self.address();
+    const JsonValue *value = self.get(host.mem);
+    // Bounded in case a stale value cycles through freed memory.
+    for (int depth = 0; depth < 1024; ++depth) {
+        if ((value->type & OWNS_ARENA) || !value->link) {
+            break;
+        }
+        at = value->link;
+        value = Ptr<JsonValue>(at).get(host.mem);
+    }
+    return Ptr<JsonValue>(at);
+}
+
+EXPORT(uint32_t, _ZNK3sce4Json5Value7getTypeEv, Ptr<JsonValue> self) {
+    return self.get(host.mem)->type & TYPE_MASK;
+}
+
+EXPORT(Ptr<JsonArray>, _ZNK3sce4Json5Value8getArrayEv, Ptr<JsonValue> self) {
+    const JsonValue *value = self.get(host.mem);
+    if (((value->type & TYPE_MASK) == VALUE_ARRAY) && value->ref.data) {
+        return Ptr<JsonArray>(value->ref.data);
+    }
+    return Ptr<JsonArray>(null_block(host).array);
+}
+
+EXPORT(Ptr<JsonValue>, _ZNK3sce4Json5Value8getValueERKNS0_6StringE, Ptr<JsonValue> self, Ptr<JsonString> name) {
+    const std::string key = string_chars(host.mem, name.get(host.mem));
+    const Address member = object_member(host.mem, self.get(host.mem), key.c_str(), uint32_t(key.size()));
+    return Ptr<JsonValue>(member ? member : null_block(host).value);
+}
+
+EXPORT(Ptr<JsonValue>, _ZNK3sce4Json5Value8getValueEj, Ptr<JsonValue> self, uint32_t index) {
+    const Address child = child_at(self.get(host.mem), index);
+    return Ptr<JsonValue>(child ? child : null_block(host).value);
+}
+
+EXPORT(int, _ZNK3sce4Json5Value8toStringERNS0_6StringE, Ptr<JsonValue> self, Ptr<JsonString> out) {
+    std::string text;
+    serialize_value(host.mem, self.get(host.mem), text);
+    assign_string(host, out.get(host.mem), text.c_str(), uint32_t(text.size()));
+    return 0;
+}
+
+EXPORT(Ptr<JsonObject>, _ZNK3sce4Json5Value9getObjectEv, Ptr<JsonValue> self) {
+    const JsonValue *value = self.get(host.mem);
+    if (((value->type & TYPE_MASK) == VALUE_OBJECT) && value->ref.data) {
+        return Ptr<JsonObject>(value->ref.data);
+    }
+    return Ptr<JsonObject>(null_block(host).object);
+}
+
+EXPORT(Ptr<JsonString>, _ZNK3sce4Json5Value9getStringEv, Ptr<JsonValue> self) {
+    const JsonValue *value = self.get(host.mem);
+    if (((value->type & TYPE_MASK) == VALUE_STRING) && value->ref.data) {
+        return Ptr<JsonString>(value->ref.data);
+    }
+    return Ptr<JsonString>(null_block(host).string);
+}
+
+EXPORT(int, _ZNK3sce4Json5ValuecvbEv, Ptr<JsonValue> self) {
+    const JsonValue *value = self.get(host.mem);
+    switch (value->type & TYPE_MASK) {
+    case VALUE_BOOLEAN:
+        return value->boolean != 0;
+    case VALUE_INTEGER:
+        return value->integer != 0;
+    case VALUE_UINTEGER:
+        return value->uinteger != 0;
+    case VALUE_REAL:
+        return value->real != 0.0;
+    case VALUE_STRING:
+    case VALUE_ARRAY:
+    case VALUE_OBJECT:
+        return value->ref.count != 0;
+    default:
+        return 0;
+    }
 }
 
-EXPORT(int, _ZNK3sce4Json5Value9getStringEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZNK3sce4Json5ValueixEPKc, Ptr<JsonValue> self, const char *name) {
+    if (!name) {
+        return Ptr<JsonValue>(null_block(host).value);
+    }
+    const Address member = object_member(host.mem, self.get(host.mem), name, uint32_t(strlen(name)));
+    return Ptr<JsonValue>(member ? member : null_block(host).value);
 }
 
-EXPORT(int, _ZNK3sce4Json5ValuecvbEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZNK3sce4Json5ValueixERKNS0_6StringE, Ptr<JsonValue> self, Ptr<JsonString> name) {
+    const std::string key = string_chars(host.mem, name.get(host.mem));
+    const Address member = object_member(host.mem, self.get(host.mem), key.c_str(), uint32_t(key.size()));
+    return Ptr<JsonValue>(member ? member : null_block(host).value);
 }
 
-EXPORT(int, _ZNK3sce4Json5ValueixEPKc) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce4Json5ValueixERKNS0_6StringE) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce4Json5ValueixEj) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonValue>, _ZNK3sce4Json5ValueixEj, Ptr<JsonValue> self, uint32_t index) {
+    const Address child = child_at(self.get(host.mem), index);
+    return Ptr<JsonValue>(child ? child : null_block(host).value);
 }
 
-EXPORT(int, _ZNK3sce4Json6Object3endEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZNK3sce4Json6Object3endEv, Ptr<JsonIterator> result, Ptr<JsonObject> self) {
+    const JsonObject *object = self.get(host.mem);
+    result.get(host.mem)->current = self.address() + sizeof(JsonObject) + (object->count * sizeof(JsonPair));
+    return result;
 }
 
-EXPORT(int, _ZNK3sce4Json6Object4findERKNS0_6StringE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZNK3sce4Json6Object4findERKNS0_6StringE, Ptr<JsonIterator> result, Ptr<JsonObject> self, Ptr<JsonString> name) {
+    const std::string key = string_chars(host.mem, name.get(host.mem));
+    const JsonObject *object = self.get(host.mem);
+    Address current = self.address() + sizeof(JsonObject) + (object->count * sizeof(JsonPair)); // end()
+    for (uint32_t i = 0; i < object->count; ++i) {
+        const Address pair = self.address() + sizeof(JsonObject) + (i * sizeof(JsonPair));
+        const JsonString *candidate = Ptr<JsonString>(pair).get(host.mem);
+        if (candidate->length != key.size()) {
+            continue;
+        }
+        const char *chars = candidate->data ? Ptr<const char>(candidate->data).get(host.mem) : "";
+        if (memcmp(chars, key.c_str(), key.size()) == 0) {
+            current = pair;
+            break;
+        }
+    }
+    result.get(host.mem)->current = current;
+    return result;
 }
 
-EXPORT(int, _ZNK3sce4Json6Object4sizeEv) {
-    return UNIMPLEMENTED();
+EXPORT(uint32_t, _ZNK3sce4Json6Object4sizeEv, Ptr<JsonObject> self) {
+    return self.get(host.mem)->count;
 }
 
-EXPORT(int, _ZNK3sce4Json6Object5beginEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonIterator>, _ZNK3sce4Json6Object5beginEv, Ptr<JsonIterator> result, Ptr<JsonObject> self) {
+    result.get(host.mem)->current = self.address() + sizeof(JsonObject);
+    return result;
 }
 
-EXPORT(int, _ZNK3sce4Json6Object5emptyEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce4Json6Object5emptyEv, Ptr<JsonObject> self) {
+    return self.get(host.mem)->count == 0;
 }
 
-EXPORT(int, _ZNK3sce4Json6Object8iteratordeEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonPair>, _ZNK3sce4Json6Object8iteratordeEv, Ptr<JsonIterator> self) {
+    return Ptr<JsonPair>(self.get(host.mem)->current);
 }
 
-EXPORT(int, _ZNK3sce4Json6Object8iteratoreqES2_) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce4Json6Object8iteratoreqES2_, Ptr<JsonIterator> self, Ptr<JsonIterator> other) {
+    return self.get(host.mem)->current == other.get(host.mem)->current;
 }
 
-EXPORT(int, _ZNK3sce4Json6Object8iteratorneES2_) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce4Json6Object8iteratorneES2_, Ptr<JsonIterator> self, Ptr<JsonIterator> other) {
+    return self.get(host.mem)->current != other.get(host.mem)->current;
 }
 
-EXPORT(int, _ZNK3sce4Json6Object8iteratorptEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonPair>, _ZNK3sce4Json6Object8iteratorptEv, Ptr<JsonIterator> self) {
+    return Ptr<JsonPair>(self.get(host.mem)->current);
 }
 
-EXPORT(int, _ZNK3sce4Json6String2atEj) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce4Json6String2atEj, Ptr<JsonString> self, uint32_t index) {
+    const JsonString *string = self.get(host.mem);
+    if (!string->data || (index >= string->length)) {
+        return 0;
+    }
+    return Ptr<const char>(string->data).get(host.mem)[index];
 }
 
-EXPORT(int, _ZNK3sce4Json6String4findEPKcj) {
-    return UNIMPLEMENTED();
+EXPORT(uint32_t, _ZNK3sce4Json6String4findEPKcj, Ptr<JsonString> self, const char *needle, uint32_t pos) {
+    const std::string haystack = string_chars(host.mem, self.get(host.mem));
+    const size_t found = haystack.find(needle ? needle : "", pos);
+    return (found == std::string::npos) ? NPOS : uint32_t(found);
 }
 
-EXPORT(int, _ZNK3sce4Json6String4findEPKcjj) {
-    return UNIMPLEMENTED();
+EXPORT(uint32_t, _ZNK3sce4Json6String4findEPKcjj, Ptr<JsonString> self, const char *needle, uint32_t pos, uint32_t count) {
+    if (!needle) {
+        return NPOS;
+    }
+    const std::string haystack = string_chars(host.mem, self.get(host.mem));
+    const size_t found = haystack.find(needle, pos, count);
+    return (found == std::string::npos) ? NPOS : uint32_t(found);
 }
 
-EXPORT(int, _ZNK3sce4Json6String4findERKS1_j) {
-    return UNIMPLEMENTED();
+EXPORT(uint32_t, _ZNK3sce4Json6String4findERKS1_j, Ptr<JsonString> self, Ptr<JsonString> needle, uint32_t pos) {
+    const std::string haystack = string_chars(host.mem, self.get(host.mem));
+    const size_t found = haystack.find(string_chars(host.mem, needle.get(host.mem)), pos);
+    return (found == std::string::npos) ? NPOS : uint32_t(found);
 }
 
-EXPORT(int, _ZNK3sce4Json6String4findEcj) {
-    return UNIMPLEMENTED();
+EXPORT(uint32_t, _ZNK3sce4Json6String4findEcj, Ptr<JsonString> self, uint32_t ch, uint32_t pos) {
+    const std::string haystack = string_chars(host.mem, self.get(host.mem));
+    const size_t found = haystack.find(char(ch), pos);
+    return (found == std::string::npos) ? NPOS : uint32_t(found);
 }
 
-EXPORT(int, _ZNK3sce4Json6String4sizeEv) {
-    return UNIMPLEMENTED();
+EXPORT(uint32_t, _ZNK3sce4Json6String4sizeEv, Ptr<JsonString> self) {
+    return self.get(host.mem)->length;
 }
 
-EXPORT(int, _ZNK3sce4Json6String5c_strEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<const char>, _ZNK3sce4Json6String5c_strEv, Ptr<JsonString> self) {
+    const JsonString *string = self.get(host.mem);
+    if (string->data) {
+        return Ptr<const char>(string->data);
+    }
+    return Ptr<const char>(null_block(host).chars);
 }
 
-EXPORT(int, _ZNK3sce4Json6String5emptyEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce4Json6String5emptyEv, Ptr<JsonString> self) {
+    return self.get(host.mem)->length == 0;
 }
 
-EXPORT(int, _ZNK3sce4Json6String5rfindEPKcj) {
-    return UNIMPLEMENTED();
+EXPORT(uint32_t, _ZNK3sce4Json6String5rfindEPKcj, Ptr<JsonString> self, const char *needle, uint32_t pos) {
+    const std::string haystack = string_chars(host.mem, self.get(host.mem));
+    const size_t found = haystack.rfind(needle ? needle : "", pos);
+    return (found == std::string::npos) ? NPOS : uint32_t(found);
 }
 
-EXPORT(int, _ZNK3sce4Json6String5rfindEPKcjj) {
-    return UNIMPLEMENTED();
+EXPORT(uint32_t, _ZNK3sce4Json6String5rfindEPKcjj, Ptr<JsonString> self, const char *needle, uint32_t pos, uint32_t count) {
+    if (!needle) {
+        return NPOS;
+    }
+    const std::string haystack = string_chars(host.mem, self.get(host.mem));
+    const size_t found = haystack.rfind(needle, pos, count);
+    return (found == std::string::npos) ? NPOS : uint32_t(found);
 }
 
-EXPORT(int, _ZNK3sce4Json6String5rfindERKS1_j) {
-    return UNIMPLEMENTED();
+EXPORT(uint32_t, _ZNK3sce4Json6String5rfindERKS1_j, Ptr<JsonString> self, Ptr<JsonString> needle, uint32_t pos) {
+    const std::string haystack = string_chars(host.mem, self.get(host.mem));
+    const size_t found = haystack.rfind(string_chars(host.mem, needle.get(host.mem)), pos);
+    return (found == std::string::npos) ? NPOS : uint32_t(found);
 }
 
-EXPORT(int, _ZNK3sce4Json6String5rfindEcj) {
-    return UNIMPLEMENTED();
+EXPORT(uint32_t, _ZNK3sce4Json6String5rfindEcj, Ptr<JsonString> self, uint32_t ch, uint32_t pos) {
+    const std::string haystack = string_chars(host.mem, self.get(host.mem));
+    const size_t found = haystack.rfind(char(ch), pos);
+    return (found == std::string::npos) ? NPOS : uint32_t(found);
 }
 
-EXPORT(int, _ZNK3sce4Json6String6lengthEv) {
-    return UNIMPLEMENTED();
+EXPORT(uint32_t, _ZNK3sce4Json6String6lengthEv, Ptr<JsonString> self) {
+    return self.get(host.mem)->length;
 }
 
-EXPORT(int, _ZNK3sce4Json6String6substrEjj) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<JsonString>, _ZNK3sce4Json6String6substrEjj, Ptr<JsonString> result, Ptr<JsonString> self, uint32_t pos, uint32_t count) {
+    JsonString *out = result.get(host.mem);
+    out->data = 0;
+    out->length = 0;
+    const std::string source = string_chars(host.mem, self.get(host.mem));
+    if (pos <= source.size()) {
+        const std::string sub = source.substr(pos, count);
+        assign_string(host, out, sub.c_str(), uint32_t(sub.size()));
+    }
+    return result;
 }
 
-EXPORT(int, _ZNK3sce4Json6String7compareEPKc) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce4Json6String7compareEPKc, Ptr<JsonString> self, const char *other) {
+    const std::string chars = string_chars(host.mem, self.get(host.mem));
+    return chars.compare(other ? other : "");
 }
 
-EXPORT(int, _ZNK3sce4Json6String7compareERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce4Json6String7compareERKS1_, Ptr<JsonString> self, Ptr<JsonString> other) {
+    const std::string chars = string_chars(host.mem, self.get(host.mem));
+    return chars.compare(string_chars(host.mem, other.get(host.mem)));
 }
 
-EXPORT(int, _ZNK3sce4Json6StringeqEPKc) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce4Json6StringeqEPKc, Ptr<JsonString> self, const char *other) {
+    const std::string chars = string_chars(host.mem, self.get(host.mem));
+    return chars == (other ? other : "");
 }
 
-EXPORT(int, _ZNK3sce4Json6StringeqERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce4Json6StringeqERKS1_, Ptr<JsonString> self, Ptr<JsonString> other) {
+    const std::string chars = string_chars(host.mem, self.get(host.mem));
+    return chars == string_chars(host.mem, other.get(host.mem));
 }
 
 BRIDGE_IMPL(_ZN3sce4Json11Initializer10initializeEPKNS0_13InitParameterE)
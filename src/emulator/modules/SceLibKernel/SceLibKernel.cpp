@@ -41,6 +41,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 EXPORT(int, SceKernelStackChkGuard) {
     return UNIMPLEMENTED();
@@ -68,7 +69,7 @@ EXPORT(int, _sceKernelCreateLwMutex, Ptr<emu::SceKernelLwMutexWork> workarea, co
     assert(opt_param == nullptr);
 
     auto uid_out = &workarea.get(host.mem)->uid;
-    return mutex_create(uid_out, host.kernel, export_name, thread_id, name, attr, init_count, SyncWeight::Light);
+    return mutex_create(uid_out, host.kernel, export_name, thread_id, name, attr, init_count, workarea.get(host.mem), SyncWeight::Light);
 }
 
 EXPORT(int, sceClibAbort) {
@@ -83,20 +84,27 @@ EXPORT(int, sceClibLookCtypeTable) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceClibMemchr) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, sceClibMemchr, Ptr<const void> s, int c, SceSize n) {
+    const uint8_t *const base = static_cast<const uint8_t *>(s.get(host.mem));
+    const void *const found = memchr(base, c, n);
+    if (!found) {
+        return Ptr<void>();
+    }
+
+    return Ptr<void>(s.address() + static_cast<Address>(static_cast<const uint8_t *>(found) - base));
 }
 
-EXPORT(int, sceClibMemcmp) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceClibMemcmp, const void *s1, const void *s2, SceSize n) {
+    return memcmp(s1, s2, n);
 }
 
 EXPORT(int, sceClibMemcmpConstTime) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceClibMemcpy) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, sceClibMemcpy, Ptr<void> destination, const void *source, SceSize num) {
+    memcpy(destination.get(host.mem), source, num);
+    return destination;
 }
 
 EXPORT(int, sceClibMemcpyChk) {
@@ -108,8 +116,9 @@ EXPORT(int, sceClibMemcpy_safe, void *destination, const void *source, SceSize n
     return 0;
 }
 
-EXPORT(int, sceClibMemmove) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, sceClibMemmove, Ptr<void> destination, const void *source, SceSize num) {
+    memmove(destination.get(host.mem), source, num);
+    return destination;
 }
 
 EXPORT(int, sceClibMemmoveChk) {
@@ -196,8 +205,8 @@ EXPORT(int, sceClibStrchr) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceClibStrcmp) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceClibStrcmp, const char *s1, const char *s2) {
+    return strcmp(s1, s2);
 }
 
 EXPORT(int, sceClibStrcpyChk) {
@@ -232,20 +241,26 @@ EXPORT(int, sceClibStrncatChk) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceClibStrncmp) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceClibStrncmp, const char *s1, const char *s2, SceSize n) {
+    return strncmp(s1, s2, n);
 }
 
-EXPORT(int, sceClibStrncpy) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<char>, sceClibStrncpy, Ptr<char> destination, const char *source, SceSize size) {
+    strncpy(destination.get(host.mem), source, size);
+    return destination;
 }
 
 EXPORT(int, sceClibStrncpyChk) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceClibStrnlen) {
-    return UNIMPLEMENTED();
+EXPORT(SceSize, sceClibStrnlen, const char *s, SceSize maxlen) {
+    const void *const terminator = memchr(s, 0, maxlen);
+    if (!terminator) {
+        return maxlen;
+    }
+
+    return static_cast<SceSize>(static_cast<const char *>(terminator) - s);
 }
 
 EXPORT(int, sceClibStrrchr) {
@@ -368,10 +383,7 @@ EXPORT(int, sceIoOpenAsync) {
 }
 
 EXPORT(int, sceIoPread, SceUID fd, void *data, SceSize size, SceOff offset) {
-    if (seek_file(fd, offset, SEEK_SET, host.io, export_name) < 0) {
-        return RET_ERROR(SCE_ERROR_ERRNO_EINVAL);
-    }
-    return read_file(data, host.io, fd, size, export_name);
+    return pread_file(data, host.io, fd, size, offset, export_name);
 }
 
 EXPORT(int, sceIoPreadAsync) {
@@ -802,7 +814,7 @@ EXPORT(int, sceKernelCreateLwMutex, Ptr<emu::SceKernelLwMutexWork> workarea, con
     assert(opt_param == nullptr);
 
     const auto uid_out = &workarea.get(host.mem)->uid;
-    return mutex_create(uid_out, host.kernel, export_name, thread_id, name, attr, init_count, SyncWeight::Light);
+    return mutex_create(uid_out, host.kernel, export_name, thread_id, name, attr, init_count, workarea.get(host.mem), SyncWeight::Light);
 }
 
 EXPORT(int, sceKernelCreateMsgPipe) {
@@ -816,7 +828,7 @@ EXPORT(int, sceKernelCreateMsgPipeWithLR) {
 EXPORT(int, sceKernelCreateMutex, const char *name, SceUInt attr, int init_count, SceKernelMutexOptParam *opt_param) {
     SceUID uid;
 
-    if (auto error = mutex_create(&uid, host.kernel, export_name, thread_id, name, attr, init_count, SyncWeight::Heavy)) {
+    if (auto error = mutex_create(&uid, host.kernel, export_name, thread_id, name, attr, init_count, nullptr, SyncWeight::Heavy)) {
         return error;
     }
     return uid;
@@ -842,8 +854,8 @@ EXPORT(SceUID, sceKernelCreateThread, const char *name, emu::SceKernelThreadEntr
     if (cpu_affinity_mask > 0x70000) {
         return RET_ERROR(SCE_KERNEL_ERROR_INVALID_CPU_AFFINITY);
     }
-    const CallImport call_import = [&host](CPUState &cpu, uint32_t nid, SceUID thread_id) {
-        ::call_import(host, cpu, nid, thread_id);
+    const CallImport call_import = [&host](CPUState &cpu, uint32_t imm, Address pc, SceUID thread_id) {
+        ::call_import(host, cpu, imm, pc, thread_id);
     };
 
     const SceUID thid = create_thread(entry.cast<const void>(), host.kernel, host.mem, name, init_priority, stack_size, call_import, false);
@@ -932,18 +944,21 @@ EXPORT(int, sceKernelGetPMUSERENR) {
     return UNIMPLEMENTED();
 }
 
+// The process-time family serves the cached coarse tick - titles poll these
+// tens of thousands of times per frame, and a 100 us quantum is finer than
+// anything a frame-time profiler can act on.
 EXPORT(int, sceKernelGetProcessTime, SceUInt64 *time) {
     if (time)
-        *time = rtc_get_ticks(host.kernel.base_tick.tick);
+        *time = rtc_get_ticks_coarse(host.kernel.coarse_time, host.kernel.base_tick.tick);
     return 0;
 }
 
 EXPORT(SceUInt32, sceKernelGetProcessTimeLow) {
-    return static_cast<SceUInt32>(rtc_get_ticks(host.kernel.base_tick.tick));
+    return static_cast<SceUInt32>(rtc_get_ticks_coarse(host.kernel.coarse_time, host.kernel.base_tick.tick));
 }
 
 EXPORT(SceUInt64, sceKernelGetProcessTimeWide) {
-    return rtc_get_ticks(host.kernel.base_tick.tick);
+    return rtc_get_ticks_coarse(host.kernel.coarse_time, host.kernel.base_tick.tick);
 }
 
 EXPORT(int, sceKernelGetRWLockInfo) {
@@ -1022,12 +1037,14 @@ EXPORT(int, sceKernelLoadModule, char *path, int flags, SceKernelLMOption *optio
     void *data = malloc(size);
     Ptr<const void> entry_point;
 
-    SceUID modId = load_self(entry_point, host.kernel, host.mem, data, path);
+    const std::string module_cache_path = host.pref_path + "modulecache";
+    SceUID modId = load_self(entry_point, host.kernel, host.mem, data, path, module_cache_path.c_str());
     close_file(host.io, file, export_name);
     free(data);
     if (modId < 0) {
         return RET_ERROR(modId);
     };
+    resolve_loaded_imports(host);
     return modId;
 }
 
@@ -1046,18 +1063,20 @@ EXPORT(int, sceKernelLoadStartModule, char *path, SceSize args, Ptr<void> argp,
     };
 
     Ptr<const void> entry_point;
-    SceUID modId = load_self(entry_point, host.kernel, host.mem, data, path);
+    const std::string module_cache_path = host.pref_path + "modulecache";
+    SceUID modId = load_self(entry_point, host.kernel, host.mem, data, path, module_cache_path.c_str());
     close_file(host.io, file, export_name);
     free(data);
     if (modId < 0) {
         return RET_ERROR(modId);
     };
+    resolve_loaded_imports(host);
 
     const SceKernelModuleInfoPtrs::const_iterator module = host.kernel.loaded_modules.find(modId);
     assert(module != host.kernel.loaded_modules.end());
 
-    const CallImport call_import = [&host](CPUState &cpu, uint32_t nid, SceUID thread_id) {
-        ::call_import(host, cpu, nid, thread_id);
+    const CallImport call_import = [&host](CPUState &cpu, uint32_t imm, Address pc, SceUID thread_id) {
+        ::call_import(host, cpu, imm, pc, thread_id);
     };
 
     const SceUID thid = create_thread(entry_point.cast<const void>(), host.kernel, host.mem, module->second.get()->module_name, SCE_KERNEL_DEFAULT_PRIORITY_USER, SCE_KERNEL_STACK_SIZE_USER_DEFAULT, call_import, false);
@@ -1075,14 +1094,15 @@ EXPORT(int, sceKernelLoadStartModule, char *path, SceSize args, Ptr<void> argp,
     thread->to_do = ThreadToDo::exit;
     thread->something_to_do.notify_all(); // TODO Should this be notify_one()?
     host.kernel.running_threads.erase(thid);
+    release_cpu(host.kernel.cpu_pool, std::move(thread->cpu));
     host.kernel.threads.erase(thid);
 
     return modId;
 }
 
 EXPORT(int, sceKernelLockLwMutex, Ptr<emu::SceKernelLwMutexWork> workarea, int lock_count, unsigned int *ptimeout) {
-    const auto lwmutexid = workarea.get(host.mem)->uid;
-    return mutex_lock(host.kernel, export_name, thread_id, lwmutexid, lock_count, ptimeout, SyncWeight::Light);
+    assert(!ptimeout);
+    return lw_mutex_lock(host.kernel, export_name, thread_id, workarea.get(host.mem), lock_count);
 }
 
 EXPORT(int, sceKernelLockLwMutexCB) {
@@ -1257,13 +1277,11 @@ EXPORT(int, sceKernelUnloadModule) {
 }
 
 EXPORT(int, sceKernelUnlockLwMutex, Ptr<emu::SceKernelLwMutexWork> workarea, int unlock_count) {
-    const auto lwmutexid = workarea.get(host.mem)->uid;
-    return mutex_unlock(host.kernel, export_name, thread_id, lwmutexid, unlock_count, SyncWeight::Light);
+    return lw_mutex_unlock(host.kernel, export_name, thread_id, workarea.get(host.mem), unlock_count);
 }
 
 EXPORT(int, sceKernelUnlockLwMutex2, Ptr<emu::SceKernelLwMutexWork> workarea, int unlock_count) {
-    const auto lwmutexid = workarea.get(host.mem)->uid;
-    return mutex_unlock(host.kernel, export_name, thread_id, lwmutexid, unlock_count, SyncWeight::Light);
+    return lw_mutex_unlock(host.kernel, export_name, thread_id, workarea.get(host.mem), unlock_count);
 }
 
 EXPORT(int, sceKernelWaitCond, SceUID cond_id, SceUInt32 *timeout) {
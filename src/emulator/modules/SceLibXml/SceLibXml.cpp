@@ -17,412 +17,1495 @@
 
 #include "SceLibXml.h"
 
-EXPORT(int, _ZN3sce3Xml10SimpleDataC1EPKcj) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml10SimpleDataC1Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml10SimpleDataC2EPKcj) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml10SimpleDataC2Ev) {
-    return UNIMPLEMENTED();
+#include <mem/mem.h>
+#include <mem/ptr.h>
+#include <util/log.h>
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// sce::Xml on a host-native parser. A DocumentBuilder parse streams the text
+// once on the host into a compact node table with interned element and
+// attribute names, so a multi-megabyte manifest costs one pass and one copy
+// of each distinct name. Node handles hand the table out to the title as
+// 64-bit ids - document address in the high half, node index in the low half
+// - and name/text characters are only copied into guest memory the first
+// time a handle is asked for them.
+
+namespace emu {
+namespace xml {
+    constexpr uint32_t NODE_ELEMENT = 1;
+    constexpr uint32_t NODE_TEXT = 3;
+    constexpr uint32_t NODE_DOCUMENT = 9;
+
+    // High bit of the index half marks an attribute handle.
+    constexpr uint32_t ATTR_FLAG = 0x80000000;
+
+    // Guest-visible layouts. Everything behind these classes is bridged, so
+    // only the sizes are contractual - titles allocate the objects with
+    // sizeof from the SDK headers.
+    struct String {
+        Address str; // NUL-terminated characters, not owned
+        uint32_t length;
+    };
+
+    struct Attr {
+        String name;
+        String value;
+    };
+
+    struct AttributeList {
+        Address items; // Attr array
+        uint32_t count;
+        uint32_t capacity;
+    };
+
+    struct NodeList {
+        Address items; // 64-bit node id array
+        uint32_t count;
+        uint32_t capacity;
+    };
+
+    struct Node {
+        uint64_t id;
+    };
+
+    struct Document {
+        Address handle; // unused - the host table is keyed by our address
+    };
+
+    struct SimpleData {
+        Address data;
+        uint32_t size;
+    };
+
+    struct VarAllocBuffer {
+        uint32_t vtable; // laid down by the guest constructor call chain
+        Address data;
+        uint32_t size;
+        uint32_t capacity;
+    };
+}
+}
+
+typedef emu::xml::String XmlString;
+typedef emu::xml::Attr XmlAttr;
+typedef emu::xml::AttributeList XmlAttributeList;
+typedef emu::xml::NodeList XmlNodeList;
+typedef emu::xml::Node XmlNode;
+typedef emu::xml::Document XmlDocument;
+typedef emu::xml::SimpleData XmlSimpleData;
+typedef emu::xml::VarAllocBuffer XmlVarAllocBuffer;
+
+using namespace emu::xml;
+
+// Host-side document: node table plus interned strings.
+struct HostXmlNode {
+    uint32_t type = 0;
+    uint32_t name = 0; // interned
+    uint32_t text = 0; // interned, text nodes only
+    uint32_t parent = 0;
+    uint32_t first_child = 0;
+    uint32_t last_child = 0;
+    uint32_t prev = 0;
+    uint32_t next = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> attrs; // interned name, value
+};
+
+struct HostXmlDoc {
+    std::vector<HostXmlNode> nodes{ HostXmlNode() }; // index 0 is the null node
+    std::vector<std::string> strings{ std::string() }; // id 0 is empty
+    std::map<std::string, uint32_t> interned;
+    std::vector<Address> guest_strings{ 0 }; // lazily filled, parallel to strings
+    std::map<std::pair<uint32_t, uint32_t>, uint32_t> attr_handle_ids;
+    std::vector<std::pair<uint32_t, uint32_t>> attr_handles; // node index, attr slot
+    uint32_t meta = 0; // interned XML declaration, if any
+    bool writable = false;
+    int status = 0;
+};
+
+typedef std::shared_ptr<HostXmlDoc> HostXmlDocPtr;
+
+struct XmlBuilderState {
+    HostXmlDocPtr doc;
+    Address doc_block = 0;
+    bool skip_whitespace = true;
+    bool skip_text = false;
+    bool resolve_entity = true;
+};
+
+static std::mutex xml_mutex;
+static std::map<Address, HostXmlDocPtr> xml_docs; // Document guest address -> host table
+static std::map<Address, XmlBuilderState> xml_builders;
+static int xml_debug_level = 0;
+
+static uint32_t intern(HostXmlDoc &doc, const std::string &text) {
+    if (text.empty()) {
+        return 0;
+    }
+    const auto existing = doc.interned.find(text);
+    if (existing != doc.interned.end()) {
+        return existing->second;
+    }
+    const uint32_t id = uint32_t(doc.strings.size());
+    doc.strings.push_back(text);
+    doc.guest_strings.push_back(0);
+    doc.interned.emplace(text, id);
+    return id;
+}
+
+static HostXmlDocPtr find_xml_doc(Address address) {
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    const auto doc = xml_docs.find(address);
+    return (doc == xml_docs.end()) ? HostXmlDocPtr() : doc->second;
+}
+
+static void register_xml_doc(Address address, const HostXmlDocPtr &doc) {
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    xml_docs[address] = doc;
+}
+
+static void unregister_xml_doc(Address address) {
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    xml_docs.erase(address);
+}
+
+static uint64_t make_node_id(Address doc_address, uint32_t index) {
+    return (uint64_t(doc_address) << 32) | index;
+}
+
+struct ResolvedNode {
+    HostXmlDocPtr doc;
+    Address doc_address = 0;
+    uint32_t index = 0;
+};
+
+static bool resolve_node(uint64_t id, ResolvedNode &out) {
+    out.doc_address = Address(id >> 32);
+    out.index = uint32_t(id);
+    if (!out.doc_address || !out.index || (out.index & ATTR_FLAG)) {
+        return false;
+    }
+    out.doc = find_xml_doc(out.doc_address);
+    return out.doc && (out.index < out.doc->nodes.size());
+}
+
+static bool resolve_attr(uint64_t id, ResolvedNode &out, uint32_t &slot) {
+    out.doc_address = Address(id >> 32);
+    const uint32_t handle = uint32_t(id);
+    if (!out.doc_address || !(handle & ATTR_FLAG)) {
+        return false;
+    }
+    out.doc = find_xml_doc(out.doc_address);
+    if (!out.doc || ((handle & ~ATTR_FLAG) >= out.doc->attr_handles.size())) {
+        return false;
+    }
+    const auto &ref = out.doc->attr_handles[handle & ~ATTR_FLAG];
+    out.index = ref.first;
+    slot = ref.second;
+    return (out.index < out.doc->nodes.size()) && (slot < out.doc->nodes[out.index].attrs.size());
+}
+
+static uint64_t attr_handle(HostXmlDoc &doc, Address doc_address, uint32_t node, uint32_t slot) {
+    const std::pair<uint32_t, uint32_t> key(node, slot);
+    const auto existing = doc.attr_handle_ids.find(key);
+    uint32_t id;
+    if (existing != doc.attr_handle_ids.end()) {
+        id = existing->second;
+    } else {
+        id = uint32_t(doc.attr_handles.size());
+        doc.attr_handles.push_back(key);
+        doc.attr_handle_ids.emplace(key, id);
+    }
+    return make_node_id(doc_address, ATTR_FLAG | id);
+}
+
+// Copy an interned string into guest memory, at most once per document.
+static Address guest_chars(HostState &host, HostXmlDoc &doc, uint32_t id) {
+    if (id >= doc.guest_strings.size()) {
+        id = 0;
+    }
+    if (!doc.guest_strings[id]) {
+        const std::string &text = doc.strings[id];
+        const Address block = alloc(host.mem, text.size() + 1, "SceLibXml string");
+        if (!block) {
+            return 0;
+        }
+        memcpy(Ptr<char>(block).get(host.mem), text.c_str(), text.size() + 1);
+        doc.guest_strings[id] = block;
+    }
+    return doc.guest_strings[id];
+}
+
+static void set_string(HostState &host, HostXmlDoc &doc, XmlString *out, uint32_t id) {
+    if (!out) {
+        return;
+    }
+    if (id >= doc.strings.size()) {
+        id = 0;
+    }
+    out->str = guest_chars(host, doc, id);
+    out->length = uint32_t(doc.strings[id].size());
+}
+
+static std::string string_view_chars(const MemState &mem, const XmlString *string) {
+    if (!string || !string->str || (string->length == 0)) {
+        return std::string();
+    }
+    return std::string(Ptr<const char>(string->str).get(mem), string->length);
+}
+
+// ---------------------------------------------------------------------------
+// Parser.
+
+static void decode_entities(const char *p, const char *end, std::string &out) {
+    while (p < end) {
+        if (*p != '&') {
+            out += *p++;
+            continue;
+        }
+        const char *semi = static_cast<const char *>(memchr(p, ';', end - p));
+        if (!semi || ((semi - p) > 10)) {
+            out += *p++;
+            continue;
+        }
+        const std::string entity(p + 1, semi);
+        if (entity == "amp") {
+            out += '&';
+        } else if (entity == "lt") {
+            out += '<';
+        } else if (entity == "gt") {
+            out += '>';
+        } else if (entity == "quot") {
+            out += '"';
+        } else if (entity == "apos") {
+            out += '\'';
+        } else if ((entity.size() > 1) && (entity[0] == '#')) {
+            const long code = (entity[1] == 'x') ? strtol(entity.c_str() + 2, nullptr, 16) : strtol(entity.c_str() + 1, nullptr, 10);
+            if ((code > 0) && (code < 0x80)) {
+                out += char(code);
+            } else if (code >= 0x80) {
+                // Minimal UTF-8 for the BMP.
+                if (code < 0x800) {
+                    out += char(0xc0 | (code >> 6));
+                } else {
+                    out += char(0xe0 | (code >> 12));
+                    out += char(0x80 | ((code >> 6) & 0x3f));
+                }
+                out += char(0x80 | (code & 0x3f));
+            }
+        } else {
+            out.append(p, semi + 1);
+        }
+        p = semi + 1;
+    }
+}
+
+static bool is_xml_space(char ch) {
+    return (ch == ' ') || (ch == '\t') || (ch == '\n') || (ch == '\r');
+}
+
+static bool is_name_char(char ch) {
+    return !is_xml_space(ch) && (ch != '>') && (ch != '/') && (ch != '=') && (ch != '<');
+}
+
+static uint32_t add_node(HostXmlDoc &doc, uint32_t parent, uint32_t type) {
+    const uint32_t index = uint32_t(doc.nodes.size());
+    doc.nodes.push_back(HostXmlNode());
+    HostXmlNode &node = doc.nodes.back();
+    node.type = type;
+    node.parent = parent;
+    if (parent) {
+        HostXmlNode &up = doc.nodes[parent];
+        node.prev = up.last_child;
+        if (up.last_child) {
+            doc.nodes[up.last_child].next = index;
+        } else {
+            up.first_child = index;
+        }
+        up.last_child = index;
+    }
+    return index;
+}
+
+static void unlink_node(HostXmlDoc &doc, uint32_t index) {
+    HostXmlNode &node = doc.nodes[index];
+    if (node.parent) {
+        HostXmlNode &up = doc.nodes[node.parent];
+        if (up.first_child == index) {
+            up.first_child = node.next;
+        }
+        if (up.last_child == index) {
+            up.last_child = node.prev;
+        }
+    }
+    if (node.prev) {
+        doc.nodes[node.prev].next = node.next;
+    }
+    if (node.next) {
+        doc.nodes[node.next].prev = node.prev;
+    }
+    node.parent = 0;
+    node.prev = 0;
+    node.next = 0;
+}
+
+// One streaming pass: elements, attributes, text, CDATA; comments, the XML
+// declaration, processing instructions and the doctype are skipped.
+static bool parse_xml(HostXmlDoc &doc, const char *p, const char *end, const XmlBuilderState &options) {
+    const uint32_t root = add_node(doc, 0, NODE_DOCUMENT);
+    std::vector<uint32_t> stack{ root };
+
+    while (p < end) {
+        if (*p != '<') {
+            const char *text_end = static_cast<const char *>(memchr(p, '<', end - p));
+            if (!text_end) {
+                text_end = end;
+            }
+            bool blank = true;
+            for (const char *scan = p; scan < text_end; ++scan) {
+                if (!is_xml_space(*scan)) {
+                    blank = false;
+                    break;
+                }
+            }
+            if (!options.skip_text && !(blank && options.skip_whitespace)) {
+                std::string text;
+                if (options.resolve_entity) {
+                    decode_entities(p, text_end, text);
+                } else {
+                    text.assign(p, text_end);
+                }
+                const uint32_t node = add_node(doc, stack.back(), NODE_TEXT);
+                doc.nodes[node].text = intern(doc, text);
+            }
+            p = text_end;
+            continue;
+        }
+
+        if (((end - p) >= 4) && (memcmp(p, "<!--", 4) == 0)) {
+            const char *scan = p + 4;
+            while (((end - scan) >= 3) && (memcmp(scan, "-->", 3) != 0)) {
+                ++scan;
+            }
+            p = ((end - scan) >= 3) ? (scan + 3) : end;
+            continue;
+        }
+        if (((end - p) >= 9) && (memcmp(p, "<![CDATA[", 9) == 0)) {
+            const char *scan = p + 9;
+            while (((end - scan) >= 3) && (memcmp(scan, "]]>", 3) != 0)) {
+                ++scan;
+            }
+            const uint32_t node = add_node(doc, stack.back(), NODE_TEXT);
+            doc.nodes[node].text = intern(doc, std::string(p + 9, scan));
+            p = ((end - scan) >= 3) ? (scan + 3) : end;
+            continue;
+        }
+        if (((end - p) >= 2) && (p[1] == '?')) {
+            const char *scan = p + 2;
+            while (((end - scan) >= 2) && (memcmp(scan, "?>", 2) != 0)) {
+                ++scan;
+            }
+            if (((end - p) >= 6) && (memcmp(p, "<?xml", 5) == 0)) {
+                doc.meta = intern(doc, std::string(p, ((end - scan) >= 2) ? (scan + 2) : end));
+            }
+            p = ((end - scan) >= 2) ? (scan + 2) : end;
+            continue;
+        }
+        if (((end - p) >= 2) && (p[1] == '!')) {
+            // Doctype - skip it, minding an internal subset.
+            int brackets = 0;
+            const char *scan = p + 2;
+            while (scan < end) {
+                if (*scan == '[') {
+                    ++brackets;
+                } else if (*scan == ']') {
+                    --brackets;
+                } else if ((*scan == '>') && (brackets <= 0)) {
+                    break;
+                }
+                ++scan;
+            }
+            p = (scan < end) ? (scan + 1) : end;
+            continue;
+        }
+        if (((end - p) >= 2) && (p[1] == '/')) {
+            const char *scan = p + 2;
+            while ((scan < end) && (*scan != '>')) {
+                ++scan;
+            }
+            if ((scan == end) || (stack.size() <= 1)) {
+                return false;
+            }
+            stack.pop_back();
+            p = scan + 1;
+            continue;
+        }
+
+        // Start tag.
+        const char *scan = p + 1;
+        const char *name_start = scan;
+        while ((scan < end) && is_name_char(*scan)) {
+            ++scan;
+        }
+        if (scan == name_start) {
+            return false;
+        }
+        const uint32_t node = add_node(doc, stack.back(), NODE_ELEMENT);
+        doc.nodes[node].name = intern(doc, std::string(name_start, scan));
+
+        bool self_closing = false;
+        while (scan < end) {
+            while ((scan < end) && is_xml_space(*scan)) {
+                ++scan;
+            }
+            if (scan == end) {
+                return false;
+            }
+            if (*scan == '>') {
+                ++scan;
+                break;
+            }
+            if (*scan == '/') {
+                self_closing = true;
+                ++scan;
+                continue;
+            }
+            const char *attr_start = scan;
+            while ((scan < end) && is_name_char(*scan)) {
+                ++scan;
+            }
+            const std::string attr_name(attr_start, scan);
+            while ((scan < end) && is_xml_space(*scan)) {
+                ++scan;
+            }
+            std::string attr_value;
+            if ((scan < end) && (*scan == '=')) {
+                ++scan;
+                while ((scan < end) && is_xml_space(*scan)) {
+                    ++scan;
+                }
+                if ((scan < end) && ((*scan == '"') || (*scan == '\''))) {
+                    const char quote = *scan++;
+                    const char *value_start = scan;
+                    while ((scan < end) && (*scan != quote)) {
+                        ++scan;
+                    }
+                    if (scan == end) {
+                        return false;
+                    }
+                    if (options.resolve_entity) {
+                        decode_entities(value_start, scan, attr_value);
+                    } else {
+                        attr_value.assign(value_start, scan);
+                    }
+                    ++scan;
+                } else {
+                    return false;
+                }
+            }
+            if (attr_name.empty()) {
+                return false;
+            }
+            doc.nodes[node].attrs.emplace_back(intern(doc, attr_name), intern(doc, attr_value));
+        }
+        if (!self_closing) {
+            stack.push_back(node);
+        }
+        p = scan;
+    }
+    return stack.size() == 1;
+}
+
+// ---------------------------------------------------------------------------
+// Serializer.
+
+static void append_xml_escaped(std::string &out, const std::string &text, bool in_attribute) {
+    for (const char ch : text) {
+        switch (ch) {
+        case '&': out += "&amp;"; break;
+        case '<': out += "&lt;"; break;
+        case '>': out += "&gt;"; break;
+        case '"':
+            out += in_attribute ? "&quot;" : "\"";
+            break;
+        default:
+            out += ch;
+            break;
+        }
+    }
+}
+
+static void serialize_node(const HostXmlDoc &doc, uint32_t index, std::string &out) {
+    const HostXmlNode &node = doc.nodes[index];
+    switch (node.type) {
+    case NODE_DOCUMENT:
+        for (uint32_t child = node.first_child; child; child = doc.nodes[child].next) {
+            serialize_node(doc, child, out);
+        }
+        break;
+    case NODE_TEXT:
+        append_xml_escaped(out, doc.strings[node.text], false);
+        break;
+    case NODE_ELEMENT: {
+        out += '<';
+        out += doc.strings[node.name];
+        for (const auto &attr : node.attrs) {
+            out += ' ';
+            out += doc.strings[attr.first];
+            out += "=\"";
+            append_xml_escaped(out, doc.strings[attr.second], true);
+            out += '"';
+        }
+        if (!node.first_child) {
+            out += "/>";
+            break;
+        }
+        out += '>';
+        for (uint32_t child = node.first_child; child; child = doc.nodes[child].next) {
+            serialize_node(doc, child, out);
+        }
+        out += "</";
+        out += doc.strings[node.name];
+        out += '>';
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Guest list helpers.
+
+template <typename T>
+static bool list_reserve(HostState &host, Address &items, uint32_t count, uint32_t &capacity, uint32_t wanted) {
+    if (wanted <= capacity) {
+        return true;
+    }
+    uint32_t next = capacity ? (capacity * 2) : 8;
+    if (next < wanted) {
+        next = wanted;
+    }
+    const Address grown = alloc(host.mem, next * sizeof(T), "SceLibXml list");
+    if (!grown) {
+        return false;
+    }
+    if (items) {
+        memcpy(Ptr<T>(grown).get(host.mem), Ptr<T>(items).get(host.mem), count * sizeof(T));
+        free(host.mem, items);
+    }
+    items = grown;
+    capacity = next;
+    return true;
+}
+
+static void node_list_append(HostState &host, XmlNodeList *list, uint64_t id) {
+    if (!list_reserve<uint64_t>(host, list->items, list->count, list->capacity, list->count + 1)) {
+        return;
+    }
+    Ptr<uint64_t>(list->items).get(host.mem)[list->count++] = id;
+}
+
+static void node_list_fill_children(HostState &host, const ResolvedNode &at, XmlNodeList *list) {
+    list->count = 0;
+    const HostXmlNode &node = at.doc->nodes[at.index];
+    for (uint32_t child = node.first_child; child; child = at.doc->nodes[child].next) {
+        node_list_append(host, list, make_node_id(at.doc_address, child));
+    }
+}
+
+static void node_list_fill_attrs(HostState &host, const ResolvedNode &at, XmlNodeList *list) {
+    list->count = 0;
+    const HostXmlNode &node = at.doc->nodes[at.index];
+    for (uint32_t slot = 0; slot < node.attrs.size(); ++slot) {
+        node_list_append(host, list, attr_handle(*at.doc, at.doc_address, at.index, slot));
+    }
+}
+
+static int set_node_attribute(HostState &host, uint64_t id, const XmlString *name, const XmlString *value) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || !at.doc->writable) {
+        return -1;
+    }
+    const uint32_t name_id = intern(*at.doc, string_view_chars(host.mem, name));
+    const uint32_t value_id = intern(*at.doc, string_view_chars(host.mem, value));
+    for (auto &attr : at.doc->nodes[at.index].attrs) {
+        if (attr.first == name_id) {
+            attr.second = value_id;
+            return 0;
+        }
+    }
+    at.doc->nodes[at.index].attrs.emplace_back(name_id, value_id);
+    return 0;
+}
+
+static uint64_t create_element_node(HostState &host, Ptr<XmlDocument> self, uint32_t parent, const XmlString *name, Ptr<XmlAttributeList> attributes, const XmlString *text) {
+    const HostXmlDocPtr doc = find_xml_doc(self.address());
+    if (!doc || !doc->writable) {
+        return 0;
+    }
+    const uint32_t node = add_node(*doc, parent, NODE_ELEMENT);
+    doc->nodes[node].name = intern(*doc, string_view_chars(host.mem, name));
+    if (attributes) {
+        const XmlAttributeList *list = attributes.get(host.mem);
+        const XmlAttr *items = list->items ? Ptr<XmlAttr>(list->items).get(host.mem) : nullptr;
+        for (uint32_t i = 0; items && (i < list->count); ++i) {
+            doc->nodes[node].attrs.emplace_back(
+                intern(*doc, string_view_chars(host.mem, &items[i].name)),
+                intern(*doc, string_view_chars(host.mem, &items[i].value)));
+        }
+    }
+    if (text && text->str) {
+        const uint32_t child = add_node(*doc, node, NODE_TEXT);
+        doc->nodes[child].text = intern(*doc, string_view_chars(host.mem, text));
+    }
+    return make_node_id(self.address(), node);
+}
+
+EXPORT(Ptr<XmlSimpleData>, _ZN3sce3Xml10SimpleDataC1EPKcj, Ptr<XmlSimpleData> self, Ptr<const char> data, uint32_t size) {
+    XmlSimpleData *simple = self.get(host.mem);
+    simple->data = data.address();
+    simple->size = size;
+    return self;
+}
+
+EXPORT(Ptr<XmlSimpleData>, _ZN3sce3Xml10SimpleDataC1Ev, Ptr<XmlSimpleData> self) {
+    memset(self.get(host.mem), 0, sizeof(XmlSimpleData));
+    return self;
+}
+
+EXPORT(Ptr<XmlSimpleData>, _ZN3sce3Xml10SimpleDataC2EPKcj, Ptr<XmlSimpleData> self, Ptr<const char> data, uint32_t size) {
+    XmlSimpleData *simple = self.get(host.mem);
+    simple->data = data.address();
+    simple->size = size;
+    return self;
+}
+
+EXPORT(Ptr<XmlSimpleData>, _ZN3sce3Xml10SimpleDataC2Ev, Ptr<XmlSimpleData> self) {
+    memset(self.get(host.mem), 0, sizeof(XmlSimpleData));
+    return self;
 }
 
 EXPORT(int, _ZN3sce3Xml11Initializer10initializeEPKNS0_13InitParameterE) {
-    return UNIMPLEMENTED();
+    // Parsing runs host-side; the allocator in the parameter is never used.
+    return 0;
 }
 
 EXPORT(int, _ZN3sce3Xml11Initializer9terminateEv) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml11InitializerC1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml11InitializerC1Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml11InitializerC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml11InitializerC2Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml11InitializerD1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml11InitializerD1Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml11InitializerD2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml11InitializerD2Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml12MemAllocatorC1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml12MemAllocatorC1Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml12MemAllocatorC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml12MemAllocatorC2Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml12MemAllocatorD0Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml12MemAllocatorD0Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml12MemAllocatorD1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml12MemAllocatorD1Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml12MemAllocatorD2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml12MemAllocatorD2Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml13AttributeList10initializeEPKNS0_11InitializerE) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml13AttributeList10initializeEPKNS0_11InitializerE, Ptr<XmlAttributeList> self, Ptr<void> initializer) {
+    memset(self.get(host.mem), 0, sizeof(XmlAttributeList));
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml13AttributeList12addAttributeEPKNS0_6StringES4_) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml13AttributeList12addAttributeEPKNS0_6StringES4_, Ptr<XmlAttributeList> self, Ptr<XmlString> name, Ptr<XmlString> value) {
+    if (!name || !value) {
+        return -1;
+    }
+    XmlAttributeList *list = self.get(host.mem);
+    if (!list_reserve<XmlAttr>(host, list->items, list->count, list->capacity, list->count + 1)) {
+        return -1;
+    }
+    XmlAttr *slot = Ptr<XmlAttr>(list->items).get(host.mem) + list->count++;
+    slot->name = *name.get(host.mem);
+    slot->value = *value.get(host.mem);
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml13AttributeList5clearEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml13AttributeList5clearEv, Ptr<XmlAttributeList> self) {
+    self.get(host.mem)->count = 0;
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml13AttributeList9terminateEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml13AttributeList9terminateEv, Ptr<XmlAttributeList> self) {
+    XmlAttributeList *list = self.get(host.mem);
+    if (list->items) {
+        free(host.mem, list->items);
+    }
+    memset(list, 0, sizeof(XmlAttributeList));
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml13AttributeListC1ERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttributeList>, _ZN3sce3Xml13AttributeListC1ERKS1_, Ptr<XmlAttributeList> self, Ptr<XmlAttributeList> other) {
+    XmlAttributeList *list = self.get(host.mem);
+    memset(list, 0, sizeof(XmlAttributeList));
+    const XmlAttributeList *source = other.get(host.mem);
+    if (source->count && list_reserve<XmlAttr>(host, list->items, 0, list->capacity, source->count)) {
+        memcpy(Ptr<XmlAttr>(list->items).get(host.mem), Ptr<XmlAttr>(source->items).get(host.mem), source->count * sizeof(XmlAttr));
+        list->count = source->count;
+    }
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml13AttributeListC1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttributeList>, _ZN3sce3Xml13AttributeListC1Ev, Ptr<XmlAttributeList> self) {
+    memset(self.get(host.mem), 0, sizeof(XmlAttributeList));
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml13AttributeListC2ERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttributeList>, _ZN3sce3Xml13AttributeListC2ERKS1_, Ptr<XmlAttributeList> self, Ptr<XmlAttributeList> other) {
+    XmlAttributeList *list = self.get(host.mem);
+    memset(list, 0, sizeof(XmlAttributeList));
+    const XmlAttributeList *source = other.get(host.mem);
+    if (source->count && list_reserve<XmlAttr>(host, list->items, 0, list->capacity, source->count)) {
+        memcpy(Ptr<XmlAttr>(list->items).get(host.mem), Ptr<XmlAttr>(source->items).get(host.mem), source->count * sizeof(XmlAttr));
+        list->count = source->count;
+    }
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml13AttributeListC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttributeList>, _ZN3sce3Xml13AttributeListC2Ev, Ptr<XmlAttributeList> self) {
+    memset(self.get(host.mem), 0, sizeof(XmlAttributeList));
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml13AttributeListD1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttributeList>, _ZN3sce3Xml13AttributeListD1Ev, Ptr<XmlAttributeList> self) {
+    XmlAttributeList *list = self.get(host.mem);
+    if (list->items) {
+        free(host.mem, list->items);
+    }
+    memset(list, 0, sizeof(XmlAttributeList));
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml13AttributeListD2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttributeList>, _ZN3sce3Xml13AttributeListD2Ev, Ptr<XmlAttributeList> self) {
+    XmlAttributeList *list = self.get(host.mem);
+    if (list->items) {
+        free(host.mem, list->items);
+    }
+    memset(list, 0, sizeof(XmlAttributeList));
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml14VarAllocBuffer4copyEPKhjb) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml14VarAllocBuffer4copyEPKhjb, Ptr<XmlVarAllocBuffer> self, const uint8_t *source, uint32_t size, int append) {
+    if (!source) {
+        return -1;
+    }
+    XmlVarAllocBuffer *buffer = self.get(host.mem);
+    const uint32_t offset = append ? buffer->size : 0;
+    if (!list_reserve<uint8_t>(host, buffer->data, buffer->size, buffer->capacity, offset + size)) {
+        return -1;
+    }
+    memcpy(Ptr<uint8_t>(buffer->data).get(host.mem) + offset, source, size);
+    buffer->size = offset + size;
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml14VarAllocBuffer5clearEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml14VarAllocBuffer5clearEv, Ptr<XmlVarAllocBuffer> self) {
+    self.get(host.mem)->size = 0;
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml14VarAllocBuffer7copyStrEPKcj) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml14VarAllocBuffer7copyStrEPKcj, Ptr<XmlVarAllocBuffer> self, const char *text, uint32_t size) {
+    if (!text) {
+        return -1;
+    }
+    XmlVarAllocBuffer *buffer = self.get(host.mem);
+    if (!list_reserve<uint8_t>(host, buffer->data, buffer->size, buffer->capacity, size + 1)) {
+        return -1;
+    }
+    char *dst = Ptr<char>(buffer->data).get(host.mem);
+    memcpy(dst, text, size);
+    dst[size] = '\0';
+    buffer->size = size;
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml14VarAllocBuffer7copyStrERKNS0_6StringE) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml14VarAllocBuffer7copyStrERKNS0_6StringE, Ptr<XmlVarAllocBuffer> self, Ptr<XmlString> text) {
+    const std::string chars = string_view_chars(host.mem, text.get(host.mem));
+    XmlVarAllocBuffer *buffer = self.get(host.mem);
+    if (!list_reserve<uint8_t>(host, buffer->data, buffer->size, buffer->capacity, uint32_t(chars.size()) + 1)) {
+        return -1;
+    }
+    memcpy(Ptr<char>(buffer->data).get(host.mem), chars.c_str(), chars.size() + 1);
+    buffer->size = uint32_t(chars.size());
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml14VarAllocBuffer7reserveEj) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml14VarAllocBuffer7reserveEj, Ptr<XmlVarAllocBuffer> self, uint32_t size) {
+    XmlVarAllocBuffer *buffer = self.get(host.mem);
+    return list_reserve<uint8_t>(host, buffer->data, buffer->size, buffer->capacity, size) ? 0 : -1;
 }
 
-EXPORT(int, _ZN3sce3Xml14VarAllocBuffer9terminateEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml14VarAllocBuffer9terminateEv, Ptr<XmlVarAllocBuffer> self) {
+    XmlVarAllocBuffer *buffer = self.get(host.mem);
+    if (buffer->data) {
+        free(host.mem, buffer->data);
+    }
+    buffer->data = 0;
+    buffer->size = 0;
+    buffer->capacity = 0;
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml14VarAllocBufferC1EPKNS0_11InitializerE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlVarAllocBuffer>, _ZN3sce3Xml14VarAllocBufferC1EPKNS0_11InitializerE, Ptr<XmlVarAllocBuffer> self, Ptr<void> initializer) {
+    memset(self.get(host.mem), 0, sizeof(XmlVarAllocBuffer));
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml14VarAllocBufferC2EPKNS0_11InitializerE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlVarAllocBuffer>, _ZN3sce3Xml14VarAllocBufferC2EPKNS0_11InitializerE, Ptr<XmlVarAllocBuffer> self, Ptr<void> initializer) {
+    memset(self.get(host.mem), 0, sizeof(XmlVarAllocBuffer));
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml14VarAllocBufferD0Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlVarAllocBuffer>, _ZN3sce3Xml14VarAllocBufferD0Ev, Ptr<XmlVarAllocBuffer> self) {
+    XmlVarAllocBuffer *buffer = self.get(host.mem);
+    if (buffer->data) {
+        free(host.mem, buffer->data);
+        buffer->data = 0;
+    }
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml14VarAllocBufferD1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlVarAllocBuffer>, _ZN3sce3Xml14VarAllocBufferD1Ev, Ptr<XmlVarAllocBuffer> self) {
+    XmlVarAllocBuffer *buffer = self.get(host.mem);
+    if (buffer->data) {
+        free(host.mem, buffer->data);
+        buffer->data = 0;
+    }
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml14VarAllocBufferD2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlVarAllocBuffer>, _ZN3sce3Xml14VarAllocBufferD2Ev, Ptr<XmlVarAllocBuffer> self) {
+    XmlVarAllocBuffer *buffer = self.get(host.mem);
+    if (buffer->data) {
+        free(host.mem, buffer->data);
+        buffer->data = 0;
+    }
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml18SerializeParameterC1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml18SerializeParameterC1Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml18SerializeParameterC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml18SerializeParameterC2Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml20bXResultToResultTypeEi) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml20bXResultToResultTypeEi, int result) {
+    return (result < 0) ? 1 : 0;
 }
 
 EXPORT(int, _ZN3sce3Xml23getMemManagerDebugLevelEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml23setMemManagerDebugLevelEi) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilder10initializeEPKNS0_11InitializerE) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilder11getDocumentEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilder16setResolveEntityEb) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilder20setSkipIgnorableTextEb) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilder26setSkipIgnorableWhiteSpaceEb) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilder5parseEPKNS0_6StringEb) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilder9terminateEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilderC1Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilderC2Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilderD1Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilderD2Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom4Node11appendChildEy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom4Node11removeChildEy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom4Node12insertBeforeEyy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom4NodeC1Ey) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom4NodeC2Ey) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom4NodeD1Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom4NodeD2Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document10importNodeEyyPKS2_y) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document10initializeEPKNS0_11InitializerE) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document10insertNodeEyyy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document11removeChildEyy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document11resetStatusEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document11setWritableEv) {
-    return UNIMPLEMENTED();
+    return xml_debug_level;
+}
+
+EXPORT(int, _ZN3sce3Xml23setMemManagerDebugLevelEi, int level) {
+    xml_debug_level = level;
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilder10initializeEPKNS0_11InitializerE, Ptr<void> self, Ptr<void> initializer) {
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    xml_builders[self.address()] = XmlBuilderState();
+    return 0;
+}
+
+EXPORT(Ptr<XmlDocument>, _ZN3sce3Xml3Dom15DocumentBuilder11getDocumentEv, Ptr<void> self) {
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    const auto builder = xml_builders.find(self.address());
+    if (builder == xml_builders.end()) {
+        return Ptr<XmlDocument>();
+    }
+    return Ptr<XmlDocument>(builder->second.doc_block);
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilder16setResolveEntityEb, Ptr<void> self, int resolve) {
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    xml_builders[self.address()].resolve_entity = resolve != 0;
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilder20setSkipIgnorableTextEb, Ptr<void> self, int skip) {
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    xml_builders[self.address()].skip_text = skip != 0;
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilder26setSkipIgnorableWhiteSpaceEb, Ptr<void> self, int skip) {
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    xml_builders[self.address()].skip_whitespace = skip != 0;
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilder5parseEPKNS0_6StringEb, Ptr<void> self, Ptr<XmlString> text, int complete) {
+    if (!text) {
+        return -1;
+    }
+    XmlBuilderState options;
+    {
+        const std::lock_guard<std::mutex> lock(xml_mutex);
+        options = xml_builders[self.address()];
+    }
+    const XmlString *view = text.get(host.mem);
+    if (!view->str) {
+        return -1;
+    }
+    const HostXmlDocPtr doc = std::make_shared<HostXmlDoc>();
+    const char *chars = Ptr<const char>(view->str).get(host.mem);
+    if (!parse_xml(*doc, chars, chars + view->length, options)) {
+        doc->status = -1;
+    }
+
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    XmlBuilderState &builder = xml_builders[self.address()];
+    if (!builder.doc_block) {
+        builder.doc_block = alloc(host.mem, sizeof(XmlDocument), "SceLibXml document");
+        if (!builder.doc_block) {
+            return -1;
+        }
+        memset(Ptr<XmlDocument>(builder.doc_block).get(host.mem), 0, sizeof(XmlDocument));
+    }
+    builder.doc = doc;
+    xml_docs[builder.doc_block] = doc;
+    return doc->status;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom15DocumentBuilder9terminateEv, Ptr<void> self) {
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    const auto builder = xml_builders.find(self.address());
+    if (builder != xml_builders.end()) {
+        if (builder->second.doc_block) {
+            xml_docs.erase(builder->second.doc_block);
+            free(host.mem, builder->second.doc_block);
+        }
+        xml_builders.erase(builder);
+    }
+    return 0;
+}
+
+EXPORT(Ptr<void>, _ZN3sce3Xml3Dom15DocumentBuilderC1Ev, Ptr<void> self) {
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    xml_builders[self.address()] = XmlBuilderState();
+    return self;
+}
+
+EXPORT(Ptr<void>, _ZN3sce3Xml3Dom15DocumentBuilderC2Ev, Ptr<void> self) {
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    xml_builders[self.address()] = XmlBuilderState();
+    return self;
+}
+
+EXPORT(Ptr<void>, _ZN3sce3Xml3Dom15DocumentBuilderD1Ev, Ptr<void> self) {
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    const auto builder = xml_builders.find(self.address());
+    if (builder != xml_builders.end()) {
+        if (builder->second.doc_block) {
+            xml_docs.erase(builder->second.doc_block);
+            free(host.mem, builder->second.doc_block);
+        }
+        xml_builders.erase(builder);
+    }
+    return self;
+}
+
+EXPORT(Ptr<void>, _ZN3sce3Xml3Dom15DocumentBuilderD2Ev, Ptr<void> self) {
+    const std::lock_guard<std::mutex> lock(xml_mutex);
+    const auto builder = xml_builders.find(self.address());
+    if (builder != xml_builders.end()) {
+        if (builder->second.doc_block) {
+            xml_docs.erase(builder->second.doc_block);
+            free(host.mem, builder->second.doc_block);
+        }
+        xml_builders.erase(builder);
+    }
+    return self;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom4Node11appendChildEy, Ptr<XmlNode> self, uint64_t child_id) {
+    ResolvedNode at, child;
+    if (!resolve_node(self.get(host.mem)->id, at) || !resolve_node(child_id, child) || (at.doc != child.doc) || !at.doc->writable) {
+        return -1;
+    }
+    unlink_node(*at.doc, child.index);
+    HostXmlNode &parent = at.doc->nodes[at.index];
+    HostXmlNode &node = at.doc->nodes[child.index];
+    node.parent = at.index;
+    node.prev = parent.last_child;
+    if (parent.last_child) {
+        at.doc->nodes[parent.last_child].next = child.index;
+    } else {
+        parent.first_child = child.index;
+    }
+    parent.last_child = child.index;
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom4Node11removeChildEy, Ptr<XmlNode> self, uint64_t child_id) {
+    ResolvedNode at, child;
+    if (!resolve_node(self.get(host.mem)->id, at) || !resolve_node(child_id, child) || (at.doc != child.doc) || !at.doc->writable) {
+        return -1;
+    }
+    if (child.doc->nodes[child.index].parent != at.index) {
+        return -1;
+    }
+    unlink_node(*at.doc, child.index);
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom4Node12insertBeforeEyy, Ptr<XmlNode> self, uint64_t child_id, uint64_t before_id) {
+    ResolvedNode at, child, before;
+    if (!resolve_node(self.get(host.mem)->id, at) || !resolve_node(child_id, child) || (at.doc != child.doc) || !at.doc->writable) {
+        return -1;
+    }
+    if (!resolve_node(before_id, before) || (before.doc != at.doc) || (at.doc->nodes[before.index].parent != at.index)) {
+        return -1;
+    }
+    unlink_node(*at.doc, child.index);
+    HostXmlNode &node = at.doc->nodes[child.index];
+    HostXmlNode &anchor = at.doc->nodes[before.index];
+    node.parent = at.index;
+    node.next = before.index;
+    node.prev = anchor.prev;
+    if (anchor.prev) {
+        at.doc->nodes[anchor.prev].next = child.index;
+    } else {
+        at.doc->nodes[at.index].first_child = child.index;
+    }
+    anchor.prev = child.index;
+    return 0;
+}
+
+EXPORT(Ptr<XmlNode>, _ZN3sce3Xml3Dom4NodeC1Ey, Ptr<XmlNode> self, uint64_t id) {
+    self.get(host.mem)->id = id;
+    return self;
+}
+
+EXPORT(Ptr<XmlNode>, _ZN3sce3Xml3Dom4NodeC2Ey, Ptr<XmlNode> self, uint64_t id) {
+    self.get(host.mem)->id = id;
+    return self;
+}
+
+EXPORT(Ptr<XmlNode>, _ZN3sce3Xml3Dom4NodeD1Ev, Ptr<XmlNode> self) {
+    return self;
+}
+
+EXPORT(Ptr<XmlNode>, _ZN3sce3Xml3Dom4NodeD2Ev, Ptr<XmlNode> self) {
+    return self;
+}
+
+EXPORT(uint64_t, _ZN3sce3Xml3Dom8Document10importNodeEyyPKS2_y) {
+    UNIMPLEMENTED();
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8Document10initializeEPKNS0_11InitializerE, Ptr<XmlDocument> self, Ptr<void> initializer) {
+    const HostXmlDocPtr doc = std::make_shared<HostXmlDoc>();
+    add_node(*doc, 0, NODE_DOCUMENT);
+    doc->writable = true;
+    register_xml_doc(self.address(), doc);
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8Document10insertNodeEyyy, Ptr<XmlDocument> self, uint64_t parent_id, uint64_t before_id, uint64_t child_id) {
+    ResolvedNode parent, child;
+    if (!resolve_node(parent_id, parent) || !resolve_node(child_id, child) || (parent.doc != child.doc) || !parent.doc->writable) {
+        return -1;
+    }
+    unlink_node(*parent.doc, child.index);
+    HostXmlNode &node = parent.doc->nodes[child.index];
+    ResolvedNode before;
+    if (resolve_node(before_id, before) && (before.doc == parent.doc) && (parent.doc->nodes[before.index].parent == parent.index)) {
+        HostXmlNode &anchor = parent.doc->nodes[before.index];
+        node.parent = parent.index;
+        node.next = before.index;
+        node.prev = anchor.prev;
+        if (anchor.prev) {
+            parent.doc->nodes[anchor.prev].next = child.index;
+        } else {
+            parent.doc->nodes[parent.index].first_child = child.index;
+        }
+        anchor.prev = child.index;
+    } else {
+        HostXmlNode &up = parent.doc->nodes[parent.index];
+        node.parent = parent.index;
+        node.prev = up.last_child;
+        if (up.last_child) {
+            parent.doc->nodes[up.last_child].next = child.index;
+        } else {
+            up.first_child = child.index;
+        }
+        up.last_child = child.index;
+    }
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8Document11removeChildEyy, Ptr<XmlDocument> self, uint64_t parent_id, uint64_t child_id) {
+    ResolvedNode parent, child;
+    if (!resolve_node(parent_id, parent) || !resolve_node(child_id, child) || (parent.doc != child.doc) || !parent.doc->writable) {
+        return -1;
+    }
+    if (child.doc->nodes[child.index].parent != parent.index) {
+        return -1;
+    }
+    unlink_node(*child.doc, child.index);
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8Document11resetStatusEv, Ptr<XmlDocument> self) {
+    const HostXmlDocPtr doc = find_xml_doc(self.address());
+    if (doc) {
+        doc->status = 0;
+    }
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8Document11setWritableEv, Ptr<XmlDocument> self) {
+    const HostXmlDocPtr doc = find_xml_doc(self.address());
+    if (!doc) {
+        return -1;
+    }
+    doc->writable = true;
+    return 0;
 }
 
 EXPORT(int, _ZN3sce3Xml3Dom8Document12importParentEPKS2_y) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _ZN3sce3Xml3Dom8Document12setAttrValueEyPKNS0_6StringES5_) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document12setAttributeEyPKNS0_6StringES5_) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document13createElementEPKNS0_6StringEPKNS0_13AttributeListES5_) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document13recurseDeleteEy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document14createTextNodeEPKNS0_6StringE) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document15addElementChildEyPKNS0_6StringEPKNS0_13AttributeListES5_) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document15removeAttributeEyPKNS0_6StringE) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document16removeAttributesEy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document16setAttributeListEyPKNS0_13AttributeListE) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document7setTextEyPKNS0_6StringE) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document9serializeEPKNS0_18SerializeParameterEPNS0_6StringE) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8Document9terminateEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8DocumentC1ERKS2_) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8DocumentC1Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8DocumentC2ERKS2_) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml3Dom8Document12setAttrValueEyPKNS0_6StringES5_, Ptr<XmlDocument> self, uint64_t id, Ptr<XmlString> name, Ptr<XmlString> value) {
+    return set_node_attribute(host, id, name.get(host.mem), value.get(host.mem));
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8Document12setAttributeEyPKNS0_6StringES5_, Ptr<XmlDocument> self, uint64_t id, Ptr<XmlString> name, Ptr<XmlString> value) {
+    return set_node_attribute(host, id, name.get(host.mem), value.get(host.mem));
+}
+
+EXPORT(uint64_t, _ZN3sce3Xml3Dom8Document13createElementEPKNS0_6StringEPKNS0_13AttributeListES5_, Ptr<XmlDocument> self, Ptr<XmlString> name, Ptr<XmlAttributeList> attributes, Ptr<XmlString> text) {
+    // Created unlinked; insertNode/appendChild attaches it.
+    return create_element_node(host, self, 0, name.get(host.mem), attributes, text.get(host.mem));
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8Document13recurseDeleteEy, Ptr<XmlDocument> self, uint64_t id) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || !at.doc->writable) {
+        return -1;
+    }
+    // Unlink only - the subtree stays in the table, unreachable. Compaction
+    // is not worth the handle invalidation it would cause.
+    unlink_node(*at.doc, at.index);
+    return 0;
+}
+
+EXPORT(uint64_t, _ZN3sce3Xml3Dom8Document14createTextNodeEPKNS0_6StringE, Ptr<XmlDocument> self, Ptr<XmlString> text) {
+    const HostXmlDocPtr doc = find_xml_doc(self.address());
+    if (!doc || !doc->writable) {
+        return 0;
+    }
+    const uint32_t node = add_node(*doc, 0, NODE_TEXT);
+    doc->nodes[node].text = intern(*doc, string_view_chars(host.mem, text.get(host.mem)));
+    return make_node_id(self.address(), node);
+}
+
+EXPORT(uint64_t, _ZN3sce3Xml3Dom8Document15addElementChildEyPKNS0_6StringEPKNS0_13AttributeListES5_, Ptr<XmlDocument> self, uint64_t parent_id, Ptr<XmlString> name, Ptr<XmlAttributeList> attributes, Ptr<XmlString> text) {
+    ResolvedNode parent;
+    if (!resolve_node(parent_id, parent) || (parent.doc_address != self.address())) {
+        return 0;
+    }
+    return create_element_node(host, self, parent.index, name.get(host.mem), attributes, text.get(host.mem));
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8Document15removeAttributeEyPKNS0_6StringE, Ptr<XmlDocument> self, uint64_t id, Ptr<XmlString> name) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || !at.doc->writable) {
+        return -1;
+    }
+    const std::string key = string_view_chars(host.mem, name.get(host.mem));
+    auto &attrs = at.doc->nodes[at.index].attrs;
+    for (auto attr = attrs.begin(); attr != attrs.end(); ++attr) {
+        if (at.doc->strings[attr->first] == key) {
+            attrs.erase(attr);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8Document16removeAttributesEy, Ptr<XmlDocument> self, uint64_t id) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || !at.doc->writable) {
+        return -1;
+    }
+    at.doc->nodes[at.index].attrs.clear();
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8Document16setAttributeListEyPKNS0_13AttributeListE, Ptr<XmlDocument> self, uint64_t id, Ptr<XmlAttributeList> attributes) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || !at.doc->writable || !attributes) {
+        return -1;
+    }
+    auto &attrs = at.doc->nodes[at.index].attrs;
+    attrs.clear();
+    const XmlAttributeList *list = attributes.get(host.mem);
+    const XmlAttr *items = list->items ? Ptr<XmlAttr>(list->items).get(host.mem) : nullptr;
+    for (uint32_t i = 0; items && (i < list->count); ++i) {
+        attrs.emplace_back(
+            intern(*at.doc, string_view_chars(host.mem, &items[i].name)),
+            intern(*at.doc, string_view_chars(host.mem, &items[i].value)));
+    }
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8Document7setTextEyPKNS0_6StringE, Ptr<XmlDocument> self, uint64_t id, Ptr<XmlString> text) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || !at.doc->writable) {
+        return -1;
+    }
+    const uint32_t interned = intern(*at.doc, string_view_chars(host.mem, text.get(host.mem)));
+    HostXmlNode &node = at.doc->nodes[at.index];
+    if (node.type == NODE_TEXT) {
+        node.text = interned;
+        return 0;
+    }
+    // On an element, replace its text child, creating one if needed.
+    for (uint32_t child = node.first_child; child; child = at.doc->nodes[child].next) {
+        if (at.doc->nodes[child].type == NODE_TEXT) {
+            at.doc->nodes[child].text = interned;
+            return 0;
+        }
+    }
+    const uint32_t child = add_node(*at.doc, at.index, NODE_TEXT);
+    at.doc->nodes[child].text = interned;
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8Document9serializeEPKNS0_18SerializeParameterEPNS0_6StringE, Ptr<XmlDocument> self, Ptr<void> parameter, Ptr<XmlString> out) {
+    const HostXmlDocPtr doc = find_xml_doc(self.address());
+    if (!doc || !out) {
+        return -1;
+    }
+    std::string text;
+    if (doc->nodes.size() > 1) {
+        serialize_node(*doc, 1, text);
+    }
+    const Address block = alloc(host.mem, text.size() + 1, "SceLibXml serialize");
+    if (!block) {
+        return -1;
+    }
+    memcpy(Ptr<char>(block).get(host.mem), text.c_str(), text.size() + 1);
+    XmlString *view = out.get(host.mem);
+    view->str = block;
+    view->length = uint32_t(text.size());
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8Document9terminateEv, Ptr<XmlDocument> self) {
+    unregister_xml_doc(self.address());
+    return 0;
+}
+
+EXPORT(Ptr<XmlDocument>, _ZN3sce3Xml3Dom8DocumentC1ERKS2_, Ptr<XmlDocument> self, Ptr<XmlDocument> other) {
+    memset(self.get(host.mem), 0, sizeof(XmlDocument));
+    const HostXmlDocPtr doc = find_xml_doc(other.address());
+    if (doc) {
+        register_xml_doc(self.address(), doc);
+    }
+    return self;
+}
+
+EXPORT(Ptr<XmlDocument>, _ZN3sce3Xml3Dom8DocumentC1Ev, Ptr<XmlDocument> self) {
+    memset(self.get(host.mem), 0, sizeof(XmlDocument));
+    return self;
+}
+
+EXPORT(Ptr<XmlDocument>, _ZN3sce3Xml3Dom8DocumentC2ERKS2_, Ptr<XmlDocument> self, Ptr<XmlDocument> other) {
+    memset(self.get(host.mem), 0, sizeof(XmlDocument));
+    const HostXmlDocPtr doc = find_xml_doc(other.address());
+    if (doc) {
+        register_xml_doc(self.address(), doc);
+    }
+    return self;
+}
+
+EXPORT(Ptr<XmlDocument>, _ZN3sce3Xml3Dom8DocumentC2Ev, Ptr<XmlDocument> self) {
+    memset(self.get(host.mem), 0, sizeof(XmlDocument));
+    return self;
+}
+
+EXPORT(Ptr<XmlDocument>, _ZN3sce3Xml3Dom8DocumentD1Ev, Ptr<XmlDocument> self) {
+    unregister_xml_doc(self.address());
+    return self;
+}
+
+EXPORT(Ptr<XmlDocument>, _ZN3sce3Xml3Dom8DocumentD2Ev, Ptr<XmlDocument> self) {
+    unregister_xml_doc(self.address());
+    return self;
+}
+
+EXPORT(Ptr<XmlDocument>, _ZN3sce3Xml3Dom8DocumentaSERKS2_, Ptr<XmlDocument> self, Ptr<XmlDocument> other) {
+    const HostXmlDocPtr doc = find_xml_doc(other.address());
+    if (doc) {
+        register_xml_doc(self.address(), doc);
+    } else {
+        unregister_xml_doc(self.address());
+    }
+    return self;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8NodeList10initializeEPKNS0_11InitializerE, Ptr<XmlNodeList> self, Ptr<void> initializer) {
+    memset(self.get(host.mem), 0, sizeof(XmlNodeList));
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8NodeList10insertLastEy, Ptr<XmlNodeList> self, uint64_t id) {
+    node_list_append(host, self.get(host.mem), id);
+    return 0;
+}
+
+EXPORT(int, _ZN3sce3Xml3Dom8NodeList10removeItemEy, Ptr<XmlNodeList> self, uint64_t id) {
+    XmlNodeList *list = self.get(host.mem);
+    uint64_t *items = list->items ? Ptr<uint64_t>(list->items).get(host.mem) : nullptr;
+    for (uint32_t i = 0; items && (i < list->count); ++i) {
+        if (items[i] == id) {
+            memmove(items + i, items + i + 1, (list->count - i - 1) * sizeof(uint64_t));
+            --list->count;
+            return 0;
+        }
+    }
+    return -1;
 }
 
-EXPORT(int, _ZN3sce3Xml3Dom8DocumentC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml3Dom8NodeList11insertFirstEy, Ptr<XmlNodeList> self, uint64_t id) {
+    XmlNodeList *list = self.get(host.mem);
+    if (!list_reserve<uint64_t>(host, list->items, list->count, list->capacity, list->count + 1)) {
+        return -1;
+    }
+    uint64_t *items = Ptr<uint64_t>(list->items).get(host.mem);
+    memmove(items + 1, items, list->count * sizeof(uint64_t));
+    items[0] = id;
+    ++list->count;
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml3Dom8DocumentD1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml3Dom8NodeList5clearEv, Ptr<XmlNodeList> self) {
+    self.get(host.mem)->count = 0;
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml3Dom8DocumentD2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml3Dom8NodeList9terminateEv, Ptr<XmlNodeList> self) {
+    XmlNodeList *list = self.get(host.mem);
+    if (list->items) {
+        free(host.mem, list->items);
+    }
+    memset(list, 0, sizeof(XmlNodeList));
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml3Dom8DocumentaSERKS2_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlNodeList>, _ZN3sce3Xml3Dom8NodeListC1ERKS2_, Ptr<XmlNodeList> self, Ptr<XmlNodeList> other) {
+    XmlNodeList *list = self.get(host.mem);
+    memset(list, 0, sizeof(XmlNodeList));
+    const XmlNodeList *source = other.get(host.mem);
+    if (source->count && list_reserve<uint64_t>(host, list->items, 0, list->capacity, source->count)) {
+        memcpy(Ptr<uint64_t>(list->items).get(host.mem), Ptr<uint64_t>(source->items).get(host.mem), source->count * sizeof(uint64_t));
+        list->count = source->count;
+    }
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml3Dom8NodeList10initializeEPKNS0_11InitializerE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlNodeList>, _ZN3sce3Xml3Dom8NodeListC1Ev, Ptr<XmlNodeList> self) {
+    memset(self.get(host.mem), 0, sizeof(XmlNodeList));
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml3Dom8NodeList10insertLastEy) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlNodeList>, _ZN3sce3Xml3Dom8NodeListC2ERKS2_, Ptr<XmlNodeList> self, Ptr<XmlNodeList> other) {
+    XmlNodeList *list = self.get(host.mem);
+    memset(list, 0, sizeof(XmlNodeList));
+    const XmlNodeList *source = other.get(host.mem);
+    if (source->count && list_reserve<uint64_t>(host, list->items, 0, list->capacity, source->count)) {
+        memcpy(Ptr<uint64_t>(list->items).get(host.mem), Ptr<uint64_t>(source->items).get(host.mem), source->count * sizeof(uint64_t));
+        list->count = source->count;
+    }
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml3Dom8NodeList10removeItemEy) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlNodeList>, _ZN3sce3Xml3Dom8NodeListC2Ev, Ptr<XmlNodeList> self) {
+    memset(self.get(host.mem), 0, sizeof(XmlNodeList));
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml3Dom8NodeList11insertFirstEy) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlNodeList>, _ZN3sce3Xml3Dom8NodeListD1Ev, Ptr<XmlNodeList> self) {
+    XmlNodeList *list = self.get(host.mem);
+    if (list->items) {
+        free(host.mem, list->items);
+    }
+    memset(list, 0, sizeof(XmlNodeList));
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml3Dom8NodeList5clearEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8NodeList9terminateEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8NodeListC1ERKS2_) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8NodeListC1Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8NodeListC2ERKS2_) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8NodeListC2Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8NodeListD1Ev) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZN3sce3Xml3Dom8NodeListD2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlNodeList>, _ZN3sce3Xml3Dom8NodeListD2Ev, Ptr<XmlNodeList> self) {
+    XmlNodeList *list = self.get(host.mem);
+    if (list->items) {
+        free(host.mem, list->items);
+    }
+    memset(list, 0, sizeof(XmlNodeList));
+    return self;
 }
 
 EXPORT(int, _ZN3sce3Xml3Sax6Parser10initializeEPKNS0_11InitializerE) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce3Xml3Sax6Parser11setUserDataEPv) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce3Xml3Sax6Parser16setResolveEntityEb) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce3Xml3Sax6Parser18setDocumentHandlerEPNS1_15DocumentHandlerE) {
+    // SAX callbacks are virtual methods on a guest object; dispatching
+    // through its vtable is not wired up. Titles we care about use the DOM.
     return UNIMPLEMENTED();
 }
 
 EXPORT(int, _ZN3sce3Xml3Sax6Parser26setSkipIgnorableWhiteSpaceEb) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce3Xml3Sax6Parser5parseEPKNS0_6StringEb) {
@@ -430,335 +1513,592 @@ EXPORT(int, _ZN3sce3Xml3Sax6Parser5parseEPKNS0_6StringEb) {
 }
 
 EXPORT(int, _ZN3sce3Xml3Sax6Parser5resetEv) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZN3sce3Xml3Sax6Parser9terminateEv) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml3Sax6ParserC1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml3Sax6ParserC1Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml3Sax6ParserC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml3Sax6ParserC2Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml3Sax6ParserD1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml3Sax6ParserD1Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml3Sax6ParserD2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, _ZN3sce3Xml3Sax6ParserD2Ev, Ptr<void> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml4Attr10initializeEPKNS0_11InitializerE) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml4Attr10initializeEPKNS0_11InitializerE, Ptr<XmlAttr> self, Ptr<void> initializer) {
+    memset(self.get(host.mem), 0, sizeof(XmlAttr));
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml4Attr7setNameEPKNS0_6StringE) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml4Attr7setNameEPKNS0_6StringE, Ptr<XmlAttr> self, Ptr<XmlString> name) {
+    if (!name) {
+        return -1;
+    }
+    self.get(host.mem)->name = *name.get(host.mem);
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml4Attr8setValueEPKNS0_6StringE) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml4Attr8setValueEPKNS0_6StringE, Ptr<XmlAttr> self, Ptr<XmlString> value) {
+    if (!value) {
+        return -1;
+    }
+    self.get(host.mem)->value = *value.get(host.mem);
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml4Attr9terminateEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZN3sce3Xml4Attr9terminateEv, Ptr<XmlAttr> self) {
+    memset(self.get(host.mem), 0, sizeof(XmlAttr));
+    return 0;
 }
 
-EXPORT(int, _ZN3sce3Xml4AttrC1ERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttr>, _ZN3sce3Xml4AttrC1ERKS1_, Ptr<XmlAttr> self, Ptr<XmlAttr> other) {
+    *self.get(host.mem) = *other.get(host.mem);
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml4AttrC1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttr>, _ZN3sce3Xml4AttrC1Ev, Ptr<XmlAttr> self) {
+    memset(self.get(host.mem), 0, sizeof(XmlAttr));
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml4AttrC2ERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttr>, _ZN3sce3Xml4AttrC2ERKS1_, Ptr<XmlAttr> self, Ptr<XmlAttr> other) {
+    *self.get(host.mem) = *other.get(host.mem);
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml4AttrC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttr>, _ZN3sce3Xml4AttrC2Ev, Ptr<XmlAttr> self) {
+    memset(self.get(host.mem), 0, sizeof(XmlAttr));
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml4AttrD1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttr>, _ZN3sce3Xml4AttrD1Ev, Ptr<XmlAttr> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml4AttrD2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttr>, _ZN3sce3Xml4AttrD2Ev, Ptr<XmlAttr> self) {
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml4AttraSERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttr>, _ZN3sce3Xml4AttraSERKS1_, Ptr<XmlAttr> self, Ptr<XmlAttr> other) {
+    *self.get(host.mem) = *other.get(host.mem);
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml4Util9strResultEi) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<const char>, _ZN3sce3Xml4Util9strResultEi, int result) {
+    static Address ok_text = 0;
+    static Address error_text = 0;
+    static std::mutex mutex;
+    const std::lock_guard<std::mutex> lock(mutex);
+    Address &cached = (result == 0) ? ok_text : error_text;
+    if (!cached) {
+        const char *text = (result == 0) ? "OK" : "ERROR";
+        cached = alloc(host.mem, strlen(text) + 1, "SceLibXml result");
+        if (cached) {
+            memcpy(Ptr<char>(cached).get(host.mem), text, strlen(text) + 1);
+        }
+    }
+    return Ptr<const char>(cached);
 }
 
-EXPORT(int, _ZN3sce3Xml6StringC1EPKc) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZN3sce3Xml6StringC1EPKc, Ptr<XmlString> self, Ptr<const char> text) {
+    XmlString *string = self.get(host.mem);
+    string->str = text.address();
+    string->length = text ? uint32_t(strlen(text.get(host.mem))) : 0;
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml6StringC1EPKcj) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZN3sce3Xml6StringC1EPKcj, Ptr<XmlString> self, Ptr<const char> text, uint32_t length) {
+    XmlString *string = self.get(host.mem);
+    string->str = text.address();
+    string->length = length;
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml6StringC1ERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZN3sce3Xml6StringC1ERKS1_, Ptr<XmlString> self, Ptr<XmlString> other) {
+    *self.get(host.mem) = *other.get(host.mem);
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml6StringC1Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZN3sce3Xml6StringC1Ev, Ptr<XmlString> self) {
+    memset(self.get(host.mem), 0, sizeof(XmlString));
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml6StringC2EPKc) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZN3sce3Xml6StringC2EPKc, Ptr<XmlString> self, Ptr<const char> text) {
+    XmlString *string = self.get(host.mem);
+    string->str = text.address();
+    string->length = text ? uint32_t(strlen(text.get(host.mem))) : 0;
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml6StringC2EPKcj) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZN3sce3Xml6StringC2EPKcj, Ptr<XmlString> self, Ptr<const char> text, uint32_t length) {
+    XmlString *string = self.get(host.mem);
+    string->str = text.address();
+    string->length = length;
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml6StringC2ERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZN3sce3Xml6StringC2ERKS1_, Ptr<XmlString> self, Ptr<XmlString> other) {
+    *self.get(host.mem) = *other.get(host.mem);
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml6StringC2Ev) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZN3sce3Xml6StringC2Ev, Ptr<XmlString> self) {
+    memset(self.get(host.mem), 0, sizeof(XmlString));
+    return self;
 }
 
-EXPORT(int, _ZN3sce3Xml6StringaSERKS1_) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZN3sce3Xml6StringaSERKS1_, Ptr<XmlString> self, Ptr<XmlString> other) {
+    *self.get(host.mem) = *other.get(host.mem);
+    return self;
 }
 
-EXPORT(int, _ZNK3sce3Xml13AttributeList11isAvailableEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce3Xml13AttributeList11isAvailableEv, Ptr<XmlAttributeList> self) {
+    return self.get(host.mem) != nullptr;
 }
 
-EXPORT(int, _ZNK3sce3Xml13AttributeList12getAttributeEPKNS0_6StringE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttr>, _ZNK3sce3Xml13AttributeList12getAttributeEPKNS0_6StringE, Ptr<XmlAttributeList> self, Ptr<XmlString> name) {
+    const std::string key = string_view_chars(host.mem, name.get(host.mem));
+    const XmlAttributeList *list = self.get(host.mem);
+    const XmlAttr *items = list->items ? Ptr<XmlAttr>(list->items).get(host.mem) : nullptr;
+    for (uint32_t i = 0; items && (i < list->count); ++i) {
+        if (string_view_chars(host.mem, &items[i].name) == key) {
+            return Ptr<XmlAttr>(list->items + (i * sizeof(XmlAttr)));
+        }
+    }
+    return Ptr<XmlAttr>();
 }
 
-EXPORT(int, _ZNK3sce3Xml13AttributeList12getAttributeEj) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlAttr>, _ZNK3sce3Xml13AttributeList12getAttributeEj, Ptr<XmlAttributeList> self, uint32_t index) {
+    const XmlAttributeList *list = self.get(host.mem);
+    if (index >= list->count) {
+        return Ptr<XmlAttr>();
+    }
+    return Ptr<XmlAttr>(list->items + (index * sizeof(XmlAttr)));
 }
 
-EXPORT(int, _ZNK3sce3Xml13AttributeList9getLengthEv) {
-    return UNIMPLEMENTED();
+EXPORT(uint32_t, _ZNK3sce3Xml13AttributeList9getLengthEv, Ptr<XmlAttributeList> self) {
+    return self.get(host.mem)->count;
 }
 
 EXPORT(int, _ZNK3sce3Xml3Dom13DocumentDebug13getStructSizeEv) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZNK3sce3Xml3Dom13DocumentDebug16getAttrTableSizeEv) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZNK3sce3Xml3Dom13DocumentDebug16getCharTableSizeEv) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
 EXPORT(int, _ZNK3sce3Xml3Dom13DocumentDebug19getElementTableSizeEv) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom4Node11getNodeNameEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZNK3sce3Xml3Dom4Node11getNodeNameEv, Ptr<XmlString> result, Ptr<XmlNode> self) {
+    memset(result.get(host.mem), 0, sizeof(XmlString));
+    ResolvedNode at;
+    if (resolve_node(self.get(host.mem)->id, at)) {
+        set_string(host, *at.doc, result.get(host.mem), at.doc->nodes[at.index].name);
+    }
+    return result;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom4Node11getNodeTypeEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce3Xml3Dom4Node11getNodeTypeEv, Ptr<XmlNode> self) {
+    ResolvedNode at;
+    if (!resolve_node(self.get(host.mem)->id, at)) {
+        return 0;
+    }
+    return at.doc->nodes[at.index].type;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom4Node11isAvailableEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce3Xml3Dom4Node11isAvailableEv, Ptr<XmlNode> self) {
+    ResolvedNode at;
+    return resolve_node(self.get(host.mem)->id, at);
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom4Node12getLastChildEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlNode>, _ZNK3sce3Xml3Dom4Node12getLastChildEv, Ptr<XmlNode> result, Ptr<XmlNode> self) {
+    result.get(host.mem)->id = 0;
+    ResolvedNode at;
+    if (resolve_node(self.get(host.mem)->id, at) && at.doc->nodes[at.index].last_child) {
+        result.get(host.mem)->id = make_node_id(at.doc_address, at.doc->nodes[at.index].last_child);
+    }
+    return result;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom4Node12getNodeValueEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZNK3sce3Xml3Dom4Node12getNodeValueEv, Ptr<XmlString> result, Ptr<XmlNode> self) {
+    memset(result.get(host.mem), 0, sizeof(XmlString));
+    ResolvedNode at;
+    if (resolve_node(self.get(host.mem)->id, at)) {
+        set_string(host, *at.doc, result.get(host.mem), at.doc->nodes[at.index].text);
+    }
+    return result;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom4Node13getAttributesEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlNodeList>, _ZNK3sce3Xml3Dom4Node13getAttributesEv, Ptr<XmlNodeList> result, Ptr<XmlNode> self) {
+    memset(result.get(host.mem), 0, sizeof(XmlNodeList));
+    ResolvedNode at;
+    if (resolve_node(self.get(host.mem)->id, at)) {
+        node_list_fill_attrs(host, at, result.get(host.mem));
+    }
+    return result;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom4Node13getChildNodesEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlNodeList>, _ZNK3sce3Xml3Dom4Node13getChildNodesEv, Ptr<XmlNodeList> result, Ptr<XmlNode> self) {
+    memset(result.get(host.mem), 0, sizeof(XmlNodeList));
+    ResolvedNode at;
+    if (resolve_node(self.get(host.mem)->id, at)) {
+        node_list_fill_children(host, at, result.get(host.mem));
+    }
+    return result;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom4Node13getFirstChildEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlNode>, _ZNK3sce3Xml3Dom4Node13getFirstChildEv, Ptr<XmlNode> result, Ptr<XmlNode> self) {
+    result.get(host.mem)->id = 0;
+    ResolvedNode at;
+    if (resolve_node(self.get(host.mem)->id, at) && at.doc->nodes[at.index].first_child) {
+        result.get(host.mem)->id = make_node_id(at.doc_address, at.doc->nodes[at.index].first_child);
+    }
+    return result;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom4Node13getParentNodeEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlNode>, _ZNK3sce3Xml3Dom4Node13getParentNodeEv, Ptr<XmlNode> result, Ptr<XmlNode> self) {
+    result.get(host.mem)->id = 0;
+    ResolvedNode at;
+    if (resolve_node(self.get(host.mem)->id, at) && at.doc->nodes[at.index].parent) {
+        result.get(host.mem)->id = make_node_id(at.doc_address, at.doc->nodes[at.index].parent);
+    }
+    return result;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom4Node13hasAttributesEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom4Node13hasChildNodesEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom4Node14getNextSiblingEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom4Node16getOwnerDocumentEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce3Xml3Dom4Node13hasAttributesEv, Ptr<XmlNode> self) {
+    ResolvedNode at;
+    return resolve_node(self.get(host.mem)->id, at) && !at.doc->nodes[at.index].attrs.empty();
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document10getDocRootEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce3Xml3Dom4Node13hasChildNodesEv, Ptr<XmlNode> self) {
+    ResolvedNode at;
+    return resolve_node(self.get(host.mem)->id, at) && (at.doc->nodes[at.index].first_child != 0);
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document10getSiblingEy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8Document10getXmlMetaEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlNode>, _ZNK3sce3Xml3Dom4Node14getNextSiblingEv, Ptr<XmlNode> result, Ptr<XmlNode> self) {
+    result.get(host.mem)->id = 0;
+    ResolvedNode at;
+    if (resolve_node(self.get(host.mem)->id, at) && at.doc->nodes[at.index].next) {
+        result.get(host.mem)->id = make_node_id(at.doc_address, at.doc->nodes[at.index].next);
+    }
+    return result;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document10isReadOnlyEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlDocument>, _ZNK3sce3Xml3Dom4Node16getOwnerDocumentEv, Ptr<XmlNode> self) {
+    return Ptr<XmlDocument>(Address(self.get(host.mem)->id >> 32));
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document11getAttrNameEy) {
-    return UNIMPLEMENTED();
+EXPORT(uint64_t, _ZNK3sce3Xml3Dom8Document10getDocRootEv, Ptr<XmlDocument> self) {
+    const HostXmlDocPtr doc = find_xml_doc(self.address());
+    if (!doc || (doc->nodes.size() < 2)) {
+        return 0;
+    }
+    return make_node_id(self.address(), 1);
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document11getNextAttrEy) {
-    return UNIMPLEMENTED();
+EXPORT(uint64_t, _ZNK3sce3Xml3Dom8Document10getSiblingEy, Ptr<XmlDocument> self, uint64_t id) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || !at.doc->nodes[at.index].next) {
+        return 0;
+    }
+    return make_node_id(at.doc_address, at.doc->nodes[at.index].next);
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document11getNodeNameEy) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZNK3sce3Xml3Dom8Document10getXmlMetaEv, Ptr<XmlString> result, Ptr<XmlDocument> self) {
+    memset(result.get(host.mem), 0, sizeof(XmlString));
+    const HostXmlDocPtr doc = find_xml_doc(self.address());
+    if (doc) {
+        set_string(host, *doc, result.get(host.mem), doc->meta);
+    }
+    return result;
+}
+
+EXPORT(int, _ZNK3sce3Xml3Dom8Document10isReadOnlyEv, Ptr<XmlDocument> self) {
+    const HostXmlDocPtr doc = find_xml_doc(self.address());
+    return doc ? !doc->writable : 1;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document11getNodeTypeEy) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZNK3sce3Xml3Dom8Document11getAttrNameEy, Ptr<XmlString> result, Ptr<XmlDocument> self, uint64_t id) {
+    memset(result.get(host.mem), 0, sizeof(XmlString));
+    ResolvedNode at;
+    uint32_t slot = 0;
+    if (resolve_attr(id, at, slot)) {
+        set_string(host, *at.doc, result.get(host.mem), at.doc->nodes[at.index].attrs[slot].first);
+    }
+    return result;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document11isAvailableEv) {
-    return UNIMPLEMENTED();
+EXPORT(uint64_t, _ZNK3sce3Xml3Dom8Document11getNextAttrEy, Ptr<XmlDocument> self, uint64_t id) {
+    ResolvedNode at;
+    uint32_t slot = 0;
+    if (!resolve_attr(id, at, slot) || ((slot + 1) >= at.doc->nodes[at.index].attrs.size())) {
+        return 0;
+    }
+    return attr_handle(*at.doc, at.doc_address, at.index, slot + 1);
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document12getAttrValueEy) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZNK3sce3Xml3Dom8Document11getNodeNameEy, Ptr<XmlString> result, Ptr<XmlDocument> self, uint64_t id) {
+    memset(result.get(host.mem), 0, sizeof(XmlString));
+    ResolvedNode at;
+    if (resolve_node(id, at)) {
+        set_string(host, *at.doc, result.get(host.mem), at.doc->nodes[at.index].name);
+    }
+    return result;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document12getAttributeEyPKNS0_6StringE) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce3Xml3Dom8Document11getNodeTypeEy, Ptr<XmlDocument> self, uint64_t id) {
+    ResolvedNode at;
+    if (!resolve_node(id, at)) {
+        return 0;
+    }
+    return at.doc->nodes[at.index].type;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document12getFirstAttrEy) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce3Xml3Dom8Document11isAvailableEv, Ptr<XmlDocument> self) {
+    return find_xml_doc(self.address()) != nullptr;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document12getLastChildEy) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZNK3sce3Xml3Dom8Document12getAttrValueEy, Ptr<XmlString> result, Ptr<XmlDocument> self, uint64_t id) {
+    memset(result.get(host.mem), 0, sizeof(XmlString));
+    ResolvedNode at;
+    uint32_t slot = 0;
+    if (resolve_attr(id, at, slot)) {
+        set_string(host, *at.doc, result.get(host.mem), at.doc->nodes[at.index].attrs[slot].second);
+    }
+    return result;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document13getAttributesEyPNS1_8NodeListE) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZNK3sce3Xml3Dom8Document12getAttributeEyPKNS0_6StringE, Ptr<XmlString> result, Ptr<XmlDocument> self, uint64_t id, Ptr<XmlString> name) {
+    memset(result.get(host.mem), 0, sizeof(XmlString));
+    ResolvedNode at;
+    if (resolve_node(id, at)) {
+        const std::string key = string_view_chars(host.mem, name.get(host.mem));
+        for (const auto &attr : at.doc->nodes[at.index].attrs) {
+            if (at.doc->strings[attr.first] == key) {
+                set_string(host, *at.doc, result.get(host.mem), attr.second);
+                break;
+            }
+        }
+    }
+    return result;
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document13getChildNodesEyPNS1_8NodeListE) {
-    return UNIMPLEMENTED();
+EXPORT(uint64_t, _ZNK3sce3Xml3Dom8Document12getFirstAttrEy, Ptr<XmlDocument> self, uint64_t id) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || at.doc->nodes[at.index].attrs.empty()) {
+        return 0;
+    }
+    return attr_handle(*at.doc, at.doc_address, at.index, 0);
+}
+
+EXPORT(uint64_t, _ZNK3sce3Xml3Dom8Document12getLastChildEy, Ptr<XmlDocument> self, uint64_t id) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || !at.doc->nodes[at.index].last_child) {
+        return 0;
+    }
+    return make_node_id(at.doc_address, at.doc->nodes[at.index].last_child);
+}
+
+EXPORT(int, _ZNK3sce3Xml3Dom8Document13getAttributesEyPNS1_8NodeListE, Ptr<XmlDocument> self, uint64_t id, Ptr<XmlNodeList> out) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || !out) {
+        return -1;
+    }
+    node_list_fill_attrs(host, at, out.get(host.mem));
+    return 0;
+}
+
+EXPORT(int, _ZNK3sce3Xml3Dom8Document13getChildNodesEyPNS1_8NodeListE, Ptr<XmlDocument> self, uint64_t id, Ptr<XmlNodeList> out) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || !out) {
+        return -1;
+    }
+    node_list_fill_children(host, at, out.get(host.mem));
+    return 0;
 }
 
 EXPORT(int, _ZNK3sce3Xml3Dom8Document13getEntityTypeEy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8Document13getFirstChildEy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8Document13hasAttributesEy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8Document13hasChildNodesEy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8Document14getSkippedTextEy) {
-    return UNIMPLEMENTED();
+    return 0;
+}
+
+EXPORT(uint64_t, _ZNK3sce3Xml3Dom8Document13getFirstChildEy, Ptr<XmlDocument> self, uint64_t id) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || !at.doc->nodes[at.index].first_child) {
+        return 0;
+    }
+    return make_node_id(at.doc_address, at.doc->nodes[at.index].first_child);
+}
+
+EXPORT(int, _ZNK3sce3Xml3Dom8Document13hasAttributesEy, Ptr<XmlDocument> self, uint64_t id) {
+    ResolvedNode at;
+    return resolve_node(id, at) && !at.doc->nodes[at.index].attrs.empty();
+}
+
+EXPORT(int, _ZNK3sce3Xml3Dom8Document13hasChildNodesEy, Ptr<XmlDocument> self, uint64_t id) {
+    ResolvedNode at;
+    return resolve_node(id, at) && (at.doc->nodes[at.index].first_child != 0);
+}
+
+EXPORT(Ptr<XmlString>, _ZNK3sce3Xml3Dom8Document14getSkippedTextEy, Ptr<XmlString> result, Ptr<XmlDocument> self, uint64_t id) {
+    // Skipped runs are not retained.
+    memset(result.get(host.mem), 0, sizeof(XmlString));
+    return result;
+}
+
+EXPORT(int, _ZNK3sce3Xml3Dom8Document20getElementsByTagNameEyPKNS0_6StringEPNS1_8NodeListE, Ptr<XmlDocument> self, uint64_t id, Ptr<XmlString> name, Ptr<XmlNodeList> out) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || !out) {
+        return -1;
+    }
+    XmlNodeList *list = out.get(host.mem);
+    list->count = 0;
+    const std::string key = string_view_chars(host.mem, name.get(host.mem));
+    std::vector<uint32_t> pending{ at.index };
+    while (!pending.empty()) {
+        const uint32_t index = pending.back();
+        pending.pop_back();
+        const HostXmlNode &node = at.doc->nodes[index];
+        if ((index != at.index) && (node.type == NODE_ELEMENT) && (at.doc->strings[node.name] == key)) {
+            node_list_append(host, list, make_node_id(at.doc_address, index));
+        }
+        // Push in reverse so matches come out in document order.
+        std::vector<uint32_t> children;
+        for (uint32_t child = node.first_child; child; child = at.doc->nodes[child].next) {
+            children.push_back(child);
+        }
+        pending.insert(pending.end(), children.rbegin(), children.rend());
+    }
+    return 0;
+}
+
+EXPORT(uint64_t, _ZNK3sce3Xml3Dom8Document7getRootEv, Ptr<XmlDocument> self) {
+    const HostXmlDocPtr doc = find_xml_doc(self.address());
+    if (!doc || (doc->nodes.size() < 2)) {
+        return 0;
+    }
+    for (uint32_t child = doc->nodes[1].first_child; child; child = doc->nodes[child].next) {
+        if (doc->nodes[child].type == NODE_ELEMENT) {
+            return make_node_id(self.address(), child);
+        }
+    }
+    return 0;
+}
+
+EXPORT(Ptr<XmlString>, _ZNK3sce3Xml3Dom8Document7getTextEy, Ptr<XmlString> result, Ptr<XmlDocument> self, uint64_t id) {
+    memset(result.get(host.mem), 0, sizeof(XmlString));
+    ResolvedNode at;
+    if (resolve_node(id, at)) {
+        const HostXmlNode &node = at.doc->nodes[at.index];
+        uint32_t text = node.text;
+        if (node.type == NODE_ELEMENT) {
+            for (uint32_t child = node.first_child; child; child = at.doc->nodes[child].next) {
+                if (at.doc->nodes[child].type == NODE_TEXT) {
+                    text = at.doc->nodes[child].text;
+                    break;
+                }
+            }
+        }
+        set_string(host, *at.doc, result.get(host.mem), text);
+    }
+    return result;
+}
+
+EXPORT(uint64_t, _ZNK3sce3Xml3Dom8Document9getEntityEy) {
+    return 0;
+}
+
+EXPORT(uint64_t, _ZNK3sce3Xml3Dom8Document9getParentEy, Ptr<XmlDocument> self, uint64_t id) {
+    ResolvedNode at;
+    if (!resolve_node(id, at) || !at.doc->nodes[at.index].parent) {
+        return 0;
+    }
+    return make_node_id(at.doc_address, at.doc->nodes[at.index].parent);
+}
+
+EXPORT(int, _ZNK3sce3Xml3Dom8Document9getStatusEv, Ptr<XmlDocument> self) {
+    const HostXmlDocPtr doc = find_xml_doc(self.address());
+    return doc ? doc->status : -1;
+}
+
+EXPORT(int, _ZNK3sce3Xml3Dom8NodeList11isAvailableEv, Ptr<XmlNodeList> self) {
+    return self.get(host.mem) != nullptr;
+}
+
+EXPORT(uint64_t, _ZNK3sce3Xml3Dom8NodeList4itemEj, Ptr<XmlNodeList> self, uint32_t index) {
+    const XmlNodeList *list = self.get(host.mem);
+    if (!list->items || (index >= list->count)) {
+        return 0;
+    }
+    return Ptr<uint64_t>(list->items).get(host.mem)[index];
+}
+
+EXPORT(uint64_t, _ZNK3sce3Xml3Dom8NodeList8findItemEPKNS0_6StringE, Ptr<XmlNodeList> self, Ptr<XmlString> name) {
+    const std::string key = string_view_chars(host.mem, name.get(host.mem));
+    const XmlNodeList *list = self.get(host.mem);
+    const uint64_t *items = list->items ? Ptr<uint64_t>(list->items).get(host.mem) : nullptr;
+    for (uint32_t i = 0; items && (i < list->count); ++i) {
+        ResolvedNode at;
+        if (resolve_node(items[i], at) && (at.doc->strings[at.doc->nodes[at.index].name] == key)) {
+            return items[i];
+        }
+    }
+    return 0;
+}
+
+EXPORT(uint64_t, _ZNK3sce3Xml3Dom8NodeList8findItemEy, Ptr<XmlNodeList> self, uint64_t id) {
+    const XmlNodeList *list = self.get(host.mem);
+    const uint64_t *items = list->items ? Ptr<uint64_t>(list->items).get(host.mem) : nullptr;
+    for (uint32_t i = 0; items && (i < list->count); ++i) {
+        if (items[i] == id) {
+            return id;
+        }
+    }
+    return 0;
+}
+
+EXPORT(uint32_t, _ZNK3sce3Xml3Dom8NodeList9getLengthEv, Ptr<XmlNodeList> self) {
+    return self.get(host.mem)->count;
+}
+
+EXPORT(uint64_t, _ZNK3sce3Xml3Dom8NodeListixEj, Ptr<XmlNodeList> self, uint32_t index) {
+    const XmlNodeList *list = self.get(host.mem);
+    if (!list->items || (index >= list->count)) {
+        return 0;
+    }
+    return Ptr<uint64_t>(list->items).get(host.mem)[index];
 }
 
-EXPORT(int, _ZNK3sce3Xml3Dom8Document20getElementsByTagNameEyPKNS0_6StringEPNS1_8NodeListE) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8Document7getRootEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8Document7getTextEy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8Document9getEntityEy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8Document9getParentEy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8Document9getStatusEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8NodeList11isAvailableEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8NodeList4itemEj) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8NodeList8findItemEPKNS0_6StringE) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8NodeList8findItemEy) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8NodeList9getLengthEv) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml3Dom8NodeListixEj) {
-    return UNIMPLEMENTED();
-}
-
-EXPORT(int, _ZNK3sce3Xml4Attr11isAvailableEv) {
-    return UNIMPLEMENTED();
+EXPORT(int, _ZNK3sce3Xml4Attr11isAvailableEv, Ptr<XmlAttr> self) {
+    return self.get(host.mem)->name.str != 0;
 }
-
-EXPORT(int, _ZNK3sce3Xml4Attr7getNameEv) {
-    return UNIMPLEMENTED();
+
+EXPORT(Ptr<XmlString>, _ZNK3sce3Xml4Attr7getNameEv, Ptr<XmlString> result, Ptr<XmlAttr> self) {
+    *result.get(host.mem) = self.get(host.mem)->name;
+    return result;
 }
 
-EXPORT(int, _ZNK3sce3Xml4Attr8getValueEv) {
-    return UNIMPLEMENTED();
+EXPORT(Ptr<XmlString>, _ZNK3sce3Xml4Attr8getValueEv, Ptr<XmlString> result, Ptr<XmlAttr> self) {
+    *result.get(host.mem) = self.get(host.mem)->value;
+    return result;
 }
 
 BRIDGE_IMPL(_ZN3sce3Xml10SimpleDataC1EPKcj)
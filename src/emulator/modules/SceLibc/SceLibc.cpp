@@ -16,9 +16,14 @@
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
 #include "SceLibc.h"
+#include "heap.h"
+
 #include <io/functions.h>
 #include <util/log.h>
 
+#include <cstdint>
+#include <cstring>
+
 Ptr<void> g_dso;
 
 EXPORT(int, _Assert) {
@@ -355,8 +360,19 @@ EXPORT(int, c32rtomb) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, calloc) {
-    return UNIMPLEMENTED();
+EXPORT(int, calloc, SceSize nelem, SceSize size) {
+    // The 32-bit multiply can wrap and silently under-allocate.
+    if ((size != 0) && (nelem > UINT32_MAX / size)) {
+        return 0;
+    }
+
+    const Address address = heap_alloc(host.mem, nelem * size);
+    if (address != 0) {
+        // Pooled blocks are recycled, so they are not implicitly zero.
+        std::memset(&host.mem.memory[address], 0, nelem * size);
+    }
+
+    return address;
 }
 
 EXPORT(int, clearerr) {
@@ -469,7 +485,7 @@ EXPORT(int, fread) {
 }
 
 EXPORT(void, free, Address mem) {
-    free(host.mem, mem);
+    heap_free(host.mem, mem);
 }
 
 EXPORT(int, freopen) {
@@ -697,7 +713,7 @@ EXPORT(int, longjmp) {
 }
 
 EXPORT(int, malloc, SceSize size) {
-    return alloc(host.mem, size, "");
+    return heap_alloc(host.mem, size);
 }
 
 EXPORT(int, malloc_stats) {
@@ -708,8 +724,8 @@ EXPORT(int, malloc_stats_fast) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, malloc_usable_size) {
-    return UNIMPLEMENTED();
+EXPORT(int, malloc_usable_size, Address ptr) {
+    return heap_usable_size(host.mem, ptr);
 }
 
 EXPORT(int, mblen) {
@@ -756,8 +772,8 @@ EXPORT(int, mbtowc) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, memalign) {
-    return UNIMPLEMENTED();
+EXPORT(int, memalign, SceSize alignment, SceSize size) {
+    return heap_alloc_aligned(host.mem, alignment, size);
 }
 
 EXPORT(int, memchr) {
@@ -897,8 +913,8 @@ EXPORT(int, rand_r) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, realloc) {
-    return UNIMPLEMENTED();
+EXPORT(int, realloc, Address ptr, SceSize size) {
+    return heap_realloc(host.mem, ptr, size);
 }
 
 EXPORT(int, reallocalign) {
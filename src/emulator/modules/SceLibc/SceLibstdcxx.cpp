@@ -16,6 +16,7 @@
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
 #include "SceLibstdcxx.h"
+#include "heap.h"
 
 EXPORT(int, _Atomic_compare_exchange_strong) {
     return UNIMPLEMENTED();
@@ -4453,44 +4454,52 @@ EXPORT(int, _ZZNSt13basic_filebufIwSt11char_traitsIwEE5_InitEPSt10_Dnk_filetNS2_
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, _ZdaPv) {
-    return UNIMPLEMENTED();
+// operator delete[](void *)
+EXPORT(void, _ZdaPv, Address ptr) {
+    heap_free(host.mem, ptr);
 }
 
-EXPORT(int, _ZdaPvRKSt9nothrow_t) {
-    return UNIMPLEMENTED();
+// operator delete[](void *, const std::nothrow_t &)
+EXPORT(void, _ZdaPvRKSt9nothrow_t, Address ptr) {
+    heap_free(host.mem, ptr);
 }
 
-EXPORT(int, _ZdaPvS_) {
-    return UNIMPLEMENTED();
+// Placement operator delete[](void *, void *) - nothing to release.
+EXPORT(void, _ZdaPvS_) {
 }
 
-EXPORT(int, _ZdlPv) {
-    return UNIMPLEMENTED();
+// operator delete(void *)
+EXPORT(void, _ZdlPv, Address ptr) {
+    heap_free(host.mem, ptr);
 }
 
-EXPORT(int, _ZdlPvRKSt9nothrow_t) {
-    return UNIMPLEMENTED();
+// operator delete(void *, const std::nothrow_t &)
+EXPORT(void, _ZdlPvRKSt9nothrow_t, Address ptr) {
+    heap_free(host.mem, ptr);
 }
 
-EXPORT(int, _ZdlPvS_) {
-    return UNIMPLEMENTED();
+// Placement operator delete(void *, void *) - nothing to release.
+EXPORT(void, _ZdlPvS_) {
 }
 
-EXPORT(int, _Znaj, int test) {
-    return alloc(host.mem, test, "");
+// operator new[](size_t)
+EXPORT(Address, _Znaj, SceSize size) {
+    return heap_alloc(host.mem, size);
 }
 
-EXPORT(int, _ZnajRKSt9nothrow_t) {
-    return UNIMPLEMENTED();
+// operator new[](size_t, const std::nothrow_t &)
+EXPORT(Address, _ZnajRKSt9nothrow_t, SceSize size) {
+    return heap_alloc(host.mem, size);
 }
 
-EXPORT(int, _Znwj, int test) {
-    return alloc(host.mem, test, "");
+// operator new(size_t)
+EXPORT(Address, _Znwj, SceSize size) {
+    return heap_alloc(host.mem, size);
 }
 
-EXPORT(int, _ZnwjRKSt9nothrow_t) {
-    return UNIMPLEMENTED();
+// operator new(size_t, const std::nothrow_t &)
+EXPORT(Address, _ZnwjRKSt9nothrow_t, SceSize size) {
+    return heap_alloc(host.mem, size);
 }
 
 EXPORT(int, __cxa_allocate_exception) {
@@ -0,0 +1,192 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include "heap.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Size classes double from 16 bytes to 4KiB; anything larger goes straight
+// to the page allocator. Chunks are carved into blocks of one class, so a
+// block's alignment equals its class size.
+static constexpr SceSize SMALLEST_CLASS = 16;
+static constexpr SceSize LARGEST_CLASS = 4096;
+static constexpr size_t CLASS_COUNT = 9; // 16, 32, ..., 4096
+static constexpr SceSize CHUNK_SIZE = 64 * 1024;
+
+static const char *const HEAP_NAME = "SceLibc heap";
+
+struct HeapState {
+    std::mutex mutex;
+    std::vector<Address> free_lists[CLASS_COUNT];
+    std::map<Address, size_t> chunk_classes; // chunk base -> size class index
+    std::map<Address, SceSize> large_blocks; // base -> requested size
+};
+
+static HeapState heap;
+
+static size_t class_index_for(SceSize size) {
+    size_t index = 0;
+    SceSize class_size = SMALLEST_CLASS;
+    while (class_size < size) {
+        class_size *= 2;
+        ++index;
+    }
+
+    return index;
+}
+
+static SceSize class_size_of(size_t index) {
+    return SMALLEST_CLASS << index;
+}
+
+// Returns the class index of the pooled block at address, or CLASS_COUNT if
+// the address does not belong to any chunk.
+static size_t find_block_class(const HeapState &state, Address address) {
+    std::map<Address, size_t>::const_iterator chunk = state.chunk_classes.upper_bound(address);
+    if (chunk == state.chunk_classes.begin()) {
+        return CLASS_COUNT;
+    }
+    --chunk;
+    if (address >= chunk->first + CHUNK_SIZE) {
+        return CLASS_COUNT;
+    }
+
+    return chunk->second;
+}
+
+Address heap_alloc(MemState &mem, SceSize size) {
+    if (size == 0) {
+        size = 1;
+    }
+    if (size > LARGEST_CLASS) {
+        const std::lock_guard<std::mutex> lock(heap.mutex);
+        const Address address = alloc(mem, size, HEAP_NAME);
+        if (address != 0) {
+            heap.large_blocks.emplace(address, size);
+        }
+        return address;
+    }
+
+    const size_t index = class_index_for(size);
+
+    const std::lock_guard<std::mutex> lock(heap.mutex);
+    std::vector<Address> &free_list = heap.free_lists[index];
+    if (free_list.empty()) {
+        const Address chunk = alloc(mem, CHUNK_SIZE, HEAP_NAME);
+        if (chunk == 0) {
+            return 0;
+        }
+        heap.chunk_classes.emplace(chunk, index);
+
+        const SceSize block_size = class_size_of(index);
+        free_list.reserve(CHUNK_SIZE / block_size);
+        for (SceSize offset = 0; offset < CHUNK_SIZE; offset += block_size) {
+            free_list.push_back(chunk + offset);
+        }
+    }
+
+    const Address address = free_list.back();
+    free_list.pop_back();
+
+    return address;
+}
+
+Address heap_alloc_aligned(MemState &mem, SceSize alignment, SceSize size) {
+    assert((alignment & (alignment - 1)) == 0);
+
+    // Pooled blocks are aligned to their class size and page allocations to
+    // the page size, so rounding the request up covers every alignment we
+    // can express.
+    if (alignment > mem.page_size) {
+        return 0;
+    }
+
+    return heap_alloc(mem, std::max(alignment, size));
+}
+
+void heap_free(MemState &mem, Address address) {
+    if (address == 0) {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock(heap.mutex);
+
+    const std::map<Address, SceSize>::iterator large = heap.large_blocks.find(address);
+    if (large != heap.large_blocks.end()) {
+        heap.large_blocks.erase(large);
+        free(mem, address);
+        return;
+    }
+
+    const size_t index = find_block_class(heap, address);
+    assert(index < CLASS_COUNT);
+    if (index >= CLASS_COUNT) {
+        return; // not ours - tolerate a stray pointer rather than corrupt a pool
+    }
+
+    heap.free_lists[index].push_back(address);
+}
+
+SceSize heap_usable_size(const MemState &mem, Address address) {
+    if (address == 0) {
+        return 0;
+    }
+
+    const std::lock_guard<std::mutex> lock(heap.mutex);
+
+    const std::map<Address, SceSize>::const_iterator large = heap.large_blocks.find(address);
+    if (large != heap.large_blocks.end()) {
+        return large->second;
+    }
+
+    const size_t index = find_block_class(heap, address);
+    if (index >= CLASS_COUNT) {
+        return 0;
+    }
+
+    return class_size_of(index);
+}
+
+Address heap_realloc(MemState &mem, Address address, SceSize size) {
+    if (address == 0) {
+        return heap_alloc(mem, size);
+    }
+    if (size == 0) {
+        heap_free(mem, address);
+        return 0;
+    }
+
+    const SceSize usable = heap_usable_size(mem, address);
+    if (size <= usable) {
+        return address;
+    }
+
+    const Address resized = heap_alloc(mem, size);
+    if (resized == 0) {
+        return 0;
+    }
+
+    std::memcpy(&mem.memory[resized], &mem.memory[address], usable);
+    heap_free(mem, address);
+
+    return resized;
+}
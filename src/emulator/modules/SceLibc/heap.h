@@ -0,0 +1,31 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <mem/mem.h>
+
+#include <psp2/types.h>
+
+// Segregated-fit heap backing the SceLibc malloc family. Blocks live in
+// guest memory but all bookkeeping is host-side, so a guest allocation costs
+// no emulated instructions. Thread-safe.
+Address heap_alloc(MemState &mem, SceSize size);
+Address heap_alloc_aligned(MemState &mem, SceSize alignment, SceSize size);
+void heap_free(MemState &mem, Address address);
+Address heap_realloc(MemState &mem, Address address, SceSize size);
+SceSize heap_usable_size(const MemState &mem, Address address);
@@ -23,6 +23,7 @@
 #endif
 #include <psp2/net/net.h>
 
+#include <kernel/functions.h>
 #include <net/functions.h>
 
 #ifndef WIN32
@@ -181,28 +182,47 @@ EXPORT(int, sceNetEmulationSet) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceNetEpollAbort) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceNetEpollAbort, int eid, int flags) {
+    if (abort_epoll(host.net, eid) < 0) {
+        return RET_ERROR(SCE_NET_ERROR_EBADF);
+    }
+    return 0;
 }
 
-EXPORT(int, sceNetEpollControl) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceNetEpollControl, int eid, int op, int id, SceNetEpollEvent *event) {
+    if (control_epoll(host.net, eid, op, id, event) < 0) {
+        return RET_ERROR(SCE_NET_ERROR_EINVAL);
+    }
+    return 0;
 }
 
-EXPORT(int, sceNetEpollCreate) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceNetEpollCreate, const char *name, int flags) {
+    return create_epoll(host.net);
 }
 
-EXPORT(int, sceNetEpollDestroy) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceNetEpollDestroy, int eid) {
+    if (destroy_epoll(host.net, eid) < 0) {
+        return RET_ERROR(SCE_NET_ERROR_EBADF);
+    }
+    return 0;
 }
 
-EXPORT(int, sceNetEpollWait) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceNetEpollWait, int eid, SceNetEpollEvent *events, int n, int timeout) {
+    const int res = wait_epoll(host.net, eid, events, n, timeout);
+    if (res < 0) {
+        return RET_ERROR(translate_errorcode());
+    }
+    return res;
 }
 
-EXPORT(int, sceNetEpollWaitCB) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceNetEpollWaitCB, int eid, SceNetEpollEvent *events, int n, int timeout) {
+    // The CB variant is a callback check point for the waiting thread.
+    deliver_pending_callbacks(host.kernel, export_name, thread_id);
+    const int res = wait_epoll(host.net, eid, events, n, timeout);
+    if (res < 0) {
+        return RET_ERROR(translate_errorcode());
+    }
+    return res;
 }
 
 EXPORT(int, sceNetErrnoLoc) {
@@ -344,20 +364,31 @@ EXPORT(int, sceNetRecvmsg) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sceNetResolverAbort) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceNetResolverAbort, int rid, int flags) {
+    if (abort_resolver(host.net, rid) < 0) {
+        return RET_ERROR(SCE_NET_ERROR_EINVAL);
+    }
+    return 0;
 }
 
-EXPORT(int, sceNetResolverCreate) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceNetResolverCreate, const char *name, void *param, int flags) {
+    return create_resolver(host.net);
 }
 
-EXPORT(int, sceNetResolverDestroy) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceNetResolverDestroy, int rid) {
+    if (destroy_resolver(host.net, rid) < 0) {
+        return RET_ERROR(SCE_NET_ERROR_EINVAL);
+    }
+    return 0;
 }
 
-EXPORT(int, sceNetResolverGetError) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceNetResolverGetError, int rid, int *result) {
+    int error = 0;
+    if ((result == nullptr) || (get_resolver_error(host.net, rid, error) < 0)) {
+        return RET_ERROR(SCE_NET_ERROR_EINVAL);
+    }
+    *result = error;
+    return 0;
 }
 
 EXPORT(int, sceNetResolverStartAton, int rid, const SceNetInAddr *addr, char *hostname, int len, int timeout, int retry, int flags) {
@@ -367,9 +398,18 @@ EXPORT(int, sceNetResolverStartAton, int rid, const SceNetInAddr *addr, char *ho
 }
 
 EXPORT(int, sceNetResolverStartNtoa, int rid, const char *hostname, SceNetInAddr *addr, int timeout, int retry, int flags) {
-    struct hostent *resolved = gethostbyname(hostname);
-    memcpy(addr, resolved->h_addr, sizeof(uint32_t));
-    return 0;
+    uint32_t resolved = 0;
+    switch (resolver_ntoa(host.net, rid, hostname, resolved, timeout)) {
+    case 0:
+        addr->s_addr = resolved;
+        return 0;
+    case -2:
+        return RET_ERROR(SCE_NET_ERROR_EINTR);
+    case -3:
+        return RET_ERROR(SCE_NET_ERROR_EADDRNOTAVAIL);
+    default:
+        return RET_ERROR(SCE_NET_ERROR_EINVAL);
+    }
 }
 
 EXPORT(int, sceNetSend, int s, const void *msg, unsigned int len, int flags) {
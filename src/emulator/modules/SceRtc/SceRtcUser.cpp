@@ -119,7 +119,9 @@ EXPORT(int, sceRtcGetCurrentTick, SceRtcTick *tick) {
         return RET_ERROR(SCE_RTC_ERROR_INVALID_POINTER);
     }
 
-    tick->tick = rtc_get_ticks(host.kernel.base_tick.tick);
+    // Coarse is fine here too - the RTC tick unit is 1 us but no title can
+    // act on wall-clock time at better than the 100 us cache quantum.
+    tick->tick = rtc_get_ticks_coarse(host.kernel.coarse_time, host.kernel.base_tick.tick);
 
     return 0;
 }
@@ -17,8 +17,155 @@
 
 #include "SceSqlite.h"
 
+#ifdef USE_HOST_SQLITE
+
+#include "../SceLibc/heap.h"
+
+#include <io/functions.h>
+#include <io/state.h>
+
+#include <sqlite3.h>
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Guest code treats sqlite3* and sqlite3_stmt* as opaque words it only ever
+// passes back, so connections and statements are bridged as small tokens
+// into host-side tables and all database work runs on the host library.
+// Result text is copied into guest memory from the SceLibc heap; statement
+// copies are recycled on the next step/reset/finalize of the owning
+// statement, matching the lifetime sqlite documents for column pointers.
+
+// Applied to every connection at open. The Vita module defaults to a tiny
+// page cache; on the host a couple of MiB per database is cheap and keeps
+// B-tree pages out of the VFS entirely.
+static constexpr int CACHE_SIZE_KIB = 2048;
+
+struct GuestDb {
+    sqlite3 *db = nullptr;
+    Address errmsg = 0; // guest copy of the last sqlite3_errmsg result
+};
+
+struct GuestStmt {
+    sqlite3_stmt *stmt = nullptr;
+    std::vector<Address> row_allocs;
+};
+
+struct SqliteState {
+    std::mutex mutex;
+    int next_handle = 1;
+    std::map<int, GuestDb> dbs;
+    std::map<int, GuestStmt> stmts;
+};
+
+static SqliteState state;
+
+static GuestDb *find_db(int handle) {
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    const auto db = state.dbs.find(handle);
+    return (db != state.dbs.end()) ? &db->second : nullptr;
+}
+
+static GuestStmt *find_stmt(int handle) {
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    const auto stmt = state.stmts.find(handle);
+    return (stmt != state.stmts.end()) ? &stmt->second : nullptr;
+}
+
+static void free_row_allocs(MemState &mem, GuestStmt &stmt) {
+    for (const Address address : stmt.row_allocs) {
+        heap_free(mem, address);
+    }
+    stmt.row_allocs.clear();
+}
+
+// Copies size bytes plus a terminator into guest memory.
+static Address copy_to_guest(MemState &mem, const void *data, size_t size) {
+    const Address address = heap_alloc(mem, static_cast<SceSize>(size + 1));
+    if (address) {
+        memcpy(&mem.memory[address], data, size);
+        mem.memory[address + size] = 0;
+    }
+    return address;
+}
+
+static int open_host_db(HostState &host, const char *filename, Ptr<int> db_out, int flags) {
+    // ":memory:" and empty (temporary) names pass through; anything else is
+    // a guest path that maps to its host location.
+    std::string host_path = filename ? filename : "";
+    if (!host_path.empty() && (host_path[0] != ':')) {
+        const TranslatedPath &translated = translate_path_cached(host.io, host_path);
+        host_path = to_host_path(translated.path, host.pref_path, translated.device);
+    }
+
+    sqlite3 *db = nullptr;
+    const int err = sqlite3_open_v2(host_path.c_str(), &db, flags, nullptr);
+
+    int handle = 0;
+    if (db) {
+        char pragma[64];
+        snprintf(pragma, sizeof(pragma), "PRAGMA cache_size=-%d;", CACHE_SIZE_KIB);
+        sqlite3_exec(db, pragma, nullptr, nullptr, nullptr);
+
+        GuestDb guest_db;
+        guest_db.db = db;
+
+        const std::lock_guard<std::mutex> lock(state.mutex);
+        handle = state.next_handle++;
+        state.dbs.emplace(handle, guest_db);
+    }
+    if (db_out) {
+        *db_out.get(host.mem) = handle;
+    }
+
+    return err;
+}
+
+static int prepare_host_stmt(HostState &host, int db_handle, Ptr<const char> sql, int nbyte, Ptr<int> stmt_out, Ptr<Ptr<const char>> tail_out) {
+    GuestDb *const guest_db = find_db(db_handle);
+    if (!guest_db) {
+        return SQLITE_MISUSE;
+    }
+
+    const char *const sql_host = sql.get(host.mem);
+    sqlite3_stmt *stmt = nullptr;
+    const char *tail = nullptr;
+    const int err = sqlite3_prepare_v2(guest_db->db, sql_host, nbyte, &stmt, &tail);
+
+    int handle = 0;
+    if (stmt) {
+        GuestStmt guest_stmt;
+        guest_stmt.stmt = stmt;
+
+        const std::lock_guard<std::mutex> lock(state.mutex);
+        handle = state.next_handle++;
+        state.stmts.emplace(handle, guest_stmt);
+    }
+    if (stmt_out) {
+        *stmt_out.get(host.mem) = handle;
+    }
+    if (tail_out) {
+        // The tail points into the guest's own sql buffer.
+        const Address guest_tail = tail ? (sql.address() + static_cast<Address>(tail - sql_host)) : 0;
+        *tail_out.get(host.mem) = Ptr<const char>(guest_tail);
+    }
+
+    return err;
+}
+
+#endif // USE_HOST_SQLITE
+
 EXPORT(int, sceSqliteConfigMallocMethods) {
+#ifdef USE_HOST_SQLITE
+    // The host library uses the host allocator; guest malloc methods would
+    // only ever see guest addresses.
+    return STUBBED("not used with host-backed sqlite");
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_aggregate_context) {
@@ -53,28 +200,74 @@ EXPORT(int, sqlite3_backup_step) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_bind_blob) {
+EXPORT(int, sqlite3_bind_blob, int stmt_handle, int index, const void *value, int size, Ptr<void> destructor) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    (void)destructor;
+    return sqlite3_bind_blob(guest_stmt->stmt, index, value, size, SQLITE_TRANSIENT);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_bind_double) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_bind_int) {
+EXPORT(int, sqlite3_bind_int, int stmt_handle, int index, int value) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_bind_int(guest_stmt->stmt, index, value);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
-EXPORT(int, sqlite3_bind_int64) {
+EXPORT(int, sqlite3_bind_int64, int stmt_handle, int index, uint64_t value) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_bind_int64(guest_stmt->stmt, index, static_cast<sqlite3_int64>(value));
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
-EXPORT(int, sqlite3_bind_null) {
+EXPORT(int, sqlite3_bind_null, int stmt_handle, int index) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_bind_null(guest_stmt->stmt, index);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
-EXPORT(int, sqlite3_bind_parameter_count) {
+EXPORT(int, sqlite3_bind_parameter_count, int stmt_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_bind_parameter_count(guest_stmt->stmt);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_bind_parameter_index) {
@@ -85,8 +278,19 @@ EXPORT(int, sqlite3_bind_parameter_name) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_bind_text) {
+EXPORT(int, sqlite3_bind_text, int stmt_handle, int index, const char *value, int size, Ptr<void> destructor) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    // The value is copied host-side, so the guest destructor never runs.
+    (void)destructor;
+    return sqlite3_bind_text(guest_stmt->stmt, index, value, size, SQLITE_TRANSIENT);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_bind_text16) {
@@ -125,20 +329,65 @@ EXPORT(int, sqlite3_busy_handler) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_busy_timeout) {
+EXPORT(int, sqlite3_busy_timeout, int db_handle, int ms) {
+#ifdef USE_HOST_SQLITE
+    GuestDb *const guest_db = find_db(db_handle);
+    if (!guest_db) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_busy_timeout(guest_db->db, ms);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
-EXPORT(int, sqlite3_changes) {
+EXPORT(int, sqlite3_changes, int db_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestDb *const guest_db = find_db(db_handle);
+    if (!guest_db) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_changes(guest_db->db);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
-EXPORT(int, sqlite3_clear_bindings) {
+EXPORT(int, sqlite3_clear_bindings, int stmt_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_clear_bindings(guest_stmt->stmt);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
-EXPORT(int, sqlite3_close) {
+EXPORT(int, sqlite3_close, int db_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestDb *const guest_db = find_db(db_handle);
+    if (!guest_db) {
+        return SQLITE_MISUSE;
+    }
+
+    const int err = sqlite3_close(guest_db->db);
+    if (err == SQLITE_OK) {
+        if (guest_db->errmsg) {
+            heap_free(host.mem, guest_db->errmsg);
+        }
+        const std::lock_guard<std::mutex> lock(state.mutex);
+        state.dbs.erase(db_handle);
+    }
+
+    return err;
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_collation_needed) {
@@ -149,20 +398,58 @@ EXPORT(int, sqlite3_collation_needed16) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_column_blob) {
+EXPORT(Ptr<const void>, sqlite3_column_blob, int stmt_handle, int col) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return Ptr<const void>();
+    }
+
+    const void *const blob = sqlite3_column_blob(guest_stmt->stmt, col);
+    if (!blob) {
+        return Ptr<const void>();
+    }
+
+    const int size = sqlite3_column_bytes(guest_stmt->stmt, col);
+    const Address address = copy_to_guest(host.mem, blob, static_cast<size_t>(size));
+    if (address) {
+        guest_stmt->row_allocs.push_back(address);
+    }
+
+    return Ptr<const void>(address);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
-EXPORT(int, sqlite3_column_bytes) {
+EXPORT(int, sqlite3_column_bytes, int stmt_handle, int col) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_column_bytes(guest_stmt->stmt, col);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_column_bytes16) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_column_count) {
+EXPORT(int, sqlite3_column_count, int stmt_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_column_count(guest_stmt->stmt);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_column_decltype) {
@@ -177,32 +464,98 @@ EXPORT(int, sqlite3_column_double) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_column_int) {
+EXPORT(int, sqlite3_column_int, int stmt_handle, int col) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_column_int(guest_stmt->stmt, col);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
-EXPORT(int, sqlite3_column_int64) {
+EXPORT(uint64_t, sqlite3_column_int64, int stmt_handle, int col) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return 0;
+    }
+
+    return static_cast<uint64_t>(sqlite3_column_int64(guest_stmt->stmt, col));
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
-EXPORT(int, sqlite3_column_name) {
+EXPORT(Ptr<const char>, sqlite3_column_name, int stmt_handle, int col) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return Ptr<const char>();
+    }
+
+    const char *const name = sqlite3_column_name(guest_stmt->stmt, col);
+    if (!name) {
+        return Ptr<const char>();
+    }
+
+    const Address address = copy_to_guest(host.mem, name, strlen(name));
+    if (address) {
+        guest_stmt->row_allocs.push_back(address);
+    }
+
+    return Ptr<const char>(address);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_column_name16) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_column_text) {
+EXPORT(Ptr<const char>, sqlite3_column_text, int stmt_handle, int col) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return Ptr<const char>();
+    }
+
+    const unsigned char *const text = sqlite3_column_text(guest_stmt->stmt, col);
+    if (!text) {
+        return Ptr<const char>();
+    }
+
+    const int size = sqlite3_column_bytes(guest_stmt->stmt, col);
+    const Address address = copy_to_guest(host.mem, text, static_cast<size_t>(size));
+    if (address) {
+        guest_stmt->row_allocs.push_back(address);
+    }
+
+    return Ptr<const char>(address);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_column_text16) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_column_type) {
+EXPORT(int, sqlite3_column_type, int stmt_handle, int col) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_column_type(guest_stmt->stmt, col);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_column_value) {
@@ -257,8 +610,17 @@ EXPORT(int, sqlite3_create_module_v2) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_data_count) {
+EXPORT(int, sqlite3_data_count, int stmt_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_data_count(guest_stmt->stmt);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_db_config) {
@@ -289,28 +651,86 @@ EXPORT(int, sqlite3_enable_shared_cache) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_errcode) {
+EXPORT(int, sqlite3_errcode, int db_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestDb *const guest_db = find_db(db_handle);
+    if (!guest_db) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_errcode(guest_db->db);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
-EXPORT(int, sqlite3_errmsg) {
+EXPORT(Ptr<const char>, sqlite3_errmsg, int db_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestDb *const guest_db = find_db(db_handle);
+    if (!guest_db) {
+        return Ptr<const char>();
+    }
+
+    // One guest copy per connection, recycled on the next call - sqlite
+    // only guarantees the message until the next API call anyway.
+    if (guest_db->errmsg) {
+        heap_free(host.mem, guest_db->errmsg);
+    }
+    const char *const errmsg = sqlite3_errmsg(guest_db->db);
+    guest_db->errmsg = copy_to_guest(host.mem, errmsg, strlen(errmsg));
+
+    return Ptr<const char>(guest_db->errmsg);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_errmsg16) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_exec) {
+EXPORT(int, sqlite3_exec, int db_handle, const char *sql, Ptr<void> callback, Ptr<void> callback_arg, Ptr<Ptr<char>> errmsg_out) {
+#ifdef USE_HOST_SQLITE
+    GuestDb *const guest_db = find_db(db_handle);
+    if (!guest_db) {
+        return SQLITE_MISUSE;
+    }
+    if (callback) {
+        // Guest row callbacks would need a CPU re-entry per row.
+        STUBBED("row callback not invoked");
+    }
+    (void)callback_arg;
+
+    char *errmsg = nullptr;
+    const int err = sqlite3_exec(guest_db->db, sql, nullptr, nullptr, errmsg_out ? &errmsg : nullptr);
+    if (errmsg_out) {
+        // The guest frees this through sqlite3_free, which is heap_free.
+        const Address guest_errmsg = errmsg ? copy_to_guest(host.mem, errmsg, strlen(errmsg)) : 0;
+        *errmsg_out.get(host.mem) = Ptr<char>(guest_errmsg);
+        sqlite3_free(errmsg);
+    }
+
+    return err;
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_expired) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_extended_errcode) {
+EXPORT(int, sqlite3_extended_errcode, int db_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestDb *const guest_db = find_db(db_handle);
+    if (!guest_db) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_extended_errcode(guest_db->db);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_extended_result_codes) {
@@ -321,20 +741,50 @@ EXPORT(int, sqlite3_file_control) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_finalize) {
+EXPORT(int, sqlite3_finalize, int stmt_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    free_row_allocs(host.mem, *guest_stmt);
+    const int err = sqlite3_finalize(guest_stmt->stmt);
+
+    const std::lock_guard<std::mutex> lock(state.mutex);
+    state.stmts.erase(stmt_handle);
+
+    return err;
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
-EXPORT(int, sqlite3_free) {
+EXPORT(void, sqlite3_free, Address ptr) {
+#ifdef USE_HOST_SQLITE
+    if (ptr) {
+        heap_free(host.mem, ptr);
+    }
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_free_table) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_get_autocommit) {
+EXPORT(int, sqlite3_get_autocommit, int db_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestDb *const guest_db = find_db(db_handle);
+    if (!guest_db) {
+        return SQLITE_MISUSE;
+    }
+
+    return sqlite3_get_autocommit(guest_db->db);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_get_auxdata) {
@@ -357,8 +807,17 @@ EXPORT(int, sqlite3_interrupt) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_last_insert_rowid) {
+EXPORT(uint64_t, sqlite3_last_insert_rowid, int db_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestDb *const guest_db = find_db(db_handle);
+    if (!guest_db) {
+        return 0;
+    }
+
+    return static_cast<uint64_t>(sqlite3_last_insert_rowid(guest_db->db));
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_libversion) {
@@ -366,7 +825,11 @@ EXPORT(int, sqlite3_libversion) {
 }
 
 EXPORT(int, sqlite3_libversion_number) {
+#ifdef USE_HOST_SQLITE
+    return SQLITE_VERSION_NUMBER;
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_limit) {
@@ -377,8 +840,16 @@ EXPORT(int, sqlite3_load_extension) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_malloc) {
+EXPORT(Address, sqlite3_malloc, int size) {
+#ifdef USE_HOST_SQLITE
+    if (size <= 0) {
+        return 0;
+    }
+
+    return heap_alloc(host.mem, static_cast<SceSize>(size));
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_memory_alarm) {
@@ -421,16 +892,26 @@ EXPORT(int, sqlite3_next_stmt) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_open) {
+EXPORT(int, sqlite3_open, const char *filename, Ptr<int> db_out) {
+#ifdef USE_HOST_SQLITE
+    return open_host_db(host, filename, db_out, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_open16) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_open_v2) {
+EXPORT(int, sqlite3_open_v2, const char *filename, Ptr<int> db_out, int flags, const char *vfs) {
+#ifdef USE_HOST_SQLITE
+    // The guest VFS name is meaningless on the host.
+    (void)vfs;
+    return open_host_db(host, filename, db_out, flags);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_os_end) {
@@ -445,8 +926,13 @@ EXPORT(int, sqlite3_overload_function) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_prepare) {
+EXPORT(int, sqlite3_prepare, int db_handle, Ptr<const char> sql, int nbyte, Ptr<int> stmt_out, Ptr<Ptr<const char>> tail_out) {
+#ifdef USE_HOST_SQLITE
+    // The legacy entry point only differs in error reporting details.
+    return prepare_host_stmt(host, db_handle, sql, nbyte, stmt_out, tail_out);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_prepare16) {
@@ -457,8 +943,12 @@ EXPORT(int, sqlite3_prepare16_v2) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_prepare_v2) {
+EXPORT(int, sqlite3_prepare_v2, int db_handle, Ptr<const char> sql, int nbyte, Ptr<int> stmt_out, Ptr<Ptr<const char>> tail_out) {
+#ifdef USE_HOST_SQLITE
+    return prepare_host_stmt(host, db_handle, sql, nbyte, stmt_out, tail_out);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_profile) {
@@ -481,8 +971,18 @@ EXPORT(int, sqlite3_release_memory) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_reset) {
+EXPORT(int, sqlite3_reset, int stmt_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    free_row_allocs(host.mem, *guest_stmt);
+    return sqlite3_reset(guest_stmt->stmt);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_reset_auto_extension) {
@@ -593,8 +1093,18 @@ EXPORT(int, sqlite3_status) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, sqlite3_step) {
+EXPORT(int, sqlite3_step, int stmt_handle) {
+#ifdef USE_HOST_SQLITE
+    GuestStmt *const guest_stmt = find_stmt(stmt_handle);
+    if (!guest_stmt) {
+        return SQLITE_MISUSE;
+    }
+
+    free_row_allocs(host.mem, *guest_stmt);
+    return sqlite3_step(guest_stmt->stmt);
+#else
     return UNIMPLEMENTED();
+#endif
 }
 
 EXPORT(int, sqlite3_stmt_status) {
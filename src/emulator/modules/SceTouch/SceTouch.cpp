@@ -19,36 +19,68 @@
 
 #include <psp2/touch.h>
 
-#include <SDL_mouse.h>
-#include <SDL_video.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+// The main loop samples both panels at the panel rate into host.touch
+// (see sample_touch in host.cpp); these exports only serve from that ring.
+// Peek snapshots the most recent samples, read drains the samples produced
+// since the port's previous read, blocking on the next sampling tick when
+// none are pending - matching the real driver, where read paces callers to
+// the panel instead of resampling on demand.
+
+// Copy `count` consecutive samples ending at `last_seq`, oldest first.
+// Caller holds host.touch.mutex.
+static void copy_samples(const TouchState &touch, SceUInt32 port, uint64_t last_seq, uint64_t count, SceTouchData *pData) {
+    for (uint64_t i = 0; i < count; ++i) {
+        const uint64_t seq = last_seq - count + 1 + i;
+        pData[i] = touch.ring[port][seq % TouchState::ring_size];
+    }
+}
+
+static int peek_touch(HostState &host, SceUInt32 port, SceTouchData *pData, SceUInt32 nBufs) {
+    TouchState &touch = host.touch;
+    std::unique_lock<std::mutex> lock(touch.mutex);
 
-// TODO Move elsewhere.
-static uint64_t timestamp;
+    if (touch.sample_seq == 0) {
+        // Nothing sampled yet - report an empty panel rather than blocking.
+        memset(pData, 0, sizeof(*pData));
+        return 1;
+    }
 
-static int peek_touch(HostState &host, SceUInt32 port, SceTouchData *pData) {
-    memset(pData, 0, sizeof(*pData));
-    pData->timeStamp = timestamp++; // TODO Use the real time and units.
+    const uint64_t count = std::min<uint64_t>({ nBufs, TouchState::ring_size, touch.sample_seq });
+    copy_samples(touch, port, touch.sample_seq, count, pData);
 
-    int window_x = 0;
-    int window_y = 0;
-    const uint32_t buttons = SDL_GetMouseState(&window_x, &window_y);
+    return static_cast<int>(count);
+}
 
-    int window_w = 0;
-    int window_h = 0;
-    SDL_Window *const window = SDL_GetMouseFocus();
-    SDL_GetWindowSize(window, &window_w, &window_h);
+static int read_touch(HostState &host, SceUInt32 port, SceTouchData *pData, SceUInt32 nBufs) {
+    TouchState &touch = host.touch;
+    std::unique_lock<std::mutex> lock(touch.mutex);
 
-    const float normalised_x = window_x / static_cast<float>(window_w);
-    const float normalised_y = window_y / static_cast<float>(window_h);
+    // Wait for a sample this port has not consumed yet. The timeout keeps a
+    // guest thread from hanging if the main loop stalls; on expiry we fall
+    // back to re-reporting the newest sample, peek-style.
+    const bool ticked = touch.condvar.wait_for(lock, std::chrono::milliseconds(100), [&]() {
+        return touch.sample_seq > touch.read_seq[port];
+    });
 
-    const uint32_t mask = (port == 1) ? SDL_BUTTON_RMASK : SDL_BUTTON_LMASK;
-    if ((buttons & mask) && (host.gui.renderer_focused)) {
-        pData->report[pData->reportNum].x = static_cast<uint16_t>(normalised_x * 1920);
-        pData->report[pData->reportNum].y = static_cast<uint16_t>(normalised_y * 1088);
-        ++pData->reportNum;
+    if (!ticked) {
+        if (touch.sample_seq == 0) {
+            memset(pData, 0, sizeof(*pData));
+            return 1;
+        }
+        copy_samples(touch, port, touch.sample_seq, 1, pData);
+        return 1;
     }
 
-    return 0;
+    const uint64_t pending = touch.sample_seq - touch.read_seq[port];
+    const uint64_t count = std::min<uint64_t>({ pending, nBufs, TouchState::ring_size });
+    copy_samples(touch, port, touch.sample_seq, count, pData);
+    touch.read_seq[port] = touch.sample_seq;
+
+    return static_cast<int>(count);
 }
 
 EXPORT(int, sceTouchActivateRegion) {
@@ -107,18 +139,18 @@ EXPORT(int, sceTouchPeek, SceUInt32 port, SceTouchData *pData, SceUInt32 nBufs)
     assert(port >= 0);
     assert(port <= 1);
     assert(pData != nullptr);
-    assert(nBufs == 1);
+    assert(nBufs >= 1);
 
-    return peek_touch(host, port, pData);
+    return peek_touch(host, port, pData, nBufs);
 }
 
 EXPORT(int, sceTouchPeek2, SceUInt32 port, SceTouchData *pData, SceUInt32 nBufs) {
     assert(port >= 0);
     assert(port <= 1);
     assert(pData != nullptr);
-    assert(nBufs == 1);
+    assert(nBufs >= 1);
 
-    return peek_touch(host, port, pData);
+    return peek_touch(host, port, pData, nBufs);
 }
 
 EXPORT(int, sceTouchPeekRegion) {
@@ -133,18 +165,18 @@ EXPORT(int, sceTouchRead, SceUInt32 port, SceTouchData *pData, SceUInt32 nBufs)
     assert(port >= 0);
     assert(port <= 1);
     assert(pData != nullptr);
-    assert(nBufs == 1);
+    assert(nBufs >= 1);
 
-    return peek_touch(host, port, pData);
+    return read_touch(host, port, pData, nBufs);
 }
 
 EXPORT(int, sceTouchRead2, SceUInt32 port, SceTouchData *pData, SceUInt32 nBufs) {
     assert(port >= 0);
     assert(port <= 1);
     assert(pData != nullptr);
-    assert(nBufs == 1);
+    assert(nBufs >= 1);
 
-    return peek_touch(host, port, pData);
+    return read_touch(host, port, pData, nBufs);
 }
 
 EXPORT(int, sceTouchReadRegion) {
@@ -18,6 +18,7 @@
 #pragma once
 
 struct NetState;
+struct SceNetEpollEvent;
 struct SceNetSockaddr;
 
 bool init(NetState &state);
@@ -31,3 +32,22 @@ int set_socket_options(NetState &net, int s, int level, int optname, const void
 int connect_socket(NetState &net, int s, const SceNetSockaddr *name, unsigned int namelen);
 int accept_socket(NetState &net, int s, SceNetSockaddr *addr, unsigned int *addrlen);
 int listen_socket(NetState &net, int s, int backlog);
+int create_epoll(NetState &net);
+int destroy_epoll(NetState &net, int eid);
+int abort_epoll(NetState &net, int eid);
+int control_epoll(NetState &net, int eid, int op, int s, const SceNetEpollEvent *event);
+// Blocks in one host poll spanning every registered socket. The timeout is
+// in microseconds, negative waits forever. Returns the number of events
+// written, 0 on timeout, or -1 with the host error set - an aborted wait
+// reports EINTR.
+int wait_epoll(NetState &net, int eid, SceNetEpollEvent *events, int n, int timeout_us);
+int create_resolver(NetState &net);
+int destroy_resolver(NetState &net, int rid);
+int abort_resolver(NetState &net, int rid);
+// Name lookup through the shared TTL cache, resolving on a worker thread on
+// a miss so only the calling thread waits and an abort takes effect mid
+// lookup. addr comes back in network byte order. Returns 0 on success, -1
+// on a bad id or argument, -2 on timeout or abort, -3 when the name does
+// not resolve.
+int resolver_ntoa(NetState &net, int rid, const char *hostname, uint32_t &addr, int timeout_s);
+int get_resolver_error(NetState &net, int rid, int &error);
@@ -17,7 +17,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #ifdef WIN32
 #define NOMINMAX
@@ -49,10 +57,99 @@ namespace emu {
 typedef std::map<int, abs_socket> sockets;
 typedef std::map<int, emu::SceNetCtlCallback> callbacks;
 
+// What a title registered a socket for in one of its sceNetEpoll instances.
+struct EpollRegistration {
+    unsigned int events; // SCE_NET_EPOLL* interest mask
+    uint64_t data; // the title's SceNetEpollData payload, opaque here
+};
+
+// One sceNetEpoll* instance. A wait snapshots the registered set under the
+// lock and blocks in a single host poll covering all of it, so a title
+// serving many connections parks one thread instead of one per socket.
+struct Epoll {
+    std::mutex mutex;
+    std::map<int, EpollRegistration> registrations; // guest socket id -> interest
+    // Bumped by abort and destroy; a wait returns once the value moves past
+    // the one it sampled on entry.
+    std::atomic<uint32_t> abort_generation{ 0 };
+};
+
+typedef std::shared_ptr<Epoll> EpollPtr;
+typedef std::map<int, EpollPtr> epolls;
+
+// One sceNetResolver instance. The actual getaddrinfo runs on a detached
+// worker thread so an abort can cut a slow lookup loose; the caller waits on
+// the condvar with its own timeout. One lookup at a time per resolver.
+struct Resolver {
+    std::mutex mutex;
+    std::condition_variable done;
+    bool busy = false;
+    bool aborted = false;
+    uint32_t result_addr = 0; // network byte order, 0 when unresolved
+    int result_error = 0;
+    int error = 0; // last failure, for sceNetResolverGetError
+};
+typedef std::shared_ptr<Resolver> ResolverPtr;
+typedef std::map<int, ResolverPtr> resolvers;
+
+// Positive lookup results shared across every resolver. getaddrinfo does
+// not surface the record TTL, so entries live a fixed sixty seconds - long
+// enough that a title hammering its API endpoint resolves once, short
+// enough that endpoint failover is still seen.
+struct DnsCacheEntry {
+    uint32_t addr; // network byte order
+    std::chrono::steady_clock::time_point expires;
+};
+
 struct NetState {
     bool inited = false;
     int next_id = 0;
     sockets socks;
+    epolls eps;
+    resolvers rids;
     callbacks cbs;
     int state = -1;
+    std::mutex dns_mutex;
+    std::map<std::string, DnsCacheEntry> dns_cache;
+};
+
+// The sceHttp object model: a template holds defaults, a connection names a
+// server, a request carries one exchange. Connections do not own sockets -
+// those are borrowed from the keep-alive pool in HttpState, so consecutive
+// requests to the same server skip the TCP handshake.
+struct HttpTemplate {
+    std::string user_agent;
+    int http_version = 0;
+};
+
+struct HttpConnection {
+    int template_id = 0;
+    std::string hostname;
+    uint16_t port = 80;
+    bool secure = false; // https - no TLS backend, rejected at send time
+    bool keep_alive = true;
+};
+
+struct HttpRequest {
+    int connection_id = 0;
+    int method = 0;
+    std::string path;
+    std::map<std::string, std::string> headers;
+    // Response state, valid once sceHttpSendRequest succeeded.
+    int status_code = 0;
+    std::string response_headers;
+    std::vector<uint8_t> body;
+    size_t read_offset = 0;
+};
+
+struct HttpState {
+    bool inited = false;
+    int next_id = 0;
+    std::map<int, HttpTemplate> templates;
+    std::map<int, HttpConnection> connections;
+    std::map<int, HttpRequest> requests;
+    // Warm sockets keyed by "host:port", parked here after a keep-alive
+    // exchange and handed to the next request for the same server.
+    std::mutex pool_mutex;
+    std::multimap<std::string, abs_socket> connection_pool;
 };
@@ -21,7 +21,15 @@
 
 #include <net/state.h>
 
+#ifndef WIN32
+#include <poll.h>
+#endif
+
+#include <cerrno>
+#include <chrono>
 #include <cstring>
+#include <thread>
+#include <vector>
 
 static void convertSceSockaddrToPosix(const struct SceNetSockaddr *src, struct sockaddr *dst) {
     if (src == nullptr || dst == nullptr)
@@ -189,3 +197,276 @@ int listen_socket(NetState &net, int id, int backlog) {
     }
     return -1;
 }
+
+int create_resolver(NetState &net) {
+    const int id = net.next_id++;
+    net.rids.emplace(id, std::make_shared<Resolver>());
+    return id;
+}
+
+int destroy_resolver(NetState &net, int rid) {
+    const resolvers::const_iterator resolver = net.rids.find(rid);
+    if (resolver == net.rids.end()) {
+        return -1;
+    }
+    abort_resolver(net, rid);
+    net.rids.erase(rid);
+    return 0;
+}
+
+int abort_resolver(NetState &net, int rid) {
+    const resolvers::const_iterator resolver = net.rids.find(rid);
+    if (resolver == net.rids.end()) {
+        return -1;
+    }
+    {
+        const std::lock_guard<std::mutex> lock(resolver->second->mutex);
+        resolver->second->aborted = true;
+    }
+    resolver->second->done.notify_all();
+    return 0;
+}
+
+// Fixed because getaddrinfo exposes no record TTL.
+static constexpr std::chrono::seconds DNS_CACHE_TTL(60);
+
+int resolver_ntoa(NetState &net, int rid, const char *hostname, uint32_t &addr, int timeout_s) {
+    if (hostname == nullptr) {
+        return -1;
+    }
+    const resolvers::const_iterator resolver_it = net.rids.find(rid);
+    if (resolver_it == net.rids.end()) {
+        return -1;
+    }
+    const ResolverPtr resolver = resolver_it->second;
+    const std::string name(hostname);
+
+    {
+        const std::lock_guard<std::mutex> lock(net.dns_mutex);
+        const auto cached = net.dns_cache.find(name);
+        if ((cached != net.dns_cache.end()) && (std::chrono::steady_clock::now() < cached->second.expires)) {
+            addr = cached->second.addr;
+            return 0;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(resolver->mutex);
+    if (resolver->busy) {
+        return -1; // a previous aborted lookup is still in flight
+    }
+    resolver->busy = true;
+    resolver->aborted = false;
+
+    // The lookup itself runs detached: if it outlives the waiter's timeout
+    // or an abort, it finishes into the shared_ptr-kept resolver and frees
+    // it for the next lookup instead of blocking anything.
+    std::thread([resolver, name]() {
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+
+        uint32_t resolved = 0;
+        addrinfo *results = nullptr;
+        if (getaddrinfo(name.c_str(), nullptr, &hints, &results) == 0) {
+            for (const addrinfo *result = results; result != nullptr; result = result->ai_next) {
+                if (result->ai_family == AF_INET) {
+                    resolved = reinterpret_cast<const sockaddr_in *>(result->ai_addr)->sin_addr.s_addr;
+                    break;
+                }
+            }
+            freeaddrinfo(results);
+        }
+
+        const std::lock_guard<std::mutex> lock(resolver->mutex);
+        resolver->result_addr = resolved;
+        resolver->result_error = (resolved != 0) ? 0 : -3;
+        resolver->busy = false;
+        resolver->done.notify_all();
+    }).detach();
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds((timeout_s > 0) ? timeout_s : 10);
+    const bool finished = resolver->done.wait_until(lock, deadline, [&resolver]() {
+        return !resolver->busy || resolver->aborted;
+    });
+    if (!finished || resolver->aborted || (resolver->result_error != 0)) {
+        resolver->error = (!finished || resolver->aborted) ? -2 : resolver->result_error;
+        return resolver->error;
+    }
+
+    addr = resolver->result_addr;
+    const std::lock_guard<std::mutex> cache_lock(net.dns_mutex);
+    net.dns_cache[name] = { addr, std::chrono::steady_clock::now() + DNS_CACHE_TTL };
+    return 0;
+}
+
+int get_resolver_error(NetState &net, int rid, int &error) {
+    const resolvers::const_iterator resolver = net.rids.find(rid);
+    if (resolver == net.rids.end()) {
+        return -1;
+    }
+    const std::lock_guard<std::mutex> lock(resolver->second->mutex);
+    error = resolver->second->error;
+    return 0;
+}
+
+int create_epoll(NetState &net) {
+    const int id = net.next_id++;
+    net.eps.emplace(id, std::make_shared<Epoll>());
+    return id;
+}
+
+int destroy_epoll(NetState &net, int eid) {
+    const epolls::const_iterator epoll = net.eps.find(eid);
+    if (epoll == net.eps.end()) {
+        return -1;
+    }
+    // Release any thread still waiting on it - the shared_ptr keeps the
+    // object alive until that wait unwinds.
+    ++epoll->second->abort_generation;
+    net.eps.erase(eid);
+    return 0;
+}
+
+int abort_epoll(NetState &net, int eid) {
+    const epolls::const_iterator epoll = net.eps.find(eid);
+    if (epoll == net.eps.end()) {
+        return -1;
+    }
+    ++epoll->second->abort_generation;
+    return 0;
+}
+
+int control_epoll(NetState &net, int eid, int op, int id, const SceNetEpollEvent *event) {
+    const epolls::const_iterator epoll = net.eps.find(eid);
+    if (epoll == net.eps.end()) {
+        return -1;
+    }
+
+    const std::lock_guard<std::mutex> lock(epoll->second->mutex);
+    switch (op) {
+    case SCE_NET_EPOLL_CTL_ADD: {
+        if ((event == nullptr) || (net.socks.find(id) == net.socks.end())) {
+            return -1;
+        }
+        const EpollRegistration registration = { event->events, event->data.u64 };
+        return epoll->second->registrations.emplace(id, registration).second ? 0 : -1;
+    }
+    case SCE_NET_EPOLL_CTL_MOD: {
+        const auto registration = epoll->second->registrations.find(id);
+        if ((event == nullptr) || (registration == epoll->second->registrations.end())) {
+            return -1;
+        }
+        registration->second.events = event->events;
+        registration->second.data = event->data.u64;
+        return 0;
+    }
+    case SCE_NET_EPOLL_CTL_DEL:
+        return epoll->second->registrations.erase(id) ? 0 : -1;
+    default:
+        return -1;
+    }
+}
+
+int wait_epoll(NetState &net, int eid, SceNetEpollEvent *events, int n, int timeout_us) {
+    const epolls::const_iterator epoll_it = net.eps.find(eid);
+    if ((epoll_it == net.eps.end()) || (events == nullptr) || (n <= 0)) {
+        return -1;
+    }
+    const EpollPtr epoll = epoll_it->second;
+
+    const uint32_t abort_before = epoll->abort_generation.load();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(timeout_us);
+
+    // Poll in short slices so aborts and registration changes made by other
+    // threads take effect without needing a wakeup channel on every platform.
+    constexpr int SLICE_MS = 50;
+
+    for (;;) {
+        std::vector<pollfd> fds;
+        std::vector<EpollRegistration> registrations;
+        {
+            const std::lock_guard<std::mutex> lock(epoll->mutex);
+            fds.reserve(epoll->registrations.size());
+            registrations.reserve(epoll->registrations.size());
+            for (const auto &registration : epoll->registrations) {
+                const sockets::const_iterator socket = net.socks.find(registration.first);
+                if (socket == net.socks.end()) {
+                    continue; // closed since it was registered
+                }
+                pollfd fd = {};
+                fd.fd = socket->second;
+                if (registration.second.events & SCE_NET_EPOLLIN) {
+                    fd.events |= POLLIN;
+                }
+                if (registration.second.events & SCE_NET_EPOLLOUT) {
+                    fd.events |= POLLOUT;
+                }
+                fds.push_back(fd);
+                registrations.push_back(registration.second);
+            }
+        }
+
+        int slice_ms = SLICE_MS;
+        if (timeout_us >= 0) {
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (remaining < slice_ms) {
+                slice_ms = (remaining > 0) ? static_cast<int>(remaining) : 0;
+            }
+        }
+
+        int res = 0;
+        if (fds.empty()) {
+            // WSAPoll rejects an empty set, so sleep the slice instead.
+            std::this_thread::sleep_for(std::chrono::milliseconds(slice_ms));
+        } else {
+#ifdef WIN32
+            res = WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), slice_ms);
+#else
+            res = poll(fds.data(), fds.size(), slice_ms);
+#endif
+            if (res < 0) {
+                return -1;
+            }
+        }
+
+        if (res > 0) {
+            int out = 0;
+            for (size_t i = 0; (i < fds.size()) && (out < n); ++i) {
+                if (fds[i].revents == 0) {
+                    continue;
+                }
+                SceNetEpollEvent event;
+                memset(&event, 0, sizeof(event));
+                if (fds[i].revents & POLLIN) {
+                    event.events |= SCE_NET_EPOLLIN;
+                }
+                if (fds[i].revents & POLLOUT) {
+                    event.events |= SCE_NET_EPOLLOUT;
+                }
+                if (fds[i].revents & POLLERR) {
+                    event.events |= SCE_NET_EPOLLERR;
+                }
+                if (fds[i].revents & POLLHUP) {
+                    event.events |= SCE_NET_EPOLLHUP;
+                }
+                event.data.u64 = registrations[i].data;
+                events[out++] = event;
+            }
+            return out;
+        }
+
+        if (epoll->abort_generation.load() != abort_before) {
+#ifdef WIN32
+            WSASetLastError(WSAEINTR);
+#else
+            errno = EINTR;
+#endif
+            return -1;
+        }
+
+        if ((timeout_us >= 0) && (std::chrono::steady_clock::now() >= deadline)) {
+            return 0;
+        }
+    }
+}
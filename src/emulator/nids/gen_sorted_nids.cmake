@@ -0,0 +1,33 @@
+# Re-emits the NID list from nids.h in ascending NID order, so consumers can
+# build sorted constexpr tables with the same X-macro they already use.
+# Invoked at build time with -DINPUT=<nids.h> -DOUTPUT=<sorted_nids.h>.
+
+file(READ "${INPUT}" contents)
+string(REGEX MATCHALL "NID\\([A-Za-z0-9_]+, 0x[0-9A-Fa-f]+\\)" entries "${contents}")
+
+# Normalize every NID to eight uppercase hex digits so a lexicographic sort
+# is a numeric sort.
+set(keyed "")
+foreach(entry ${entries})
+	string(REGEX REPLACE "NID\\(([A-Za-z0-9_]+), 0x([0-9A-Fa-f]+)\\)" "\\1;\\2" parts "${entry}")
+	list(GET parts 0 name)
+	list(GET parts 1 nid)
+	string(TOUPPER "${nid}" nid)
+	string(LENGTH "${nid}" len)
+	while(len LESS 8)
+		set(nid "0${nid}")
+		string(LENGTH "${nid}" len)
+	endwhile()
+	list(APPEND keyed "${nid} ${name}")
+endforeach()
+
+list(SORT keyed)
+
+set(out "// Generated from nids.h by gen_sorted_nids.cmake - do not edit.\n")
+set(out "${out}// Entries are in ascending NID order.\n")
+foreach(entry ${keyed})
+	string(REGEX REPLACE "([0-9A-F]+) (.+)" "NID(\\2, 0x\\1)" line "${entry}")
+	set(out "${out}${line}\n")
+endforeach()
+
+file(WRITE "${OUTPUT}" "${out}")
@@ -1,17 +1,33 @@
 #include <nids/functions.h>
 
-#define NID(name, nid) extern const char name_##name[] = #name;
-#include <nids/nids.h>
+// Names are emitted in the same build-time-sorted order as the resolver's
+// key array, so the lookup is a binary search over one read-only segment
+// instead of the jump tables a 4000-case switch compiles to.
+static constexpr uint32_t nids[] = {
+#define NID(name, nid) nid,
+#include <nids/sorted_nids.h>
 #undef NID
+};
 
-const char *import_name(uint32_t nid) {
-    switch (nid) {
-#define NID(name, nid) \
-    case nid:          \
-        return name_##name;
-#include <nids/nids.h>
+static constexpr const char *const names[] = {
+#define NID(name, nid) #name,
+#include <nids/sorted_nids.h>
 #undef NID
-    default:
+};
+
+static constexpr size_t nid_count = sizeof(nids) / sizeof(nids[0]);
+
+const char *import_name(uint32_t nid) {
+    const uint32_t *base = nids;
+    size_t n = nid_count;
+    while (n > 1) {
+        const size_t half = n / 2;
+        base = (base[half - 1] < nid) ? (base + half) : base;
+        n -= half;
+    }
+
+    if (*base != nid) {
         return "UNRECOGNISED";
     }
+    return names[base - nids];
 }
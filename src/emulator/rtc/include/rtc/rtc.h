@@ -19,8 +19,10 @@
 
 #include <psp2/types.h>
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <thread>
 
 struct _FILETIME;
 
@@ -38,6 +40,31 @@ using VitaClocks = std::chrono::duration<std::uint64_t, std::ratio<1, VITA_CLOCK
 
 std::uint64_t rtc_base_ticks();
 std::uint64_t rtc_get_ticks(uint64_t base_tick);
+
+// vDSO-style cached tick source. A background updater refreshes the cached
+// tick at a fixed granularity, so the hot time NIDs - titles call them tens
+// of thousands of times per frame for profiling code left enabled - cost a
+// relaxed load instead of a clock read and 64-bit conversions. Callers that
+// need the real resolution keep using rtc_get_ticks.
+struct CoarseTimeState {
+    std::atomic<std::uint64_t> ticks{ 0 };
+    std::uint64_t granularity_us = 100;
+    std::atomic<bool> stop{ false };
+    std::thread updater;
+
+    ~CoarseTimeState();
+};
+
+// A granularity of 0 keeps the default. Starting twice is a no-op.
+void rtc_start_coarse(CoarseTimeState &coarse, std::uint64_t base_ticks, std::uint64_t granularity_us = 0);
+void rtc_stop_coarse(CoarseTimeState &coarse);
+
+// The cached tick, at most one granularity stale and never decreasing.
+// Falls back to the precise clock until the updater has run once.
+inline std::uint64_t rtc_get_ticks_coarse(const CoarseTimeState &coarse, std::uint64_t base_ticks) {
+    const std::uint64_t ticks = coarse.ticks.load(std::memory_order_relaxed);
+    return (ticks != 0) ? ticks : rtc_get_ticks(base_ticks);
+}
 #ifdef WIN32
 std::uint64_t convert_filetime(const _FILETIME &filetime);
 #else
@@ -38,6 +38,38 @@ std::uint64_t rtc_get_ticks(uint64_t base_ticks) {
     return base_ticks + now_ticks;
 }
 
+CoarseTimeState::~CoarseTimeState() {
+    rtc_stop_coarse(*this);
+}
+
+void rtc_start_coarse(CoarseTimeState &coarse, std::uint64_t base_ticks, std::uint64_t granularity_us) {
+    if (coarse.updater.joinable()) {
+        return;
+    }
+    if (granularity_us != 0) {
+        coarse.granularity_us = granularity_us;
+    }
+
+    // Seed before the thread exists so readers never see the fallback once
+    // this returns.
+    coarse.ticks.store(rtc_get_ticks(base_ticks), std::memory_order_relaxed);
+    coarse.stop.store(false, std::memory_order_relaxed);
+    coarse.updater = std::thread([&coarse, base_ticks]() {
+        while (!coarse.stop.load(std::memory_order_relaxed)) {
+            coarse.ticks.store(rtc_get_ticks(base_ticks), std::memory_order_relaxed);
+            std::this_thread::sleep_for(std::chrono::microseconds(coarse.granularity_us));
+        }
+    });
+}
+
+void rtc_stop_coarse(CoarseTimeState &coarse) {
+    if (!coarse.updater.joinable()) {
+        return;
+    }
+    coarse.stop.store(true, std::memory_order_relaxed);
+    coarse.updater.join();
+}
+
 #ifdef WIN32
 std::uint64_t convert_filetime(const _FILETIME &filetime) {
     // Microseconds between 1601-01-01 00:00:00 UTC and 1970-01-01 00:00:00 UTC
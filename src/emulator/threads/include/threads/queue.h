@@ -1,11 +1,13 @@
 #ifndef queue_h
 #define queue_h
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <thread>
 
 template <typename T>
 class Queue {
@@ -38,7 +40,7 @@ public:
     void push(const T &item) {
         {
             std::unique_lock<std::mutex> mlock(mutex_);
-            while (!aborted && queue_.size() == displayQueueMaxPendingCount_) {
+            while (!aborted && queue_.size() >= displayQueueMaxPendingCount_) {
                 cond_.wait(mlock);
             }
             if (aborted) {
@@ -54,6 +56,15 @@ public:
         condempty_.notify_one();
     }
 
+    void set_max_pending_count(unsigned int count) {
+        {
+            std::unique_lock<std::mutex> mlock(mutex_);
+            displayQueueMaxPendingCount_ = count;
+        }
+        // A producer blocked on a lower cap can continue if it was raised.
+        cond_.notify_all();
+    }
+
     void abort() {
         aborted = true;
         condempty_.notify_all();
@@ -77,4 +88,120 @@ private:
     std::atomic<bool> aborted{ false };
 };
 
+// Bounded single-producer/single-consumer ring with the same blocking
+// interface as Queue. The fast path is two atomic index operations - no mutex
+// and no condvar signal; either side only spins briefly and then parks on the
+// condvar when it actually has to wait, and the other side only takes the
+// mutex to wake it when the sleeper count says somebody is parked.
+template <typename T>
+class SpscQueue {
+public:
+    std::unique_ptr<T> pop() {
+        int spins = 0;
+        while (head_.load() == tail_.load()) {
+            if (aborted_) {
+                return {};
+            }
+            if (++spins < SPIN_LIMIT) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> mlock(mutex_);
+            sleeping_consumers_.fetch_add(1);
+            if ((head_.load() == tail_.load()) && !aborted_) {
+                not_empty_.wait(mlock);
+            }
+            sleeping_consumers_.fetch_sub(1);
+            spins = 0;
+        }
+
+        const uint64_t head = head_.load();
+        std::unique_ptr<T> item = std::make_unique<T>(items_[head % CAPACITY]);
+        head_.store(head + 1);
+        if (sleeping_producers_.load() > 0) {
+            { const std::lock_guard<std::mutex> mlock(mutex_); }
+            not_full_.notify_one();
+        }
+        return item;
+    }
+
+    void push(const T &item) {
+        const uint64_t tail = tail_.load();
+        int spins = 0;
+        while (tail - head_.load() >= pending_cap()) {
+            if (aborted_) {
+                return;
+            }
+            if (++spins < SPIN_LIMIT) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> mlock(mutex_);
+            sleeping_producers_.fetch_add(1);
+            if ((tail - head_.load() >= pending_cap()) && !aborted_) {
+                not_full_.wait(mlock);
+            }
+            sleeping_producers_.fetch_sub(1);
+            spins = 0;
+        }
+        if (aborted_) {
+            return;
+        }
+
+        items_[tail % CAPACITY] = item;
+        tail_.store(tail + 1);
+        if (sleeping_consumers_.load() > 0) {
+            { const std::lock_guard<std::mutex> mlock(mutex_); }
+            not_empty_.notify_one();
+        }
+    }
+
+    void set_max_pending_count(unsigned int count) {
+        max_pending_.store(count);
+        // A producer blocked on a lower cap can continue if it was raised.
+        { const std::lock_guard<std::mutex> mlock(mutex_); }
+        not_full_.notify_all();
+    }
+
+    void abort() {
+        aborted_ = true;
+        { const std::lock_guard<std::mutex> mlock(mutex_); }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    void reset() {
+        head_.store(0);
+        tail_.store(0);
+        aborted_ = false;
+    }
+
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue &) = delete; // disable copying
+    SpscQueue &operator=(const SpscQueue &) = delete; // disable assignment
+
+private:
+    static constexpr uint64_t CAPACITY = 64; // far above any realistic pending cap
+    static constexpr int SPIN_LIMIT = 1024;
+
+    uint64_t pending_cap() const {
+        const uint64_t cap = max_pending_.load();
+        return (cap < CAPACITY) ? cap : CAPACITY;
+    }
+
+    std::array<T, CAPACITY> items_;
+    // Sequentially consistent on purpose: the sleeper counters and the ring
+    // indices cross-check each other to avoid a lost wakeup, and the ring is
+    // far too small for the fence cost to show up next to a mutex handoff.
+    std::atomic<uint64_t> head_{ 0 }; // next slot to pop, advanced by the consumer
+    std::atomic<uint64_t> tail_{ 0 }; // next slot to push, advanced by the producer
+    std::atomic<uint64_t> max_pending_{ CAPACITY };
+    std::atomic<int> sleeping_consumers_{ 0 };
+    std::atomic<int> sleeping_producers_{ 0 };
+    std::atomic<bool> aborted_{ false };
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::mutex mutex_; // parking only; the fast path never takes it
+};
+
 #endif /* queue_h */
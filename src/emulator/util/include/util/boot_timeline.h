@@ -0,0 +1,51 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Boot timeline: named slices recorded during startup - init phases, each
+// SELF load, each installed file - and written out as chrome://tracing JSON
+// so a slow boot lands with an artifact that diffs between builds. Process
+// global like the logger, since recorders span host, kernel and io without
+// sharing any state struct. Recording stops once finish_boot_timeline has
+// written the file; afterwards a slice costs one load of the enabled flag.
+void add_boot_slice(std::string name, uint64_t ts_us, uint64_t dur_us, uint64_t bytes);
+uint64_t boot_timeline_now_us();
+bool finish_boot_timeline(const std::string &path);
+
+// Records the slice from construction to destruction.
+class BootSlice {
+public:
+    explicit BootSlice(std::string name, uint64_t bytes = 0)
+        : bytes(bytes)
+        , name(std::move(name))
+        , start_us(boot_timeline_now_us()) {
+    }
+
+    ~BootSlice() {
+        add_boot_slice(std::move(name), start_us, boot_timeline_now_us() - start_us, bytes);
+    }
+
+    uint64_t bytes; // adjustable while the slice is open
+
+private:
+    std::string name;
+    uint64_t start_us;
+};
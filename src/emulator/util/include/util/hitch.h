@@ -0,0 +1,65 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <cstdint>
+
+// Online slow-frame attribution. The expensive stages accumulate wall time
+// into process-wide counters as they run (any thread), and the display
+// frame boundary classifies each frame that blew its budget by the stage
+// that dominated it. The counters are monotonic like the instruction
+// counter, so they cost one relaxed atomic add per timed region.
+
+enum HitchStage {
+    HITCH_STAGE_SHADER_COMPILE,
+    HITCH_STAGE_TEXTURE_UPLOAD,
+    HITCH_STAGE_VERTEX_UPLOAD,
+    HITCH_STAGE_VBLANK_WAIT,
+    HITCH_STAGE_GUEST_CPU, // residual - frame time not covered by a timed stage
+    HitchStageCount
+};
+
+extern const char *const hitch_stage_names[HitchStageCount];
+
+void hitch_add_stage_time(HitchStage stage, uint64_t duration_us);
+
+// RAII wall timer over one stage region.
+struct HitchStageScope {
+    explicit HitchStageScope(HitchStage stage);
+    ~HitchStageScope();
+
+    HitchStageScope(const HitchStageScope &) = delete;
+    HitchStageScope &operator=(const HitchStageScope &) = delete;
+
+    const HitchStage stage;
+    const uint64_t start_us;
+};
+
+// Session totals: every presented frame, the slow ones, and the slow ones
+// broken down by dominant cause.
+struct HitchHistogram {
+    uint64_t frames = 0;
+    uint64_t slow_frames = 0;
+    uint64_t counts[HitchStageCount] = {};
+};
+
+// Call once per presented frame (the set-frame-buffer path). Measures the
+// frame's wall time, classifies it if it was slow, and restarts the clock.
+void hitch_frame_boundary();
+
+HitchHistogram hitch_histogram_snapshot();
@@ -1,11 +1,25 @@
 #pragma once
 
 #include "find.h"
+#include "uid_table.h"
 
 #include <mutex>
+#include <shared_mutex>
 
 template <typename T, typename Key>
 std::shared_ptr<T> lock_and_find(Key key, const std::map<Key, std::shared_ptr<T>> &map, std::mutex &mutex) {
     const std::lock_guard<std::mutex> lock(mutex);
     return find(key, map);
 }
+
+template <typename T, typename Key>
+std::shared_ptr<T> lock_and_find(Key key, const std::map<Key, std::shared_ptr<T>> &map, std::shared_mutex &mutex) {
+    const std::shared_lock<std::shared_mutex> lock(mutex);
+    return find(key, map);
+}
+
+template <typename T>
+std::shared_ptr<T> lock_and_find(int32_t key, const UIDTable<T> &table, std::shared_mutex &mutex) {
+    const std::shared_lock<std::shared_mutex> lock(mutex);
+    return table.find(key);
+}
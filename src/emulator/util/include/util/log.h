@@ -25,19 +25,32 @@ extern std::shared_ptr<spdlog::logger> g_logger;
 
 void init_logging();
 
+// STRIP_TRACE_LOGS compiles trace and debug macros down to nothing - no
+// formatting, no argument evaluation - for production builds where these
+// levels fire per HLE call and the cost shows in profiles.
+#ifdef STRIP_TRACE_LOGS
+#define LOG_TRACE(fmt, ...) (void)0
+#define LOG_DEBUG(fmt, ...) (void)0
+#else
 #define LOG_TRACE(fmt, ...) g_logger->trace("|T| [{:s}]:  " fmt, __FUNCTION__, ##__VA_ARGS__)
 #define LOG_DEBUG(fmt, ...) g_logger->debug("|D| [{:s}]:  " fmt, __FUNCTION__, ##__VA_ARGS__)
+#endif
 #define LOG_INFO(fmt, ...) g_logger->info("|I| [{:s}]:  " fmt, __FUNCTION__, ##__VA_ARGS__)
 #define LOG_WARN(fmt, ...) g_logger->warn("|W| [{:s}]:  " fmt, __FUNCTION__, ##__VA_ARGS__)
 #define LOG_ERROR(fmt, ...) g_logger->error("|E| [{:s}]:  " fmt, __FUNCTION__, ##__VA_ARGS__)
 #define LOG_CRITICAL(fmt, ...) g_logger->critical("|C| [{:s}]:  " fmt, __FUNCTION__, ##__VA_ARGS__)
 
+#ifdef STRIP_TRACE_LOGS
+#define LOG_TRACE_IF(flag, fmt, ...) (void)0
+#define LOG_DEBUG_IF(flag, fmt, ...) (void)0
+#else
 #define LOG_TRACE_IF(flag, fmt, ...) \
     if (flag)                        \
     g_logger->trace("|T| [{:s}]:  " fmt, __FUNCTION__, ##__VA_ARGS__)
 #define LOG_DEBUG_IF(flag, fmt, ...) \
     if (flag)                        \
     g_logger->debug("|D| [{:s}]:  " fmt, __FUNCTION__, ##__VA_ARGS__)
+#endif
 #define LOG_INFO_IF(flag, fmt, ...) \
     if (flag)                       \
     g_logger->info("|I| [{:s}]:  " fmt, __FUNCTION__, ##__VA_ARGS__)
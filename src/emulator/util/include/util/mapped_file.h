@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Read-only shared mapping of a whole file. Every process mapping the same
+// file shares one physical copy of its pages through the page cache, so
+// several emulator instances warming the same on-disk caches pay for the
+// data once instead of once per instance. The underlying handle is released
+// as soon as the view exists; only the mapping itself is kept.
+struct MappedFile {
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Maps the file read-only. Empty and unopenable files fail.
+    bool open(const std::string &path);
+    void close();
+
+    const uint8_t *data() const {
+        return base;
+    }
+    uint64_t size() const {
+        return mapped_size;
+    }
+    explicit operator bool() const {
+        return base != nullptr;
+    }
+
+private:
+    const uint8_t *base = nullptr;
+    uint64_t mapped_size = 0;
+};
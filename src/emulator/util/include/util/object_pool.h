@@ -0,0 +1,113 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Size-bucketed recycling pool for the fixed-size kernel objects created on
+// hot paths. Nodes are carved from contiguous slabs so same-type objects
+// created together also sit together, and freed nodes are kept per size and
+// handed back on the next request, so steady-state object churn does no heap
+// allocation.
+class ObjectPool {
+public:
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    ~ObjectPool() {
+        for (void *const slab : slabs) {
+            ::operator delete(slab);
+        }
+    }
+
+    void *allocate(size_t size) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        std::vector<void *> &bucket = free_nodes[size];
+        if (bucket.empty()) {
+            // Node sizes are whole object sizes, so slab offsets keep the
+            // allocation's natural alignment.
+            char *const slab = static_cast<char *>(::operator new(size * SLAB_NODES));
+            slabs.push_back(slab);
+            for (size_t node = 0; node < SLAB_NODES; ++node) {
+                bucket.push_back(slab + (node * size));
+            }
+        }
+
+        void *const node = bucket.back();
+        bucket.pop_back();
+        return node;
+    }
+
+    void deallocate(void *node, size_t size) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        free_nodes[size].push_back(node);
+    }
+
+private:
+    static constexpr size_t SLAB_NODES = 16;
+
+    typedef std::map<size_t, std::vector<void *>> Buckets;
+
+    std::mutex mutex;
+    Buckets free_nodes;
+    std::vector<void *> slabs; // slab bases, freed only at pool destruction
+};
+
+// Allocator adapter so allocate_shared can place the control block and the
+// object together in one pooled node.
+template <class T>
+class PooledAllocator {
+public:
+    typedef T value_type;
+
+    explicit PooledAllocator(ObjectPool &pool)
+        : pool(&pool) {}
+
+    template <class U>
+    PooledAllocator(const PooledAllocator<U> &other)
+        : pool(other.pool) {}
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(pool->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *node, size_t n) {
+        pool->deallocate(node, n * sizeof(T));
+    }
+
+    ObjectPool *pool;
+};
+
+template <class T, class U>
+bool operator==(const PooledAllocator<T> &a, const PooledAllocator<U> &b) {
+    return a.pool == b.pool;
+}
+
+template <class T, class U>
+bool operator!=(const PooledAllocator<T> &a, const PooledAllocator<U> &b) {
+    return !(a == b);
+}
+
+template <class T>
+std::shared_ptr<T> make_pooled(ObjectPool &pool) {
+    return std::allocate_shared<T>(PooledAllocator<T>(pool));
+}
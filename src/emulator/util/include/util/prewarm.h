@@ -0,0 +1,44 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+// Per-title session manifest behind the cache prewarmers. Each subsystem
+// owns one log; an entry is a single line (a shader pair key, a file path)
+// appended the first time it occurs in a session, so the manifest grows
+// incrementally and the next session can replay it ahead of demand. A
+// default-constructed log records nothing until opened.
+struct PrewarmLog {
+    std::string manifest_path;
+    std::mutex mutex;
+    std::vector<std::string> entries; // manifest order, for replay
+    std::set<std::string> recorded; // membership, so each entry lands once
+};
+
+// Loads prior sessions' entries from path and enables recording to it.
+void prewarm_log_open(PrewarmLog &log, const std::string &path);
+
+// Appends the entry to the manifest unless it is already there.
+void prewarm_log_record(PrewarmLog &log, const std::string &entry);
+
+// Snapshots the entries for replay.
+std::vector<std::string> prewarm_log_entries(PrewarmLog &log);
@@ -7,6 +7,10 @@ using ProgramArgsWide = std::vector<std::wstring>;
 
 std::wstring utf_to_wide(const std::string &str);
 
+// Memoized utf_to_wide for per-file-operation host paths, which repeat
+// frame after frame. Returns a copy so callers need no lock discipline.
+std::wstring utf_to_wide_cached(const std::string &str);
+
 std::string wide_to_utf(const std::wstring &str);
 
 std::string utf16_to_utf8(const std::u16string &str);
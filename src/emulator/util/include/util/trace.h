@@ -0,0 +1,56 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Runtime trace capture for cross-subsystem stalls. Each thread records
+// slices into its own fixed ring, so an enabled event costs two clock reads
+// and a couple of stores with no shared writes - cheap enough to scatter
+// through scene boundaries, sync waits, io operations and the audio
+// callback. Disabled, a scope is one relaxed atomic load.
+//
+// Names must be string literals (the rings keep only the pointer).
+// Rings wrap, so a dump holds the most recent ~8k events per thread.
+void set_tracing_enabled(bool enabled);
+bool is_tracing_enabled();
+uint64_t trace_now_us();
+void add_trace_event(const char *name, uint64_t start_us, uint64_t end_us);
+
+// Stops recording and writes every ring as chrome://tracing JSON.
+bool dump_trace(const std::string &path);
+
+// Records the slice from construction to destruction when tracing is on.
+class TraceScope {
+public:
+    explicit TraceScope(const char *name)
+        : name(name)
+        , start_us(is_tracing_enabled() ? trace_now_us() : 0) {
+    }
+
+    ~TraceScope() {
+        if (start_us != 0) {
+            add_trace_event(name, start_us, trace_now_us());
+        }
+    }
+
+private:
+    const char *name;
+    uint64_t start_us;
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <util/log.h>
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Generation-checked flat slot table for kernel object handles. The low 16
+// bits of a UID index the slot array and the high bits carry the slot's
+// generation, so lookup is one bounds check and one compare on contiguous
+// storage instead of a red-black-tree walk, and a stale handle to a recycled
+// slot fails the generation compare instead of aliasing the new object.
+//
+// Callers are expected to provide their own locking, matching the discipline
+// of the std::map tables this replaces: alloc/set/erase under the exclusive
+// kernel lock, find and iteration under the shared one.
+template <typename T>
+class UIDTable {
+public:
+    typedef std::shared_ptr<T> ItemPtr;
+    typedef std::pair<int32_t, ItemPtr> value_type;
+
+    // Reserves a slot and returns its handle. The slot stays invisible to
+    // find and iteration until set publishes an object into it.
+    int32_t alloc() {
+        uint32_t index;
+        if (free_indices.empty()) {
+            if (slots.size() >= max_slots) {
+                // A 17th index bit would fold into the generation field and
+                // make the handle alias slot 0, so fail loudly instead.
+                LOG_CRITICAL("UID table exhausted ({} live slots)", slots.size());
+                assert(slots.size() < max_slots);
+                return -1;
+            }
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        } else {
+            index = free_indices.back();
+            free_indices.pop_back();
+        }
+        return make_uid(slots[index].generation, index);
+    }
+
+    void set(int32_t uid, ItemPtr item) {
+        slots[index_of(uid)].item = std::move(item);
+    }
+
+    ItemPtr find(int32_t uid) const {
+        const uint32_t index = index_of(uid);
+        if (index >= slots.size()) {
+            return ItemPtr();
+        }
+        const Slot &slot = slots[index];
+        if (make_uid(slot.generation, index) != uid) {
+            return ItemPtr();
+        }
+        return slot.item;
+    }
+
+    bool erase(int32_t uid) {
+        const uint32_t index = index_of(uid);
+        if ((index >= slots.size()) || (make_uid(slots[index].generation, index) != uid)) {
+            return false;
+        }
+        slots[index].item.reset();
+        ++slots[index].generation; // invalidates outstanding handles
+        free_indices.push_back(index);
+        return true;
+    }
+
+    size_t size() const {
+        return slots.size() - free_indices.size();
+    }
+
+private:
+    struct Slot {
+        uint32_t generation = 0;
+        ItemPtr item;
+    };
+
+    // The index field is 16 bits wide, so this many slots is a hard ceiling.
+    static constexpr size_t max_slots = 0x10000;
+
+    static uint32_t index_of(int32_t uid) {
+        return static_cast<uint32_t>(uid) & 0xffff;
+    }
+
+    static int32_t make_uid(uint32_t generation, uint32_t index) {
+        // Keep the sign bit clear - negative SceUIDs are error codes.
+        return static_cast<int32_t>(((generation & 0x7fff) << 16) | index);
+    }
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> free_indices;
+
+public:
+    // Iteration over occupied slots, yielding (uid, item) pairs so existing
+    // range-for consumers of the old map tables keep working.
+    class const_iterator {
+    public:
+        const_iterator(const UIDTable *table, uint32_t index)
+            : table(table)
+            , index(index) {
+            skip_empty();
+        }
+
+        value_type operator*() const {
+            const Slot &slot = table->slots[index];
+            return value_type(make_uid(slot.generation, index), slot.item);
+        }
+
+        const_iterator &operator++() {
+            ++index;
+            skip_empty();
+            return *this;
+        }
+
+        bool operator!=(const const_iterator &rhs) const {
+            return index != rhs.index;
+        }
+        bool operator==(const const_iterator &rhs) const {
+            return index == rhs.index;
+        }
+
+    private:
+        void skip_empty() {
+            while ((index < table->slots.size()) && !table->slots[index].item) {
+                ++index;
+            }
+        }
+
+        const UIDTable *table;
+        uint32_t index;
+    };
+    typedef const_iterator iterator;
+
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const {
+        return const_iterator(this, static_cast<uint32_t>(slots.size()));
+    }
+};
+
+template <typename T>
+std::shared_ptr<T> find(int32_t key, const UIDTable<T> &table) {
+    return table.find(key);
+}
@@ -0,0 +1,106 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <util/boot_timeline.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct BootTimelineEvent {
+    std::string name;
+    uint64_t ts_us;
+    uint64_t dur_us;
+    uint64_t bytes;
+    size_t tid;
+};
+
+struct BootTimeline {
+    std::mutex mutex;
+    std::vector<BootTimelineEvent> events;
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    std::atomic<bool> enabled{ true };
+};
+
+static BootTimeline g_boot_timeline;
+
+// Slice names carry guest and host paths, so quotes and backslashes need
+// escaping before they land in JSON string literals.
+static std::string escape_json(const std::string &s) {
+    std::string escaped;
+    escaped.reserve(s.size());
+    for (const char c : s) {
+        if ((c == '"') || (c == '\\')) {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+
+    return escaped;
+}
+
+uint64_t boot_timeline_now_us() {
+    const auto elapsed = std::chrono::steady_clock::now() - g_boot_timeline.origin;
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+void add_boot_slice(std::string name, uint64_t ts_us, uint64_t dur_us, uint64_t bytes) {
+    if (!g_boot_timeline.enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    const size_t tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    const std::lock_guard<std::mutex> lock(g_boot_timeline.mutex);
+    g_boot_timeline.events.push_back({ std::move(name), ts_us, dur_us, bytes, tid });
+}
+
+bool finish_boot_timeline(const std::string &path) {
+    g_boot_timeline.enabled = false;
+
+    std::vector<BootTimelineEvent> events;
+    {
+        const std::lock_guard<std::mutex> lock(g_boot_timeline.mutex);
+        events.swap(g_boot_timeline.events);
+    }
+
+    std::ofstream out(path, std::ofstream::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    // Complete ("X") events in chrome://tracing's JSON array format - load
+    // the file at chrome://tracing or ui.perfetto.dev to inspect or diff.
+    out << "{\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i) {
+        const BootTimelineEvent &event = events[i];
+        if (i != 0) {
+            out << ",";
+        }
+        out << "\n{\"name\":\"" << escape_json(event.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.tid
+            << ",\"ts\":" << event.ts_us << ",\"dur\":" << event.dur_us
+            << ",\"args\":{\"bytes\":" << event.bytes << "}}";
+    }
+    out << "\n]}\n";
+
+    return out.good();
+}
@@ -0,0 +1,113 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <util/hitch.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+const char *const hitch_stage_names[HitchStageCount] = {
+    "shader_compile",
+    "texture_upload",
+    "vertex_upload",
+    "vblank_wait",
+    "guest_cpu",
+};
+
+// A frame past this is a dropped 60 Hz deadline with margin - the kind of
+// hitch a player feels, not scheduler jitter.
+static constexpr uint64_t SLOW_FRAME_THRESHOLD_US = 25000;
+
+// Stage timers run on whatever thread does the work (render thread, shader
+// compiler thread, guest threads), so the totals are relaxed atomics. The
+// boundary state and histogram are only touched under the mutex.
+static std::atomic<uint64_t> g_stage_time_us[HitchStageCount];
+
+static std::mutex g_boundary_mutex;
+static uint64_t g_last_stage_time_us[HitchStageCount] = {};
+static std::chrono::steady_clock::time_point g_last_boundary{};
+static HitchHistogram g_histogram;
+
+static uint64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void hitch_add_stage_time(HitchStage stage, uint64_t duration_us) {
+    g_stage_time_us[stage].fetch_add(duration_us, std::memory_order_relaxed);
+}
+
+HitchStageScope::HitchStageScope(HitchStage stage)
+    : stage(stage)
+    , start_us(now_us()) {
+}
+
+HitchStageScope::~HitchStageScope() {
+    hitch_add_stage_time(stage, now_us() - start_us);
+}
+
+void hitch_frame_boundary() {
+    const auto now = std::chrono::steady_clock::now();
+    const std::lock_guard<std::mutex> lock(g_boundary_mutex);
+
+    if (g_last_boundary.time_since_epoch().count() == 0) {
+        // First frame - just start the clock.
+        g_last_boundary = now;
+        for (int stage = 0; stage < HitchStageCount; ++stage) {
+            g_last_stage_time_us[stage] = g_stage_time_us[stage].load(std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    const uint64_t frame_us = std::chrono::duration_cast<std::chrono::microseconds>(now - g_last_boundary).count();
+    g_last_boundary = now;
+    ++g_histogram.frames;
+
+    // Stage deltas for the frame that just ended. The timed stages overlap
+    // the guest (render and compiler threads run concurrently), so this is
+    // "time that stage was burning during the frame", which is exactly the
+    // attribution question - not a strict breakdown of the critical path.
+    uint64_t deltas[HitchStageCount] = {};
+    uint64_t timed_total = 0;
+    for (int stage = 0; stage < HitchStageCount; ++stage) {
+        const uint64_t total = g_stage_time_us[stage].load(std::memory_order_relaxed);
+        deltas[stage] = total - g_last_stage_time_us[stage];
+        g_last_stage_time_us[stage] = total;
+        timed_total += deltas[stage];
+    }
+    deltas[HITCH_STAGE_GUEST_CPU] = (frame_us > timed_total) ? (frame_us - timed_total) : 0;
+
+    if (frame_us < SLOW_FRAME_THRESHOLD_US) {
+        return;
+    }
+
+    ++g_histogram.slow_frames;
+    int dominant = HITCH_STAGE_GUEST_CPU;
+    for (int stage = 0; stage < HitchStageCount; ++stage) {
+        if (deltas[stage] > deltas[dominant]) {
+            dominant = stage;
+        }
+    }
+    ++g_histogram.counts[dominant];
+}
+
+HitchHistogram hitch_histogram_snapshot() {
+    const std::lock_guard<std::mutex> lock(g_boundary_mutex);
+    return g_histogram;
+}
@@ -0,0 +1,83 @@
+#include <util/mapped_file.h>
+
+#ifdef WIN32
+#include <util/string_convert.h>
+
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::string &path) {
+    close();
+
+#ifdef WIN32
+    const HANDLE file = CreateFileW(utf_to_wide(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER file_size = {};
+    if (!GetFileSizeEx(file, &file_size) || (file_size.QuadPart == 0)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    const void *const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping); // the view keeps the mapping alive
+    if (view == nullptr) {
+        return false;
+    }
+
+    base = static_cast<const uint8_t *>(view);
+    mapped_size = static_cast<uint64_t>(file_size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat file_stat;
+    if ((fstat(fd, &file_stat) != 0) || (file_stat.st_size == 0)) {
+        ::close(fd);
+        return false;
+    }
+
+    void *const view = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps its own reference
+    if (view == MAP_FAILED) {
+        return false;
+    }
+
+    base = static_cast<const uint8_t *>(view);
+    mapped_size = static_cast<uint64_t>(file_stat.st_size);
+#endif
+
+    return true;
+}
+
+void MappedFile::close() {
+    if (base == nullptr) {
+        return;
+    }
+#ifdef WIN32
+    UnmapViewOfFile(base);
+#else
+    munmap(const_cast<uint8_t *>(base), mapped_size);
+#endif
+    base = nullptr;
+    mapped_size = 0;
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
@@ -0,0 +1,49 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <util/prewarm.h>
+
+#include <fstream>
+
+void prewarm_log_open(PrewarmLog &log, const std::string &path) {
+    const std::lock_guard<std::mutex> lock(log.mutex);
+    log.manifest_path = path;
+
+    std::ifstream manifest(path);
+    std::string line;
+    while (std::getline(manifest, line)) {
+        if (!line.empty() && log.recorded.insert(line).second) {
+            log.entries.push_back(line);
+        }
+    }
+}
+
+void prewarm_log_record(PrewarmLog &log, const std::string &entry) {
+    const std::lock_guard<std::mutex> lock(log.mutex);
+    if (log.manifest_path.empty() || !log.recorded.insert(entry).second) {
+        return;
+    }
+    log.entries.push_back(entry);
+
+    std::ofstream manifest(log.manifest_path, std::ofstream::app);
+    manifest << entry << '\n';
+}
+
+std::vector<std::string> prewarm_log_entries(PrewarmLog &log) {
+    const std::lock_guard<std::mutex> lock(log.mutex);
+    return log.entries;
+}
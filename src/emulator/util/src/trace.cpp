@@ -0,0 +1,116 @@
+// Vita3K emulator project
+// Copyright (C) 2018 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <util/trace.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct TraceEvent {
+    const char *name;
+    uint64_t ts_us;
+    uint64_t dur_us;
+};
+
+// One ring per thread. Held by shared_ptr in the registry so events from
+// threads that have since exited still make it into the dump.
+struct TraceRing {
+    static constexpr uint32_t capacity = 8192;
+
+    std::array<TraceEvent, capacity> events;
+    uint32_t pos = 0;
+    uint32_t count = 0;
+    size_t tid = 0;
+};
+
+static std::atomic<bool> g_tracing_enabled{ false };
+static std::mutex g_trace_registry_mutex;
+static std::vector<std::shared_ptr<TraceRing>> g_trace_rings;
+static const auto g_trace_origin = std::chrono::steady_clock::now();
+
+static TraceRing &thread_trace_ring() {
+    thread_local std::shared_ptr<TraceRing> ring = []() {
+        auto new_ring = std::make_shared<TraceRing>();
+        new_ring->tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+        const std::lock_guard<std::mutex> lock(g_trace_registry_mutex);
+        g_trace_rings.push_back(new_ring);
+        return new_ring;
+    }();
+    return *ring;
+}
+
+void set_tracing_enabled(bool enabled) {
+    g_tracing_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool is_tracing_enabled() {
+    return g_tracing_enabled.load(std::memory_order_relaxed);
+}
+
+uint64_t trace_now_us() {
+    const auto elapsed = std::chrono::steady_clock::now() - g_trace_origin;
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+void add_trace_event(const char *name, uint64_t start_us, uint64_t end_us) {
+    if (!is_tracing_enabled()) {
+        return;
+    }
+
+    TraceRing &ring = thread_trace_ring();
+    ring.events[ring.pos] = { name, start_us, end_us - start_us };
+    ring.pos = (ring.pos + 1) % TraceRing::capacity;
+    ring.count = std::min(ring.count + 1, TraceRing::capacity);
+}
+
+bool dump_trace(const std::string &path) {
+    // Stop recording first so the rings are quiescent while we read them.
+    set_tracing_enabled(false);
+
+    std::ofstream out(path, std::ofstream::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+
+    const std::lock_guard<std::mutex> lock(g_trace_registry_mutex);
+    for (const std::shared_ptr<TraceRing> &ring : g_trace_rings) {
+        const uint32_t start = (ring->count < TraceRing::capacity) ? 0 : ring->pos;
+        for (uint32_t i = 0; i < ring->count; ++i) {
+            const TraceEvent &event = ring->events[(start + i) % TraceRing::capacity];
+            if (!first) {
+                out << ",";
+            }
+            first = false;
+            out << "\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->tid
+                << ",\"ts\":" << event.ts_us << ",\"dur\":" << event.dur_us << "}";
+        }
+    }
+    out << "\n]}\n";
+
+    return out.good();
+}
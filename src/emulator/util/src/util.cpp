@@ -1,6 +1,8 @@
 #include <util/log.h>
 #include <util/string_convert.h>
 
+#include <spdlog/async_logger.h>
+
 #ifdef WIN32
 #include <direct.h>
 #include <processenv.h>
@@ -18,7 +20,10 @@
 #include <codecvt> // std::codecvt_utf8
 #include <iostream>
 #include <locale> // std::wstring_convert
+#include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 
 std::shared_ptr<spdlog::logger> g_logger;
@@ -32,6 +37,10 @@ static const
     = "/vita3k.log";
 #endif
 
+// Must be a power of two. 8K messages of headroom covers the worst
+// per-frame HLE chatter without growing the resident set noticeably.
+static constexpr size_t ASYNC_LOG_QUEUE_SIZE = 8192;
+
 void init_logging() {
 #ifdef _MSC_VER
     static constexpr bool LOG_MSVC_OUTPUT = true;
@@ -81,7 +90,12 @@ void init_logging() {
         sinks.push_back(std::make_shared<spdlog::sinks::msvc_sink_st>());
 #endif
 
-    g_logger = std::make_shared<spdlog::logger>("vita3k logger", begin(sinks), end(sinks));
+    // Async so the calling thread only enqueues - formatting and sinking
+    // happen on spdlog's worker. The queue drops on overflow rather than
+    // blocking the emulation threads; at overflow density the casualties
+    // are trace/debug spam, which is the right thing to lose.
+    g_logger = std::make_shared<spdlog::async_logger>("vita3k logger", begin(sinks), end(sinks),
+        ASYNC_LOG_QUEUE_SIZE, spdlog::async_overflow_policy::discard_log_msg);
     spdlog::register_logger(g_logger);
 
     spdlog::set_error_handler([](const std::string &msg) {
@@ -92,7 +106,9 @@ void init_logging() {
 
     spdlog::set_level(spdlog::level::trace);
 
-    g_logger->flush_on(spdlog::level::debug);
+    // Flushing per debug message would keep the worker in fsync and undo
+    // the point of the queue; errors still hit the disk promptly.
+    g_logger->flush_on(spdlog::level::err);
 }
 
 std::wstring utf_to_wide(const std::string &str) {
@@ -105,6 +121,34 @@ std::string wide_to_utf(const std::wstring &str) {
     return myconv.to_bytes(str);
 }
 
+// utf_to_wide constructs a codecvt facet and converts on every call, which
+// shows up on Windows hosts where each file operation widens its host path.
+// Titles operate on the same handful of paths every frame, so a memoized
+// copy is almost always available. Bounded by a wholesale clear - the
+// working set refills in a few frames and the cache never grows unchecked.
+static std::shared_mutex wide_cache_mutex;
+static std::map<std::string, std::wstring> wide_cache;
+static constexpr size_t WIDE_CACHE_LIMIT = 4096;
+
+std::wstring utf_to_wide_cached(const std::string &str) {
+    {
+        const std::shared_lock<std::shared_mutex> lock(wide_cache_mutex);
+        const auto cached = wide_cache.find(str);
+        if (cached != wide_cache.end()) {
+            return cached->second;
+        }
+    }
+
+    std::wstring wide = utf_to_wide(str);
+
+    const std::lock_guard<std::shared_mutex> lock(wide_cache_mutex);
+    if (wide_cache.size() >= WIDE_CACHE_LIMIT) {
+        wide_cache.clear();
+    }
+    wide_cache.emplace(str, wide);
+    return wide;
+}
+
 #ifdef WIN32
 std::string utf16_to_utf8(const std::u16string &str) {
     std::wstring_convert<std::codecvt_utf8_utf16<int16_t>, int16_t> myconv;